@@ -6,6 +6,8 @@
 
 #include "core/fpdfapi/edit/cpdf_pageexporter.h"
 
+#include <utility>
+
 #include "constants/page_object.h"
 #include "core/fpdfapi/parser/cpdf_dictionary.h"
 #include "core/fpdfapi/parser/cpdf_document.h"
@@ -90,3 +92,23 @@ bool CPDF_PageExporter::ExportPages(pdfium::span<const uint32_t> page_indices,
 
   return true;
 }
+
+bool CPDF_PageExporter::ExportCatalogEntry(ByteStringView key) {
+  const CPDF_Dictionary* src_root = src()->GetRoot();
+  RetainPtr<CPDF_Dictionary> dest_root = dest()->GetMutableRoot();
+  if (!src_root || !dest_root) {
+    return false;
+  }
+
+  RetainPtr<const CPDF_Object> src_obj = src_root->GetObjectFor(key);
+  if (!src_obj) {
+    return true;
+  }
+
+  RetainPtr<CPDF_Object> dest_obj = src_obj->Clone();
+  if (!UpdateReference(dest_obj)) {
+    return false;
+  }
+  dest_root->SetFor(ByteString(key), std::move(dest_obj));
+  return true;
+}
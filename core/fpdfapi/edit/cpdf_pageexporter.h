@@ -10,6 +10,7 @@
 #include <stdint.h>
 
 #include "core/fpdfapi/edit/cpdf_pageorganizer.h"
+#include "core/fxcrt/bytestring.h"
 #include "core/fxcrt/span.h"
 
 class CPDF_Document;
@@ -25,6 +26,12 @@ class CPDF_PageExporter final : public CPDF_PageOrganizer {
   // indices, insert them into the destination document at page `index`.
   // `page_indices` and `index` are 0-based.
   bool ExportPages(pdfium::span<const uint32_t> page_indices, int index);
+
+  // Copies the `key` entry of the source document's catalog, e.g.
+  // "OCProperties", into the destination document's catalog. Must be called
+  // after ExportPages(), so the entry refers to the exported pages. Returns
+  // true if the source catalog has no `key` entry.
+  bool ExportCatalogEntry(ByteStringView key);
 };
 
 #endif  // CORE_FPDFAPI_EDIT_CPDF_PAGEEXPORTER_H_
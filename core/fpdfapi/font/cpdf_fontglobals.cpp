@@ -53,7 +53,11 @@ CPDF_FontGlobals* CPDF_FontGlobals::GetInstance() {
 
 CPDF_FontGlobals::CPDF_FontGlobals() = default;
 
-CPDF_FontGlobals::~CPDF_FontGlobals() = default;
+CPDF_FontGlobals::~CPDF_FontGlobals() {
+  for (auto& [name, cmap] : cmaps_) {
+    cmap->Unfreeze();
+  }
+}
 
 void CPDF_FontGlobals::LoadEmbeddedMaps() {
   LoadEmbeddedGB1CMaps();
@@ -65,6 +69,7 @@ void CPDF_FontGlobals::LoadEmbeddedMaps() {
 RetainPtr<CPDF_Font> CPDF_FontGlobals::Find(
     CPDF_Document* doc,
     CFX_FontMapper::StandardFont index) {
+  std::lock_guard<std::mutex> lock(lock_);
   auto it = stock_map_.find(doc);
   if (it == stock_map_.end() || !it->second) {
     return nullptr;
@@ -76,6 +81,7 @@ RetainPtr<CPDF_Font> CPDF_FontGlobals::Find(
 void CPDF_FontGlobals::Set(CPDF_Document* doc,
                            CFX_FontMapper::StandardFont index,
                            RetainPtr<CPDF_Font> font) {
+  std::lock_guard<std::mutex> lock(lock_);
   UnownedPtr<CPDF_Document> pKey(doc);
   if (!pdfium::Contains(stock_map_, pKey)) {
     stock_map_[pKey] = std::make_unique<CFX_StockFontArray>();
@@ -84,11 +90,17 @@ void CPDF_FontGlobals::Set(CPDF_Document* doc,
 }
 
 void CPDF_FontGlobals::Clear(CPDF_Document* doc) {
-  // Avoid constructing smart-pointer key as erase() doesn't invoke
-  // transparent lookup in the same way find() does.
-  auto it = stock_map_.find(doc);
-  if (it != stock_map_.end()) {
-    stock_map_.erase(it);
+  // Release the fonts outside the lock.
+  std::unique_ptr<CFX_StockFontArray> fonts;
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    // Avoid constructing smart-pointer key as erase() doesn't invoke
+    // transparent lookup in the same way find() does.
+    auto it = stock_map_.find(doc);
+    if (it != stock_map_.end()) {
+      fonts = std::move(it->second);
+      stock_map_.erase(it);
+    }
   }
 }
 
@@ -114,20 +126,25 @@ void CPDF_FontGlobals::LoadEmbeddedKorea1CMaps() {
 
 RetainPtr<const CPDF_CMap> CPDF_FontGlobals::GetPredefinedCMap(
     const ByteString& name) {
+  if (name.IsEmpty()) {
+    return LoadPredefinedCMap(name.AsStringView());
+  }
+
+  std::lock_guard<std::mutex> lock(lock_);
   auto it = cmaps_.find(name);
   if (it != cmaps_.end()) {
     return it->second;
   }
 
   RetainPtr<const CPDF_CMap> pCMap = LoadPredefinedCMap(name.AsStringView());
-  if (!name.IsEmpty()) {
-    cmaps_[name] = pCMap;
-  }
-
+  pCMap->Freeze();
+  // Copy the name, so the key does not share a string buffer with the caller.
+  cmaps_[ByteString(name.AsStringView())] = pCMap;
   return pCMap;
 }
 
 CPDF_CID2UnicodeMap* CPDF_FontGlobals::GetCID2UnicodeMap(CIDSet charset) {
+  std::lock_guard<std::mutex> lock(lock_);
   if (!cid2unicode_maps_[charset]) {
     cid2unicode_maps_[charset] = std::make_unique<CPDF_CID2UnicodeMap>(charset);
   }
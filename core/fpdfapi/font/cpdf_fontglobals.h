@@ -11,6 +11,7 @@
 #include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 
 #include "core/fpdfapi/cmaps/fpdf_cmaps.h"
 #include "core/fpdfapi/font/cpdf_cidfont.h"
@@ -22,6 +23,9 @@
 class CFX_StockFontArray;
 class CPDF_Font;
 
+// Shared by all threads. The predefined cmaps and CID to Unicode maps are
+// immutable once loaded, so all documents share them. Stock fonts belong to
+// a document, and only get used on the thread that uses the document.
 class CPDF_FontGlobals {
  public:
   // Per-process singleton which must be managed by callers.
@@ -64,6 +68,9 @@ class CPDF_FontGlobals {
   void LoadEmbeddedJapan1CMaps();
   void LoadEmbeddedKorea1CMaps();
 
+  // Guards `cmaps_`, `cid2unicode_maps_` and `stock_map_`.
+  std::mutex lock_;
+  // Frozen, so that threads can share them.
   std::map<ByteString, RetainPtr<const CPDF_CMap>> cmaps_;
   std::array<std::unique_ptr<CPDF_CID2UnicodeMap>, CIDSET_NUM_SETS>
       cid2unicode_maps_;
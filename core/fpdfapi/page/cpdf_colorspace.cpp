@@ -8,6 +8,7 @@
 
 #include <math.h>
 #include <stdint.h>
+#include <stdlib.h>
 
 #include <algorithm>
 #include <array>
@@ -250,6 +251,64 @@ class CPDF_ICCBasedCS final : public CPDF_BasedCS {
   std::vector<float> ranges_;
 };
 
+// Caches the tint transform of a Separation or DeviceN color space as a lookup
+// table, once images are large enough to make up for building it. With one
+// component, the table holds the exact result for every byte value. With up to
+// four components, it holds the results for a grid of kGridSize values per
+// component, and the colors in between get interpolated.
+//
+// Interpolation is only close for smooth tint transforms. So the grid only gets
+// used if it matches the exact results at the center of every grid cell, which
+// steps and thresholds inside a cell do not. Otherwise, conversions keep
+// evaluating the tint transform for every pixel.
+class TintTransformLut {
+ public:
+  TintTransformLut();
+  ~TintTransformLut();
+
+  // Converts like TranslateImageLineWithTintTransform(). Returns false if the
+  // tint transform fails.
+  bool TranslateImageLine(const CPDF_Function& func,
+                          const CPDF_ColorSpace& base_cs,
+                          uint32_t components,
+                          pdfium::span<uint8_t> dest_span,
+                          pdfium::span<const uint8_t> src_span,
+                          int pixels,
+                          int image_width,
+                          int image_height);
+
+ private:
+  // 15 intervals divide 255, so every 17th byte value lands on a grid node.
+  static constexpr uint32_t kGridSize = 16;
+  static constexpr uint32_t kMaxComponents = 4;
+
+  enum class State : uint8_t {
+    kEmpty,
+    kBuilt,
+    kFailed,
+  };
+
+  bool Build(const CPDF_Function& func,
+             const CPDF_ColorSpace& base_cs,
+             uint32_t components);
+  // Returns whether interpolating in the grid gives the exact results, give
+  // or take 1, at the center of every grid cell.
+  bool IsGridAccurate(const CPDF_Function& func,
+                      const CPDF_ColorSpace& base_cs,
+                      uint32_t components) const;
+  void TranslateWithGrid(uint32_t components,
+                         pdfium::span<uint8_t> dest_span,
+                         pdfium::span<const uint8_t> src_span,
+                         int pixels) const;
+
+  State state_ = State::kEmpty;
+  // BGR bytes for all 256 values of a single component.
+  DataVector<uint8_t> bgr_table_;
+  // BGR values, scaled to 0-255 but not yet truncated, for the grid nodes.
+  // The first component varies fastest.
+  DataVector<float> grid_;
+};
+
 class CPDF_SeparationCS final : public CPDF_BasedCS {
  public:
   CONSTRUCT_VIA_MAKE_RETAIN;
@@ -262,6 +321,12 @@ class CPDF_SeparationCS final : public CPDF_BasedCS {
                        float* value,
                        float* min,
                        float* max) const override;
+  void TranslateImageLine(pdfium::span<uint8_t> dest_span,
+                          pdfium::span<const uint8_t> src_span,
+                          int pixels,
+                          int image_width,
+                          int image_height,
+                          bool bTransMask) const override;
   uint32_t v_Load(CPDF_Document* doc,
                   const CPDF_Array* pArray,
                   std::set<const CPDF_Object*>* pVisited) override;
@@ -271,6 +336,7 @@ class CPDF_SeparationCS final : public CPDF_BasedCS {
 
   bool is_none_type_ = false;
   std::unique_ptr<const CPDF_Function> func_;
+  mutable TintTransformLut lut_;
 };
 
 class CPDF_DeviceNCS final : public CPDF_BasedCS {
@@ -285,6 +351,12 @@ class CPDF_DeviceNCS final : public CPDF_BasedCS {
                        float* value,
                        float* min,
                        float* max) const override;
+  void TranslateImageLine(pdfium::span<uint8_t> dest_span,
+                          pdfium::span<const uint8_t> src_span,
+                          int pixels,
+                          int image_width,
+                          int image_height,
+                          bool bTransMask) const override;
   uint32_t v_Load(CPDF_Document* doc,
                   const CPDF_Array* pArray,
                   std::set<const CPDF_Object*>* pVisited) override;
@@ -293,6 +365,7 @@ class CPDF_DeviceNCS final : public CPDF_BasedCS {
   CPDF_DeviceNCS();
 
   std::unique_ptr<const CPDF_Function> func_;
+  mutable TintTransformLut lut_;
 };
 
 class Vector_3by1 {
@@ -411,6 +484,211 @@ FX_RGB_STRUCT<float> XYZ_to_sRGB_WhitePoint(float X,
   return {RGB_Conversion(RGB.a), RGB_Conversion(RGB.b), RGB_Conversion(RGB.c)};
 }
 
+// Calculates the colors of `pixel_count` pixels with `components` bytes each,
+// like calling GetRGB() on a Separation or DeviceN color space for each pixel,
+// but with the tint transform `func` evaluated for all of them at once. Passes
+// each pixel's index and color to `write`. Returns false if any of the calls to
+// `func` fails.
+template <typename Writer>
+bool CalculateTintTransformColors(const CPDF_Function& func,
+                                  const CPDF_ColorSpace& base_cs,
+                                  uint32_t components,
+                                  pdfium::span<const uint8_t> src_span,
+                                  size_t pixel_count,
+                                  Writer write) {
+  std::vector<float> inputs(Fx2DSizeOrDie(pixel_count, components));
+  for (auto [input, src] : fxcrt::Zip(inputs, src_span)) {
+    input = static_cast<float>(src) / 255;
+  }
+  const uint32_t outputs = func.OutputCount();
+  std::vector<float> results(Fx2DSizeOrDie(pixel_count, outputs));
+  if (!func.CallBatch(pixel_count, inputs, results)) {
+    return false;
+  }
+
+  // Using at least 16 elements due to the call base_cs.GetRGB() below.
+  std::vector<float> pixel_results(std::max(outputs, 16u));
+  for (size_t i = 0; i < pixel_count; ++i) {
+    fxcrt::spancpy(pdfium::span(pixel_results),
+                   pdfium::span(results).subspan(i * outputs, outputs));
+    write(i, base_cs.GetRGBOrZerosOnError(pixel_results));
+  }
+  return true;
+}
+
+// Converts `pixels` pixels with `components` bytes each to BGR, using
+// CalculateTintTransformColors().
+bool TranslateImageLineWithTintTransform(const CPDF_Function& func,
+                                         const CPDF_ColorSpace& base_cs,
+                                         uint32_t components,
+                                         pdfium::span<uint8_t> dest_span,
+                                         pdfium::span<const uint8_t> src_span,
+                                         int pixels) {
+  return CalculateTintTransformColors(
+      func, base_cs, components, src_span, static_cast<size_t>(pixels),
+      [dest_span](size_t i, const FX_RGB_STRUCT<float>& rgb) {
+        dest_span[i * 3] = static_cast<int32_t>(rgb.blue * 255);
+        dest_span[i * 3 + 1] = static_cast<int32_t>(rgb.green * 255);
+        dest_span[i * 3 + 2] = static_cast<int32_t>(rgb.red * 255);
+      });
+}
+
+TintTransformLut::TintTransformLut() = default;
+
+TintTransformLut::~TintTransformLut() = default;
+
+bool TintTransformLut::TranslateImageLine(const CPDF_Function& func,
+                                          const CPDF_ColorSpace& base_cs,
+                                          uint32_t components,
+                                          pdfium::span<uint8_t> dest_span,
+                                          pdfium::span<const uint8_t> src_span,
+                                          int pixels,
+                                          int image_width,
+                                          int image_height) {
+  if (state_ == State::kEmpty && components <= kMaxComponents) {
+    // Only build the table once an image has at least as many pixels as the
+    // table has entries.
+    const size_t entries = components == 1 ? 256 : 1u << (4 * components);
+    if (static_cast<size_t>(image_width) * image_height >= entries) {
+      state_ = Build(func, base_cs, components) ? State::kBuilt
+                                                : State::kFailed;
+    }
+  }
+  if (state_ != State::kBuilt) {
+    return TranslateImageLineWithTintTransform(func, base_cs, components,
+                                               dest_span, src_span, pixels);
+  }
+
+  if (components > 1) {
+    TranslateWithGrid(components, dest_span, src_span, pixels);
+    return true;
+  }
+  for (size_t i = 0; i < static_cast<size_t>(pixels); ++i) {
+    const size_t value = src_span[i];
+    fxcrt::spancpy(dest_span.subspan(i * 3, 3u),
+                   pdfium::span(bgr_table_).subspan(value * 3, 3u));
+  }
+  return true;
+}
+
+bool TintTransformLut::Build(const CPDF_Function& func,
+                             const CPDF_ColorSpace& base_cs,
+                             uint32_t components) {
+  if (components == 1) {
+    std::array<uint8_t, 256> values;
+    for (size_t i = 0; i < values.size(); ++i) {
+      values[i] = static_cast<uint8_t>(i);
+    }
+    bgr_table_.resize(values.size() * 3);
+    return TranslateImageLineWithTintTransform(
+        func, base_cs, 1, bgr_table_, values, static_cast<int>(values.size()));
+  }
+
+  const size_t node_count = 1u << (4 * components);
+  DataVector<uint8_t> nodes(node_count * components);
+  for (size_t node = 0; node < node_count; ++node) {
+    for (uint32_t c = 0; c < components; ++c) {
+      nodes[node * components + c] =
+          static_cast<uint8_t>((node >> (4 * c)) % kGridSize * 17);
+    }
+  }
+  grid_.resize(node_count * 3);
+  if (!CalculateTintTransformColors(
+          func, base_cs, components, nodes, node_count,
+          [this](size_t i, const FX_RGB_STRUCT<float>& rgb) {
+            grid_[i * 3] = rgb.blue * 255;
+            grid_[i * 3 + 1] = rgb.green * 255;
+            grid_[i * 3 + 2] = rgb.red * 255;
+          })) {
+    return false;
+  }
+  if (!IsGridAccurate(func, base_cs, components)) {
+    grid_ = DataVector<float>();
+    return false;
+  }
+  return true;
+}
+
+bool TintTransformLut::IsGridAccurate(const CPDF_Function& func,
+                                      const CPDF_ColorSpace& base_cs,
+                                      uint32_t components) const {
+  static constexpr uint32_t kCellsPerComponent = kGridSize - 1;
+  size_t cell_count = 1;
+  for (uint32_t c = 0; c < components; ++c) {
+    cell_count *= kCellsPerComponent;
+  }
+  // Cells are 17 values wide, so an offset of 8 is as close to the center as
+  // byte values get.
+  DataVector<uint8_t> centers(cell_count * components);
+  for (size_t cell = 0; cell < cell_count; ++cell) {
+    size_t index = cell;
+    for (uint32_t c = 0; c < components; ++c) {
+      centers[cell * components + c] =
+          static_cast<uint8_t>(index % kCellsPerComponent * 17 + 8);
+      index /= kCellsPerComponent;
+    }
+  }
+
+  const int pixels = static_cast<int>(cell_count);
+  DataVector<uint8_t> exact(cell_count * 3);
+  if (!TranslateImageLineWithTintTransform(func, base_cs, components, exact,
+                                           centers, pixels)) {
+    return false;
+  }
+  DataVector<uint8_t> interpolated(cell_count * 3);
+  TranslateWithGrid(components, interpolated, centers, pixels);
+  for (size_t i = 0; i < exact.size(); ++i) {
+    if (abs(exact[i] - interpolated[i]) > 1) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void TintTransformLut::TranslateWithGrid(uint32_t components,
+                                         pdfium::span<uint8_t> dest_span,
+                                         pdfium::span<const uint8_t> src_span,
+                                         int pixels) const {
+  const uint32_t corner_count = 1u << components;
+  std::array<float, kMaxComponents> fractions;
+  for (size_t i = 0; i < static_cast<size_t>(pixels); ++i) {
+    // Find the grid cell around the pixel, and where in it the pixel is.
+    size_t cell = 0;
+    for (uint32_t c = 0; c < components; ++c) {
+      const uint8_t value = src_span[i * components + c];
+      const uint32_t index = std::min<uint32_t>(value / 17, kGridSize - 2);
+      fractions[c] = static_cast<float>(value - index * 17) / 17;
+      cell += static_cast<size_t>(index) << (4 * c);
+    }
+
+    // Multilinear interpolation between the corners of the cell. Pixels on
+    // grid nodes give exactly the node values, since all other corners get
+    // a zero weight.
+    std::array<float, 3> bgr = {};
+    for (uint32_t corner = 0; corner < corner_count; ++corner) {
+      float weight = 1.0f;
+      size_t node = cell;
+      for (uint32_t c = 0; c < components; ++c) {
+        if (corner & (1u << c)) {
+          weight *= fractions[c];
+          node += static_cast<size_t>(1) << (4 * c);
+        } else {
+          weight *= 1.0f - fractions[c];
+        }
+      }
+      if (weight == 0) {
+        continue;
+      }
+      for (size_t j = 0; j < bgr.size(); ++j) {
+        bgr[j] += weight * grid_[node * 3 + j];
+      }
+    }
+    for (size_t j = 0; j < bgr.size(); ++j) {
+      dest_span[i * 3 + j] = static_cast<int32_t>(bgr[j]);
+    }
+  }
+}
+
 class StockColorSpaces {
  public:
   StockColorSpaces()
@@ -422,10 +700,19 @@ class StockColorSpaces {
             CPDF_ColorSpace::Family::kDeviceCMYK)),
         pattern_(pdfium::MakeRetain<CPDF_PatternCS>()) {
     pattern_->InitializeStockPattern();
+    gray_->Freeze();
+    rgb_->Freeze();
+    cmyk_->Freeze();
+    pattern_->Freeze();
   }
   StockColorSpaces(const StockColorSpaces&) = delete;
   StockColorSpaces& operator=(const StockColorSpaces&) = delete;
-  ~StockColorSpaces() = default;
+  ~StockColorSpaces() {
+    gray_->Unfreeze();
+    rgb_->Unfreeze();
+    cmyk_->Unfreeze();
+    pattern_->Unfreeze();
+  }
 
   RetainPtr<CPDF_ColorSpace> GetStockCS(CPDF_ColorSpace::Family family) {
     if (family == CPDF_ColorSpace::Family::kDeviceGray) {
@@ -450,8 +737,16 @@ class StockColorSpaces {
   RetainPtr<CPDF_PatternCS> pattern_;
 };
 
+// Frozen, so that threads can share them.
 StockColorSpaces* g_stock_colorspaces = nullptr;
 
+constexpr size_t kFamilyCount =
+    static_cast<size_t>(CPDF_ColorSpace::Family::kPattern) + 1;
+
+// The std conversion state of the stock color spaces, by family. Threads
+// share the color spaces, but not this state.
+thread_local std::array<uint32_t, kFamilyCount> g_stock_std_conversion = {};
+
 }  // namespace
 
 PatternValue::PatternValue() = default;
@@ -665,13 +960,23 @@ void CPDF_ColorSpace::TranslateImageLine(pdfium::span<uint8_t> dest_span,
 }
 
 void CPDF_ColorSpace::EnableStdConversion(bool bEnabled) {
+  uint32_t& std_conversion =
+      is_stock_ ? g_stock_std_conversion[static_cast<size_t>(family_)]
+                : std_conversion_;
   if (bEnabled) {
-    std_conversion_++;
-  } else if (std_conversion_) {
-    std_conversion_--;
+    std_conversion++;
+  } else if (std_conversion) {
+    std_conversion--;
   }
 }
 
+bool CPDF_ColorSpace::IsStdConversionEnabled() const {
+  if (is_stock_) {
+    return g_stock_std_conversion[static_cast<size_t>(family_)] != 0;
+  }
+  return std_conversion_ != 0;
+}
+
 bool CPDF_ColorSpace::IsNormal() const {
   return GetFamily() == Family::kDeviceGray ||
          GetFamily() == Family::kDeviceRGB ||
@@ -692,6 +997,7 @@ CPDF_ColorSpace::CPDF_ColorSpace(Family family) : family_(family) {}
 CPDF_ColorSpace::~CPDF_ColorSpace() = default;
 
 void CPDF_ColorSpace::SetComponentsForStockCS(uint32_t nComponents) {
+  is_stock_ = true;
   components_ = nComponents;
 }
 
@@ -1210,6 +1516,21 @@ std::optional<FX_RGB_STRUCT<float>> CPDF_SeparationCS::GetRGB(
   return std::nullopt;
 }
 
+void CPDF_SeparationCS::TranslateImageLine(
+    pdfium::span<uint8_t> dest_span,
+    pdfium::span<const uint8_t> src_span,
+    int pixels,
+    int image_width,
+    int image_height,
+    bool bTransMask) const {
+  if (is_none_type_ || !func_ || !base_cs_ || bTransMask ||
+      !lut_.TranslateImageLine(*func_, *base_cs_, 1, dest_span, src_span,
+                               pixels, image_width, image_height)) {
+    CPDF_ColorSpace::TranslateImageLine(dest_span, src_span, pixels,
+                                        image_width, image_height, bTransMask);
+  }
+}
+
 CPDF_DeviceNCS::CPDF_DeviceNCS() : CPDF_BasedCS(Family::kDeviceN) {}
 
 CPDF_DeviceNCS::~CPDF_DeviceNCS() = default;
@@ -1268,3 +1589,17 @@ std::optional<FX_RGB_STRUCT<float>> CPDF_DeviceNCS::GetRGB(
   }
   return base_cs_->GetRGB(results);
 }
+
+void CPDF_DeviceNCS::TranslateImageLine(pdfium::span<uint8_t> dest_span,
+                                        pdfium::span<const uint8_t> src_span,
+                                        int pixels,
+                                        int image_width,
+                                        int image_height,
+                                        bool bTransMask) const {
+  if (!func_ || bTransMask ||
+      !lut_.TranslateImageLine(*func_, *base_cs_, ComponentCount(), dest_span,
+                               src_span, pixels, image_width, image_height)) {
+    CPDF_ColorSpace::TranslateImageLine(dest_span, src_span, pixels,
+                                        image_width, image_height, bTransMask);
+  }
+}
@@ -143,10 +143,10 @@ class CPDF_ColorSpace : public Retainable, public Observable {
                           std::set<const CPDF_Object*>* pVisited) = 0;
 
   // Stock colorspaces are not loaded normally. This initializes their
-  // components count.
+  // components count, and marks them as stock.
   void SetComponentsForStockCS(uint32_t nComponents);
 
-  bool IsStdConversionEnabled() const { return std_conversion_ != 0; }
+  bool IsStdConversionEnabled() const;
   bool HasSameArray(const CPDF_Object* pObj) const { return array_ == pObj; }
 
  private:
@@ -157,6 +157,9 @@ class CPDF_ColorSpace : public Retainable, public Observable {
       ByteStringView bsFamilyName);
 
   const Family family_;
+  // Stock color spaces are shared by threads, so they keep their std
+  // conversion state elsewhere.
+  bool is_stock_ = false;
   uint32_t std_conversion_ = 0;
   uint32_t components_ = 0;
   RetainPtr<const CPDF_Array> array_;
@@ -8,13 +8,93 @@
 #include <stdint.h>
 
 #include <algorithm>
+#include <set>
+#include <utility>
+#include <vector>
 
+#include "core/fpdfapi/page/test_with_page_module.h"
+#include "core/fpdfapi/parser/cpdf_array.h"
+#include "core/fpdfapi/parser/cpdf_dictionary.h"
+#include "core/fpdfapi/parser/cpdf_indirect_object_holder.h"
+#include "core/fpdfapi/parser/cpdf_name.h"
+#include "core/fpdfapi/parser/cpdf_number.h"
+#include "core/fpdfapi/parser/cpdf_reference.h"
+#include "core/fpdfapi/parser/cpdf_stream.h"
+#include "core/fxcrt/bytestring.h"
+#include "core/fxcrt/data_vector.h"
 #include "core/fxcrt/retain_ptr.h"
+#include "core/fxcrt/span.h"
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 using ::testing::ElementsAre;
 
+namespace {
+
+// Creates a Type 4 function with inputs and outputs in the range [0, 1].
+RetainPtr<CPDF_Stream> CreatePostScriptFunction(
+    CPDF_IndirectObjectHolder* holder,
+    const ByteString& program,
+    int inputs,
+    int outputs) {
+  auto dict = pdfium::MakeRetain<CPDF_Dictionary>();
+  dict->SetNewFor<CPDF_Number>("FunctionType", 4);
+  auto domain = dict->SetNewFor<CPDF_Array>("Domain");
+  for (int i = 0; i < inputs; ++i) {
+    domain->AppendNew<CPDF_Number>(0);
+    domain->AppendNew<CPDF_Number>(1);
+  }
+  auto range = dict->SetNewFor<CPDF_Array>("Range");
+  for (int i = 0; i < outputs; ++i) {
+    range->AppendNew<CPDF_Number>(0);
+    range->AppendNew<CPDF_Number>(1);
+  }
+  return holder->NewIndirect<CPDF_Stream>(
+      DataVector<uint8_t>(program.unsigned_span().begin(),
+                          program.unsigned_span().end()),
+      std::move(dict));
+}
+
+// Loads a DeviceN color space with `inputs` components, or a Separation color
+// space if `inputs` is 1, that converts to DeviceRGB with `program`.
+RetainPtr<CPDF_ColorSpace> LoadTintTransformColorSpace(
+    const ByteString& program,
+    int inputs) {
+  CPDF_IndirectObjectHolder holder;
+  auto array = pdfium::MakeRetain<CPDF_Array>();
+  if (inputs == 1) {
+    array->AppendNew<CPDF_Name>("Separation");
+    array->AppendNew<CPDF_Name>("Spot");
+  } else {
+    array->AppendNew<CPDF_Name>("DeviceN");
+    auto names = array->AppendNew<CPDF_Array>();
+    for (int i = 0; i < inputs; ++i) {
+      names->AppendNew<CPDF_Name>(ByteString::Format("Spot%d", i));
+    }
+  }
+  array->AppendNew<CPDF_Name>("DeviceRGB");
+  array->AppendNew<CPDF_Reference>(
+      &holder,
+      CreatePostScriptFunction(&holder, program, inputs, 3)->GetObjNum());
+  std::set<const CPDF_Object*> visited;
+  return CPDF_ColorSpace::Load(nullptr, array.Get(), &visited);
+}
+
+// Converts all of `src` as one line, as part of an image that is either too
+// small or large enough to use a lookup table.
+std::vector<uint8_t> TranslateLine(const CPDF_ColorSpace& cs,
+                                   const std::vector<uint8_t>& src,
+                                   int pixels,
+                                   bool large_image) {
+  std::vector<uint8_t> dest(pixels * 3);
+  const int image_size = large_image ? 1000 : 1;
+  cs.TranslateImageLine(dest, src, pixels, image_size, image_size,
+                        /*bTransMask=*/false);
+  return dest;
+}
+
+}  // namespace
+
 TEST(CPDFCalGrayTest, TranslateImageLine) {
   RetainPtr<CPDF_ColorSpace> pCal = CPDF_ColorSpace::AllocateColorSpace("CalG");
   ASSERT_TRUE(pCal);
@@ -38,3 +118,85 @@ TEST(CPDFCalRGBTest, TranslateImageLine) {
   pCal->TranslateImageLine(dst, kSrc, 4, 4, 1, /*bTransMask=*/false);
   EXPECT_THAT(dst, ElementsAre(0, 0, 255, 0, 255, 0, 255, 0, 0, 128, 128, 128));
 }
+
+using CPDFTintTransformTest = TestWithPageModule;
+
+TEST_F(CPDFTintTransformTest, SeparationLookupTable) {
+  static constexpr char kProgram[] = "{ dup dup mul 1 2 index sub }";
+  RetainPtr<CPDF_ColorSpace> cs = LoadTintTransformColorSpace(kProgram, 1);
+  ASSERT_TRUE(cs);
+  RetainPtr<CPDF_ColorSpace> lut_cs = LoadTintTransformColorSpace(kProgram, 1);
+  ASSERT_TRUE(lut_cs);
+
+  std::vector<uint8_t> src(256);
+  for (size_t i = 0; i < src.size(); ++i) {
+    src[i] = static_cast<uint8_t>(i);
+  }
+  // The table has the exact results for all values.
+  EXPECT_EQ(TranslateLine(*cs, src, 256, /*large_image=*/false),
+            TranslateLine(*lut_cs, src, 256, /*large_image=*/true));
+  EXPECT_THAT(TranslateLine(*lut_cs, {0, 255}, 2, /*large_image=*/true),
+              ElementsAre(255, 0, 0, 0, 255, 255));
+}
+
+TEST_F(CPDFTintTransformTest, DeviceNLookupTable) {
+  static constexpr char kProgram[] =
+      "{ dup mul 3 1 roll 2 copy mul 3 1 roll add 2 div 3 -1 roll }";
+  RetainPtr<CPDF_ColorSpace> cs = LoadTintTransformColorSpace(kProgram, 3);
+  ASSERT_TRUE(cs);
+  RetainPtr<CPDF_ColorSpace> lut_cs = LoadTintTransformColorSpace(kProgram, 3);
+  ASSERT_TRUE(lut_cs);
+
+  // Grid nodes, at multiples of 17, give exact results.
+  std::vector<uint8_t> nodes;
+  for (int i = 0; i < 16; ++i) {
+    nodes.push_back(i * 17);
+    nodes.push_back(255 - i * 17);
+    nodes.push_back((i * 7 % 16) * 17);
+  }
+  EXPECT_EQ(TranslateLine(*cs, nodes, 16, /*large_image=*/false),
+            TranslateLine(*lut_cs, nodes, 16, /*large_image=*/true));
+
+  // Values in between get interpolated, and end up close.
+  std::vector<uint8_t> src;
+  for (int i = 0; i < 256; ++i) {
+    src.push_back(i);
+    src.push_back((i * 37) % 256);
+    src.push_back((i * 101 + 13) % 256);
+  }
+  std::vector<uint8_t> expected =
+      TranslateLine(*cs, src, 256, /*large_image=*/false);
+  std::vector<uint8_t> actual =
+      TranslateLine(*lut_cs, src, 256, /*large_image=*/true);
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_NEAR(expected[i], actual[i], 1) << "at " << i;
+  }
+}
+
+TEST_F(CPDFTintTransformTest, DeviceNLookupTableWithThresholds) {
+  // Red and green switch from 0 to 1 in the middle of grid cells.
+  static constexpr char kProgram[] =
+      "{ 0.3 gt { 1 } { 0 } ifelse exch 0.5 gt { 1 } { 0 } ifelse 0 }";
+  RetainPtr<CPDF_ColorSpace> cs = LoadTintTransformColorSpace(kProgram, 2);
+  ASSERT_TRUE(cs);
+  RetainPtr<CPDF_ColorSpace> lut_cs = LoadTintTransformColorSpace(kProgram, 2);
+  ASSERT_TRUE(lut_cs);
+
+  std::vector<uint8_t> src;
+  for (int i = 0; i < 256; ++i) {
+    src.push_back(i);
+    src.push_back((i * 37) % 256);
+  }
+  for (int i : {76, 77, 127, 128}) {
+    src.push_back(i);
+    src.push_back(i);
+  }
+  const int pixels = static_cast<int>(src.size() / 2);
+
+  // Interpolating would blur the steps, so the results stay exact.
+  std::vector<uint8_t> expected =
+      TranslateLine(*cs, src, pixels, /*large_image=*/false);
+  EXPECT_EQ(expected, TranslateLine(*lut_cs, src, pixels, /*large_image=*/true));
+  EXPECT_THAT(pdfium::span(expected).last(12u),
+              ElementsAre(0, 0, 0, 0, 0, 255, 0, 0, 255, 0, 255, 255));
+}
@@ -8,6 +8,7 @@
 
 #include <utility>
 #include <variant>
+#include <vector>
 
 #include "constants/page_object.h"
 #include "core/fpdfapi/font/cpdf_type3char.h"
@@ -58,6 +59,25 @@ CPDF_ContentParser::CPDF_ContentParser(CPDF_Page* pPage)
   HandlePageContentFailure();
 }
 
+CPDF_ContentParser::CPDF_ContentParser(
+    CPDF_Page* pPage,
+    std::vector<RetainPtr<CPDF_StreamAcc>> loaded_streams)
+    : current_stage_(Stage::kPrepareContent), page_object_holder_(pPage) {
+  DCHECK(pPage);
+  if (!pPage->GetDocument() || loaded_streams.empty()) {
+    HandlePageContentFailure();
+    return;
+  }
+
+  if (loaded_streams.size() == 1) {
+    single_stream_ = std::move(loaded_streams.front());
+    return;
+  }
+
+  streams_ = fxcrt::CollectionSize<uint32_t>(loaded_streams);
+  stream_array_ = std::move(loaded_streams);
+}
+
 CPDF_ContentParser::CPDF_ContentParser(
     RetainPtr<const CPDF_Stream> pStream,
     CPDF_PageObjectHolder* pPageObjectHolder,
@@ -122,6 +142,36 @@ CPDF_ContentParser::CPDF_ContentParser(
 
 CPDF_ContentParser::~CPDF_ContentParser() = default;
 
+// static
+std::vector<RetainPtr<CPDF_StreamAcc>>
+CPDF_ContentParser::GetPageContentStreams(CPDF_Page* pPage) {
+  std::vector<RetainPtr<CPDF_StreamAcc>> streams;
+  if (!pPage->GetDocument()) {
+    return streams;
+  }
+
+  RetainPtr<const CPDF_Object> pContent =
+      pPage->GetDict()->GetDirectObjectFor(pdfium::page_object::kContents);
+  if (!pContent) {
+    return streams;
+  }
+
+  if (const CPDF_Stream* pStream = pContent->AsStream()) {
+    streams.push_back(
+        pdfium::MakeRetain<CPDF_StreamAcc>(pdfium::WrapRetain(pStream)));
+    return streams;
+  }
+
+  // Same as GetContent(), where elements that are not streams have no data.
+  if (const CPDF_Array* pArray = pContent->AsArray()) {
+    for (size_t i = 0; i < pArray->size(); ++i) {
+      streams.push_back(pdfium::MakeRetain<CPDF_StreamAcc>(
+          ToStream(pArray->GetDirectObjectAt(i))));
+    }
+  }
+  return streams;
+}
+
 CPDF_PageObjectHolder::CTMMap CPDF_ContentParser::TakeAllCTMs() {
   return parser_ ? parser_->TakeAllCTMs() : CPDF_PageObjectHolder::CTMMap();
 }
@@ -33,6 +33,10 @@ class PauseIndicatorIface;
 class CPDF_ContentParser {
  public:
   explicit CPDF_ContentParser(CPDF_Page* pPage);
+  // Same as above, but for a page whose content streams from
+  // GetPageContentStreams() have all been loaded already.
+  CPDF_ContentParser(CPDF_Page* pPage,
+                     std::vector<RetainPtr<CPDF_StreamAcc>> loaded_streams);
   CPDF_ContentParser(RetainPtr<const CPDF_Stream> pStream,
                      CPDF_PageObjectHolder* pPageObjectHolder,
                      const CPDF_AllStates* pGraphicStates,
@@ -41,6 +45,13 @@ class CPDF_ContentParser {
                      CPDF_Form::RecursionState* recursion_state);
   ~CPDF_ContentParser();
 
+  // Returns accessors for the content streams of `pPage`, in order, without
+  // loading their data. Returns nothing if the page has no usable contents.
+  // Callers can load the data, e.g. with the filters running on other
+  // threads, and then pass them to the constructor.
+  static std::vector<RetainPtr<CPDF_StreamAcc>> GetPageContentStreams(
+      CPDF_Page* pPage);
+
   CPDF_PageObjectHolder::CTMMap TakeAllCTMs();
 
   // Returns whether to continue or not.
@@ -477,9 +477,18 @@ CPDF_DIB::LoadState CPDF_DIB::CreateDecoder(uint8_t resolution_levels_to_skip) {
     decoder_ = BasicModule::CreateRunLengthDecoder(
         src_span, GetWidth(), GetHeight(), components_, bpc_);
   } else if (decoder == "DCTDecode") {
-    if (!CreateDCTDecoder(src_span, pParams)) {
+    const uint8_t jpeg_levels_to_skip = std::min(
+        resolution_levels_to_skip, JpegModule::kMaxResolutionLevelsToSkip);
+    if (!CreateDCTDecoder(src_span, pParams, jpeg_levels_to_skip)) {
       return LoadState::kFail;
     }
+    if (decoder_ && jpeg_levels_to_skip > 0) {
+      // Round up, like the decoder does.
+      const int scale = 1 << jpeg_levels_to_skip;
+      SetWidth((GetWidth() + scale - 1) / scale);
+      SetHeight((GetHeight() + scale - 1) / scale);
+      resolution_levels_skipped_ = jpeg_levels_to_skip;
+    }
   }
   if (!decoder_) {
     return LoadState::kFail;
@@ -502,10 +511,12 @@ CPDF_DIB::LoadState CPDF_DIB::CreateDecoder(uint8_t resolution_levels_to_skip) {
 }
 
 bool CPDF_DIB::CreateDCTDecoder(pdfium::span<const uint8_t> src_span,
-                                const CPDF_Dictionary* pParams) {
+                                const CPDF_Dictionary* pParams,
+                                uint8_t resolution_levels_to_skip) {
   decoder_ = JpegModule::CreateDecoder(
       src_span, GetWidth(), GetHeight(), components_,
-      !pParams || pParams->GetIntegerFor("ColorTransform", 1));
+      !pParams || pParams->GetIntegerFor("ColorTransform", 1),
+      resolution_levels_to_skip);
   if (decoder_) {
     return true;
   }
@@ -528,7 +539,8 @@ bool CPDF_DIB::CreateDCTDecoder(pdfium::span<const uint8_t> src_span,
   if (components_ == static_cast<uint32_t>(info.num_components)) {
     bpc_ = info.bits_per_components;
     decoder_ = JpegModule::CreateDecoder(src_span, GetWidth(), GetHeight(),
-                                         components_, info.color_transform);
+                                         components_, info.color_transform,
+                                         resolution_levels_to_skip);
     return true;
   }
 
@@ -578,7 +590,8 @@ bool CPDF_DIB::CreateDCTDecoder(pdfium::span<const uint8_t> src_span,
 
   bpc_ = info.bits_per_components;
   decoder_ = JpegModule::CreateDecoder(src_span, GetWidth(), GetHeight(),
-                                       components_, info.color_transform);
+                                       components_, info.color_transform,
+                                       resolution_levels_to_skip);
   return true;
 }
 
@@ -594,6 +607,7 @@ RetainPtr<CFX_DIBitmap> CPDF_DIB::LoadJpxBitmap(
 
   SetWidth(GetWidth() >> resolution_levels_to_skip);
   SetHeight(GetHeight() >> resolution_levels_to_skip);
+  resolution_levels_skipped_ = resolution_levels_to_skip;
 
   if (!decoder->StartDecode()) {
     return nullptr;
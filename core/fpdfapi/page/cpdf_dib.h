@@ -53,6 +53,12 @@ class CPDF_DIB final : public CFX_DIBBase {
   uint32_t GetMatteColor() const { return matte_color_; }
   bool IsJBigImage() const;
 
+  // Number of times the image got halved in size while decoding, because the
+  // caller did not need the full size.
+  uint8_t GetResolutionLevelsSkipped() const {
+    return resolution_levels_skipped_;
+  }
+
   bool Load();
   LoadState StartLoadDIBBase(bool bHasMask,
                              const CPDF_Dictionary* pFormResources,
@@ -95,7 +101,8 @@ class CPDF_DIB final : public CFX_DIBBase {
   void LoadPalette();
   LoadState CreateDecoder(uint8_t resolution_levels_to_skip);
   bool CreateDCTDecoder(pdfium::span<const uint8_t> src_span,
-                        const CPDF_Dictionary* pParams);
+                        const CPDF_Dictionary* pParams,
+                        uint8_t resolution_levels_to_skip);
   void TranslateScanline24bpp(pdfium::span<uint8_t> dest_scan,
                               pdfium::span<const uint8_t> src_scan) const;
   bool TranslateScanline24bppDefaultDecode(
@@ -120,6 +127,7 @@ class CPDF_DIB final : public CFX_DIBBase {
   CPDF_ColorSpace::Family group_family_ = CPDF_ColorSpace::Family::kUnknown;
   uint32_t matte_color_ = 0;
   LoadState status_ = LoadState::kFail;
+  uint8_t resolution_levels_skipped_ = 0;
   bool load_mask_ = false;
   bool default_decode_ = true;
   bool image_mask_ = false;
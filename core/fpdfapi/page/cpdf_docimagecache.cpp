@@ -0,0 +1,172 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/page/cpdf_docimagecache.h"
+
+#include <algorithm>
+#include <iterator>
+#include <mutex>
+#include <optional>
+
+#include "core/fpdfapi/parser/cpdf_dictionary.h"
+#include "core/fpdfapi/parser/cpdf_stream.h"
+#include "core/fxcrt/check.h"
+#include "core/fxge/dib/cfx_dibbase.h"
+
+namespace {
+
+size_t EstimateSize(const CPDF_DocImageCache::Image& image) {
+  size_t bytes = image.bitmap->GetEstimatedImageMemoryBurden();
+  if (image.mask) {
+    bytes += image.mask->GetEstimatedImageMemoryBurden();
+  }
+  return bytes;
+}
+
+// A full size image suits any size. A downscaled one only suits sizes it is
+// at least as large as.
+bool IsLargeEnough(const CPDF_DocImageCache::Image& image,
+                   const CFX_Size& max_size_required) {
+  if (image.resolution_levels_skipped == 0) {
+    return true;
+  }
+  if (max_size_required.width == 0 && max_size_required.height == 0) {
+    return false;
+  }
+  return image.bitmap->GetWidth() >= max_size_required.width &&
+         image.bitmap->GetHeight() >= max_size_required.height;
+}
+
+constinit CacheBudget g_image_budget(CPDF_DocImageCache::kDefaultMaxBytes);
+
+}  // namespace
+
+// static
+CacheBudget* CPDF_DocImageCache::GetImageBudget() {
+  return &g_image_budget;
+}
+
+CPDF_DocImageCache::CPDF_DocImageCache()
+    : CPDF_DocImageCache(GetImageBudget()) {}
+
+CPDF_DocImageCache::CPDF_DocImageCache(CacheBudget* budget)
+    : budget_(budget) {
+  std::lock_guard<std::mutex> lock(budget_->lock());
+  budget_->AddEvictable(this);
+}
+
+CPDF_DocImageCache::~CPDF_DocImageCache() {
+  std::lock_guard<std::mutex> lock(budget_->lock());
+  budget_->RemoveEvictable(this);
+  budget_->Remove(bytes_);
+}
+
+std::optional<CPDF_DocImageCache::Image> CPDF_DocImageCache::Get(
+    const Key& key,
+    const CFX_Size& max_size_required) {
+  std::lock_guard<std::mutex> lock(budget_->lock());
+  budget_->EvictUntilFits(this, 0);
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    budget_->RecordMiss();
+    return std::nullopt;
+  }
+
+  // Prefer the smallest image that is large enough.
+  std::optional<EntryList::iterator> best;
+  for (EntryList::iterator entry_it : it->second) {
+    if (!IsLargeEnough(entry_it->image, max_size_required)) {
+      continue;
+    }
+    if (!best.has_value() ||
+        entry_it->image.resolution_levels_skipped >
+            best.value()->image.resolution_levels_skipped) {
+      best = entry_it;
+    }
+  }
+  if (!best.has_value()) {
+    budget_->RecordMiss();
+    return std::nullopt;
+  }
+
+  budget_->RecordHit();
+  best.value()->last_use = budget_->Use(this);
+  entries_.splice(entries_.begin(), entries_, best.value());
+  return best.value()->image;
+}
+
+void CPDF_DocImageCache::Put(const Key& key, Image image) {
+  CHECK(image.bitmap);
+  std::lock_guard<std::mutex> lock(budget_->lock());
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    auto same_level = std::find_if(
+        it->second.begin(), it->second.end(),
+        [&image](EntryList::iterator entry_it) {
+          return entry_it->image.resolution_levels_skipped ==
+                 image.resolution_levels_skipped;
+        });
+    if (same_level != it->second.end()) {
+      budget_->Remove(Erase(*same_level));
+    }
+  }
+
+  const size_t bytes = EstimateSize(image);
+  if (bytes > budget_->max_bytes() || !budget_->EvictUntilFits(this, bytes)) {
+    return;
+  }
+
+  entries_.push_front({.key = key,
+                       .image = std::move(image),
+                       .bytes = bytes,
+                       .last_use = budget_->Use(this)});
+  index_[key].push_back(entries_.begin());
+  bytes_ += bytes;
+  budget_->Add(bytes);
+}
+
+void CPDF_DocImageCache::Remove(const CPDF_Stream* stream) {
+  std::lock_guard<std::mutex> lock(budget_->lock());
+  for (auto entry_it = entries_.begin(); entry_it != entries_.end();) {
+    auto next_it = std::next(entry_it);
+    if (entry_it->key.stream == stream) {
+      budget_->Remove(Erase(entry_it));
+    }
+    entry_it = next_it;
+  }
+}
+
+void CPDF_DocImageCache::Trim() {
+  std::lock_guard<std::mutex> lock(budget_->lock());
+  budget_->EvictUntilFits(this, 0);
+}
+
+size_t CPDF_DocImageCache::bytes() const {
+  std::lock_guard<std::mutex> lock(budget_->lock());
+  return bytes_;
+}
+
+std::optional<uint64_t> CPDF_DocImageCache::GetOldestUse() const {
+  if (entries_.empty()) {
+    return std::nullopt;
+  }
+  return entries_.back().last_use;
+}
+
+void CPDF_DocImageCache::EvictOldest() {
+  budget_->Evict(Erase(std::prev(entries_.end())));
+}
+
+size_t CPDF_DocImageCache::Erase(EntryList::iterator entry_it) {
+  auto it = index_.find(entry_it->key);
+  CHECK(it != index_.end());
+  std::erase(it->second, entry_it);
+  if (it->second.empty()) {
+    index_.erase(it);
+  }
+  const size_t bytes = entry_it->bytes;
+  bytes_ -= bytes;
+  entries_.erase(entry_it);
+  return bytes;
+}
@@ -0,0 +1,125 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FPDFAPI_PAGE_CPDF_DOCIMAGECACHE_H_
+#define CORE_FPDFAPI_PAGE_CPDF_DOCIMAGECACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <list>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "core/fpdfapi/page/cpdf_colorspace.h"
+#include "core/fxcrt/cache_budget.h"
+#include "core/fxcrt/fx_coordinates.h"
+#include "core/fxcrt/retain_ptr.h"
+#include "core/fxcrt/unowned_ptr.h"
+#include "third_party/abseil-cpp/absl/container/flat_hash_map.h"
+
+class CFX_DIBBase;
+class CPDF_Dictionary;
+class CPDF_Stream;
+
+// Caches decoded images for a whole document, so images that appear on many
+// pages, like logos and backgrounds, only get decoded once. An image may be
+// cached at several resolutions, one per number of resolution levels the
+// decoder skipped. The image caches of all documents share one byte budget,
+// and evict the least recently used bitmaps across the documents used on the
+// current thread to make room. A bitmap that still does not fit does not get
+// cached.
+class CPDF_DocImageCache final : public CacheBudget::Evictable {
+ public:
+  // Everything that decoding an image stream depends on, other than the
+  // resolution.
+  struct Key {
+    bool operator==(const Key& that) const = default;
+
+    template <typename H>
+    friend H AbslHashValue(H h, const Key& key) {
+      return H::combine(std::move(h), key.stream.Get(),
+                        key.page_color_spaces.Get(), key.group_family,
+                        key.std_cs, key.load_mask);
+    }
+
+    // Not an inline image stream. Those belong to a single page object.
+    RetainPtr<const CPDF_Stream> stream;
+    // The /ColorSpace resource dictionary that named color spaces in the
+    // image dictionary resolve against, if any.
+    RetainPtr<const CPDF_Dictionary> page_color_spaces;
+    CPDF_ColorSpace::Family group_family = CPDF_ColorSpace::Family::kUnknown;
+    bool std_cs = false;
+    bool load_mask = false;
+  };
+
+  struct Image {
+    RetainPtr<CFX_DIBBase> bitmap;
+    RetainPtr<CFX_DIBBase> mask;
+    uint32_t matte_color = 0;
+    // Number of times `bitmap` got halved in size while decoding.
+    uint8_t resolution_levels_skipped = 0;
+  };
+
+  static constexpr size_t kDefaultMaxBytes = 128 * 1024 * 1024;
+
+  // The budget that image caches use by default. `kDefaultMaxBytes` by
+  // default.
+  static CacheBudget* GetImageBudget();
+
+  CPDF_DocImageCache();
+  // `budget` must outlive this cache.
+  explicit CPDF_DocImageCache(CacheBudget* budget);
+  ~CPDF_DocImageCache();
+
+  // Returns a copy of the smallest cached image for `key` that is at least
+  // `max_size_required` in size, or nullopt. A zero `max_size_required`
+  // requires the full size. Evicts images first if the budget is exceeded.
+  std::optional<Image> Get(const Key& key, const CFX_Size& max_size_required);
+
+  // Caches `image` for `key`, replacing any image at the same resolution,
+  // unless it does not fit in the budget after evicting other images.
+  void Put(const Key& key, Image image);
+
+  // Drops all images decoded from `stream`, e.g. after it got modified.
+  void Remove(const CPDF_Stream* stream);
+
+  // Evicts images until the budget is no longer exceeded, or the documents
+  // used on the current thread have no images left.
+  void Trim();
+
+  CacheBudget* budget() const { return budget_; }
+
+  // Bytes used by this cache's images.
+  size_t bytes() const;
+
+  // CacheBudget::Evictable:
+  std::optional<uint64_t> GetOldestUse() const override;
+  void EvictOldest() override;
+
+ private:
+  struct Entry {
+    Key key;
+    Image image;
+    size_t bytes;
+    // From CacheBudget::Use().
+    uint64_t last_use;
+  };
+  using EntryList = std::list<Entry>;
+
+  // Returns the bytes freed, for the caller to remove from the budget.
+  size_t Erase(EntryList::iterator entry_it);
+
+  UnownedPtr<CacheBudget> const budget_;
+  // The members below are guarded by the budget's lock, as other caches
+  // sharing the budget may evict from this one.
+  size_t bytes_ = 0;
+  // Most recently used first.
+  EntryList entries_;
+  // The entries for each key, one per resolution.
+  absl::flat_hash_map<Key, std::vector<EntryList::iterator>> index_;
+};
+
+#endif  // CORE_FPDFAPI_PAGE_CPDF_DOCIMAGECACHE_H_
@@ -0,0 +1,232 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/page/cpdf_docimagecache.h"
+
+#include <stdint.h>
+
+#include <optional>
+#include <thread>
+#include <utility>
+
+#include "core/fpdfapi/parser/cpdf_dictionary.h"
+#include "core/fpdfapi/parser/cpdf_stream.h"
+#include "core/fxcrt/cache_budget.h"
+#include "core/fxcrt/check.h"
+#include "core/fxge/dib/cfx_dibitmap.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+RetainPtr<CPDF_Stream> CreateStream() {
+  return pdfium::MakeRetain<CPDF_Stream>(pdfium::MakeRetain<CPDF_Dictionary>());
+}
+
+CPDF_DocImageCache::Key CreateKey(RetainPtr<const CPDF_Stream> stream) {
+  return {.stream = std::move(stream),
+          .group_family = CPDF_ColorSpace::Family::kDeviceRGB,
+          .std_cs = true};
+}
+
+// Returns an image that is a full size `width` by `width` image halved
+// `levels_skipped` times.
+CPDF_DocImageCache::Image CreateImage(int width, uint8_t levels_skipped) {
+  auto bitmap = pdfium::MakeRetain<CFX_DIBitmap>();
+  const int scaled_width = width >> levels_skipped;
+  CHECK(bitmap->Create(scaled_width, scaled_width, FXDIB_Format::kBgr));
+  return {.bitmap = std::move(bitmap),
+          .resolution_levels_skipped = levels_skipped};
+}
+
+size_t GetImageSize(int width) {
+  return CreateImage(width, 0).bitmap->GetEstimatedImageMemoryBurden();
+}
+
+}  // namespace
+
+TEST(CPDFDocImageCacheTest, KeyIncludesDecodeParameters) {
+  CacheBudget budget(CacheBudget::kUnlimited);
+  CPDF_DocImageCache cache(&budget);
+  auto stream = CreateStream();
+  CPDF_DocImageCache::Key key = CreateKey(stream);
+  EXPECT_FALSE(cache.Get(key, {0, 0}));
+
+  cache.Put(key, CreateImage(16, 0));
+  EXPECT_EQ(GetImageSize(16), cache.bytes());
+  EXPECT_EQ(GetImageSize(16), budget.bytes());
+  std::optional<CPDF_DocImageCache::Image> image = cache.Get(key, {0, 0});
+  ASSERT_TRUE(image);
+  EXPECT_EQ(16, image->bitmap->GetWidth());
+
+  // Other pages share the image, unless it gets decoded differently.
+  EXPECT_TRUE(cache.Get(CreateKey(stream), {0, 0}));
+  CPDF_DocImageCache::Key other_key = CreateKey(stream);
+  other_key.load_mask = true;
+  EXPECT_FALSE(cache.Get(other_key, {0, 0}));
+  other_key = CreateKey(stream);
+  other_key.page_color_spaces = pdfium::MakeRetain<CPDF_Dictionary>();
+  EXPECT_FALSE(cache.Get(other_key, {0, 0}));
+  EXPECT_FALSE(cache.Get(CreateKey(CreateStream()), {0, 0}));
+
+  const CacheBudget::Stats stats = budget.GetStats();
+  EXPECT_EQ(2u, stats.hits);
+  EXPECT_EQ(4u, stats.misses);
+  EXPECT_EQ(0u, stats.evictions);
+}
+
+TEST(CPDFDocImageCacheTest, ResolutionLevels) {
+  CacheBudget budget(CacheBudget::kUnlimited);
+  CPDF_DocImageCache cache(&budget);
+  CPDF_DocImageCache::Key key = CreateKey(CreateStream());
+
+  // A downscaled image only serves sizes it is large enough for.
+  cache.Put(key, CreateImage(64, 2));
+  std::optional<CPDF_DocImageCache::Image> image = cache.Get(key, {10, 10});
+  ASSERT_TRUE(image);
+  EXPECT_EQ(16, image->bitmap->GetWidth());
+  EXPECT_FALSE(cache.Get(key, {20, 20}));
+  EXPECT_FALSE(cache.Get(key, {0, 0}));
+
+  // The smallest large enough image wins.
+  cache.Put(key, CreateImage(64, 0));
+  cache.Put(key, CreateImage(64, 1));
+  EXPECT_EQ(GetImageSize(16) + GetImageSize(32) + GetImageSize(64),
+            cache.bytes());
+  image = cache.Get(key, {10, 10});
+  ASSERT_TRUE(image);
+  EXPECT_EQ(16, image->bitmap->GetWidth());
+  image = cache.Get(key, {20, 20});
+  ASSERT_TRUE(image);
+  EXPECT_EQ(32, image->bitmap->GetWidth());
+  image = cache.Get(key, {0, 0});
+  ASSERT_TRUE(image);
+  EXPECT_EQ(64, image->bitmap->GetWidth());
+
+  // Putting the same level again replaces it.
+  cache.Put(key, CreateImage(64, 1));
+  EXPECT_EQ(GetImageSize(16) + GetImageSize(32) + GetImageSize(64),
+            cache.bytes());
+
+  cache.Remove(key.stream.Get());
+  EXPECT_EQ(0u, cache.bytes());
+  EXPECT_EQ(0u, budget.bytes());
+  EXPECT_EQ(0u, budget.GetStats().evictions);
+  EXPECT_FALSE(cache.Get(key, {10, 10}));
+}
+
+TEST(CPDFDocImageCacheTest, EvictsLeastRecentlyUsed) {
+  CacheBudget budget(3 * GetImageSize(16));
+  CPDF_DocImageCache cache(&budget);
+  CPDF_DocImageCache::Key key1 = CreateKey(CreateStream());
+  CPDF_DocImageCache::Key key2 = CreateKey(CreateStream());
+  CPDF_DocImageCache::Key key3 = CreateKey(CreateStream());
+  CPDF_DocImageCache::Key key4 = CreateKey(CreateStream());
+  cache.Put(key1, CreateImage(16, 0));
+  cache.Put(key2, CreateImage(16, 0));
+  cache.Put(key3, CreateImage(16, 0));
+
+  // Makes `key2` the least recently used.
+  EXPECT_TRUE(cache.Get(key1, {0, 0}));
+  cache.Put(key4, CreateImage(16, 0));
+  EXPECT_EQ(1u, budget.GetStats().evictions);
+  EXPECT_EQ(3 * GetImageSize(16), budget.bytes());
+  EXPECT_FALSE(cache.Get(key2, {0, 0}));
+  EXPECT_TRUE(cache.Get(key1, {0, 0}));
+  EXPECT_TRUE(cache.Get(key3, {0, 0}));
+  EXPECT_TRUE(cache.Get(key4, {0, 0}));
+
+  // Images larger than the budget do not get cached, and do not evict
+  // anything either.
+  cache.Put(key2, CreateImage(64, 0));
+  EXPECT_FALSE(cache.Get(key2, {0, 0}));
+  EXPECT_EQ(3 * GetImageSize(16), budget.bytes());
+  EXPECT_EQ(1u, budget.GetStats().evictions);
+
+  // Trimming after lowering the limit evicts from the least recently used
+  // end.
+  budget.SetMaxBytes(GetImageSize(16));
+  cache.Trim();
+  EXPECT_EQ(3u, budget.GetStats().evictions);
+  EXPECT_EQ(GetImageSize(16), budget.bytes());
+  EXPECT_TRUE(cache.Get(key4, {0, 0}));
+  EXPECT_FALSE(cache.Get(key3, {0, 0}));
+
+  // A limit of 0 evicts everything.
+  budget.SetMaxBytes(0);
+  cache.Trim();
+  EXPECT_EQ(4u, budget.GetStats().evictions);
+  EXPECT_EQ(0u, cache.bytes());
+  cache.Put(key1, CreateImage(16, 0));
+  EXPECT_FALSE(cache.Get(key1, {0, 0}));
+}
+
+// Documents share the budget, and evict the least recently used images across
+// the documents used on the current thread.
+TEST(CPDFDocImageCacheTest, SharedBudget) {
+  CacheBudget budget(2 * GetImageSize(16));
+  CPDF_DocImageCache cache1(&budget);
+  CPDF_DocImageCache cache2(&budget);
+  CPDF_DocImageCache::Key key1 = CreateKey(CreateStream());
+  CPDF_DocImageCache::Key key2 = CreateKey(CreateStream());
+  CPDF_DocImageCache::Key key3 = CreateKey(CreateStream());
+  cache1.Put(key1, CreateImage(16, 0));
+  cache1.Put(key2, CreateImage(16, 0));
+  EXPECT_EQ(2 * GetImageSize(16), budget.bytes());
+
+  // The budget is full of the first document's images, so the second one
+  // evicts the least recently used of them.
+  cache2.Put(key3, CreateImage(16, 0));
+  EXPECT_EQ(1u, budget.GetStats().evictions);
+  EXPECT_EQ(GetImageSize(16), cache1.bytes());
+  EXPECT_EQ(GetImageSize(16), cache2.bytes());
+  EXPECT_FALSE(cache1.Get(key1, {0, 0}));
+  EXPECT_TRUE(cache1.Get(key2, {0, 0}));
+
+  // Now the second document has the least recently used image.
+  cache1.Put(key1, CreateImage(16, 0));
+  EXPECT_EQ(2u, budget.GetStats().evictions);
+  EXPECT_EQ(0u, cache2.bytes());
+  EXPECT_FALSE(cache2.Get(key3, {0, 0}));
+  EXPECT_TRUE(cache1.Get(key1, {0, 0}));
+  EXPECT_TRUE(cache1.Get(key2, {0, 0}));
+
+  // Lowering the limit also trims the other document.
+  budget.SetMaxBytes(0);
+  cache2.Trim();
+  EXPECT_EQ(0u, cache1.bytes());
+  EXPECT_EQ(0u, budget.bytes());
+
+  // Closing a document gives back its bytes.
+  budget.SetMaxBytes(CacheBudget::kUnlimited);
+  cache1.Put(key1, CreateImage(16, 0));
+  {
+    CPDF_DocImageCache cache3(&budget);
+    cache3.Put(key2, CreateImage(16, 0));
+    EXPECT_EQ(2 * GetImageSize(16), budget.bytes());
+  }
+  EXPECT_EQ(GetImageSize(16), budget.bytes());
+}
+
+// Images of a document last used on another thread may still be in use there,
+// so they do not get evicted.
+TEST(CPDFDocImageCacheTest, SharedBudgetAcrossThreads) {
+  CacheBudget budget(GetImageSize(16));
+  CPDF_DocImageCache cache1(&budget);
+  CPDF_DocImageCache cache2(&budget);
+  CPDF_DocImageCache::Key key1 = CreateKey(CreateStream());
+  CPDF_DocImageCache::Key key2 = CreateKey(CreateStream());
+  std::thread([&] { cache1.Put(key1, CreateImage(16, 0)); }).join();
+  EXPECT_EQ(GetImageSize(16), cache1.bytes());
+
+  cache2.Put(key2, CreateImage(16, 0));
+  EXPECT_EQ(0u, cache2.bytes());
+  EXPECT_EQ(0u, budget.GetStats().evictions);
+
+  // Once the first document is used on this thread, its images can go.
+  EXPECT_TRUE(cache1.Get(key1, {0, 0}));
+  cache2.Put(key2, CreateImage(16, 0));
+  EXPECT_EQ(GetImageSize(16), cache2.bytes());
+  EXPECT_EQ(0u, cache1.bytes());
+  EXPECT_EQ(1u, budget.GetStats().evictions);
+}
@@ -13,6 +13,7 @@
 
 #include "core/fpdfapi/font/cpdf_font.h"
 #include "core/fpdfapi/page/cpdf_colorspace.h"
+#include "core/fpdfapi/page/cpdf_docimagecache.h"
 #include "core/fpdfapi/parser/cpdf_document.h"
 #include "core/fxcrt/bytestring.h"
 #include "core/fxcrt/data_vector.h"
@@ -87,6 +88,8 @@ class CPDF_DocPageData final : public CPDF_Document::PageDataIface,
   RetainPtr<CPDF_IccProfile> GetIccProfile(
       RetainPtr<const CPDF_Stream> pProfileStream);
 
+  CPDF_DocImageCache* GetImageCache() { return &image_cache_; }
+
  private:
   struct HashIccProfileKey {
     HashIccProfileKey(DataVector<uint8_t> digest, uint32_t components);
@@ -131,6 +134,10 @@ class CPDF_DocPageData final : public CPDF_Document::PageDataIface,
   std::map<RetainPtr<const CPDF_Object>, RetainPtr<CPDF_Pattern>> pattern_map_;
   std::map<uint32_t, RetainPtr<CPDF_Image>> image_map_;
   std::map<RetainPtr<const CPDF_Dictionary>, RetainPtr<CPDF_Font>> font_map_;
+
+  // Cached bitmaps may refer to color spaces and streams from the maps above.
+  // Declared last, so it gets destroyed first.
+  CPDF_DocImageCache image_cache_;
 };
 
 #endif  // CORE_FPDFAPI_PAGE_CPDF_DOCPAGEDATA_H_
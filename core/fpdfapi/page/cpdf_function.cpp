@@ -173,6 +173,68 @@ std::optional<uint32_t> CPDF_Function::Call(pdfium::span<const float> inputs,
   return outputs_;
 }
 
+bool CPDF_Function::CallBatch(size_t count,
+                              pdfium::span<const float> inputs,
+                              pdfium::span<float> results) const {
+  FX_SAFE_SIZE_T input_size = count;
+  input_size *= inputs_;
+  FX_SAFE_SIZE_T result_size = count;
+  result_size *= outputs_;
+  if (!input_size.IsValid() || !result_size.IsValid() ||
+      inputs.size() != input_size.ValueOrDie() ||
+      results.size() < result_size.ValueOrDie()) {
+    return false;
+  }
+
+  for (uint32_t i = 0; i < inputs_; i++) {
+    if (domains_[i * 2] > domains_[i * 2 + 1]) {
+      return false;
+    }
+  }
+  if (!ranges_.empty()) {
+    for (uint32_t i = 0; i < outputs_; i++) {
+      if (ranges_[i * 2] > ranges_[i * 2 + 1]) {
+        return false;
+      }
+    }
+  }
+  if (count == 0) {
+    return true;
+  }
+
+  std::vector<float> clamped_inputs(inputs.begin(), inputs.end());
+  for (size_t i = 0; i < clamped_inputs.size(); i++) {
+    const size_t domain = i % inputs_;
+    clamped_inputs[i] = std::clamp(clamped_inputs[i], domains_[domain * 2],
+                                   domains_[domain * 2 + 1]);
+  }
+  results = results.first(result_size.ValueOrDie());
+  if (!v_CallBatch(count, clamped_inputs, results)) {
+    return false;
+  }
+
+  if (!ranges_.empty()) {
+    for (size_t i = 0; i < results.size(); i++) {
+      const size_t range = i % outputs_;
+      results[i] =
+          std::clamp(results[i], ranges_[range * 2], ranges_[range * 2 + 1]);
+    }
+  }
+  return true;
+}
+
+bool CPDF_Function::v_CallBatch(size_t count,
+                                pdfium::span<const float> inputs,
+                                pdfium::span<float> results) const {
+  for (size_t i = 0; i < count; i++) {
+    if (!v_Call(inputs.subspan(i * inputs_, inputs_),
+                results.subspan(i * outputs_, outputs_))) {
+      return false;
+    }
+  }
+  return true;
+}
+
 // See PDF Reference 1.7, page 170.
 float CPDF_Function::Interpolate(float x,
                                  float xmin,
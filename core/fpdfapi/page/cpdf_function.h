@@ -7,6 +7,9 @@
 #ifndef CORE_FPDFAPI_PAGE_CPDF_FUNCTION_H_
 #define CORE_FPDFAPI_PAGE_CPDF_FUNCTION_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <memory>
 #include <optional>
 #include <set>
@@ -38,6 +41,13 @@ class CPDF_Function {
 
   std::optional<uint32_t> Call(pdfium::span<const float> inputs,
                                pdfium::span<float> results) const;
+  // Same as calling Call() `count` times, for points whose InputCount() inputs
+  // and OutputCount() results follow one another in `inputs` and `results`.
+  // Returns false if any of the calls fails. `results` then has unspecified
+  // values.
+  bool CallBatch(size_t count,
+                 pdfium::span<const float> inputs,
+                 pdfium::span<float> results) const;
   uint32_t InputCount() const { return inputs_; }
   uint32_t OutputCount() const { return outputs_; }
   float GetDomain(int i) const { return domains_[i]; }
@@ -66,6 +76,10 @@ class CPDF_Function {
   virtual bool v_Init(const CPDF_Object* pObj, VisitedSet* pVisited) = 0;
   virtual bool v_Call(pdfium::span<const float> inputs,
                       pdfium::span<float> results) const = 0;
+  // Calls v_Call() for each point by default.
+  virtual bool v_CallBatch(size_t count,
+                           pdfium::span<const float> inputs,
+                           pdfium::span<float> results) const;
 
   const Type type_;
   uint32_t inputs_ = 0;
@@ -4,10 +4,18 @@
 
 #include "core/fpdfapi/page/cpdf_function.h"
 
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
 #include "core/fpdfapi/parser/cpdf_array.h"
 #include "core/fpdfapi/parser/cpdf_dictionary.h"
 #include "core/fpdfapi/parser/cpdf_number.h"
+#include "core/fpdfapi/parser/cpdf_stream.h"
+#include "core/fxcrt/data_vector.h"
 #include "core/fxcrt/retain_ptr.h"
+#include "core/fxcrt/span.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 TEST(CPDFFunction, BadFunctionType) {
@@ -41,3 +49,65 @@ TEST(CPDFFunction, NoRange) {
   pArray->AppendNew<CPDF_Number>(10);
   EXPECT_FALSE(CPDF_Function::Load(dict));
 }
+
+TEST(CPDFFunction, CallBatch) {
+  auto type2_dict = pdfium::MakeRetain<CPDF_Dictionary>();
+  type2_dict->SetNewFor<CPDF_Number>("FunctionType", 2);
+  type2_dict->SetNewFor<CPDF_Number>("N", 2);
+  auto domain = type2_dict->SetNewFor<CPDF_Array>("Domain");
+  domain->AppendNew<CPDF_Number>(0);
+  domain->AppendNew<CPDF_Number>(1);
+  auto c0 = type2_dict->SetNewFor<CPDF_Array>("C0");
+  c0->AppendNew<CPDF_Number>(0);
+  c0->AppendNew<CPDF_Number>(1);
+  auto c1 = type2_dict->SetNewFor<CPDF_Array>("C1");
+  c1->AppendNew<CPDF_Number>(0.5f);
+  c1->AppendNew<CPDF_Number>(2);
+
+  auto type4_dict = pdfium::MakeRetain<CPDF_Dictionary>();
+  type4_dict->SetNewFor<CPDF_Number>("FunctionType", 4);
+  domain = type4_dict->SetNewFor<CPDF_Array>("Domain");
+  for (int value : {0, 1, -1, 1}) {
+    domain->AppendNew<CPDF_Number>(value);
+  }
+  auto range = type4_dict->SetNewFor<CPDF_Array>("Range");
+  for (int value : {0, 1, -1, 1}) {
+    range->AppendNew<CPDF_Number>(value);
+  }
+  static constexpr uint8_t kContents[] =
+      "{ 2 copy gt { exch } if 2 copy sub 3 1 roll add 2 div }";
+  auto type4_stream = pdfium::MakeRetain<CPDF_Stream>(
+      DataVector<uint8_t>(std::begin(kContents), std::end(kContents)),
+      std::move(type4_dict));
+
+  for (RetainPtr<const CPDF_Object> object :
+       {RetainPtr<const CPDF_Object>(type2_dict),
+        RetainPtr<const CPDF_Object>(type4_stream)}) {
+    std::unique_ptr<CPDF_Function> func = CPDF_Function::Load(object);
+    ASSERT_TRUE(func);
+    const uint32_t inputs = func->InputCount();
+    const uint32_t outputs = func->OutputCount();
+
+    // Includes inputs outside of the domain.
+    std::vector<float> batch_inputs;
+    for (int i = 0; i < 7 * static_cast<int>(inputs); ++i) {
+      batch_inputs.push_back(i * 0.37f - 0.5f);
+    }
+    std::vector<float> results(7 * outputs);
+    ASSERT_TRUE(func->CallBatch(7, batch_inputs, results));
+    for (size_t i = 0; i < 7; ++i) {
+      std::vector<float> expected(outputs);
+      ASSERT_EQ(outputs, func->Call(pdfium::span(batch_inputs)
+                                        .subspan(i * inputs, inputs),
+                                    expected));
+      for (size_t j = 0; j < outputs; ++j) {
+        EXPECT_EQ(expected[j], results[i * outputs + j]);
+      }
+    }
+
+    EXPECT_TRUE(func->CallBatch(0, {}, {}));
+    EXPECT_FALSE(func->CallBatch(6, batch_inputs, results));
+    EXPECT_FALSE(
+        func->CallBatch(7, batch_inputs, pdfium::span(results).first(1u)));
+  }
+}
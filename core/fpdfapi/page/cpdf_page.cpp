@@ -8,6 +8,7 @@
 
 #include <set>
 #include <utility>
+#include <vector>
 
 #include "constants/page_object.h"
 #include "core/fpdfapi/page/cpdf_contentparser.h"
@@ -77,6 +78,17 @@ void CPDF_Page::ParseContent() {
   ContinueParse(nullptr);
 }
 
+void CPDF_Page::ParseContentWithLoadedStreams(
+    std::vector<RetainPtr<CPDF_StreamAcc>> streams) {
+  if (GetParseState() != ParseState::kNotParsed) {
+    ParseContent();
+    return;
+  }
+
+  StartParse(std::make_unique<CPDF_ContentParser>(this, std::move(streams)));
+  ContinueParse(nullptr);
+}
+
 RetainPtr<CPDF_Object> CPDF_Page::GetMutablePageAttr(ByteStringView name) {
   return pdfium::WrapRetain(const_cast<CPDF_Object*>(GetPageAttr(name).Get()));
 }
@@ -10,6 +10,7 @@
 #include <memory>
 #include <optional>
 #include <utility>
+#include <vector>
 
 #include "core/fpdfapi/page/cpdf_pageobjectholder.h"
 #include "core/fpdfapi/page/ipdf_page.h"
@@ -24,6 +25,7 @@ class CPDF_Dictionary;
 class CPDF_Document;
 class CPDF_Object;
 class CPDF_PageImageCache;
+class CPDF_StreamAcc;
 
 class CPDF_Page final : public IPDF_Page, public CPDF_PageObjectHolder {
  public:
@@ -39,6 +41,13 @@ class CPDF_Page final : public IPDF_Page, public CPDF_PageObjectHolder {
     virtual ~RenderContextIface() = default;
   };
 
+  // A copy of this page for the embedder API to keep between renders, e.g. for
+  // other threads to render from.
+  class SnapshotIface {
+   public:
+    virtual ~SnapshotIface() = default;
+  };
+
   class RenderContextClearer {
    public:
     FX_STACK_ALLOCATED();
@@ -72,6 +81,10 @@ class CPDF_Page final : public IPDF_Page, public CPDF_PageObjectHolder {
   bool IsPage() const override;
 
   void ParseContent();
+  // Same as ParseContent(), with the content streams from
+  // CPDF_ContentParser::GetPageContentStreams() already loaded.
+  void ParseContentWithLoadedStreams(
+      std::vector<RetainPtr<CPDF_StreamAcc>> streams);
   const CFX_SizeF& GetPageSize() const { return page_size_; }
   const CFX_Matrix& GetPageMatrix() const { return page_matrix_; }
   CFX_Matrix GetDisplayMatrix() const;
@@ -91,6 +104,11 @@ class CPDF_Page final : public IPDF_Page, public CPDF_PageObjectHolder {
   void SetRenderContext(std::unique_ptr<RenderContextIface> pContext);
   void ClearRenderContext();
 
+  SnapshotIface* GetSnapshot() { return snapshot_.get(); }
+  void SetSnapshot(std::unique_ptr<SnapshotIface> snapshot) {
+    snapshot_ = std::move(snapshot);
+  }
+
   void SetView(View* pView) { view_.Reset(pView); }
   void ClearView();
   void UpdateDimensions();
@@ -110,6 +128,7 @@ class CPDF_Page final : public IPDF_Page, public CPDF_PageObjectHolder {
   UnownedPtr<CPDF_Document> const pdf_document_;
   std::unique_ptr<CPDF_PageImageCache> page_image_cache_;
   std::unique_ptr<RenderContextIface> render_context_;
+  std::unique_ptr<SnapshotIface> snapshot_;
   ObservedPtr<View> view_;
 };
 
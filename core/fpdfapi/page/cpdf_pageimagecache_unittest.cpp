@@ -15,6 +15,7 @@
 #include "core/fpdfapi/page/cpdf_pagemodule.h"
 #include "core/fpdfapi/parser/cpdf_parser.h"
 #include "core/fpdfapi/render/cpdf_docrenderdata.h"
+#include "core/fxcrt/cache_budget.h"
 #include "core/fxcrt/fx_stream.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/utils/path_service.h"
@@ -84,4 +85,89 @@ TEST(CPDFPageImageCache, RenderBug1924) {
   DestroyPageModule();
 }
 
+TEST(CPDFPageImageCache, DownscaleJpeg) {
+  // JPEG images get decoded at 1/2, 1/4 or 1/8 of their size when drawn small
+  // enough. The cache has to redecode them at a larger size when needed, and
+  // keeps the smaller sizes for when the image gets drawn small again.
+  InitializePageModule();
+  {
+    std::string file_path = PathService::GetTestFilePath("embedded_images.pdf");
+    ASSERT_FALSE(file_path.empty());
+    auto document =
+        std::make_unique<CPDF_Document>(std::make_unique<CPDF_DocRenderData>(),
+                                        std::make_unique<CPDF_DocPageData>());
+    ASSERT_EQ(document->LoadDoc(
+                  IFX_SeekableReadStream::CreateFromFilename(file_path.c_str()),
+                  nullptr),
+              CPDF_Parser::SUCCESS);
+
+    RetainPtr<CPDF_Dictionary> page_dict =
+        document->GetMutablePageDictionary(0);
+    ASSERT_TRUE(page_dict);
+    auto page =
+        pdfium::MakeRetain<CPDF_Page>(document.get(), std::move(page_dict));
+    page->AddPageImageCache();
+    page->ParseContent();
+
+    CPDF_PageImageCache* page_image_cache = page->GetPageImageCache();
+    ASSERT_TRUE(page_image_cache);
+
+    // The 126x106 DCTDecode image.
+    CPDF_ImageObject* image = nullptr;
+    for (size_t i = 0; i < page->GetPageObjectCount(); ++i) {
+      CPDF_ImageObject* candidate = page->GetPageObjectByIndex(i)->AsImage();
+      if (candidate && candidate->GetImage()->GetPixelWidth() == 126) {
+        image = candidate;
+        break;
+      }
+    }
+    ASSERT_TRUE(image);
+
+    auto get_bitmap = [&](const CFX_Size& max_size_required) {
+      bool should_continue = page_image_cache->StartGetCachedBitmap(
+          image->GetImage(), nullptr, page->GetMutablePageResources(), true,
+          CPDF_ColorSpace::Family::kDeviceRGB, false, max_size_required);
+      while (should_continue) {
+        should_continue = page_image_cache->Continue(nullptr);
+      }
+      return page_image_cache->DetachCurBitmap();
+    };
+
+    const CacheBudget::Stats stats_before =
+        CPDF_DocImageCache::GetImageBudget()->GetStats();
+    RetainPtr<CFX_DIBBase> bitmap = get_bitmap({25, 25});
+    ASSERT_TRUE(bitmap);
+    EXPECT_EQ(32, bitmap->GetWidth());
+    EXPECT_EQ(27, bitmap->GetHeight());
+
+    bitmap = get_bitmap({50, 50});
+    ASSERT_TRUE(bitmap);
+    EXPECT_EQ(63, bitmap->GetWidth());
+    EXPECT_EQ(53, bitmap->GetHeight());
+
+    // The 1/2 size bitmap is still good enough.
+    bitmap = get_bitmap({40, 40});
+    ASSERT_TRUE(bitmap);
+    EXPECT_EQ(63, bitmap->GetWidth());
+
+    bitmap = get_bitmap({0, 0});
+    ASSERT_TRUE(bitmap);
+    EXPECT_EQ(126, bitmap->GetWidth());
+    EXPECT_EQ(106, bitmap->GetHeight());
+
+    bitmap = get_bitmap({25, 25});
+    ASSERT_TRUE(bitmap);
+    EXPECT_EQ(32, bitmap->GetWidth());
+
+    const CacheBudget::Stats stats =
+        CPDF_DocImageCache::GetImageBudget()->GetStats();
+    EXPECT_EQ(stats_before.hits + 2, stats.hits);
+    EXPECT_EQ(stats_before.misses + 3, stats.misses);
+
+    ASSERT_TRUE(page->AsPDFPage());
+    page->AsPDFPage()->ClearView();
+  }
+  DestroyPageModule();
+}
+
 }  // namespace pdfium
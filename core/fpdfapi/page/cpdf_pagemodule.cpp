@@ -8,7 +8,6 @@
 
 #include "core/fpdfapi/font/cpdf_fontglobals.h"
 #include "core/fpdfapi/page/cpdf_colorspace.h"
-#include "core/fpdfapi/page/cpdf_streamcontentparser.h"
 
 namespace pdfium {
 
@@ -16,11 +15,9 @@ void InitializePageModule() {
   CPDF_ColorSpace::InitializeGlobals();
   CPDF_FontGlobals::Create();
   CPDF_FontGlobals::GetInstance()->LoadEmbeddedMaps();
-  CPDF_StreamContentParser::InitializeGlobals();
 }
 
 void DestroyPageModule() {
-  CPDF_StreamContentParser::DestroyGlobals();
   CPDF_FontGlobals::Destroy();
   CPDF_ColorSpace::DestroyGlobals();
 }
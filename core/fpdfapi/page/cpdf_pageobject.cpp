@@ -10,6 +10,13 @@
 
 #include "core/fxcrt/fx_coordinates.h"
 
+namespace {
+
+// Per-thread, like the page objects that change it.
+thread_local uint32_t g_indexed_rect_generation = 0;
+
+}  // namespace
+
 CPDF_PageObject::CPDF_PageObject(int32_t content_stream)
     : content_stream_(content_stream) {}
 
@@ -101,6 +108,18 @@ void CPDF_PageObject::SetIsActive(bool value) {
   }
 }
 
+void CPDF_PageObject::SetRect(const CFX_FloatRect& rect) {
+  rect_ = rect;
+  if (indexed_) {
+    ++g_indexed_rect_generation;
+  }
+}
+
+// static
+uint32_t CPDF_PageObject::GetIndexedRectGeneration() {
+  return g_indexed_rect_generation;
+}
+
 void CPDF_PageObject::TransformClipPath(const CFX_Matrix& matrix) {
   CPDF_ClipPath& clip_path = mutable_clip_path();
   if (!clip_path.HasRef()) {
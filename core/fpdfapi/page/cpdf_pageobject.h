@@ -69,7 +69,7 @@ class CPDF_PageObject {
 
   void SetOriginalRect(const CFX_FloatRect& rect) { original_rect_ = rect; }
   const CFX_FloatRect& GetOriginalRect() const { return original_rect_; }
-  void SetRect(const CFX_FloatRect& rect) { rect_ = rect; }
+  void SetRect(const CFX_FloatRect& rect);
   const CFX_FloatRect& GetRect() const { return rect_; }
   FX_RECT GetBBox() const;
   FX_RECT GetTransformedBBox(const CFX_Matrix& matrix) const;
@@ -138,6 +138,11 @@ class CPDF_PageObject {
 
   const CFX_Matrix& original_matrix() const { return original_matrix_; }
 
+  // Marks the object as part of a CPDF_PageObjectIndex. Changing its rect then
+  // changes GetIndexedRectGeneration(), so the index knows to rebuild.
+  void SetIndexed() { indexed_ = true; }
+  static uint32_t GetIndexedRectGeneration();
+
  protected:
   void CopyData(const CPDF_PageObject* pSrcObject);
   void InitializeOriginalMatrix(const CFX_Matrix& matrix);
@@ -159,6 +164,7 @@ class CPDF_PageObject {
   // `original_matrix_`.
   bool matrix_dirty_ = false;
   bool is_active_ = true;
+  bool indexed_ = false;
   int32_t content_stream_;
   // The resource name for this object.
   ByteString resource_name_;
@@ -13,6 +13,7 @@
 #include "core/fpdfapi/page/cpdf_allstates.h"
 #include "core/fpdfapi/page/cpdf_contentparser.h"
 #include "core/fpdfapi/page/cpdf_pageobject.h"
+#include "core/fpdfapi/page/cpdf_pageobjectindex.h"
 #include "core/fpdfapi/parser/cpdf_dictionary.h"
 #include "core/fpdfapi/parser/cpdf_document.h"
 #include "core/fxcrt/check.h"
@@ -187,6 +188,7 @@ void CPDF_PageObjectHolder::AppendPageObject(
     std::unique_ptr<CPDF_PageObject> pPageObj) {
   CHECK(pPageObj);
   page_object_list_.push_back(std::move(pPageObj));
+  object_index_.reset();
 }
 
 bool CPDF_PageObjectHolder::InsertPageObjectAtIndex(
@@ -201,6 +203,7 @@ bool CPDF_PageObjectHolder::InsertPageObjectAtIndex(
   // std::deque::iterator::operator++() has not been marked as unsafe yet.
   page_object_list_.insert(UNSAFE_TODO(page_object_list_.begin() + index),
                            std::move(page_obj));
+  object_index_.reset();
   return true;
 }
 
@@ -214,6 +217,7 @@ std::unique_ptr<CPDF_PageObject> CPDF_PageObjectHolder::RemovePageObject(
 
   std::unique_ptr<CPDF_PageObject> result = std::move(*it);
   page_object_list_.erase(it);
+  object_index_.reset();
 
   int32_t content_stream = pPageObj->GetContentStream();
   if (content_stream >= 0) {
@@ -231,5 +235,25 @@ bool CPDF_PageObjectHolder::ErasePageObjectAtIndex(size_t index) {
   // Unsafe, but the compiler will not complain, because
   // std::deque::iterator::operator++() has not been marked as unsafe yet.
   page_object_list_.erase(UNSAFE_TODO(page_object_list_.begin() + index));
+  object_index_.reset();
   return true;
 }
+
+const CPDF_PageObjectIndex* CPDF_PageObjectHolder::GetObjectIndex() {
+  if (parse_state_ != ParseState::kParsed) {
+    return nullptr;
+  }
+
+  const uint32_t generation = CPDF_PageObject::GetIndexedRectGeneration();
+  if (!object_index_ || object_index_generation_ != generation) {
+    std::vector<CFX_FloatRect> rects;
+    rects.reserve(page_object_list_.size());
+    for (const auto& page_object : page_object_list_) {
+      page_object->SetIndexed();
+      rects.push_back(page_object->GetRect());
+    }
+    object_index_ = std::make_unique<CPDF_PageObjectIndex>(std::move(rects));
+    object_index_generation_ = generation;
+  }
+  return object_index_.get();
+}
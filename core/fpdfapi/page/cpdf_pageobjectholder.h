@@ -30,6 +30,7 @@
 class CPDF_ContentParser;
 class CPDF_Document;
 class CPDF_PageObject;
+class CPDF_PageObjectIndex;
 class PauseIndicatorIface;
 
 // These structs are used to keep track of resources that have already been
@@ -116,6 +117,11 @@ class CPDF_PageObjectHolder {
 
   const CFX_FloatRect& GetBBox() const { return bbox_; }
 
+  // Returns a spatial index over the page object rects, which is built on
+  // first use and rebuilt after the objects change. Returns nullptr until
+  // parsing finishes.
+  const CPDF_PageObjectIndex* GetObjectIndex();
+
   const CPDF_Transparency& GetTransparency() const { return transparency_; }
   bool BackgroundAlphaNeeded() const { return background_alpha_needed_; }
   void SetBackgroundAlphaNeeded(bool needed) {
@@ -164,6 +170,8 @@ class CPDF_PageObjectHolder {
   std::vector<CFX_FloatRect> mask_bounding_boxes_;
   std::unique_ptr<CPDF_ContentParser> parser_;
   std::deque<std::unique_ptr<CPDF_PageObject>> page_object_list_;
+  std::unique_ptr<CPDF_PageObjectIndex> object_index_;
+  uint32_t object_index_generation_ = 0;
 
   CTMMap all_ctms_;
 
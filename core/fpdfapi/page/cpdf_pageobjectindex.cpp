@@ -0,0 +1,186 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/page/cpdf_pageobjectindex.h"
+
+#include <math.h>
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "core/fxcrt/check_op.h"
+
+namespace {
+
+// Aim for about this many objects per grid cell.
+constexpr size_t kObjectsPerCell = 4;
+constexpr size_t kMaxCells = 256 * 256;
+
+// Objects that cover more cells than this go into `large_objects_` instead.
+constexpr int kMaxCellsPerObject = 16;
+
+bool IsFiniteAndNormalized(const CFX_FloatRect& rect) {
+  return isfinite(rect.left) && isfinite(rect.right) && isfinite(rect.bottom) &&
+         isfinite(rect.top) && rect.left <= rect.right &&
+         rect.bottom <= rect.top;
+}
+
+// Must match the culling in CPDF_ProgressiveRenderer and CPDF_RenderStatus.
+bool Intersects(const CFX_FloatRect& object_rect, const CFX_FloatRect& rect) {
+  return object_rect.left <= rect.right && object_rect.right >= rect.left &&
+         object_rect.bottom <= rect.top && object_rect.top >= rect.bottom;
+}
+
+int GetCell(float coordinate, float origin, float cell_size, int cell_count) {
+  if (cell_size <= 0) {
+    return 0;
+  }
+  const double cell = floor((static_cast<double>(coordinate) - origin) /
+                            static_cast<double>(cell_size));
+  if (isnan(cell) || cell < 0) {
+    return 0;
+  }
+  return cell >= cell_count ? cell_count - 1 : static_cast<int>(cell);
+}
+
+}  // namespace
+
+CPDF_PageObjectIndex::CPDF_PageObjectIndex(std::vector<CFX_FloatRect> rects)
+    : rects_(std::move(rects)) {
+  CHECK_LE(rects_.size(), std::numeric_limits<uint32_t>::max());
+
+  bool has_bounds = false;
+  for (const CFX_FloatRect& rect : rects_) {
+    if (!IsFiniteAndNormalized(rect)) {
+      continue;
+    }
+    if (has_bounds) {
+      bounds_.Union(rect);
+    } else {
+      bounds_ = rect;
+      has_bounds = true;
+    }
+  }
+
+  if (has_bounds) {
+    const size_t cell_count =
+        std::clamp(rects_.size() / kObjectsPerCell, size_t{1}, kMaxCells);
+    const double width = bounds_.Width();
+    const double height = bounds_.Height();
+    double columns = 1;
+    if (width > 0 && height > 0) {
+      columns = round(sqrt(cell_count * width / height));
+    } else if (width > 0) {
+      columns = cell_count;
+    }
+    columns_ = static_cast<int>(
+        std::clamp(columns, 1.0, static_cast<double>(cell_count)));
+    rows_ = static_cast<int>((cell_count + columns_ - 1) / columns_);
+    cell_width_ = static_cast<float>(width / columns_);
+    cell_height_ = static_cast<float>(height / rows_);
+  }
+
+  // Count the objects in each cell, then fill the cells.
+  cell_starts_.assign(static_cast<size_t>(columns_) * rows_ + 1, 0);
+  for (size_t pos = 0; pos < rects_.size(); ++pos) {
+    if (!IsInGrid(pos)) {
+      large_objects_.push_back(static_cast<uint32_t>(pos));
+      continue;
+    }
+    const CellRange range = GetCellRange(rects_[pos]);
+    for (int row = range.first_row; row <= range.last_row; ++row) {
+      for (int column = range.first_column; column <= range.last_column;
+           ++column) {
+        ++cell_starts_[row * columns_ + column + 1];
+      }
+    }
+  }
+  for (size_t i = 1; i < cell_starts_.size(); ++i) {
+    cell_starts_[i] += cell_starts_[i - 1];
+  }
+
+  cell_objects_.resize(cell_starts_.back());
+  std::vector<uint32_t> cell_ends(cell_starts_.begin(), cell_starts_.end() - 1);
+  for (size_t pos = 0; pos < rects_.size(); ++pos) {
+    if (!IsInGrid(pos)) {
+      continue;
+    }
+    const CellRange range = GetCellRange(rects_[pos]);
+    for (int row = range.first_row; row <= range.last_row; ++row) {
+      for (int column = range.first_column; column <= range.last_column;
+           ++column) {
+        cell_objects_[cell_ends[row * columns_ + column]++] =
+            static_cast<uint32_t>(pos);
+      }
+    }
+  }
+}
+
+CPDF_PageObjectIndex::~CPDF_PageObjectIndex() = default;
+
+std::vector<size_t> CPDF_PageObjectIndex::GetObjectsIntersecting(
+    const CFX_FloatRect& rect) const {
+  std::vector<size_t> result;
+  const bool covers_grid =
+      rect.left <= bounds_.left && rect.right >= bounds_.right &&
+      rect.bottom <= bounds_.bottom && rect.top >= bounds_.top;
+  if (columns_ == 0 || covers_grid) {
+    // Nothing to gain from the grid.
+    for (size_t pos = 0; pos < rects_.size(); ++pos) {
+      if (Intersects(rects_[pos], rect)) {
+        result.push_back(pos);
+      }
+    }
+    return result;
+  }
+
+  if (Intersects(bounds_, rect)) {
+    const CellRange range = GetCellRange(rect);
+    for (int row = range.first_row; row <= range.last_row; ++row) {
+      for (int column = range.first_column; column <= range.last_column;
+           ++column) {
+        const size_t cell = row * columns_ + column;
+        for (uint32_t i = cell_starts_[cell]; i < cell_starts_[cell + 1]; ++i) {
+          const uint32_t pos = cell_objects_[i];
+          if (Intersects(rects_[pos], rect)) {
+            result.push_back(pos);
+          }
+        }
+      }
+    }
+  }
+  for (uint32_t pos : large_objects_) {
+    if (Intersects(rects_[pos], rect)) {
+      result.push_back(pos);
+    }
+  }
+
+  // Objects that span several cells were found more than once.
+  std::ranges::sort(result);
+  auto duplicates = std::ranges::unique(result);
+  result.erase(duplicates.begin(), duplicates.end());
+  return result;
+}
+
+bool CPDF_PageObjectIndex::IsInGrid(size_t pos) const {
+  const CFX_FloatRect& rect = rects_[pos];
+  if (columns_ == 0 || !IsFiniteAndNormalized(rect)) {
+    return false;
+  }
+  const CellRange range = GetCellRange(rect);
+  const int cells = (range.last_column - range.first_column + 1) *
+                    (range.last_row - range.first_row + 1);
+  return cells <= kMaxCellsPerObject;
+}
+
+CPDF_PageObjectIndex::CellRange CPDF_PageObjectIndex::GetCellRange(
+    const CFX_FloatRect& rect) const {
+  return {
+      .first_column = GetCell(rect.left, bounds_.left, cell_width_, columns_),
+      .last_column = GetCell(rect.right, bounds_.left, cell_width_, columns_),
+      .first_row = GetCell(rect.bottom, bounds_.bottom, cell_height_, rows_),
+      .last_row = GetCell(rect.top, bounds_.bottom, cell_height_, rows_),
+  };
+}
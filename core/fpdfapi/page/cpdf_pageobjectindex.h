@@ -0,0 +1,59 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FPDFAPI_PAGE_CPDF_PAGEOBJECTINDEX_H_
+#define CORE_FPDFAPI_PAGE_CPDF_PAGEOBJECTINDEX_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "core/fxcrt/fx_coordinates.h"
+
+// Uniform grid over the rects of the page objects in a CPDF_PageObjectHolder.
+// Lets rendering a small area of a page with many objects, such as a map tile,
+// only look at the objects near that area instead of the whole object list.
+class CPDF_PageObjectIndex {
+ public:
+  // `rects` are the page object rects, in page object list order.
+  explicit CPDF_PageObjectIndex(std::vector<CFX_FloatRect> rects);
+  ~CPDF_PageObjectIndex();
+
+  size_t size() const { return rects_.size(); }
+
+  // Returns the positions of the objects whose rects intersect `rect`, in
+  // ascending order. Uses the same inclusive test as the renderers' culling.
+  std::vector<size_t> GetObjectsIntersecting(const CFX_FloatRect& rect) const;
+
+ private:
+  struct CellRange {
+    int first_column;
+    int last_column;
+    int first_row;
+    int last_row;
+  };
+
+  // Whether the object at `pos` is stored in the grid cells.
+  bool IsInGrid(size_t pos) const;
+  CellRange GetCellRange(const CFX_FloatRect& rect) const;
+
+  const std::vector<CFX_FloatRect> rects_;
+  CFX_FloatRect bounds_;
+  int columns_ = 0;
+  int rows_ = 0;
+  float cell_width_ = 0.0f;
+  float cell_height_ = 0.0f;
+
+  // Objects in cell `i` are `cell_objects_[cell_starts_[i]]` up to, but not
+  // including, `cell_objects_[cell_starts_[i + 1]]`.
+  std::vector<uint32_t> cell_starts_;
+  std::vector<uint32_t> cell_objects_;
+
+  // Objects that cover too many cells, or have non-finite rects. These are
+  // checked on every query.
+  std::vector<uint32_t> large_objects_;
+};
+
+#endif  // CORE_FPDFAPI_PAGE_CPDF_PAGEOBJECTINDEX_H_
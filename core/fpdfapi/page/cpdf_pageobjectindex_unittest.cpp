@@ -0,0 +1,91 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/page/cpdf_pageobjectindex.h"
+
+#include <limits>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+std::vector<size_t> FindIntersecting(const std::vector<CFX_FloatRect>& rects,
+                                     const CFX_FloatRect& rect) {
+  std::vector<size_t> result;
+  for (size_t pos = 0; pos < rects.size(); ++pos) {
+    const CFX_FloatRect& object_rect = rects[pos];
+    if (object_rect.left <= rect.right && object_rect.right >= rect.left &&
+        object_rect.bottom <= rect.top && object_rect.top >= rect.bottom) {
+      result.push_back(pos);
+    }
+  }
+  return result;
+}
+
+}  // namespace
+
+TEST(CPDFPageObjectIndex, Empty) {
+  CPDF_PageObjectIndex index({});
+  EXPECT_EQ(0u, index.size());
+  EXPECT_TRUE(
+      index.GetObjectsIntersecting(CFX_FloatRect(0, 0, 10, 10)).empty());
+}
+
+TEST(CPDFPageObjectIndex, MatchesLinearSearch) {
+  // A 40x30 grid of 8x8 squares, like many_rectangles.pdf, on top of a page
+  // sized background and a few objects spanning many cells.
+  std::vector<CFX_FloatRect> rects;
+  rects.emplace_back(0, 0, 400, 300);
+  for (int y = 0; y < 30; ++y) {
+    for (int x = 0; x < 40; ++x) {
+      rects.emplace_back(x * 10 + 1, y * 10 + 1, x * 10 + 9, y * 10 + 9);
+    }
+  }
+  rects.emplace_back(0, 145, 400, 155);
+  rects.emplace_back(195, 0, 205, 300);
+  CPDF_PageObjectIndex index(rects);
+  ASSERT_EQ(rects.size(), index.size());
+
+  const CFX_FloatRect kQueries[] = {
+      CFX_FloatRect(0, 0, 400, 300),     CFX_FloatRect(-50, -50, 500, 500),
+      CFX_FloatRect(0, 0, 32, 32),       CFX_FloatRect(100, 100, 164, 164),
+      CFX_FloatRect(9, 9, 11, 11),       CFX_FloatRect(9.5f, 9.5f, 9.5f, 9.5f),
+      CFX_FloatRect(399, 299, 500, 500), CFX_FloatRect(401, 301, 500, 500),
+      CFX_FloatRect(-10, -10, -1, -1),   CFX_FloatRect(150, 0, 250, 300),
+  };
+  for (const CFX_FloatRect& query : kQueries) {
+    EXPECT_EQ(FindIntersecting(rects, query),
+              index.GetObjectsIntersecting(query))
+        << query.left << "," << query.bottom << "," << query.right << ","
+        << query.top;
+  }
+}
+
+TEST(CPDFPageObjectIndex, UnusualRects) {
+  constexpr float kInf = std::numeric_limits<float>::infinity();
+  constexpr float kNan = std::numeric_limits<float>::quiet_NaN();
+  std::vector<CFX_FloatRect> rects;
+  for (int i = 0; i < 100; ++i) {
+    rects.emplace_back(i, i, i + 1, i + 1);
+  }
+  rects.emplace_back(-kInf, -kInf, kInf, kInf);
+  rects.emplace_back(kNan, 0, 10, 10);
+  rects.emplace_back(50, 50, 40, 40);
+  rects.emplace_back(20, 20, 20, 20);
+  CPDF_PageObjectIndex index(rects);
+
+  const CFX_FloatRect kQueries[] = {
+      CFX_FloatRect(0, 0, 100, 100),
+      CFX_FloatRect(10, 10, 12, 12),
+      CFX_FloatRect(20, 20, 20, 20),
+      CFX_FloatRect(45, 45, 46, 46),
+      CFX_FloatRect(-kInf, -kInf, kInf, kInf),
+      CFX_FloatRect(kNan, kNan, kNan, kNan),
+  };
+  for (const CFX_FloatRect& query : kQueries) {
+    EXPECT_EQ(FindIntersecting(rects, query),
+              index.GetObjectsIntersecting(query));
+  }
+}
@@ -18,6 +18,7 @@
 #include "core/fxcrt/check_op.h"
 #include "core/fxcrt/fx_safe_types.h"
 #include "core/fxcrt/fx_string.h"
+#include "core/fxcrt/notreached.h"
 
 namespace {
 
@@ -219,171 +220,152 @@ bool CPDF_PSEngine::Parse(pdfium::span<const uint8_t> input) {
   return parser.GetWord() == "{" && main_proc_.Parse(&parser, 0);
 }
 
-bool CPDF_PSEngine::DoOperator(PDF_PSOP op) {
-  int i1;
-  int i2;
-  float d1;
-  float d2;
-  FX_SAFE_INT32 result;
+// static
+bool CPDF_PSEngine::IsUnaryOperator(PDF_PSOP op) {
+  switch (op) {
+    case PSOP_NEG:
+    case PSOP_ABS:
+    case PSOP_CEILING:
+    case PSOP_FLOOR:
+    case PSOP_ROUND:
+    case PSOP_TRUNCATE:
+    case PSOP_SQRT:
+    case PSOP_SIN:
+    case PSOP_COS:
+    case PSOP_LN:
+    case PSOP_LOG:
+    case PSOP_CVI:
+    case PSOP_NOT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// static
+bool CPDF_PSEngine::IsBinaryOperator(PDF_PSOP op) {
   switch (op) {
     case PSOP_ADD:
-      d1 = Pop();
-      d2 = Pop();
-      Push(d1 + d2);
-      break;
     case PSOP_SUB:
-      d2 = Pop();
-      d1 = Pop();
-      Push(d1 - d2);
-      break;
     case PSOP_MUL:
-      d1 = Pop();
-      d2 = Pop();
-      Push(d1 * d2);
-      break;
     case PSOP_DIV:
-      d2 = Pop();
-      d1 = Pop();
-      Push(d2 ? d1 / d2 : 0);
-      break;
     case PSOP_IDIV:
-      i2 = PopInt();
-      i1 = PopInt();
-      if (i2) {
-        result = i1;
-        result /= i2;
-        Push(result.ValueOrDefault(0));
-      } else {
-        Push(0);
-      }
-      break;
     case PSOP_MOD:
-      i2 = PopInt();
-      i1 = PopInt();
-      if (i2) {
-        result = i1;
-        result %= i2;
-        Push(result.ValueOrDefault(0));
-      } else {
-        Push(0);
-      }
-      break;
+    case PSOP_ATAN:
+    case PSOP_EXP:
+    case PSOP_EQ:
+    case PSOP_NE:
+    case PSOP_GT:
+    case PSOP_GE:
+    case PSOP_LT:
+    case PSOP_LE:
+    case PSOP_AND:
+    case PSOP_OR:
+    case PSOP_XOR:
+    case PSOP_BITSHIFT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// static
+float CPDF_PSEngine::DoUnaryOperator(PDF_PSOP op, float value) {
+  const float d1 = value;
+  switch (op) {
     case PSOP_NEG:
-      d1 = Pop();
-      Push(-d1);
-      break;
+      return -d1;
     case PSOP_ABS:
-      d1 = Pop();
-      Push(fabs(d1));
-      break;
+      return fabs(d1);
     case PSOP_CEILING:
-      d1 = Pop();
-      Push(ceil(d1));
-      break;
+      return ceil(d1);
     case PSOP_FLOOR:
-      d1 = Pop();
-      Push(floor(d1));
-      break;
+      return floor(d1);
     case PSOP_ROUND:
-      d1 = Pop();
-      Push(RoundHalfUp(d1));
-      break;
+      return RoundHalfUp(d1);
     case PSOP_TRUNCATE:
-      i1 = PopInt();
-      Push(i1);
-      break;
+    case PSOP_CVI:
+      return static_cast<int>(d1);
     case PSOP_SQRT:
-      d1 = Pop();
-      Push(sqrt(d1));
-      break;
+      return sqrt(d1);
     case PSOP_SIN:
-      d1 = Pop();
-      Push(sin(d1 * FXSYS_PI / 180.0f));
-      break;
+      return sin(d1 * FXSYS_PI / 180.0f);
     case PSOP_COS:
-      d1 = Pop();
-      Push(cos(d1 * FXSYS_PI / 180.0f));
-      break;
+      return cos(d1 * FXSYS_PI / 180.0f);
+    case PSOP_LN:
+      return log(d1);
+    case PSOP_LOG:
+      return log10(d1);
+    case PSOP_NOT:
+      return !static_cast<int>(d1);
+    default:
+      NOTREACHED();
+  }
+}
+
+// static
+float CPDF_PSEngine::DoBinaryOperator(PDF_PSOP op, float below, float top) {
+  float d1 = below;
+  const float d2 = top;
+  int i1;
+  int i2;
+  FX_SAFE_INT32 result;
+  switch (op) {
+    case PSOP_ADD:
+      return d2 + d1;
+    case PSOP_SUB:
+      return d1 - d2;
+    case PSOP_MUL:
+      return d2 * d1;
+    case PSOP_DIV:
+      return d2 ? d1 / d2 : 0;
+    case PSOP_IDIV:
+      i1 = static_cast<int>(d1);
+      i2 = static_cast<int>(d2);
+      if (!i2) {
+        return 0;
+      }
+      result = i1;
+      result /= i2;
+      return result.ValueOrDefault(0);
+    case PSOP_MOD:
+      i1 = static_cast<int>(d1);
+      i2 = static_cast<int>(d2);
+      if (!i2) {
+        return 0;
+      }
+      result = i1;
+      result %= i2;
+      return result.ValueOrDefault(0);
     case PSOP_ATAN:
-      d2 = Pop();
-      d1 = Pop();
       d1 = atan2(d1, d2) * 180.0 / FXSYS_PI;
       if (d1 < 0) {
         d1 += 360;
       }
-      Push(d1);
-      break;
+      return d1;
     case PSOP_EXP:
-      d2 = Pop();
-      d1 = Pop();
-      Push(powf(d1, d2));
-      break;
-    case PSOP_LN:
-      d1 = Pop();
-      Push(log(d1));
-      break;
-    case PSOP_LOG:
-      d1 = Pop();
-      Push(log10(d1));
-      break;
-    case PSOP_CVI:
-      i1 = PopInt();
-      Push(i1);
-      break;
-    case PSOP_CVR:
-      break;
+      return powf(d1, d2);
     case PSOP_EQ:
-      d2 = Pop();
-      d1 = Pop();
-      Push(d1 == d2);
-      break;
+      return d1 == d2;
     case PSOP_NE:
-      d2 = Pop();
-      d1 = Pop();
-      Push(d1 != d2);
-      break;
+      return d1 != d2;
     case PSOP_GT:
-      d2 = Pop();
-      d1 = Pop();
-      Push(d1 > d2);
-      break;
+      return d1 > d2;
     case PSOP_GE:
-      d2 = Pop();
-      d1 = Pop();
-      Push(d1 >= d2);
-      break;
+      return d1 >= d2;
     case PSOP_LT:
-      d2 = Pop();
-      d1 = Pop();
-      Push(d1 < d2);
-      break;
+      return d1 < d2;
     case PSOP_LE:
-      d2 = Pop();
-      d1 = Pop();
-      Push(d1 <= d2);
-      break;
+      return d1 <= d2;
     case PSOP_AND:
-      i1 = PopInt();
-      i2 = PopInt();
-      Push(i1 & i2);
-      break;
+      return static_cast<int>(d2) & static_cast<int>(d1);
     case PSOP_OR:
-      i1 = PopInt();
-      i2 = PopInt();
-      Push(i1 | i2);
-      break;
+      return static_cast<int>(d2) | static_cast<int>(d1);
     case PSOP_XOR:
-      i1 = PopInt();
-      i2 = PopInt();
-      Push(i1 ^ i2);
-      break;
-    case PSOP_NOT:
-      i1 = PopInt();
-      Push(!i1);
-      break;
+      return static_cast<int>(d2) ^ static_cast<int>(d1);
     case PSOP_BITSHIFT: {
-      int shift = PopInt();
-      result = PopInt();
+      int shift = static_cast<int>(d2);
+      result = static_cast<int>(d1);
       if (shift > 0) {
         result <<= shift;
       } else {
@@ -391,9 +373,28 @@ bool CPDF_PSEngine::DoOperator(PDF_PSOP op) {
         FX_SAFE_INT32 safe_shift = shift;
         result >>= (-safe_shift).ValueOrDefault(0);
       }
-      Push(result.ValueOrDefault(0));
-      break;
+      return result.ValueOrDefault(0);
     }
+    default:
+      NOTREACHED();
+  }
+}
+
+bool CPDF_PSEngine::DoOperator(PDF_PSOP op) {
+  if (IsUnaryOperator(op)) {
+    Push(DoUnaryOperator(op, Pop()));
+    return true;
+  }
+  if (IsBinaryOperator(op)) {
+    float top = Pop();
+    float below = Pop();
+    Push(DoBinaryOperator(op, below, top));
+    return true;
+  }
+
+  float d1;
+  float d2;
+  switch (op) {
     case PSOP_TRUE:
       Push(1);
       break;
@@ -78,6 +78,7 @@ class CPDF_PSOP {
   void Execute(CPDF_PSEngine* pEngine);
   float GetFloatValue() const;
   PDF_PSOP GetOp() const { return op_; }
+  const CPDF_PSProc* GetProc() const { return proc_.get(); }
 
  private:
   const PDF_PSOP op_;
@@ -93,6 +94,10 @@ class CPDF_PSProc {
   bool Parse(CPDF_SimpleParser* parser, int depth);
   bool Execute(CPDF_PSEngine* pEngine);
 
+  const std::vector<std::unique_ptr<CPDF_PSOP>>& operators() const {
+    return operators_;
+  }
+
   // These methods are exposed for testing.
   void AddOperatorForTesting(ByteStringView word);
   const std::unique_ptr<CPDF_PSOP>& last_operator() {
@@ -120,10 +125,18 @@ class CPDF_PSEngine {
   float Pop();
   int PopInt();
   uint32_t GetStackSize() const { return stack_count_; }
+  const CPDF_PSProc& main_proc() const { return main_proc_; }
+
+  // Operators that pop one or two values and push one value computed from
+  // them. For binary operators, `top` is the value that was pushed last.
+  static bool IsUnaryOperator(PDF_PSOP op);
+  static bool IsBinaryOperator(PDF_PSOP op);
+  static float DoUnaryOperator(PDF_PSOP op, float value);
+  static float DoBinaryOperator(PDF_PSOP op, float below, float top);
 
- private:
   static constexpr uint32_t kPSEngineStackSize = 100;
 
+ private:
   uint32_t stack_count_ = 0;
   CPDF_PSProc main_proc_;
   std::array<float, kPSEngineStackSize> stack_ = {};
@@ -17,11 +17,21 @@ bool CPDF_PSFunc::v_Init(const CPDF_Object* pObj, VisitedSet* pVisited) {
   auto pAcc =
       pdfium::MakeRetain<CPDF_StreamAcc>(pdfium::WrapRetain(pObj->AsStream()));
   pAcc->LoadAllDataFiltered();
-  return ps_.Parse(pAcc->GetSpan());
+  if (!ps_.Parse(pAcc->GetSpan())) {
+    return false;
+  }
+
+  program_ = CPDF_PSProgram::Compile(ps_.main_proc(), inputs_, outputs_);
+  return true;
 }
 
 bool CPDF_PSFunc::v_Call(pdfium::span<const float> inputs,
                          pdfium::span<float> results) const {
+  if (program_) {
+    program_->Run(inputs, results);
+    return true;
+  }
+
   ps_.Reset();
   for (uint32_t i = 0; i < inputs_; i++) {
     ps_.Push(inputs[i]);
@@ -35,3 +45,17 @@ bool CPDF_PSFunc::v_Call(pdfium::span<const float> inputs,
   }
   return true;
 }
+
+bool CPDF_PSFunc::v_CallBatch(size_t count,
+                              pdfium::span<const float> inputs,
+                              pdfium::span<float> results) const {
+  if (!program_) {
+    return CPDF_Function::v_CallBatch(count, inputs, results);
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    program_->Run(inputs.subspan(i * inputs_, inputs_),
+                  results.subspan(i * outputs_, outputs_));
+  }
+  return true;
+}
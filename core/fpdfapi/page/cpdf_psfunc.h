@@ -7,8 +7,11 @@
 #ifndef CORE_FPDFAPI_PAGE_CPDF_PSFUNC_H_
 #define CORE_FPDFAPI_PAGE_CPDF_PSFUNC_H_
 
+#include <memory>
+
 #include "core/fpdfapi/page/cpdf_function.h"
 #include "core/fpdfapi/page/cpdf_psengine.h"
+#include "core/fpdfapi/page/cpdf_psprogram.h"
 
 class CPDF_Object;
 
@@ -21,9 +24,14 @@ class CPDF_PSFunc final : public CPDF_Function {
   bool v_Init(const CPDF_Object* pObj, VisitedSet* pVisited) override;
   bool v_Call(pdfium::span<const float> inputs,
               pdfium::span<float> results) const override;
+  bool v_CallBatch(size_t count,
+                   pdfium::span<const float> inputs,
+                   pdfium::span<float> results) const override;
 
  private:
   mutable CPDF_PSEngine ps_;  // Pre-initialized scratch space for v_Call().
+  // Runs instead of `ps_` when the program compiles.
+  std::unique_ptr<CPDF_PSProgram> program_;
 };
 
 #endif  // CORE_FPDFAPI_PAGE_CPDF_PSFUNC_H_
@@ -0,0 +1,358 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/page/cpdf_psprogram.h"
+
+#include <algorithm>
+#include <bit>
+#include <map>
+#include <optional>
+#include <utility>
+
+#include "core/fxcrt/compiler_specific.h"
+#include "core/fxcrt/ptr_util.h"
+#include "core/fxcrt/span_util.h"
+
+// Tracks the operand stack at compile time. Each stack entry names the
+// register that holds its value at run time.
+class CPDF_PSProgram::Compiler {
+ public:
+  explicit Compiler(uint32_t input_count) {
+    for (uint32_t i = 0; i < input_count; ++i) {
+      Push(NewRegister());
+    }
+  }
+
+  // Appends the code for `proc` to `code`. Returns false if `proc` cannot be
+  // compiled.
+  bool CompileProc(const CPDF_PSProc& proc, std::vector<Instruction>* code) {
+    const auto& operators = proc.operators();
+    for (size_t i = 0; i < operators.size(); ++i) {
+      const PDF_PSOP op = operators[i]->GetOp();
+      if (op == PSOP_PROC) {
+        continue;
+      }
+
+      if (op == PSOP_CONST) {
+        Push(Constant(operators[i]->GetFloatValue()));
+        continue;
+      }
+
+      // Malformed conditionals end the procedure, like in
+      // CPDF_PSProc::Execute().
+      if (op == PSOP_IF) {
+        if (i == 0 || operators[i - 1]->GetOp() != PSOP_PROC) {
+          return true;
+        }
+        if (!CompileConditional(*operators[i - 1]->GetProc(), nullptr, code)) {
+          return false;
+        }
+      } else if (op == PSOP_IFELSE) {
+        if (i < 2 || operators[i - 1]->GetOp() != PSOP_PROC ||
+            operators[i - 2]->GetOp() != PSOP_PROC) {
+          return true;
+        }
+        if (!CompileConditional(*operators[i - 2]->GetProc(),
+                                operators[i - 1]->GetProc(), code)) {
+          return false;
+        }
+      } else if (!CompileOperator(op, code)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  std::unique_ptr<CPDF_PSProgram> Finish(uint32_t input_count,
+                                         uint32_t output_count,
+                                         std::vector<Instruction> code) {
+    if (stack_.size() < output_count) {
+      return nullptr;
+    }
+
+    std::vector<uint32_t> output_registers(stack_.end() - output_count,
+                                           stack_.end());
+    return pdfium::WrapUnique(
+        new CPDF_PSProgram(input_count, std::move(code),
+                           std::move(output_registers), std::move(registers_)));
+  }
+
+ private:
+  bool CompileOperator(PDF_PSOP op, std::vector<Instruction>* code) {
+    if (CPDF_PSEngine::IsUnaryOperator(op)) {
+      const uint32_t value = Pop();
+      if (IsConstant(value)) {
+        Push(Constant(CPDF_PSEngine::DoUnaryOperator(op, registers_[value])));
+        return true;
+      }
+      const uint32_t dest = NewRegister();
+      code->push_back(
+          {.code = OpCode::kUnary, .op = op, .dest = dest, .left = value});
+      Push(dest);
+      return true;
+    }
+
+    if (CPDF_PSEngine::IsBinaryOperator(op)) {
+      const uint32_t top = Pop();
+      const uint32_t below = Pop();
+      if (IsConstant(below) && IsConstant(top)) {
+        Push(Constant(CPDF_PSEngine::DoBinaryOperator(op, registers_[below],
+                                                      registers_[top])));
+        return true;
+      }
+      const uint32_t dest = NewRegister();
+      code->push_back({.code = OpCode::kBinary,
+                       .op = op,
+                       .dest = dest,
+                       .left = below,
+                       .right = top});
+      Push(dest);
+      return true;
+    }
+
+    // Same as CPDF_PSEngine::DoOperator(), but moving register names around.
+    switch (op) {
+      case PSOP_TRUE:
+        Push(Constant(1));
+        return true;
+      case PSOP_FALSE:
+        Push(Constant(0));
+        return true;
+      case PSOP_POP:
+        Pop();
+        return true;
+      case PSOP_EXCH: {
+        const uint32_t top = Pop();
+        const uint32_t below = Pop();
+        Push(top);
+        Push(below);
+        return true;
+      }
+      case PSOP_DUP: {
+        const uint32_t value = Pop();
+        Push(value);
+        Push(value);
+        return true;
+      }
+      case PSOP_COPY: {
+        std::optional<int> n = PopConstantInt();
+        if (!n.has_value()) {
+          return false;
+        }
+        const size_t size = stack_.size();
+        if (n.value() < 0 || size + n.value() > kStackSize ||
+            n.value() > static_cast<int>(size)) {
+          return true;
+        }
+        for (size_t i = size - n.value(); i < size; ++i) {
+          stack_.push_back(stack_[i]);
+        }
+        return true;
+      }
+      case PSOP_INDEX: {
+        std::optional<int> n = PopConstantInt();
+        if (!n.has_value()) {
+          return false;
+        }
+        if (n.value() < 0 || n.value() >= static_cast<int>(stack_.size())) {
+          return true;
+        }
+        Push(stack_[stack_.size() - n.value() - 1]);
+        return true;
+      }
+      case PSOP_ROLL: {
+        std::optional<int> j = PopConstantInt();
+        std::optional<int> n = PopConstantInt();
+        if (!j.has_value() || !n.has_value()) {
+          return false;
+        }
+        if (j.value() == 0 || n.value() == 0 || stack_.empty()) {
+          return true;
+        }
+        if (n.value() < 0 || n.value() > static_cast<int>(stack_.size())) {
+          return true;
+        }
+
+        int shift = j.value() % n.value();
+        if (shift > 0) {
+          shift -= n.value();
+        }
+        auto begin_it = stack_.end() - n.value();
+        std::rotate(begin_it, begin_it - shift, stack_.end());
+        return true;
+      }
+      default:
+        return true;
+    }
+  }
+
+  // Compiles `if` when `else_proc` is null, or else `ifelse`.
+  bool CompileConditional(const CPDF_PSProc& then_proc,
+                          const CPDF_PSProc* else_proc,
+                          std::vector<Instruction>* code) {
+    const uint32_t condition = Pop();
+    if (IsConstant(condition)) {
+      if (static_cast<int>(registers_[condition])) {
+        return CompileProc(then_proc, code);
+      }
+      return !else_proc || CompileProc(*else_proc, code);
+    }
+
+    const std::vector<uint32_t> entry_stack = stack_;
+    std::vector<Instruction> then_code;
+    if (!CompileProc(then_proc, &then_code)) {
+      return false;
+    }
+    const std::vector<uint32_t> then_stack = std::exchange(stack_, entry_stack);
+    std::vector<Instruction> else_code;
+    if (else_proc && !CompileProc(*else_proc, &else_code)) {
+      return false;
+    }
+    if (then_stack.size() != stack_.size()) {
+      return false;
+    }
+
+    // Where the two sides disagree, they both move their value into a new
+    // register, which the rest of the code uses.
+    for (size_t i = 0; i < stack_.size(); ++i) {
+      if (then_stack[i] == stack_[i]) {
+        continue;
+      }
+      const uint32_t merged = NewRegister();
+      then_code.push_back(
+          {.code = OpCode::kMove, .dest = merged, .left = then_stack[i]});
+      else_code.push_back(
+          {.code = OpCode::kMove, .dest = merged, .left = stack_[i]});
+      stack_[i] = merged;
+    }
+
+    const bool has_else = !else_code.empty();
+    code->push_back(
+        {.code = OpCode::kJumpIfFalse,
+         .left = condition,
+         .right = static_cast<uint32_t>(then_code.size() + has_else)});
+    code->insert(code->end(), then_code.begin(), then_code.end());
+    if (has_else) {
+      code->push_back({.code = OpCode::kJump,
+                       .right = static_cast<uint32_t>(else_code.size())});
+      code->insert(code->end(), else_code.begin(), else_code.end());
+    }
+    return true;
+  }
+
+  uint32_t NewRegister() {
+    registers_.push_back(0);
+    is_constant_.push_back(false);
+    return static_cast<uint32_t>(registers_.size() - 1);
+  }
+
+  uint32_t Constant(float value) {
+    auto [it, inserted] =
+        constants_.emplace(std::bit_cast<uint32_t>(value), 0);
+    if (inserted) {
+      it->second = NewRegister();
+      registers_.back() = value;
+      is_constant_.back() = true;
+    }
+    return it->second;
+  }
+
+  bool IsConstant(uint32_t reg) const { return is_constant_[reg]; }
+
+  // Like CPDF_PSEngine, drops values that do not fit and pops zeros from an
+  // empty stack.
+  void Push(uint32_t reg) {
+    if (stack_.size() < kStackSize) {
+      stack_.push_back(reg);
+    }
+  }
+
+  uint32_t Pop() {
+    if (stack_.empty()) {
+      return Constant(0);
+    }
+    const uint32_t reg = stack_.back();
+    stack_.pop_back();
+    return reg;
+  }
+
+  std::optional<int> PopConstantInt() {
+    const uint32_t reg = Pop();
+    if (!IsConstant(reg)) {
+      return std::nullopt;
+    }
+    return static_cast<int>(registers_[reg]);
+  }
+
+  static constexpr size_t kStackSize = CPDF_PSEngine::kPSEngineStackSize;
+
+  std::vector<uint32_t> stack_;
+  DataVector<float> registers_;
+  std::vector<bool> is_constant_;
+  // Keyed by bit pattern, to keep 0 and -0 apart.
+  std::map<uint32_t, uint32_t> constants_;
+};
+
+// static
+std::unique_ptr<CPDF_PSProgram> CPDF_PSProgram::Compile(
+    const CPDF_PSProc& proc,
+    uint32_t input_count,
+    uint32_t output_count) {
+  Compiler compiler(input_count);
+  std::vector<Instruction> code;
+  if (!compiler.CompileProc(proc, &code)) {
+    return nullptr;
+  }
+  return compiler.Finish(input_count, output_count, std::move(code));
+}
+
+CPDF_PSProgram::CPDF_PSProgram(uint32_t input_count,
+                               std::vector<Instruction> code,
+                               std::vector<uint32_t> output_registers,
+                               DataVector<float> registers)
+    : input_count_(input_count),
+      code_(std::move(code)),
+      output_registers_(std::move(output_registers)),
+      registers_(std::move(registers)) {}
+
+CPDF_PSProgram::~CPDF_PSProgram() = default;
+
+void CPDF_PSProgram::Run(pdfium::span<const float> inputs,
+                         pdfium::span<float> results) const {
+  fxcrt::spancpy(pdfium::span(registers_), inputs.first(input_count_));
+  float* regs = registers_.data();
+  const Instruction* code = code_.data();
+  const size_t code_size = code_.size();
+  // SAFETY: The compiler only emits indices of registers it allocated, and
+  // jumps that land within `code_` or right at its end.
+  UNSAFE_BUFFERS({
+    for (size_t pc = 0; pc < code_size; ++pc) {
+      const Instruction& inst = code[pc];
+      switch (inst.code) {
+        case OpCode::kUnary:
+          regs[inst.dest] =
+              CPDF_PSEngine::DoUnaryOperator(inst.op, regs[inst.left]);
+          break;
+        case OpCode::kBinary:
+          regs[inst.dest] = CPDF_PSEngine::DoBinaryOperator(
+              inst.op, regs[inst.left], regs[inst.right]);
+          break;
+        case OpCode::kMove:
+          regs[inst.dest] = regs[inst.left];
+          break;
+        case OpCode::kJump:
+          pc += inst.right;
+          break;
+        case OpCode::kJumpIfFalse:
+          if (!static_cast<int>(regs[inst.left])) {
+            pc += inst.right;
+          }
+          break;
+      }
+    }
+  });
+  for (size_t i = 0; i < output_registers_.size(); ++i) {
+    results[i] = registers_[output_registers_[i]];
+  }
+}
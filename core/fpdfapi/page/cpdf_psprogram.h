@@ -0,0 +1,75 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FPDFAPI_PAGE_CPDF_PSPROGRAM_H_
+#define CORE_FPDFAPI_PAGE_CPDF_PSPROGRAM_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "core/fpdfapi/page/cpdf_psengine.h"
+#include "core/fxcrt/data_vector.h"
+#include "core/fxcrt/span.h"
+
+// A Type 4 (PostScript calculator) function, compiled from the procedure that
+// CPDF_PSEngine parsed into flat register code. The operand stack only exists
+// while compiling, operators with constant operands get folded, and only
+// conditions that depend on the inputs turn into jumps. Running the program
+// gives the same results as interpreting the procedure with CPDF_PSEngine.
+class CPDF_PSProgram {
+ public:
+  // Returns nullptr if `proc` cannot be compiled, e.g. when `copy`, `index`
+  // or `roll` take computed operands, or when the two sides of a conditional
+  // leave different numbers of values on the stack. Such procedures have to
+  // be interpreted instead.
+  static std::unique_ptr<CPDF_PSProgram> Compile(const CPDF_PSProc& proc,
+                                                 uint32_t input_count,
+                                                 uint32_t output_count);
+
+  ~CPDF_PSProgram();
+
+  // Reads `input_count` values from `inputs` and writes `output_count` values
+  // to `results`, as passed to Compile().
+  void Run(pdfium::span<const float> inputs, pdfium::span<float> results) const;
+
+ private:
+  class Compiler;
+
+  enum class OpCode : uint8_t {
+    kUnary,
+    kBinary,
+    kMove,
+    kJump,
+    kJumpIfFalse,
+  };
+
+  struct Instruction {
+    OpCode code;
+    // The operator for kUnary and kBinary.
+    PDF_PSOP op = PSOP_PROC;
+    uint32_t dest = 0;
+    // The operand of kUnary and kMove, the left operand of kBinary, or the
+    // condition of kJumpIfFalse.
+    uint32_t left = 0;
+    // The right operand of kBinary, or the number of instructions to skip
+    // for jumps.
+    uint32_t right = 0;
+  };
+
+  CPDF_PSProgram(uint32_t input_count,
+                 std::vector<Instruction> code,
+                 std::vector<uint32_t> output_registers,
+                 DataVector<float> registers);
+
+  const uint32_t input_count_;
+  const std::vector<Instruction> code_;
+  const std::vector<uint32_t> output_registers_;
+  // The inputs come first. Constants are preset, everything else is scratch
+  // space for Run().
+  mutable DataVector<float> registers_;
+};
+
+#endif  // CORE_FPDFAPI_PAGE_CPDF_PSPROGRAM_H_
@@ -0,0 +1,169 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/page/cpdf_psprogram.h"
+
+#include <bit>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include "core/fpdfapi/page/cpdf_psengine.h"
+#include "core/fxcrt/bytestring.h"
+#include "core/fxcrt/span.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+// Compares bit patterns, so NaNs compare equal to themselves and 0 != -0.
+std::vector<uint32_t> ToBits(pdfium::span<const float> values) {
+  std::vector<uint32_t> bits;
+  for (float value : values) {
+    bits.push_back(std::bit_cast<uint32_t>(value));
+  }
+  return bits;
+}
+
+// Runs `program` both compiled and interpreted, like CPDF_PSFunc does, for
+// inputs from a small grid.
+void ExpectSameAsInterpreter(const ByteString& program,
+                             uint32_t input_count,
+                             uint32_t output_count) {
+  SCOPED_TRACE(program.c_str());
+  CPDF_PSEngine engine;
+  ASSERT_TRUE(engine.Parse(program.unsigned_span()));
+  std::unique_ptr<CPDF_PSProgram> compiled =
+      CPDF_PSProgram::Compile(engine.main_proc(), input_count, output_count);
+  ASSERT_TRUE(compiled);
+
+  static constexpr float kValues[] = {-1.5f, -0.0f, 0.0f, 0.25f,
+                                      0.5f,  0.75f, 1.0f, 3.7f};
+  std::vector<size_t> indices(input_count);
+  while (true) {
+    std::vector<float> inputs;
+    for (size_t index : indices) {
+      inputs.push_back(kValues[index]);
+    }
+
+    engine.Reset();
+    for (float input : inputs) {
+      engine.Push(input);
+    }
+    engine.Execute();
+    ASSERT_GE(engine.GetStackSize(), output_count);
+    std::vector<float> expected(output_count);
+    for (uint32_t i = 0; i < output_count; ++i) {
+      expected[output_count - i - 1] = engine.Pop();
+    }
+
+    std::vector<float> results(output_count);
+    compiled->Run(inputs, results);
+    EXPECT_EQ(ToBits(expected), ToBits(results))
+        << "inputs " << testing::PrintToString(inputs);
+
+    size_t i = 0;
+    while (i < indices.size() && ++indices[i] == std::size(kValues)) {
+      indices[i++] = 0;
+    }
+    if (i == indices.size()) {
+      break;
+    }
+  }
+}
+
+std::unique_ptr<CPDF_PSProgram> Compile(const ByteString& program,
+                                        uint32_t input_count,
+                                        uint32_t output_count) {
+  CPDF_PSEngine engine;
+  if (!engine.Parse(program.unsigned_span())) {
+    return nullptr;
+  }
+  return CPDF_PSProgram::Compile(engine.main_proc(), input_count,
+                                 output_count);
+}
+
+}  // namespace
+
+TEST(CPDFPSProgramTest, Arithmetic) {
+  ExpectSameAsInterpreter("{ 2 copy add 3 1 roll sub mul }", 2, 1);
+  ExpectSameAsInterpreter("{ exch div 4 idiv 3 mod neg abs }", 2, 1);
+  ExpectSameAsInterpreter("{ 10 mul cvi 3 idiv 7 and 2 bitshift 5 xor cvr }",
+                          1, 1);
+  ExpectSameAsInterpreter("{ 2 copy or 3 1 roll -1 bitshift exch not }", 2,
+                          3);
+  ExpectSameAsInterpreter(
+      "{ 360 mul dup sin exch cos 2 copy atan 3 1 roll exp }", 1, 2);
+  ExpectSameAsInterpreter(
+      "{ dup ln exch dup log exch dup sqrt exch 2.5 mul dup ceiling exch dup "
+      "floor exch dup round exch truncate }",
+      1, 7);
+  ExpectSameAsInterpreter(
+      "{ 2 copy eq 3 1 roll 2 copy ne 3 1 roll 2 copy gt 3 1 roll 2 copy ge "
+      "3 1 roll 2 copy lt 3 1 roll le }",
+      2, 6);
+}
+
+TEST(CPDFPSProgramTest, TintTransform) {
+  ExpectSameAsInterpreter(
+      "{ dup 0 mul exch dup 0.5 mul exch dup 0.9 mul exch 0.1 mul }", 1, 4);
+  ExpectSameAsInterpreter(
+      "{ 3 index 0.3 mul 3 index add 4 1 roll pop 0.5 mul exch 0.1 mul add "
+      "exch 2 copy add }",
+      4, 4);
+}
+
+TEST(CPDFPSProgramTest, StackOperators) {
+  ExpectSameAsInterpreter(
+      "{ 1 index 1 index 3 -1 roll mul 2 copy pop add exch }", 2, 3);
+  ExpectSameAsInterpreter("{ 3 index 2 index 4 2 roll 4 -7 roll 0 index }", 3,
+                          5);
+  // Operands out of range do nothing, other than getting popped.
+  ExpectSameAsInterpreter("{ 5 copy -1 copy 5 index -1 index 5 1 roll }", 2,
+                          2);
+  ExpectSameAsInterpreter("{ 3 0 roll 0 3 roll -2 2 roll }", 3, 3);
+  // Popping from an empty stack gives 0.
+  ExpectSameAsInterpreter("{ pop pop pop add exch dup }", 1, 3);
+}
+
+TEST(CPDFPSProgramTest, Conditionals) {
+  ExpectSameAsInterpreter("{ dup 0.5 gt { 1 exch sub } if }", 1, 1);
+  ExpectSameAsInterpreter(
+      "{ dup 0.5 lt { 2 mul 0 } { 0.5 sub 3 mul 1 } ifelse }", 1, 2);
+  ExpectSameAsInterpreter(
+      "{ exch dup 0 gt { exch dup 0.5 gt { 1 } { 2 } ifelse add } "
+      "{ pop 7 } ifelse }",
+      2, 2);
+  // Swapping values on one side only.
+  ExpectSameAsInterpreter("{ 2 copy lt { exch } if }", 2, 2);
+  // Conditions from constants get decided at compile time.
+  ExpectSameAsInterpreter(
+      "{ true { 2 mul } { 3 mul } ifelse 1 0 gt { neg } if 0.9 { 1 add } if }",
+      1, 1);
+  // Malformed conditionals end the procedure.
+  ExpectSameAsInterpreter("{ 1 if 2 }", 1, 2);
+  ExpectSameAsInterpreter("{ dup { 3 } ifelse 4 }", 1, 1);
+}
+
+TEST(CPDFPSProgramTest, StackOverflow) {
+  // Like the interpreter, drops values that do not fit on the stack.
+  ByteString program = "{";
+  for (int i = 0; i < 120; ++i) {
+    program += ByteString::Format(" %d", i);
+  }
+  program += " add }";
+  ExpectSameAsInterpreter(program, 1, 1);
+}
+
+TEST(CPDFPSProgramTest, NotCompiled) {
+  // Computed operands for stack operators.
+  EXPECT_FALSE(Compile("{ cvi copy }", 2, 1));
+  EXPECT_FALSE(Compile("{ cvi index }", 2, 1));
+  EXPECT_FALSE(Compile("{ 1 roll }", 2, 1));
+  // Different stack depths after a conditional.
+  EXPECT_FALSE(Compile("{ dup 0.5 lt { 2 mul } { 1 exch } ifelse }", 1, 1));
+  // Too few results.
+  EXPECT_FALSE(Compile("{ pop }", 1, 1));
+
+  EXPECT_TRUE(Compile("{ dup 0.5 lt { 2 mul } { 1 exch pop } ifelse }", 1, 1));
+}
@@ -8,7 +8,6 @@
 
 #include <algorithm>
 #include <array>
-#include <map>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -59,16 +58,13 @@ constexpr int kCoonsCoordinatePairs = 12;
 constexpr int kSingleColorPerPatch = 1;
 constexpr int kQuadColorsPerPatch = 4;
 
-const char kPathOperatorSubpath = 'm';
-const char kPathOperatorLine = 'l';
-const char kPathOperatorCubicBezier1 = 'c';
-const char kPathOperatorCubicBezier2 = 'v';
-const char kPathOperatorCubicBezier3 = 'y';
-const char kPathOperatorClosePath = 'h';
-const char kPathOperatorRectangle[] = "re";
-
-using OpCodes = std::map<uint32_t, void (CPDF_StreamContentParser::*)()>;
-OpCodes* g_opcodes = nullptr;
+constexpr char kPathOperatorSubpath = 'm';
+constexpr char kPathOperatorLine = 'l';
+constexpr char kPathOperatorCubicBezier1 = 'c';
+constexpr char kPathOperatorCubicBezier2 = 'v';
+constexpr char kPathOperatorCubicBezier3 = 'y';
+constexpr char kPathOperatorClosePath = 'h';
+constexpr char kPathOperatorRectangle[] = "re";
 
 CFX_FloatRect GetShadingBBox(CPDF_ShadingPattern* pShading,
                              const CFX_Matrix& matrix) {
@@ -260,130 +256,216 @@ void ReplaceAbbr(RetainPtr<CPDF_Object> pObj) {
 }  // namespace
 
 // static
-void CPDF_StreamContentParser::InitializeGlobals() {
-  CHECK(!g_opcodes);
-  g_opcodes = new OpCodes({
-      {FXBSTR_ID('"', 0, 0, 0),
-       &CPDF_StreamContentParser::Handle_NextLineShowText_Space},
-      {FXBSTR_ID('\'', 0, 0, 0),
-       &CPDF_StreamContentParser::Handle_NextLineShowText},
-      {FXBSTR_ID('B', 0, 0, 0),
-       &CPDF_StreamContentParser::Handle_FillStrokePath},
-      {FXBSTR_ID('B', '*', 0, 0),
-       &CPDF_StreamContentParser::Handle_EOFillStrokePath},
-      {FXBSTR_ID('B', 'D', 'C', 0),
-       &CPDF_StreamContentParser::Handle_BeginMarkedContent_Dictionary},
-      {FXBSTR_ID('B', 'I', 0, 0), &CPDF_StreamContentParser::Handle_BeginImage},
-      {FXBSTR_ID('B', 'M', 'C', 0),
-       &CPDF_StreamContentParser::Handle_BeginMarkedContent},
-      {FXBSTR_ID('B', 'T', 0, 0), &CPDF_StreamContentParser::Handle_BeginText},
-      {FXBSTR_ID('C', 'S', 0, 0),
-       &CPDF_StreamContentParser::Handle_SetColorSpace_Stroke},
-      {FXBSTR_ID('D', 'P', 0, 0),
-       &CPDF_StreamContentParser::Handle_MarkPlace_Dictionary},
-      {FXBSTR_ID('D', 'o', 0, 0),
-       &CPDF_StreamContentParser::Handle_ExecuteXObject},
-      {FXBSTR_ID('E', 'I', 0, 0), &CPDF_StreamContentParser::Handle_EndImage},
-      {FXBSTR_ID('E', 'M', 'C', 0),
-       &CPDF_StreamContentParser::Handle_EndMarkedContent},
-      {FXBSTR_ID('E', 'T', 0, 0), &CPDF_StreamContentParser::Handle_EndText},
-      {FXBSTR_ID('F', 0, 0, 0), &CPDF_StreamContentParser::Handle_FillPathOld},
-      {FXBSTR_ID('G', 0, 0, 0),
-       &CPDF_StreamContentParser::Handle_SetGray_Stroke},
-      {FXBSTR_ID('I', 'D', 0, 0),
-       &CPDF_StreamContentParser::Handle_BeginImageData},
-      {FXBSTR_ID('J', 0, 0, 0), &CPDF_StreamContentParser::Handle_SetLineCap},
-      {FXBSTR_ID('K', 0, 0, 0),
-       &CPDF_StreamContentParser::Handle_SetCMYKColor_Stroke},
-      {FXBSTR_ID('M', 0, 0, 0),
-       &CPDF_StreamContentParser::Handle_SetMiterLimit},
-      {FXBSTR_ID('M', 'P', 0, 0), &CPDF_StreamContentParser::Handle_MarkPlace},
-      {FXBSTR_ID('Q', 0, 0, 0),
-       &CPDF_StreamContentParser::Handle_RestoreGraphState},
-      {FXBSTR_ID('R', 'G', 0, 0),
-       &CPDF_StreamContentParser::Handle_SetRGBColor_Stroke},
-      {FXBSTR_ID('S', 0, 0, 0), &CPDF_StreamContentParser::Handle_StrokePath},
-      {FXBSTR_ID('S', 'C', 0, 0),
-       &CPDF_StreamContentParser::Handle_SetColor_Stroke},
-      {FXBSTR_ID('S', 'C', 'N', 0),
-       &CPDF_StreamContentParser::Handle_SetColorPS_Stroke},
-      {FXBSTR_ID('T', '*', 0, 0),
-       &CPDF_StreamContentParser::Handle_MoveToNextLine},
-      {FXBSTR_ID('T', 'D', 0, 0),
-       &CPDF_StreamContentParser::Handle_MoveTextPoint_SetLeading},
-      {FXBSTR_ID('T', 'J', 0, 0),
-       &CPDF_StreamContentParser::Handle_ShowText_Positioning},
-      {FXBSTR_ID('T', 'L', 0, 0),
-       &CPDF_StreamContentParser::Handle_SetTextLeading},
-      {FXBSTR_ID('T', 'c', 0, 0),
-       &CPDF_StreamContentParser::Handle_SetCharSpace},
-      {FXBSTR_ID('T', 'd', 0, 0),
-       &CPDF_StreamContentParser::Handle_MoveTextPoint},
-      {FXBSTR_ID('T', 'f', 0, 0), &CPDF_StreamContentParser::Handle_SetFont},
-      {FXBSTR_ID('T', 'j', 0, 0), &CPDF_StreamContentParser::Handle_ShowText},
-      {FXBSTR_ID('T', 'm', 0, 0),
-       &CPDF_StreamContentParser::Handle_SetTextMatrix},
-      {FXBSTR_ID('T', 'r', 0, 0),
-       &CPDF_StreamContentParser::Handle_SetTextRenderMode},
-      {FXBSTR_ID('T', 's', 0, 0),
-       &CPDF_StreamContentParser::Handle_SetTextRise},
-      {FXBSTR_ID('T', 'w', 0, 0),
-       &CPDF_StreamContentParser::Handle_SetWordSpace},
-      {FXBSTR_ID('T', 'z', 0, 0),
-       &CPDF_StreamContentParser::Handle_SetHorzScale},
-      {FXBSTR_ID('W', 0, 0, 0), &CPDF_StreamContentParser::Handle_Clip},
-      {FXBSTR_ID('W', '*', 0, 0), &CPDF_StreamContentParser::Handle_EOClip},
-      {FXBSTR_ID('b', 0, 0, 0),
-       &CPDF_StreamContentParser::Handle_CloseFillStrokePath},
-      {FXBSTR_ID('b', '*', 0, 0),
-       &CPDF_StreamContentParser::Handle_CloseEOFillStrokePath},
-      {FXBSTR_ID('c', 0, 0, 0), &CPDF_StreamContentParser::Handle_CurveTo_123},
-      {FXBSTR_ID('c', 'm', 0, 0),
-       &CPDF_StreamContentParser::Handle_ConcatMatrix},
-      {FXBSTR_ID('c', 's', 0, 0),
-       &CPDF_StreamContentParser::Handle_SetColorSpace_Fill},
-      {FXBSTR_ID('d', 0, 0, 0), &CPDF_StreamContentParser::Handle_SetDash},
-      {FXBSTR_ID('d', '0', 0, 0),
-       &CPDF_StreamContentParser::Handle_SetCharWidth},
-      {FXBSTR_ID('d', '1', 0, 0),
-       &CPDF_StreamContentParser::Handle_SetCachedDevice},
-      {FXBSTR_ID('f', 0, 0, 0), &CPDF_StreamContentParser::Handle_FillPath},
-      {FXBSTR_ID('f', '*', 0, 0), &CPDF_StreamContentParser::Handle_EOFillPath},
-      {FXBSTR_ID('g', 0, 0, 0), &CPDF_StreamContentParser::Handle_SetGray_Fill},
-      {FXBSTR_ID('g', 's', 0, 0),
-       &CPDF_StreamContentParser::Handle_SetExtendGraphState},
-      {FXBSTR_ID('h', 0, 0, 0), &CPDF_StreamContentParser::Handle_ClosePath},
-      {FXBSTR_ID('i', 0, 0, 0), &CPDF_StreamContentParser::Handle_SetFlat},
-      {FXBSTR_ID('j', 0, 0, 0), &CPDF_StreamContentParser::Handle_SetLineJoin},
-      {FXBSTR_ID('k', 0, 0, 0),
-       &CPDF_StreamContentParser::Handle_SetCMYKColor_Fill},
-      {FXBSTR_ID('l', 0, 0, 0), &CPDF_StreamContentParser::Handle_LineTo},
-      {FXBSTR_ID('m', 0, 0, 0), &CPDF_StreamContentParser::Handle_MoveTo},
-      {FXBSTR_ID('n', 0, 0, 0), &CPDF_StreamContentParser::Handle_EndPath},
-      {FXBSTR_ID('q', 0, 0, 0),
-       &CPDF_StreamContentParser::Handle_SaveGraphState},
-      {FXBSTR_ID('r', 'e', 0, 0), &CPDF_StreamContentParser::Handle_Rectangle},
-      {FXBSTR_ID('r', 'g', 0, 0),
-       &CPDF_StreamContentParser::Handle_SetRGBColor_Fill},
-      {FXBSTR_ID('r', 'i', 0, 0),
-       &CPDF_StreamContentParser::Handle_SetRenderIntent},
-      {FXBSTR_ID('s', 0, 0, 0),
-       &CPDF_StreamContentParser::Handle_CloseStrokePath},
-      {FXBSTR_ID('s', 'c', 0, 0),
-       &CPDF_StreamContentParser::Handle_SetColor_Fill},
-      {FXBSTR_ID('s', 'c', 'n', 0),
-       &CPDF_StreamContentParser::Handle_SetColorPS_Fill},
-      {FXBSTR_ID('s', 'h', 0, 0), &CPDF_StreamContentParser::Handle_ShadeFill},
-      {FXBSTR_ID('v', 0, 0, 0), &CPDF_StreamContentParser::Handle_CurveTo_23},
-      {FXBSTR_ID('w', 0, 0, 0), &CPDF_StreamContentParser::Handle_SetLineWidth},
-      {FXBSTR_ID('y', 0, 0, 0), &CPDF_StreamContentParser::Handle_CurveTo_13},
-  });
-}
-
-// static
-void CPDF_StreamContentParser::DestroyGlobals() {
-  delete g_opcodes;
-  g_opcodes = nullptr;
+CPDF_StreamContentParser::OpCodeHandler CPDF_StreamContentParser::FindHandler(
+    ByteStringView op) {
+  using P = CPDF_StreamContentParser;
+  // Switch on the operator length and then on its bytes, so the compiler can
+  // turn each level into a jump table.
+  switch (op.GetLength()) {
+    case 1:
+      switch (op.CharAt(0)) {
+        case '"':
+          return &P::Handle_NextLineShowText_Space;
+        case '\'':
+          return &P::Handle_NextLineShowText;
+        case 'B':
+          return &P::Handle_FillStrokePath;
+        case 'F':
+          return &P::Handle_FillPathOld;
+        case 'G':
+          return &P::Handle_SetGray_Stroke;
+        case 'J':
+          return &P::Handle_SetLineCap;
+        case 'K':
+          return &P::Handle_SetCMYKColor_Stroke;
+        case 'M':
+          return &P::Handle_SetMiterLimit;
+        case 'Q':
+          return &P::Handle_RestoreGraphState;
+        case 'S':
+          return &P::Handle_StrokePath;
+        case 'W':
+          return &P::Handle_Clip;
+        case 'b':
+          return &P::Handle_CloseFillStrokePath;
+        case 'c':
+          return &P::Handle_CurveTo_123;
+        case 'd':
+          return &P::Handle_SetDash;
+        case 'f':
+          return &P::Handle_FillPath;
+        case 'g':
+          return &P::Handle_SetGray_Fill;
+        case 'h':
+          return &P::Handle_ClosePath;
+        case 'i':
+          return &P::Handle_SetFlat;
+        case 'j':
+          return &P::Handle_SetLineJoin;
+        case 'k':
+          return &P::Handle_SetCMYKColor_Fill;
+        case 'l':
+          return &P::Handle_LineTo;
+        case 'm':
+          return &P::Handle_MoveTo;
+        case 'n':
+          return &P::Handle_EndPath;
+        case 'q':
+          return &P::Handle_SaveGraphState;
+        case 's':
+          return &P::Handle_CloseStrokePath;
+        case 'v':
+          return &P::Handle_CurveTo_23;
+        case 'w':
+          return &P::Handle_SetLineWidth;
+        case 'y':
+          return &P::Handle_CurveTo_13;
+        default:
+          return nullptr;
+      }
+    case 2: {
+      const char second = op.CharAt(1);
+      switch (op.CharAt(0)) {
+        case 'B':
+          switch (second) {
+            case '*':
+              return &P::Handle_EOFillStrokePath;
+            case 'I':
+              return &P::Handle_BeginImage;
+            case 'T':
+              return &P::Handle_BeginText;
+            default:
+              return nullptr;
+          }
+        case 'C':
+          return second == 'S' ? &P::Handle_SetColorSpace_Stroke : nullptr;
+        case 'D':
+          switch (second) {
+            case 'P':
+              return &P::Handle_MarkPlace_Dictionary;
+            case 'o':
+              return &P::Handle_ExecuteXObject;
+            default:
+              return nullptr;
+          }
+        case 'E':
+          switch (second) {
+            case 'I':
+              return &P::Handle_EndImage;
+            case 'T':
+              return &P::Handle_EndText;
+            default:
+              return nullptr;
+          }
+        case 'I':
+          return second == 'D' ? &P::Handle_BeginImageData : nullptr;
+        case 'M':
+          return second == 'P' ? &P::Handle_MarkPlace : nullptr;
+        case 'R':
+          return second == 'G' ? &P::Handle_SetRGBColor_Stroke : nullptr;
+        case 'S':
+          return second == 'C' ? &P::Handle_SetColor_Stroke : nullptr;
+        case 'T':
+          switch (second) {
+            case '*':
+              return &P::Handle_MoveToNextLine;
+            case 'D':
+              return &P::Handle_MoveTextPoint_SetLeading;
+            case 'J':
+              return &P::Handle_ShowText_Positioning;
+            case 'L':
+              return &P::Handle_SetTextLeading;
+            case 'c':
+              return &P::Handle_SetCharSpace;
+            case 'd':
+              return &P::Handle_MoveTextPoint;
+            case 'f':
+              return &P::Handle_SetFont;
+            case 'j':
+              return &P::Handle_ShowText;
+            case 'm':
+              return &P::Handle_SetTextMatrix;
+            case 'r':
+              return &P::Handle_SetTextRenderMode;
+            case 's':
+              return &P::Handle_SetTextRise;
+            case 'w':
+              return &P::Handle_SetWordSpace;
+            case 'z':
+              return &P::Handle_SetHorzScale;
+            default:
+              return nullptr;
+          }
+        case 'W':
+          return second == '*' ? &P::Handle_EOClip : nullptr;
+        case 'b':
+          return second == '*' ? &P::Handle_CloseEOFillStrokePath : nullptr;
+        case 'c':
+          switch (second) {
+            case 'm':
+              return &P::Handle_ConcatMatrix;
+            case 's':
+              return &P::Handle_SetColorSpace_Fill;
+            default:
+              return nullptr;
+          }
+        case 'd':
+          switch (second) {
+            case '0':
+              return &P::Handle_SetCharWidth;
+            case '1':
+              return &P::Handle_SetCachedDevice;
+            default:
+              return nullptr;
+          }
+        case 'f':
+          return second == '*' ? &P::Handle_EOFillPath : nullptr;
+        case 'g':
+          return second == 's' ? &P::Handle_SetExtendGraphState : nullptr;
+        case 'r':
+          switch (second) {
+            case 'e':
+              return &P::Handle_Rectangle;
+            case 'g':
+              return &P::Handle_SetRGBColor_Fill;
+            case 'i':
+              return &P::Handle_SetRenderIntent;
+            default:
+              return nullptr;
+          }
+        case 's':
+          switch (second) {
+            case 'c':
+              return &P::Handle_SetColor_Fill;
+            case 'h':
+              return &P::Handle_ShadeFill;
+            default:
+              return nullptr;
+          }
+        default:
+          return nullptr;
+      }
+    }
+    case 3:
+      if (op == "BDC") {
+        return &P::Handle_BeginMarkedContent_Dictionary;
+      }
+      if (op == "BMC") {
+        return &P::Handle_BeginMarkedContent;
+      }
+      if (op == "EMC") {
+        return &P::Handle_EndMarkedContent;
+      }
+      if (op == "SCN") {
+        return &P::Handle_SetColorPS_Stroke;
+      }
+      if (op == "scn") {
+        return &P::Handle_SetColorPS_Fill;
+      }
+      return nullptr;
+    default:
+      return nullptr;
+  }
 }
 
 CPDF_StreamContentParser::CPDF_StreamContentParser(
@@ -589,9 +671,9 @@ void CPDF_StreamContentParser::SetGraphicStates(CPDF_PageObject* pObj,
 }
 
 void CPDF_StreamContentParser::OnOperator(ByteStringView op) {
-  auto it = g_opcodes->find(op.GetID());
-  if (it != g_opcodes->end()) {
-    (this->*it->second)();
+  OpCodeHandler handler = FindHandler(op);
+  if (handler) {
+    (this->*handler)();
   }
 }
 
@@ -1055,6 +1137,7 @@ void CPDF_StreamContentParser::Handle_Rectangle() {
   float w = GetNumber(1);
   float h = GetNumber(0);
   AddPathRect(x, y, w, h);
+  ParsePathObject();
 }
 
 void CPDF_StreamContentParser::AddPathRect(float x, float y, float w, float h) {
@@ -1683,99 +1766,99 @@ uint32_t CPDF_StreamContentParser::Parse(
 }
 
 void CPDF_StreamContentParser::ParsePathObject() {
+  // Handles runs of path construction operators without going through the
+  // generic parameter buffer. Stops before the first operator it does not
+  // handle, or that does not have exactly the number of operands it needs, and
+  // leaves that to Parse(), so the result is the same as going through
+  // OnOperator().
   std::array<float, 6> params = {};
-  int nParams = 0;
-  int last_pos = syntax_->GetPos();
+  size_t param_count = 0;
+  uint32_t last_pos = syntax_->GetPos();
   while (true) {
-    CPDF_StreamParser::ElementType type = syntax_->ParseNextElement();
-    bool bProcessed = true;
-    switch (type) {
+    switch (syntax_->ParseNextElement()) {
       case CPDF_StreamParser::ElementType::kEndOfData:
         return;
-      case CPDF_StreamParser::ElementType::kKeyword: {
-        ByteStringView strc = syntax_->GetWord();
-        int len = strc.GetLength();
-        if (len == 1) {
-          switch (strc[0]) {
-            case kPathOperatorSubpath:
-              AddPathPoint({params[0], params[1]},
-                           CFX_Path::Point::Type::kMove);
-              nParams = 0;
-              break;
-            case kPathOperatorLine:
-              AddPathPoint({params[0], params[1]},
-                           CFX_Path::Point::Type::kLine);
-              nParams = 0;
-              break;
-            case kPathOperatorCubicBezier1:
-              AddPathPoint({params[0], params[1]},
-                           CFX_Path::Point::Type::kBezier);
-              AddPathPoint({params[2], params[3]},
-                           CFX_Path::Point::Type::kBezier);
-              AddPathPoint({params[4], params[5]},
-                           CFX_Path::Point::Type::kBezier);
-              nParams = 0;
-              break;
-            case kPathOperatorCubicBezier2:
-              AddPathPoint(path_current_, CFX_Path::Point::Type::kBezier);
-              AddPathPoint({params[0], params[1]},
-                           CFX_Path::Point::Type::kBezier);
-              AddPathPoint({params[2], params[3]},
-                           CFX_Path::Point::Type::kBezier);
-              nParams = 0;
-              break;
-            case kPathOperatorCubicBezier3:
-              AddPathPoint({params[0], params[1]},
-                           CFX_Path::Point::Type::kBezier);
-              AddPathPoint({params[2], params[3]},
-                           CFX_Path::Point::Type::kBezier);
-              AddPathPoint({params[2], params[3]},
-                           CFX_Path::Point::Type::kBezier);
-              nParams = 0;
-              break;
-            case kPathOperatorClosePath:
-              Handle_ClosePath();
-              nParams = 0;
-              break;
-            default:
-              bProcessed = false;
-              break;
-          }
-        } else if (len == 2) {
-          if (strc[0] == kPathOperatorRectangle[0] &&
-              strc[1] == kPathOperatorRectangle[1]) {
-            AddPathRect(params[0], params[1], params[2], params[3]);
-            nParams = 0;
-          } else {
-            bProcessed = false;
-          }
-        } else {
-          bProcessed = false;
-        }
-        if (bProcessed) {
-          last_pos = syntax_->GetPos();
+      case CPDF_StreamParser::ElementType::kNumber:
+        if (param_count == params.size()) {
+          syntax_->SetPos(last_pos);
+          return;
         }
+        params[param_count++] = FX_Number(syntax_->GetWord()).GetFloat();
         break;
-      }
-      case CPDF_StreamParser::ElementType::kNumber: {
-        if (nParams == 6) {
-          break;
+      case CPDF_StreamParser::ElementType::kKeyword:
+        if (!HandlePathOperator(syntax_->GetWord(),
+                                pdfium::span(params).first(param_count))) {
+          syntax_->SetPos(last_pos);
+          return;
         }
-
-        FX_Number number(syntax_->GetWord());
-        params[nParams++] = number.GetFloat();
+        param_count = 0;
+        last_pos = syntax_->GetPos();
         break;
-      }
       default:
-        bProcessed = false;
-    }
-    if (!bProcessed) {
-      syntax_->SetPos(last_pos);
-      return;
+        syntax_->SetPos(last_pos);
+        return;
     }
   }
 }
 
+bool CPDF_StreamContentParser::HandlePathOperator(
+    ByteStringView op,
+    pdfium::span<const float> params) {
+  switch (op.GetID()) {
+    case FXBSTR_ID(kPathOperatorSubpath, 0, 0, 0):
+      if (params.size() != 2) {
+        return false;
+      }
+      AddPathPoint({params[0], params[1]}, CFX_Path::Point::Type::kMove);
+      return true;
+    case FXBSTR_ID(kPathOperatorLine, 0, 0, 0):
+      if (params.size() != 2) {
+        return false;
+      }
+      AddPathPoint({params[0], params[1]}, CFX_Path::Point::Type::kLine);
+      return true;
+    case FXBSTR_ID(kPathOperatorCubicBezier1, 0, 0, 0):
+      if (params.size() != 6) {
+        return false;
+      }
+      AddPathPoint({params[0], params[1]}, CFX_Path::Point::Type::kBezier);
+      AddPathPoint({params[2], params[3]}, CFX_Path::Point::Type::kBezier);
+      AddPathPoint({params[4], params[5]}, CFX_Path::Point::Type::kBezier);
+      return true;
+    case FXBSTR_ID(kPathOperatorCubicBezier2, 0, 0, 0):
+      if (params.size() != 4) {
+        return false;
+      }
+      AddPathPoint(path_current_, CFX_Path::Point::Type::kBezier);
+      AddPathPoint({params[0], params[1]}, CFX_Path::Point::Type::kBezier);
+      AddPathPoint({params[2], params[3]}, CFX_Path::Point::Type::kBezier);
+      return true;
+    case FXBSTR_ID(kPathOperatorCubicBezier3, 0, 0, 0):
+      if (params.size() != 4) {
+        return false;
+      }
+      AddPathPoint({params[0], params[1]}, CFX_Path::Point::Type::kBezier);
+      AddPathPoint({params[2], params[3]}, CFX_Path::Point::Type::kBezier);
+      AddPathPoint({params[2], params[3]}, CFX_Path::Point::Type::kBezier);
+      return true;
+    case FXBSTR_ID(kPathOperatorClosePath, 0, 0, 0):
+      if (!params.empty()) {
+        return false;
+      }
+      Handle_ClosePath();
+      return true;
+    case FXBSTR_ID(kPathOperatorRectangle[0], kPathOperatorRectangle[1], 0,
+                   0):
+      if (params.size() != 4) {
+        return false;
+      }
+      AddPathRect(params[0], params[1], params[2], params[3]);
+      return true;
+    default:
+      return false;
+  }
+}
+
 // static
 ByteStringView CPDF_StreamContentParser::FindKeyAbbreviationForTesting(
     ByteStringView abbr) {
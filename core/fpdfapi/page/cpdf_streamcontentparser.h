@@ -42,9 +42,6 @@ class CPDF_TextObject;
 
 class CPDF_StreamContentParser {
  public:
-  static void InitializeGlobals();
-  static void DestroyGlobals();
-
   CPDF_StreamContentParser(CPDF_Document* doc,
                            RetainPtr<CPDF_Dictionary> pPageResources,
                            RetainPtr<CPDF_Dictionary> pParentResources,
@@ -76,8 +73,13 @@ class CPDF_StreamContentParser {
   using ContentParam =
       std::variant<RetainPtr<CPDF_Object>, FX_Number, ByteString>;
 
+  using OpCodeHandler = void (CPDF_StreamContentParser::*)();
+
   static constexpr int kParamBufSize = 16;
 
+  // Returns the handler for operator `op`, or nullptr for unknown operators.
+  static OpCodeHandler FindHandler(ByteStringView op);
+
   void AddNameParam(ByteStringView bsName);
   void AddNumberParam(ByteStringView str);
   void AddObjectParam(RetainPtr<CPDF_Object> pObj);
@@ -105,6 +107,9 @@ class CPDF_StreamContentParser {
 
   void OnChangeTextMatrix();
   void ParsePathObject();
+  // Runs the path construction operator `op` on `params`, if it is one and
+  // `params` has the right size. Returns whether it did.
+  bool HandlePathOperator(ByteStringView op, pdfium::span<const float> params);
   void AddPathPoint(const CFX_PointF& point, CFX_Path::Point::Type type);
   void AddPathPointAndClose(const CFX_PointF& point,
                             CFX_Path::Point::Type type);
@@ -0,0 +1,112 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stddef.h>
+
+#include <functional>
+#include <string>
+
+#include "core/fxcrt/bytestring.h"
+#include "public/cpp/fpdf_scopers.h"
+#include "public/fpdf_edit.h"
+#include "public/fpdfview.h"
+#include "testing/embedder_test.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf_timer.h"
+
+namespace {
+
+// Size of the synthetic content streams.
+constexpr size_t kContentSize = 8 * 1024 * 1024;
+
+// Returns a one page document, with a content stream made of `make_chunk`'s
+// results for 0, 1, 2, ... until it is `kContentSize` bytes or more.
+std::string MakeDocument(const std::function<ByteString(int)>& make_chunk) {
+  std::string content;
+  content.reserve(kContentSize);
+  for (int i = 0; content.size() < kContentSize; ++i) {
+    content += make_chunk(i).c_str();
+  }
+
+  std::string pdf = "%PDF-1.7\n";
+  size_t offsets[6] = {};
+  offsets[1] = pdf.size();
+  pdf += "1 0 obj\n<< /Type /Catalog /Pages 2 0 R >>\nendobj\n";
+  offsets[2] = pdf.size();
+  pdf += "2 0 obj\n<< /Type /Pages /Kids [3 0 R] /Count 1 >>\nendobj\n";
+  offsets[3] = pdf.size();
+  pdf +=
+      "3 0 obj\n<< /Type /Page /Parent 2 0 R /MediaBox [0 0 612 792] "
+      "/Resources << /Font << /F1 5 0 R >> >> /Contents 4 0 R >>\nendobj\n";
+  offsets[4] = pdf.size();
+  pdf += ByteString::Format("4 0 obj\n<< /Length %zu >>\nstream\n",
+                            content.size())
+             .c_str();
+  pdf += content;
+  pdf += "\nendstream\nendobj\n";
+  offsets[5] = pdf.size();
+  pdf +=
+      "5 0 obj\n<< /Type /Font /Subtype /Type1 /BaseFont /Helvetica >>\n"
+      "endobj\n";
+
+  const size_t xref_offset = pdf.size();
+  pdf += "xref\n0 6\n0000000000 65535 f\r\n";
+  for (size_t i = 1; i < 6; ++i) {
+    pdf += ByteString::Format("%010zu 00000 n\r\n", offsets[i]).c_str();
+  }
+  pdf += ByteString::Format(
+             "trailer\n<< /Size 6 /Root 1 0 R >>\nstartxref\n%zu\n%%%%EOF\n",
+             xref_offset)
+             .c_str();
+  return pdf;
+}
+
+// Paths with many real number operands, and graphics state changes.
+ByteString MakePathChunk(int i) {
+  const int x = i % 500;
+  const int y = i % 700;
+  return ByteString::Format(
+      "q 0.%03d 0.5 0.25 rg 1.5 w 1 0 0 1 %d.25 %d.75 cm "
+      "%d.125 %d.5 m %d.75 %d.0625 l %d.5 %d.25 %d.125 %d.5 %d.75 %d.375 c "
+      "h f Q\n",
+      i % 1000, x, y, x, y, x + 10, y + 3, x + 12, y + 8, x + 4, y + 12, x,
+      y + 6);
+}
+
+// Text objects with font, positioning and string operands.
+ByteString MakeTextChunk(int i) {
+  return ByteString::Format(
+      "BT /F1 %d Tf %d.5 %d.25 Td 0.%03d Tc (Line %d of the text) Tj "
+      "[(Kerned) -120 (text) 80.5 (array)] TJ ET\n",
+      8 + i % 8, i % 400, i % 700, i % 1000, i);
+}
+
+void MeasureLoadPage(const std::string& pdf) {
+  ScopedFPDFDocument doc(
+      FPDF_LoadMemDocument64(pdf.data(), pdf.size(), nullptr));
+  ASSERT_TRUE(doc);
+  const double ms =
+      pdfium::MeasureBestTimeMs("load_page", pdfium::kDefaultPerfRuns, [&doc] {
+        ScopedFPDFPage page(FPDF_LoadPage(doc.get(), 0));
+        ASSERT_TRUE(page);
+        EXPECT_GT(FPDFPage_CountObjects(page.get()), 0);
+      });
+  testing::Test::RecordProperty(
+      "mib_per_second",
+      ByteString::Format("%.1f", kContentSize / (1024.0 * 1024.0) /
+                                     (ms / 1000.0))
+          .c_str());
+}
+
+}  // namespace
+
+class CPDFStreamContentParserPerfTest : public EmbedderTest {};
+
+TEST_F(CPDFStreamContentParserPerfTest, ParsePaths) {
+  MeasureLoadPage(MakeDocument(MakePathChunk));
+}
+
+TEST_F(CPDFStreamContentParserPerfTest, ParseText) {
+  MeasureLoadPage(MakeDocument(MakeTextChunk));
+}
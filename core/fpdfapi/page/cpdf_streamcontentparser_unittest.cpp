@@ -3,8 +3,62 @@
 // found in the LICENSE file.
 
 #include "core/fpdfapi/page/cpdf_streamcontentparser.h"
+
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include "core/fpdfapi/page/cpdf_form.h"
+#include "core/fpdfapi/page/cpdf_pathobject.h"
+#include "core/fpdfapi/page/test_with_page_module.h"
+#include "core/fpdfapi/parser/cpdf_dictionary.h"
+#include "core/fpdfapi/parser/cpdf_stream.h"
+#include "core/fpdfapi/parser/cpdf_test_document.h"
+#include "core/fxcrt/data_vector.h"
+#include "core/fxcrt/span.h"
+#include "core/fxge/cfx_path.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
+namespace {
+
+class CPDFStreamContentParserPathTest : public TestWithPageModule {
+ protected:
+  // Parses `contents` as a form, and returns the points of its only page
+  // object, which must be a path.
+  std::vector<CFX_Path::Point> ParsePath(pdfium::span<const uint8_t> contents) {
+    CPDF_TestDocument doc;
+    doc.CreateNewDoc();
+    auto stream = pdfium::MakeRetain<CPDF_Stream>(
+        DataVector<uint8_t>(contents.begin(), contents.end()),
+        pdfium::MakeRetain<CPDF_Dictionary>());
+    auto form = std::make_unique<CPDF_Form>(&doc, nullptr, stream);
+    form->ParseContent();
+    EXPECT_EQ(1u, form->GetPageObjectCount());
+    if (form->GetPageObjectCount() != 1) {
+      return {};
+    }
+    CPDF_PathObject* path = form->GetPageObjectByIndex(0)->AsPath();
+    EXPECT_TRUE(path);
+    if (!path) {
+      return {};
+    }
+    return path->path().GetPoints();
+  }
+};
+
+void ExpectPoint(const CFX_Path::Point& point,
+                 float x,
+                 float y,
+                 CFX_Path::Point::Type type,
+                 bool close_figure) {
+  EXPECT_FLOAT_EQ(x, point.point_.x);
+  EXPECT_FLOAT_EQ(y, point.point_.y);
+  EXPECT_EQ(type, point.type_);
+  EXPECT_EQ(close_figure, point.close_figure_);
+}
+
+}  // namespace
+
 TEST(CPDFStreamContentParserTest, PDFFindKeyAbbreviation) {
   EXPECT_EQ(ByteStringView("BitsPerComponent"),
             CPDF_StreamContentParser::FindKeyAbbreviationForTesting(
@@ -42,3 +96,47 @@ TEST(CPDFStreamContentParserTest, PDFFindValueAbbreviation) {
             CPDF_StreamContentParser::FindValueAbbreviationForTesting(
                 ByteStringView("II")));
 }
+
+TEST_F(CPDFStreamContentParserPathTest, PathOperators) {
+  static constexpr uint8_t kContents[] =
+      "1 2 m 3 4 l 5 6 7 8 9 10 c 11 12 13 14 v 15 16 17 18 y h "
+      "-1 -2 .5 4 re f";
+  std::vector<CFX_Path::Point> points =
+      ParsePath(pdfium::span(kContents).first(std::size(kContents) - 1));
+  ASSERT_EQ(17u, points.size());
+  using Type = CFX_Path::Point::Type;
+  ExpectPoint(points[0], 1, 2, Type::kMove, false);
+  ExpectPoint(points[1], 3, 4, Type::kLine, false);
+  ExpectPoint(points[2], 5, 6, Type::kBezier, false);
+  ExpectPoint(points[3], 7, 8, Type::kBezier, false);
+  ExpectPoint(points[4], 9, 10, Type::kBezier, false);
+  ExpectPoint(points[5], 9, 10, Type::kBezier, false);
+  ExpectPoint(points[6], 11, 12, Type::kBezier, false);
+  ExpectPoint(points[7], 13, 14, Type::kBezier, false);
+  ExpectPoint(points[8], 15, 16, Type::kBezier, false);
+  ExpectPoint(points[9], 17, 18, Type::kBezier, false);
+  ExpectPoint(points[10], 17, 18, Type::kBezier, false);
+  ExpectPoint(points[11], 1, 2, Type::kLine, true);
+  ExpectPoint(points[12], -1, -2, Type::kMove, false);
+  ExpectPoint(points[13], -0.5f, -2, Type::kLine, false);
+  ExpectPoint(points[14], -0.5f, 2, Type::kLine, false);
+  ExpectPoint(points[15], -1, 2, Type::kLine, false);
+  ExpectPoint(points[16], -1, -2, Type::kLine, true);
+}
+
+TEST_F(CPDFStreamContentParserPathTest, WrongOperandCounts) {
+  // Path operators with the wrong number of operands get handled the same
+  // way, whether or not they follow other path operators.
+  static constexpr uint8_t kContents[] =
+      "1 2 m 9 3 4 l 5 l 6 7 l 1 2 3 4 5 6 7 8 9 10 11 12 13 14 c h 1 h f";
+  std::vector<CFX_Path::Point> points =
+      ParsePath(pdfium::span(kContents).first(std::size(kContents) - 1));
+  ASSERT_EQ(6u, points.size());
+  using Type = CFX_Path::Point::Type;
+  ExpectPoint(points[0], 1, 2, Type::kMove, false);
+  ExpectPoint(points[1], 6, 7, Type::kLine, false);
+  ExpectPoint(points[2], 9, 10, Type::kBezier, false);
+  ExpectPoint(points[3], 11, 12, Type::kBezier, false);
+  ExpectPoint(points[4], 13, 14, Type::kBezier, false);
+  ExpectPoint(points[5], 1, 2, Type::kLine, true);
+}
@@ -79,8 +79,7 @@ uint32_t DecodeInlineStream(pdfium::span<const uint8_t> src_span,
                             int width,
                             int height,
                             const ByteString& decoder,
-                            RetainPtr<const CPDF_Dictionary> pParam,
-                            uint32_t orig_size) {
+                            RetainPtr<const CPDF_Dictionary> pParam) {
   // |decoder| should not be an abbreviation.
   DCHECK(decoder != "A85");
   DCHECK(decoder != "AHx");
@@ -91,9 +90,7 @@ uint32_t DecodeInlineStream(pdfium::span<const uint8_t> src_span,
   DCHECK(decoder != "RL");
 
   if (decoder == "FlateDecode") {
-    return FlateOrLZWDecode(/*use_lzw=*/false, src_span, pParam.Get(),
-                            /*estimated_size=*/orig_size)
-        .bytes_consumed;
+    return GetFlateDecodeSrcSize(src_span, pParam.Get());
   }
   if (decoder == "LZWDecode") {
     return FlateOrLZWDecode(
@@ -104,7 +101,8 @@ uint32_t DecodeInlineStream(pdfium::span<const uint8_t> src_span,
   if (decoder == "DCTDecode") {
     std::unique_ptr<ScanlineDecoder> pDecoder = JpegModule::CreateDecoder(
         src_span, width, height, 0,
-        !pParam || pParam->GetIntegerFor("ColorTransform", 1));
+        !pParam || pParam->GetIntegerFor("ColorTransform", 1),
+        /*resolution_levels_to_skip=*/0);
     return DecodeAllScanlines(std::move(pDecoder));
   }
   if (decoder == "CCITTFaxDecode") {
@@ -205,7 +203,7 @@ RetainPtr<CPDF_Stream> CPDF_StreamParser::ReadInlineStream(
   } else {
     actual_stream_size =
         DecodeInlineStream(stream_span, width, height, decoder,
-                           std::move(param_dict), original_size);
+                           std::move(param_dict));
     if (!pdfium::IsValueInRangeForNumericType<int>(actual_stream_size)) {
       return nullptr;
     }
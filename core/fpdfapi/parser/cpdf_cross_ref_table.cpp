@@ -4,12 +4,237 @@
 
 #include "core/fpdfapi/parser/cpdf_cross_ref_table.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "core/fpdfapi/parser/cpdf_dictionary.h"
 #include "core/fpdfapi/parser/cpdf_parser.h"
+#include "core/fxcrt/check.h"
 #include "core/fxcrt/check_op.h"
-#include "core/fxcrt/containers/contains.h"
+
+namespace {
+
+// Object numbers below this value are always stored densely.
+constexpr uint32_t kMinDenseSize = 1024;
+
+// Dense storage is used as long as at least 1 in this many slots is in use.
+// A dense slot costs a fraction of a std::map node, so this keeps dense
+// storage no larger than the equivalent sparse storage.
+constexpr uint32_t kMaxDenseSlotsPerEntry = 4;
+
+bool ShouldPreserveObjectStreamFlag(
+    const CPDF_CrossRefTable::ObjectInfo& current,
+    const CPDF_CrossRefTable::ObjectInfo& top) {
+  return top.type == CPDF_CrossRefTable::ObjectType::kNormal &&
+         current.type == CPDF_CrossRefTable::ObjectType::kNormal &&
+         current.is_object_stream_flag;
+}
+
+}  // namespace
+
+CPDF_CrossRefTable::ObjectInfoMap::const_iterator::const_iterator(
+    const ObjectInfoMap* map,
+    uint32_t dense_index,
+    std::map<uint32_t, ObjectInfo>::const_iterator sparse_it)
+    : map_(map), dense_index_(dense_index), sparse_it_(sparse_it) {
+  SkipAbsentDenseEntries();
+}
+
+CPDF_CrossRefTable::ObjectInfoMap::value_type
+CPDF_CrossRefTable::ObjectInfoMap::const_iterator::operator*() const {
+  if (dense_index_ < map_->dense_.size()) {
+    return {dense_index_, map_->dense_[dense_index_]};
+  }
+  return {sparse_it_->first, sparse_it_->second};
+}
+
+CPDF_CrossRefTable::ObjectInfoMap::const_iterator&
+CPDF_CrossRefTable::ObjectInfoMap::const_iterator::operator++() {
+  if (dense_index_ < map_->dense_.size()) {
+    ++dense_index_;
+    SkipAbsentDenseEntries();
+  } else {
+    ++sparse_it_;
+  }
+  return *this;
+}
+
+void CPDF_CrossRefTable::ObjectInfoMap::const_iterator::
+    SkipAbsentDenseEntries() {
+  while (dense_index_ < map_->dense_.size() &&
+         !map_->dense_present_[dense_index_]) {
+    ++dense_index_;
+  }
+}
+
+CPDF_CrossRefTable::ObjectInfoMap::ObjectInfoMap() = default;
+
+CPDF_CrossRefTable::ObjectInfoMap::ObjectInfoMap(ObjectInfoMap&& that) noexcept
+    : dense_(std::move(that.dense_)),
+      dense_present_(std::move(that.dense_present_)),
+      sparse_(std::move(that.sparse_)),
+      size_(std::exchange(that.size_, 0)) {
+  that.clear();
+}
+
+CPDF_CrossRefTable::ObjectInfoMap&
+CPDF_CrossRefTable::ObjectInfoMap::operator=(ObjectInfoMap&& that) noexcept {
+  dense_ = std::move(that.dense_);
+  dense_present_ = std::move(that.dense_present_);
+  sparse_ = std::move(that.sparse_);
+  size_ = std::exchange(that.size_, 0);
+  that.clear();
+  return *this;
+}
+
+CPDF_CrossRefTable::ObjectInfoMap::~ObjectInfoMap() = default;
+
+CPDF_CrossRefTable::ObjectInfoMap::const_iterator
+CPDF_CrossRefTable::ObjectInfoMap::begin() const {
+  return const_iterator(this, 0, sparse_.begin());
+}
+
+CPDF_CrossRefTable::ObjectInfoMap::const_iterator
+CPDF_CrossRefTable::ObjectInfoMap::end() const {
+  return const_iterator(this, static_cast<uint32_t>(dense_.size()),
+                        sparse_.end());
+}
+
+uint32_t CPDF_CrossRefTable::ObjectInfoMap::GetLastObjNum() const {
+  CHECK(!empty());
+  if (!sparse_.empty()) {
+    return sparse_.rbegin()->first;
+  }
+  return static_cast<uint32_t>(dense_.size() - 1);
+}
+
+const CPDF_CrossRefTable::ObjectInfo* CPDF_CrossRefTable::ObjectInfoMap::Find(
+    uint32_t obj_num) const {
+  if (obj_num < dense_.size()) {
+    return dense_present_[obj_num] ? &dense_[obj_num] : nullptr;
+  }
+  const auto it = sparse_.find(obj_num);
+  return it != sparse_.end() ? &it->second : nullptr;
+}
+
+std::pair<CPDF_CrossRefTable::ObjectInfo*, bool>
+CPDF_CrossRefTable::ObjectInfoMap::FindOrCreate(uint32_t obj_num) {
+  if (obj_num >= dense_.size()) {
+    auto it = sparse_.find(obj_num);
+    if (it != sparse_.end()) {
+      return {&it->second, false};
+    }
+
+    // Prefer moving all the sparse entries over in one go, so growing
+    // `dense_` one object at a time does not repeatedly pick them off.
+    const uint32_t last_obj_num =
+        sparse_.empty() ? obj_num
+                        : std::max(obj_num, sparse_.rbegin()->first);
+    if (IsDenseEnough(last_obj_num)) {
+      GrowDense(last_obj_num + 1);
+    } else if (IsDenseEnough(obj_num)) {
+      GrowDense(obj_num + 1);
+    } else {
+      ++size_;
+      return {&sparse_.emplace(obj_num, ObjectInfo()).first->second, true};
+    }
+  }
+
+  if (dense_present_[obj_num]) {
+    return {&dense_[obj_num], false};
+  }
+
+  dense_present_[obj_num] = true;
+  ++size_;
+  return {&dense_[obj_num], true};
+}
+
+void CPDF_CrossRefTable::ObjectInfoMap::Truncate(uint32_t size) {
+  if (size < dense_.size()) {
+    for (size_t i = size; i < dense_.size(); ++i) {
+      if (dense_present_[i]) {
+        --size_;
+      }
+    }
+    dense_.resize(size);
+    dense_present_.resize(size);
+    TrimDense();
+  }
+
+  auto it = sparse_.lower_bound(size);
+  size_ -= static_cast<size_t>(std::distance(it, sparse_.end()));
+  sparse_.erase(it, sparse_.end());
+}
+
+void CPDF_CrossRefTable::ObjectInfoMap::clear() {
+  dense_.clear();
+  dense_present_.clear();
+  sparse_.clear();
+  size_ = 0;
+}
+
+void CPDF_CrossRefTable::ObjectInfoMap::MergeUp(ObjectInfoMap top) {
+  if (top.empty()) {
+    return;
+  }
+
+  if (empty()) {
+    *this = std::move(top);
+    return;
+  }
+
+  // Walk the smaller of the two maps, and insert its entries into the larger
+  // one, so merging a small update section into a large table, or vice versa,
+  // does not touch every entry in the large table.
+  if (top.size() <= size()) {
+    for (const auto& [obj_num, top_info] : top) {
+      auto [info, created] = FindOrCreate(obj_num);
+      const bool preserve_flag =
+          !created && ShouldPreserveObjectStreamFlag(*info, top_info);
+      *info = top_info;
+      if (preserve_flag) {
+        info->is_object_stream_flag = true;
+      }
+    }
+    return;
+  }
+
+  for (const auto& [obj_num, current_info] : *this) {
+    auto [info, created] = top.FindOrCreate(obj_num);
+    if (created) {
+      *info = current_info;
+    } else if (ShouldPreserveObjectStreamFlag(current_info, *info)) {
+      info->is_object_stream_flag = true;
+    }
+  }
+  *this = std::move(top);
+}
+
+bool CPDF_CrossRefTable::ObjectInfoMap::IsDenseEnough(uint32_t obj_num) const {
+  // Account for the entry being added for `obj_num`.
+  return obj_num < kMinDenseSize ||
+         obj_num / kMaxDenseSlotsPerEntry <= size_ + 1;
+}
+
+void CPDF_CrossRefTable::ObjectInfoMap::GrowDense(uint32_t new_dense_size) {
+  DCHECK_GT(new_dense_size, dense_.size());
+  dense_.resize(new_dense_size);
+  dense_present_.resize(new_dense_size);
+
+  auto it = sparse_.begin();
+  while (it != sparse_.end() && it->first < new_dense_size) {
+    dense_[it->first] = it->second;
+    dense_present_[it->first] = true;
+    it = sparse_.erase(it);
+  }
+}
+
+void CPDF_CrossRefTable::ObjectInfoMap::TrimDense() {
+  while (!dense_present_.empty() && !dense_present_.back()) {
+    dense_.pop_back();
+    dense_present_.pop_back();
+  }
+}
 
 // static
 std::unique_ptr<CPDF_CrossRefTable> CPDF_CrossRefTable::MergeUp(
@@ -42,22 +267,24 @@ void CPDF_CrossRefTable::AddCompressed(uint32_t obj_num,
   CHECK_LE(obj_num, CPDF_Parser::kMaxObjectNumber);
   CHECK_LE(archive_obj_num, CPDF_Parser::kMaxObjectNumber);
 
-  auto& info = objects_info_[obj_num];
-  if (info.gennum > 0) {
+  ObjectInfo* info = objects_info_.FindOrCreate(obj_num).first;
+  if (info->gennum > 0) {
     return;
   }
 
   // Don't add known object streams to object streams.
-  if (info.is_object_stream_flag) {
+  if (info->is_object_stream_flag) {
     return;
   }
 
-  info.type = ObjectType::kCompressed;
-  info.archive.obj_num = archive_obj_num;
-  info.archive.obj_index = archive_obj_index;
-  info.gennum = 0;
+  info->type = ObjectType::kCompressed;
+  info->archive.obj_num = archive_obj_num;
+  info->archive.obj_index = archive_obj_index;
+  info->gennum = 0;
 
-  objects_info_[archive_obj_num].is_object_stream_flag = true;
+  // Note that this may invalidate `info`.
+  objects_info_.FindOrCreate(archive_obj_num).first->is_object_stream_flag =
+      true;
 }
 
 void CPDF_CrossRefTable::AddNormal(uint32_t obj_num,
@@ -66,24 +293,24 @@ void CPDF_CrossRefTable::AddNormal(uint32_t obj_num,
                                    FX_FILESIZE pos) {
   CHECK_LE(obj_num, CPDF_Parser::kMaxObjectNumber);
 
-  auto& info = objects_info_[obj_num];
-  if (info.gennum > gen_num) {
+  ObjectInfo* info = objects_info_.FindOrCreate(obj_num).first;
+  if (info->gennum > gen_num) {
     return;
   }
 
-  info.type = ObjectType::kNormal;
-  info.is_object_stream_flag |= is_object_stream;
-  info.gennum = gen_num;
-  info.pos = pos;
+  info->type = ObjectType::kNormal;
+  info->is_object_stream_flag |= is_object_stream;
+  info->gennum = gen_num;
+  info->pos = pos;
 }
 
 void CPDF_CrossRefTable::SetFree(uint32_t obj_num, uint16_t gen_num) {
   CHECK_LE(obj_num, CPDF_Parser::kMaxObjectNumber);
 
-  auto& info = objects_info_[obj_num];
-  info.type = ObjectType::kFree;
-  info.gennum = gen_num;
-  info.pos = 0;
+  ObjectInfo* info = objects_info_.FindOrCreate(obj_num).first;
+  info->type = ObjectType::kFree;
+  info->gennum = gen_num;
+  info->pos = 0;
 }
 
 void CPDF_CrossRefTable::SetTrailer(RetainPtr<CPDF_Dictionary> trailer,
@@ -94,13 +321,12 @@ void CPDF_CrossRefTable::SetTrailer(RetainPtr<CPDF_Dictionary> trailer,
 
 const CPDF_CrossRefTable::ObjectInfo* CPDF_CrossRefTable::GetObjectInfo(
     uint32_t obj_num) const {
-  const auto it = objects_info_.find(obj_num);
-  return it != objects_info_.end() ? &it->second : nullptr;
+  return objects_info_.Find(obj_num);
 }
 
 void CPDF_CrossRefTable::Update(
     std::unique_ptr<CPDF_CrossRefTable> new_cross_ref) {
-  UpdateInfo(std::move(new_cross_ref->objects_info_));
+  objects_info_.MergeUp(std::move(new_cross_ref->objects_info_));
   UpdateTrailer(std::move(new_cross_ref->trailer_));
 }
 
@@ -110,46 +336,11 @@ void CPDF_CrossRefTable::SetObjectMapSize(uint32_t size) {
     return;
   }
 
-  objects_info_.erase(objects_info_.lower_bound(size), objects_info_.end());
-
-  if (!pdfium::Contains(objects_info_, size - 1)) {
-    objects_info_[size - 1].pos = 0;
-  }
-}
-
-void CPDF_CrossRefTable::UpdateInfo(
-    std::map<uint32_t, ObjectInfo> new_objects_info) {
-  if (new_objects_info.empty()) {
-    return;
-  }
-
-  if (objects_info_.empty()) {
-    objects_info_ = std::move(new_objects_info);
-    return;
-  }
+  objects_info_.Truncate(size);
 
-  auto cur_it = objects_info_.begin();
-  auto new_it = new_objects_info.begin();
-  while (cur_it != objects_info_.end() && new_it != new_objects_info.end()) {
-    if (cur_it->first == new_it->first) {
-      if (new_it->second.type == ObjectType::kNormal &&
-          cur_it->second.type == ObjectType::kNormal &&
-          cur_it->second.is_object_stream_flag) {
-        new_it->second.is_object_stream_flag = true;
-      }
-      ++cur_it;
-      ++new_it;
-    } else if (cur_it->first < new_it->first) {
-      new_objects_info.insert(new_it, *cur_it);
-      ++cur_it;
-    } else {
-      new_it = new_objects_info.lower_bound(cur_it->first);
-    }
-  }
-  for (; cur_it != objects_info_.end(); ++cur_it) {
-    new_objects_info.insert(new_objects_info.end(), *cur_it);
-  }
-  objects_info_ = std::move(new_objects_info);
+  // Make sure there is an entry for `size - 1`. If it did not exist, then the
+  // new entry is a free object with `pos` set to 0.
+  objects_info_.FindOrCreate(size - 1);
 }
 
 void CPDF_CrossRefTable::UpdateTrailer(RetainPtr<CPDF_Dictionary> new_trailer) {
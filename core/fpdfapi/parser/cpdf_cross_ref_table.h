@@ -5,10 +5,14 @@
 #ifndef CORE_FPDFAPI_PARSER_CPDF_CROSS_REF_TABLE_H_
 #define CORE_FPDFAPI_PARSER_CPDF_CROSS_REF_TABLE_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
+#include <iterator>
 #include <map>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "core/fxcrt/fx_types.h"
 #include "core/fxcrt/retain_ptr.h"
@@ -40,6 +44,89 @@ class CPDF_CrossRefTable {
     };
   };
 
+  // Object number indexed storage for ObjectInfo entries. Most documents
+  // number their objects densely from 0, so entries live in a vector indexed
+  // by object number. Object numbers far beyond the populated range, e.g. a
+  // lone entry near CPDF_Parser::kMaxObjectNumber, go into a sparse map
+  // instead, so they do not force a huge allocation. All sparse object
+  // numbers are greater than or equal to the dense range size, so iteration
+  // visits entries in ascending object number order.
+  class ObjectInfoMap {
+   public:
+    using value_type = std::pair<uint32_t, const ObjectInfo&>;
+
+    class const_iterator {
+     public:
+      using iterator_category = std::input_iterator_tag;
+      using value_type = ObjectInfoMap::value_type;
+      using difference_type = std::ptrdiff_t;
+      using pointer = void;
+      using reference = value_type;
+
+      const_iterator(const ObjectInfoMap* map,
+                     uint32_t dense_index,
+                     std::map<uint32_t, ObjectInfo>::const_iterator sparse_it);
+
+      value_type operator*() const;
+      const_iterator& operator++();
+      bool operator==(const const_iterator& that) const {
+        return dense_index_ == that.dense_index_ &&
+               sparse_it_ == that.sparse_it_;
+      }
+      bool operator!=(const const_iterator& that) const {
+        return !(*this == that);
+      }
+
+     private:
+      void SkipAbsentDenseEntries();
+
+      const ObjectInfoMap* map_;
+      uint32_t dense_index_;
+      std::map<uint32_t, ObjectInfo>::const_iterator sparse_it_;
+    };
+
+    ObjectInfoMap();
+    ObjectInfoMap(ObjectInfoMap&& that) noexcept;
+    ObjectInfoMap& operator=(ObjectInfoMap&& that) noexcept;
+    ~ObjectInfoMap();
+
+    const_iterator begin() const;
+    const_iterator end() const;
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    // Returns the largest object number in the map. Must not be empty.
+    uint32_t GetLastObjNum() const;
+
+    const ObjectInfo* Find(uint32_t obj_num) const;
+
+    // Returns the entry for `obj_num`, default-constructing it if needed. The
+    // returned pointer is invalidated by the next mutation of the map. The
+    // bool is true if the entry was newly created.
+    std::pair<ObjectInfo*, bool> FindOrCreate(uint32_t obj_num);
+
+    // Removes all entries with object number >= `size`.
+    void Truncate(uint32_t size);
+
+    void clear();
+
+    // Merges `top` into this map, with entries from `top` taking precedence.
+    // Runs in time linear in the size of the smaller map.
+    void MergeUp(ObjectInfoMap top);
+
+   private:
+    bool IsDenseEnough(uint32_t obj_num) const;
+    void GrowDense(uint32_t new_dense_size);
+    void TrimDense();
+
+    // Indexed by object number. `dense_present_[i]` indicates whether
+    // `dense_[i]` is in the map. When non-empty, the last entry is present.
+    std::vector<ObjectInfo> dense_;
+    std::vector<bool> dense_present_;
+    std::map<uint32_t, ObjectInfo> sparse_;
+    size_t size_ = 0;
+  };
+
   // Merge cross reference tables.  Apply top on current.
   static std::unique_ptr<CPDF_CrossRefTable> MergeUp(
       std::unique_ptr<CPDF_CrossRefTable> current,
@@ -67,9 +154,7 @@ class CPDF_CrossRefTable {
 
   const ObjectInfo* GetObjectInfo(uint32_t obj_num) const;
 
-  const std::map<uint32_t, ObjectInfo>& objects_info() const {
-    return objects_info_;
-  }
+  const ObjectInfoMap& objects_info() const { return objects_info_; }
 
   void Update(std::unique_ptr<CPDF_CrossRefTable> new_cross_ref);
 
@@ -77,7 +162,6 @@ class CPDF_CrossRefTable {
   void SetObjectMapSize(uint32_t size);
 
  private:
-  void UpdateInfo(std::map<uint32_t, ObjectInfo> new_objects_info);
   void UpdateTrailer(RetainPtr<CPDF_Dictionary> new_trailer);
 
   RetainPtr<CPDF_Dictionary> trailer_;
@@ -85,7 +169,7 @@ class CPDF_CrossRefTable {
   // inline, it has no object number. Store the stream's object number, or 0 if
   // there is none.
   uint32_t trailer_object_number_ = 0;
-  std::map<uint32_t, ObjectInfo> objects_info_;
+  ObjectInfoMap objects_info_;
 };
 
 #endif  // CORE_FPDFAPI_PARSER_CPDF_CROSS_REF_TABLE_H_
@@ -0,0 +1,181 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/parser/cpdf_cross_ref_table.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "core/fpdfapi/parser/cpdf_parser.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using ObjectType = CPDF_CrossRefTable::ObjectType;
+
+namespace {
+
+std::vector<uint32_t> GetObjectNumbers(const CPDF_CrossRefTable& table) {
+  std::vector<uint32_t> result;
+  for (const auto& it : table.objects_info()) {
+    result.push_back(it.first);
+  }
+  return result;
+}
+
+}  // namespace
+
+TEST(CrossRefTableTest, Empty) {
+  CPDF_CrossRefTable table;
+  EXPECT_TRUE(table.objects_info().empty());
+  EXPECT_EQ(0u, table.objects_info().size());
+  EXPECT_FALSE(table.GetObjectInfo(0));
+  EXPECT_TRUE(table.objects_info().begin() == table.objects_info().end());
+}
+
+TEST(CrossRefTableTest, DenseAndSparseEntries) {
+  CPDF_CrossRefTable table;
+  table.AddNormal(CPDF_Parser::kMaxObjectNumber, 0, false, 300);
+  table.AddNormal(1, 0, false, 100);
+  table.AddNormal(3, 2, false, 200);
+  table.SetFree(5, 1);
+
+  EXPECT_EQ(4u, table.objects_info().size());
+  EXPECT_EQ(CPDF_Parser::kMaxObjectNumber,
+            table.objects_info().GetLastObjNum());
+  EXPECT_EQ((std::vector<uint32_t>{1, 3, 5, CPDF_Parser::kMaxObjectNumber}),
+            GetObjectNumbers(table));
+
+  EXPECT_FALSE(table.GetObjectInfo(0));
+  EXPECT_FALSE(table.GetObjectInfo(2));
+  EXPECT_FALSE(table.GetObjectInfo(6));
+
+  const CPDF_CrossRefTable::ObjectInfo* info = table.GetObjectInfo(3);
+  ASSERT_TRUE(info);
+  EXPECT_EQ(ObjectType::kNormal, info->type);
+  EXPECT_EQ(2, info->gennum);
+  EXPECT_EQ(200, info->pos);
+
+  info = table.GetObjectInfo(5);
+  ASSERT_TRUE(info);
+  EXPECT_EQ(ObjectType::kFree, info->type);
+
+  info = table.GetObjectInfo(CPDF_Parser::kMaxObjectNumber);
+  ASSERT_TRUE(info);
+  EXPECT_EQ(ObjectType::kNormal, info->type);
+  EXPECT_EQ(300, info->pos);
+}
+
+TEST(CrossRefTableTest, ManyObjects) {
+  static constexpr uint32_t kCount = 100000;
+  CPDF_CrossRefTable table;
+  // Add the last object first, the way SetObjectMapSize() does.
+  table.SetObjectMapSize(kCount);
+  for (uint32_t i = 0; i < kCount; ++i) {
+    table.AddNormal(i, 0, false, 10 * i);
+  }
+
+  EXPECT_EQ(kCount, table.objects_info().size());
+  EXPECT_EQ(kCount - 1, table.objects_info().GetLastObjNum());
+  uint32_t expected_obj_num = 0;
+  for (const auto& [obj_num, info] : table.objects_info()) {
+    ASSERT_EQ(expected_obj_num, obj_num);
+    EXPECT_EQ(10 * obj_num, info.pos);
+    ++expected_obj_num;
+  }
+  EXPECT_EQ(kCount, expected_obj_num);
+}
+
+TEST(CrossRefTableTest, SetObjectMapSize) {
+  CPDF_CrossRefTable table;
+  table.AddNormal(1, 0, false, 100);
+  table.AddNormal(2, 0, false, 200);
+  table.AddNormal(10, 0, false, 1000);
+  table.AddNormal(CPDF_Parser::kMaxObjectNumber, 0, false, 300);
+
+  table.SetObjectMapSize(8);
+  EXPECT_EQ((std::vector<uint32_t>{1, 2, 7}), GetObjectNumbers(table));
+  const CPDF_CrossRefTable::ObjectInfo* info = table.GetObjectInfo(7);
+  ASSERT_TRUE(info);
+  EXPECT_EQ(ObjectType::kFree, info->type);
+  EXPECT_EQ(0, info->pos);
+
+  table.SetObjectMapSize(3);
+  EXPECT_EQ((std::vector<uint32_t>{1, 2}), GetObjectNumbers(table));
+  EXPECT_EQ(2u, table.objects_info().GetLastObjNum());
+
+  table.SetObjectMapSize(0);
+  EXPECT_TRUE(table.objects_info().empty());
+}
+
+TEST(CrossRefTableTest, AddCompressed) {
+  CPDF_CrossRefTable table;
+  table.AddNormal(4, 0, false, 400);
+  table.AddCompressed(2, 4, 1);
+
+  const CPDF_CrossRefTable::ObjectInfo* info = table.GetObjectInfo(2);
+  ASSERT_TRUE(info);
+  EXPECT_EQ(ObjectType::kCompressed, info->type);
+  EXPECT_EQ(4u, info->archive.obj_num);
+  EXPECT_EQ(1u, info->archive.obj_index);
+
+  info = table.GetObjectInfo(4);
+  ASSERT_TRUE(info);
+  EXPECT_TRUE(info->is_object_stream_flag);
+
+  // Object streams cannot be inside other object streams.
+  table.AddCompressed(4, 2, 0);
+  info = table.GetObjectInfo(4);
+  ASSERT_TRUE(info);
+  EXPECT_EQ(ObjectType::kNormal, info->type);
+}
+
+TEST(CrossRefTableTest, MergeUp) {
+  for (bool top_is_larger : {false, true}) {
+    auto current = std::make_unique<CPDF_CrossRefTable>();
+    current->AddNormal(1, 0, false, 100);
+    current->AddNormal(2, 0, true, 200);
+    current->AddNormal(3, 0, false, 300);
+    current->AddNormal(CPDF_Parser::kMaxObjectNumber, 0, false, 400);
+
+    auto top = std::make_unique<CPDF_CrossRefTable>();
+    top->AddNormal(2, 0, false, 250);
+    top->SetFree(3, 1);
+    top->AddNormal(5, 0, false, 500);
+    if (top_is_larger) {
+      for (uint32_t i = 6; i < 20; ++i) {
+        top->AddNormal(i, 0, false, 100 * i);
+      }
+    }
+
+    auto merged =
+        CPDF_CrossRefTable::MergeUp(std::move(current), std::move(top));
+    ASSERT_TRUE(merged);
+    EXPECT_EQ(top_is_larger ? 19u : 5u, merged->objects_info().size());
+    EXPECT_EQ(CPDF_Parser::kMaxObjectNumber,
+              merged->objects_info().GetLastObjNum());
+
+    const CPDF_CrossRefTable::ObjectInfo* info = merged->GetObjectInfo(1);
+    ASSERT_TRUE(info);
+    EXPECT_EQ(100, info->pos);
+
+    // The object stream flag carries over from the older entry.
+    info = merged->GetObjectInfo(2);
+    ASSERT_TRUE(info);
+    EXPECT_EQ(250, info->pos);
+    EXPECT_TRUE(info->is_object_stream_flag);
+
+    info = merged->GetObjectInfo(3);
+    ASSERT_TRUE(info);
+    EXPECT_EQ(ObjectType::kFree, info->type);
+    EXPECT_EQ(1, info->gennum);
+
+    info = merged->GetObjectInfo(5);
+    ASSERT_TRUE(info);
+    EXPECT_EQ(500, info->pos);
+
+    info = merged->GetObjectInfo(CPDF_Parser::kMaxObjectNumber);
+    ASSERT_TRUE(info);
+    EXPECT_EQ(400, info->pos);
+  }
+}
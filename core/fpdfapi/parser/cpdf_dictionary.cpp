@@ -6,6 +6,7 @@
 
 #include "core/fpdfapi/parser/cpdf_dictionary.h"
 
+#include <algorithm>
 #include <set>
 #include <utility>
 
@@ -32,7 +33,7 @@ CPDF_Dictionary::~CPDF_Dictionary() {
   // Mark the object as deleted so that it will not be deleted again,
   // and break cyclic references.
   obj_num_ = kInvalidObjNum;
-  for (auto& it : map_) {
+  for (auto& it : entries_) {
     if (it.second->GetObjNum() == kInvalidObjNum) {
       it.second.Leak();
     }
@@ -62,17 +63,33 @@ RetainPtr<CPDF_Object> CPDF_Dictionary::CloneNonCyclic(
       std::set<const CPDF_Object*> visited(*pVisited);
       auto obj = it.second->CloneNonCyclic(bDirect, &visited);
       if (obj) {
-        pCopy->map_.insert(std::make_pair(it.first, std::move(obj)));
+        // Already in key order.
+        pCopy->entries_.emplace_back(it.first, std::move(obj));
       }
     }
   }
   return pCopy;
 }
 
+size_t CPDF_Dictionary::LowerBound(ByteStringView key) const {
+  auto it = std::lower_bound(
+      entries_.begin(), entries_.end(), key,
+      [](const Entry& entry, ByteStringView key) { return entry.first < key; });
+  return it - entries_.begin();
+}
+
+std::optional<size_t> CPDF_Dictionary::Find(ByteStringView key) const {
+  const size_t index = LowerBound(key);
+  if (index == entries_.size() || entries_[index].first != key) {
+    return std::nullopt;
+  }
+  return index;
+}
+
 const CPDF_Object* CPDF_Dictionary::GetObjectForInternal(
     ByteStringView key) const {
-  auto it = map_.find(key);
-  return it != map_.end() ? it->second.Get() : nullptr;
+  std::optional<size_t> index = Find(key);
+  return index.has_value() ? entries_[index.value()].second.Get() : nullptr;
 }
 
 RetainPtr<const CPDF_Object> CPDF_Dictionary::GetObjectFor(
@@ -257,7 +274,7 @@ CFX_Matrix CPDF_Dictionary::GetMatrixFor(ByteStringView key) const {
 }
 
 bool CPDF_Dictionary::KeyExist(ByteStringView key) const {
-  return pdfium::Contains(map_, key);
+  return Find(key).has_value();
 }
 
 std::vector<ByteString> CPDF_Dictionary::GetKeys() const {
@@ -277,55 +294,103 @@ void CPDF_Dictionary::SetFor(const ByteString& key,
 CPDF_Object* CPDF_Dictionary::SetForInternal(const ByteString& key,
                                              RetainPtr<CPDF_Object> pObj) {
   CHECK(!IsLocked());
+  const size_t index = LowerBound(key.AsStringView());
+  const bool found = index < entries_.size() && entries_[index].first == key;
   if (!pObj) {
-    map_.erase(key);
+    if (found) {
+      entries_.erase(entries_.begin() + index);
+    }
     return nullptr;
   }
   CHECK(pObj->IsInline());
   CHECK(!pObj->IsStream());
   CPDF_Object* pRet = pObj.Get();
-  map_[MaybeIntern(key)] = std::move(pObj);
+  if (found) {
+    entries_[index].second = std::move(pObj);
+  } else {
+    entries_.emplace(entries_.begin() + index, MaybeIntern(key),
+                     std::move(pObj));
+  }
   return pRet;
 }
 
+void CPDF_Dictionary::SetEntries(std::vector<Entry> entries) {
+  CHECK(!IsLocked());
+  if (!entries_.empty()) {
+    for (Entry& entry : entries) {
+      CHECK(entry.second);
+      SetForInternal(entry.first, std::move(entry.second));
+    }
+    return;
+  }
+
+  for (Entry& entry : entries) {
+    CHECK(entry.second);
+    CHECK(entry.second->IsInline());
+    CHECK(!entry.second->IsStream());
+    entry.first = MaybeIntern(entry.first);
+  }
+  std::stable_sort(
+      entries.begin(), entries.end(),
+      [](const Entry& a, const Entry& b) { return a.first < b.first; });
+
+  // Keeps the last of the entries with the same key, like SetFor() would.
+  size_t unique_count = 0;
+  for (Entry& entry : entries) {
+    if (unique_count > 0 && entries[unique_count - 1].first == entry.first) {
+      entries[unique_count - 1].second = std::move(entry.second);
+      continue;
+    }
+    if (&entries[unique_count] != &entry) {
+      entries[unique_count] = std::move(entry);
+    }
+    ++unique_count;
+  }
+  entries.erase(entries.begin() + unique_count, entries.end());
+  entries_ = std::move(entries);
+}
+
 void CPDF_Dictionary::ConvertToIndirectObjectFor(
     const ByteString& key,
     CPDF_IndirectObjectHolder* pHolder) {
   CHECK(!IsLocked());
-  auto it = map_.find(key);
-  if (it == map_.end() || it->second->IsReference()) {
+  std::optional<size_t> index = Find(key.AsStringView());
+  if (!index.has_value()) {
     return;
   }
 
-  pHolder->AddIndirectObject(it->second);
-  it->second = it->second->MakeReference(pHolder);
+  RetainPtr<CPDF_Object>& object = entries_[index.value()].second;
+  if (object->IsReference()) {
+    return;
+  }
+
+  pHolder->AddIndirectObject(object);
+  object = object->MakeReference(pHolder);
 }
 
 RetainPtr<CPDF_Object> CPDF_Dictionary::RemoveFor(ByteStringView key) {
   CHECK(!IsLocked());
-  auto it = map_.find(key);
-  if (it == map_.end()) {
+  std::optional<size_t> index = Find(key);
+  if (!index.has_value()) {
     return RetainPtr<CPDF_Object>();
   }
-  auto node = map_.extract(it);
-  return std::move(node.mapped());
+  RetainPtr<CPDF_Object> object = std::move(entries_[index.value()].second);
+  entries_.erase(entries_.begin() + index.value());
+  return object;
 }
 
 void CPDF_Dictionary::ReplaceKey(const ByteString& oldkey,
                                  const ByteString& newkey) {
   CHECK(!IsLocked());
-  auto old_it = map_.find(oldkey);
-  if (old_it == map_.end()) {
-    return;
-  }
-
-  auto new_it = map_.find(newkey);
-  if (new_it == old_it) {
+  std::optional<size_t> old_index = Find(oldkey.AsStringView());
+  if (!old_index.has_value() || oldkey == newkey) {
     return;
   }
 
-  map_[MaybeIntern(newkey)] = std::move(old_it->second);
-  map_.erase(old_it);
+  RetainPtr<CPDF_Object> object =
+      std::move(entries_[old_index.value()].second);
+  entries_.erase(entries_.begin() + old_index.value());
+  SetForInternal(newkey, std::move(object));
 }
 
 void CPDF_Dictionary::SetRectFor(const ByteString& key,
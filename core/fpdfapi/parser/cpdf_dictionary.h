@@ -7,8 +7,7 @@
 #ifndef CORE_FPDFAPI_PARSER_CPDF_DICTIONARY_H_
 #define CORE_FPDFAPI_PARSER_CPDF_DICTIONARY_H_
 
-#include <functional>
-#include <map>
+#include <optional>
 #include <set>
 #include <type_traits>
 #include <utility>
@@ -28,8 +27,8 @@ class CPDF_IndirectObjectHolder;
 // will return nullptr to indicate non-existent keys.
 class CPDF_Dictionary final : public CPDF_Object {
  public:
-  using DictMap = std::map<ByteString, RetainPtr<CPDF_Object>, std::less<>>;
-  using const_iterator = DictMap::const_iterator;
+  using Entry = std::pair<ByteString, RetainPtr<CPDF_Object>>;
+  using const_iterator = std::vector<Entry>::const_iterator;
 
   CONSTRUCT_VIA_MAKE_RETAIN;
 
@@ -42,7 +41,7 @@ class CPDF_Dictionary final : public CPDF_Object {
 
   bool IsLocked() const { return !!lock_count_; }
 
-  size_t size() const { return map_.size(); }
+  size_t size() const { return entries_.size(); }
   RetainPtr<const CPDF_Object> GetObjectFor(ByteStringView key) const;
   RetainPtr<CPDF_Object> GetMutableObjectFor(ByteStringView key);
 
@@ -83,10 +82,9 @@ class CPDF_Dictionary final : public CPDF_Object {
   std::vector<ByteString> GetKeys() const;
 
   // Creates a new object owned by the dictionary and returns an unowned
-  // pointer to it. Invalidates iterators for the element with the key |key|.
-  // Prefer using these templates over calls to SetFor(), since by creating
-  // a new object with no previous references, they ensure cycles can not be
-  // introduced.
+  // pointer to it. Invalidates iterators. Prefer using these templates over
+  // calls to SetFor(), since by creating a new object with no previous
+  // references, they ensure cycles can not be introduced.
   template <typename T, typename... Args>
     requires(!CanInternStrings<T>::value)
   RetainPtr<T> SetNewFor(const ByteString& key, Args&&... args) {
@@ -103,13 +101,18 @@ class CPDF_Dictionary final : public CPDF_Object {
         key, pdfium::MakeRetain<T>(pool_, std::forward<Args>(args)...))));
   }
 
-  // If `object` is null, then `key` is erased from the map. Otherwise, takes
-  // ownership of `object` and stores in in the map. Invalidates iterators for
-  // the element with the key `key`.
+  // If `object` is null, then `key` is erased from the dictionary. Otherwise,
+  // takes ownership of `object` and stores it in the dictionary. Invalidates
+  // iterators.
   void SetFor(const ByteString& key, RetainPtr<CPDF_Object> object);
   // A stream must be indirect and added as a `CPDF_Reference` instead.
   void SetFor(const ByteString& key, RetainPtr<CPDF_Stream> stream) = delete;
 
+  // Same as calling SetFor() for each of `entries` in order, but only sorts
+  // them once, so building a large dictionary does not take quadratic time.
+  // None of the objects may be null.
+  void SetEntries(std::vector<Entry> entries);
+
   // Convenience functions to convert native objects to array form.
   void SetRectFor(const ByteString& key, const CFX_FloatRect& rect);
   void SetMatrixFor(const ByteString& key, const CFX_Matrix& matrix);
@@ -117,10 +120,10 @@ class CPDF_Dictionary final : public CPDF_Object {
   void ConvertToIndirectObjectFor(const ByteString& key,
                                   CPDF_IndirectObjectHolder* pHolder);
 
-  // Invalidates iterators for the element with the key |key|.
+  // Invalidates iterators.
   RetainPtr<CPDF_Object> RemoveFor(ByteStringView key);
 
-  // Invalidates iterators for the element with the key |oldkey|.
+  // Invalidates iterators.
   void ReplaceKey(const ByteString& oldkey, const ByteString& newkey);
 
   WeakPtr<ByteStringPool> GetByteStringPool() const { return pool_; }
@@ -132,6 +135,11 @@ class CPDF_Dictionary final : public CPDF_Object {
   explicit CPDF_Dictionary(const WeakPtr<ByteStringPool>& pPool);
   ~CPDF_Dictionary() override;
 
+  // Returns the index of the first entry with a key not less than `key`.
+  size_t LowerBound(ByteStringView key) const;
+  // Returns the index of the entry for `key`, if any.
+  std::optional<size_t> Find(ByteStringView key) const;
+
   // No guarantees about result lifetime, use with caution.
   const CPDF_Object* GetObjectForInternal(ByteStringView key) const;
   const CPDF_Object* GetDirectObjectForInternal(ByteStringView key) const;
@@ -151,7 +159,10 @@ class CPDF_Dictionary final : public CPDF_Object {
 
   mutable uint32_t lock_count_ = 0;
   WeakPtr<ByteStringPool> pool_;
-  DictMap map_;
+  // Sorted by key, without duplicate keys. Most dictionaries only have a
+  // handful of entries, so a flat vector takes a single allocation and keeps
+  // lookups within a few cache lines.
+  std::vector<Entry> entries_;
 };
 
 class CPDF_DictionaryLocker {
@@ -166,11 +177,11 @@ class CPDF_DictionaryLocker {
 
   const_iterator begin() const {
     CHECK(dict_->IsLocked());
-    return dict_->map_.begin();
+    return dict_->entries_.begin();
   }
   const_iterator end() const {
     CHECK(dict_->IsLocked());
-    return dict_->map_.end();
+    return dict_->entries_.end();
   }
 
  private:
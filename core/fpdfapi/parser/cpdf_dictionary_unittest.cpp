@@ -4,10 +4,13 @@
 
 #include "core/fpdfapi/parser/cpdf_dictionary.h"
 
+#include <algorithm>
 #include <utility>
+#include <vector>
 
 #include "core/fpdfapi/parser/cpdf_array.h"
 #include "core/fpdfapi/parser/cpdf_number.h"
+#include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 TEST(DictionaryTest, Iterators) {
@@ -35,3 +38,63 @@ TEST(DictionaryTest, Iterators) {
   ++it;
   EXPECT_EQ(it, locked_dict.end());
 }
+
+TEST(DictionaryTest, KeepsKeysSorted) {
+  auto dict = pdfium::MakeRetain<CPDF_Dictionary>();
+  for (const char* key : {"M", "B", "Z", "A", "Q", "B"}) {
+    dict->SetNewFor<CPDF_Number>(key, key[0]);
+  }
+  EXPECT_EQ(5u, dict->size());
+  EXPECT_THAT(dict->GetKeys(), testing::ElementsAre("A", "B", "M", "Q", "Z"));
+  for (const char* key : {"A", "B", "M", "Q", "Z"}) {
+    EXPECT_EQ(key[0], dict->GetIntegerFor(key));
+  }
+  EXPECT_FALSE(dict->KeyExist("C"));
+  EXPECT_FALSE(dict->KeyExist("ZZ"));
+  EXPECT_FALSE(dict->KeyExist(""));
+
+  EXPECT_TRUE(dict->RemoveFor("M"));
+  EXPECT_FALSE(dict->RemoveFor("M"));
+  dict->SetFor("Q", RetainPtr<CPDF_Object>());
+  dict->ReplaceKey("A", "Y");
+  EXPECT_THAT(dict->GetKeys(), testing::ElementsAre("B", "Y", "Z"));
+  EXPECT_EQ('A', dict->GetIntegerFor("Y"));
+
+  // Replacing a key overwrites any existing entry for the new key.
+  dict->ReplaceKey("Y", "Z");
+  EXPECT_THAT(dict->GetKeys(), testing::ElementsAre("B", "Z"));
+  EXPECT_EQ('A', dict->GetIntegerFor("Z"));
+}
+
+TEST(DictionaryTest, SetEntries) {
+  std::vector<CPDF_Dictionary::Entry> entries;
+  for (int i = 0; i < 1000; ++i) {
+    entries.emplace_back(ByteString::FormatInteger((i * 7) % 1000),
+                         pdfium::MakeRetain<CPDF_Number>(i));
+  }
+  // Later entries win, like they do with SetFor().
+  entries.emplace_back("7", pdfium::MakeRetain<CPDF_Number>(-1));
+
+  auto dict = pdfium::MakeRetain<CPDF_Dictionary>();
+  dict->SetEntries(std::move(entries));
+  EXPECT_EQ(1000u, dict->size());
+  EXPECT_EQ(-1, dict->GetIntegerFor("7"));
+  EXPECT_EQ(143, dict->GetIntegerFor("1"));
+  {
+    CPDF_DictionaryLocker locked_dict(dict);
+    EXPECT_TRUE(std::is_sorted(
+        locked_dict.begin(), locked_dict.end(),
+        [](const CPDF_Dictionary::Entry& a, const CPDF_Dictionary::Entry& b) {
+          return a.first < b.first;
+        }));
+  }
+
+  // Adds to a non-empty dictionary too.
+  std::vector<CPDF_Dictionary::Entry> more_entries;
+  more_entries.emplace_back("1", pdfium::MakeRetain<CPDF_Number>(-2));
+  more_entries.emplace_back("new", pdfium::MakeRetain<CPDF_Number>(-3));
+  dict->SetEntries(std::move(more_entries));
+  EXPECT_EQ(1001u, dict->size());
+  EXPECT_EQ(-2, dict->GetIntegerFor("1"));
+  EXPECT_EQ(-3, dict->GetIntegerFor("new"));
+}
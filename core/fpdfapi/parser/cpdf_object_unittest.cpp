@@ -945,6 +945,27 @@ TEST(PDFStreamTest, LengthInDictionaryOnCreate) {
   }
 }
 
+TEST(PDFStreamTest, DataId) {
+  auto stream = pdfium::MakeRetain<CPDF_Stream>(
+      DataVector<uint8_t>(100), pdfium::MakeRetain<CPDF_Dictionary>());
+  auto other_stream = pdfium::MakeRetain<CPDF_Stream>(
+      DataVector<uint8_t>(100), pdfium::MakeRetain<CPDF_Dictionary>());
+  const uint64_t data_id = stream->GetDataId();
+  EXPECT_NE(data_id, other_stream->GetDataId());
+
+  // Changing the dictionary does not change the data.
+  stream->GetMutableDict()->SetNewFor<CPDF_Name>("Type", "XObject");
+  EXPECT_EQ(data_id, stream->GetDataId());
+
+  // Replacing the data does, even with the same bytes.
+  stream->SetData(DataVector<uint8_t>(100));
+  EXPECT_NE(data_id, stream->GetDataId());
+
+  // Clones have data of their own.
+  RetainPtr<CPDF_Object> clone = stream->Clone();
+  EXPECT_NE(stream->GetDataId(), clone->AsStream()->GetDataId());
+}
+
 TEST(PDFDictionaryTest, CloneDirectObject) {
   CPDF_IndirectObjectHolder objects_holder;
   auto dict = pdfium::MakeRetain<CPDF_Dictionary>();
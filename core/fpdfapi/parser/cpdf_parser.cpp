@@ -178,7 +178,7 @@ CPDF_Parser::~CPDF_Parser() = default;
 uint32_t CPDF_Parser::GetLastObjNum() const {
   return cross_ref_table_->objects_info().empty()
              ? 0
-             : cross_ref_table_->objects_info().rbegin()->first;
+             : cross_ref_table_->objects_info().GetLastObjNum();
 }
 
 bool CPDF_Parser::IsValidObjectNumber(uint32_t objnum) const {
@@ -0,0 +1,208 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdint.h>
+
+#include <functional>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/fpdfapi/parser/cpdf_dictionary.h"
+#include "core/fpdfapi/parser/cpdf_document.h"
+#include "core/fxcrt/bytestring.h"
+#include "core/fxcrt/retain_ptr.h"
+#include "public/cpp/fpdf_scopers.h"
+#include "public/fpdfview.h"
+#include "testing/embedder_test.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf_timer.h"
+
+namespace {
+
+constexpr uint32_t kObjectCount = 1000000;
+constexpr uint32_t kDictionaryCount = 100000;
+
+// Keys of the dictionaries that MakeDictionaryBody() returns.
+constexpr const char* kDictionaryKeys[] = {
+    "A", "BS", "Border", "C", "CA", "Contents", "F", "H", "M", "NM", "Open",
+    "P", "Q", "Rect", "StructParent", "Subtype", "Type"};
+
+// Keys that the dictionaries do not have.
+constexpr const char* kMissingKeys[] = {"AP", "Parent", "Z"};
+
+CPDF_Document* GetCPDFDocument(FPDF_DOCUMENT document) {
+  // This is cheating slightly to avoid a layering violation, since this file
+  // cannot include fpdfsdk/cpdfsdk_helpers.h to get access to
+  // CPDFDocumentFromFPDFDocument().
+  return reinterpret_cast<CPDF_Document*>((document));
+}
+
+ByteString MakeSmallBody(uint32_t obj_num) {
+  return ByteString::Format("<< /Value %u >>", obj_num);
+}
+
+// Returns a link annotation dictionary with the `kDictionaryKeys`, in an order
+// that is not sorted by key.
+ByteString MakeDictionaryBody(uint32_t obj_num) {
+  return ByteString::Format(
+      "<< /Type /Annot /Subtype /Link /Rect [%u 0 %u 10] /Border [0 0 1] "
+      "/F 4 /P 3 0 R /NM (link%u) /M (D:20250101000000) /C [1 0 0] /H /I "
+      "/A << /S /URI /URI (https://example.com/%u) >> /StructParent %u "
+      "/Contents (Link %u) /BS << /W 1 /S /S >> /Q 0 /CA 1 /Open false >>",
+      obj_num, obj_num + 10, obj_num, obj_num, obj_num, obj_num);
+}
+
+void AppendObject(uint32_t obj_num, const ByteString& body, std::string& pdf) {
+  pdf += ByteString::Format("%u 0 obj\n%s\nendobj\n", obj_num, body.c_str())
+             .c_str();
+}
+
+// Appends a cross-reference section with a single subsection for
+// `offsets.size()` objects starting at `first_obj_num`, and a trailer. Returns
+// the section's offset.
+size_t AppendCrossRefSection(uint32_t first_obj_num,
+                             const std::vector<size_t>& offsets,
+                             uint32_t size,
+                             size_t prev_offset,
+                             std::string& pdf) {
+  const size_t offset = pdf.size();
+  pdf += ByteString::Format("xref\n%u %zu\n", first_obj_num, offsets.size())
+             .c_str();
+  for (size_t entry_offset : offsets) {
+    if (entry_offset) {
+      pdf += ByteString::Format("%010zu 00000 n\r\n", entry_offset).c_str();
+    } else {
+      pdf += "0000000000 65535 f\r\n";
+    }
+  }
+  pdf += ByteString::Format("trailer\n<< /Size %u /Root 1 0 R", size).c_str();
+  if (prev_offset) {
+    pdf += ByteString::Format(" /Prev %zu", prev_offset).c_str();
+  }
+  pdf += ByteString::Format(" >>\nstartxref\n%zu\n%%%%EOF\n", offset).c_str();
+  return offset;
+}
+
+// Builds a one page document with `object_count` objects. Objects from number
+// 4 on have the bodies that `make_body` returns. The document is followed by
+// `update_count` incremental updates, each of which redefines a different
+// range of objects.
+std::string MakeDocument(uint32_t object_count,
+                         const std::function<ByteString(uint32_t)>& make_body,
+                         uint32_t update_count) {
+  std::string pdf = "%PDF-1.7\n";
+  std::vector<size_t> offsets(object_count, 0);
+  offsets[1] = pdf.size();
+  AppendObject(1, "<< /Type /Catalog /Pages 2 0 R >>", pdf);
+  offsets[2] = pdf.size();
+  AppendObject(2, "<< /Type /Pages /Kids [3 0 R] /Count 1 >>", pdf);
+  offsets[3] = pdf.size();
+  AppendObject(3, "<< /Type /Page /Parent 2 0 R /MediaBox [0 0 100 100] >>",
+               pdf);
+  for (uint32_t i = 4; i < object_count; ++i) {
+    offsets[i] = pdf.size();
+    AppendObject(i, make_body(i), pdf);
+  }
+  size_t xref_offset = AppendCrossRefSection(0, offsets, object_count, 0, pdf);
+
+  const uint32_t update_size = object_count / (update_count + 1);
+  for (uint32_t update = 1; update <= update_count; ++update) {
+    const uint32_t first_obj_num = update * update_size;
+    std::vector<size_t> update_offsets(update_size);
+    for (uint32_t i = 0; i < update_size; ++i) {
+      update_offsets[i] = pdf.size();
+      AppendObject(first_obj_num + i,
+                   ByteString::Format("<< /Update %u >>", update), pdf);
+    }
+    xref_offset = AppendCrossRefSection(first_obj_num, update_offsets,
+                                        object_count, xref_offset, pdf);
+  }
+  return pdf;
+}
+
+void MeasureLoad(const std::string& pdf) {
+  pdfium::MeasureBestTimeMs("load", pdfium::kDefaultPerfRuns, [&pdf] {
+    ScopedFPDFDocument doc(
+        FPDF_LoadMemDocument64(pdf.data(), pdf.size(), nullptr));
+    ASSERT_TRUE(doc);
+    EXPECT_EQ(1, FPDF_GetPageCount(doc.get()));
+  });
+}
+
+// Parses all the dictionaries in a document from MakeDocument() with
+// MakeDictionaryBody().
+std::vector<RetainPtr<const CPDF_Dictionary>> ParseDictionaries(
+    CPDF_Document* doc) {
+  std::vector<RetainPtr<const CPDF_Dictionary>> dicts;
+  dicts.reserve(kDictionaryCount);
+  for (uint32_t i = 4; i < kDictionaryCount; ++i) {
+    RetainPtr<const CPDF_Dictionary> dict =
+        ToDictionary(doc->GetOrParseIndirectObject(i));
+    if (dict) {
+      dicts.push_back(std::move(dict));
+    }
+  }
+  return dicts;
+}
+
+}  // namespace
+
+class CPDFParserPerfTest : public EmbedderTest {};
+
+TEST_F(CPDFParserPerfTest, Load1MObjects) {
+  MeasureLoad(MakeDocument(kObjectCount, MakeSmallBody, /*update_count=*/0));
+}
+
+TEST_F(CPDFParserPerfTest, Load1MObjectsWithUpdates) {
+  MeasureLoad(MakeDocument(kObjectCount, MakeSmallBody, /*update_count=*/9));
+}
+
+TEST_F(CPDFParserPerfTest, ParseDictionaries) {
+  const std::string pdf =
+      MakeDocument(kDictionaryCount, MakeDictionaryBody, /*update_count=*/0);
+  pdfium::MeasureBestTimeMs("load_and_parse", pdfium::kDefaultPerfRuns, [&pdf] {
+    ScopedFPDFDocument doc(
+        FPDF_LoadMemDocument64(pdf.data(), pdf.size(), nullptr));
+    ASSERT_TRUE(doc);
+    EXPECT_EQ(kDictionaryCount - 4,
+              ParseDictionaries(GetCPDFDocument(doc.get())).size());
+  });
+}
+
+TEST_F(CPDFParserPerfTest, LookUpAndIterateDictionaries) {
+  const std::string pdf =
+      MakeDocument(kDictionaryCount, MakeDictionaryBody, /*update_count=*/0);
+  ScopedFPDFDocument doc(
+      FPDF_LoadMemDocument64(pdf.data(), pdf.size(), nullptr));
+  ASSERT_TRUE(doc);
+  const std::vector<RetainPtr<const CPDF_Dictionary>> dicts =
+      ParseDictionaries(GetCPDFDocument(doc.get()));
+  ASSERT_EQ(kDictionaryCount - 4, dicts.size());
+
+  pdfium::MeasureBestTimeMs("look_up", pdfium::kDefaultPerfRuns, [&dicts] {
+    size_t found = 0;
+    for (const auto& dict : dicts) {
+      for (const char* key : kDictionaryKeys) {
+        found += !!dict->GetObjectFor(key);
+      }
+      for (const char* key : kMissingKeys) {
+        found += !!dict->GetObjectFor(key);
+      }
+    }
+    EXPECT_EQ(dicts.size() * std::size(kDictionaryKeys), found);
+  });
+
+  pdfium::MeasureBestTimeMs("iterate", pdfium::kDefaultPerfRuns, [&dicts] {
+    size_t entries = 0;
+    for (const auto& dict : dicts) {
+      CPDF_DictionaryLocker locker(dict);
+      for (const auto& it : locker) {
+        entries += !!it.second;
+      }
+    }
+    EXPECT_EQ(dicts.size() * std::size(kDictionaryKeys), entries);
+  });
+}
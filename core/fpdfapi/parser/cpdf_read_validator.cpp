@@ -87,6 +87,19 @@ FX_FILESIZE CPDF_ReadValidator::GetSize() {
   return file_size_;
 }
 
+pdfium::span<const uint8_t> CPDF_ReadValidator::GetInMemorySpan() {
+  pdfium::span<const uint8_t> span = file_read_->GetInMemorySpan();
+  if (span.empty() || span.size() != static_cast<uint64_t>(file_size_) ||
+      !IsWholeFileAvailable()) {
+    return {};
+  }
+  return span;
+}
+
+RetainPtr<IFX_SeekableReadStream> CPDF_ReadValidator::GetInMemoryFile() {
+  return GetInMemorySpan().empty() ? nullptr : file_read_;
+}
+
 void CPDF_ReadValidator::ScheduleDownload(FX_FILESIZE offset, size_t size) {
   has_unavailable_data_ = true;
   if (!hints_ || size == 0) {
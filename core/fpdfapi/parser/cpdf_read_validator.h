@@ -44,10 +44,16 @@ class CPDF_ReadValidator : public IFX_SeekableReadStream {
   bool CheckDataRangeAndRequestIfUnavailable(FX_FILESIZE offset, size_t size);
   bool CheckWholeFileAndRequestIfUnavailable();
 
+  // Returns the underlying stream when GetInMemorySpan() is non-empty, so
+  // callers can keep that memory alive without holding onto `this`.
+  RetainPtr<IFX_SeekableReadStream> GetInMemoryFile();
+
   // IFX_SeekableReadStream overrides:
   bool ReadBlockAtOffset(pdfium::span<uint8_t> buffer,
                          FX_FILESIZE offset) override;
   FX_FILESIZE GetSize() override;
+  // Only exposes the underlying span once the whole file is available.
+  pdfium::span<const uint8_t> GetInMemorySpan() override;
 
  protected:
   CPDF_ReadValidator(RetainPtr<IFX_SeekableReadStream> file_read,
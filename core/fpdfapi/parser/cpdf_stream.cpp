@@ -8,6 +8,7 @@
 
 #include <stdint.h>
 
+#include <atomic>
 #include <sstream>
 #include <utility>
 #include <variant>
@@ -36,6 +37,11 @@ bool IsMetaDataStreamDictionary(const CPDF_Dictionary* dict) {
          dict->GetNameFor("Subtype") == "XML";
 }
 
+uint64_t NextDataId() {
+  static std::atomic<uint64_t> next_data_id = 1;
+  return next_data_id++;
+}
+
 }  // namespace
 
 CPDF_Stream::CPDF_Stream(RetainPtr<CPDF_Dictionary> dict)
@@ -53,7 +59,7 @@ CPDF_Stream::CPDF_Stream(fxcrt::ostringstream* stream)
 
 CPDF_Stream::CPDF_Stream(RetainPtr<IFX_SeekableReadStream> file,
                          RetainPtr<CPDF_Dictionary> dict)
-    : data_(std::move(file)), dict_(std::move(dict)) {
+    : data_(std::move(file)), data_id_(NextDataId()), dict_(std::move(dict)) {
   CHECK(dict_->IsInline());
   SetLengthInDict(pdfium::checked_cast<int>(
       std::get<RetainPtr<IFX_SeekableReadStream>>(data_)->GetSize()));
@@ -61,7 +67,7 @@ CPDF_Stream::CPDF_Stream(RetainPtr<IFX_SeekableReadStream> file,
 
 CPDF_Stream::CPDF_Stream(DataVector<uint8_t> data,
                          RetainPtr<CPDF_Dictionary> dict)
-    : data_(std::move(data)), dict_(std::move(dict)) {
+    : data_(std::move(data)), data_id_(NextDataId()), dict_(std::move(dict)) {
   CHECK(dict_->IsInline());
   SetLengthInDict(
       pdfium::checked_cast<int>(std::get<DataVector<uint8_t>>(data_).size()));
@@ -89,6 +95,7 @@ CPDF_Stream* CPDF_Stream::AsMutableStream() {
 void CPDF_Stream::InitStreamFromFile(RetainPtr<IFX_SeekableReadStream> file) {
   const int size = pdfium::checked_cast<int>(file->GetSize());
   data_ = std::move(file);
+  data_id_ = NextDataId();
   dict_ = pdfium::MakeRetain<CPDF_Dictionary>();
   SetLengthInDict(size);
 }
@@ -138,6 +145,7 @@ void CPDF_Stream::SetData(pdfium::span<const uint8_t> pData) {
 void CPDF_Stream::TakeData(DataVector<uint8_t> data) {
   const int size = pdfium::checked_cast<int>(data.size());
   data_ = std::move(data);
+  data_id_ = NextDataId();
   SetLengthInDict(size);
 }
 
@@ -164,6 +172,11 @@ DataVector<uint8_t> CPDF_Stream::ReadAllRawData() const {
   return result;
 }
 
+pdfium::span<const uint8_t> CPDF_Stream::GetInMemoryFileRawData() const {
+  CHECK(IsFileBased());
+  return std::get<RetainPtr<IFX_SeekableReadStream>>(data_)->GetInMemorySpan();
+}
+
 bool CPDF_Stream::HasFilter() const {
   return dict_->KeyExist("Filter");
 }
@@ -56,6 +56,11 @@ class CPDF_Stream final : public CPDF_Object {
   // Can only be called when a stream is not memory-based.
   DataVector<uint8_t> ReadAllRawData() const;
 
+  // Can only be called when a stream is not memory-based. Returns the raw data
+  // in place when the underlying file is resident in memory, e.g. because it
+  // is memory-mapped. Otherwise returns an empty span.
+  pdfium::span<const uint8_t> GetInMemoryFileRawData() const;
+
   bool IsFileBased() const {
     return std::holds_alternative<RetainPtr<IFX_SeekableReadStream>>(data_);
   }
@@ -64,6 +69,10 @@ class CPDF_Stream final : public CPDF_Object {
   }
   bool HasFilter() const;
 
+  // Identifies the stream's current data. Differs between streams, and changes
+  // whenever the data gets replaced.
+  uint64_t GetDataId() const { return data_id_; }
+
  private:
   friend class CPDF_Dictionary;
 
@@ -94,6 +103,7 @@ class CPDF_Stream final : public CPDF_Object {
   void SetLengthInDict(int length);
 
   std::variant<RetainPtr<IFX_SeekableReadStream>, DataVector<uint8_t>> data_;
+  uint64_t data_id_ = 0;
   RetainPtr<CPDF_Dictionary> dict_;
 };
 
@@ -10,13 +10,51 @@
 #include <variant>
 
 #include "core/fdrm/fx_crypt.h"
+#include "core/fpdfapi/parser/cpdf_boolean.h"
 #include "core/fpdfapi/parser/cpdf_dictionary.h"
+#include "core/fpdfapi/parser/cpdf_name.h"
+#include "core/fpdfapi/parser/cpdf_number.h"
 #include "core/fpdfapi/parser/cpdf_stream.h"
 #include "core/fpdfapi/parser/fpdf_parser_decode.h"
 #include "core/fxcrt/check_op.h"
 #include "core/fxcrt/compiler_specific.h"
 #include "core/fxcrt/data_vector.h"
 
+namespace {
+
+// Returns a copy of `params` that shares nothing with the document, or nullptr
+// if `params` holds anything other than direct numbers, booleans and names.
+RetainPtr<const CPDF_Dictionary> CopyDecodeParams(
+    const CPDF_Dictionary* params) {
+  if (!params) {
+    return nullptr;
+  }
+
+  auto copy = pdfium::MakeRetain<CPDF_Dictionary>();
+  CPDF_DictionaryLocker locker(params);
+  for (const auto& it : locker) {
+    ByteString key(it.first.AsStringView());
+    const CPDF_Object* value = it.second.Get();
+    if (const CPDF_Number* number = value->AsNumber()) {
+      if (number->IsInteger()) {
+        copy->SetNewFor<CPDF_Number>(key, number->GetInteger());
+      } else {
+        copy->SetNewFor<CPDF_Number>(key, number->GetNumber());
+      }
+    } else if (const CPDF_Boolean* boolean = value->AsBoolean()) {
+      copy->SetNewFor<CPDF_Boolean>(key, boolean->GetInteger() != 0);
+    } else if (const CPDF_Name* name = value->AsName()) {
+      copy->SetNewFor<CPDF_Name>(
+          key, ByteString(name->GetString().AsStringView()));
+    } else {
+      return nullptr;
+    }
+  }
+  return copy;
+}
+
+}  // namespace
+
 CPDF_StreamAcc::CPDF_StreamAcc(RetainPtr<const CPDF_Stream> pStream)
     : stream_(std::move(pStream)) {}
 
@@ -82,7 +120,9 @@ pdfium::span<const uint8_t> CPDF_StreamAcc::GetSpan() const {
   if (stream_ && stream_->IsMemoryBased()) {
     return stream_->GetInMemoryRawData();
   }
-  return {};
+  // Either empty, or spans over a file-based stream's in-memory data, which
+  // `stream_` keeps alive.
+  return std::get<pdfium::raw_span<const uint8_t>>(data_);
 }
 
 uint64_t CPDF_StreamAcc::KeyForCache() const {
@@ -113,6 +153,12 @@ void CPDF_StreamAcc::ProcessRawData() {
     return;
   }
 
+  pdfium::span<const uint8_t> file_span = stream_->GetInMemoryFileRawData();
+  if (!file_span.empty()) {
+    data_ = file_span;
+    return;
+  }
+
   DataVector<uint8_t> data = ReadRawStream();
   if (data.empty()) {
     return;
@@ -128,19 +174,14 @@ void CPDF_StreamAcc::ProcessFilteredData(uint32_t estimated_size,
     return;
   }
 
-  std::variant<pdfium::raw_span<const uint8_t>, DataVector<uint8_t>> src_data;
-  pdfium::span<const uint8_t> src_span;
-  if (stream_->IsMemoryBased()) {
-    src_span = stream_->GetInMemoryRawData();
-    src_data = src_span;
-  } else {
-    DataVector<uint8_t> temp_src_data = ReadRawStream();
-    if (temp_src_data.empty()) {
-      return;
-    }
-
-    src_span = pdfium::span(temp_src_data);
-    src_data = std::move(temp_src_data);
+  std::variant<pdfium::raw_span<const uint8_t>, DataVector<uint8_t>> src_data =
+      GetFilteredSource();
+  pdfium::span<const uint8_t> src_span =
+      std::holds_alternative<DataVector<uint8_t>>(src_data)
+          ? pdfium::span<const uint8_t>(std::get<DataVector<uint8_t>>(src_data))
+          : std::get<pdfium::raw_span<const uint8_t>>(src_data);
+  if (src_span.empty()) {
+    return;
   }
 
   std::optional<DecoderArray> decoder_array =
@@ -168,6 +209,78 @@ void CPDF_StreamAcc::ProcessFilteredData(uint32_t estimated_size,
   data_ = std::move(result.value().data);
 }
 
+void CPDF_StreamAcc::PrepareFilteredDecode() {
+  if (!stream_ || !stream_->HasFilter() || stream_->GetRawSize() == 0) {
+    LoadAllDataFiltered();
+    return;
+  }
+
+  std::optional<DecoderArray> decoder_array =
+      GetDecoderArray(stream_->GetDict());
+  if (!decoder_array.has_value() || decoder_array.value().empty()) {
+    LoadAllDataFiltered();
+    return;
+  }
+
+  // Names and objects from the document share reference counts, and maybe
+  // string buffers, with other objects. So give the filters their own copies.
+  DecoderArray decoders;
+  for (const auto& decoder : decoder_array.value()) {
+    RetainPtr<const CPDF_Object> params;
+    if (decoder.second) {
+      params = CopyDecodeParams(decoder.second->AsDictionary());
+      if (!params) {
+        LoadAllDataFiltered();
+        return;
+      }
+    }
+    decoders.emplace_back(ByteString(decoder.first.AsStringView()),
+                          std::move(params));
+  }
+
+  data_ = GetFilteredSource();
+  pending_decoders_ = std::move(decoders);
+}
+
+void CPDF_StreamAcc::DecodePrepared() {
+  if (!pending_decoders_.has_value()) {
+    return;
+  }
+
+  const DecoderArray decoders = std::move(pending_decoders_.value());
+  pending_decoders_.reset();
+  pdfium::span<const uint8_t> src_span = GetSpan();
+  if (src_span.empty()) {
+    return;
+  }
+
+  std::optional<PDFDataDecodeResult> result =
+      PDF_DataDecode(src_span, /*estimated_size=*/0, /*bImageAcc=*/false,
+                     decoders);
+  if (!result.has_value()) {
+    return;
+  }
+
+  image_decoder_ = std::move(result.value().image_encoding);
+  image_param_ = std::move(result.value().image_params);
+  if (!result.value().data.empty()) {
+    data_ = std::move(result.value().data);
+  }
+}
+
+std::variant<pdfium::raw_span<const uint8_t>, DataVector<uint8_t>>
+CPDF_StreamAcc::GetFilteredSource() const {
+  if (stream_->IsMemoryBased()) {
+    return stream_->GetInMemoryRawData();
+  }
+  pdfium::span<const uint8_t> file_span = stream_->GetInMemoryFileRawData();
+  if (!file_span.empty()) {
+    // Decode straight from the file's memory. Only decoded output gets copied.
+    return file_span;
+  }
+  return ReadRawStream();
+}
+
 DataVector<uint8_t> CPDF_StreamAcc::ReadRawStream() const {
   DCHECK(stream_);
   DCHECK(stream_->IsFileBased());
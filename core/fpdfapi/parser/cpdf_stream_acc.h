@@ -10,8 +10,10 @@
 #include <stdint.h>
 
 #include <memory>
+#include <optional>
 #include <variant>
 
+#include "core/fpdfapi/parser/fpdf_parser_decode.h"
 #include "core/fxcrt/bytestring.h"
 #include "core/fxcrt/data_vector.h"
 #include "core/fxcrt/raw_span.h"
@@ -33,6 +35,15 @@ class CPDF_StreamAcc final : public Retainable {
   void LoadAllDataImageAcc(uint32_t estimated_size);
   void LoadAllDataRaw();
 
+  // Does the same as LoadAllDataFiltered(), in two steps, so the filters can
+  // run on another thread. PrepareFilteredDecode() must run on the thread
+  // that owns the document. It copies what the filters need out of the
+  // document, or loads the data right away when it cannot. DecodePrepared()
+  // then runs the filters on any thread, as long as nothing else uses this
+  // object or modifies the stream meanwhile.
+  void PrepareFilteredDecode();
+  void DecodePrepared();
+
   RetainPtr<const CPDF_Stream> GetStream() const;
   RetainPtr<const CPDF_Dictionary> GetImageParam() const;
 
@@ -56,6 +67,11 @@ class CPDF_StreamAcc final : public Retainable {
   // Returns the raw data from `stream_`, or no data on failure.
   DataVector<uint8_t> ReadRawStream() const;
 
+  // Returns the undecoded data of a filtered `stream_`, without copying it
+  // when it is already in memory.
+  std::variant<pdfium::raw_span<const uint8_t>, DataVector<uint8_t>>
+  GetFilteredSource() const;
+
   bool is_owned() const {
     return std::holds_alternative<DataVector<uint8_t>>(data_);
   }
@@ -65,6 +81,9 @@ class CPDF_StreamAcc final : public Retainable {
   // Needs to outlive `data_` when the data is not owned.
   RetainPtr<const CPDF_Stream> const stream_;
   std::variant<pdfium::raw_span<const uint8_t>, DataVector<uint8_t>> data_;
+  // Set between PrepareFilteredDecode() and DecodePrepared(). Shares no
+  // ref-counted data with the document.
+  std::optional<DecoderArray> pending_decoders_;
 };
 
 #endif  // CORE_FPDFAPI_PARSER_CPDF_STREAM_ACC_H_
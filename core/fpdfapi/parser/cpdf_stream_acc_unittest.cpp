@@ -8,7 +8,9 @@
 #include <utility>
 
 #include "core/fpdfapi/parser/cpdf_dictionary.h"
+#include "core/fpdfapi/parser/cpdf_name.h"
 #include "core/fpdfapi/parser/cpdf_stream.h"
+#include "core/fxcrt/cfx_read_only_span_stream.h"
 #include "core/fxcrt/fx_stream.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/invalid_seekable_read_stream.h"
@@ -34,3 +36,54 @@ TEST(StreamAccTest, DataStreamLifeTime) {
   EXPECT_TRUE(
       std::equal(std::begin(kData), std::end(kData), span.begin(), span.end()));
 }
+
+TEST(StreamAccTest, InMemoryFileDataNotCopied) {
+  static constexpr uint8_t kData[] = {'a', 'b', 'c'};
+  auto stream = pdfium::MakeRetain<CPDF_Stream>(
+      pdfium::MakeRetain<CFX_ReadOnlySpanStream>(kData),
+      pdfium::MakeRetain<CPDF_Dictionary>());
+  {
+    auto stream_acc = pdfium::MakeRetain<CPDF_StreamAcc>(stream);
+    stream_acc->LoadAllDataRaw();
+    EXPECT_EQ(kData, stream_acc->GetSpan().data());
+    EXPECT_EQ(3u, stream_acc->GetSize());
+  }
+  {
+    auto stream_acc = pdfium::MakeRetain<CPDF_StreamAcc>(stream);
+    stream_acc->LoadAllDataFiltered();
+    EXPECT_EQ(kData, stream_acc->GetSpan().data());
+
+    // Detaching still hands out a copy.
+    DataVector<uint8_t> detached = stream_acc->DetachData();
+    EXPECT_NE(kData, detached.data());
+    EXPECT_TRUE(std::equal(std::begin(kData), std::end(kData),
+                           detached.begin(), detached.end()));
+  }
+}
+
+TEST(StreamAccTest, InMemoryFileDataDecoded) {
+  static constexpr uint8_t kData[] = {'6', '1', '6', '2', '>'};
+  auto dict = pdfium::MakeRetain<CPDF_Dictionary>();
+  dict->SetNewFor<CPDF_Name>("Filter", "ASCIIHexDecode");
+  auto stream = pdfium::MakeRetain<CPDF_Stream>(
+      pdfium::MakeRetain<CFX_ReadOnlySpanStream>(kData), std::move(dict));
+  auto stream_acc = pdfium::MakeRetain<CPDF_StreamAcc>(std::move(stream));
+  stream_acc->LoadAllDataFiltered();
+  pdfium::span<const uint8_t> span = stream_acc->GetSpan();
+  ASSERT_EQ(2u, span.size());
+  EXPECT_EQ('a', span[0]);
+  EXPECT_EQ('b', span[1]);
+}
+
+TEST(StreamAccTest, InMemoryFileImageDataNotCopied) {
+  // The image decoder runs later, so the accessor only needs the raw data.
+  static constexpr uint8_t kData[] = {0xff, 0xd8, 0xff, 0xd9};
+  auto dict = pdfium::MakeRetain<CPDF_Dictionary>();
+  dict->SetNewFor<CPDF_Name>("Filter", "DCTDecode");
+  auto stream = pdfium::MakeRetain<CPDF_Stream>(
+      pdfium::MakeRetain<CFX_ReadOnlySpanStream>(kData), std::move(dict));
+  auto stream_acc = pdfium::MakeRetain<CPDF_StreamAcc>(std::move(stream));
+  stream_acc->LoadAllDataImageAcc(0);
+  EXPECT_EQ("DCTDecode", stream_acc->GetImageDecoder());
+  EXPECT_EQ(kData, stream_acc->GetSpan().data());
+}
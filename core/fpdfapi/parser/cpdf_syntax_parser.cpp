@@ -8,6 +8,7 @@
 
 #include <algorithm>
 #include <utility>
+#include <vector>
 
 #include "core/fpdfapi/parser/cpdf_array.h"
 #include "core/fpdfapi/parser/cpdf_boolean.h"
@@ -22,6 +23,7 @@
 #include "core/fpdfapi/parser/cpdf_string.h"
 #include "core/fpdfapi/parser/fpdf_parser_utility.h"
 #include "core/fxcrt/autorestorer.h"
+#include "core/fxcrt/cfx_read_only_span_stream.h"
 #include "core/fxcrt/cfx_read_only_vector_stream.h"
 #include "core/fxcrt/check.h"
 #include "core/fxcrt/check_op.h"
@@ -68,16 +70,57 @@ class ReadableSubStream final : public IFX_SeekableReadStream {
 
   FX_FILESIZE GetSize() override { return part_size_; }
 
+  pdfium::span<const uint8_t> GetInMemorySpan() override {
+    pdfium::span<const uint8_t> span = file_read_->GetInMemorySpan();
+    FX_SAFE_SIZE_T safe_end = part_offset_;
+    safe_end += part_size_;
+    if (span.empty() || !safe_end.IsValid() ||
+        safe_end.ValueOrDie() > span.size()) {
+      return {};
+    }
+    return span.subspan(static_cast<size_t>(part_offset_),
+                        static_cast<size_t>(part_size_));
+  }
+
  private:
   RetainPtr<IFX_SeekableReadStream> file_read_;
   FX_FILESIZE part_offset_;
   FX_FILESIZE part_size_;
 };
 
+// Views part of a file that lives entirely in memory. Keeps the file alive,
+// so the view stays valid for as long as this stream exists.
+class InMemorySubStream final : public IFX_SeekableReadStream {
+ public:
+  InMemorySubStream(RetainPtr<IFX_SeekableReadStream> file,
+                    pdfium::span<const uint8_t> part)
+      : file_(std::move(file)),
+        part_(pdfium::MakeRetain<CFX_ReadOnlySpanStream>(part)) {}
+
+  ~InMemorySubStream() override = default;
+
+  // IFX_SeekableReadStream overrides:
+  bool ReadBlockAtOffset(pdfium::span<uint8_t> buffer,
+                         FX_FILESIZE offset) override {
+    return part_->ReadBlockAtOffset(buffer, offset);
+  }
+
+  FX_FILESIZE GetSize() override { return part_->GetSize(); }
+
+  pdfium::span<const uint8_t> GetInMemorySpan() override {
+    return part_->GetInMemorySpan();
+  }
+
+ private:
+  // Must outlive `part_`.
+  RetainPtr<IFX_SeekableReadStream> const file_;
+  RetainPtr<CFX_ReadOnlySpanStream> const part_;
+};
+
 }  // namespace
 
 // static
-int CPDF_SyntaxParser::s_CurrentRecursionDepth = 0;
+thread_local int CPDF_SyntaxParser::s_CurrentRecursionDepth = 0;
 
 // static
 std::unique_ptr<CPDF_SyntaxParser> CPDF_SyntaxParser::CreateForTesting(
@@ -122,12 +165,24 @@ bool CPDF_SyntaxParser::ReadBlockAt(FX_FILESIZE read_pos) {
     read_size = file_len_ - read_pos;
   }
 
+  // When the whole file is resident in memory, make it the read window, so
+  // no further reads or copies are needed.
+  pdfium::span<const uint8_t> in_memory_span = file_access_->GetInMemorySpan();
+  if (!in_memory_span.empty()) {
+    file_buf_.clear();
+    buf_span_ = in_memory_span;
+    buf_offset_ = 0;
+    return true;
+  }
+
   file_buf_.resize(read_size);
   if (!file_access_->ReadBlockAtOffset(file_buf_, read_pos)) {
     file_buf_.clear();
+    buf_span_ = pdfium::span<const uint8_t>();
     return false;
   }
 
+  buf_span_ = file_buf_;
   buf_offset_ = read_pos;
   return true;
 }
@@ -142,7 +197,7 @@ bool CPDF_SyntaxParser::GetNextChar(uint8_t& ch) {
     return false;
   }
 
-  ch = file_buf_[pos - buf_offset_];
+  ch = buf_span_[pos - buf_offset_];
   pos_++;
   return true;
 }
@@ -166,7 +221,7 @@ bool CPDF_SyntaxParser::GetCharAtBackward(FX_FILESIZE pos, uint8_t* ch) {
       return false;
     }
   }
-  *ch = file_buf_[pos - buf_offset_];
+  *ch = buf_span_[pos - buf_offset_];
   return true;
 }
 
@@ -605,8 +660,7 @@ RetainPtr<CPDF_Object> CPDF_SyntaxParser::GetObjectBodyInternal(
         pool_, PDF_NameDecode(ByteStringView(word_span).Substr(1)));
   }
   if (word == "<<") {
-    RetainPtr<CPDF_Dictionary> dict =
-        pdfium::MakeRetain<CPDF_Dictionary>(pool_);
+    std::vector<CPDF_Dictionary::Entry> entries;
     while (true) {
       WordResult inner_word_result = GetNextWord();
       const ByteString& inner_word = inner_word_result.word;
@@ -646,9 +700,12 @@ RetainPtr<CPDF_Object> CPDF_SyntaxParser::GetObjectBodyInternal(
       // `key` has to be "/X" at the minimum.
       // `pObj` cannot be a stream, per ISO 32000-1:2008 section 7.3.8.1.
       if (key.GetLength() > 1 && !pObj->IsStream()) {
-        dict->SetFor(key.Substr(1), std::move(pObj));
+        entries.emplace_back(key.Substr(1), std::move(pObj));
       }
     }
+    RetainPtr<CPDF_Dictionary> dict =
+        pdfium::MakeRetain<CPDF_Dictionary>(pool_);
+    dict->SetEntries(std::move(entries));
 
     AutoRestorer<FX_FILESIZE> pos_restorer(&pos_);
     if (GetNextWord().word != "stream") {
@@ -856,13 +913,25 @@ RetainPtr<CPDF_Stream> CPDF_SyntaxParser::ReadStream(
   if (substream) {
     // It is unclear from CPDF_SyntaxParser's perspective what object
     // `substream` is ultimately holding references to. To avoid unexpectedly
-    // changing object lifetimes by handing `substream` to `stream`, make a
-    // copy of the data here.
-    auto data = FixedSizeDataVector<uint8_t>::Uninit(substream->GetSize());
-    bool did_read = substream->ReadBlockAtOffset(data.span(), 0);
-    CHECK(did_read);
-    auto data_as_stream =
-        pdfium::MakeRetain<CFX_ReadOnlyVectorStream>(std::move(data));
+    // changing object lifetimes by handing `substream` to `stream`, either
+    // view the data while holding only the in-memory file that owns it, or
+    // make a copy of the data here.
+    RetainPtr<IFX_SeekableReadStream> data_as_stream;
+    RetainPtr<IFX_SeekableReadStream> in_memory_file =
+        GetValidator()->GetInMemoryFile();
+    pdfium::span<const uint8_t> in_memory_data =
+        in_memory_file ? substream->GetInMemorySpan()
+                       : pdfium::span<const uint8_t>();
+    if (!in_memory_data.empty()) {
+      data_as_stream = pdfium::MakeRetain<InMemorySubStream>(
+          std::move(in_memory_file), in_memory_data);
+    } else {
+      auto data = FixedSizeDataVector<uint8_t>::Uninit(substream->GetSize());
+      bool did_read = substream->ReadBlockAtOffset(data.span(), 0);
+      CHECK(did_read);
+      data_as_stream =
+          pdfium::MakeRetain<CFX_ReadOnlyVectorStream>(std::move(data));
+    }
 
     stream = pdfium::MakeRetain<CPDF_Stream>(std::move(data_as_stream),
                                              std::move(dict));
@@ -1007,5 +1076,5 @@ FX_FILESIZE CPDF_SyntaxParser::FindTag(ByteStringView tag) {
 
 bool CPDF_SyntaxParser::IsPositionRead(FX_FILESIZE pos) const {
   return buf_offset_ <= pos &&
-         pos < static_cast<FX_FILESIZE>(buf_offset_ + file_buf_.size());
+         pos < static_cast<FX_FILESIZE>(buf_offset_ + buf_span_.size());
 }
@@ -16,6 +16,7 @@
 #include "core/fpdfapi/parser/cpdf_stream.h"
 #include "core/fxcrt/data_vector.h"
 #include "core/fxcrt/fx_types.h"
+#include "core/fxcrt/raw_span.h"
 #include "core/fxcrt/retain_ptr.h"
 #include "core/fxcrt/span.h"
 #include "core/fxcrt/string_pool_template.h"
@@ -95,7 +96,7 @@ class CPDF_SyntaxParser {
   friend class cpdf_syntax_parser_ReadHexString_Test;
 
   static constexpr int kParserMaxRecursionDepth = 64;
-  static int s_CurrentRecursionDepth;
+  static thread_local int s_CurrentRecursionDepth;
 
   bool ReadBlockAt(FX_FILESIZE read_pos);
   bool GetCharAtBackward(FX_FILESIZE pos, uint8_t* ch);
@@ -125,6 +126,9 @@ class CPDF_SyntaxParser {
   FX_FILESIZE pos_ = 0;
   WeakPtr<ByteStringPool> pool_;
   DataVector<uint8_t> file_buf_;
+  // The current read window, starting at `buf_offset_`. Spans over either
+  // `file_buf_`, or the whole file when it is resident in memory.
+  pdfium::raw_span<const uint8_t> buf_span_;
   FX_FILESIZE buf_offset_ = 0;
   uint32_t word_size_ = 0;
   uint32_t read_buffer_size_ = CPDF_Stream::kFileBufSize;
@@ -6,6 +6,7 @@
 
 #include "core/fpdfapi/parser/cpdf_object.h"
 #include "core/fpdfapi/parser/cpdf_parser.h"
+#include "core/fpdfapi/parser/cpdf_stream.h"
 #include "core/fpdfapi/parser/cpdf_syntax_parser.h"
 #include "core/fxcrt/cfx_read_only_span_stream.h"
 #include "core/fxcrt/fx_extension.h"
@@ -147,3 +148,21 @@ TEST(SyntaxParserTest, PeekNextWord) {
   EXPECT_EQ("WORD", parser.PeekNextWord());
   EXPECT_EQ("WORD", parser.GetNextWord().word);
 }
+
+TEST(SyntaxParserTest, ReadStreamFromInMemoryFile) {
+  static const char kData[] = "<</Length 3>>\nstream\nabc\nendstream\nendobj";
+  auto file = pdfium::MakeRetain<CFX_ReadOnlySpanStream>(
+      ByteStringView(kData).unsigned_span());
+  CPDF_SyntaxParser parser(file);
+  RetainPtr<CPDF_Object> object = parser.GetObjectBody(nullptr);
+  ASSERT_TRUE(object);
+  RetainPtr<CPDF_Stream> stream = ToStream(std::move(object));
+  ASSERT_TRUE(stream);
+  ASSERT_TRUE(stream->IsFileBased());
+
+  // The stream views the file rather than holding a copy.
+  pdfium::span<const uint8_t> data = stream->GetInMemoryFileRawData();
+  ASSERT_EQ(3u, data.size());
+  EXPECT_EQ(file->GetInMemorySpan().subspan(21u).data(), data.data());
+  EXPECT_EQ('a', data[0]);
+}
@@ -11,6 +11,8 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <memory>
 #include <utility>
 
 #include "build/build_config.h"
@@ -37,6 +39,11 @@ namespace {
 
 const uint32_t kMaxStreamSize = 20 * 1024 * 1024;
 
+// Size of the window GetFlateDecodeSrcSize() decodes into.
+constexpr size_t kFlateSkipWindowSize = 64 * 1024;
+
+std::atomic<size_t> g_max_flate_decode_size = 0;
+
 bool CheckFlateDecodeParams(int Colors, int BitsPerComponent, int Columns) {
   if (Colors < 0 || BitsPerComponent < 0 || Columns < 0) {
     return false;
@@ -382,9 +389,42 @@ DataAndBytesConsumed FlateOrLZWDecode(bool use_lzw,
       return {DataVector<uint8_t>(), FX_INVALID_OFFSET};
     }
   }
-  return FlateModule::FlateOrLZWDecode(use_lzw, src_span, bEarlyChange,
-                                       predictor, Colors, BitsPerComponent,
-                                       Columns, estimated_size);
+  return FlateModule::FlateOrLZWDecode(
+      use_lzw, src_span, bEarlyChange, predictor, Colors, BitsPerComponent,
+      Columns, estimated_size, g_max_flate_decode_size);
+}
+
+uint32_t GetFlateDecodeSrcSize(pdfium::span<const uint8_t> src_span,
+                               const CPDF_Dictionary* pParams) {
+  int predictor = 0;
+  int Colors = 0;
+  int BitsPerComponent = 0;
+  int Columns = 0;
+  if (pParams) {
+    predictor = pParams->GetIntegerFor("Predictor");
+    Colors = pParams->GetIntegerFor("Colors", 1);
+    BitsPerComponent = pParams->GetIntegerFor("BitsPerComponent", 8);
+    Columns = pParams->GetIntegerFor("Columns", 1);
+    if (!CheckFlateDecodeParams(Colors, BitsPerComponent, Columns)) {
+      return FX_INVALID_OFFSET;
+    }
+  }
+  std::unique_ptr<FlateStreamingDecoder> decoder =
+      FlateModule::CreateStreamingDecoder(src_span, predictor, Colors,
+                                          BitsPerComponent, Columns);
+  DataVector<uint8_t> window(kFlateSkipWindowSize);
+  while (decoder->Read(window) == window.size()) {
+    // Only the amount of source data consumed matters.
+  }
+  return decoder->HasError() ? FX_INVALID_OFFSET : decoder->GetSrcOffset();
+}
+
+void SetMaxFlateDecodeSize(size_t max_size) {
+  g_max_flate_decode_size = max_size;
+}
+
+size_t GetMaxFlateDecodeSize() {
+  return g_max_flate_decode_size;
 }
 
 std::optional<DecoderArray> GetDecoderArray(
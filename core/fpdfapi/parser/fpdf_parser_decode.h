@@ -7,6 +7,7 @@
 #ifndef CORE_FPDFAPI_PARSER_FPDF_PARSER_DECODE_H_
 #define CORE_FPDFAPI_PARSER_FPDF_PARSER_DECODE_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include <array>
@@ -60,12 +61,24 @@ fxcodec::DataAndBytesConsumed A85Decode(pdfium::span<const uint8_t> src_span);
 
 fxcodec::DataAndBytesConsumed HexDecode(pdfium::span<const uint8_t> src_span);
 
+// Flate data is decoded up to the limit set with SetMaxFlateDecodeSize().
 fxcodec::DataAndBytesConsumed FlateOrLZWDecode(
     bool use_lzw,
     pdfium::span<const uint8_t> src_span,
     const CPDF_Dictionary* pParams,
     uint32_t estimated_size);
 
+// Returns how many bytes of Flate data in |src_span| FlateOrLZWDecode() would
+// consume, or FX_INVALID_OFFSET on failure. Only keeps a small window of the
+// decoded data at a time, and ignores the SetMaxFlateDecodeSize() limit.
+uint32_t GetFlateDecodeSrcSize(pdfium::span<const uint8_t> src_span,
+                               const CPDF_Dictionary* pParams);
+
+// Limits how many bytes each FlateDecode filter decodes to, for all documents.
+// Decoding stops at the limit, as if the data ended there. 0 means no limit.
+void SetMaxFlateDecodeSize(size_t max_size);
+size_t GetMaxFlateDecodeSize();
+
 // Returns std::nullopt if the filter in |dict| is the wrong type or an
 // invalid decoder pipeline.
 // Returns an empty vector if there is no filter, or if the filter is an empty
@@ -68,6 +68,44 @@ RetainPtr<CPDF_TransferFunc> CPDF_DocRenderData::GetTransferFunc(
   return func;
 }
 
+const CPDF_DocRenderData::ShadingSteps* CPDF_DocRenderData::GetShadingSteps(
+    RetainPtr<const CPDF_Object> shading,
+    float t_min,
+    float t_max) {
+  auto it = shading_steps_map_.find(shading);
+  if (it == shading_steps_map_.end() || it->second.t_min != t_min ||
+      it->second.t_max != t_max) {
+    return nullptr;
+  }
+  it->second.last_used = ++shading_steps_clock_;
+  return &it->second.steps;
+}
+
+void CPDF_DocRenderData::SetShadingSteps(RetainPtr<const CPDF_Object> shading,
+                                         float t_min,
+                                         float t_max,
+                                         const ShadingSteps& steps) {
+  CHECK(shading);
+  auto it = shading_steps_map_.find(shading);
+  if (it == shading_steps_map_.end() &&
+      shading_steps_map_.size() >= kMaxCachedShadings) {
+    // The map holds the only reference to shadings that got released, e.g.
+    // along with the page or the modified resources they belonged to.
+    std::erase_if(shading_steps_map_,
+                  [](const auto& entry) { return entry.first->HasOneRef(); });
+    if (shading_steps_map_.size() >= kMaxCachedShadings) {
+      shading_steps_map_.erase(std::ranges::min_element(
+          shading_steps_map_, {}, [](const auto& entry) {
+            return entry.second.last_used;
+          }));
+    }
+  }
+  shading_steps_map_[std::move(shading)] = {.t_min = t_min,
+                                            .t_max = t_max,
+                                            .last_used = ++shading_steps_clock_,
+                                            .steps = steps};
+}
+
 #if BUILDFLAG(IS_WIN)
 CFX_PSFontTracker* CPDF_DocRenderData::GetPSFontTracker() {
   if (!psfont_tracker_) {
@@ -7,6 +7,10 @@
 #ifndef CORE_FPDFAPI_RENDER_CPDF_DOCRENDERDATA_H_
 #define CORE_FPDFAPI_RENDER_CPDF_DOCRENDERDATA_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
 #include <functional>
 #include <map>
 
@@ -14,6 +18,7 @@
 #include "core/fpdfapi/parser/cpdf_document.h"
 #include "core/fxcrt/observed_ptr.h"
 #include "core/fxcrt/retain_ptr.h"
+#include "core/fxge/dib/fx_dib.h"
 
 #if BUILDFLAG(IS_WIN)
 #include <memory>
@@ -31,6 +36,14 @@ class CFX_PSFontTracker;
 
 class CPDF_DocRenderData : public CPDF_Document::RenderDataIface {
  public:
+  // The colors of a shading's functions for evenly spaced inputs, from its
+  // first to its last input, without alpha.
+  static constexpr size_t kShadingSteps = 256;
+  using ShadingSteps = std::array<FX_ARGB, kShadingSteps>;
+
+  // The number of shadings to cache steps for, about 1 KiB each.
+  static constexpr size_t kMaxCachedShadings = 64;
+
   static CPDF_DocRenderData* FromDocument(const CPDF_Document* doc);
 
   CPDF_DocRenderData();
@@ -44,6 +57,21 @@ class CPDF_DocRenderData : public CPDF_Document::RenderDataIface {
   RetainPtr<CPDF_TransferFunc> GetTransferFunc(
       RetainPtr<const CPDF_Object> obj);
 
+  // Returns the steps that got cached for `shading` with the same input
+  // range, or nullptr. They only depend on the shading object, so rendering
+  // it again at another zoom level or for another tile can reuse them. The
+  // result stays valid until the next call to SetShadingSteps().
+  const ShadingSteps* GetShadingSteps(RetainPtr<const CPDF_Object> shading,
+                                      float t_min,
+                                      float t_max);
+  // Caches `steps` for `shading`. Once `kMaxCachedShadings` shadings have
+  // steps, first drops the steps of shadings that nothing else references
+  // anymore, then those of the least recently used shading.
+  void SetShadingSteps(RetainPtr<const CPDF_Object> shading,
+                       float t_min,
+                       float t_max,
+                       const ShadingSteps& steps);
+
 #if BUILDFLAG(IS_WIN)
   CFX_PSFontTracker* GetPSFontTracker();
 #endif
@@ -61,6 +89,17 @@ class CPDF_DocRenderData : public CPDF_Document::RenderDataIface {
            std::less<>>
       transfer_func_map_;
 
+  struct CachedShadingSteps {
+    float t_min;
+    float t_max;
+    // From `shading_steps_clock_`, when the steps were last used.
+    uint64_t last_used;
+    ShadingSteps steps;
+  };
+  std::map<RetainPtr<const CPDF_Object>, CachedShadingSteps, std::less<>>
+      shading_steps_map_;
+  uint64_t shading_steps_clock_ = 0;
+
 #if BUILDFLAG(IS_WIN)
   std::unique_ptr<CFX_PSFontTracker> psfont_tracker_;
 #endif
@@ -7,6 +7,7 @@
 #include <iterator>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "core/fpdfapi/page/cpdf_transferfunc.h"
 #include "core/fpdfapi/parser/cpdf_array.h"
@@ -257,4 +258,61 @@ TEST(CPDFDocRenderDataTest, BadTransferFunctions) {
   }
 }
 
+TEST(CPDFDocRenderDataTest, ShadingSteps) {
+  auto shading = pdfium::MakeRetain<CPDF_Dictionary>();
+  auto other_shading = pdfium::MakeRetain<CPDF_Dictionary>();
+  CPDF_DocRenderData render_data;
+  EXPECT_FALSE(render_data.GetShadingSteps(shading, 0.0f, 1.0f));
+
+  CPDF_DocRenderData::ShadingSteps steps;
+  for (size_t i = 0; i < steps.size(); ++i) {
+    steps[i] = static_cast<FX_ARGB>(i);
+  }
+  render_data.SetShadingSteps(shading, 0.0f, 1.0f, steps);
+  const CPDF_DocRenderData::ShadingSteps* cached_steps =
+      render_data.GetShadingSteps(shading, 0.0f, 1.0f);
+  ASSERT_TRUE(cached_steps);
+  EXPECT_THAT(*cached_steps, ElementsAreArray(steps));
+
+  // Only matches the same shading with the same input range.
+  EXPECT_FALSE(render_data.GetShadingSteps(other_shading, 0.0f, 1.0f));
+  EXPECT_FALSE(render_data.GetShadingSteps(shading, 0.0f, 2.0f));
+  EXPECT_FALSE(render_data.GetShadingSteps(shading, -1.0f, 1.0f));
+
+  // Replaces the steps for another input range.
+  steps.fill(0);
+  render_data.SetShadingSteps(shading, 0.0f, 2.0f, steps);
+  EXPECT_FALSE(render_data.GetShadingSteps(shading, 0.0f, 1.0f));
+  cached_steps = render_data.GetShadingSteps(shading, 0.0f, 2.0f);
+  ASSERT_TRUE(cached_steps);
+  EXPECT_THAT(*cached_steps, ElementsAreArray(steps));
+}
+
+TEST(CPDFDocRenderDataTest, ShadingStepsLimit) {
+  CPDF_DocRenderData render_data;
+  CPDF_DocRenderData::ShadingSteps steps = {};
+  std::vector<RetainPtr<CPDF_Dictionary>> shadings;
+  for (size_t i = 0; i < CPDF_DocRenderData::kMaxCachedShadings; ++i) {
+    shadings.push_back(pdfium::MakeRetain<CPDF_Dictionary>());
+    render_data.SetShadingSteps(shadings.back(), 0.0f, 1.0f, steps);
+  }
+
+  // Using the oldest shading makes the second one the least recently used.
+  EXPECT_TRUE(render_data.GetShadingSteps(shadings[0], 0.0f, 1.0f));
+  auto new_shading = pdfium::MakeRetain<CPDF_Dictionary>();
+  render_data.SetShadingSteps(new_shading, 0.0f, 1.0f, steps);
+  EXPECT_TRUE(render_data.GetShadingSteps(new_shading, 0.0f, 1.0f));
+  EXPECT_TRUE(render_data.GetShadingSteps(shadings[0], 0.0f, 1.0f));
+  EXPECT_FALSE(render_data.GetShadingSteps(shadings[1], 0.0f, 1.0f));
+  EXPECT_TRUE(render_data.GetShadingSteps(shadings[2], 0.0f, 1.0f));
+
+  // Shadings that got released go first, so the least recently used one,
+  // shadings[4], stays.
+  shadings[3].Reset();
+  render_data.SetShadingSteps(shadings[1], 0.0f, 1.0f, steps);
+  EXPECT_TRUE(render_data.GetShadingSteps(shadings[1], 0.0f, 1.0f));
+  EXPECT_TRUE(render_data.GetShadingSteps(shadings[4], 0.0f, 1.0f));
+  EXPECT_TRUE(render_data.GetShadingSteps(new_shading, 0.0f, 1.0f));
+}
+
 }  // namespace
@@ -34,6 +34,7 @@
 #include "core/fxcrt/check.h"
 #include "core/fxcrt/fx_safe_types.h"
 #include "core/fxcrt/maybe_owned.h"
+#include "core/fxcrt/numerics/safe_conversions.h"
 #include "core/fxcrt/zip.h"
 #include "core/fxge/agg/cfx_agg_imagerenderer.h"
 #include "core/fxge/cfx_defaultrenderdevice.h"
@@ -58,6 +59,17 @@ bool IsImageValueTooBig(int val) {
   return safe_val.ValueOrDefault(kLimit) >= kLimit;
 }
 
+int GetRequiredPixels(float length) {
+  return std::max(1, pdfium::saturated_cast<int>(ceilf(length)));
+}
+
+// Returns how many device pixels the image spans along each of its own axes.
+// Decoders may skip resolution beyond that, as it would not show.
+CFX_Size GetRequiredImageSize(const CFX_Matrix& image_matrix) {
+  return {GetRequiredPixels(hypotf(image_matrix.a, image_matrix.b)),
+          GetRequiredPixels(hypotf(image_matrix.c, image_matrix.d))};
+}
+
 }  // namespace
 
 CPDF_ImageRenderer::CPDF_ImageRenderer(CPDF_RenderStatus* pStatus)
@@ -75,8 +87,7 @@ bool CPDF_ImageRenderer::StartLoadDIBBase() {
           render_status_->GetFormResource(), render_status_->GetPageResource(),
           std_cs_, render_status_->GetGroupFamily(),
           render_status_->GetLoadMask(),
-          {render_status_->GetRenderDevice()->GetWidth(),
-           render_status_->GetRenderDevice()->GetHeight()})) {
+          GetRequiredImageSize(image_matrix_))) {
     return false;
   }
   mode_ = Mode::kDefault;
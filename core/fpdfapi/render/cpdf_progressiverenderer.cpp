@@ -12,6 +12,7 @@
 #include "core/fpdfapi/page/cpdf_pageimagecache.h"
 #include "core/fpdfapi/page/cpdf_pageobject.h"
 #include "core/fpdfapi/page/cpdf_pageobjectholder.h"
+#include "core/fpdfapi/page/cpdf_pageobjectindex.h"
 #include "core/fpdfapi/render/cpdf_renderoptions.h"
 #include "core/fpdfapi/render/cpdf_renderstatus.h"
 #include "core/fxcrt/check.h"
@@ -51,7 +52,7 @@ void CPDF_ProgressiveRenderer::Continue(PauseIndicatorIface* pPause) {
         return;
       }
       current_layer_ = context_->GetLayer(layer_index_);
-      last_object_rendered_ = current_layer_->GetObjectHolder()->end();
+      next_object_ = 0;
       render_status_ = std::make_unique<CPDF_RenderStatus>(context_, device_);
       if (options_) {
         render_status_->SetOptions(*options_);
@@ -62,20 +63,21 @@ void CPDF_ProgressiveRenderer::Continue(PauseIndicatorIface* pPause) {
       device_->SaveState();
       clip_rect_ = current_layer_->GetMatrix().GetInverse().TransformRect(
           CFX_FloatRect(device_->GetClipBox()));
-    }
-    CPDF_PageObjectHolder::const_iterator iter;
-    CPDF_PageObjectHolder::const_iterator iterEnd =
-        current_layer_->GetObjectHolder()->end();
-    if (last_object_rendered_ != iterEnd) {
-      iter = last_object_rendered_;
-      ++iter;
-    } else {
-      iter = current_layer_->GetObjectHolder()->begin();
+
+      // Avoid walking all the objects of large pages when only a small part
+      // of the page is visible, e.g. when rendering tiles.
+      visible_objects_.reset();
+      CPDF_PageObjectHolder* holder = current_layer_->GetObjectHolder();
+      if (holder->GetPageObjectCount() >= kMinObjectsForIndex) {
+        const CPDF_PageObjectIndex* index = holder->GetObjectIndex();
+        if (index) {
+          visible_objects_ = index->GetObjectsIntersecting(clip_rect_);
+        }
+      }
     }
     int nObjsToGo = kStepLimit;
     bool is_mask = false;
-    while (iter != iterEnd) {
-      CPDF_PageObject* pCurObj = iter->get();
+    while (CPDF_PageObject* pCurObj = GetNextObject()) {
       if (pCurObj->IsActive() && pCurObj->GetRect().left <= clip_rect_.right &&
           pCurObj->GetRect().right >= clip_rect_.left &&
           pCurObj->GetRect().bottom <= clip_rect_.top &&
@@ -84,7 +86,7 @@ void CPDF_ProgressiveRenderer::Continue(PauseIndicatorIface* pPause) {
             pCurObj->AsImage()->GetImage()->IsMask()) {
 #if BUILDFLAG(IS_WIN)
           if (device_->GetDeviceType() == DeviceType::kPrinter) {
-            last_object_rendered_ = iter;
+            ++next_object_;
             render_status_->ProcessClipPath(pCurObj->clip_path(),
                                             current_layer_->GetMatrix());
             return;
@@ -99,8 +101,7 @@ void CPDF_ProgressiveRenderer::Continue(PauseIndicatorIface* pPause) {
         if (pCurObj->IsImage() && render_status_->GetRenderOptions()
                                       .GetOptions()
                                       .bLimitedImageCache) {
-          context_->GetPageCache()->CacheOptimization(
-              render_status_->GetRenderOptions().GetCacheSizeLimit());
+          context_->GetPageCache()->CacheOptimization();
         }
         if (pCurObj->IsForm() || pCurObj->IsShading()) {
           nObjsToGo = 0;
@@ -108,15 +109,14 @@ void CPDF_ProgressiveRenderer::Continue(PauseIndicatorIface* pPause) {
           --nObjsToGo;
         }
       }
-      last_object_rendered_ = iter;
+      ++next_object_;
       if (nObjsToGo == 0) {
         if (pPause && pPause->NeedToPauseNow()) {
           return;
         }
         nObjsToGo = kStepLimit;
       }
-      ++iter;
-      if (is_mask && iter != iterEnd) {
+      if (is_mask && GetNextObject()) {
         return;
       }
     }
@@ -140,3 +140,14 @@ void CPDF_ProgressiveRenderer::Continue(PauseIndicatorIface* pPause) {
     }
   }
 }
+
+CPDF_PageObject* CPDF_ProgressiveRenderer::GetNextObject() const {
+  const CPDF_PageObjectHolder* holder = current_layer_->GetObjectHolder();
+  if (!visible_objects_.has_value()) {
+    return holder->GetPageObjectByIndex(next_object_);
+  }
+  if (next_object_ >= visible_objects_->size()) {
+    return nullptr;
+  }
+  return holder->GetPageObjectByIndex(visible_objects_.value()[next_object_]);
+}
@@ -10,6 +10,8 @@
 #include <stdint.h>
 
 #include <memory>
+#include <optional>
+#include <vector>
 
 #include "core/fpdfapi/page/cpdf_pageobjectholder.h"
 #include "core/fpdfapi/render/cpdf_rendercontext.h"
@@ -46,6 +48,13 @@ class CPDF_ProgressiveRenderer {
   // Maximum page objects to render before checking for pause.
   static constexpr int kStepLimit = 100;
 
+  // Minimum page objects in a layer to cull them with a CPDF_PageObjectIndex.
+  static constexpr size_t kMinObjectsForIndex = 256;
+
+  // Returns the object at `next_object_` in the current layer, or nullptr
+  // once there are no more objects to render, or to render yet.
+  CPDF_PageObject* GetNextObject() const;
+
   Status status_ = kReady;
   UnownedPtr<CPDF_RenderContext> const context_;
   UnownedPtr<CFX_RenderDevice> const device_;
@@ -54,7 +63,11 @@ class CPDF_ProgressiveRenderer {
   CFX_FloatRect clip_rect_;
   uint32_t layer_index_ = 0;
   UnownedPtr<CPDF_RenderContext::Layer> current_layer_;
-  CPDF_PageObjectHolder::const_iterator last_object_rendered_;
+  // Position in `visible_objects_` if set, or in the object holder.
+  size_t next_object_ = 0;
+  // Positions in the object holder of the objects that intersect
+  // `clip_rect_`, when the current layer has a CPDF_PageObjectIndex.
+  std::optional<std::vector<size_t>> visible_objects_;
 };
 
 #endif  // CORE_FPDFAPI_RENDER_CPDF_PROGRESSIVERENDERER_H_
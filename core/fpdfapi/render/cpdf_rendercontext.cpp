@@ -79,8 +79,7 @@ void CPDF_RenderContext::Render(CFX_RenderDevice* pDevice,
     status.Initialize(nullptr, nullptr);
     status.RenderObjectList(layer.GetObjectHolder(), final_matrix);
     if (status.GetRenderOptions().GetOptions().bLimitedImageCache) {
-      page_cache_->CacheOptimization(
-          status.GetRenderOptions().GetCacheSizeLimit());
+      page_cache_->CacheOptimization();
     }
     if (status.IsStopped()) {
       break;
@@ -6,12 +6,6 @@
 
 #include "core/fpdfapi/render/cpdf_renderoptions.h"
 
-namespace {
-
-constexpr uint32_t kCacheSizeLimitBytes = 100 * 1024 * 1024;
-
-}  // namespace
-
 CPDF_RenderOptions::Options::Options() = default;
 
 CPDF_RenderOptions::Options::Options(const CPDF_RenderOptions::Options& rhs) =
@@ -75,10 +69,6 @@ FX_ARGB CPDF_RenderOptions::TranslateObjectStrokeColor(
   }
 }
 
-uint32_t CPDF_RenderOptions::GetCacheSizeLimit() const {
-  return kCacheSizeLimitBytes;
-}
-
 bool CPDF_RenderOptions::CheckOCGDictVisible(const CPDF_Dictionary* pOC) const {
   return !oc_context_ || oc_context_->CheckOCGDictVisible(pOC);
 }
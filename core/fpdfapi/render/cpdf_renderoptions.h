@@ -64,7 +64,6 @@ class CPDF_RenderOptions {
   const Options& GetOptions() const { return options_; }
   Options& GetOptions() { return options_; }
 
-  uint32_t GetCacheSizeLimit() const;
   bool CheckOCGDictVisible(const CPDF_Dictionary* pOC) const;
   bool CheckPageObjectVisible(const CPDF_PageObject* pPageObj) const;
 
@@ -10,7 +10,9 @@
 
 #include <algorithm>
 #include <array>
+#include <limits>
 #include <memory>
+#include <optional>
 #include <utility>
 #include <vector>
 
@@ -23,6 +25,8 @@
 #include "core/fpdfapi/parser/cpdf_stream.h"
 #include "core/fpdfapi/parser/fpdf_parser_utility.h"
 #include "core/fpdfapi/render/cpdf_devicebuffer.h"
+#include "core/fpdfapi/render/cpdf_docrenderdata.h"
+#include "core/fpdfapi/render/cpdf_rendercontext.h"
 #include "core/fpdfapi/render/cpdf_renderoptions.h"
 #include "core/fxcrt/check.h"
 #include "core/fxcrt/check_op.h"
@@ -34,6 +38,7 @@
 #include "core/fxcrt/span_util.h"
 #include "core/fxcrt/stl_util.h"
 #include "core/fxcrt/unowned_ptr.h"
+#include "core/fxcrt/zip.h"
 #include "core/fxge/cfx_defaultrenderdevice.h"
 #include "core/fxge/cfx_fillrenderoptions.h"
 #include "core/fxge/cfx_path.h"
@@ -42,7 +47,7 @@
 
 namespace {
 
-constexpr int kShadingSteps = 256;
+constexpr int kShadingSteps = CPDF_DocRenderData::kShadingSteps;
 
 uint32_t CountOutputsFromFunctions(
     const std::vector<std::unique_ptr<CPDF_Function>>& funcs) {
@@ -62,43 +67,99 @@ uint32_t GetValidatedOutputsCount(
   return funcs_outputs ? std::max(funcs_outputs, pCS->ComponentCount()) : 0;
 }
 
-bool GetShadingSteps(float t_min,
+// Gets the colors of `funcs` for evenly spaced inputs from `t_min` to
+// `t_max`, from the document's cache if `render_data` has them for `shading`.
+bool GetShadingSteps(CPDF_DocRenderData* render_data,
+                     const CPDF_Object* shading,
+                     float t_min,
                      float t_max,
                      const std::vector<std::unique_ptr<CPDF_Function>>& funcs,
                      const RetainPtr<CPDF_ColorSpace>& pCS,
                      int alpha,
                      std::array<FX_ARGB, kShadingSteps>* output) {
-  const uint32_t results_count = GetValidatedOutputsCount(funcs, pCS);
-  if (results_count == 0) {
-    return false;
-  }
+  const CPDF_DocRenderData::ShadingSteps* cached_steps =
+      render_data ? render_data->GetShadingSteps(pdfium::WrapRetain(shading),
+                                                 t_min, t_max)
+                  : nullptr;
+  CPDF_DocRenderData::ShadingSteps steps;
+  if (!cached_steps) {
+    const uint32_t results_count = GetValidatedOutputsCount(funcs, pCS);
+    if (results_count == 0) {
+      return false;
+    }
 
-  CHECK_GE(results_count, CountOutputsFromFunctions(funcs));
-  CHECK_GE(results_count, pCS->ComponentCount());
-  std::array<FX_ARGB, kShadingSteps>& shading_steps = *output;
-  std::vector<float> result_array(results_count);
-  float diff = t_max - t_min;
-  for (int i = 0; i < kShadingSteps; ++i) {
-    float input = diff * i / kShadingSteps + t_min;
-    pdfium::span<float> result_span = pdfium::span(result_array);
-    for (const auto& func : funcs) {
-      if (!func) {
-        continue;
-      }
-      std::optional<uint32_t> nresults =
-          func->Call(pdfium::span_from_ref(input), result_span);
-      if (nresults.has_value()) {
-        result_span = result_span.subspan(nresults.value());
+    CHECK_GE(results_count, CountOutputsFromFunctions(funcs));
+    CHECK_GE(results_count, pCS->ComponentCount());
+    std::vector<float> result_array(results_count);
+    float diff = t_max - t_min;
+    for (int i = 0; i < kShadingSteps; ++i) {
+      float input = diff * i / kShadingSteps + t_min;
+      pdfium::span<float> result_span = pdfium::span(result_array);
+      for (const auto& func : funcs) {
+        if (!func) {
+          continue;
+        }
+        std::optional<uint32_t> nresults =
+            func->Call(pdfium::span_from_ref(input), result_span);
+        if (nresults.has_value()) {
+          result_span = result_span.subspan(nresults.value());
+        }
       }
+      auto rgb = pCS->GetRGBOrZerosOnError(result_array);
+      steps[i] = ArgbEncode(0, FXSYS_roundf(rgb.red * 255),
+                            FXSYS_roundf(rgb.green * 255),
+                            FXSYS_roundf(rgb.blue * 255));
+    }
+    if (render_data) {
+      render_data->SetShadingSteps(pdfium::WrapRetain(shading), t_min, t_max,
+                                   steps);
     }
-    auto rgb = pCS->GetRGBOrZerosOnError(result_array);
-    shading_steps[i] =
-        ArgbEncode(alpha, FXSYS_roundf(rgb.red * 255),
-                   FXSYS_roundf(rgb.green * 255), FXSYS_roundf(rgb.blue * 255));
+    cached_steps = &steps;
+  }
+
+  const FX_ARGB alpha_bits = ArgbEncode(alpha, 0, 0, 0);
+  for (auto [color, cached_color] : fxcrt::Zip(*output, *cached_steps)) {
+    color = cached_color | alpha_bits;
   }
   return true;
 }
 
+// Returns the shading step that `position` falls on, truncating like a cast
+// to int does, or -1 before the first step, or kShadingSteps after the last.
+int GetShadingStep(double position) {
+  // NaNs count as being before the first step.
+  if (!(position > -1)) {
+    return -1;
+  }
+  if (position >= kShadingSteps) {
+    return kShadingSteps;
+  }
+  return static_cast<int>(position);
+}
+
+// Transforms the pixels of a bitmap row like CFX_Matrix::Transform() does,
+// with the same results, but with the row's terms computed only once.
+class RowTransformer {
+ public:
+  explicit RowTransformer(const CFX_Matrix& matrix) : matrix_(matrix) {}
+
+  void SetRow(int row) {
+    row_x_ = matrix_.c * static_cast<float>(row);
+    row_y_ = matrix_.d * static_cast<float>(row);
+  }
+
+  CFX_PointF Transform(int column) const {
+    const float x = static_cast<float>(column);
+    return CFX_PointF(matrix_.a * x + row_x_ + matrix_.e,
+                      matrix_.b * x + row_y_ + matrix_.f);
+  }
+
+ private:
+  const CFX_Matrix matrix_;
+  float row_x_ = 0;
+  float row_y_ = 0;
+};
+
 float ComponentToShadingIndex(float c, float c_min, float c_max) {
   if (c_min == c_max) {
     return 0;
@@ -111,7 +172,8 @@ void DrawAxialShading(const RetainPtr<CFX_DIBitmap>& pBitmap,
                       const CPDF_Dictionary* dict,
                       const std::vector<std::unique_ptr<CPDF_Function>>& funcs,
                       const RetainPtr<CPDF_ColorSpace>& pCS,
-                      int alpha) {
+                      int alpha,
+                      CPDF_DocRenderData* render_data) {
   DCHECK_EQ(pBitmap->GetFormat(), FXDIB_Format::kBgra);
 
   RetainPtr<const CPDF_Array> pCoords = dict->GetArrayFor("Coords");
@@ -141,23 +203,62 @@ void DrawAxialShading(const RetainPtr<CFX_DIBitmap>& pBitmap,
   float axis_len_square = (x_span * x_span) + (y_span * y_span);
 
   std::array<FX_ARGB, kShadingSteps> shading_steps;
-  if (!GetShadingSteps(t_min, t_max, funcs, pCS, alpha, &shading_steps)) {
+  if (!GetShadingSteps(render_data, dict, t_min, t_max, funcs, pCS, alpha,
+                       &shading_steps)) {
     return;
   }
 
-  CFX_Matrix matrix = mtObject2Bitmap.GetInverse();
+  const CFX_Matrix matrix = mtObject2Bitmap.GetInverse();
+  RowTransformer transformer(matrix);
+  auto get_position = [&](int column) {
+    const CFX_PointF pos = transformer.Transform(column);
+    float scale =
+        (((pos.x - start_x) * x_span) + ((pos.y - start_y) * y_span)) /
+        axis_len_square;
+    return scale * (kShadingSteps - 1);
+  };
+
+  // The position along the axis is an affine function of the pixel position,
+  // so step it along each row in double precision. Where the difference to
+  // get_position() could affect the result, which is only close to the
+  // boundaries between steps, fall back to get_position(). kErrorFactor
+  // generously covers the rounding errors of its float operations.
+  static constexpr double kErrorFactor =
+      16 * std::numeric_limits<float>::epsilon();
+  const double position_scale = (kShadingSteps - 1) / axis_len_square;
+  const double position_per_column =
+      (static_cast<double>(matrix.a) * x_span +
+       static_cast<double>(matrix.b) * y_span) *
+      position_scale;
+  const double abs_position_per_column =
+      (fabs(matrix.a) * fabs(x_span) + fabs(matrix.b) * fabs(y_span)) *
+      position_scale * width;
   for (int row = 0; row < height; row++) {
     auto dest_buf = pBitmap->GetWritableScanlineAs<uint32_t>(row).first(
         static_cast<size_t>(width));
-    size_t column_counter = 0;
-    for (auto& pix : dest_buf) {
-      const float column = static_cast<float>(column_counter++);
-      const CFX_PointF pos =
-          matrix.Transform(CFX_PointF(column, static_cast<float>(row)));
-      float scale =
-          (((pos.x - start_x) * x_span) + ((pos.y - start_y) * y_span)) /
-          axis_len_square;
-      int index = static_cast<int32_t>(scale * (kShadingSteps - 1));
+    transformer.SetRow(row);
+    const double row_x = static_cast<double>(matrix.c) * row + matrix.e;
+    const double row_y = static_cast<double>(matrix.d) * row + matrix.f;
+    const double row_position =
+        ((row_x - start_x) * x_span + (row_y - start_y) * y_span) *
+        position_scale;
+    const double max_error =
+        kErrorFactor *
+            (abs_position_per_column +
+             ((fabs(matrix.c * row) + fabs(matrix.e) + fabs(start_x)) *
+                  fabs(x_span) +
+              (fabs(matrix.d * row) + fabs(matrix.f) + fabs(start_y)) *
+                  fabs(y_span)) *
+                 position_scale) +
+        std::numeric_limits<float>::min();
+    const bool can_step = isfinite(row_position) &&
+                          isfinite(position_per_column) && isfinite(max_error);
+    for (int column = 0; column < width; column++) {
+      const double position = row_position + position_per_column * column;
+      int index = GetShadingStep(position - max_error);
+      if (!can_step || index != GetShadingStep(position + max_error)) {
+        index = GetShadingStep(get_position(column));
+      }
       if (index < 0) {
         if (!bStartExtend) {
           continue;
@@ -169,7 +270,7 @@ void DrawAxialShading(const RetainPtr<CFX_DIBitmap>& pBitmap,
         }
         index = kShadingSteps - 1;
       }
-      pix = shading_steps[index];
+      dest_buf[column] = shading_steps[index];
     }
   }
 }
@@ -179,7 +280,8 @@ void DrawRadialShading(const RetainPtr<CFX_DIBitmap>& pBitmap,
                        const CPDF_Dictionary* dict,
                        const std::vector<std::unique_ptr<CPDF_Function>>& funcs,
                        const RetainPtr<CPDF_ColorSpace>& pCS,
-                       int alpha) {
+                       int alpha,
+                       CPDF_DocRenderData* render_data) {
   DCHECK_EQ(pBitmap->GetFormat(), FXDIB_Format::kBgra);
 
   RetainPtr<const CPDF_Array> pCoords = dict->GetArrayFor("Coords");
@@ -205,7 +307,8 @@ void DrawRadialShading(const RetainPtr<CFX_DIBitmap>& pBitmap,
   const bool bEndExtend = pArray && pArray->GetBooleanAt(1, false);
 
   std::array<FX_ARGB, kShadingSteps> shading_steps;
-  if (!GetShadingSteps(t_min, t_max, funcs, pCS, alpha, &shading_steps)) {
+  if (!GetShadingSteps(render_data, dict, t_min, t_max, funcs, pCS, alpha,
+                       &shading_steps)) {
     return;
   }
 
@@ -219,15 +322,14 @@ void DrawRadialShading(const RetainPtr<CFX_DIBitmap>& pBitmap,
   int height = pBitmap->GetHeight();
   bool bDecreasing = dr < 0 && static_cast<int>(hypotf(dx, dy)) < -dr;
 
-  CFX_Matrix matrix = mtObject2Bitmap.GetInverse();
+  RowTransformer transformer(mtObject2Bitmap.GetInverse());
   for (int row = 0; row < height; row++) {
     auto dest_buf = pBitmap->GetWritableScanlineAs<uint32_t>(row).first(
         static_cast<size_t>(width));
-    size_t column_counter = 0;
+    transformer.SetRow(row);
+    int column = 0;
     for (auto& pix : dest_buf) {
-      const float column = static_cast<float>(column_counter++);
-      const CFX_PointF pos =
-          matrix.Transform(CFX_PointF(column, static_cast<float>(row)));
+      const CFX_PointF pos = transformer.Transform(column++);
       float pos_dx = pos.x - start_x;
       float pos_dy = pos.y - start_y;
       float b = -2 * (pos_dx * dx + pos_dy * dy + start_r * dr);
@@ -257,7 +359,7 @@ void DrawRadialShading(const RetainPtr<CFX_DIBitmap>& pBitmap,
           continue;
         }
       }
-      int index = static_cast<int32_t>(s * (kShadingSteps - 1));
+      int index = GetShadingStep(s * (kShadingSteps - 1));
       if (index < 0) {
         if (!bStartExtend) {
           continue;
@@ -279,7 +381,8 @@ void DrawFuncShading(const RetainPtr<CFX_DIBitmap>& pBitmap,
                      const CPDF_Dictionary* dict,
                      const std::vector<std::unique_ptr<CPDF_Function>>& funcs,
                      const RetainPtr<CPDF_ColorSpace>& pCS,
-                     int alpha) {
+                     int alpha,
+                     CPDF_DocRenderData* render_data) {
   DCHECK_EQ(pBitmap->GetFormat(), FXDIB_Format::kBgra);
 
   const uint32_t total_results = GetValidatedOutputsCount(funcs, pCS);
@@ -299,38 +402,67 @@ void DrawFuncShading(const RetainPtr<CFX_DIBitmap>& pBitmap,
     ymax = pDomain->GetFloatAt(3);
   }
   CFX_Matrix mtDomain2Target = dict->GetMatrixFor("Matrix");
-  CFX_Matrix matrix =
-      mtObject2Bitmap.GetInverse() * mtDomain2Target.GetInverse();
+  RowTransformer transformer(mtObject2Bitmap.GetInverse() *
+                            mtDomain2Target.GetInverse());
   int width = pBitmap->GetWidth();
   int height = pBitmap->GetHeight();
 
   CHECK_GE(total_results, CountOutputsFromFunctions(funcs));
   CHECK_GE(total_results, pCS->ComponentCount());
   std::vector<float> result_array(total_results);
+  std::vector<int> columns;
+  std::vector<float> inputs;
+  std::vector<std::vector<float>> func_results(funcs.size());
   for (int row = 0; row < height; ++row) {
     auto dib_buf = pBitmap->GetWritableScanlineAs<uint32_t>(row);
+    columns.clear();
+    inputs.clear();
+    transformer.SetRow(row);
     for (int column = 0; column < width; column++) {
-      CFX_PointF pos = matrix.Transform(
-          CFX_PointF(static_cast<float>(column), static_cast<float>(row)));
+      const CFX_PointF pos = transformer.Transform(column);
       if (pos.x < xmin || pos.x > xmax || pos.y < ymin || pos.y > ymax) {
         continue;
       }
+      columns.push_back(column);
+      inputs.push_back(pos.x);
+      inputs.push_back(pos.y);
+    }
+
+    // Evaluate the functions for the whole row at once, or for one pixel at a
+    // time if that fails.
+    bool batched = true;
+    for (size_t i = 0; batched && i < funcs.size(); ++i) {
+      if (funcs[i]) {
+        func_results[i].resize(columns.size() * funcs[i]->OutputCount());
+        batched = funcs[i]->CallBatch(columns.size(), inputs, func_results[i]);
+      }
+    }
 
-      float input[2] = {pos.x, pos.y};
+    for (size_t i = 0; i < columns.size(); ++i) {
       pdfium::span<float> result_span = pdfium::span(result_array);
-      for (const auto& func : funcs) {
+      for (size_t j = 0; j < funcs.size(); ++j) {
+        const auto& func = funcs[j];
         if (!func) {
           continue;
         }
-        std::optional<uint32_t> nresults = func->Call(input, result_span);
+        if (batched) {
+          const size_t outputs = func->OutputCount();
+          result_span = fxcrt::spancpy(
+              result_span,
+              pdfium::span(func_results[j]).subspan(i * outputs, outputs));
+          continue;
+        }
+        std::optional<uint32_t> nresults =
+            func->Call(pdfium::span(inputs).subspan(i * 2, 2u), result_span);
         if (nresults.has_value()) {
           result_span = result_span.subspan(nresults.value());
         }
       }
       auto rgb = pCS->GetRGBOrZerosOnError(result_array);
-      dib_buf[column] = ArgbEncode(alpha, static_cast<int32_t>(rgb.red * 255),
-                                   static_cast<int32_t>(rgb.green * 255),
-                                   static_cast<int32_t>(rgb.blue * 255));
+      dib_buf[columns[i]] =
+          ArgbEncode(alpha, static_cast<int32_t>(rgb.red * 255),
+                     static_cast<int32_t>(rgb.green * 255),
+                     static_cast<int32_t>(rgb.blue * 255));
     }
   }
 }
@@ -461,9 +593,12 @@ void DrawFreeGouraudShading(
     RetainPtr<const CPDF_Stream> pShadingStream,
     const std::vector<std::unique_ptr<CPDF_Function>>& funcs,
     RetainPtr<CPDF_ColorSpace> pCS,
-    int alpha) {
+    int alpha,
+    CPDF_DocRenderData* render_data) {
   DCHECK_EQ(pBitmap->GetFormat(), FXDIB_Format::kBgra);
 
+  // `stream` keeps the shading alive.
+  const CPDF_Stream* shading = pShadingStream.Get();
   CPDF_MeshStream stream(kFreeFormGouraudTriangleMeshShading, funcs,
                          std::move(pShadingStream), pCS);
   if (!stream.Load()) {
@@ -472,8 +607,9 @@ void DrawFreeGouraudShading(
 
   std::array<FX_ARGB, kShadingSteps> shading_steps;
   if (!funcs.empty()) {
-    if (!GetShadingSteps(stream.component_min(0), stream.component_max(0),
-                         funcs, pCS, alpha, &shading_steps)) {
+    if (!GetShadingSteps(render_data, shading, stream.component_min(0),
+                         stream.component_max(0), funcs, pCS, alpha,
+                         &shading_steps)) {
       return;
     }
   }
@@ -522,7 +658,8 @@ void DrawLatticeGouraudShading(
     RetainPtr<const CPDF_Stream> pShadingStream,
     const std::vector<std::unique_ptr<CPDF_Function>>& funcs,
     RetainPtr<CPDF_ColorSpace> pCS,
-    int alpha) {
+    int alpha,
+    CPDF_DocRenderData* render_data) {
   DCHECK_EQ(pBitmap->GetFormat(), FXDIB_Format::kBgra);
 
   int row_verts = pShadingStream->GetDict()->GetIntegerFor("VerticesPerRow");
@@ -530,6 +667,8 @@ void DrawLatticeGouraudShading(
     return;
   }
 
+  // `stream` keeps the shading alive.
+  const CPDF_Stream* shading = pShadingStream.Get();
   CPDF_MeshStream stream(kLatticeFormGouraudTriangleMeshShading, funcs,
                          std::move(pShadingStream), pCS);
   if (!stream.Load()) {
@@ -538,8 +677,9 @@ void DrawLatticeGouraudShading(
 
   std::array<FX_ARGB, kShadingSteps> shading_steps;
   if (!funcs.empty()) {
-    if (!GetShadingSteps(stream.component_min(0), stream.component_max(0),
-                         funcs, pCS, alpha, &shading_steps)) {
+    if (!GetShadingSteps(render_data, shading, stream.component_min(0),
+                         stream.component_max(0), funcs, pCS, alpha,
+                         &shading_steps)) {
       return;
     }
   }
@@ -851,7 +991,8 @@ void DrawCoonPatchMeshes(
     const std::vector<std::unique_ptr<CPDF_Function>>& funcs,
     RetainPtr<CPDF_ColorSpace> pCS,
     bool bNoPathSmooth,
-    int alpha) {
+    int alpha,
+    CPDF_DocRenderData* render_data) {
   DCHECK_EQ(pBitmap->GetFormat(), FXDIB_Format::kBgra);
   DCHECK(type == kCoonsPatchMeshShading ||
          type == kTensorProductPatchMeshShading);
@@ -859,6 +1000,8 @@ void DrawCoonPatchMeshes(
   CFX_DefaultRenderDevice device;
   device.Attach(pBitmap);
 
+  // `stream` keeps the shading alive.
+  const CPDF_Stream* shading = pShadingStream.Get();
   CPDF_MeshStream stream(type, funcs, std::move(pShadingStream), pCS);
   if (!stream.Load()) {
     return;
@@ -866,8 +1009,9 @@ void DrawCoonPatchMeshes(
 
   std::array<FX_ARGB, kShadingSteps> shading_steps;
   if (!funcs.empty()) {
-    if (!GetShadingSteps(stream.component_min(0), stream.component_max(0),
-                         funcs, pCS, alpha, &shading_steps)) {
+    if (!GetShadingSteps(render_data, shading, stream.component_min(0),
+                         stream.component_max(0), funcs, pCS, alpha,
+                         &shading_steps)) {
       return;
     }
   }
@@ -1050,21 +1194,23 @@ void CPDF_RenderShading::Draw(CFX_RenderDevice* pDevice,
   }
   const CFX_Matrix final_matrix = mtMatrix * buffer.GetMatrix();
   const auto& funcs = pPattern->GetFuncs();
+  CPDF_DocRenderData* render_data =
+      CPDF_DocRenderData::FromDocument(pContext->GetDocument());
   switch (pPattern->GetShadingType()) {
     case kInvalidShading:
     case kMaxShading:
       return;
     case kFunctionBasedShading:
       DrawFuncShading(pBitmap, final_matrix, dict.Get(), funcs, pColorSpace,
-                      alpha);
+                      alpha, render_data);
       break;
     case kAxialShading:
       DrawAxialShading(pBitmap, final_matrix, dict.Get(), funcs, pColorSpace,
-                       alpha);
+                       alpha, render_data);
       break;
     case kRadialShading:
       DrawRadialShading(pBitmap, final_matrix, dict.Get(), funcs, pColorSpace,
-                        alpha);
+                        alpha, render_data);
       break;
     case kFreeFormGouraudTriangleMeshShading: {
       // The shading object can be a stream or a dictionary. We do not handle
@@ -1073,7 +1219,7 @@ void CPDF_RenderShading::Draw(CFX_RenderDevice* pDevice,
           ToStream(pPattern->GetShadingObject());
       if (pStream) {
         DrawFreeGouraudShading(pBitmap, final_matrix, std::move(pStream), funcs,
-                               pColorSpace, alpha);
+                               pColorSpace, alpha, render_data);
       }
       break;
     }
@@ -1084,7 +1230,7 @@ void CPDF_RenderShading::Draw(CFX_RenderDevice* pDevice,
           ToStream(pPattern->GetShadingObject());
       if (pStream) {
         DrawLatticeGouraudShading(pBitmap, final_matrix, std::move(pStream),
-                                  funcs, pColorSpace, alpha);
+                                  funcs, pColorSpace, alpha, render_data);
       }
       break;
     }
@@ -1097,7 +1243,8 @@ void CPDF_RenderShading::Draw(CFX_RenderDevice* pDevice,
       if (pStream) {
         DrawCoonPatchMeshes(pPattern->GetShadingType(), pBitmap, final_matrix,
                             std::move(pStream), funcs, pColorSpace,
-                            options.GetOptions().bNoPathSmooth, alpha);
+                            options.GetOptions().bNoPathSmooth, alpha,
+                            render_data);
       }
       break;
     }
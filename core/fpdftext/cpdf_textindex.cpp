@@ -0,0 +1,407 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdftext/cpdf_textindex.h"
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <utility>
+
+#include "core/fpdfapi/parser/cpdf_array.h"
+#include "core/fpdfapi/parser/cpdf_document.h"
+#include "core/fpdfapi/parser/cpdf_parser.h"
+#include "core/fxcrt/binary_buffer.h"
+#include "core/fxcrt/fx_extension.h"
+#include "core/fxcrt/fx_safe_types.h"
+#include "core/fxcrt/numerics/safe_conversions.h"
+#include "core/fxcrt/raw_span.h"
+#include "core/fxcrt/stl_util.h"
+
+namespace {
+
+// Serialized indices start with these bytes, followed by the format version,
+// the document ID and the page count.
+constexpr std::array<const uint8_t, 4> kSignature = {{'P', 'T', 'X', 'I'}};
+constexpr uint32_t kVersion = 1;
+
+// Packs the lower case forms of 3 characters into 21 bits each.
+uint64_t PackTrigram(uint32_t c0, uint32_t c1, uint32_t c2) {
+  return static_cast<uint64_t>(c0) << 42 | static_cast<uint64_t>(c1) << 21 |
+         c2;
+}
+
+uint32_t FoldCase(wchar_t c) {
+  return static_cast<uint32_t>(FXSYS_towlower(c)) & 0x1fffff;
+}
+
+// Appends the trigrams of `text` to `trigrams`. Every case insensitive match in
+// `text` contains the trigrams of the matched word.
+void AppendTrigrams(const WideString& text, std::vector<uint64_t>& trigrams) {
+  if (text.GetLength() < 3) {
+    return;
+  }
+  uint32_t c0 = FoldCase(text[0]);
+  uint32_t c1 = FoldCase(text[1]);
+  for (size_t i = 2; i < text.GetLength(); ++i) {
+    const uint32_t c2 = FoldCase(text[i]);
+    trigrams.push_back(PackTrigram(c0, c1, c2));
+    c0 = c1;
+    c1 = c2;
+  }
+}
+
+// Writes `value` 7 bits at a time, least significant first, with the top bit
+// of each byte set when more bytes follow.
+void AppendVarint(BinaryBuffer& buffer, uint64_t value) {
+  while (value >= 0x80) {
+    buffer.AppendUint8(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  buffer.AppendUint8(static_cast<uint8_t>(value));
+}
+
+class IndexReader {
+ public:
+  explicit IndexReader(pdfium::span<const uint8_t> data) : data_(data) {}
+
+  bool ReadSignature() {
+    if (data_.size() < kSignature.size() ||
+        data_.first(kSignature.size()) != pdfium::span(kSignature)) {
+      return false;
+    }
+    data_ = data_.subspan(kSignature.size());
+    return true;
+  }
+
+  std::optional<uint32_t> ReadVarint() {
+    uint32_t value = 0;
+    for (int shift = 0; shift < 32; shift += 7) {
+      if (data_.empty()) {
+        return std::nullopt;
+      }
+      const uint8_t byte = data_.front();
+      data_ = data_.subspan(1u);
+      if (shift == 28 && byte > 0x0f) {
+        return std::nullopt;
+      }
+      value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) {
+        return value;
+      }
+    }
+    return std::nullopt;
+  }
+
+  // Reads a count or an index, which must fit in an int.
+  std::optional<int> ReadInt() {
+    std::optional<uint32_t> value = ReadVarint();
+    if (!value.has_value() ||
+        !pdfium::IsValueInRangeForNumericType<int>(value.value())) {
+      return std::nullopt;
+    }
+    return static_cast<int>(value.value());
+  }
+
+  // Reads a count of items that take at least `min_item_size` bytes each.
+  std::optional<int> ReadCount(size_t min_item_size) {
+    std::optional<int> count = ReadInt();
+    if (!count.has_value() ||
+        static_cast<size_t>(count.value()) > data_.size() / min_item_size) {
+      return std::nullopt;
+    }
+    return count;
+  }
+
+  // Reads bytes written as a count followed by the bytes themselves.
+  std::optional<ByteString> ReadBytes() {
+    std::optional<int> size = ReadCount(1);
+    if (!size.has_value()) {
+      return std::nullopt;
+    }
+    ByteString bytes(ByteStringView(
+        data_.first(static_cast<size_t>(size.value()))));
+    data_ = data_.subspan(static_cast<size_t>(size.value()));
+    return bytes;
+  }
+
+  bool IsEmpty() const { return data_.empty(); }
+
+ private:
+  pdfium::raw_span<const uint8_t> data_;
+};
+
+std::optional<CPDF_TextIndex::Page> ReadPage(IndexReader& reader) {
+  CPDF_TextIndex::Page page;
+  std::optional<int> text_length = reader.ReadCount(1);
+  if (!text_length.has_value()) {
+    return std::nullopt;
+  }
+  {
+    const size_t length = static_cast<size_t>(text_length.value());
+    pdfium::span<wchar_t> buffer = page.text.GetBuffer(length).first(length);
+    for (wchar_t& c : buffer) {
+      std::optional<uint32_t> value = reader.ReadVarint();
+      if (!value.has_value() ||
+          !pdfium::IsValueInRangeForNumericType<wchar_t>(value.value())) {
+        return std::nullopt;
+      }
+      c = static_cast<wchar_t>(value.value());
+    }
+    page.text.ReleaseBuffer(length);
+  }
+
+  std::optional<int> segment_count = reader.ReadCount(2);
+  if (!segment_count.has_value()) {
+    return std::nullopt;
+  }
+  page.char_segments.reserve(static_cast<size_t>(segment_count.value()));
+  FX_SAFE_INT32 total_count = 0;
+  for (int i = 0; i < segment_count.value(); ++i) {
+    std::optional<int> index = reader.ReadInt();
+    std::optional<int> count = reader.ReadInt();
+    if (!index.has_value() || !count.has_value()) {
+      return std::nullopt;
+    }
+    FX_SAFE_INT32 segment_end = index.value();
+    segment_end += count.value();
+    total_count += count.value();
+    if (!segment_end.IsValid() || !total_count.IsValid()) {
+      return std::nullopt;
+    }
+    page.char_segments.push_back({index.value(), count.value()});
+  }
+  // CPDF_TextIndex::CharIndexFromTextIndex() relies on the segments covering
+  // the text exactly.
+  if (total_count.ValueOrDie() != text_length.value()) {
+    return std::nullopt;
+  }
+  return page;
+}
+
+}  // namespace
+
+CPDF_TextIndex::Search::Search(const CPDF_TextIndex* index,
+                               const WideString& findwhat,
+                               const CPDF_TextPageFind::Options& options,
+                               int start_page)
+    : index_(index),
+      find_what_array_(CPDF_TextPageFind::ExtractFindWhat(findwhat, options)),
+      options_(options),
+      candidate_pages_(index->GetCandidatePages(find_what_array_, start_page)) {
+}
+
+CPDF_TextIndex::Search::~Search() = default;
+
+bool CPDF_TextIndex::Search::FindNext() {
+  while (true) {
+    if (find_next_start_.has_value() &&
+        CPDF_TextPageFind::FindNextInText(
+            page_text_, find_what_array_, options_.bMatchWholeWord,
+            find_next_start_.value(), res_start_, res_end_)) {
+      // Same as CPDF_TextPageFind::FindNext().
+      find_next_start_ = options_.bConsecutive ? res_start_ + 1 : res_end_ + 1;
+      const int char_index =
+          index_->CharIndexFromTextIndex(page_index_, res_start_);
+      hit_ = Hit{.page_index = page_index_,
+                 .char_index = char_index,
+                 .char_count =
+                     index_->CharIndexFromTextIndex(page_index_, res_end_) -
+                     char_index + 1};
+      return true;
+    }
+
+    if (next_candidate_ >= candidate_pages_.size()) {
+      find_next_start_.reset();
+      hit_.reset();
+      return false;
+    }
+
+    // Starts the next page, like a new CPDF_TextPageFind at text index 0.
+    page_index_ = static_cast<int>(candidate_pages_[next_candidate_++]);
+    page_text_ = CPDF_TextPageFind::GetTextCase(
+        index_->pages_[page_index_].text, options_);
+    find_next_start_.reset();
+    if (!page_text_.IsEmpty()) {
+      find_next_start_ = 0;
+    }
+    res_start_ = 0;
+    res_end_ = -1;
+  }
+}
+
+// static
+CPDF_TextIndex::Page CPDF_TextIndex::PageFromTextPage(
+    const CPDF_TextPage& text_page) {
+  pdfium::span<const TextPageCharSegment> segments =
+      text_page.GetCharSegments();
+  return {.text = text_page.GetAllPageText(),
+          .char_segments = DataVector<TextPageCharSegment>(segments.begin(),
+                                                           segments.end())};
+}
+
+// static
+ByteString CPDF_TextIndex::GetDocumentId(const CPDF_Document& doc) {
+  BinaryBuffer buffer;
+  const CPDF_Parser* parser = doc.GetParser();
+  if (parser) {
+    RetainPtr<const CPDF_Array> id_array = parser->GetIDArray();
+    const size_t id_count = id_array ? id_array->size() : 0;
+    AppendVarint(buffer, id_count);
+    for (size_t i = 0; i < id_count; ++i) {
+      const ByteString id = id_array->GetByteStringAt(i);
+      AppendVarint(buffer, id.GetLength());
+      buffer.AppendString(id);
+    }
+    AppendVarint(buffer, static_cast<uint64_t>(parser->GetDocumentSize()));
+    AppendVarint(buffer, static_cast<uint64_t>(parser->GetLastXRefOffset()));
+  }
+  return ByteString(ByteStringView(buffer.GetSpan()));
+}
+
+// static
+std::unique_ptr<CPDF_TextIndex> CPDF_TextIndex::Deserialize(
+    pdfium::span<const uint8_t> data,
+    const ByteString& document_id,
+    int page_count) {
+  IndexReader reader(data);
+  if (!reader.ReadSignature() || reader.ReadVarint() != kVersion ||
+      reader.ReadBytes() != document_id) {
+    return nullptr;
+  }
+
+  // Each page takes at least 2 bytes, for its text length and segment count.
+  if (reader.ReadCount(2) != page_count) {
+    return nullptr;
+  }
+  std::vector<Page> pages;
+  pages.reserve(static_cast<size_t>(page_count));
+  for (int i = 0; i < page_count; ++i) {
+    std::optional<Page> page = ReadPage(reader);
+    if (!page.has_value()) {
+      return nullptr;
+    }
+    pages.push_back(std::move(page.value()));
+  }
+  if (!reader.IsEmpty()) {
+    return nullptr;
+  }
+  return std::make_unique<CPDF_TextIndex>(document_id, std::move(pages));
+}
+
+CPDF_TextIndex::CPDF_TextIndex(const ByteString& document_id,
+                               std::vector<Page> pages)
+    : document_id_(document_id), pages_(std::move(pages)) {
+  std::vector<std::pair<uint64_t, uint32_t>> postings;
+  std::vector<uint64_t> page_trigrams;
+  for (size_t i = 0; i < pages_.size(); ++i) {
+    page_trigrams.clear();
+    AppendTrigrams(pages_[i].text, page_trigrams);
+    std::ranges::sort(page_trigrams);
+    auto duplicates = std::ranges::unique(page_trigrams);
+    page_trigrams.erase(duplicates.begin(), duplicates.end());
+    for (uint64_t trigram : page_trigrams) {
+      postings.emplace_back(trigram, static_cast<uint32_t>(i));
+    }
+  }
+
+  std::ranges::sort(postings);
+  trigram_pages_.reserve(postings.size());
+  for (const auto& [trigram, page_index] : postings) {
+    if (trigrams_.empty() || trigrams_.back() != trigram) {
+      trigrams_.push_back(trigram);
+      trigram_starts_.push_back(
+          fxcrt::CollectionSize<uint32_t>(trigram_pages_));
+    }
+    trigram_pages_.push_back(page_index);
+  }
+  trigram_starts_.push_back(fxcrt::CollectionSize<uint32_t>(trigram_pages_));
+}
+
+CPDF_TextIndex::~CPDF_TextIndex() = default;
+
+DataVector<uint8_t> CPDF_TextIndex::Serialize() const {
+  BinaryBuffer buffer;
+  buffer.AppendSpan(kSignature);
+  AppendVarint(buffer, kVersion);
+  AppendVarint(buffer, document_id_.GetLength());
+  buffer.AppendString(document_id_);
+  AppendVarint(buffer, fxcrt::CollectionSize<uint32_t>(pages_));
+  for (const Page& page : pages_) {
+    AppendVarint(buffer, static_cast<uint32_t>(page.text.GetLength()));
+    for (wchar_t c : page.text) {
+      AppendVarint(buffer, static_cast<uint32_t>(c));
+    }
+    AppendVarint(buffer, fxcrt::CollectionSize<uint32_t>(page.char_segments));
+    for (const TextPageCharSegment& segment : page.char_segments) {
+      AppendVarint(buffer, static_cast<uint32_t>(segment.index));
+      AppendVarint(buffer, static_cast<uint32_t>(segment.count));
+    }
+  }
+  return buffer.DetachBuffer();
+}
+
+int CPDF_TextIndex::CountPages() const {
+  return fxcrt::CollectionSize<int>(pages_);
+}
+
+std::vector<uint32_t> CPDF_TextIndex::GetCandidatePages(
+    const std::vector<WideString>& find_what_array,
+    int start_page) const {
+  const uint32_t first_page = static_cast<uint32_t>(std::max(start_page, 0));
+  std::vector<uint64_t> query_trigrams;
+  for (const WideString& word : find_what_array) {
+    AppendTrigrams(word, query_trigrams);
+  }
+
+  std::vector<uint32_t> pages;
+  if (query_trigrams.empty()) {
+    for (uint32_t i = first_page; i < pages_.size(); ++i) {
+      pages.push_back(i);
+    }
+    return pages;
+  }
+
+  std::ranges::sort(query_trigrams);
+  auto duplicates = std::ranges::unique(query_trigrams);
+  query_trigrams.erase(duplicates.begin(), duplicates.end());
+  for (size_t i = 0; i < query_trigrams.size(); ++i) {
+    auto it = std::ranges::lower_bound(trigrams_, query_trigrams[i]);
+    if (it == trigrams_.end() || *it != query_trigrams[i]) {
+      return {};
+    }
+    const size_t trigram_index = std::distance(trigrams_.begin(), it);
+    pdfium::span<const uint32_t> trigram_pages =
+        pdfium::span(trigram_pages_)
+            .subspan(trigram_starts_[trigram_index],
+                     trigram_starts_[trigram_index + 1] -
+                         trigram_starts_[trigram_index]);
+    if (i == 0) {
+      pages.assign(std::ranges::lower_bound(trigram_pages, first_page),
+                   trigram_pages.end());
+    } else {
+      std::vector<uint32_t> both;
+      std::ranges::set_intersection(pages, trigram_pages,
+                                    std::back_inserter(both));
+      pages = std::move(both);
+    }
+    if (pages.empty()) {
+      break;
+    }
+  }
+  return pages;
+}
+
+int CPDF_TextIndex::CharIndexFromTextIndex(int page_index,
+                                           int text_index) const {
+  // Same as CPDF_TextPage::CharIndexFromTextIndex().
+  int count = 0;
+  for (const TextPageCharSegment& segment : pages_[page_index].char_segments) {
+    count += segment.count;
+    if (count > text_index) {
+      return text_index - count + segment.count + segment.index;
+    }
+  }
+  return -1;
+}
@@ -0,0 +1,120 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FPDFTEXT_CPDF_TEXTINDEX_H_
+#define CORE_FPDFTEXT_CPDF_TEXTINDEX_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "core/fpdftext/cpdf_textpage.h"
+#include "core/fpdftext/cpdf_textpagefind.h"
+#include "core/fxcrt/bytestring.h"
+#include "core/fxcrt/data_vector.h"
+#include "core/fxcrt/span.h"
+#include "core/fxcrt/unowned_ptr.h"
+#include "core/fxcrt/widestring.h"
+
+class CPDF_Document;
+
+// Searchable text of a whole document, built once from the CPDF_TextPage of
+// each page. Searches return the same matches as CPDF_TextPageFind does on
+// each page, without loading any page.
+//
+// An inverted index from the trigrams of the lower case page text to the pages
+// that contain them narrows searches down to the pages that may match. Those
+// pages then get searched like CPDF_TextPageFind does, using the page text and
+// text to character index mapping stored in the index.
+class CPDF_TextIndex {
+ public:
+  struct Page {
+    WideString text;
+    DataVector<TextPageCharSegment> char_segments;
+  };
+
+  struct Hit {
+    bool operator==(const Hit& other) const = default;
+
+    int page_index;
+    // Same as CPDF_TextPageFind::GetCurOrder() and GetMatchedCount().
+    int char_index;
+    int char_count;
+  };
+
+  // Enumerates the matches of a search through the pages in order.
+  class Search {
+   public:
+    Search(const CPDF_TextIndex* index,
+           const WideString& findwhat,
+           const CPDF_TextPageFind::Options& options,
+           int start_page);
+    ~Search();
+
+    // Moves on to the next match. Returns false once there are no more.
+    bool FindNext();
+
+    // Returns the match found by the last FindNext() call, if any.
+    const std::optional<Hit>& GetHit() const { return hit_; }
+
+   private:
+    UnownedPtr<const CPDF_TextIndex> const index_;
+    const std::vector<WideString> find_what_array_;
+    const CPDF_TextPageFind::Options options_;
+    const std::vector<uint32_t> candidate_pages_;
+    size_t next_candidate_ = 0;
+    int page_index_ = -1;
+    WideString page_text_;
+    std::optional<size_t> find_next_start_;
+    int res_start_ = 0;
+    int res_end_ = -1;
+    std::optional<Hit> hit_;
+  };
+
+  static Page PageFromTextPage(const CPDF_TextPage& text_page);
+
+  // Returns bytes that identify the saved file `doc` got loaded from: its
+  // trailer /ID, which PDF writers update on every save, and the file size
+  // and last cross-reference offset, for files without an /ID.
+  static ByteString GetDocumentId(const CPDF_Document& doc);
+
+  // Returns nullptr if `data` is not an index written by Serialize(), or if
+  // it was written for a document with another ID or page count.
+  static std::unique_ptr<CPDF_TextIndex> Deserialize(
+      pdfium::span<const uint8_t> data,
+      const ByteString& document_id,
+      int page_count);
+
+  CPDF_TextIndex(const ByteString& document_id, std::vector<Page> pages);
+  ~CPDF_TextIndex();
+
+  // Writes the document ID, page texts and mappings. The trigram index gets
+  // rebuilt from them by Deserialize().
+  DataVector<uint8_t> Serialize() const;
+
+  int CountPages() const;
+
+ private:
+  // Returns the pages from `start_page` on that contain all the trigrams of
+  // `find_what_array`, in order.
+  std::vector<uint32_t> GetCandidatePages(
+      const std::vector<WideString>& find_what_array,
+      int start_page) const;
+
+  int CharIndexFromTextIndex(int page_index, int text_index) const;
+
+  const ByteString document_id_;
+  const std::vector<Page> pages_;
+  // Sorted distinct trigrams. The pages containing `trigrams_[i]` are
+  // `trigram_pages_[trigram_starts_[i]]` up to
+  // `trigram_pages_[trigram_starts_[i + 1]]`, in order.
+  std::vector<uint64_t> trigrams_;
+  std::vector<uint32_t> trigram_starts_;
+  std::vector<uint32_t> trigram_pages_;
+};
+
+#endif  // CORE_FPDFTEXT_CPDF_TEXTINDEX_H_
@@ -0,0 +1,167 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdftext/cpdf_textindex.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "core/fxcrt/data_vector.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+using Hit = CPDF_TextIndex::Hit;
+
+constexpr char kDocumentId[] = "doc";
+constexpr int kPageCount = 4;
+
+// A page where every text index maps to the char index `first_char` higher.
+CPDF_TextIndex::Page CreatePage(const wchar_t* text, int first_char = 0) {
+  WideString page_text(text);
+  DataVector<TextPageCharSegment> segments;
+  if (!page_text.IsEmpty()) {
+    segments.push_back({first_char, static_cast<int>(page_text.GetLength())});
+  }
+  return {.text = std::move(page_text), .char_segments = std::move(segments)};
+}
+
+std::unique_ptr<CPDF_TextIndex> CreateIndex() {
+  std::vector<CPDF_TextIndex::Page> pages;
+  pages.push_back(CreatePage(L"The quick brown fox"));
+  pages.push_back(CreatePage(L""));
+  pages.push_back(CreatePage(L"no match here, aaaa"));
+  pages.push_back(CreatePage(L"Foxes and FOX, fox.\r\nfoxfox", 5));
+  return std::make_unique<CPDF_TextIndex>(kDocumentId, std::move(pages));
+}
+
+std::vector<Hit> FindAll(const CPDF_TextIndex& index,
+                         const wchar_t* findwhat,
+                         const CPDF_TextPageFind::Options& options,
+                         int start_page = 0) {
+  CPDF_TextIndex::Search search(&index, findwhat, options, start_page);
+  std::vector<Hit> hits;
+  while (search.FindNext()) {
+    hits.push_back(search.GetHit().value());
+  }
+  EXPECT_FALSE(search.GetHit().has_value());
+  return hits;
+}
+
+}  // namespace
+
+TEST(CPDFTextIndexTest, Find) {
+  std::unique_ptr<CPDF_TextIndex> index = CreateIndex();
+  ASSERT_EQ(kPageCount, index->CountPages());
+
+  CPDF_TextPageFind::Options options;
+  EXPECT_EQ((std::vector<Hit>{{0, 16, 3},
+                              {3, 5, 3},
+                              {3, 15, 3},
+                              {3, 20, 3},
+                              {3, 26, 3},
+                              {3, 29, 3}}),
+            FindAll(*index, L"fox", options));
+  EXPECT_EQ((std::vector<Hit>{
+                {3, 5, 3}, {3, 15, 3}, {3, 20, 3}, {3, 26, 3}, {3, 29, 3}}),
+            FindAll(*index, L"fox", options, /*start_page=*/1));
+  EXPECT_EQ((std::vector<Hit>{{0, 4, 11}}),
+            FindAll(*index, L"quick  brown", options));
+  EXPECT_TRUE(FindAll(*index, L"quick fox", options).empty());
+  EXPECT_TRUE(FindAll(*index, L"wolf", options).empty());
+
+  options.bMatchCase = true;
+  EXPECT_EQ((std::vector<Hit>{{3, 15, 3}}), FindAll(*index, L"FOX", options));
+
+  options.bMatchCase = false;
+  options.bMatchWholeWord = true;
+  EXPECT_EQ((std::vector<Hit>{{0, 16, 3}, {3, 15, 3}, {3, 20, 3}}),
+            FindAll(*index, L"fox", options));
+
+  // Consecutive searches also find overlapping matches.
+  options.bMatchWholeWord = false;
+  EXPECT_EQ((std::vector<Hit>{{2, 15, 2}, {2, 17, 2}}),
+            FindAll(*index, L"aa", options));
+  options.bConsecutive = true;
+  EXPECT_EQ((std::vector<Hit>{{2, 15, 2}, {2, 16, 2}, {2, 17, 2}}),
+            FindAll(*index, L"aa", options));
+}
+
+TEST(CPDFTextIndexTest, Serialize) {
+  std::unique_ptr<CPDF_TextIndex> index = CreateIndex();
+  DataVector<uint8_t> data = index->Serialize();
+  std::unique_ptr<CPDF_TextIndex> loaded =
+      CPDF_TextIndex::Deserialize(data, kDocumentId, kPageCount);
+  ASSERT_TRUE(loaded);
+  EXPECT_EQ(index->CountPages(), loaded->CountPages());
+  EXPECT_EQ(data, loaded->Serialize());
+
+  CPDF_TextPageFind::Options options;
+  EXPECT_EQ(FindAll(*index, L"fox", options),
+            FindAll(*loaded, L"fox", options));
+}
+
+TEST(CPDFTextIndexTest, DeserializeInvalid) {
+  DataVector<uint8_t> data = CreateIndex()->Serialize();
+  EXPECT_FALSE(CPDF_TextIndex::Deserialize({}, kDocumentId, kPageCount));
+
+  // Truncated.
+  for (size_t size = 0; size < data.size(); ++size) {
+    EXPECT_FALSE(CPDF_TextIndex::Deserialize(pdfium::span(data).first(size),
+                                             kDocumentId, kPageCount))
+        << size;
+  }
+
+  // Trailing data.
+  DataVector<uint8_t> longer = data;
+  longer.push_back(0);
+  EXPECT_FALSE(CPDF_TextIndex::Deserialize(longer, kDocumentId, kPageCount));
+
+  // Bad signature.
+  DataVector<uint8_t> bad_signature = data;
+  bad_signature[0] = 'X';
+  EXPECT_FALSE(
+      CPDF_TextIndex::Deserialize(bad_signature, kDocumentId, kPageCount));
+
+  // Unknown version.
+  DataVector<uint8_t> bad_version = data;
+  bad_version[4] = 2;
+  EXPECT_FALSE(
+      CPDF_TextIndex::Deserialize(bad_version, kDocumentId, kPageCount));
+
+  // Page count larger than the data.
+  const uint8_t kHugePageCount[] = {'P', 'T', 'X', 'I', 1,   3,
+                                    'd', 'o', 'c', 0xff, 0xff, 0x03};
+  EXPECT_FALSE(CPDF_TextIndex::Deserialize(kHugePageCount, kDocumentId,
+                                           /*page_count=*/0xffff));
+
+  // Char segments that do not cover the text exactly.
+  const std::vector<DataVector<TextPageCharSegment>> kBadSegments = {
+      {},
+      {{0, 2}},
+      {{0, 4}},
+      {{0, 2}, {5, 2}},
+      {{0, 3}, {5, 0x7fffffff}},
+      {{0, 0x7fffffff}, {5, 0x7fffffff}, {9, 2}},
+      {{0x7fffffff, 3}},
+  };
+  for (const auto& segments : kBadSegments) {
+    std::vector<CPDF_TextIndex::Page> pages;
+    pages.push_back({.text = L"abc", .char_segments = segments});
+    DataVector<uint8_t> bad_segments =
+        CPDF_TextIndex(kDocumentId, std::move(pages)).Serialize();
+    EXPECT_FALSE(CPDF_TextIndex::Deserialize(bad_segments, kDocumentId,
+                                             /*page_count=*/1));
+  }
+}
+
+TEST(CPDFTextIndexTest, DeserializeOtherDocument) {
+  DataVector<uint8_t> data = CreateIndex()->Serialize();
+  EXPECT_FALSE(CPDF_TextIndex::Deserialize(data, "other", kPageCount));
+  EXPECT_FALSE(CPDF_TextIndex::Deserialize(data, "", kPageCount));
+  EXPECT_FALSE(CPDF_TextIndex::Deserialize(data, kDocumentId, kPageCount - 1));
+  EXPECT_FALSE(CPDF_TextIndex::Deserialize(data, kDocumentId, kPageCount + 1));
+  EXPECT_TRUE(CPDF_TextIndex::Deserialize(data, kDocumentId, kPageCount));
+}
@@ -18,6 +18,7 @@
 #include "core/fxcrt/data_vector.h"
 #include "core/fxcrt/fx_coordinates.h"
 #include "core/fxcrt/fx_memory_wrappers.h"
+#include "core/fxcrt/span.h"
 #include "core/fxcrt/unowned_ptr.h"
 #include "core/fxcrt/widestring.h"
 #include "core/fxcrt/widetext_buffer.h"
@@ -90,6 +91,12 @@ class CPDF_TextPage {
 
   int CharIndexFromTextIndex(int text_index) const;
   int TextIndexFromCharIndex(int char_index) const;
+
+  // Runs of characters that map to consecutive text indices, in the order of
+  // the page text. See CharIndexFromTextIndex().
+  pdfium::span<const TextPageCharSegment> GetCharSegments() const {
+    return char_indices_;
+  }
   size_t size() const { return char_list_.size(); }
   int CountChars() const;
 
@@ -125,7 +125,7 @@ std::optional<WideString> ExtractSubString(const wchar_t* lpszFullString,
   });
 }
 
-std::vector<WideString> ExtractFindWhat(const WideString& findwhat) {
+std::vector<WideString> SplitFindWhat(const WideString& findwhat) {
   std::vector<WideString> findwhat_array;
 
   size_t len = findwhat.GetLength();
@@ -188,66 +188,43 @@ std::vector<WideString> ExtractFindWhat(const WideString& findwhat) {
 }  // namespace
 
 // static
-std::unique_ptr<CPDF_TextPageFind> CPDF_TextPageFind::Create(
-    const CPDF_TextPage* pTextPage,
+std::vector<WideString> CPDF_TextPageFind::ExtractFindWhat(
     const WideString& findwhat,
-    const Options& options,
-    std::optional<size_t> startPos) {
-  std::vector<WideString> findwhat_array =
-      ExtractFindWhat(GetStringCase(findwhat, options.bMatchCase));
-  auto find = pdfium::WrapUnique(
-      new CPDF_TextPageFind(pTextPage, findwhat_array, options, startPos));
-  find->FindFirst();
-  return find;
+    const Options& options) {
+  return SplitFindWhat(GetStringCase(findwhat, options.bMatchCase));
 }
 
-CPDF_TextPageFind::CPDF_TextPageFind(
-    const CPDF_TextPage* pTextPage,
-    const std::vector<WideString>& findwhat_array,
-    const Options& options,
-    std::optional<size_t> startPos)
-    : text_page_(pTextPage),
-      str_text_(GetStringCase(pTextPage->GetAllPageText(), options.bMatchCase)),
-      find_what_array_(findwhat_array),
-      options_(options) {
-  if (!str_text_.IsEmpty()) {
-    find_next_start_ = startPos;
-    find_pre_start_ = startPos.value_or(str_text_.GetLength() - 1);
-  }
-}
-
-CPDF_TextPageFind::~CPDF_TextPageFind() = default;
-
-int CPDF_TextPageFind::GetCharIndex(int index) const {
-  return text_page_->CharIndexFromTextIndex(index);
-}
-
-bool CPDF_TextPageFind::FindFirst() {
-  return str_text_.IsEmpty() || !find_what_array_.empty();
+// static
+WideString CPDF_TextPageFind::GetTextCase(const WideString& text,
+                                          const Options& options) {
+  return GetStringCase(text, options.bMatchCase);
 }
 
-bool CPDF_TextPageFind::FindNext() {
-  if (str_text_.IsEmpty() || !find_next_start_.has_value()) {
-    return false;
-  }
-
-  const size_t strLen = str_text_.GetLength();
-  size_t nStartPos = find_next_start_.value();
+// static
+bool CPDF_TextPageFind::FindNextInText(
+    const WideString& str_text,
+    const std::vector<WideString>& find_what_array,
+    bool match_whole_word,
+    size_t start_pos,
+    int& res_start,
+    int& res_end) {
+  const size_t strLen = str_text.GetLength();
+  size_t nStartPos = start_pos;
   if (nStartPos >= strLen) {
     return false;
   }
 
-  int nCount = fxcrt::CollectionSize<int>(find_what_array_);
+  int nCount = fxcrt::CollectionSize<int>(find_what_array);
   std::optional<size_t> nResultPos = 0;
   bool bSpaceStart = false;
   for (int iWord = 0; iWord < nCount; iWord++) {
-    WideString csWord = find_what_array_[iWord];
+    WideString csWord = find_what_array[iWord];
     if (csWord.IsEmpty()) {
       if (iWord == nCount - 1) {
         if (nStartPos >= strLen) {
           return false;
         }
-        wchar_t strInsert = str_text_[nStartPos];
+        wchar_t strInsert = str_text[nStartPos];
         if (strInsert == L'\n' || strInsert == L' ' || strInsert == L'\r' ||
             strInsert == kNonBreakingSpace) {
           nResultPos = nStartPos + 1;
@@ -259,20 +236,20 @@ bool CPDF_TextPageFind::FindNext() {
       }
       continue;
     }
-    nResultPos = str_text_.Find(csWord.AsStringView(), nStartPos);
+    nResultPos = str_text.Find(csWord.AsStringView(), nStartPos);
     if (!nResultPos.has_value()) {
       return false;
     }
 
     size_t endIndex = nResultPos.value() + csWord.GetLength() - 1;
     if (iWord == 0) {
-      res_start_ = nResultPos.value();
+      res_start = nResultPos.value();
     }
     bool bMatch = true;
     if (iWord != 0 && !bSpaceStart) {
       size_t PreResEndPos = nStartPos;
       int curChar = csWord[0];
-      WideString lastWord = find_what_array_[iWord - 1];
+      WideString lastWord = find_what_array[iWord - 1];
       int lastChar = lastWord.Back();
       if (nStartPos == nResultPos.value() &&
           !(IsIgnoreSpaceCharacter(lastChar) ||
@@ -280,7 +257,7 @@ bool CPDF_TextPageFind::FindNext() {
         bMatch = false;
       }
       for (size_t d = PreResEndPos; d < nResultPos.value(); d++) {
-        wchar_t strInsert = str_text_[d];
+        wchar_t strInsert = str_text[d];
         if (strInsert != L'\n' && strInsert != L' ' && strInsert != L'\r' &&
             strInsert != kNonBreakingSpace) {
           bMatch = false;
@@ -289,18 +266,18 @@ bool CPDF_TextPageFind::FindNext() {
       }
     } else if (bSpaceStart) {
       if (nResultPos.value() > 0) {
-        wchar_t strInsert = str_text_[nResultPos.value() - 1];
+        wchar_t strInsert = str_text[nResultPos.value() - 1];
         if (strInsert != L'\n' && strInsert != L' ' && strInsert != L'\r' &&
             strInsert != kNonBreakingSpace) {
           bMatch = false;
-          res_start_ = nResultPos.value();
+          res_start = nResultPos.value();
         } else {
-          res_start_ = nResultPos.value() - 1;
+          res_start = nResultPos.value() - 1;
         }
       }
     }
-    if (options_.bMatchWholeWord && bMatch) {
-      bMatch = IsMatchWholeWord(str_text_, nResultPos.value(), endIndex);
+    if (match_whole_word && bMatch) {
+      bMatch = IsMatchWholeWord(str_text, nResultPos.value(), endIndex);
     }
 
     if (bMatch) {
@@ -308,10 +285,60 @@ bool CPDF_TextPageFind::FindNext() {
     } else {
       iWord = -1;
       size_t index = bSpaceStart ? 1 : 0;
-      nStartPos = res_start_ + find_what_array_[index].GetLength();
+      nStartPos = res_start + find_what_array[index].GetLength();
     }
   }
-  res_end_ = nResultPos.value() + find_what_array_.back().GetLength() - 1;
+  res_end = nResultPos.value() + find_what_array.back().GetLength() - 1;
+  return true;
+}
+
+// static
+std::unique_ptr<CPDF_TextPageFind> CPDF_TextPageFind::Create(
+    const CPDF_TextPage* pTextPage,
+    const WideString& findwhat,
+    const Options& options,
+    std::optional<size_t> startPos) {
+  std::vector<WideString> findwhat_array = ExtractFindWhat(findwhat, options);
+  auto find = pdfium::WrapUnique(
+      new CPDF_TextPageFind(pTextPage, findwhat_array, options, startPos));
+  find->FindFirst();
+  return find;
+}
+
+CPDF_TextPageFind::CPDF_TextPageFind(
+    const CPDF_TextPage* pTextPage,
+    const std::vector<WideString>& findwhat_array,
+    const Options& options,
+    std::optional<size_t> startPos)
+    : text_page_(pTextPage),
+      str_text_(GetStringCase(pTextPage->GetAllPageText(), options.bMatchCase)),
+      find_what_array_(findwhat_array),
+      options_(options) {
+  if (!str_text_.IsEmpty()) {
+    find_next_start_ = startPos;
+    find_pre_start_ = startPos.value_or(str_text_.GetLength() - 1);
+  }
+}
+
+CPDF_TextPageFind::~CPDF_TextPageFind() = default;
+
+int CPDF_TextPageFind::GetCharIndex(int index) const {
+  return text_page_->CharIndexFromTextIndex(index);
+}
+
+bool CPDF_TextPageFind::FindFirst() {
+  return str_text_.IsEmpty() || !find_what_array_.empty();
+}
+
+bool CPDF_TextPageFind::FindNext() {
+  if (str_text_.IsEmpty() || !find_next_start_.has_value()) {
+    return false;
+  }
+
+  if (!FindNextInText(str_text_, find_what_array_, options_.bMatchWholeWord,
+                      find_next_start_.value(), res_start_, res_end_)) {
+    return false;
+  }
   if (options_.bConsecutive) {
     find_next_start_ = res_start_ + 1;
     find_pre_start_ = res_end_ - 1;
@@ -33,6 +33,26 @@ class CPDF_TextPageFind {
       const Options& options,
       std::optional<size_t> startPos);
 
+  // Splits `findwhat` into the words that get matched in turn, in the case
+  // that `options` require.
+  static std::vector<WideString> ExtractFindWhat(const WideString& findwhat,
+                                                 const Options& options);
+
+  // Returns `text` in the case that `options` require.
+  static WideString GetTextCase(const WideString& text, const Options& options);
+
+  // Finds the first match of `find_what_array`, as returned by
+  // ExtractFindWhat(), at or after text index `start_pos` of `text`, as
+  // returned by GetTextCase(). On success, sets `res_start` and `res_end` to
+  // the text indices of the first and last matched characters. On failure,
+  // `res_start` may still change.
+  static bool FindNextInText(const WideString& text,
+                             const std::vector<WideString>& find_what_array,
+                             bool match_whole_word,
+                             size_t start_pos,
+                             int& res_start,
+                             int& res_end);
+
   ~CPDF_TextPageFind();
 
   bool FindNext();
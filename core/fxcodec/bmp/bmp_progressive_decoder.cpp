@@ -14,6 +14,8 @@ namespace fxcodec {
 
 namespace {
 
+// Only set during library initialization and teardown. The decoder keeps its
+// state in the contexts it creates, so threads can share it.
 BmpProgressiveDecoder* g_bmp_decoder = nullptr;
 
 }  // namespace
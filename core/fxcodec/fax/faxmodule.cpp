@@ -13,6 +13,7 @@
 #include <iterator>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "build/build_config.h"
 #include "core/fxcodec/scanlinedecoder.h"
@@ -27,7 +28,6 @@
 #include "core/fxcrt/numerics/safe_conversions.h"
 #include "core/fxcrt/raw_span.h"
 #include "core/fxcrt/span.h"
-#include "core/fxcrt/span_util.h"
 #include "core/fxge/calculate_pitch.h"
 
 #if BUILDFLAG(IS_WIN)
@@ -38,130 +38,152 @@ namespace fxcodec {
 
 namespace {
 
-constexpr std::array<const uint8_t, 256> kOneLeadPos = {{
-    8, 7, 6, 6, 5, 5, 5, 5, 4, 4, 4, 4, 4, 4, 4, 4, 3, 3, 3, 3, 3, 3, 3, 3,
-    3, 3, 3, 3, 3, 3, 3, 3, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1,
-    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-    1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-}};
-
 // Limit of image dimension. Use the same limit as the JBIG2 codecs.
 constexpr int kFaxMaxImageDimension = 65535;
 
 constexpr int kFaxBpc = 1;
 constexpr int kFaxComps = 1;
 
-int FindBit(pdfium::span<const uint8_t> data_buf,
-            int max_pos,
-            int start_pos,
-            bool bit) {
-  DCHECK(start_pos >= 0);
-  if (start_pos >= max_pos) {
-    return max_pos;
-  }
-
-  const uint8_t bit_xor = bit ? 0x00 : 0xff;
-  int bit_offset = start_pos % 8;
-  if (bit_offset) {
-    const int byte_pos = start_pos / 8;
-    uint8_t data = (data_buf[byte_pos] ^ bit_xor) & (0xff >> bit_offset);
-    if (data) {
-      return byte_pos * 8 + kOneLeadPos[data];
+// Run length codes are up to `kFaxRunMaxBits` long. They are looked up with
+// their first `kFaxRunPrimaryBits` bits, and longer codes continue into a
+// second level table indexed by the remaining bits.
+constexpr int kFaxRunMaxBits = 13;
+constexpr int kFaxRunPrimaryBits = 9;
+constexpr int kFaxRunSecondaryBits = kFaxRunMaxBits - kFaxRunPrimaryBits;
+constexpr size_t kFaxRunMaxSecondaryTables = 32;
+
+// Mode codes are up to 7 bits long. See TABLE 1/T.6 "Code table" in ITU-T
+// T.6.
+constexpr int kFaxModeBits = 7;
+
+// Returns the `count` bits at `bitpos`, with the first one as the most
+// significant bit. Bits past the end of `src_buf` read as 0.
+uint32_t PeekBits(pdfium::span<const uint8_t> src_buf, int bitpos, int count) {
+  DCHECK_GE(bitpos, 0);
+  DCHECK_LE(count, 17);
+  const size_t byte_pos = bitpos / 8;
+  uint32_t data = 0;
+  if (byte_pos + 3 <= src_buf.size()) {
+    data = src_buf[byte_pos] << 16 | src_buf[byte_pos + 1] << 8 |
+           src_buf[byte_pos + 2];
+  } else {
+    for (size_t i = byte_pos; i < byte_pos + 3; ++i) {
+      data = data << 8 | (i < src_buf.size() ? src_buf[i] : 0);
     }
-    start_pos += 7;
   }
+  return (data >> (24 - bitpos % 8 - count)) & ((1u << count) - 1);
+}
 
-  const int max_byte = (max_pos + 7) / 8;
-  int byte_pos = start_pos / 8;
+bool NextBit(pdfium::span<const uint8_t> src_buf, int* bitpos) {
+  int pos = (*bitpos)++;
+  return !!(src_buf[pos / 8] & (1 << (7 - pos % 8)));
+}
 
-  // Try reading in bigger chunks in case there are long runs to be skipped.
-  static constexpr int kBulkReadSize = 8;
-  if (max_byte >= kBulkReadSize && byte_pos < max_byte - kBulkReadSize) {
-    static constexpr uint8_t skip_block_0[kBulkReadSize] = {
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
-    static constexpr uint8_t skip_block_1[kBulkReadSize] = {
-        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
-    const uint8_t* skip_block = bit ? skip_block_0 : skip_block_1;
-    while (byte_pos < max_byte - kBulkReadSize &&
-           UNSAFE_TODO(
-               memcmp(data_buf.subspan(static_cast<size_t>(byte_pos)).data(),
-                      skip_block, kBulkReadSize)) == 0) {
-      byte_pos += kBulkReadSize;
-    }
+// Sets the bits from `startpos` to `endpos` to `value`.
+void FaxFillBits(pdfium::span<uint8_t> dest_buf,
+                 int startpos,
+                 int endpos,
+                 bool value) {
+  DCHECK_GE(startpos, 0);
+  DCHECK_LT(startpos, endpos);
+  const size_t first_byte = startpos / 8;
+  const size_t last_byte = (endpos - 1) / 8;
+  auto fill_mask = [value](uint8_t& byte, uint8_t mask) {
+    byte = value ? byte | mask : byte & ~mask;
+  };
+  // The bits from `startpos` to the end of its byte, and from the start of
+  // the last byte to `endpos`.
+  const uint8_t first_mask = 0xff >> (startpos % 8);
+  const uint8_t last_mask = 0xff << (7 - (endpos - 1) % 8);
+  if (first_byte == last_byte) {
+    fill_mask(dest_buf[first_byte], first_mask & last_mask);
+    return;
   }
+  fill_mask(dest_buf[first_byte], first_mask);
+  fill_mask(dest_buf[last_byte], last_mask);
+  std::ranges::fill(
+      dest_buf.subspan(first_byte + 1, last_byte - first_byte - 1),
+      value ? 0xff : 0);
+}
 
-  while (byte_pos < max_byte) {
-    uint8_t data = data_buf[byte_pos] ^ bit_xor;
-    if (data) {
-      return std::min(byte_pos * 8 + kOneLeadPos[data], max_pos);
-    }
-    ++byte_pos;
+// Rows are kept as their changing elements, i.e. the start and end positions
+// of their black runs in increasing order. This is what 2D coding refers to,
+// so decoding a row never has to scan its reference row for b1 and b2.
+void AddBlackRun(std::vector<int>* changes,
+                 int columns,
+                 int startpos,
+                 int endpos) {
+  startpos = std::max(startpos, 0);
+  endpos = std::clamp(endpos, 0, columns);
+  if (startpos >= endpos) {
+    return;
   }
-  return max_pos;
+  if (!changes->empty() && changes->back() == startpos) {
+    changes->back() = endpos;
+    return;
+  }
+  DCHECK(changes->empty() || changes->back() < startpos);
+  changes->push_back(startpos);
+  changes->push_back(endpos);
+}
+
+// Turns the changing elements of a decoded row into a reference row. Looking
+// up b1 and b2 may read up to two elements past its last black run.
+void FinishReferenceRow(std::vector<int>* changes, int columns) {
+  changes->push_back(columns);
+  changes->push_back(columns);
 }
 
-void FaxG4FindB1B2(pdfium::span<const uint8_t> ref_buf,
+// Writes the row made of the black runs in `changes`, with black pixels as 1
+// bits if `black_is_1`, and as 0 bits otherwise.
+void FaxWriteRow(pdfium::span<const int> changes,
+                 bool black_is_1,
+                 pdfium::span<uint8_t> dest_buf) {
+  std::ranges::fill(dest_buf, black_is_1 ? 0 : 0xff);
+  for (size_t i = 0; i < changes.size(); i += 2) {
+    FaxFillBits(dest_buf, changes[i], changes[i + 1], black_is_1);
+  }
+}
+
+// `ref_index` is where the previous lookup on the same row stopped, which is
+// where this one starts, as `a0` only moves to the right.
+void FaxG4FindB1B2(pdfium::span<const int> ref_changes,
                    int columns,
                    int a0,
                    bool a0color,
+                   size_t* ref_index,
                    int* b1,
                    int* b2) {
-  bool first_bit = a0 < 0 || (ref_buf[a0 / 8] & (1 << (7 - a0 % 8))) != 0;
-  *b1 = FindBit(ref_buf, columns, a0 + 1, !first_bit);
-  if (*b1 >= columns) {
+  DCHECK_LT(a0, columns);
+  size_t index = *ref_index;
+  while (ref_changes[index] <= a0) {
+    ++index;
+  }
+  *ref_index = index;
+  if (ref_changes[index] >= columns) {
     *b1 = *b2 = columns;
     return;
   }
-  if (first_bit == !a0color) {
-    *b1 = FindBit(ref_buf, columns, *b1 + 1, first_bit);
-    first_bit = !first_bit;
+  // The reference row is white at `a0` if it has an even number of changing
+  // elements up to `a0`. If that color is not `a0color`, then the next
+  // changing element is to `a0color`, and b1 is the one after it.
+  const bool first_bit = index % 2 == 0;
+  if (first_bit != a0color) {
+    ++index;
   }
+  *b1 = ref_changes[index];
   if (*b1 >= columns) {
     *b1 = *b2 = columns;
     return;
   }
-  *b2 = FindBit(ref_buf, columns, *b1 + 1, first_bit);
-}
-
-void FaxFillBits(uint8_t* dest_buf, int columns, int startpos, int endpos) {
-  startpos = std::max(startpos, 0);
-  endpos = std::clamp(endpos, 0, columns);
-  if (startpos >= endpos) {
-    return;
-  }
-  int first_byte = startpos / 8;
-  int last_byte = (endpos - 1) / 8;
-  if (first_byte == last_byte) {
-    for (int i = startpos % 8; i <= (endpos - 1) % 8; ++i) {
-      UNSAFE_TODO(dest_buf[first_byte] -= 1 << (7 - i));
-    }
-    return;
-  }
-  for (int i = startpos % 8; i < 8; ++i) {
-    UNSAFE_TODO(dest_buf[first_byte] -= 1 << (7 - i));
-  }
-  for (int i = 0; i <= (endpos - 1) % 8; ++i) {
-    UNSAFE_TODO(dest_buf[last_byte] -= 1 << (7 - i));
-  }
-  if (last_byte > first_byte + 1) {
-    UNSAFE_TODO(
-        FXSYS_memset(dest_buf + first_byte + 1, 0, last_byte - first_byte - 1));
-  }
+  *b2 = ref_changes[index + 1];
 }
 
-inline bool NextBit(const uint8_t* src_buf, int* bitpos) {
-  int pos = (*bitpos)++;
-  return !!UNSAFE_TODO((src_buf[pos / 8] & (1 << (7 - pos % 8))));
-}
+// Tables of run length codes, as groups of codes with the same length,
+// starting from 1 bit codes. Each group has the number of codes, followed by
+// the code, and the run length as 2 bytes, for each code.
 
-const uint8_t kFaxBlackRunIns[] = {
+constexpr auto kFaxBlackRunIns = std::to_array<uint8_t>({
     0,          2,          0x02,       3,          0,          0x03,
     2,          0,          2,          0x02,       1,          0,
     0x03,       4,          0,          2,          0x02,       6,
@@ -216,9 +238,9 @@ const uint8_t kFaxBlackRunIns[] = {
     576 / 256,  0x72,       896 % 256,  896 / 256,  0x73,       960 % 256,
     960 / 256,  0x74,       1024 % 256, 1024 / 256, 0x75,       1088 % 256,
     1088 / 256, 0x76,       1152 % 256, 1152 / 256, 0x77,       1216 % 256,
-    1216 / 256, 0xff};
+    1216 / 256, 0xff});
 
-const uint8_t kFaxWhiteRunIns[] = {
+constexpr auto kFaxWhiteRunIns = std::to_array<uint8_t>({
     0,          0,          0,          6,          0x07,       2,
     0,          0x08,       3,          0,          0x0B,       4,
     0,          0x0C,       5,          0,          0x0E,       6,
@@ -274,90 +296,203 @@ const uint8_t kFaxWhiteRunIns[] = {
     0x1c,       2368 % 256, 2368 / 256, 0x1d,       2432 % 256, 2432 / 256,
     0x1e,       2496 % 256, 2496 / 256, 0x1f,       2560 % 256, 2560 / 256,
     0xff,
+});
+
+struct FaxRunCode {
+  uint16_t run;
+  // Length of the code, or 0 if it is invalid or continues in `next`.
+  uint8_t bits;
+  // 1 + the index of the second level table for longer codes, or 0.
+  uint8_t next;
 };
 
-int FaxGetRun(pdfium::span<const uint8_t> ins_array,
-              const uint8_t* src_buf,
-              int* bitpos,
-              int bitsize) {
-  uint32_t code = 0;
-  int ins_off = 0;
-  while (true) {
-    uint8_t ins = ins_array[ins_off++];
-    if (ins == 0xff) {
-      return -1;
-    }
+struct FaxRunTable {
+  std::array<FaxRunCode, 1 << kFaxRunPrimaryBits> primary;
+  std::array<FaxRunCode, kFaxRunMaxSecondaryTables << kFaxRunSecondaryBits>
+      secondary;
+  // The number of bits consumed by an invalid code.
+  int max_bits;
+};
 
-    if (*bitpos >= bitsize) {
-      return -1;
-    }
+template <size_t N>
+constexpr FaxRunTable BuildFaxRunTable(const std::array<uint8_t, N>& ins) {
+  FaxRunTable table = {};
+  size_t secondary_tables = 0;
+  size_t offset = 0;
+  int bits = 1;
+  // Shorter codes come first, and take precedence over longer ones with the
+  // same prefix, as do earlier codes with the same length.
+  for (; ins[offset] != 0xff; ++bits) {
+    const size_t count = ins[offset++];
+    for (size_t i = 0; i < count; ++i, offset += 3) {
+      const uint32_t code = ins[offset];
+      const FaxRunCode entry = {
+          .run = static_cast<uint16_t>(ins[offset + 1] + ins[offset + 2] * 256),
+          .bits = static_cast<uint8_t>(bits),
+          .next = 0};
+      if (bits <= kFaxRunPrimaryBits) {
+        const int shift = kFaxRunPrimaryBits - bits;
+        for (uint32_t j = code << shift; j < (code + 1) << shift; ++j) {
+          if (!table.primary[j].bits) {
+            table.primary[j] = entry;
+          }
+        }
+        continue;
+      }
 
-    code <<= 1;
-    UNSAFE_TODO({
-      if (src_buf[*bitpos / 8] & (1 << (7 - *bitpos % 8))) {
-        ++code;
+      FaxRunCode& primary = table.primary[code >> (bits - kFaxRunPrimaryBits)];
+      if (primary.bits) {
+        continue;
       }
-    });
-    ++(*bitpos);
-    int next_off = ins_off + ins * 3;
-    for (; ins_off < next_off; ins_off += 3) {
-      if (ins_array[ins_off] == code) {
-        return ins_array[ins_off + 1] + ins_array[ins_off + 2] * 256;
+      if (!primary.next) {
+        primary.next = static_cast<uint8_t>(++secondary_tables);
       }
+      const size_t base = size_t{primary.next - 1u} << kFaxRunSecondaryBits;
+      const int shift = kFaxRunMaxBits - bits;
+      const uint32_t suffix = code & ((1u << (bits - kFaxRunPrimaryBits)) - 1);
+      for (uint32_t j = suffix << shift; j < (suffix + 1) << shift; ++j) {
+        if (!table.secondary[base + j].bits) {
+          table.secondary[base + j] = entry;
+        }
+      }
+    }
+  }
+  table.max_bits = bits - 1;
+  return table;
+}
+
+constexpr FaxRunTable kFaxBlackRuns = BuildFaxRunTable(kFaxBlackRunIns);
+constexpr FaxRunTable kFaxWhiteRuns = BuildFaxRunTable(kFaxWhiteRunIns);
+
+// Returns the run length of the code at `bitpos`, or -1 if it is invalid or
+// truncated.
+int FaxGetRun(const FaxRunTable& table,
+              pdfium::span<const uint8_t> src_buf,
+              int bitsize,
+              int* bitpos) {
+  if (*bitpos >= bitsize) {
+    return -1;
+  }
+
+  const uint32_t bits = PeekBits(src_buf, *bitpos, kFaxRunMaxBits);
+  FaxRunCode code = table.primary[bits >> kFaxRunSecondaryBits];
+  if (code.next) {
+    code = table.secondary[(size_t{code.next - 1u} << kFaxRunSecondaryBits) |
+                           (bits & ((1u << kFaxRunSecondaryBits) - 1))];
+  }
+  if (!code.bits || code.bits > bitsize - *bitpos) {
+    *bitpos = std::min(bitsize, *bitpos + table.max_bits);
+    return -1;
+  }
+  *bitpos += code.bits;
+  return code.run;
+}
+
+// Returns the total of the makeup codes at `bitpos` and the terminating code
+// that follows them.
+int FaxGetRunLength(const FaxRunTable& table,
+                    pdfium::span<const uint8_t> src_buf,
+                    int bitsize,
+                    int* bitpos) {
+  int run_len = 0;
+  while (true) {
+    int run = FaxGetRun(table, src_buf, bitsize, bitpos);
+    run_len += run;
+    if (run < 64) {
+      return run_len;
     }
   }
 }
 
-void FaxG4GetRow(const uint8_t* src_buf,
+enum class FaxMode : uint8_t {
+  kPass,
+  kHorizontal,
+  kVertical,
+  kExtension,
+  // The first 7 bits of an EOL code.
+  kEndOfLine,
+};
+
+struct FaxModeCode {
+  FaxMode mode;
+  uint8_t bits;
+  int8_t v_delta;
+};
+
+constexpr std::array<FaxModeCode, 1 << kFaxModeBits> BuildFaxModeTable() {
+  struct ModeCode {
+    uint8_t code;
+    FaxModeCode entry;
+  };
+  constexpr ModeCode kModeCodes[] = {
+      {0b1, {FaxMode::kVertical, 1, 0}},
+      {0b011, {FaxMode::kVertical, 3, 1}},
+      {0b010, {FaxMode::kVertical, 3, -1}},
+      {0b001, {FaxMode::kHorizontal, 3, 0}},
+      {0b0001, {FaxMode::kPass, 4, 0}},
+      {0b000011, {FaxMode::kVertical, 6, 2}},
+      {0b000010, {FaxMode::kVertical, 6, -2}},
+      {0b0000011, {FaxMode::kVertical, 7, 3}},
+      {0b0000010, {FaxMode::kVertical, 7, -3}},
+      {0b0000001, {FaxMode::kExtension, 7, 0}},
+      {0b0000000, {FaxMode::kEndOfLine, 7, 0}},
+  };
+  std::array<FaxModeCode, 1 << kFaxModeBits> table = {};
+  for (const ModeCode& mode_code : kModeCodes) {
+    const int shift = kFaxModeBits - mode_code.entry.bits;
+    for (uint32_t j = mode_code.code << shift;
+         j < (mode_code.code + 1u) << shift; ++j) {
+      table[j] = mode_code.entry;
+    }
+  }
+  return table;
+}
+
+constexpr std::array<FaxModeCode, 1 << kFaxModeBits> kFaxModeCodes =
+    BuildFaxModeTable();
+
+// Decodes a 2D coded row against the reference row `ref_changes`, and adds
+// its black runs to `changes`.
+void FaxG4GetRow(pdfium::span<const uint8_t> src_buf,
                  int bitsize,
                  int* bitpos,
-                 uint8_t* dest_buf,
-                 pdfium::span<const uint8_t> ref_buf,
-                 int columns) {
-  // See TABLE 1/T.6 "Code table" in ITU-T T.6.
+                 pdfium::span<const int> ref_changes,
+                 int columns,
+                 std::vector<int>* changes) {
   int a0 = -1;
   bool a0color = true;
+  size_t ref_index = 0;
   while (true) {
     if (*bitpos >= bitsize) {
       return;
     }
 
-    int a1;
-    int a2;
     int b1;
     int b2;
-    FaxG4FindB1B2(ref_buf, columns, a0, a0color, &b1, &b2);
+    FaxG4FindB1B2(ref_changes, columns, a0, a0color, &ref_index, &b1, &b2);
 
-    int v_delta = 0;
-    if (!NextBit(src_buf, bitpos)) {
-      if (*bitpos >= bitsize) {
-        return;
-      }
-
-      bool bit1 = NextBit(src_buf, bitpos);
-      if (*bitpos >= bitsize) {
-        return;
-      }
+    const FaxModeCode& mode =
+        kFaxModeCodes[PeekBits(src_buf, *bitpos, kFaxModeBits)];
+    if (mode.bits > bitsize - *bitpos) {
+      *bitpos = bitsize;
+      return;
+    }
+    *bitpos += mode.bits;
 
-      bool bit2 = NextBit(src_buf, bitpos);
-      if (bit1) {
-        // Mode "Vertical", VR(1), VL(1).
-        v_delta = bit2 ? 1 : -1;
-      } else if (bit2) {
-        // Mode "Horizontal".
-        int run_len1 = 0;
-        while (true) {
-          int run = FaxGetRun(
-              a0color ? pdfium::span<const uint8_t, pdfium::dynamic_extent>(
-                            kFaxWhiteRunIns)
-                      : pdfium::span<const uint8_t, pdfium::dynamic_extent>(
-                            kFaxBlackRunIns),
-              src_buf, bitpos, bitsize);
-          run_len1 += run;
-          if (run < 64) {
-            break;
-          }
+    switch (mode.mode) {
+      case FaxMode::kPass:
+        if (!a0color) {
+          AddBlackRun(changes, columns, a0, b2);
+        }
+        if (b2 >= columns) {
+          return;
         }
+        a0 = b2;
+        break;
+      case FaxMode::kHorizontal: {
+        int run_len1 =
+            FaxGetRunLength(a0color ? kFaxWhiteRuns : kFaxBlackRuns, src_buf,
+                            bitsize, bitpos);
         if (a0 < 0) {
           ++run_len1;
         }
@@ -365,114 +500,58 @@ void FaxG4GetRow(const uint8_t* src_buf,
           return;
         }
 
-        a1 = a0 + run_len1;
+        int a1 = a0 + run_len1;
         if (!a0color) {
-          FaxFillBits(dest_buf, columns, a0, a1);
+          AddBlackRun(changes, columns, a0, a1);
         }
 
-        int run_len2 = 0;
-        while (true) {
-          int run = FaxGetRun(
-              a0color ? pdfium::span<const uint8_t, pdfium::dynamic_extent>(
-                            kFaxBlackRunIns)
-                      : pdfium::span<const uint8_t, pdfium::dynamic_extent>(
-                            kFaxWhiteRunIns),
-              src_buf, bitpos, bitsize);
-          run_len2 += run;
-          if (run < 64) {
-            break;
-          }
-        }
+        int run_len2 =
+            FaxGetRunLength(a0color ? kFaxBlackRuns : kFaxWhiteRuns, src_buf,
+                            bitsize, bitpos);
         if (run_len2 < 0) {
           return;
         }
-        a2 = a1 + run_len2;
+        int a2 = a1 + run_len2;
         if (a0color) {
-          FaxFillBits(dest_buf, columns, a1, a2);
+          AddBlackRun(changes, columns, a1, a2);
         }
 
         a0 = a2;
-        if (a0 < columns) {
-          continue;
-        }
-
-        return;
-      } else {
-        if (*bitpos >= bitsize) {
+        if (a0 >= columns) {
           return;
         }
-
-        if (NextBit(src_buf, bitpos)) {
-          // Mode "Pass".
-          if (!a0color) {
-            FaxFillBits(dest_buf, columns, a0, b2);
-          }
-
-          if (b2 >= columns) {
-            return;
-          }
-
-          a0 = b2;
-          continue;
+        break;
+      }
+      case FaxMode::kVertical: {
+        int a1 = b1 + mode.v_delta;
+        if (!a0color) {
+          AddBlackRun(changes, columns, a0, a1);
         }
 
-        if (*bitpos >= bitsize) {
+        if (a1 >= columns) {
           return;
         }
 
-        bool next_bit1 = NextBit(src_buf, bitpos);
-        if (*bitpos >= bitsize) {
+        // The position of picture element must be monotonic increasing.
+        if (a0 >= a1) {
           return;
         }
 
-        bool next_bit2 = NextBit(src_buf, bitpos);
-        if (next_bit1) {
-          // Mode "Vertical", VR(2), VL(2).
-          v_delta = next_bit2 ? 2 : -2;
-        } else if (next_bit2) {
-          if (*bitpos >= bitsize) {
-            return;
-          }
-
-          // Mode "Vertical", VR(3), VL(3).
-          v_delta = NextBit(src_buf, bitpos) ? 3 : -3;
-        } else {
-          if (*bitpos >= bitsize) {
-            return;
-          }
-
-          // Extension
-          if (NextBit(src_buf, bitpos)) {
-            *bitpos += 3;
-            continue;
-          }
-          *bitpos += 5;
-          return;
-        }
+        a0 = a1;
+        a0color = !a0color;
+        break;
       }
-    } else {
-      // Mode "Vertical", V(0).
-    }
-    a1 = b1 + v_delta;
-    if (!a0color) {
-      FaxFillBits(dest_buf, columns, a0, a1);
-    }
-
-    if (a1 >= columns) {
-      return;
-    }
-
-    // The position of picture element must be monotonic increasing.
-    if (a0 >= a1) {
-      return;
+      case FaxMode::kExtension:
+        *bitpos += 3;
+        break;
+      case FaxMode::kEndOfLine:
+        *bitpos += 5;
+        return;
     }
-
-    a0 = a1;
-    a0color = !a0color;
   }
 }
 
-void FaxSkipEOL(const uint8_t* src_buf, int bitsize, int* bitpos) {
+void FaxSkipEOL(pdfium::span<const uint8_t> src_buf, int bitsize, int* bitpos) {
   int startbit = *bitpos;
   while (*bitpos < bitsize) {
     if (!NextBit(src_buf, bitpos)) {
@@ -485,11 +564,12 @@ void FaxSkipEOL(const uint8_t* src_buf, int bitsize, int* bitpos) {
   }
 }
 
-void FaxGet1DLine(const uint8_t* src_buf,
+// Decodes a 1D coded row, and adds its black runs to `changes`.
+void FaxGet1DLine(pdfium::span<const uint8_t> src_buf,
                   int bitsize,
                   int* bitpos,
-                  uint8_t* dest_buf,
-                  int columns) {
+                  int columns,
+                  std::vector<int>* changes) {
   bool color = true;
   int startpos = 0;
   while (true) {
@@ -499,12 +579,8 @@ void FaxGet1DLine(const uint8_t* src_buf,
 
     int run_len = 0;
     while (true) {
-      int run =
-          FaxGetRun(color ? pdfium::span<const uint8_t, pdfium::dynamic_extent>(
-                                kFaxWhiteRunIns)
-                          : pdfium::span<const uint8_t, pdfium::dynamic_extent>(
-                                kFaxBlackRunIns),
-                    src_buf, bitpos, bitsize);
+      int run = FaxGetRun(color ? kFaxWhiteRuns : kFaxBlackRuns, src_buf,
+                          bitsize, bitpos);
       if (run < 0) {
         while (*bitpos < bitsize) {
           if (NextBit(src_buf, bitpos)) {
@@ -519,7 +595,7 @@ void FaxGet1DLine(const uint8_t* src_buf,
       }
     }
     if (!color) {
-      FaxFillBits(dest_buf, columns, startpos, startpos + run_len);
+      AddBlackRun(changes, columns, startpos, startpos + run_len);
     }
 
     startpos += run_len;
@@ -548,8 +624,6 @@ class FaxDecoder final : public ScanlineDecoder {
   uint32_t GetSrcOffset() override;
 
  private:
-  void InvertBuffer();
-
   const int encoding_;
   int bitpos_ = 0;
   bool byte_align_ = false;
@@ -557,7 +631,8 @@ class FaxDecoder final : public ScanlineDecoder {
   const bool black_;
   const pdfium::raw_span<const uint8_t> src_span_;
   DataVector<uint8_t> scanline_buf_;
-  DataVector<uint8_t> ref_buf_;
+  std::vector<int> changes_;
+  std::vector<int> ref_changes_;
 };
 
 FaxDecoder::FaxDecoder(pdfium::span<const uint8_t> src_span,
@@ -579,8 +654,7 @@ FaxDecoder::FaxDecoder(pdfium::span<const uint8_t> src_span,
       end_of_line_(EndOfLine),
       black_(BlackIs1),
       src_span_(src_span),
-      scanline_buf_(pitch_),
-      ref_buf_(pitch_) {}
+      scanline_buf_(pitch_) {}
 
 FaxDecoder::~FaxDecoder() {
   // Span in superclass can't outlive our buffer.
@@ -588,38 +662,41 @@ FaxDecoder::~FaxDecoder() {
 }
 
 bool FaxDecoder::Rewind() {
-  std::ranges::fill(ref_buf_, 0xff);
+  ref_changes_.clear();
+  FinishReferenceRow(&ref_changes_, orig_width_);
   bitpos_ = 0;
   return true;
 }
 
 pdfium::span<uint8_t> FaxDecoder::GetNextLine() {
   int bitsize = pdfium::checked_cast<int>(src_span_.size() * 8);
-  FaxSkipEOL(src_span_.data(), bitsize, &bitpos_);
+  FaxSkipEOL(src_span_, bitsize, &bitpos_);
   if (bitpos_ >= bitsize) {
     return pdfium::span<uint8_t>();
   }
 
-  std::ranges::fill(scanline_buf_, 0xff);
+  changes_.clear();
   if (encoding_ < 0) {
-    FaxG4GetRow(src_span_.data(), bitsize, &bitpos_, scanline_buf_.data(),
-                ref_buf_, orig_width_);
-    ref_buf_ = scanline_buf_;
+    FaxG4GetRow(src_span_, bitsize, &bitpos_, ref_changes_, orig_width_,
+                &changes_);
   } else if (encoding_ == 0) {
-    FaxGet1DLine(src_span_.data(), bitsize, &bitpos_, scanline_buf_.data(),
-                 orig_width_);
+    FaxGet1DLine(src_span_, bitsize, &bitpos_, orig_width_, &changes_);
   } else {
-    if (NextBit(src_span_.data(), &bitpos_)) {
-      FaxGet1DLine(src_span_.data(), bitsize, &bitpos_, scanline_buf_.data(),
-                   orig_width_);
+    if (NextBit(src_span_, &bitpos_)) {
+      FaxGet1DLine(src_span_, bitsize, &bitpos_, orig_width_, &changes_);
     } else {
-      FaxG4GetRow(src_span_.data(), bitsize, &bitpos_, scanline_buf_.data(),
-                  ref_buf_, orig_width_);
+      FaxG4GetRow(src_span_, bitsize, &bitpos_, ref_changes_, orig_width_,
+                  &changes_);
     }
-    ref_buf_ = scanline_buf_;
   }
+  FaxWriteRow(changes_, black_, scanline_buf_);
+  if (encoding_ != 0) {
+    FinishReferenceRow(&changes_, orig_width_);
+    std::swap(ref_changes_, changes_);
+  }
+
   if (end_of_line_) {
-    FaxSkipEOL(src_span_.data(), bitsize, &bitpos_);
+    FaxSkipEOL(src_span_, bitsize, &bitpos_);
   }
 
   if (byte_align_ && bitpos_ < bitsize) {
@@ -637,9 +714,6 @@ pdfium::span<uint8_t> FaxDecoder::GetNextLine() {
       bitpos_ = bitpos1;
     }
   }
-  if (black_) {
-    InvertBuffer();
-  }
   return scanline_buf_;
 }
 
@@ -648,14 +722,6 @@ uint32_t FaxDecoder::GetSrcOffset() {
       std::min<size_t>((bitpos_ + 7) / 8, src_span_.size()));
 }
 
-void FaxDecoder::InvertBuffer() {
-  auto byte_span = pdfium::span(scanline_buf_);
-  auto data = fxcrt::reinterpret_span<uint32_t>(byte_span);
-  for (auto& datum : data) {
-    datum = ~datum;
-  }
-}
-
 }  // namespace
 
 // static
@@ -696,22 +762,89 @@ int FaxModule::FaxG4Decode(pdfium::span<const uint8_t> src_span,
                            uint8_t* dest_buf) {
   DCHECK(pitch != 0);
 
-  const uint8_t* src_buf = src_span.data();
-  uint32_t src_size = pdfium::checked_cast<uint32_t>(src_span.size());
-
-  DataVector<uint8_t> ref_buf(pitch, 0xff);
+  const uint32_t src_size = pdfium::checked_cast<uint32_t>(src_span.size());
+  std::vector<int> ref_changes;
+  FinishReferenceRow(&ref_changes, width);
+  std::vector<int> changes;
   int bitpos = starting_bitpos;
   for (int iRow = 0; iRow < height; ++iRow) {
-    uint8_t* line_buf = UNSAFE_TODO(dest_buf + iRow * pitch);
-    UNSAFE_TODO(FXSYS_memset(line_buf, 0xff, pitch));
-    FaxG4GetRow(src_buf, src_size << 3, &bitpos, line_buf, ref_buf, width);
-    UNSAFE_TODO(FXSYS_memcpy(ref_buf.data(), line_buf, pitch));
+    changes.clear();
+    FaxG4GetRow(src_span, src_size << 3, &bitpos, ref_changes, width,
+                &changes);
+    FaxWriteRow(changes, /*black_is_1=*/true,
+                UNSAFE_TODO(pdfium::span(dest_buf + iRow * pitch,
+                                         static_cast<size_t>(pitch))));
+    FinishReferenceRow(&changes, width);
+    std::swap(ref_changes, changes);
   }
   return bitpos;
 }
 
 #if BUILDFLAG(IS_WIN)
 namespace {
+constexpr std::array<const uint8_t, 256> kOneLeadPos = {{
+    8, 7, 6, 6, 5, 5, 5, 5, 4, 4, 4, 4, 4, 4, 4, 4, 3, 3, 3, 3, 3, 3, 3, 3,
+    3, 3, 3, 3, 3, 3, 3, 3, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+}};
+
+int FindBit(pdfium::span<const uint8_t> data_buf,
+            int max_pos,
+            int start_pos,
+            bool bit) {
+  DCHECK(start_pos >= 0);
+  if (start_pos >= max_pos) {
+    return max_pos;
+  }
+
+  const uint8_t bit_xor = bit ? 0x00 : 0xff;
+  int bit_offset = start_pos % 8;
+  if (bit_offset) {
+    const int byte_pos = start_pos / 8;
+    uint8_t data = (data_buf[byte_pos] ^ bit_xor) & (0xff >> bit_offset);
+    if (data) {
+      return byte_pos * 8 + kOneLeadPos[data];
+    }
+    start_pos += 7;
+  }
+
+  const int max_byte = (max_pos + 7) / 8;
+  int byte_pos = start_pos / 8;
+
+  // Try reading in bigger chunks in case there are long runs to be skipped.
+  static constexpr int kBulkReadSize = 8;
+  if (max_byte >= kBulkReadSize && byte_pos < max_byte - kBulkReadSize) {
+    static constexpr uint8_t skip_block_0[kBulkReadSize] = {
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+    static constexpr uint8_t skip_block_1[kBulkReadSize] = {
+        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+    const uint8_t* skip_block = bit ? skip_block_0 : skip_block_1;
+    while (byte_pos < max_byte - kBulkReadSize &&
+           UNSAFE_TODO(
+               memcmp(data_buf.subspan(static_cast<size_t>(byte_pos)).data(),
+                      skip_block, kBulkReadSize)) == 0) {
+      byte_pos += kBulkReadSize;
+    }
+  }
+
+  while (byte_pos < max_byte) {
+    uint8_t data = data_buf[byte_pos] ^ bit_xor;
+    if (data) {
+      return std::min(byte_pos * 8 + kOneLeadPos[data], max_pos);
+    }
+    ++byte_pos;
+  }
+  return max_pos;
+}
+
 const uint8_t BlackRunTerminator[128] = {
     0x37, 10, 0x02, 3,  0x03, 2,  0x02, 2,  0x03, 3,  0x03, 4,  0x02, 4,
     0x03, 5,  0x05, 6,  0x04, 6,  0x04, 7,  0x05, 7,  0x07, 7,  0x04, 8,
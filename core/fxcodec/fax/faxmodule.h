@@ -38,7 +38,8 @@ class FaxModule {
       int Columns,
       int Rows);
 
-  // Return the ending bit position.
+  // Decodes `height` rows of Group 4 data into `dest_buf`, with 1 bits for
+  // black pixels. Return the ending bit position.
   static int FaxG4Decode(pdfium::span<const uint8_t> src_buf,
                          int starting_bitpos,
                          int width,
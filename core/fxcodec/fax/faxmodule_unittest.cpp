@@ -0,0 +1,109 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxcodec/fax/faxmodule.h"
+
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "core/fxcodec/scanlinedecoder.h"
+#include "core/fxcrt/span.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+// Packs a string of '0' and '1' characters into bytes, ignoring spaces.
+std::vector<uint8_t> PackBits(const char* bits) {
+  std::vector<uint8_t> result;
+  int bitpos = 0;
+  for (; *bits; ++bits) {
+    if (*bits == ' ') {
+      continue;
+    }
+    if (bitpos % 8 == 0) {
+      result.push_back(0);
+    }
+    if (*bits == '1') {
+      result.back() |= 1 << (7 - bitpos % 8);
+    }
+    ++bitpos;
+  }
+  return result;
+}
+
+// Two 16 pixel rows with black pixels 3 and 4. The first row is in horizontal
+// mode: white 3, black 2, then V0. The second one is all V0 codes.
+constexpr char kTwoRowsG4[] = "001 1000 11 1  1 1 1";
+
+}  // namespace
+
+TEST(FaxModuleTest, G4Decode) {
+  const std::vector<uint8_t> src = PackBits(kTwoRowsG4);
+  std::vector<uint8_t> dest(8, 0xaa);
+  EXPECT_EQ(13, FaxModule::FaxG4Decode(src, 0, 16, 2, 4, dest.data()));
+  // Black pixels are 1 bits, and the ends of the rows are cleared.
+  EXPECT_EQ((std::vector<uint8_t>{0x18, 0, 0, 0, 0x18, 0, 0, 0}), dest);
+}
+
+TEST(FaxModuleTest, G4DecodeLongRun) {
+  // White 0, then black 128 + 2 with a 12 bit makeup code.
+  const std::vector<uint8_t> src =
+      PackBits("001 00110101 000011001000 11 1");
+  std::vector<uint8_t> dest(32, 0xaa);
+  EXPECT_EQ(26, FaxModule::FaxG4Decode(src, 0, 200, 1, 32, dest.data()));
+  for (size_t i = 0; i < 16; ++i) {
+    EXPECT_EQ(0xff, dest[i]) << i;
+  }
+  EXPECT_EQ(0xc0, dest[16]);
+  for (size_t i = 17; i < dest.size(); ++i) {
+    EXPECT_EQ(0, dest[i]) << i;
+  }
+}
+
+TEST(FaxModuleTest, G4DecodeTruncated) {
+  // A horizontal mode code without its runs.
+  const std::vector<uint8_t> src = PackBits("1 001");
+  std::vector<uint8_t> dest(8, 0xaa);
+  EXPECT_EQ(8, FaxModule::FaxG4Decode(src, 0, 16, 2, 4, dest.data()));
+  EXPECT_EQ(std::vector<uint8_t>(8, 0), dest);
+}
+
+TEST(FaxModuleTest, Decoder) {
+  const std::vector<uint8_t> src = PackBits(kTwoRowsG4);
+  for (bool black_is_1 : {false, true}) {
+    SCOPED_TRACE(black_is_1);
+    std::unique_ptr<ScanlineDecoder> decoder = FaxModule::CreateDecoder(
+        src, 16, 2, /*K=*/-1, /*EndOfLine=*/false, /*EncodedByteAlign=*/false,
+        black_is_1, /*Columns=*/0, /*Rows=*/0);
+    ASSERT_TRUE(decoder);
+    const uint8_t black = black_is_1 ? 0x18 : 0xe7;
+    const uint8_t white = black_is_1 ? 0 : 0xff;
+    for (int row = 0; row < 2; ++row) {
+      pdfium::span<const uint8_t> line = decoder->GetScanline(row);
+      ASSERT_EQ(4u, line.size());
+      EXPECT_EQ(black, line[0]);
+      EXPECT_EQ(white, line[1]);
+      EXPECT_EQ(white, line[2]);
+      EXPECT_EQ(white, line[3]);
+    }
+    EXPECT_EQ(2u, decoder->GetSrcOffset());
+  }
+}
+
+TEST(FaxModuleTest, Decoder1D) {
+  // White 3, black 2, white 11, for each row.
+  const std::vector<uint8_t> src = PackBits("1000 11 01000  1000 11 01000");
+  std::unique_ptr<ScanlineDecoder> decoder = FaxModule::CreateDecoder(
+      src, 16, 2, /*K=*/0, /*EndOfLine=*/false, /*EncodedByteAlign=*/false,
+      /*BlackIs1=*/false, /*Columns=*/0, /*Rows=*/0);
+  ASSERT_TRUE(decoder);
+  for (int row = 0; row < 2; ++row) {
+    pdfium::span<const uint8_t> line = decoder->GetScanline(row);
+    ASSERT_EQ(4u, line.size());
+    EXPECT_EQ(0xe7, line[0]);
+    EXPECT_EQ(0xff, line[1]);
+  }
+}
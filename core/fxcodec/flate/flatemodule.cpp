@@ -16,6 +16,7 @@
 #include <vector>
 
 #include "core/fxcodec/data_and_bytes_consumed.h"
+#include "core/fxcodec/flate/predictor_simd.h"
 #include "core/fxcodec/scanlinedecoder.h"
 #include "core/fxcrt/check.h"
 #include "core/fxcrt/data_vector.h"
@@ -104,10 +105,6 @@ bool FlateOutput(z_stream* context, pdfium::span<uint8_t> dest_span) {
   return ret;
 }
 
-uint32_t FlateGetAvailOut(z_stream* context) {
-  return context->avail_out;
-}
-
 void FlateEnd(z_stream* context) {
   inflateEnd(context);
   FX_Free(context);
@@ -307,36 +304,6 @@ bool CLZWDecoder::Decode() {
   return dest_byte_pos_ != 0;
 }
 
-uint8_t GetLeftValue(pdfium::span<const uint8_t> span,
-                     size_t i,
-                     uint32_t bytes_per_pixel) {
-  return i >= bytes_per_pixel ? span[i - bytes_per_pixel] : 0;
-}
-
-uint8_t GetUpValue(pdfium::span<const uint8_t> span, size_t i) {
-  return span.empty() ? 0 : span[i];
-}
-
-uint8_t GetUpperLeftValue(pdfium::span<const uint8_t> span,
-                          size_t i,
-                          uint32_t bytes_per_pixel) {
-  if (i >= bytes_per_pixel && !span.empty()) {
-    return span[i - bytes_per_pixel];
-  }
-  return 0;
-}
-
-uint8_t PathPredictor(uint8_t a, uint8_t b, uint8_t c) {
-  int p = static_cast<int>(a) + b - c;
-  int pa = abs(p - a);
-  int pb = abs(p - b);
-  int pc = abs(p - c);
-  if (pa <= pb && pa <= pc) {
-    return a;
-  }
-  return pb <= pc ? b : c;
-}
-
 void PNG_PredictLine(pdfium::span<uint8_t> dest_span,
                      pdfium::span<const uint8_t> src_span,
                      pdfium::span<const uint8_t> last_span,
@@ -347,35 +314,21 @@ void PNG_PredictLine(pdfium::span<uint8_t> dest_span,
       src_span.subspan(1u, row_size);
   switch (tag) {
     case 1: {
-      for (size_t i = 0; i < remaining_src_span.size(); ++i) {
-        uint8_t left = GetLeftValue(dest_span, i, bytes_per_pixel);
-        dest_span[i] = remaining_src_span[i] + left;
-      }
+      PngUnpredictSub(remaining_src_span, bytes_per_pixel, dest_span);
       break;
     }
     case 2: {
-      for (size_t i = 0; i < remaining_src_span.size(); ++i) {
-        uint8_t up = GetUpValue(last_span, i);
-        dest_span[i] = remaining_src_span[i] + up;
-      }
+      PngUnpredictUp(remaining_src_span, last_span, dest_span);
       break;
     }
     case 3: {
-      for (size_t i = 0; i < remaining_src_span.size(); ++i) {
-        uint8_t left = GetLeftValue(dest_span, i, bytes_per_pixel);
-        uint8_t up = GetUpValue(last_span, i);
-        dest_span[i] = remaining_src_span[i] + (up + left) / 2;
-      }
+      PngUnpredictAverage(remaining_src_span, last_span, bytes_per_pixel,
+                          dest_span);
       break;
     }
     case 4: {
-      for (size_t i = 0; i < remaining_src_span.size(); ++i) {
-        uint8_t left = GetLeftValue(dest_span, i, bytes_per_pixel);
-        uint8_t up = GetUpValue(last_span, i);
-        uint8_t upper_left = GetUpperLeftValue(last_span, i, bytes_per_pixel);
-        dest_span[i] =
-            remaining_src_span[i] + PathPredictor(left, up, upper_left);
-      }
+      PngUnpredictPaeth(remaining_src_span, last_span, bytes_per_pixel,
+                        dest_span);
       break;
     }
     default: {
@@ -461,9 +414,7 @@ void TIFF_PredictLine(pdfium::span<uint8_t> dest_span,
       dest_span[i + 1] = (uint8_t)pixel;
     }
   } else {
-    for (size_t i = BytesPerPixel; i < dest_span.size(); i++) {
-      dest_span[i] += dest_span[i - BytesPerPixel];
-    }
+    TiffUnpredictBytes(dest_span, static_cast<uint32_t>(BytesPerPixel));
   }
 }
 
@@ -494,60 +445,6 @@ uint32_t EstimateFlateUncompressBufferSize(uint32_t orig_size,
   return std::min(guess_size, kMaxInitialAllocSize);
 }
 
-DataAndBytesConsumed FlateUncompress(pdfium::span<const uint8_t> src_buf,
-                                     uint32_t orig_size) {
-  std::unique_ptr<z_stream, FlateDeleter> context(FlateInit());
-  if (!context) {
-    return {DataVector<uint8_t>(), 0u};
-  }
-
-  FlateInput(context.get(), src_buf);
-
-  const uint32_t buf_size =
-      EstimateFlateUncompressBufferSize(orig_size, src_buf.size());
-  uint32_t last_buf_size = buf_size;
-  DataVector<uint8_t> guess_buf(buf_size);
-  std::vector<DataVector<uint8_t>> result_tmp_bufs;
-  {
-    DataVector<uint8_t> cur_buf = std::move(guess_buf);
-    while (true) {
-      bool ret = FlateOutput(context.get(), cur_buf);
-      uint32_t avail_buf_size = FlateGetAvailOut(context.get());
-      if (!ret || avail_buf_size != 0) {
-        last_buf_size = buf_size - avail_buf_size;
-        result_tmp_bufs.push_back(std::move(cur_buf));
-        break;
-      }
-      result_tmp_bufs.push_back(std::move(cur_buf));
-      cur_buf = DataVector<uint8_t>(buf_size);
-    }
-  }
-
-  // The TotalOut size returned from the library may not be big enough to
-  // handle the content the library returns. We can only handle items
-  // up to 4GB in size.
-  const uint32_t dest_size = FlateGetPossiblyTruncatedTotalOut(context.get());
-  const uint32_t bytes_consumed =
-      FlateGetPossiblyTruncatedTotalIn(context.get());
-  if (result_tmp_bufs.size() == 1) {
-    CHECK_LE(dest_size, buf_size);
-    result_tmp_bufs.front().resize(dest_size);
-    return {std::move(result_tmp_bufs.front()), bytes_consumed};
-  }
-
-  DataVector<uint8_t> result_buf(dest_size);
-  auto result_span = pdfium::span(result_buf);
-  for (size_t i = 0; i < result_tmp_bufs.size(); i++) {
-    DataVector<uint8_t> tmp_buf = std::move(result_tmp_bufs[i]);
-    const uint32_t tmp_buf_size =
-        i + 1 < result_tmp_bufs.size() ? buf_size : last_buf_size;
-    size_t cp_size = std::min<size_t>(tmp_buf_size, result_span.size());
-    result_span =
-        fxcrt::spancpy(result_span, pdfium::span(tmp_buf).first(cp_size));
-  }
-  return {std::move(result_buf), bytes_consumed};
-}
-
 enum class PredictorType : uint8_t { kNone, kFlate, kPng };
 static PredictorType GetPredictor(int predictor) {
   if (predictor >= 10) {
@@ -773,6 +670,186 @@ size_t FlatePredictorScanlineDecoder::CopyAndAdvanceLine(size_t bytes_to_go) {
   return bytes_to_go - read_bytes;
 }
 
+class FlateStreamingDecoderImpl final : public FlateStreamingDecoder {
+ public:
+  FlateStreamingDecoderImpl(pdfium::span<const uint8_t> src_span,
+                            PredictorType predictor,
+                            int Colors,
+                            int BitsPerComponent,
+                            int Columns);
+  ~FlateStreamingDecoderImpl() override;
+
+  // FlateStreamingDecoder:
+  size_t Read(pdfium::span<uint8_t> dest) override;
+  bool HasError() const override { return has_error_; }
+  uint32_t GetSrcOffset() const override;
+
+ private:
+  // Inflates into `dest` until it is full or the data ends. Returns how many
+  // bytes were written.
+  size_t Inflate(pdfium::span<uint8_t> dest);
+
+  // Decodes the next predicted row into `row_`. Returns false at the end of
+  // the data.
+  bool DecodeNextRow();
+
+  std::unique_ptr<z_stream, FlateDeleter> flate_;
+  const PredictorType predictor_;
+  const int colors_;
+  const int bits_per_component_;
+  const int columns_;
+  uint32_t row_size_ = 0;
+  bool inflate_done_ = false;
+  bool has_error_ = false;
+  bool has_rows_ = false;
+  // The current row, and for PNG predictors, the one before it.
+  DataVector<uint8_t> row_;
+  DataVector<uint8_t> prev_row_;
+  // A PNG row, with its leading predictor tag.
+  DataVector<uint8_t> raw_row_;
+  size_t row_pos_ = 0;
+  size_t row_end_ = 0;
+};
+
+FlateStreamingDecoderImpl::FlateStreamingDecoderImpl(
+    pdfium::span<const uint8_t> src_span,
+    PredictorType predictor,
+    int Colors,
+    int BitsPerComponent,
+    int Columns)
+    : flate_(FlateInit()),
+      predictor_(predictor),
+      colors_(Colors),
+      bits_per_component_(BitsPerComponent),
+      columns_(Columns) {
+  FlateInput(flate_.get(), src_span);
+  if (predictor_ == PredictorType::kNone) {
+    return;
+  }
+
+  row_size_ =
+      fxge::CalculatePitch8(bits_per_component_, colors_, columns_).value_or(0);
+  if (row_size_ == 0) {
+    has_error_ = true;
+    return;
+  }
+
+  row_.resize(row_size_);
+  if (predictor_ == PredictorType::kPng) {
+    prev_row_.resize(row_size_);
+    raw_row_.resize(row_size_ + 1);
+  }
+}
+
+FlateStreamingDecoderImpl::~FlateStreamingDecoderImpl() = default;
+
+size_t FlateStreamingDecoderImpl::Read(pdfium::span<uint8_t> dest) {
+  if (predictor_ == PredictorType::kNone) {
+    return Inflate(dest);
+  }
+
+  size_t written = 0;
+  while (written < dest.size()) {
+    if (row_pos_ == row_end_ && !DecodeNextRow()) {
+      break;
+    }
+    const size_t size = std::min(row_end_ - row_pos_, dest.size() - written);
+    fxcrt::Copy(pdfium::span(row_).subspan(row_pos_, size),
+                dest.subspan(written, size));
+    row_pos_ += size;
+    written += size;
+  }
+  return written;
+}
+
+uint32_t FlateStreamingDecoderImpl::GetSrcOffset() const {
+  return FlateGetPossiblyTruncatedTotalIn(flate_.get());
+}
+
+size_t FlateStreamingDecoderImpl::Inflate(pdfium::span<uint8_t> dest) {
+  size_t written = 0;
+  while (written < dest.size() && !inflate_done_) {
+    pdfium::span<uint8_t> remaining = dest.subspan(written);
+    remaining = remaining.first(std::min<size_t>(
+        remaining.size(), std::numeric_limits<uint32_t>::max()));
+    flate_->next_out = remaining.data();
+    flate_->avail_out = static_cast<uint32_t>(remaining.size());
+    const int ret = inflate(flate_.get(), Z_SYNC_FLUSH);
+    written += remaining.size() - flate_->avail_out;
+    inflate_done_ = ret != Z_OK || flate_->avail_out != 0;
+  }
+  return written;
+}
+
+bool FlateStreamingDecoderImpl::DecodeNextRow() {
+  if (has_error_) {
+    return false;
+  }
+
+  row_pos_ = 0;
+  row_end_ = 0;
+  if (predictor_ == PredictorType::kFlate) {
+    row_end_ = Inflate(row_);
+    if (row_end_ == 0) {
+      return false;
+    }
+    TIFF_PredictLine(pdfium::span(row_).first(row_end_), bits_per_component_,
+                     colors_, columns_);
+    return true;
+  }
+
+  const size_t raw_size = Inflate(raw_row_);
+  if (raw_size == 0) {
+    // Like PNG_Predictor(), treat data without any rows as an error.
+    has_error_ = !has_rows_;
+    return false;
+  }
+
+  // The row before this one is the "up" row for the predictor.
+  pdfium::span<const uint8_t> prev_row;
+  if (has_rows_) {
+    std::swap(row_, prev_row_);
+    prev_row = prev_row_;
+  }
+  has_rows_ = true;
+  row_end_ = std::min<size_t>(row_size_, raw_size - 1);
+  const uint32_t bytes_per_pixel = (colors_ * bits_per_component_ + 7) / 8;
+  PNG_PredictLine(row_, raw_row_, prev_row, row_end_, bytes_per_pixel);
+  return true;
+}
+
+// Reads all of the data from `decoder`, up to `max_size` bytes, in
+// `buf_size` pieces.
+DataVector<uint8_t> ReadAll(FlateStreamingDecoder* decoder,
+                            uint32_t buf_size,
+                            size_t max_size) {
+  std::vector<DataVector<uint8_t>> bufs;
+  size_t total_size = 0;
+  while (total_size < max_size) {
+    DataVector<uint8_t> buf(
+        std::clamp<size_t>(buf_size, 1, max_size - total_size));
+    const size_t size = decoder->Read(buf);
+    total_size += size;
+    const bool done = size < buf.size();
+    buf.resize(size);
+    bufs.push_back(std::move(buf));
+    if (done) {
+      break;
+    }
+  }
+
+  if (bufs.size() == 1) {
+    return std::move(bufs.front());
+  }
+
+  DataVector<uint8_t> result(total_size);
+  pdfium::span<uint8_t> result_span = pdfium::span(result);
+  for (const DataVector<uint8_t>& buf : bufs) {
+    result_span = fxcrt::spancpy(result_span, pdfium::span(buf));
+  }
+  return result;
+}
+
 }  // namespace
 
 // static
@@ -796,6 +873,17 @@ std::unique_ptr<ScanlineDecoder> FlateModule::CreateDecoder(
       BitsPerComponent, Columns);
 }
 
+// static
+std::unique_ptr<FlateStreamingDecoder> FlateModule::CreateStreamingDecoder(
+    pdfium::span<const uint8_t> src_span,
+    int predictor,
+    int Colors,
+    int BitsPerComponent,
+    int Columns) {
+  return std::make_unique<FlateStreamingDecoderImpl>(
+      src_span, GetPredictor(predictor), Colors, BitsPerComponent, Columns);
+}
+
 // static
 DataAndBytesConsumed FlateModule::FlateOrLZWDecode(
     bool bLZW,
@@ -805,25 +893,30 @@ DataAndBytesConsumed FlateModule::FlateOrLZWDecode(
     int Colors,
     int BitsPerComponent,
     int Columns,
-    uint32_t estimated_size) {
-  DataVector<uint8_t> dest_buf;
-  uint32_t bytes_consumed = FX_INVALID_OFFSET;
+    uint32_t estimated_size,
+    size_t max_size) {
   PredictorType predictor_type = GetPredictor(predictor);
-
-  if (bLZW) {
-    auto decoder = std::make_unique<CLZWDecoder>(src_span, bEarlyChange);
-    if (!decoder->Decode()) {
-      return {std::move(dest_buf), bytes_consumed};
+  if (!bLZW) {
+    FlateStreamingDecoderImpl decoder(src_span, predictor_type, Colors,
+                                      BitsPerComponent, Columns);
+    if (max_size == 0 || max_size > kMaxTotalOutSize) {
+      max_size = kMaxTotalOutSize;
     }
+    DataVector<uint8_t> dest_buf = ReadAll(
+        &decoder,
+        EstimateFlateUncompressBufferSize(estimated_size, src_span.size()),
+        max_size);
+    return {std::move(dest_buf), decoder.HasError() ? FX_INVALID_OFFSET
+                                                    : decoder.GetSrcOffset()};
+  }
 
-    dest_buf = decoder->TakeDestBuf();
-    bytes_consumed = decoder->GetSrcSize();
-  } else {
-    DataAndBytesConsumed result = FlateUncompress(src_span, estimated_size);
-    dest_buf = std::move(result.data);
-    bytes_consumed = result.bytes_consumed;
+  auto decoder = std::make_unique<CLZWDecoder>(src_span, bEarlyChange);
+  if (!decoder->Decode()) {
+    return {DataVector<uint8_t>(), FX_INVALID_OFFSET};
   }
 
+  DataVector<uint8_t> dest_buf = decoder->TakeDestBuf();
+  const uint32_t bytes_consumed = decoder->GetSrcSize();
   switch (predictor_type) {
     case PredictorType::kNone: {
       return {std::move(dest_buf), bytes_consumed};
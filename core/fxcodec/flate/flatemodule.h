@@ -7,6 +7,7 @@
 #ifndef CORE_FXCODEC_FLATE_FLATEMODULE_H_
 #define CORE_FXCODEC_FLATE_FLATEMODULE_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include <memory>
@@ -19,6 +20,25 @@ namespace fxcodec {
 
 class ScanlineDecoder;
 
+// Decodes Flate data a piece at a time, so callers need not hold all of the
+// decoded data at once. Produces the same data as
+// FlateModule::FlateOrLZWDecode().
+class FlateStreamingDecoder {
+ public:
+  virtual ~FlateStreamingDecoder() = default;
+
+  // Decodes up to `dest.size()` bytes into `dest`, and returns how many bytes
+  // were written. Returns less than `dest.size()` only at the end of the data.
+  virtual size_t Read(pdfium::span<uint8_t> dest) = 0;
+
+  // Returns whether the predictor cannot be applied to the data. Only final
+  // once Read() has reached the end of the data.
+  virtual bool HasError() const = 0;
+
+  // Returns how many bytes of the source data have been consumed so far.
+  virtual uint32_t GetSrcOffset() const = 0;
+};
+
 class FlateModule {
  public:
   static std::unique_ptr<ScanlineDecoder> CreateDecoder(
@@ -32,6 +52,16 @@ class FlateModule {
       int BitsPerComponent,
       int Columns);
 
+  // The returned decoder must not outlive `src_span`.
+  static std::unique_ptr<FlateStreamingDecoder> CreateStreamingDecoder(
+      pdfium::span<const uint8_t> src_span,
+      int predictor,
+      int Colors,
+      int BitsPerComponent,
+      int Columns);
+
+  // Decoded Flate data stops at `max_size` bytes, or at 1 GiB if `max_size` is
+  // 0 or larger than that. `max_size` does not apply to LZW data.
   static DataAndBytesConsumed FlateOrLZWDecode(
       bool bLZW,
       pdfium::span<const uint8_t> src_span,
@@ -40,7 +70,8 @@ class FlateModule {
       int Colors,
       int BitsPerComponent,
       int Columns,
-      uint32_t estimated_size);
+      uint32_t estimated_size,
+      size_t max_size);
 
   static DataVector<uint8_t> Encode(pdfium::span<const uint8_t> src_span);
 
@@ -52,5 +83,6 @@ class FlateModule {
 }  // namespace fxcodec
 
 using FlateModule = fxcodec::FlateModule;
+using FlateStreamingDecoder = fxcodec::FlateStreamingDecoder;
 
 #endif  // CORE_FXCODEC_FLATE_FLATEMODULE_H_
@@ -4,13 +4,37 @@
 
 #include "core/fxcodec/flate/flatemodule.h"
 
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
 #include "core/fxcodec/data_and_bytes_consumed.h"
+#include "core/fxcrt/fx_extension.h"
+#include "core/fxcrt/span.h"
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/test_support.h"
 
 using testing::ElementsAreArray;
 
+namespace {
+
+// Reads all of `decoder`'s data, `read_size` bytes at a time.
+std::vector<uint8_t> ReadAll(FlateStreamingDecoder* decoder, size_t read_size) {
+  std::vector<uint8_t> result;
+  std::vector<uint8_t> buf(read_size);
+  while (true) {
+    const size_t size = decoder->Read(buf);
+    result.insert(result.end(), buf.begin(), buf.begin() + size);
+    if (size < buf.size()) {
+      return result;
+    }
+  }
+}
+
+}  // namespace
+
 // NOTE: python's zlib.compress() and zlib.decompress() may be useful for
 // external validation of the FlateDncode/FlateEecode test cases.
 TEST(FlateModule, Decode) {
@@ -37,7 +61,7 @@ TEST(FlateModule, Decode) {
   size_t i = 0;
   for (const pdfium::DecodeTestData& data : flate_decode_cases) {
     DataAndBytesConsumed result = FlateModule::FlateOrLZWDecode(
-        false, data.input_span(), false, 0, 0, 0, 0, 0);
+        false, data.input_span(), false, 0, 0, 0, 0, 0, 0);
     EXPECT_EQ(data.processed_size, result.bytes_consumed) << " for case " << i;
     EXPECT_THAT(result.data, ElementsAreArray(data.expected_span()))
         << " for case " << i;
@@ -72,3 +96,97 @@ TEST(FlateModule, Encode) {
     ++i;
   }
 }
+
+TEST(FlateModule, DecodeWithMaxSize) {
+  std::vector<uint8_t> data(100000);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<uint8_t>(i * i / 7);
+  }
+  const DataVector<uint8_t> encoded = FlateModule::Encode(data);
+
+  DataAndBytesConsumed result =
+      FlateModule::FlateOrLZWDecode(false, encoded, false, 0, 0, 0, 0, 0, 0);
+  EXPECT_EQ(encoded.size(), result.bytes_consumed);
+  EXPECT_THAT(result.data, ElementsAreArray(data));
+
+  // Decoding stops early, so not all of the data is consumed.
+  result = FlateModule::FlateOrLZWDecode(false, encoded, false, 0, 0, 0, 0,
+                                         /*estimated_size=*/1000,
+                                         /*max_size=*/2500);
+  EXPECT_LT(result.bytes_consumed, encoded.size());
+  EXPECT_THAT(result.data, ElementsAreArray(pdfium::span(data).first(2500u)));
+}
+
+TEST(FlateModule, StreamingDecoder) {
+  std::vector<uint8_t> data(100000);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<uint8_t>(i * i / 7);
+  }
+  const DataVector<uint8_t> encoded = FlateModule::Encode(data);
+  for (size_t read_size : {1u, 1000u, 65536u, 200000u}) {
+    SCOPED_TRACE(read_size);
+    std::unique_ptr<FlateStreamingDecoder> decoder =
+        FlateModule::CreateStreamingDecoder(encoded, 0, 0, 0, 0);
+    EXPECT_EQ(data, ReadAll(decoder.get(), read_size));
+    EXPECT_FALSE(decoder->HasError());
+    EXPECT_EQ(encoded.size(), decoder->GetSrcOffset());
+  }
+}
+
+TEST(FlateModule, StreamingDecoderPngPredictor) {
+  // 3 byte rows with the None, Sub and Up predictors, and a partial row.
+  const std::vector<uint8_t> predicted = {0, 1, 2, 3, 1, 1, 1, 1,
+                                          2, 1, 1, 1, 2, 5};
+  const std::vector<uint8_t> expected = {1, 2, 3, 1, 2, 3, 2, 3, 4, 7};
+  const DataVector<uint8_t> encoded = FlateModule::Encode(predicted);
+  for (size_t read_size : {1u, 2u, 100u}) {
+    SCOPED_TRACE(read_size);
+    std::unique_ptr<FlateStreamingDecoder> decoder =
+        FlateModule::CreateStreamingDecoder(encoded, /*predictor=*/12,
+                                            /*Colors=*/1,
+                                            /*BitsPerComponent=*/8,
+                                            /*Columns=*/3);
+    EXPECT_EQ(expected, ReadAll(decoder.get(), read_size));
+    EXPECT_FALSE(decoder->HasError());
+  }
+
+  DataAndBytesConsumed result =
+      FlateModule::FlateOrLZWDecode(false, encoded, false, 12, 1, 8, 3, 0, 0);
+  EXPECT_EQ(encoded.size(), result.bytes_consumed);
+  EXPECT_THAT(result.data, ElementsAreArray(expected));
+
+  // There must be at least one row.
+  const DataVector<uint8_t> empty =
+      FlateModule::Encode(pdfium::span<const uint8_t>());
+  std::unique_ptr<FlateStreamingDecoder> decoder =
+      FlateModule::CreateStreamingDecoder(empty, 12, 1, 8, 3);
+  EXPECT_TRUE(ReadAll(decoder.get(), 100).empty());
+  EXPECT_TRUE(decoder->HasError());
+  result =
+      FlateModule::FlateOrLZWDecode(false, empty, false, 12, 1, 8, 3, 0, 0);
+  EXPECT_EQ(FX_INVALID_OFFSET, result.bytes_consumed);
+}
+
+TEST(FlateModule, StreamingDecoderTiffPredictor) {
+  // 4 byte rows, and a partial row.
+  const std::vector<uint8_t> predicted = {1, 1, 1, 1, 10, 0, 2, 0, 5, 1};
+  const std::vector<uint8_t> expected = {1, 2, 3, 4, 10, 10, 12, 12, 5, 6};
+  const DataVector<uint8_t> encoded = FlateModule::Encode(predicted);
+  for (size_t read_size : {1u, 3u, 100u}) {
+    SCOPED_TRACE(read_size);
+    std::unique_ptr<FlateStreamingDecoder> decoder =
+        FlateModule::CreateStreamingDecoder(encoded, /*predictor=*/2,
+                                            /*Colors=*/1,
+                                            /*BitsPerComponent=*/8,
+                                            /*Columns=*/4);
+    EXPECT_EQ(expected, ReadAll(decoder.get(), read_size));
+    EXPECT_FALSE(decoder->HasError());
+    EXPECT_EQ(encoded.size(), decoder->GetSrcOffset());
+  }
+
+  // Rows cannot be empty.
+  std::unique_ptr<FlateStreamingDecoder> decoder =
+      FlateModule::CreateStreamingDecoder(encoded, 2, 1, 8, 0);
+  EXPECT_TRUE(ReadAll(decoder.get(), 100).empty());
+  EXPECT_TRUE(decoder->HasError());
+}
@@ -0,0 +1,349 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxcodec/flate/predictor_simd.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+
+#include <array>
+
+#include "core/fxcrt/check.h"
+#include "core/fxcrt/check_op.h"
+#include "core/fxcrt/compiler_specific.h"
+#include "core/fxcrt/stl_util.h"
+
+// Compiles this file once per CPU target that Highway supports.
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "core/fxcodec/flate/predictor_simd.cpp"
+#include "hwy/foreach_target.h"  // IWYU pragma: keep
+#include "hwy/highway.h"
+
+HWY_BEFORE_NAMESPACE();
+namespace fxcodec {
+namespace HWY_NAMESPACE {
+
+namespace hn = hwy::HWY_NAMESPACE;
+
+// 16 bytes. Byte shifts and lookups only work within 128-bit blocks, so the
+// prefix sums stick to one block.
+using DBlock = hn::FixedTag<uint8_t, 16>;
+using VBlock = hn::Vec<DBlock>;
+
+// One pixel of up to 4 bytes, one per lane.
+using DPixel = hn::FixedTag<uint8_t, 4>;
+using VPixel = hn::Vec<DPixel>;
+
+uint8_t PaethPredictor(uint8_t a, uint8_t b, uint8_t c) {
+  int p = static_cast<int>(a) + b - c;
+  int pa = abs(p - a);
+  int pb = abs(p - b);
+  int pc = abs(p - c);
+  if (pa <= pb && pa <= pc) {
+    return a;
+  }
+  return pb <= pc ? b : c;
+}
+
+// The scalar loops undo the predictors for the bytes from `start` on. The
+// bytes before `start` must already be in `dest`.
+void UnpredictSubScalar(pdfium::span<const uint8_t> src,
+                        size_t bpp,
+                        pdfium::span<uint8_t> dest,
+                        size_t start) {
+  for (size_t i = start; i < src.size(); ++i) {
+    const uint8_t left = i >= bpp ? dest[i - bpp] : 0;
+    dest[i] = src[i] + left;
+  }
+}
+
+void UnpredictAverageScalar(pdfium::span<const uint8_t> src,
+                            pdfium::span<const uint8_t> prev,
+                            size_t bpp,
+                            pdfium::span<uint8_t> dest,
+                            size_t start) {
+  for (size_t i = start; i < src.size(); ++i) {
+    const uint8_t left = i >= bpp ? dest[i - bpp] : 0;
+    const uint8_t up = prev.empty() ? 0 : prev[i];
+    dest[i] = src[i] + (left + up) / 2;
+  }
+}
+
+void UnpredictPaethScalar(pdfium::span<const uint8_t> src,
+                          pdfium::span<const uint8_t> prev,
+                          size_t bpp,
+                          pdfium::span<uint8_t> dest,
+                          size_t start) {
+  for (size_t i = start; i < src.size(); ++i) {
+    const uint8_t left = i >= bpp ? dest[i - bpp] : 0;
+    const uint8_t up = prev.empty() ? 0 : prev[i];
+    const uint8_t upper_left = i >= bpp && !prev.empty() ? prev[i - bpp] : 0;
+    dest[i] = src[i] + PaethPredictor(left, up, upper_left);
+  }
+}
+
+// For each lane, the lane of the previous block that holds the same byte of
+// the last whole pixel.
+template <int kBpp>
+constexpr std::array<uint8_t, 16> MakeCarryIndices() {
+  constexpr int kStep = 16 - 16 % kBpp;
+  std::array<uint8_t, 16> indices = {};
+  for (int i = 0; i < 16; ++i) {
+    indices[i] = static_cast<uint8_t>(kStep - kBpp + i % kBpp);
+  }
+  return indices;
+}
+
+// Undoes the Sub predictor with prefix sums over 16 bytes at a time. Each
+// block starts on a whole pixel, so the last pixel of the previous block
+// carries over to every pixel of the next one. Works in place too. Returns
+// how many bytes are done.
+template <int kBpp>
+size_t UnpredictSubBlocks(pdfium::span<const uint8_t> src,
+                          pdfium::span<uint8_t> dest) {
+  constexpr size_t kStep = 16 - 16 % kBpp;
+  static constexpr std::array<uint8_t, 16> kCarryIndices =
+      MakeCarryIndices<kBpp>();
+  if (src.size() < 16) {
+    return 0;
+  }
+
+  const DBlock d;
+  const VBlock carry_indices = hn::LoadU(d, kCarryIndices.data());
+  VBlock prev = hn::Zero(d);
+  size_t i = 0;
+  // SAFETY: every load and store covers 16 bytes at offsets where at least 16
+  // bytes remain, and `dest` is at least as long as `src`.
+  UNSAFE_BUFFERS({
+    VBlock next = hn::LoadU(d, src.data());
+    while (true) {
+      VBlock sums = next;
+      sums = hn::Add(sums, hn::ShiftLeftBytes<kBpp>(d, sums));
+      if constexpr (kBpp * 2 < 16) {
+        sums = hn::Add(sums, hn::ShiftLeftBytes<kBpp * 2>(d, sums));
+      }
+      if constexpr (kBpp * 4 < 16) {
+        sums = hn::Add(sums, hn::ShiftLeftBytes<kBpp * 4>(d, sums));
+      }
+      if constexpr (kBpp * 8 < 16) {
+        sums = hn::Add(sums, hn::ShiftLeftBytes<kBpp * 8>(d, sums));
+      }
+      prev = hn::Add(sums, hn::TableLookupBytes(prev, carry_indices));
+      // Load the next block before the store overwrites its start, when
+      // working in place.
+      const bool last = i + kStep + 16 > src.size();
+      if (!last) {
+        next = hn::LoadU(d, src.data() + i + kStep);
+      }
+      hn::StoreU(prev, d, dest.data() + i);
+      if (last) {
+        break;
+      }
+      i += kStep;
+    }
+  });
+  // The bytes past the last whole pixel of the last block are done as well.
+  return i + 16;
+}
+
+// Undoes the Average predictor one pixel per vector. Returns how many bytes
+// are done.
+template <int kBpp>
+size_t UnpredictAveragePixels(pdfium::span<const uint8_t> src,
+                              pdfium::span<const uint8_t> prev,
+                              pdfium::span<uint8_t> dest) {
+  const DPixel d;
+  const VPixel one = hn::Set(d, 1);
+  VPixel left = hn::Zero(d);
+  size_t i = 0;
+  // SAFETY: each load and store covers 4 bytes, where at least 4 bytes remain
+  // in `src`, and `prev` and `dest` are at least as long as `src`. With 3 bytes
+  // per pixel, the extra byte gets overwritten by the next pixel.
+  UNSAFE_BUFFERS({
+    for (; i + 4 <= src.size(); i += kBpp) {
+      const VPixel up = hn::LoadU(d, prev.data() + i);
+      // (left + up) / 2, rounded down.
+      const VPixel average = hn::Sub(hn::AverageRound(left, up),
+                                     hn::And(hn::Xor(left, up), one));
+      left = hn::Add(hn::LoadU(d, src.data() + i), average);
+      hn::StoreU(left, d, dest.data() + i);
+    }
+  });
+  return i;
+}
+
+// Same as UnpredictAveragePixels(), for the Paeth predictor. Works with 16-bit
+// lanes, so the distances do not overflow.
+template <int kBpp>
+size_t UnpredictPaethPixels(pdfium::span<const uint8_t> src,
+                            pdfium::span<const uint8_t> prev,
+                            pdfium::span<uint8_t> dest) {
+  const DPixel d;
+  const hn::Rebind<int16_t, DPixel> d16;
+  VPixel left = hn::Zero(d);
+  VPixel upper_left = hn::Zero(d);
+  size_t i = 0;
+  // SAFETY: same as in UnpredictAveragePixels().
+  UNSAFE_BUFFERS({
+    for (; i + 4 <= src.size(); i += kBpp) {
+      const VPixel up = hn::LoadU(d, prev.data() + i);
+      const auto a = hn::PromoteTo(d16, left);
+      const auto b = hn::PromoteTo(d16, up);
+      const auto c = hn::PromoteTo(d16, upper_left);
+      const auto pa = hn::Abs(hn::Sub(b, c));
+      const auto pb = hn::Abs(hn::Sub(a, c));
+      const auto pc = hn::Abs(hn::Sub(hn::Add(a, b), hn::Add(c, c)));
+      const auto predictor =
+          hn::IfThenElse(hn::And(hn::Le(pa, pb), hn::Le(pa, pc)), a,
+                         hn::IfThenElse(hn::Le(pb, pc), b, c));
+      left = hn::Add(hn::LoadU(d, src.data() + i), hn::DemoteTo(d, predictor));
+      hn::StoreU(left, d, dest.data() + i);
+      upper_left = up;
+    }
+  });
+  return i;
+}
+
+void PngUnpredictSubImpl(pdfium::span<const uint8_t> src,
+                         uint32_t bytes_per_pixel,
+                         pdfium::span<uint8_t> dest) {
+  size_t done = 0;
+  switch (bytes_per_pixel) {
+    case 1:
+      done = UnpredictSubBlocks<1>(src, dest);
+      break;
+    case 3:
+      done = UnpredictSubBlocks<3>(src, dest);
+      break;
+    case 4:
+      done = UnpredictSubBlocks<4>(src, dest);
+      break;
+    default:
+      break;
+  }
+  UnpredictSubScalar(src, bytes_per_pixel, dest, done);
+}
+
+void PngUnpredictUpImpl(pdfium::span<const uint8_t> src,
+                        pdfium::span<const uint8_t> prev,
+                        pdfium::span<uint8_t> dest) {
+  if (prev.empty()) {
+    fxcrt::Copy(src, dest);
+    return;
+  }
+
+  const hn::ScalableTag<uint8_t> d;
+  const size_t lanes = hn::Lanes(d);
+  size_t i = 0;
+  // SAFETY: `prev` and `dest` are at least as long as `src`.
+  UNSAFE_BUFFERS({
+    for (; i + lanes <= src.size(); i += lanes) {
+      hn::StoreU(
+          hn::Add(hn::LoadU(d, src.data() + i), hn::LoadU(d, prev.data() + i)),
+          d, dest.data() + i);
+    }
+  });
+  for (; i < src.size(); ++i) {
+    dest[i] = src[i] + prev[i];
+  }
+}
+
+void PngUnpredictAverageImpl(pdfium::span<const uint8_t> src,
+                             pdfium::span<const uint8_t> prev,
+                             uint32_t bytes_per_pixel,
+                             pdfium::span<uint8_t> dest) {
+  size_t done = 0;
+  if (!prev.empty()) {
+    switch (bytes_per_pixel) {
+      case 3:
+        done = UnpredictAveragePixels<3>(src, prev, dest);
+        break;
+      case 4:
+        done = UnpredictAveragePixels<4>(src, prev, dest);
+        break;
+      default:
+        break;
+    }
+  }
+  UnpredictAverageScalar(src, prev, bytes_per_pixel, dest, done);
+}
+
+void PngUnpredictPaethImpl(pdfium::span<const uint8_t> src,
+                           pdfium::span<const uint8_t> prev,
+                           uint32_t bytes_per_pixel,
+                           pdfium::span<uint8_t> dest) {
+  // Without a row above, Paeth always predicts the left byte.
+  if (prev.empty()) {
+    PngUnpredictSubImpl(src, bytes_per_pixel, dest);
+    return;
+  }
+
+  size_t done = 0;
+  switch (bytes_per_pixel) {
+    case 3:
+      done = UnpredictPaethPixels<3>(src, prev, dest);
+      break;
+    case 4:
+      done = UnpredictPaethPixels<4>(src, prev, dest);
+      break;
+    default:
+      break;
+  }
+  UnpredictPaethScalar(src, prev, bytes_per_pixel, dest, done);
+}
+
+}  // namespace HWY_NAMESPACE
+}  // namespace fxcodec
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace fxcodec {
+
+HWY_EXPORT(PngUnpredictSubImpl);
+HWY_EXPORT(PngUnpredictUpImpl);
+HWY_EXPORT(PngUnpredictAverageImpl);
+HWY_EXPORT(PngUnpredictPaethImpl);
+
+void PngUnpredictSub(pdfium::span<const uint8_t> src,
+                     uint32_t bytes_per_pixel,
+                     pdfium::span<uint8_t> dest) {
+  CHECK_GE(dest.size(), src.size());
+  HWY_DYNAMIC_DISPATCH(PngUnpredictSubImpl)(src, bytes_per_pixel, dest);
+}
+
+void PngUnpredictUp(pdfium::span<const uint8_t> src,
+                    pdfium::span<const uint8_t> prev,
+                    pdfium::span<uint8_t> dest) {
+  CHECK_GE(dest.size(), src.size());
+  CHECK(prev.empty() || prev.size() >= src.size());
+  HWY_DYNAMIC_DISPATCH(PngUnpredictUpImpl)(src, prev, dest);
+}
+
+void PngUnpredictAverage(pdfium::span<const uint8_t> src,
+                         pdfium::span<const uint8_t> prev,
+                         uint32_t bytes_per_pixel,
+                         pdfium::span<uint8_t> dest) {
+  CHECK_GE(dest.size(), src.size());
+  CHECK(prev.empty() || prev.size() >= src.size());
+  HWY_DYNAMIC_DISPATCH(PngUnpredictAverageImpl)(src, prev, bytes_per_pixel,
+                                                dest);
+}
+
+void PngUnpredictPaeth(pdfium::span<const uint8_t> src,
+                       pdfium::span<const uint8_t> prev,
+                       uint32_t bytes_per_pixel,
+                       pdfium::span<uint8_t> dest) {
+  CHECK_GE(dest.size(), src.size());
+  CHECK(prev.empty() || prev.size() >= src.size());
+  HWY_DYNAMIC_DISPATCH(PngUnpredictPaethImpl)(src, prev, bytes_per_pixel,
+                                              dest);
+}
+
+void TiffUnpredictBytes(pdfium::span<uint8_t> row, uint32_t bytes_per_pixel) {
+  // Horizontal differencing is the same as the PNG Sub predictor.
+  HWY_DYNAMIC_DISPATCH(PngUnpredictSubImpl)(row, bytes_per_pixel, row);
+}
+
+}  // namespace fxcodec
+#endif  // HWY_ONCE
@@ -0,0 +1,47 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FXCODEC_FLATE_PREDICTOR_SIMD_H_
+#define CORE_FXCODEC_FLATE_PREDICTOR_SIMD_H_
+
+#include <stdint.h>
+
+#include "core/fxcrt/span.h"
+
+// Vectorized PNG and TIFF predictor reversal, with runtime CPU dispatch. Rows
+// with 1, 3 or 4 bytes per pixel take the vector paths, as far as the
+// predictor allows. Other rows use scalar loops with identical results.
+namespace fxcodec {
+
+// Undoes the PNG Sub predictor for the bytes of `src`, without the leading
+// predictor tag, and writes them to the start of `dest`.
+void PngUnpredictSub(pdfium::span<const uint8_t> src,
+                     uint32_t bytes_per_pixel,
+                     pdfium::span<uint8_t> dest);
+
+// Same as PngUnpredictSub(), for the Up predictor. `prev` is the previous
+// decoded row, or empty for the first row.
+void PngUnpredictUp(pdfium::span<const uint8_t> src,
+                    pdfium::span<const uint8_t> prev,
+                    pdfium::span<uint8_t> dest);
+
+// Same as PngUnpredictUp(), for the Average predictor.
+void PngUnpredictAverage(pdfium::span<const uint8_t> src,
+                         pdfium::span<const uint8_t> prev,
+                         uint32_t bytes_per_pixel,
+                         pdfium::span<uint8_t> dest);
+
+// Same as PngUnpredictUp(), for the Paeth predictor.
+void PngUnpredictPaeth(pdfium::span<const uint8_t> src,
+                       pdfium::span<const uint8_t> prev,
+                       uint32_t bytes_per_pixel,
+                       pdfium::span<uint8_t> dest);
+
+// Undoes TIFF horizontal differencing byte by byte in place, as for 8 bits per
+// component.
+void TiffUnpredictBytes(pdfium::span<uint8_t> row, uint32_t bytes_per_pixel);
+
+}  // namespace fxcodec
+
+#endif  // CORE_FXCODEC_FLATE_PREDICTOR_SIMD_H_
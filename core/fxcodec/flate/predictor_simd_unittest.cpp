@@ -0,0 +1,168 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxcodec/flate/predictor_simd.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <vector>
+
+#include "core/fxcrt/span.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using fxcodec::PngUnpredictAverage;
+using fxcodec::PngUnpredictPaeth;
+using fxcodec::PngUnpredictSub;
+using fxcodec::PngUnpredictUp;
+using fxcodec::TiffUnpredictBytes;
+
+namespace {
+
+constexpr uint8_t kFill = 0xcd;
+
+// Row sizes around the vector widths, and some longer rows.
+constexpr size_t kSizes[] = {0,  1,  2,  3,  4,  5,  7,   8,   15,  16,
+                             17, 31, 32, 33, 47, 48, 63,  64,  65,  95,
+                             96, 97, 99, 127, 128, 129, 200, 255, 300};
+
+std::vector<uint8_t> MakeRow(size_t size, uint32_t seed) {
+  std::vector<uint8_t> row(size);
+  for (uint8_t& byte : row) {
+    seed = seed * 1103515245 + 12345;
+    byte = static_cast<uint8_t>(seed >> 16);
+  }
+  return row;
+}
+
+// Reference versions of the loops that PNG_PredictLine() used to have.
+uint8_t Left(const std::vector<uint8_t>& dest, size_t i, uint32_t bpp) {
+  return i >= bpp ? dest[i - bpp] : 0;
+}
+
+uint8_t Up(const std::vector<uint8_t>& prev, size_t i) {
+  return prev.empty() ? 0 : prev[i];
+}
+
+uint8_t UpperLeft(const std::vector<uint8_t>& prev, size_t i, uint32_t bpp) {
+  return i >= bpp && !prev.empty() ? prev[i - bpp] : 0;
+}
+
+uint8_t Paeth(uint8_t a, uint8_t b, uint8_t c) {
+  int p = static_cast<int>(a) + b - c;
+  int pa = abs(p - a);
+  int pb = abs(p - b);
+  int pc = abs(p - c);
+  if (pa <= pb && pa <= pc) {
+    return a;
+  }
+  return pb <= pc ? b : c;
+}
+
+std::vector<uint8_t> ReferenceUnpredict(int tag,
+                                        const std::vector<uint8_t>& src,
+                                        const std::vector<uint8_t>& prev,
+                                        uint32_t bpp,
+                                        size_t dest_size) {
+  std::vector<uint8_t> dest(dest_size, kFill);
+  for (size_t i = 0; i < src.size(); ++i) {
+    uint8_t predictor = 0;
+    switch (tag) {
+      case 1:
+        predictor = Left(dest, i, bpp);
+        break;
+      case 2:
+        predictor = Up(prev, i);
+        break;
+      case 3:
+        predictor = (Left(dest, i, bpp) + Up(prev, i)) / 2;
+        break;
+      case 4:
+        predictor = Paeth(Left(dest, i, bpp), Up(prev, i),
+                          UpperLeft(prev, i, bpp));
+        break;
+    }
+    dest[i] = src[i] + predictor;
+  }
+  return dest;
+}
+
+std::vector<uint8_t> Unpredict(int tag,
+                               const std::vector<uint8_t>& src,
+                               const std::vector<uint8_t>& prev,
+                               uint32_t bpp,
+                               size_t dest_size) {
+  std::vector<uint8_t> dest(dest_size, kFill);
+  switch (tag) {
+    case 1:
+      PngUnpredictSub(src, bpp, dest);
+      break;
+    case 2:
+      PngUnpredictUp(src, prev, dest);
+      break;
+    case 3:
+      PngUnpredictAverage(src, prev, bpp, dest);
+      break;
+    case 4:
+      PngUnpredictPaeth(src, prev, bpp, dest);
+      break;
+  }
+  return dest;
+}
+
+}  // namespace
+
+TEST(PredictorSimdTest, PngMatchesScalar) {
+  uint32_t seed = 1;
+  for (int tag = 1; tag <= 4; ++tag) {
+    for (uint32_t bpp = 1; bpp <= 8; ++bpp) {
+      for (size_t size : kSizes) {
+        for (bool has_prev : {false, true}) {
+          SCOPED_TRACE(testing::Message() << "tag " << tag << ", bpp " << bpp
+                                          << ", size " << size << ", prev "
+                                          << has_prev);
+          const std::vector<uint8_t> src = MakeRow(size, ++seed);
+          std::vector<uint8_t> prev;
+          if (has_prev) {
+            // The previous row may be longer than the current one.
+            ++seed;
+            prev = MakeRow(size + seed % 3, seed);
+          }
+          // Bytes past `src` must be left alone.
+          const size_t dest_size = size + seed % 5;
+          EXPECT_EQ(ReferenceUnpredict(tag, src, prev, bpp, dest_size),
+                    Unpredict(tag, src, prev, bpp, dest_size));
+        }
+      }
+    }
+  }
+}
+
+TEST(PredictorSimdTest, PngInPlace) {
+  // TiffUnpredictBytes() relies on the Sub predictor working in place.
+  for (uint32_t bpp : {1u, 3u, 4u}) {
+    SCOPED_TRACE(bpp);
+    std::vector<uint8_t> row = MakeRow(301, bpp);
+    const std::vector<uint8_t> expected =
+        ReferenceUnpredict(1, row, {}, bpp, row.size());
+    PngUnpredictSub(row, bpp, row);
+    EXPECT_EQ(expected, row);
+  }
+}
+
+TEST(PredictorSimdTest, TiffMatchesScalar) {
+  uint32_t seed = 7;
+  for (uint32_t bpp = 0; bpp <= 8; ++bpp) {
+    for (size_t size : kSizes) {
+      SCOPED_TRACE(testing::Message() << "bpp " << bpp << ", size " << size);
+      std::vector<uint8_t> row = MakeRow(size, ++seed);
+      std::vector<uint8_t> expected = row;
+      for (size_t i = bpp; i < expected.size(); ++i) {
+        expected[i] += expected[i - bpp];
+      }
+      TiffUnpredictBytes(row, bpp);
+      EXPECT_EQ(expected, row);
+    }
+  }
+}
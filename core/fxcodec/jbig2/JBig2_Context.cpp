@@ -9,7 +9,6 @@
 #include <algorithm>
 #include <array>
 #include <limits>
-#include <list>
 #include <utility>
 #include <vector>
 
@@ -47,24 +46,13 @@ JBig2ComposeOp GetRegionInfoComposeOp(const JBig2RegionInfo& ri) {
 
 }  // namespace
 
-// Implement a very small least recently used (LRU) cache. It is very
-// common for a JBIG2 dictionary to span multiple pages in a PDF file,
-// and we do not want to decode the same dictionary over and over
-// again. We key off of the memory location of the dictionary. The
-// list keeps track of the freshness of entries, with freshest ones
-// at the front. Even a tiny cache size like 2 makes a dramatic
-// difference for typical JBIG2 documents.
-static const size_t kSymbolDictCacheMaxSize = 2;
-static_assert(kSymbolDictCacheMaxSize > 0,
-              "Symbol Dictionary Cache must have non-zero size");
-
 // static
 std::unique_ptr<CJBig2_Context> CJBig2_Context::Create(
     pdfium::span<const uint8_t> pGlobalSpan,
     uint64_t global_key,
     pdfium::span<const uint8_t> pSrcSpan,
     uint64_t src_key,
-    std::list<CJBig2_CachePair>* pSymbolDictCache) {
+    CJBig2_SymbolDictCache* pSymbolDictCache) {
   auto result = pdfium::WrapUnique(
       new CJBig2_Context(pSrcSpan, src_key, pSymbolDictCache, false));
   if (!pGlobalSpan.empty()) {
@@ -76,7 +64,7 @@ std::unique_ptr<CJBig2_Context> CJBig2_Context::Create(
 
 CJBig2_Context::CJBig2_Context(pdfium::span<const uint8_t> pSrcSpan,
                                uint64_t src_key,
-                               std::list<CJBig2_CachePair>* pSymbolDictCache,
+                               CJBig2_SymbolDictCache* pSymbolDictCache,
                                bool bIsGlobal)
     : stream_(std::make_unique<CJBig2_BitStream>(pSrcSpan, src_key)),
       huffman_tables_(CJBig2_HuffmanTable::kNumHuffmanTables),
@@ -561,57 +549,46 @@ JBig2_Result CJBig2_Context::ParseSymbolDict(CJBig2_Segment* pSegment) {
   }
 
   CJBig2_CompoundKey key(pSegment->key_, pSegment->data_offset_);
-  bool cache_hit = false;
   pSegment->result_type_ = JBIG2_SYMBOL_DICT_POINTER;
+  // It is very common for a JBIG2 dictionary to span multiple pages in a PDF
+  // file, so avoid decoding the same dictionary over and over again.
   if (is_global_ && key.first != 0) {
-    for (auto it = symbol_dict_cache_->begin(); it != symbol_dict_cache_->end();
-         ++it) {
-      if (it->first == key) {
-        pSegment->symbol_dict_ = it->second->DeepCopy();
-        symbol_dict_cache_->emplace_front(key, std::move(it->second));
-        symbol_dict_cache_->erase(it);
-        cache_hit = true;
-        break;
-      }
-    }
+    pSegment->symbol_dict_ = symbol_dict_cache_->Get(key);
   }
-  if (!cache_hit) {
+  if (!pSegment->symbol_dict_) {
+    RetainPtr<CJBig2_SymbolDict> dict;
     if (bUseGbContext) {
       auto pArithDecoder = std::make_unique<CJBig2_ArithDecoder>(stream_.get());
-      pSegment->symbol_dict_ = pSymbolDictDecoder->DecodeArith(
-          pArithDecoder.get(), gbContexts, grContexts);
-      if (!pSegment->symbol_dict_) {
+      dict = pSymbolDictDecoder->DecodeArith(pArithDecoder.get(), gbContexts,
+                                             grContexts);
+      if (!dict) {
         return JBig2_Result::kFailure;
       }
 
       stream_->alignByte();
       stream_->addOffset(2);
     } else {
-      pSegment->symbol_dict_ = pSymbolDictDecoder->DecodeHuffman(
-          stream_.get(), gbContexts, grContexts);
-      if (!pSegment->symbol_dict_) {
+      dict = pSymbolDictDecoder->DecodeHuffman(stream_.get(), gbContexts,
+                                               grContexts);
+      if (!dict) {
         return JBig2_Result::kFailure;
       }
       stream_->alignByte();
     }
-    if (is_global_) {
-      std::unique_ptr<CJBig2_SymbolDict> value =
-          pSegment->symbol_dict_->DeepCopy();
-      size_t size = symbol_dict_cache_->size();
-      while (size >= kSymbolDictCacheMaxSize) {
-        symbol_dict_cache_->pop_back();
-        --size;
+    // Keep the contexts with the dictionary before sharing it, so that cache
+    // hits get the same contexts as a fresh decode.
+    if (wFlags & 0x0200) {
+      if (bUseGbContext) {
+        dict->SetGbContexts(std::move(gbContexts));
+      }
+      if (bUseGrContext) {
+        dict->SetGrContexts(std::move(grContexts));
       }
-      symbol_dict_cache_->emplace_front(key, std::move(value));
-    }
-  }
-  if (wFlags & 0x0200) {
-    if (bUseGbContext) {
-      pSegment->symbol_dict_->SetGbContexts(std::move(gbContexts));
     }
-    if (bUseGrContext) {
-      pSegment->symbol_dict_->SetGrContexts(std::move(grContexts));
+    if (is_global_ && key.first != 0) {
+      symbol_dict_cache_->Put(key, dict);
     }
+    pSegment->symbol_dict_ = std::move(dict);
   }
   return JBig2_Result::kSuccess;
 }
@@ -10,15 +10,14 @@
 #include <stddef.h>
 #include <stdint.h>
 
-#include <list>
 #include <memory>
 #include <utility>
 #include <vector>
 
 #include "core/fxcodec/fx_codec_def.h"
-#include "core/fxcodec/jbig2/JBig2_DocumentContext.h"
 #include "core/fxcodec/jbig2/JBig2_Page.h"
 #include "core/fxcodec/jbig2/JBig2_Segment.h"
+#include "core/fxcodec/jbig2/JBig2_SymbolDictCache.h"
 #include "core/fxcrt/span.h"
 #include "core/fxcrt/unowned_ptr.h"
 
@@ -37,7 +36,7 @@ class CJBig2_Context {
       uint64_t global_key,
       pdfium::span<const uint8_t> pSrcSpan,
       uint64_t src_key,
-      std::list<CJBig2_CachePair>* pSymbolDictCache);
+      CJBig2_SymbolDictCache* pSymbolDictCache);
 
   ~CJBig2_Context();
 
@@ -59,7 +58,7 @@ class CJBig2_Context {
  private:
   CJBig2_Context(pdfium::span<const uint8_t> pSrcSpan,
                  uint64_t src_key,
-                 std::list<CJBig2_CachePair>* pSymbolDictCache,
+                 CJBig2_SymbolDictCache* pSymbolDictCache,
                  bool bIsGlobal);
 
   JBig2_Result DecodeSequential(PauseIndicatorIface* pPause);
@@ -105,7 +104,7 @@ class CJBig2_Context {
   std::unique_ptr<CJBig2_Segment> segment_;
   uint32_t offset_ = 0;
   JBig2RegionInfo ri_ = {};
-  UnownedPtr<std::list<CJBig2_CachePair>> const symbol_dict_cache_;
+  UnownedPtr<CJBig2_SymbolDictCache> const symbol_dict_cache_;
   bool reject_large_regions_when_fuzzing_ = false;
 };
 
@@ -6,9 +6,6 @@
 
 #include "core/fxcodec/jbig2/JBig2_DocumentContext.h"
 
-#include "core/fxcodec/jbig2/JBig2_Image.h"
-#include "core/fxcodec/jbig2/JBig2_SymbolDict.h"
-
 JBig2_DocumentContext::JBig2_DocumentContext() = default;
 
 JBig2_DocumentContext::~JBig2_DocumentContext() = default;
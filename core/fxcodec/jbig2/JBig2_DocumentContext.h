@@ -7,18 +7,7 @@
 #ifndef CORE_FXCODEC_JBIG2_JBIG2_DOCUMENTCONTEXT_H_
 #define CORE_FXCODEC_JBIG2_JBIG2_DOCUMENTCONTEXT_H_
 
-#include <stdint.h>
-
-#include <list>
-#include <memory>
-#include <utility>
-
-class CJBig2_SymbolDict;
-
-// Cache is keyed by both the key of a stream and an index within the stream.
-using CJBig2_CompoundKey = std::pair<uint64_t, uint32_t>;
-using CJBig2_CachePair =
-    std::pair<CJBig2_CompoundKey, std::unique_ptr<CJBig2_SymbolDict>>;
+#include "core/fxcodec/jbig2/JBig2_SymbolDictCache.h"
 
 // Holds per-document JBig2 related data.
 class JBig2_DocumentContext {
@@ -26,12 +15,10 @@ class JBig2_DocumentContext {
   JBig2_DocumentContext();
   ~JBig2_DocumentContext();
 
-  std::list<CJBig2_CachePair>* GetSymbolDictCache() {
-    return &symbol_dict_cache_;
-  }
+  CJBig2_SymbolDictCache* GetSymbolDictCache() { return &symbol_dict_cache_; }
 
  private:
-  std::list<CJBig2_CachePair> symbol_dict_cache_;
+  CJBig2_SymbolDictCache symbol_dict_cache_;
 };
 
 #endif  // CORE_FXCODEC_JBIG2_JBIG2_DOCUMENTCONTEXT_H_
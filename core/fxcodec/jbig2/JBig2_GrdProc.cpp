@@ -6,6 +6,7 @@
 
 #include "core/fxcodec/jbig2/JBig2_GrdProc.h"
 
+#include <algorithm>
 #include <array>
 #include <functional>
 #include <memory>
@@ -36,14 +37,91 @@ constexpr std::array<const uint16_t, 3> kOptConstant7 = {
     {0x0800, 0x0200, 0x0080}};
 constexpr std::array<const uint16_t, 3> kOptConstant8 = {
     {0x0010, 0x0008, 0x0004}};
-constexpr std::array<const uint16_t, 3> kOptConstant9 = {
-    {0x000c, 0x0009, 0x0007}};
-constexpr std::array<const uint16_t, 3> kOptConstant10 = {
-    {0x0007, 0x000f, 0x0007}};
-constexpr std::array<const uint16_t, 3> kOptConstant11 = {
-    {0x001f, 0x001f, 0x000f}};
-constexpr std::array<const uint16_t, 3> kOptConstant12 = {
-    {0x000f, 0x0007, 0x0003}};
+
+// Where the pixels of each generic region template go in the context, for
+// decoding with arbitrary AT pixels. The pixels of the row two above are
+// `line1`, those of the row above are `line2`, and the previously decoded
+// pixels of the current row are `line3`.
+struct GenericTemplateLayout {
+  uint16_t tpgdon_context;
+  // Number of pixels read from the row before decoding its first pixel.
+  uint8_t line1_pixels;
+  uint8_t line1_shift;
+  uint32_t line1_mask;
+  uint8_t line2_pixels;
+  uint8_t line2_shift;
+  uint32_t line2_mask;
+  uint32_t line3_mask;
+  uint8_t at_pixels;
+  std::array<uint8_t, 4> at_shifts;
+};
+
+constexpr std::array<GenericTemplateLayout, 4> kGenericTemplateLayouts = {{
+    {0x9b25, 2, 12, 0x07, 3, 5, 0x1f, 0x0f, 4, {4, 10, 11, 15}},
+    {0x0795, 3, 9, 0x0f, 3, 4, 0x1f, 0x07, 1, {3, 0, 0, 0}},
+    {0x00e5, 2, 7, 0x07, 2, 3, 0x0f, 0x03, 1, {2, 0, 0, 0}},
+    {0x0195, 0, 0, 0x00, 2, 5, 0x1f, 0x0f, 1, {4, 0, 0, 0}},
+}};
+
+const GenericTemplateLayout& GetTemplateLayout(uint8_t gb_template) {
+  return kGenericTemplateLayouts[std::min<uint8_t>(gb_template, 3)];
+}
+
+// Reads the pixels of an image row from left to right, a byte at a time. Like
+// CJBig2_Image::GetPixel(), returns 0 for pixels outside of the image. Only
+// reads the row correctly if it does not change while being read.
+class PixelRowReader {
+ public:
+  // Reads nothing but 0.
+  PixelRowReader() = default;
+
+  // Starts reading row `y` at column `x`.
+  PixelRowReader(const CJBig2_Image& image, int32_t y, int32_t x)
+      : line_(image.GetLine(y)), width_(image.width()), next_x_(x) {}
+
+  int Next() {
+    if (bits_left_ == 0) {
+      Load();
+    }
+    --bits_left_;
+    return (byte_ >> bits_left_) & 1;
+  }
+
+ private:
+  void Load() {
+    // Arithmetic shifts, so columns left of the image map to negative bytes.
+    const int32_t byte_start = next_x_ & ~7;
+    bits_left_ = 8 - (next_x_ - byte_start);
+    byte_ = 0;
+    if (line_ && byte_start >= 0 && byte_start < width_) {
+      // SAFETY: `byte_start` is within the row.
+      byte_ = UNSAFE_BUFFERS(line_[byte_start >> 3]);
+      const int32_t byte_end = byte_start + 8;
+      if (byte_end > width_) {
+        byte_ &= 0xff << (byte_end - width_);
+      }
+    }
+    next_x_ = byte_start + 8;
+  }
+
+  UNOWNED_PTR_EXCLUSION const uint8_t* line_ = nullptr;
+  int32_t width_ = 0;
+  // The first column after the bits in `byte_`.
+  int32_t next_x_ = 0;
+  uint32_t byte_ = 0;
+  int32_t bits_left_ = 0;
+};
+
+pdfium::span<uint8_t> GetLineSpan(const CJBig2_Image* image, int32_t y) {
+  // SAFETY: `stride` bytes per row.
+  return UNSAFE_BUFFERS(
+      pdfium::span(image->GetLine(y), static_cast<size_t>(image->stride())));
+}
+
+// `x` must be less than the image width.
+int GetLinePixel(pdfium::span<const uint8_t> line, int32_t x) {
+  return x >= 0 ? (line[x >> 3] >> (7 - (x & 7))) & 1 : 0;
+}
 
 }  // namespace
 
@@ -82,19 +160,18 @@ std::unique_ptr<CJBig2_Image> CJBig2_GRDProc::DecodeArith(
     case 0:
       return UseTemplate0Opt3()
                  ? DecodeArithOpt3(pArithDecoder, gbContexts, 0)
-                 : DecodeArithTemplateUnopt(pArithDecoder, gbContexts, 0);
+                 : DecodeArithUnopt(pArithDecoder, gbContexts);
     case 1:
-      return UseTemplate1Opt3()
-                 ? DecodeArithOpt3(pArithDecoder, gbContexts, 1)
-                 : DecodeArithTemplateUnopt(pArithDecoder, gbContexts, 1);
+      return UseTemplate1Opt3() ? DecodeArithOpt3(pArithDecoder, gbContexts, 1)
+                                : DecodeArithUnopt(pArithDecoder, gbContexts);
     case 2:
       return UseTemplate23Opt3()
                  ? DecodeArithOpt3(pArithDecoder, gbContexts, 2)
-                 : DecodeArithTemplateUnopt(pArithDecoder, gbContexts, 2);
+                 : DecodeArithUnopt(pArithDecoder, gbContexts);
     default:
       return UseTemplate23Opt3()
                  ? DecodeArithTemplate3Opt3(pArithDecoder, gbContexts)
-                 : DecodeArithTemplate3Unopt(pArithDecoder, gbContexts);
+                 : DecodeArithUnopt(pArithDecoder, gbContexts);
   }
 }
 
@@ -214,72 +291,102 @@ std::unique_ptr<CJBig2_Image> CJBig2_GRDProc::DecodeArithOpt3(
   });
 }
 
-std::unique_ptr<CJBig2_Image> CJBig2_GRDProc::DecodeArithTemplateUnopt(
+std::unique_ptr<CJBig2_Image> CJBig2_GRDProc::DecodeArithUnopt(
     CJBig2_ArithDecoder* pArithDecoder,
-    pdfium::span<JBig2ArithCtx> gbContexts,
-    int UNOPT) {
+    pdfium::span<JBig2ArithCtx> gbContexts) {
   auto GBREG = std::make_unique<CJBig2_Image>(GBW, GBH);
   if (!GBREG->data()) {
     return nullptr;
   }
 
   GBREG->Fill(false);
+  const uint16_t tpgdon_context = GetTemplateLayout(GBTEMPLATE).tpgdon_context;
   int LTP = 0;
-  uint8_t MOD2 = UNOPT % 2;
-  uint8_t DIV2 = UNOPT / 2;
-  uint8_t SHIFT = 4 - UNOPT;
   for (uint32_t h = 0; h < GBH; h++) {
     if (TPGDON) {
       if (pArithDecoder->IsComplete()) {
         return nullptr;
       }
 
-      LTP = LTP ^ pArithDecoder->Decode(&gbContexts[kOptConstant1[UNOPT]]);
+      LTP = LTP ^ pArithDecoder->Decode(&gbContexts[tpgdon_context]);
     }
     if (LTP) {
       GBREG->CopyLine(h, h - 1);
       continue;
     }
-    uint32_t line1 = GBREG->GetPixel(1 + MOD2, h - 2);
-    line1 |= GBREG->GetPixel(MOD2, h - 2) << 1;
-    if (UNOPT == 1) {
-      line1 |= GBREG->GetPixel(0, h - 2) << 2;
+    if (!DecodeArithLineUnopt(pArithDecoder, gbContexts, GBREG.get(), h)) {
+      return nullptr;
+    }
+  }
+  return GBREG;
+}
+
+bool CJBig2_GRDProc::DecodeArithLineUnopt(
+    CJBig2_ArithDecoder* pArithDecoder,
+    pdfium::span<JBig2ArithCtx> gbContexts,
+    CJBig2_Image* pImage,
+    int32_t h) const {
+  const GenericTemplateLayout& layout = GetTemplateLayout(GBTEMPLATE);
+  PixelRowReader line1_reader(*pImage, h - 2, 0);
+  PixelRowReader line2_reader(*pImage, h - 1, 0);
+  uint32_t line1 = 0;
+  for (uint8_t i = 0; i < layout.line1_pixels; ++i) {
+    line1 = (line1 << 1) | line1_reader.Next();
+  }
+  uint32_t line2 = 0;
+  for (uint8_t i = 0; i < layout.line2_pixels; ++i) {
+    line2 = (line2 << 1) | line2_reader.Next();
+  }
+  uint32_t line3 = 0;
+
+  // AT pixels to the left on the current row get decoded while the row is
+  // being read, so they are read directly from `line`. All other AT pixels
+  // are in rows that do not change while decoding this one.
+  pdfium::span<uint8_t> line = GetLineSpan(pImage, h);
+  std::array<PixelRowReader, 4> at_readers;
+  std::array<int32_t, 4> at_line_offsets = {};
+  for (uint8_t i = 0; i < layout.at_pixels; ++i) {
+    const int32_t dx = GBAT[2 * i];
+    const int32_t dy = GBAT[2 * i + 1];
+    if (dy == 0 && dx < 0) {
+      at_line_offsets[i] = dx;
+    } else {
+      at_readers[i] = PixelRowReader(*pImage, h + dy, dx);
     }
-    uint32_t line2 = GBREG->GetPixel(2 - DIV2, h - 1);
-    line2 |= GBREG->GetPixel(1 - DIV2, h - 1) << 1;
-    if (UNOPT < 2) {
-      line2 |= GBREG->GetPixel(0, h - 1) << 2;
+  }
+  PixelRowReader skip_reader;
+  if (USESKIP) {
+    skip_reader = PixelRowReader(*SKIP, h, 0);
+  }
+
+  for (uint32_t w = 0; w < GBW; w++) {
+    uint32_t CONTEXT = line3 | (line2 << layout.line2_shift) |
+                       (line1 << layout.line1_shift);
+    for (uint8_t i = 0; i < layout.at_pixels; ++i) {
+      const int pixel =
+          at_line_offsets[i]
+              ? GetLinePixel(line, static_cast<int32_t>(w) + at_line_offsets[i])
+              : at_readers[i].Next();
+      CONTEXT |= pixel << layout.at_shifts[i];
     }
-    uint32_t line3 = 0;
-    for (uint32_t w = 0; w < GBW; w++) {
-      int bVal = 0;
-      if (!USESKIP || !SKIP->GetPixel(w, h)) {
-        if (pArithDecoder->IsComplete()) {
-          return nullptr;
-        }
+    int bVal = 0;
+    if (!USESKIP || !skip_reader.Next()) {
+      if (pArithDecoder->IsComplete()) {
+        return false;
+      }
 
-        uint32_t CONTEXT = line3;
-        CONTEXT |= GBREG->GetPixel(w + GBAT[0], h + GBAT[1]) << SHIFT;
-        CONTEXT |= line2 << (SHIFT + 1);
-        CONTEXT |= line1 << kOptConstant9[UNOPT];
-        if (UNOPT == 0) {
-          CONTEXT |= GBREG->GetPixel(w + GBAT[2], h + GBAT[3]) << 10;
-          CONTEXT |= GBREG->GetPixel(w + GBAT[4], h + GBAT[5]) << 11;
-          CONTEXT |= GBREG->GetPixel(w + GBAT[6], h + GBAT[7]) << 15;
-        }
-        bVal = pArithDecoder->Decode(&gbContexts[CONTEXT]);
-        if (bVal) {
-          GBREG->SetPixel(w, h, bVal);
-        }
+      bVal = pArithDecoder->Decode(&gbContexts[CONTEXT]);
+      if (bVal) {
+        line[w >> 3] |= 0x80 >> (w & 7);
       }
-      line1 = ((line1 << 1) | GBREG->GetPixel(w + 2 + MOD2, h - 2)) &
-              kOptConstant10[UNOPT];
-      line2 = ((line2 << 1) | GBREG->GetPixel(w + 3 - DIV2, h - 1)) &
-              kOptConstant11[UNOPT];
-      line3 = ((line3 << 1) | bVal) & kOptConstant12[UNOPT];
     }
+    if (layout.line1_mask) {
+      line1 = ((line1 << 1) | line1_reader.Next()) & layout.line1_mask;
+    }
+    line2 = ((line2 << 1) | line2_reader.Next()) & layout.line2_mask;
+    line3 = ((line3 << 1) | bVal) & layout.line3_mask;
   }
-  return GBREG;
+  return true;
 }
 
 std::unique_ptr<CJBig2_Image> CJBig2_GRDProc::DecodeArithTemplate3Opt3(
@@ -375,55 +482,6 @@ std::unique_ptr<CJBig2_Image> CJBig2_GRDProc::DecodeArithTemplate3Opt3(
   });
 }
 
-std::unique_ptr<CJBig2_Image> CJBig2_GRDProc::DecodeArithTemplate3Unopt(
-    CJBig2_ArithDecoder* pArithDecoder,
-    pdfium::span<JBig2ArithCtx> gbContexts) {
-  auto GBREG = std::make_unique<CJBig2_Image>(GBW, GBH);
-  if (!GBREG->data()) {
-    return nullptr;
-  }
-
-  GBREG->Fill(false);
-  int LTP = 0;
-  for (uint32_t h = 0; h < GBH; h++) {
-    if (TPGDON) {
-      if (pArithDecoder->IsComplete()) {
-        return nullptr;
-      }
-
-      LTP = LTP ^ pArithDecoder->Decode(&gbContexts[0x0195]);
-    }
-    if (LTP == 1) {
-      GBREG->CopyLine(h, h - 1);
-    } else {
-      uint32_t line1 = GBREG->GetPixel(1, h - 1);
-      line1 |= GBREG->GetPixel(0, h - 1) << 1;
-      uint32_t line2 = 0;
-      for (uint32_t w = 0; w < GBW; w++) {
-        int bVal;
-        if (USESKIP && SKIP->GetPixel(w, h)) {
-          bVal = 0;
-        } else {
-          uint32_t CONTEXT = line2;
-          CONTEXT |= GBREG->GetPixel(w + GBAT[0], h + GBAT[1]) << 4;
-          CONTEXT |= line1 << 5;
-          if (pArithDecoder->IsComplete()) {
-            return nullptr;
-          }
-
-          bVal = pArithDecoder->Decode(&gbContexts[CONTEXT]);
-        }
-        if (bVal) {
-          GBREG->SetPixel(w, h, bVal);
-        }
-        line1 = ((line1 << 1) | GBREG->GetPixel(w + 2, h - 1)) & 0x1f;
-        line2 = ((line2 << 1) | bVal) & 0x0f;
-      }
-    }
-  }
-  return GBREG;
-}
-
 FXCODEC_STATUS CJBig2_GRDProc::StartDecodeArith(
     ProgressiveArithDecodeState* pState) {
   if (!CJBig2_Image::IsValidImageSize(GBW, GBH)) {
@@ -459,22 +517,22 @@ FXCODEC_STATUS CJBig2_GRDProc::ProgressiveDecodeArith(
     case 0:
       func = UseTemplate0Opt3()
                  ? &CJBig2_GRDProc::ProgressiveDecodeArithTemplate0Opt3
-                 : &CJBig2_GRDProc::ProgressiveDecodeArithTemplate0Unopt;
+                 : &CJBig2_GRDProc::ProgressiveDecodeArithUnopt;
       break;
     case 1:
       func = UseTemplate1Opt3()
                  ? &CJBig2_GRDProc::ProgressiveDecodeArithTemplate1Opt3
-                 : &CJBig2_GRDProc::ProgressiveDecodeArithTemplate1Unopt;
+                 : &CJBig2_GRDProc::ProgressiveDecodeArithUnopt;
       break;
     case 2:
       func = UseTemplate23Opt3()
                  ? &CJBig2_GRDProc::ProgressiveDecodeArithTemplate2Opt3
-                 : &CJBig2_GRDProc::ProgressiveDecodeArithTemplate2Unopt;
+                 : &CJBig2_GRDProc::ProgressiveDecodeArithUnopt;
       break;
     default:
       func = UseTemplate23Opt3()
                  ? &CJBig2_GRDProc::ProgressiveDecodeArithTemplate3Opt3
-                 : &CJBig2_GRDProc::ProgressiveDecodeArithTemplate3Unopt;
+                 : &CJBig2_GRDProc::ProgressiveDecodeArithUnopt;
       break;
   }
   CJBig2_Image* pImage = pState->pImage->get();
@@ -503,9 +561,6 @@ FXCODEC_STATUS CJBig2_GRDProc::StartDecodeMMR(
   bitpos = FaxModule::FaxG4Decode(pStream->getBufSpan(), bitpos, GBW, GBH,
                                   image->stride(), image->data());
   pStream->setBitPos(bitpos);
-  for (uint32_t i = 0; i < image->stride() * GBH; ++i) {
-    UNSAFE_TODO(image->data()[i] = ~image->data()[i]);
-  }
 
   progressive_status_ = FXCODEC_STATUS::kDecodeFinished;
   replace_rect_.left = 0;
@@ -640,66 +695,6 @@ FXCODEC_STATUS CJBig2_GRDProc::ProgressiveDecodeArithTemplate0Opt3(
   });
 }
 
-FXCODEC_STATUS CJBig2_GRDProc::ProgressiveDecodeArithTemplate0Unopt(
-    ProgressiveArithDecodeState* pState) {
-  CJBig2_Image* pImage = pState->pImage->get();
-  pdfium::span<JBig2ArithCtx> gbContexts = pState->gbContexts;
-  CJBig2_ArithDecoder* pArithDecoder = pState->pArithDecoder;
-  for (; loop_index_ < GBH; loop_index_++) {
-    if (TPGDON) {
-      if (pArithDecoder->IsComplete()) {
-        return FXCODEC_STATUS::kError;
-      }
-
-      ltp_ = ltp_ ^ pArithDecoder->Decode(&gbContexts[0x9b25]);
-    }
-    if (ltp_) {
-      pImage->CopyLine(loop_index_, loop_index_ - 1);
-    } else {
-      uint32_t line1 = pImage->GetPixel(1, loop_index_ - 2);
-      line1 |= pImage->GetPixel(0, loop_index_ - 2) << 1;
-      uint32_t line2 = pImage->GetPixel(2, loop_index_ - 1);
-      line2 |= pImage->GetPixel(1, loop_index_ - 1) << 1;
-      line2 |= pImage->GetPixel(0, loop_index_ - 1) << 2;
-      uint32_t line3 = 0;
-      for (uint32_t w = 0; w < GBW; w++) {
-        int bVal;
-        if (USESKIP && SKIP->GetPixel(w, loop_index_)) {
-          bVal = 0;
-        } else {
-          uint32_t CONTEXT = line3;
-          CONTEXT |= pImage->GetPixel(w + GBAT[0], loop_index_ + GBAT[1]) << 4;
-          CONTEXT |= line2 << 5;
-          CONTEXT |= pImage->GetPixel(w + GBAT[2], loop_index_ + GBAT[3]) << 10;
-          CONTEXT |= pImage->GetPixel(w + GBAT[4], loop_index_ + GBAT[5]) << 11;
-          CONTEXT |= line1 << 12;
-          CONTEXT |= pImage->GetPixel(w + GBAT[6], loop_index_ + GBAT[7]) << 15;
-          if (pArithDecoder->IsComplete()) {
-            return FXCODEC_STATUS::kError;
-          }
-
-          bVal = pArithDecoder->Decode(&gbContexts[CONTEXT]);
-        }
-        if (bVal) {
-          pImage->SetPixel(w, loop_index_, bVal);
-        }
-        line1 =
-            ((line1 << 1) | pImage->GetPixel(w + 2, loop_index_ - 2)) & 0x07;
-        line2 =
-            ((line2 << 1) | pImage->GetPixel(w + 3, loop_index_ - 1)) & 0x1f;
-        line3 = ((line3 << 1) | bVal) & 0x0f;
-      }
-    }
-    if (pState->pPause && pState->pPause->NeedToPauseNow()) {
-      loop_index_++;
-      progressive_status_ = FXCODEC_STATUS::kDecodeToBeContinued;
-      return FXCODEC_STATUS::kDecodeToBeContinued;
-    }
-  }
-  progressive_status_ = FXCODEC_STATUS::kDecodeFinished;
-  return FXCODEC_STATUS::kDecodeFinished;
-}
-
 FXCODEC_STATUS CJBig2_GRDProc::ProgressiveDecodeArithTemplate1Opt3(
     ProgressiveArithDecodeState* pState) {
   CJBig2_Image* pImage = pState->pImage->get();
@@ -810,62 +805,6 @@ FXCODEC_STATUS CJBig2_GRDProc::ProgressiveDecodeArithTemplate1Opt3(
   });
 }
 
-FXCODEC_STATUS CJBig2_GRDProc::ProgressiveDecodeArithTemplate1Unopt(
-    ProgressiveArithDecodeState* pState) {
-  CJBig2_Image* pImage = pState->pImage->get();
-  pdfium::span<JBig2ArithCtx> gbContexts = pState->gbContexts;
-  CJBig2_ArithDecoder* pArithDecoder = pState->pArithDecoder;
-  for (uint32_t h = 0; h < GBH; h++) {
-    if (TPGDON) {
-      if (pArithDecoder->IsComplete()) {
-        return FXCODEC_STATUS::kError;
-      }
-
-      ltp_ = ltp_ ^ pArithDecoder->Decode(&gbContexts[0x0795]);
-    }
-    if (ltp_) {
-      pImage->CopyLine(h, h - 1);
-    } else {
-      uint32_t line1 = pImage->GetPixel(2, h - 2);
-      line1 |= pImage->GetPixel(1, h - 2) << 1;
-      line1 |= pImage->GetPixel(0, h - 2) << 2;
-      uint32_t line2 = pImage->GetPixel(2, h - 1);
-      line2 |= pImage->GetPixel(1, h - 1) << 1;
-      line2 |= pImage->GetPixel(0, h - 1) << 2;
-      uint32_t line3 = 0;
-      for (uint32_t w = 0; w < GBW; w++) {
-        int bVal;
-        if (USESKIP && SKIP->GetPixel(w, h)) {
-          bVal = 0;
-        } else {
-          uint32_t CONTEXT = line3;
-          CONTEXT |= pImage->GetPixel(w + GBAT[0], h + GBAT[1]) << 3;
-          CONTEXT |= line2 << 4;
-          CONTEXT |= line1 << 9;
-          if (pArithDecoder->IsComplete()) {
-            return FXCODEC_STATUS::kError;
-          }
-
-          bVal = pArithDecoder->Decode(&gbContexts[CONTEXT]);
-        }
-        if (bVal) {
-          pImage->SetPixel(w, h, bVal);
-        }
-        line1 = ((line1 << 1) | pImage->GetPixel(w + 3, h - 2)) & 0x0f;
-        line2 = ((line2 << 1) | pImage->GetPixel(w + 3, h - 1)) & 0x1f;
-        line3 = ((line3 << 1) | bVal) & 0x07;
-      }
-    }
-    if (pState->pPause && pState->pPause->NeedToPauseNow()) {
-      loop_index_++;
-      progressive_status_ = FXCODEC_STATUS::kDecodeToBeContinued;
-      return FXCODEC_STATUS::kDecodeToBeContinued;
-    }
-  }
-  progressive_status_ = FXCODEC_STATUS::kDecodeFinished;
-  return FXCODEC_STATUS::kDecodeFinished;
-}
-
 FXCODEC_STATUS CJBig2_GRDProc::ProgressiveDecodeArithTemplate2Opt3(
     ProgressiveArithDecodeState* pState) {
   CJBig2_Image* pImage = pState->pImage->get();
@@ -976,62 +915,6 @@ FXCODEC_STATUS CJBig2_GRDProc::ProgressiveDecodeArithTemplate2Opt3(
   })
 }
 
-FXCODEC_STATUS CJBig2_GRDProc::ProgressiveDecodeArithTemplate2Unopt(
-    ProgressiveArithDecodeState* pState) {
-  CJBig2_Image* pImage = pState->pImage->get();
-  pdfium::span<JBig2ArithCtx> gbContexts = pState->gbContexts;
-  CJBig2_ArithDecoder* pArithDecoder = pState->pArithDecoder;
-  for (; loop_index_ < GBH; loop_index_++) {
-    if (TPGDON) {
-      if (pArithDecoder->IsComplete()) {
-        return FXCODEC_STATUS::kError;
-      }
-
-      ltp_ = ltp_ ^ pArithDecoder->Decode(&gbContexts[0x00e5]);
-    }
-    if (ltp_) {
-      pImage->CopyLine(loop_index_, loop_index_ - 1);
-    } else {
-      uint32_t line1 = pImage->GetPixel(1, loop_index_ - 2);
-      line1 |= pImage->GetPixel(0, loop_index_ - 2) << 1;
-      uint32_t line2 = pImage->GetPixel(1, loop_index_ - 1);
-      line2 |= pImage->GetPixel(0, loop_index_ - 1) << 1;
-      uint32_t line3 = 0;
-      for (uint32_t w = 0; w < GBW; w++) {
-        int bVal;
-        if (USESKIP && SKIP->GetPixel(w, loop_index_)) {
-          bVal = 0;
-        } else {
-          uint32_t CONTEXT = line3;
-          CONTEXT |= pImage->GetPixel(w + GBAT[0], loop_index_ + GBAT[1]) << 2;
-          CONTEXT |= line2 << 3;
-          CONTEXT |= line1 << 7;
-          if (pArithDecoder->IsComplete()) {
-            return FXCODEC_STATUS::kError;
-          }
-
-          bVal = pArithDecoder->Decode(&gbContexts[CONTEXT]);
-        }
-        if (bVal) {
-          pImage->SetPixel(w, loop_index_, bVal);
-        }
-        line1 =
-            ((line1 << 1) | pImage->GetPixel(w + 2, loop_index_ - 2)) & 0x07;
-        line2 =
-            ((line2 << 1) | pImage->GetPixel(w + 2, loop_index_ - 1)) & 0x0f;
-        line3 = ((line3 << 1) | bVal) & 0x03;
-      }
-    }
-    if (pState->pPause && pState->pPause->NeedToPauseNow()) {
-      loop_index_++;
-      progressive_status_ = FXCODEC_STATUS::kDecodeToBeContinued;
-      return FXCODEC_STATUS::kDecodeToBeContinued;
-    }
-  }
-  progressive_status_ = FXCODEC_STATUS::kDecodeFinished;
-  return FXCODEC_STATUS::kDecodeFinished;
-}
-
 FXCODEC_STATUS CJBig2_GRDProc::ProgressiveDecodeArithTemplate3Opt3(
     ProgressiveArithDecodeState* pState) {
   CJBig2_Image* pImage = pState->pImage->get();
@@ -1127,46 +1010,25 @@ FXCODEC_STATUS CJBig2_GRDProc::ProgressiveDecodeArithTemplate3Opt3(
   });
 }
 
-FXCODEC_STATUS CJBig2_GRDProc::ProgressiveDecodeArithTemplate3Unopt(
+FXCODEC_STATUS CJBig2_GRDProc::ProgressiveDecodeArithUnopt(
     ProgressiveArithDecodeState* pState) {
   CJBig2_Image* pImage = pState->pImage->get();
   pdfium::span<JBig2ArithCtx> gbContexts = pState->gbContexts;
   CJBig2_ArithDecoder* pArithDecoder = pState->pArithDecoder;
+  const uint16_t tpgdon_context = GetTemplateLayout(GBTEMPLATE).tpgdon_context;
   for (; loop_index_ < GBH; loop_index_++) {
     if (TPGDON) {
       if (pArithDecoder->IsComplete()) {
         return FXCODEC_STATUS::kError;
       }
 
-      ltp_ = ltp_ ^ pArithDecoder->Decode(&gbContexts[0x0195]);
+      ltp_ = ltp_ ^ pArithDecoder->Decode(&gbContexts[tpgdon_context]);
     }
     if (ltp_) {
       pImage->CopyLine(loop_index_, loop_index_ - 1);
-    } else {
-      uint32_t line1 = pImage->GetPixel(1, loop_index_ - 1);
-      line1 |= pImage->GetPixel(0, loop_index_ - 1) << 1;
-      uint32_t line2 = 0;
-      for (uint32_t w = 0; w < GBW; w++) {
-        int bVal;
-        if (USESKIP && SKIP->GetPixel(w, loop_index_)) {
-          bVal = 0;
-        } else {
-          uint32_t CONTEXT = line2;
-          CONTEXT |= pImage->GetPixel(w + GBAT[0], loop_index_ + GBAT[1]) << 4;
-          CONTEXT |= line1 << 5;
-          if (pArithDecoder->IsComplete()) {
-            return FXCODEC_STATUS::kError;
-          }
-
-          bVal = pArithDecoder->Decode(&gbContexts[CONTEXT]);
-        }
-        if (bVal) {
-          pImage->SetPixel(w, loop_index_, bVal);
-        }
-        line1 =
-            ((line1 << 1) | pImage->GetPixel(w + 2, loop_index_ - 1)) & 0x1f;
-        line2 = ((line2 << 1) | bVal) & 0x0f;
-      }
+    } else if (!DecodeArithLineUnopt(pArithDecoder, gbContexts, pImage,
+                                     loop_index_)) {
+      return FXCODEC_STATUS::kError;
     }
     if (pState->pPause && pState->pPause->NeedToPauseNow()) {
       loop_index_++;
@@ -67,33 +67,31 @@ class CJBig2_GRDProc {
   FXCODEC_STATUS ProgressiveDecodeArith(ProgressiveArithDecodeState* pState);
   FXCODEC_STATUS ProgressiveDecodeArithTemplate0Opt3(
       ProgressiveArithDecodeState* pState);
-  FXCODEC_STATUS ProgressiveDecodeArithTemplate0Unopt(
-      ProgressiveArithDecodeState* pState);
   FXCODEC_STATUS ProgressiveDecodeArithTemplate1Opt3(
       ProgressiveArithDecodeState* pState);
-  FXCODEC_STATUS ProgressiveDecodeArithTemplate1Unopt(
-      ProgressiveArithDecodeState* pState);
   FXCODEC_STATUS ProgressiveDecodeArithTemplate2Opt3(
       ProgressiveArithDecodeState* pState);
-  FXCODEC_STATUS ProgressiveDecodeArithTemplate2Unopt(
-      ProgressiveArithDecodeState* pState);
   FXCODEC_STATUS ProgressiveDecodeArithTemplate3Opt3(
       ProgressiveArithDecodeState* pState);
-  FXCODEC_STATUS ProgressiveDecodeArithTemplate3Unopt(
+  FXCODEC_STATUS ProgressiveDecodeArithUnopt(
       ProgressiveArithDecodeState* pState);
 
   std::unique_ptr<CJBig2_Image> DecodeArithOpt3(
       CJBig2_ArithDecoder* pArithDecoder,
       pdfium::span<JBig2ArithCtx> gbContexts,
       int OPT);
-  std::unique_ptr<CJBig2_Image> DecodeArithTemplateUnopt(
-      CJBig2_ArithDecoder* pArithDecoder,
-      pdfium::span<JBig2ArithCtx> gbContexts,
-      int UNOPT);
-  std::unique_ptr<CJBig2_Image> DecodeArithTemplate3Opt3(
+  // Decodes any template with arbitrary AT pixels, and supports USESKIP.
+  std::unique_ptr<CJBig2_Image> DecodeArithUnopt(
       CJBig2_ArithDecoder* pArithDecoder,
       pdfium::span<JBig2ArithCtx> gbContexts);
-  std::unique_ptr<CJBig2_Image> DecodeArithTemplate3Unopt(
+  // Decodes row `h` of `pImage` for DecodeArithUnopt() and
+  // ProgressiveDecodeArithUnopt(). Returns false if `pArithDecoder` runs out
+  // of data.
+  bool DecodeArithLineUnopt(CJBig2_ArithDecoder* pArithDecoder,
+                            pdfium::span<JBig2ArithCtx> gbContexts,
+                            CJBig2_Image* pImage,
+                            int32_t h) const;
+  std::unique_ptr<CJBig2_Image> DecodeArithTemplate3Opt3(
       CJBig2_ArithDecoder* pArithDecoder,
       pdfium::span<JBig2ArithCtx> gbContexts);
 
@@ -0,0 +1,150 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxcodec/jbig2/JBig2_GrdProc.h"
+
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "core/fxcodec/jbig2/JBig2_ArithDecoder.h"
+#include "core/fxcodec/jbig2/JBig2_BitStream.h"
+#include "core/fxcodec/jbig2/JBig2_Image.h"
+#include "core/fxcrt/pauseindicator_iface.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+constexpr uint32_t kWidth = 45;
+constexpr uint32_t kHeight = 30;
+
+class AlwaysPause final : public PauseIndicatorIface {
+ public:
+  bool NeedToPauseNow() override { return true; }
+};
+
+// Arbitrary bytes, which decode to a noisy image.
+std::vector<uint8_t> CreateData() {
+  std::vector<uint8_t> data(2000);
+  uint32_t seed = 12345;
+  for (uint8_t& byte : data) {
+    seed = seed * 1103515245 + 12345;
+    byte = static_cast<uint8_t>(seed >> 16);
+  }
+  return data;
+}
+
+size_t GetContextSize(uint8_t gb_template) {
+  return gb_template == 0 ? 65536 : gb_template == 1 ? 8192 : 1024;
+}
+
+// Sets up `proc` with the nominal AT pixels of `gb_template`.
+void InitProc(CJBig2_GRDProc* proc, uint8_t gb_template) {
+  proc->MMR = false;
+  proc->TPGDON = true;
+  proc->USESKIP = false;
+  proc->GBTEMPLATE = gb_template;
+  proc->GBW = kWidth;
+  proc->GBH = kHeight;
+  if (gb_template == 0) {
+    proc->GBAT = {3, -1, -3, -1, 2, -2, -2, -2};
+  } else {
+    proc->GBAT = {gb_template == 1 ? int8_t{3} : int8_t{2}, -1};
+  }
+}
+
+std::unique_ptr<CJBig2_Image> Decode(CJBig2_GRDProc* proc) {
+  std::vector<uint8_t> data = CreateData();
+  CJBig2_BitStream stream(data, 0);
+  CJBig2_ArithDecoder decoder(&stream);
+  std::vector<JBig2ArithCtx> contexts(GetContextSize(proc->GBTEMPLATE));
+  return proc->DecodeArith(&decoder, contexts);
+}
+
+std::unique_ptr<CJBig2_Image> DecodeProgressive(CJBig2_GRDProc* proc) {
+  std::vector<uint8_t> data = CreateData();
+  CJBig2_BitStream stream(data, 0);
+  CJBig2_ArithDecoder decoder(&stream);
+  std::vector<JBig2ArithCtx> contexts(GetContextSize(proc->GBTEMPLATE));
+  std::unique_ptr<CJBig2_Image> image;
+  AlwaysPause pause;
+  CJBig2_GRDProc::ProgressiveArithDecodeState state;
+  state.pImage = &image;
+  state.pArithDecoder = &decoder;
+  state.gbContexts = contexts;
+  state.pPause = &pause;
+  FXCODEC_STATUS status = proc->StartDecodeArith(&state);
+  uint32_t rows = 1;
+  while (status == FXCODEC_STATUS::kDecodeToBeContinued) {
+    // Each call decodes one more row.
+    EXPECT_EQ(rows, static_cast<uint32_t>(proc->GetReplaceRect().bottom));
+    status = proc->ContinueDecode(&state);
+    ++rows;
+  }
+  EXPECT_EQ(FXCODEC_STATUS::kDecodeFinished, status);
+  return image;
+}
+
+void ExpectSameImage(const CJBig2_Image& expected, const CJBig2_Image& actual) {
+  ASSERT_EQ(expected.width(), actual.width());
+  ASSERT_EQ(expected.height(), actual.height());
+  int set_pixels = 0;
+  for (int32_t y = 0; y < expected.height(); ++y) {
+    for (int32_t x = 0; x < expected.width(); ++x) {
+      EXPECT_EQ(expected.GetPixel(x, y), actual.GetPixel(x, y))
+          << "at " << x << ", " << y;
+      set_pixels += expected.GetPixel(x, y);
+    }
+  }
+  EXPECT_GT(set_pixels, 0);
+}
+
+}  // namespace
+
+TEST(CJBig2GRDProcTest, GenericTemplatesMatchOptimized) {
+  // An all white SKIP image skips nothing, but makes the generic decoder
+  // handle the nominal AT pixels, which the optimized decoders hardcode.
+  CJBig2_Image skip(kWidth, kHeight);
+  skip.Fill(false);
+  for (uint8_t gb_template = 0; gb_template < 4; ++gb_template) {
+    SCOPED_TRACE(gb_template);
+    CJBig2_GRDProc optimized;
+    InitProc(&optimized, gb_template);
+    std::unique_ptr<CJBig2_Image> expected = Decode(&optimized);
+    ASSERT_TRUE(expected);
+
+    CJBig2_GRDProc generic;
+    InitProc(&generic, gb_template);
+    generic.USESKIP = true;
+    generic.SKIP = &skip;
+    std::unique_ptr<CJBig2_Image> actual = Decode(&generic);
+    ASSERT_TRUE(actual);
+    ExpectSameImage(*expected, *actual);
+
+    CJBig2_GRDProc progressive;
+    InitProc(&progressive, gb_template);
+    progressive.USESKIP = true;
+    progressive.SKIP = &skip;
+    actual = DecodeProgressive(&progressive);
+    ASSERT_TRUE(actual);
+    ExpectSameImage(*expected, *actual);
+  }
+}
+
+TEST(CJBig2GRDProcTest, GenericTemplateProgressive) {
+  // AT pixels on the current row, and in rows above and below.
+  CJBig2_GRDProc generic;
+  InitProc(&generic, 0);
+  generic.GBAT = {-2, 0, 5, 0, -9, -3, 4, 1};
+  std::unique_ptr<CJBig2_Image> expected = Decode(&generic);
+  ASSERT_TRUE(expected);
+
+  CJBig2_GRDProc progressive;
+  InitProc(&progressive, 0);
+  progressive.GBAT = generic.GBAT;
+  std::unique_ptr<CJBig2_Image> actual = DecodeProgressive(&progressive);
+  ASSERT_TRUE(actual);
+  ExpectSameImage(*expected, *actual);
+}
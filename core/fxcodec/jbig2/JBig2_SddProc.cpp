@@ -22,13 +22,14 @@
 #include "core/fxcodec/jbig2/JBig2_TrdProc.h"
 #include "core/fxcrt/fx_memcpy_wrappers.h"
 #include "core/fxcrt/fx_safe_types.h"
+#include "core/fxcrt/retain_ptr.h"
 #include "core/fxcrt/stl_util.h"
 
 CJBig2_SDDProc::CJBig2_SDDProc() = default;
 
 CJBig2_SDDProc::~CJBig2_SDDProc() = default;
 
-std::unique_ptr<CJBig2_SymbolDict> CJBig2_SDDProc::DecodeArith(
+RetainPtr<CJBig2_SymbolDict> CJBig2_SDDProc::DecodeArith(
     CJBig2_ArithDecoder* pArithDecoder,
     pdfium::span<JBig2ArithCtx> gbContexts,
     pdfium::span<JBig2ArithCtx> grContexts) {
@@ -238,8 +239,7 @@ std::unique_ptr<CJBig2_SymbolDict> CJBig2_SDDProc::DecodeArith(
     return nullptr;
   }
 
-  std::unique_ptr<CJBig2_SymbolDict> dict =
-      std::make_unique<CJBig2_SymbolDict>();
+  auto dict = pdfium::MakeRetain<CJBig2_SymbolDict>();
   for (uint32_t i = 0, j = 0; i < SDNUMINSYMS + SDNUMNEWSYMS; ++i) {
     if (!EXFLAGS[i] || j >= SDNUMEXSYMS) {
       continue;
@@ -256,7 +256,7 @@ std::unique_ptr<CJBig2_SymbolDict> CJBig2_SDDProc::DecodeArith(
   return dict;
 }
 
-std::unique_ptr<CJBig2_SymbolDict> CJBig2_SDDProc::DecodeHuffman(
+RetainPtr<CJBig2_SymbolDict> CJBig2_SDDProc::DecodeHuffman(
     CJBig2_BitStream* pStream,
     pdfium::span<JBig2ArithCtx> gbContexts,
     pdfium::span<JBig2ArithCtx> grContexts) {
@@ -524,7 +524,7 @@ std::unique_ptr<CJBig2_SymbolDict> CJBig2_SDDProc::DecodeHuffman(
     return nullptr;
   }
 
-  auto dict = std::make_unique<CJBig2_SymbolDict>();
+  auto dict = pdfium::MakeRetain<CJBig2_SymbolDict>();
   for (uint32_t i = 0, j = 0; i < SDNUMINSYMS + SDNUMNEWSYMS; ++i) {
     if (!EXFLAGS[i] || j >= SDNUMEXSYMS) {
       continue;
@@ -14,6 +14,7 @@
 #include <vector>
 
 #include "core/fxcodec/jbig2/JBig2_ArithDecoder.h"
+#include "core/fxcrt/retain_ptr.h"
 #include "core/fxcrt/span.h"
 #include "core/fxcrt/unowned_ptr.h"
 
@@ -27,12 +28,12 @@ class CJBig2_SDDProc {
   CJBig2_SDDProc();
   ~CJBig2_SDDProc();
 
-  std::unique_ptr<CJBig2_SymbolDict> DecodeArith(
+  RetainPtr<CJBig2_SymbolDict> DecodeArith(
       CJBig2_ArithDecoder* pArithDecoder,
       pdfium::span<JBig2ArithCtx> gbContexts,
       pdfium::span<JBig2ArithCtx> grContexts);
 
-  std::unique_ptr<CJBig2_SymbolDict> DecodeHuffman(
+  RetainPtr<CJBig2_SymbolDict> DecodeHuffman(
       CJBig2_BitStream* pStream,
       pdfium::span<JBig2ArithCtx> gbContexts,
       pdfium::span<JBig2ArithCtx> grContexts);
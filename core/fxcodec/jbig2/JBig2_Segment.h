@@ -54,7 +54,7 @@ class CJBig2_Segment {
   uint64_t key_ = 0;
   JBig2_SegmentState state_ = JBIG2_SEGMENT_HEADER_UNPARSED;
   JBig2_ResultType result_type_ = JBIG2_VOID_POINTER;
-  std::unique_ptr<CJBig2_SymbolDict> symbol_dict_;
+  RetainPtr<const CJBig2_SymbolDict> symbol_dict_;
   std::unique_ptr<CJBig2_PatternDict> pattern_dict_;
   std::unique_ptr<CJBig2_Image> image_;
   std::unique_ptr<CJBig2_HuffmanTable> huffman_table_;
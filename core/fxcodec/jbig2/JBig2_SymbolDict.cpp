@@ -6,19 +6,26 @@
 
 #include "core/fxcodec/jbig2/JBig2_SymbolDict.h"
 
+#include <limits>
+
 #include "core/fxcodec/jbig2/JBig2_Image.h"
+#include "core/fxcrt/fx_safe_types.h"
 
 CJBig2_SymbolDict::CJBig2_SymbolDict() = default;
 
 CJBig2_SymbolDict::~CJBig2_SymbolDict() = default;
 
-std::unique_ptr<CJBig2_SymbolDict> CJBig2_SymbolDict::DeepCopy() const {
-  auto dst = std::make_unique<CJBig2_SymbolDict>();
+size_t CJBig2_SymbolDict::EstimateSize() const {
+  FX_SAFE_SIZE_T size = sizeof(*this);
+  size += (gb_contexts_.size() + gr_contexts_.size()) * sizeof(JBig2ArithCtx);
   for (const auto& image : sdexsyms_) {
-    dst->sdexsyms_.push_back(image ? std::make_unique<CJBig2_Image>(*image)
-                                   : nullptr);
+    size += sizeof(image);
+    if (image) {
+      FX_SAFE_SIZE_T image_size = image->stride();
+      image_size *= image->height();
+      size += sizeof(CJBig2_Image);
+      size += image_size;
+    }
   }
-  dst->gb_contexts_ = gb_contexts_;
-  dst->gr_contexts_ = gr_contexts_;
-  return dst;
+  return size.ValueOrDefault(std::numeric_limits<size_t>::max());
 }
@@ -7,19 +7,24 @@
 #ifndef CORE_FXCODEC_JBIG2_JBIG2_SYMBOLDICT_H_
 #define CORE_FXCODEC_JBIG2_JBIG2_SYMBOLDICT_H_
 
+#include <stddef.h>
+
 #include <memory>
 #include <utility>
 #include <vector>
 
 #include "core/fxcodec/jbig2/JBig2_ArithDecoder.h"
 #include "core/fxcodec/jbig2/JBig2_Image.h"
+#include "core/fxcrt/retain_ptr.h"
 
-class CJBig2_SymbolDict {
+// Shared between segments and documents' symbol dictionary caches once
+// decoded, and must not change from then on.
+class CJBig2_SymbolDict final : public Retainable {
  public:
-  CJBig2_SymbolDict();
-  ~CJBig2_SymbolDict();
+  CONSTRUCT_VIA_MAKE_RETAIN;
 
-  std::unique_ptr<CJBig2_SymbolDict> DeepCopy() const;
+  // Approximate number of bytes used by the dictionary and its symbols.
+  size_t EstimateSize() const;
 
   void AddImage(std::unique_ptr<CJBig2_Image> image) {
     sdexsyms_.push_back(std::move(image));
@@ -39,6 +44,9 @@ class CJBig2_SymbolDict {
   }
 
  private:
+  CJBig2_SymbolDict();
+  ~CJBig2_SymbolDict() override;
+
   std::vector<JBig2ArithCtx> gb_contexts_;
   std::vector<JBig2ArithCtx> gr_contexts_;
   std::vector<std::unique_ptr<CJBig2_Image>> sdexsyms_;
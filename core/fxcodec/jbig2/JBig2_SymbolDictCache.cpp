@@ -0,0 +1,107 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxcodec/jbig2/JBig2_SymbolDictCache.h"
+
+#include <iterator>
+#include <mutex>
+#include <utility>
+
+#include "core/fxcodec/jbig2/JBig2_SymbolDict.h"
+#include "core/fxcrt/check.h"
+
+namespace {
+
+constinit CacheBudget g_symbol_dict_budget(
+    CJBig2_SymbolDictCache::kDefaultMaxBytes);
+
+}  // namespace
+
+// static
+CacheBudget* CJBig2_SymbolDictCache::GetSymbolDictBudget() {
+  return &g_symbol_dict_budget;
+}
+
+CJBig2_SymbolDictCache::CJBig2_SymbolDictCache()
+    : CJBig2_SymbolDictCache(GetSymbolDictBudget()) {}
+
+CJBig2_SymbolDictCache::CJBig2_SymbolDictCache(CacheBudget* budget)
+    : budget_(budget) {
+  std::lock_guard<std::mutex> lock(budget_->lock());
+  budget_->AddEvictable(this);
+}
+
+CJBig2_SymbolDictCache::~CJBig2_SymbolDictCache() {
+  std::lock_guard<std::mutex> lock(budget_->lock());
+  budget_->RemoveEvictable(this);
+  budget_->Remove(bytes_);
+}
+
+RetainPtr<const CJBig2_SymbolDict> CJBig2_SymbolDictCache::Get(
+    const CJBig2_CompoundKey& key) {
+  std::lock_guard<std::mutex> lock(budget_->lock());
+  budget_->EvictUntilFits(this, 0);
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    budget_->RecordMiss();
+    return nullptr;
+  }
+
+  budget_->RecordHit();
+  it->second->last_use = budget_->Use(this);
+  entries_.splice(entries_.begin(), entries_, it->second);
+  return it->second->dict;
+}
+
+void CJBig2_SymbolDictCache::Put(const CJBig2_CompoundKey& key,
+                                 RetainPtr<const CJBig2_SymbolDict> dict) {
+  CHECK(dict);
+  std::lock_guard<std::mutex> lock(budget_->lock());
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    budget_->Remove(Erase(it->second));
+  }
+
+  const size_t bytes = dict->EstimateSize();
+  if (bytes > budget_->max_bytes() || !budget_->EvictUntilFits(this, bytes)) {
+    return;
+  }
+
+  entries_.push_front({.key = key,
+                       .dict = std::move(dict),
+                       .bytes = bytes,
+                       .last_use = budget_->Use(this)});
+  index_[key] = entries_.begin();
+  bytes_ += bytes;
+  budget_->Add(bytes);
+}
+
+void CJBig2_SymbolDictCache::Trim() {
+  std::lock_guard<std::mutex> lock(budget_->lock());
+  budget_->EvictUntilFits(this, 0);
+}
+
+size_t CJBig2_SymbolDictCache::bytes() const {
+  std::lock_guard<std::mutex> lock(budget_->lock());
+  return bytes_;
+}
+
+std::optional<uint64_t> CJBig2_SymbolDictCache::GetOldestUse() const {
+  if (entries_.empty()) {
+    return std::nullopt;
+  }
+  return entries_.back().last_use;
+}
+
+void CJBig2_SymbolDictCache::EvictOldest() {
+  budget_->Evict(Erase(std::prev(entries_.end())));
+}
+
+size_t CJBig2_SymbolDictCache::Erase(EntryList::iterator entry_it) {
+  index_.erase(entry_it->key);
+  const size_t bytes = entry_it->bytes;
+  bytes_ -= bytes;
+  entries_.erase(entry_it);
+  return bytes;
+}
@@ -0,0 +1,88 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FXCODEC_JBIG2_JBIG2_SYMBOLDICTCACHE_H_
+#define CORE_FXCODEC_JBIG2_JBIG2_SYMBOLDICTCACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <list>
+#include <optional>
+#include <utility>
+
+#include "core/fxcrt/cache_budget.h"
+#include "core/fxcrt/retain_ptr.h"
+#include "core/fxcrt/unowned_ptr.h"
+#include "third_party/abseil-cpp/absl/container/flat_hash_map.h"
+
+class CJBig2_SymbolDict;
+
+// Cache is keyed by both the key of a stream and an index within the stream.
+using CJBig2_CompoundKey = std::pair<uint64_t, uint32_t>;
+
+// Caches symbol dictionaries decoded from JBIG2Globals streams, which are
+// often shared by many pages. The symbol dictionary caches of all documents
+// share one byte budget, and evict the least recently used dictionaries across
+// the documents used on the current thread to make room. A dictionary that
+// still does not fit does not get cached.
+class CJBig2_SymbolDictCache final : public CacheBudget::Evictable {
+ public:
+  static constexpr size_t kDefaultMaxBytes = 32 * 1024 * 1024;
+
+  // The budget that symbol dictionary caches use by default.
+  // `kDefaultMaxBytes` by default.
+  static CacheBudget* GetSymbolDictBudget();
+
+  CJBig2_SymbolDictCache();
+  // `budget` must outlive this cache.
+  explicit CJBig2_SymbolDictCache(CacheBudget* budget);
+  ~CJBig2_SymbolDictCache();
+
+  // Returns the dictionary cached for `key`, or nullptr. The dictionary is
+  // shared with the cache and with other callers, so it stays immutable.
+  // Evicts dictionaries first if the budget is exceeded.
+  RetainPtr<const CJBig2_SymbolDict> Get(const CJBig2_CompoundKey& key);
+
+  // Caches `dict` for `key`, unless it does not fit in the budget after
+  // evicting other dictionaries.
+  void Put(const CJBig2_CompoundKey& key,
+           RetainPtr<const CJBig2_SymbolDict> dict);
+
+  // Evicts dictionaries until the budget is no longer exceeded, or the
+  // documents used on the current thread have no dictionaries left.
+  void Trim();
+
+  CacheBudget* budget() const { return budget_; }
+
+  // Bytes used by this cache's dictionaries.
+  size_t bytes() const;
+
+  // CacheBudget::Evictable:
+  std::optional<uint64_t> GetOldestUse() const override;
+  void EvictOldest() override;
+
+ private:
+  struct Entry {
+    CJBig2_CompoundKey key;
+    RetainPtr<const CJBig2_SymbolDict> dict;
+    size_t bytes;
+    // From CacheBudget::Use().
+    uint64_t last_use;
+  };
+  using EntryList = std::list<Entry>;
+
+  // Returns the bytes freed, for the caller to remove from the budget.
+  size_t Erase(EntryList::iterator entry_it);
+
+  UnownedPtr<CacheBudget> const budget_;
+  // The members below are guarded by the budget's lock, as other caches
+  // sharing the budget may evict from this one.
+  size_t bytes_ = 0;
+  // Most recently used first.
+  EntryList entries_;
+  absl::flat_hash_map<CJBig2_CompoundKey, EntryList::iterator> index_;
+};
+
+#endif  // CORE_FXCODEC_JBIG2_JBIG2_SYMBOLDICTCACHE_H_
@@ -0,0 +1,168 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxcodec/jbig2/JBig2_SymbolDictCache.h"
+
+#include <memory>
+#include <thread>
+#include <utility>
+
+#include "core/fxcodec/jbig2/JBig2_Image.h"
+#include "core/fxcodec/jbig2/JBig2_SymbolDict.h"
+#include "core/fxcrt/cache_budget.h"
+#include "core/fxcrt/retain_ptr.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+// Returns a dictionary with one `width` by 8 symbol, with the top left pixel
+// set.
+RetainPtr<CJBig2_SymbolDict> CreateSymbolDict(int32_t width) {
+  auto image = std::make_unique<CJBig2_Image>(width, 8);
+  image->Fill(false);
+  image->SetPixel(0, 0, 1);
+  auto dict = pdfium::MakeRetain<CJBig2_SymbolDict>();
+  dict->AddImage(std::move(image));
+  return dict;
+}
+
+}  // namespace
+
+TEST(CJBig2SymbolDictCacheTest, GetReturnsSharedDict) {
+  CacheBudget budget(CacheBudget::kUnlimited);
+  CJBig2_SymbolDictCache cache(&budget);
+  const CJBig2_CompoundKey key(1, 0);
+  EXPECT_FALSE(cache.Get(key));
+
+  RetainPtr<CJBig2_SymbolDict> dict = CreateSymbolDict(32);
+  cache.Put(key, dict);
+  EXPECT_EQ(dict->EstimateSize(), cache.bytes());
+  EXPECT_EQ(dict->EstimateSize(), budget.bytes());
+
+  RetainPtr<const CJBig2_SymbolDict> cached = cache.Get(key);
+  EXPECT_EQ(dict.Get(), cached.Get());
+  EXPECT_EQ(cached, cache.Get(key));
+
+  // Keys from the same stream at different offsets are different.
+  EXPECT_FALSE(cache.Get(CJBig2_CompoundKey(1, 4)));
+  EXPECT_FALSE(cache.Get(CJBig2_CompoundKey(2, 0)));
+
+  CacheBudget::Stats stats = budget.GetStats();
+  EXPECT_EQ(2u, stats.hits);
+  EXPECT_EQ(3u, stats.misses);
+  EXPECT_EQ(0u, stats.evictions);
+
+  // The dictionary outlives its cache entry while still in use.
+  dict.Reset();
+  budget.SetMaxBytes(0);
+  cache.Trim();
+  EXPECT_EQ(1u, budget.GetStats().evictions);
+  EXPECT_EQ(0u, budget.bytes());
+  ASSERT_EQ(1u, cached->NumImages());
+  EXPECT_EQ(1, cached->GetImage(0)->GetPixel(0, 0));
+  EXPECT_EQ(0, cached->GetImage(0)->GetPixel(1, 0));
+}
+
+TEST(CJBig2SymbolDictCacheTest, EvictsLeastRecentlyUsed) {
+  RetainPtr<CJBig2_SymbolDict> dict = CreateSymbolDict(32);
+  const size_t dict_size = dict->EstimateSize();
+
+  CacheBudget budget(3 * dict_size);
+  CJBig2_SymbolDictCache cache(&budget);
+  cache.Put({1, 0}, dict);
+  cache.Put({2, 0}, dict);
+  cache.Put({3, 0}, dict);
+  EXPECT_EQ(3 * dict_size, cache.bytes());
+
+  // Using the oldest entry makes the second one the least recently used.
+  EXPECT_TRUE(cache.Get({1, 0}));
+  cache.Put({4, 0}, dict);
+  EXPECT_EQ(1u, budget.GetStats().evictions);
+  EXPECT_EQ(3 * dict_size, cache.bytes());
+  EXPECT_TRUE(cache.Get({1, 0}));
+  EXPECT_FALSE(cache.Get({2, 0}));
+  EXPECT_TRUE(cache.Get({3, 0}));
+  EXPECT_TRUE(cache.Get({4, 0}));
+
+  // Putting an existing key again replaces the entry.
+  cache.Put({4, 0}, dict);
+  EXPECT_EQ(1u, budget.GetStats().evictions);
+  EXPECT_EQ(3 * dict_size, cache.bytes());
+
+  // Shrinking the budget evicts on the next lookup.
+  budget.SetMaxBytes(dict_size);
+  EXPECT_TRUE(cache.Get({4, 0}));
+  EXPECT_EQ(3u, budget.GetStats().evictions);
+  EXPECT_EQ(dict_size, cache.bytes());
+  EXPECT_FALSE(cache.Get({1, 0}));
+}
+
+TEST(CJBig2SymbolDictCacheTest, TooLarge) {
+  RetainPtr<CJBig2_SymbolDict> small_dict = CreateSymbolDict(32);
+  RetainPtr<CJBig2_SymbolDict> large_dict = CreateSymbolDict(320);
+  ASSERT_GT(large_dict->EstimateSize(), small_dict->EstimateSize());
+
+  CacheBudget budget(small_dict->EstimateSize());
+  CJBig2_SymbolDictCache cache(&budget);
+  cache.Put({1, 0}, small_dict);
+  // Not cached, and does not evict anything either.
+  cache.Put({2, 0}, large_dict);
+  EXPECT_FALSE(cache.Get({2, 0}));
+  EXPECT_TRUE(cache.Get({1, 0}));
+  EXPECT_EQ(0u, budget.GetStats().evictions);
+
+  // A budget of 0 disables the cache.
+  budget.SetMaxBytes(0);
+  cache.Trim();
+  EXPECT_EQ(0u, cache.bytes());
+  cache.Put({1, 0}, small_dict);
+  EXPECT_FALSE(cache.Get({1, 0}));
+}
+
+// Documents share the budget, and evict the least recently used dictionaries
+// across the documents used on the current thread.
+TEST(CJBig2SymbolDictCacheTest, SharedBudget) {
+  RetainPtr<CJBig2_SymbolDict> dict = CreateSymbolDict(32);
+  const size_t dict_size = dict->EstimateSize();
+
+  CacheBudget budget(2 * dict_size);
+  CJBig2_SymbolDictCache cache1(&budget);
+  CJBig2_SymbolDictCache cache2(&budget);
+  cache1.Put({1, 0}, dict);
+  cache1.Put({2, 0}, dict);
+  EXPECT_EQ(2 * dict_size, budget.bytes());
+
+  // The budget is full of the first document's dictionaries, so the second
+  // one evicts the least recently used of them.
+  cache2.Put({1, 0}, dict);
+  EXPECT_TRUE(cache2.Get({1, 0}));
+  EXPECT_EQ(dict_size, cache1.bytes());
+  EXPECT_EQ(1u, budget.GetStats().evictions);
+  EXPECT_FALSE(cache1.Get({1, 0}));
+  EXPECT_TRUE(cache1.Get({2, 0}));
+
+  // Another thread only evicts from the documents last used on it.
+  std::thread([&] { cache2.Put({2, 0}, dict); }).join();
+  EXPECT_EQ(2u, budget.GetStats().evictions);
+  EXPECT_EQ(dict_size, cache1.bytes());
+  EXPECT_EQ(dict_size, cache2.bytes());
+
+  // The second document has the least recently used dictionary, but was last
+  // used on the other thread.
+  EXPECT_TRUE(cache1.Get({2, 0}));
+  cache1.Put({1, 0}, dict);
+  EXPECT_EQ(3u, budget.GetStats().evictions);
+  EXPECT_EQ(dict_size, cache2.bytes());
+  EXPECT_TRUE(cache1.Get({1, 0}));
+  EXPECT_FALSE(cache1.Get({2, 0}));
+
+  // Closing a document gives back its bytes.
+  {
+    CJBig2_SymbolDictCache cache3(&budget);
+    budget.SetMaxBytes(CacheBudget::kUnlimited);
+    cache3.Put({1, 0}, dict);
+    EXPECT_EQ(3 * dict_size, budget.bytes());
+  }
+  EXPECT_EQ(2 * dict_size, budget.bytes());
+}
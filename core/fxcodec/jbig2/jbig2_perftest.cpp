@@ -0,0 +1,102 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "public/cpp/fpdf_scopers.h"
+#include "public/fpdf_ppo.h"
+#include "public/fpdf_save.h"
+#include "public/fpdfview.h"
+#include "testing/embedder_test.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf_timer.h"
+
+namespace {
+
+constexpr int kPageCount = 50;
+
+FPDF_CACHE_STATS GetCacheStats(int cache) {
+  FPDF_CACHE_STATS stats = {};
+  EXPECT_TRUE(FPDF_GetCacheStats(cache, &stats));
+  return stats;
+}
+
+// Restores the default image and JBIG2 symbol dictionary cache limits when
+// it goes out of scope.
+class ScopedRestoreCacheLimits {
+ public:
+  ScopedRestoreCacheLimits()
+      : image_max_bytes_(GetCacheStats(FPDF_CACHE_IMAGES).max_bytes),
+        symbol_dict_max_bytes_(
+            GetCacheStats(FPDF_CACHE_JBIG2_SYMBOL_DICTS).max_bytes) {}
+  ~ScopedRestoreCacheLimits() {
+    FPDF_SetCacheLimit(FPDF_CACHE_IMAGES, image_max_bytes_);
+    FPDF_SetCacheLimit(FPDF_CACHE_JBIG2_SYMBOL_DICTS, symbol_dict_max_bytes_);
+  }
+
+ private:
+  const size_t image_max_bytes_;
+  const size_t symbol_dict_max_bytes_;
+};
+
+void RenderAllPages(FPDF_DOCUMENT doc) {
+  ASSERT_EQ(kPageCount, FPDF_GetPageCount(doc));
+  for (int i = 0; i < kPageCount; ++i) {
+    ScopedFPDFPage page(FPDF_LoadPage(doc, i));
+    ASSERT_TRUE(page);
+    ScopedFPDFBitmap bitmap = EmbedderTest::RenderPage(page.get());
+    ASSERT_TRUE(bitmap);
+  }
+}
+
+}  // namespace
+
+class JBig2PerfTest : public EmbedderTest {};
+
+TEST_F(JBig2PerfTest, RenderMultiPageDocument) {
+  // Build a document where every page draws the same JBIG2 image, which uses a
+  // symbol dictionary from its JBIG2Globals stream.
+  ASSERT_TRUE(OpenDocument("bug_631912.pdf"));
+  {
+    ScopedFPDFDocument multi_page_doc(FPDF_CreateNewDocument());
+    ASSERT_TRUE(multi_page_doc);
+    const std::vector<int> page_indices(kPageCount, 0);
+    ASSERT_TRUE(FPDF_ImportPagesByIndex(multi_page_doc.get(), document(),
+                                        page_indices.data(),
+                                        page_indices.size(), 0));
+    ASSERT_TRUE(FPDF_SaveAsCopy(multi_page_doc.get(), this, 0));
+  }
+  const std::string pdf = GetString();
+
+  ScopedRestoreCacheLimits restore_cache_limits;
+  auto open_and_render = [&pdf] {
+    ScopedFPDFDocument doc(
+        FPDF_LoadMemDocument64(pdf.data(), pdf.size(), nullptr));
+    ASSERT_TRUE(doc);
+    RenderAllPages(doc.get());
+  };
+
+  // With the default limits, the image only gets decoded for the first page.
+  pdfium::MeasureBestTimeMs("image_cache", pdfium::kDefaultPerfRuns,
+                            open_and_render);
+
+  // Without the image cache, the image gets decoded for every page, using the
+  // cached symbol dictionary from the second page on.
+  ASSERT_TRUE(FPDF_SetCacheLimit(FPDF_CACHE_IMAGES, 0));
+  const FPDF_CACHE_STATS before = GetCacheStats(FPDF_CACHE_JBIG2_SYMBOL_DICTS);
+  pdfium::MeasureBestTimeMs("symbol_dict_cache", pdfium::kDefaultPerfRuns,
+                            open_and_render);
+  const FPDF_CACHE_STATS after = GetCacheStats(FPDF_CACHE_JBIG2_SYMBOL_DICTS);
+  EXPECT_EQ(uint64_t{(kPageCount - 1) * pdfium::kDefaultPerfRuns},
+            after.hits - before.hits);
+
+  // Without either cache, the symbol dictionary gets decoded for every page.
+  ASSERT_TRUE(FPDF_SetCacheLimit(FPDF_CACHE_JBIG2_SYMBOL_DICTS, 0));
+  pdfium::MeasureBestTimeMs("no_cache", pdfium::kDefaultPerfRuns,
+                            open_and_render);
+}
@@ -36,6 +36,14 @@ int jpeg_common_read_header(JpegCommon* jpeg_common, boolean flag) {
   return jpeg_read_header(&jpeg_common->cinfo, flag);
 }
 
+boolean jpeg_common_calc_output_dimensions(JpegCommon* jpeg_common) {
+  if (setjmp(jpeg_common->jmpbuf) == -1) {
+    return FALSE;
+  }
+  jpeg_calc_output_dimensions(&jpeg_common->cinfo);
+  return TRUE;
+}
+
 int jpeg_common_read_scanlines(JpegCommon* jpeg_common,
                                void* buf,
                                unsigned int count) {
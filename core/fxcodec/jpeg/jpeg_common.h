@@ -46,6 +46,7 @@ boolean jpeg_common_create_decompress(JpegCommon* jpeg_common);
 void jpeg_common_destroy_decompress(JpegCommon* jpeg_common);
 boolean jpeg_common_start_decompress(JpegCommon* jpeg_common);
 int jpeg_common_read_header(JpegCommon* jpeg_common, boolean flag);
+boolean jpeg_common_calc_output_dimensions(JpegCommon* jpeg_common);
 int jpeg_common_read_scanlines(JpegCommon* jpeg_common,
                                void* buf,
                                unsigned int count);
@@ -60,6 +60,8 @@ namespace fxcodec {
 
 namespace {
 
+// Only set during library initialization and teardown. The decoder keeps its
+// state in the contexts it creates, so threads can share it.
 JpegProgressiveDecoder* g_jpeg_decoder = nullptr;
 
 }  // namespace
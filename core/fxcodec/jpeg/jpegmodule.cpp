@@ -90,7 +90,8 @@ class JpegDecoder final : public ScanlineDecoder {
               uint32_t width,
               uint32_t height,
               int nComps,
-              bool ColorTransform);
+              bool ColorTransform,
+              uint8_t resolution_levels_to_skip);
 
   // ScanlineDecoder:
   [[nodiscard]] bool Rewind() override;
@@ -128,7 +129,7 @@ class JpegDecoder final : public ScanlineDecoder {
   bool decompress_created_ = false;
   bool started_ = false;
   bool jpeg_transform_ = false;
-  uint32_t default_scale_denom_ = 1;
+  unsigned int scale_denom_ = 1;
 };
 
 JpegDecoder::JpegDecoder() = default;
@@ -191,9 +192,14 @@ bool JpegDecoder::InitDecode(bool bAcceptKnownBadHeader) {
 
   orig_width_ = common_.cinfo.image_width;
   orig_height_ = common_.cinfo.image_height;
-  output_width_ = orig_width_;
-  output_height_ = orig_height_;
-  default_scale_denom_ = common_.cinfo.scale_denom;
+  common_.cinfo.scale_denom = scale_denom_;
+  if (!jpeg_common_calc_output_dimensions(&common_)) {
+    jpeg_common_destroy_decompress(&common_);
+    decompress_created_ = false;
+    return false;
+  }
+  output_width_ = common_.cinfo.output_width;
+  output_height_ = common_.cinfo.output_height;
   return true;
 }
 
@@ -201,7 +207,8 @@ bool JpegDecoder::Create(pdfium::span<const uint8_t> src_span,
                          uint32_t width,
                          uint32_t height,
                          int nComps,
-                         bool ColorTransform) {
+                         bool ColorTransform,
+                         uint8_t resolution_levels_to_skip) {
   src_span_ = JpegScanSOI(src_span);
   if (src_span_.size() < 2) {
     return false;
@@ -220,6 +227,7 @@ bool JpegDecoder::Create(pdfium::span<const uint8_t> src_span,
   common_.source_mgr.fill_input_buffer = jpeg_common_src_fill_buffer;
   common_.source_mgr.resync_to_restart = jpeg_common_src_resync;
   jpeg_transform_ = ColorTransform;
+  scale_denom_ = 1u << resolution_levels_to_skip;
   output_width_ = orig_width_ = width;
   output_height_ = orig_height_ = height;
   if (!InitDecode(/*bAcceptKnownBadHeader=*/true)) {
@@ -249,14 +257,11 @@ bool JpegDecoder::Rewind() {
       return false;
     }
   }
-  common_.cinfo.scale_denom = default_scale_denom_;
-  output_width_ = orig_width_;
-  output_height_ = orig_height_;
   if (!jpeg_common_start_decompress(&common_)) {
     jpeg_common_destroy_decompress(&common_);
     return false;
   }
-  CHECK_LE(static_cast<int>(common_.cinfo.output_width), orig_width_);
+  CHECK_LE(static_cast<int>(common_.cinfo.output_width), output_width_);
   started_ = true;
   return true;
 }
@@ -276,7 +281,7 @@ uint32_t JpegDecoder::GetSrcOffset() {
 }
 
 void JpegDecoder::CalcPitch() {
-  pitch_ = static_cast<uint32_t>(common_.cinfo.image_width) *
+  pitch_ = static_cast<uint32_t>(common_.cinfo.output_width) *
            common_.cinfo.num_components;
   pitch_ += 3;
   pitch_ /= 4;
@@ -354,11 +359,14 @@ std::unique_ptr<ScanlineDecoder> JpegModule::CreateDecoder(
     uint32_t width,
     uint32_t height,
     int nComps,
-    bool ColorTransform) {
+    bool ColorTransform,
+    uint8_t resolution_levels_to_skip) {
   DCHECK(!src_span.empty());
+  CHECK_LE(resolution_levels_to_skip, kMaxResolutionLevelsToSkip);
 
   auto pDecoder = std::make_unique<JpegDecoder>();
-  if (!pDecoder->Create(src_span, width, height, nComps, ColorTransform)) {
+  if (!pDecoder->Create(src_span, width, height, nComps, ColorTransform,
+                        resolution_levels_to_skip)) {
     return nullptr;
   }
 
@@ -37,12 +37,18 @@ class JpegModule {
     bool color_transform;
   };
 
+  // libjpeg can scale images down by 1/2, 1/4 or 1/8 while decoding.
+  static constexpr uint8_t kMaxResolutionLevelsToSkip = 3;
+
+  // Decodes at 1/2^`resolution_levels_to_skip` of the full size, with the
+  // output dimensions rounded up. `width` and `height` are the full size.
   static std::unique_ptr<ScanlineDecoder> CreateDecoder(
       pdfium::span<const uint8_t> src_span,
       uint32_t width,
       uint32_t height,
       int nComps,
-      bool ColorTransform);
+      bool ColorTransform,
+      uint8_t resolution_levels_to_skip);
 
   static std::optional<ImageInfo> LoadInfo(
       pdfium::span<const uint8_t> src_span);
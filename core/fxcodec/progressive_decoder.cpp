@@ -23,6 +23,7 @@
 #include "core/fxcrt/fx_system.h"
 #include "core/fxcrt/notreached.h"
 #include "core/fxcrt/numerics/safe_conversions.h"
+#include "core/fxcrt/span.h"
 #include "core/fxcrt/span_util.h"
 #include "core/fxcrt/stl_util.h"
 #include "core/fxge/dib/cfx_cmyk_to_srgb.h"
@@ -922,8 +923,9 @@ void ProgressiveDecoder::ResampleScanline(
   const int src_bytes_per_pixel = (src_format & 0xff) / 8;
   const int dest_bytes_per_pixel = pDeviceBitmap->GetBPP() / 8;
   for (int dest_col = 0; dest_col < src_width_; dest_col++) {
-    CStretchEngine::PixelWeight* pPixelWeights =
+    const CStretchEngine::PixelWeight* pPixelWeights =
         weight_horz_.GetPixelWeight(dest_col);
+    pdfium::span<const uint32_t> weights = weight_horz_.GetWeights(dest_col);
     switch (trans_method_) {
       case TransformMethod::kInvalid:
         return;
@@ -932,8 +934,7 @@ void ProgressiveDecoder::ResampleScanline(
           uint32_t dest_g = 0;
           for (int j = pPixelWeights->src_start_; j <= pPixelWeights->src_end_;
                j++) {
-            uint32_t pixel_weight =
-                pPixelWeights->weights_[j - pPixelWeights->src_start_];
+            uint32_t pixel_weight = weights[j - pPixelWeights->src_start_];
             dest_g += pixel_weight * src_scan[j];
           }
           FXSYS_memset(dest_scan, CStretchEngine::PixelFromFixed(dest_g), 3);
@@ -948,8 +949,7 @@ void ProgressiveDecoder::ResampleScanline(
           uint32_t dest_b = 0;
           for (int j = pPixelWeights->src_start_; j <= pPixelWeights->src_end_;
                j++) {
-            uint32_t pixel_weight =
-                pPixelWeights->weights_[j - pPixelWeights->src_start_];
+            uint32_t pixel_weight = weights[j - pPixelWeights->src_start_];
             uint32_t argb = src_palette_[src_scan[j]];
             dest_r += pixel_weight * FXARGB_R(argb);
             dest_g += pixel_weight * FXARGB_G(argb);
@@ -971,8 +971,7 @@ void ProgressiveDecoder::ResampleScanline(
             uint32_t dest_b = 0;
             for (int j = pPixelWeights->src_start_;
                  j <= pPixelWeights->src_end_; j++) {
-              uint32_t pixel_weight =
-                  pPixelWeights->weights_[j - pPixelWeights->src_start_];
+              uint32_t pixel_weight = weights[j - pPixelWeights->src_start_];
               uint32_t argb = src_palette_[src_scan[j]];
               dest_r += pixel_weight * FXARGB_R(argb);
               dest_g += pixel_weight * FXARGB_G(argb);
@@ -993,8 +992,7 @@ void ProgressiveDecoder::ResampleScanline(
           uint32_t dest_b = 0;
           for (int j = pPixelWeights->src_start_; j <= pPixelWeights->src_end_;
                j++) {
-            uint32_t pixel_weight =
-                pPixelWeights->weights_[j - pPixelWeights->src_start_];
+            uint32_t pixel_weight = weights[j - pPixelWeights->src_start_];
             FX_ARGB argb = src_palette_[src_scan[j]];
             dest_a += pixel_weight * FXARGB_A(argb);
             dest_r += pixel_weight * FXARGB_R(argb);
@@ -1015,8 +1013,7 @@ void ProgressiveDecoder::ResampleScanline(
           uint32_t dest_r = 0;
           for (int j = pPixelWeights->src_start_; j <= pPixelWeights->src_end_;
                j++) {
-            uint32_t pixel_weight =
-                pPixelWeights->weights_[j - pPixelWeights->src_start_];
+            uint32_t pixel_weight = weights[j - pPixelWeights->src_start_];
             const uint8_t* src_pixel = src_scan + j * src_bytes_per_pixel;
             dest_b += pixel_weight * (*src_pixel++);
             dest_g += pixel_weight * (*src_pixel++);
@@ -1036,8 +1033,7 @@ void ProgressiveDecoder::ResampleScanline(
           uint32_t dest_r = 0;
           for (int j = pPixelWeights->src_start_; j <= pPixelWeights->src_end_;
                j++) {
-            uint32_t pixel_weight =
-                pPixelWeights->weights_[j - pPixelWeights->src_start_];
+            uint32_t pixel_weight = weights[j - pPixelWeights->src_start_];
             const uint8_t* src_pixel = src_scan + j * src_bytes_per_pixel;
             FX_RGB_STRUCT<uint8_t> src_rgb =
                 AdobeCMYK_to_sRGB1(255 - src_pixel[0], 255 - src_pixel[1],
@@ -1061,8 +1057,7 @@ void ProgressiveDecoder::ResampleScanline(
           uint32_t dest_b = 0;
           for (int j = pPixelWeights->src_start_; j <= pPixelWeights->src_end_;
                j++) {
-            uint32_t pixel_weight =
-                pPixelWeights->weights_[j - pPixelWeights->src_start_];
+            uint32_t pixel_weight = weights[j - pPixelWeights->src_start_];
             const uint8_t* src_pixel = src_scan + j * src_bytes_per_pixel;
             pixel_weight = pixel_weight * src_pixel[3] / 255;
             dest_b += pixel_weight * (*src_pixel++);
@@ -0,0 +1,76 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxcrt/cache_budget.h"
+
+#include "core/fxcrt/check_op.h"
+
+namespace fxcrt {
+
+bool CacheBudget::CanFit(size_t bytes) const {
+  const size_t max = max_bytes();
+  const size_t used = this->bytes();
+  return used <= max && bytes <= max - used;
+}
+
+void CacheBudget::Remove(size_t bytes) {
+  const size_t old_bytes = bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+  CHECK_LE(bytes, old_bytes);
+}
+
+void CacheBudget::Evict(size_t bytes) {
+  Remove(bytes);
+  evictions_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void CacheBudget::AddEvictable(Evictable* cache) {
+  cache->thread_ = std::this_thread::get_id();
+  evictables_.push_back(cache);
+}
+
+void CacheBudget::RemoveEvictable(Evictable* cache) {
+  const size_t removed = std::erase(evictables_, cache);
+  CHECK_EQ(removed, 1u);
+}
+
+uint64_t CacheBudget::Use(Evictable* cache) {
+  cache->thread_ = std::this_thread::get_id();
+  return ++last_use_;
+}
+
+bool CacheBudget::EvictUntilFits(Evictable* cache, size_t bytes) {
+  const std::thread::id thread = std::this_thread::get_id();
+  cache->thread_ = thread;
+  while (!CanFit(bytes)) {
+    Evictable* oldest_cache = nullptr;
+    uint64_t oldest_use = 0;
+    for (Evictable* other : evictables_) {
+      if (other->thread_ != thread) {
+        continue;
+      }
+      std::optional<uint64_t> use = other->GetOldestUse();
+      if (use.has_value() && (!oldest_cache || use.value() < oldest_use)) {
+        oldest_cache = other;
+        oldest_use = use.value();
+      }
+    }
+    if (!oldest_cache) {
+      return false;
+    }
+    oldest_cache->EvictOldest();
+  }
+  return true;
+}
+
+CacheBudget::Stats CacheBudget::GetStats() const {
+  return {
+      .hits = hits_.load(std::memory_order_relaxed),
+      .misses = misses_.load(std::memory_order_relaxed),
+      .evictions = evictions_.load(std::memory_order_relaxed),
+      .bytes = bytes(),
+      .max_bytes = max_bytes(),
+  };
+}
+
+}  // namespace fxcrt
@@ -0,0 +1,121 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FXCRT_CACHE_BUDGET_H_
+#define CORE_FXCRT_CACHE_BUDGET_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace fxcrt {
+
+// A byte budget shared by all instances of one kind of cache, on all threads,
+// along with hit, miss and eviction counters. The cache instances themselves
+// are not shared. Each instance reports what it adds and removes, and evicts
+// least recently used entries while the budget is exceeded.
+//
+// Instances that register as Evictable are ordered by one least recently used
+// list, so that an idle instance does not keep the others from caching. Their
+// entries may still be in use on the thread that last used them, so only that
+// thread evicts them.
+class CacheBudget {
+ public:
+  // A cache instance that the others sharing the budget can evict from. The
+  // budget calls these with lock() held.
+  class Evictable {
+   public:
+    // The Use() stamp of the least recently used entry, or nullopt if there
+    // are no entries.
+    virtual std::optional<uint64_t> GetOldestUse() const = 0;
+    // Evicts the least recently used entry, and reports it with Evict().
+    virtual void EvictOldest() = 0;
+
+   protected:
+    ~Evictable() = default;
+
+   private:
+    friend class CacheBudget;
+
+    // The thread that last called Use() for this instance.
+    std::thread::id thread_;
+  };
+
+  struct Stats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    // Bytes currently used by all instances.
+    size_t bytes = 0;
+    size_t max_bytes = 0;
+  };
+
+  static constexpr size_t kUnlimited = std::numeric_limits<size_t>::max();
+
+  explicit constexpr CacheBudget(size_t max_bytes) : max_bytes_(max_bytes) {}
+  CacheBudget(const CacheBudget&) = delete;
+  CacheBudget& operator=(const CacheBudget&) = delete;
+
+  size_t max_bytes() const {
+    return max_bytes_.load(std::memory_order_relaxed);
+  }
+  void SetMaxBytes(size_t max_bytes) {
+    max_bytes_.store(max_bytes, std::memory_order_relaxed);
+  }
+
+  size_t bytes() const { return bytes_.load(std::memory_order_relaxed); }
+
+  // Whether `bytes` more bytes fit in the budget.
+  bool CanFit(size_t bytes) const;
+  bool IsExceeded() const { return !CanFit(0); }
+
+  void RecordHit() { hits_.fetch_add(1, std::memory_order_relaxed); }
+  void RecordMiss() { misses_.fetch_add(1, std::memory_order_relaxed); }
+  void Add(size_t bytes) {
+    bytes_.fetch_add(bytes, std::memory_order_relaxed);
+  }
+  void Remove(size_t bytes);
+  // Like Remove(), and counts an eviction.
+  void Evict(size_t bytes);
+
+  Stats GetStats() const;
+
+  // Guards the Evictable instances and the methods below.
+  std::mutex& lock() { return lock_; }
+
+  void AddEvictable(Evictable* cache);
+  void RemoveEvictable(Evictable* cache);
+
+  // Returns a stamp that orders entry uses across instances, for an entry of
+  // `cache` used on the current thread.
+  uint64_t Use(Evictable* cache);
+
+  // Records that `cache` is used on the current thread, then evicts the least
+  // recently used entries of the instances last used on it, until `bytes`
+  // more bytes fit. Returns whether they do.
+  bool EvictUntilFits(Evictable* cache, size_t bytes);
+
+ private:
+  std::atomic<size_t> max_bytes_;
+  std::atomic<size_t> bytes_ = 0;
+  std::atomic<uint64_t> hits_ = 0;
+  std::atomic<uint64_t> misses_ = 0;
+  std::atomic<uint64_t> evictions_ = 0;
+  std::mutex lock_;
+  // Guarded by `lock_`.
+  std::vector<Evictable*> evictables_;
+  uint64_t last_use_ = 0;
+};
+
+}  // namespace fxcrt
+
+using fxcrt::CacheBudget;
+
+#endif  // CORE_FXCRT_CACHE_BUDGET_H_
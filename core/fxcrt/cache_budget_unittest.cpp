@@ -0,0 +1,89 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxcrt/cache_budget.h"
+
+#include <thread>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace fxcrt {
+
+TEST(CacheBudget, CanFit) {
+  CacheBudget budget(100);
+  EXPECT_TRUE(budget.CanFit(100));
+  EXPECT_FALSE(budget.CanFit(101));
+  EXPECT_FALSE(budget.IsExceeded());
+
+  budget.Add(60);
+  EXPECT_TRUE(budget.CanFit(40));
+  EXPECT_FALSE(budget.CanFit(41));
+
+  budget.SetMaxBytes(50);
+  EXPECT_TRUE(budget.IsExceeded());
+  EXPECT_FALSE(budget.CanFit(0));
+
+  budget.SetMaxBytes(0);
+  budget.Remove(60);
+  EXPECT_FALSE(budget.IsExceeded());
+  EXPECT_TRUE(budget.CanFit(0));
+  EXPECT_FALSE(budget.CanFit(1));
+
+  CacheBudget unlimited(CacheBudget::kUnlimited);
+  unlimited.Add(1000);
+  EXPECT_TRUE(unlimited.CanFit(CacheBudget::kUnlimited - 1000));
+  EXPECT_FALSE(unlimited.CanFit(CacheBudget::kUnlimited));
+}
+
+TEST(CacheBudget, Stats) {
+  CacheBudget budget(100);
+  budget.RecordMiss();
+  budget.Add(30);
+  budget.RecordMiss();
+  budget.Add(20);
+  budget.RecordHit();
+  budget.Evict(30);
+
+  CacheBudget::Stats stats = budget.GetStats();
+  EXPECT_EQ(1u, stats.hits);
+  EXPECT_EQ(2u, stats.misses);
+  EXPECT_EQ(1u, stats.evictions);
+  EXPECT_EQ(20u, stats.bytes);
+  EXPECT_EQ(100u, stats.max_bytes);
+
+  budget.Remove(20);
+  stats = budget.GetStats();
+  EXPECT_EQ(1u, stats.evictions);
+  EXPECT_EQ(0u, stats.bytes);
+}
+
+TEST(CacheBudget, SharedByThreads) {
+  static constexpr int kThreadCount = 4;
+  static constexpr int kIterations = 1000;
+
+  CacheBudget budget(CacheBudget::kUnlimited);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreadCount; ++i) {
+    threads.emplace_back([&budget] {
+      for (int j = 0; j < kIterations; ++j) {
+        budget.RecordMiss();
+        budget.Add(3);
+        budget.RecordHit();
+        budget.Evict(1);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  const CacheBudget::Stats stats = budget.GetStats();
+  EXPECT_EQ(uint64_t{kThreadCount * kIterations}, stats.hits);
+  EXPECT_EQ(uint64_t{kThreadCount * kIterations}, stats.misses);
+  EXPECT_EQ(uint64_t{kThreadCount * kIterations}, stats.evictions);
+  EXPECT_EQ(size_t{2 * kThreadCount * kIterations}, stats.bytes);
+}
+
+}  // namespace fxcrt
@@ -0,0 +1,77 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxcrt/cfx_read_only_mapped_file_stream.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "core/fxcrt/cfx_read_only_span_stream.h"
+#include "core/fxcrt/compiler_specific.h"
+#include "core/fxcrt/numerics/safe_conversions.h"
+
+#ifndef O_BINARY
+#define O_BINARY 0
+#endif  // O_BINARY
+
+#ifndef O_LARGEFILE
+#define O_LARGEFILE 0
+#endif  // O_LARGEFILE
+
+// static
+RetainPtr<CFX_ReadOnlyMappedFileStream> CFX_ReadOnlyMappedFileStream::Create(
+    const char* filename) {
+  const int fd = open(filename, O_BINARY | O_LARGEFILE | O_RDONLY);
+  if (fd < 0) {
+    return nullptr;
+  }
+
+  struct stat s = {};
+  if (fstat(fd, &s) != 0 || !S_ISREG(s.st_mode) || s.st_size <= 0 ||
+      !pdfium::IsValueInRangeForNumericType<size_t>(s.st_size) ||
+      !pdfium::IsValueInRangeForNumericType<FX_FILESIZE>(s.st_size)) {
+    close(fd);
+    return nullptr;
+  }
+
+  const size_t size = static_cast<size_t>(s.st_size);
+  void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+  // The mapping stays valid after the file descriptor is closed.
+  close(fd);
+  if (address == MAP_FAILED) {
+    return nullptr;
+  }
+
+  // SAFETY: mmap() succeeded, so `address` points to `size` readable bytes.
+  auto mapping = UNSAFE_BUFFERS(
+      pdfium::span(static_cast<const uint8_t*>(address), size));
+  return pdfium::MakeRetain<CFX_ReadOnlyMappedFileStream>(mapping);
+}
+
+CFX_ReadOnlyMappedFileStream::CFX_ReadOnlyMappedFileStream(
+    pdfium::span<const uint8_t> mapping)
+    : mapping_(mapping),
+      stream_(pdfium::MakeRetain<CFX_ReadOnlySpanStream>(mapping_)) {}
+
+CFX_ReadOnlyMappedFileStream::~CFX_ReadOnlyMappedFileStream() {
+  stream_.Reset();
+  munmap(const_cast<uint8_t*>(mapping_.data()), mapping_.size());
+}
+
+FX_FILESIZE CFX_ReadOnlyMappedFileStream::GetSize() {
+  return stream_->GetSize();
+}
+
+bool CFX_ReadOnlyMappedFileStream::ReadBlockAtOffset(
+    pdfium::span<uint8_t> buffer,
+    FX_FILESIZE offset) {
+  return stream_->ReadBlockAtOffset(buffer, offset);
+}
+
+pdfium::span<const uint8_t> CFX_ReadOnlyMappedFileStream::GetInMemorySpan() {
+  return mapping_;
+}
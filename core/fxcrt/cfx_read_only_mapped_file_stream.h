@@ -0,0 +1,47 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FXCRT_CFX_READ_ONLY_MAPPED_FILE_STREAM_H_
+#define CORE_FXCRT_CFX_READ_ONLY_MAPPED_FILE_STREAM_H_
+
+#include <stdint.h>
+
+#include "build/build_config.h"
+#include "core/fxcrt/fx_stream.h"
+#include "core/fxcrt/raw_span.h"
+#include "core/fxcrt/retain_ptr.h"
+#include "core/fxcrt/span.h"
+
+#if !BUILDFLAG(IS_POSIX)
+#error "Included on the wrong platform"
+#endif
+
+class CFX_ReadOnlySpanStream;
+
+// Read-only stream over a memory-mapped file. The file must not be truncated
+// while it is mapped, as reading past the new end of the file is fatal.
+class CFX_ReadOnlyMappedFileStream final : public IFX_SeekableReadStream {
+ public:
+  CONSTRUCT_VIA_MAKE_RETAIN;
+
+  // Returns nullptr if `filename` cannot be opened or mapped. Empty files
+  // cannot be mapped.
+  static RetainPtr<CFX_ReadOnlyMappedFileStream> Create(const char* filename);
+
+  // IFX_SeekableReadStream:
+  FX_FILESIZE GetSize() override;
+  bool ReadBlockAtOffset(pdfium::span<uint8_t> buffer,
+                         FX_FILESIZE offset) override;
+  pdfium::span<const uint8_t> GetInMemorySpan() override;
+
+ private:
+  explicit CFX_ReadOnlyMappedFileStream(pdfium::span<const uint8_t> mapping);
+  ~CFX_ReadOnlyMappedFileStream() override;
+
+  const pdfium::raw_span<const uint8_t> mapping_;
+  // Spans over `mapping_`. Must be released before `mapping_` is unmapped.
+  RetainPtr<CFX_ReadOnlySpanStream> stream_;
+};
+
+#endif  // CORE_FXCRT_CFX_READ_ONLY_MAPPED_FILE_STREAM_H_
@@ -0,0 +1,84 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxcrt/cfx_read_only_mapped_file_stream.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <array>
+#include <string>
+
+#include "core/fxcrt/bytestring.h"
+#include "core/fxcrt/retain_ptr.h"
+#include "core/fxcrt/span.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+class ScopedTempFile {
+ public:
+  explicit ScopedTempFile(ByteStringView contents) {
+    char path[] = "/tmp/pdfium_mapped_file_XXXXXX";
+    const int fd = mkstemp(path);
+    if (fd < 0) {
+      return;
+    }
+    path_ = path;
+    if (!contents.IsEmpty()) {
+      EXPECT_EQ(static_cast<ssize_t>(contents.GetLength()),
+                write(fd, contents.unterminated_c_str(), contents.GetLength()));
+    }
+    close(fd);
+  }
+  ~ScopedTempFile() {
+    if (!path_.empty()) {
+      unlink(path_.c_str());
+    }
+  }
+
+  const char* path() const { return path_.c_str(); }
+
+ private:
+  std::string path_;
+};
+
+}  // namespace
+
+TEST(ReadOnlyMappedFileStreamTest, NonexistentFile) {
+  EXPECT_FALSE(CFX_ReadOnlyMappedFileStream::Create(
+      "/this/file/does/not/exist.pdf"));
+}
+
+TEST(ReadOnlyMappedFileStreamTest, EmptyFile) {
+  ScopedTempFile file("");
+  ASSERT_TRUE(file.path()[0]);
+  EXPECT_FALSE(CFX_ReadOnlyMappedFileStream::Create(file.path()));
+
+  // The fallback still opens the file.
+  RetainPtr<IFX_SeekableReadStream> stream =
+      IFX_SeekableReadStream::CreateMappedFromFilename(file.path());
+  ASSERT_TRUE(stream);
+  EXPECT_EQ(0, stream->GetSize());
+  EXPECT_TRUE(stream->GetInMemorySpan().empty());
+}
+
+TEST(ReadOnlyMappedFileStreamTest, Read) {
+  ScopedTempFile file("%PDF-1.7 mapped");
+  ASSERT_TRUE(file.path()[0]);
+  RetainPtr<CFX_ReadOnlyMappedFileStream> stream =
+      CFX_ReadOnlyMappedFileStream::Create(file.path());
+  ASSERT_TRUE(stream);
+  EXPECT_EQ(15, stream->GetSize());
+  EXPECT_EQ("%PDF-1.7 mapped", ByteStringView(stream->GetInMemorySpan()));
+
+  std::array<uint8_t, 6> buffer;
+  ASSERT_TRUE(stream->ReadBlockAtOffset(buffer, 9));
+  EXPECT_EQ("mapped", ByteStringView(buffer));
+
+  EXPECT_FALSE(stream->ReadBlockAtOffset(buffer, 10));
+  EXPECT_FALSE(stream->ReadBlockAtOffset(buffer, -1));
+  EXPECT_FALSE(stream->ReadBlockAtOffset(pdfium::span<uint8_t>(), 0));
+}
@@ -37,3 +37,7 @@ bool CFX_ReadOnlySpanStream::ReadBlockAtOffset(pdfium::span<uint8_t> buffer,
 
   return true;
 }
+
+pdfium::span<const uint8_t> CFX_ReadOnlySpanStream::GetInMemorySpan() {
+  return span_;
+}
@@ -10,7 +10,6 @@
 #include <variant>
 
 #include "core/fxcrt/fx_extension.h"
-#include "core/fxcrt/fx_safe_types.h"
 #include "core/fxcrt/fx_string.h"
 #include "core/fxcrt/numerics/safe_conversions.h"
 
@@ -25,17 +24,13 @@ FX_Number::FX_Number(ByteStringView strc) {
     return;
   }
 
-  if (strc.Contains('.')) {
-    value_ = StringToFloat(strc);
-    return;
-  }
-
   // Note, numbers in PDF are typically of the form 123, -123, etc. But,
   // for things like the Permissions on the encryption hash the number is
   // actually an unsigned value. We use a uint32_t so we can deal with the
   // unsigned and then check for overflow if the user actually signed the value.
   // The Permissions flag is listed in Table 3.20 PDF 1.7 spec.
-  FX_SAFE_UINT32 unsigned_val = 0;
+  uint32_t uValue = 0;
+  bool bOverflow = false;
   bool bIsSigned = false;
   bool bNegative = false;
   size_t cc = 0;
@@ -48,14 +43,25 @@ FX_Number::FX_Number(ByteStringView strc) {
     cc++;
   }
 
+  // Both integers and reals usually start with their integer digits, so
+  // parse those first, and only look for a '.' in what is left.
   for (; cc < strc.GetLength() && FXSYS_IsDecimalDigit(strc.CharAt(cc)); ++cc) {
-    // Deliberately not using FXSYS_DecimalCharToInt() in a tight loop to avoid
-    // a duplicate FXSYS_IsDecimalDigit() call. Note that the order of operation
-    // is important to avoid unintentional overflows.
-    unsigned_val = unsigned_val * 10 + (strc.CharAt(cc) - '0');
+    const uint64_t next = uint64_t{uValue} * 10 + (strc.CharAt(cc) - '0');
+    if (next > std::numeric_limits<uint32_t>::max()) {
+      bOverflow = true;
+      break;
+    }
+    uValue = static_cast<uint32_t>(next);
+  }
+
+  if (strc.Substr(cc).Contains('.')) {
+    value_ = StringToFloat(strc);
+    return;
   }
 
-  uint32_t uValue = unsigned_val.ValueOrDefault(0);
+  if (bOverflow) {
+    uValue = 0;
+  }
   if (!bIsSigned) {
     value_ = uValue;
     return;
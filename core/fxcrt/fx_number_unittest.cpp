@@ -147,6 +147,30 @@ TEST(fxnumber, FromStringSigned) {
 }
 
 TEST(fxnumber, FromStringFloat) {
-  FX_Number number("3.24");
-  EXPECT_FLOAT_EQ(3.24f, number.GetFloat());
+  {
+    FX_Number number("3.24");
+    EXPECT_FALSE(number.IsInteger());
+    EXPECT_FLOAT_EQ(3.24f, number.GetFloat());
+  }
+  {
+    FX_Number number("-.5");
+    EXPECT_FALSE(number.IsInteger());
+    EXPECT_FLOAT_EQ(-0.5f, number.GetFloat());
+  }
+  {
+    FX_Number number("+12.");
+    EXPECT_FALSE(number.IsInteger());
+    EXPECT_FLOAT_EQ(12.0f, number.GetFloat());
+  }
+  {
+    // Too big for an integer, but fine for a float.
+    FX_Number number("12345678901234.5");
+    EXPECT_FALSE(number.IsInteger());
+    EXPECT_FLOAT_EQ(12345678901234.5f, number.GetFloat());
+  }
+  {
+    // Anything after the integer digits may still make it a float.
+    FX_Number number("12e3.5");
+    EXPECT_FALSE(number.IsInteger());
+  }
 }
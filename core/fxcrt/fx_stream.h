@@ -54,10 +54,21 @@ class IFX_SeekableReadStream : virtual public Retainable,
   static RetainPtr<IFX_SeekableReadStream> CreateFromFilename(
       const char* filename);
 
+  // Same as CreateFromFilename(), but memory-maps the file when possible, so
+  // readers can use GetInMemorySpan() instead of copying blocks out of it.
+  // Falls back to CreateFromFilename() when the file cannot be mapped.
+  static RetainPtr<IFX_SeekableReadStream> CreateMappedFromFilename(
+      const char* filename);
+
   virtual bool IsEOF();
   virtual FX_FILESIZE GetPosition();
   [[nodiscard]] virtual bool ReadBlockAtOffset(pdfium::span<uint8_t> buffer,
                                                FX_FILESIZE offset) = 0;
+
+  // Returns the entire contents of the stream, if they are resident in memory
+  // and remain valid for the lifetime of the stream. Otherwise returns an
+  // empty span, and callers must use ReadBlockAtOffset().
+  virtual pdfium::span<const uint8_t> GetInMemorySpan();
 };
 
 class IFX_SeekableStream : public IFX_SeekableReadStream,
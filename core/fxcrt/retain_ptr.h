@@ -9,6 +9,7 @@
 
 #include <cstddef>
 #include <functional>
+#include <limits>
 #include <memory>
 #include <type_traits>
 #include <utility>
@@ -156,6 +157,20 @@ class Retainable {
 
   bool HasOneRef() const { return ref_count_ == 1; }
 
+  // Stops counting references, so that threads can share the object without
+  // racing on its reference count. The object must not change from then on.
+  // The caller must hold the only reference, and must call Unfreeze() before
+  // releasing it, once no other thread can use the object.
+  void Freeze() const {
+    CHECK(HasOneRef());
+    ref_count_ = kFrozenRefCount;
+  }
+  void Unfreeze() const {
+    CHECK(IsFrozen());
+    ref_count_ = 1;
+  }
+  bool IsFrozen() const { return ref_count_ == kFrozenRefCount; }
+
  protected:
   virtual ~Retainable() = default;
 
@@ -173,16 +188,25 @@ class Retainable {
   // RetainPtr<const T> can be used for an object that is otherwise const
   // apart from the internal ref-counting.
   void Retain() const {
+    if (IsFrozen()) {
+      return;
+    }
     ++ref_count_;
     CHECK(ref_count_ > 0);
   }
   void Release() const {
+    if (IsFrozen()) {
+      return;
+    }
     CHECK(ref_count_ > 0);
     if (--ref_count_ == 0) {
       delete this;
     }
   }
 
+  static constexpr uintptr_t kFrozenRefCount =
+      std::numeric_limits<uintptr_t>::max();
+
   mutable uintptr_t ref_count_ = 0;
   static_assert(std::is_unsigned<decltype(ref_count_)>::value,
                 "ref_count_ must be an unsigned type for overflow check"
@@ -422,6 +422,23 @@ TEST(RetainPtr, MakeRetained) {
   EXPECT_TRUE(ptr->HasOneRef());
 }
 
+TEST(RetainPtr, Frozen) {
+  auto ptr = pdfium::MakeRetain<Retainable>();
+  ptr->Freeze();
+  EXPECT_TRUE(ptr->IsFrozen());
+  EXPECT_FALSE(ptr->HasOneRef());
+  {
+    RetainPtr<Retainable> copy1 = ptr;
+    RetainPtr<Retainable> copy2 = copy1;
+    EXPECT_TRUE(ptr->IsFrozen());
+  }
+  EXPECT_TRUE(ptr->IsFrozen());
+
+  ptr->Unfreeze();
+  EXPECT_FALSE(ptr->IsFrozen());
+  EXPECT_TRUE(ptr->HasOneRef());
+}
+
 TEST(RetainPtr, VectorMove) {
   // Proves move ctor is selected by std::vector over copy/delete, this
   // may require the ctor to be marked "noexcept".
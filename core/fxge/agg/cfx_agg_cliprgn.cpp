@@ -6,93 +6,186 @@
 
 #include "core/fxge/agg/cfx_agg_cliprgn.h"
 
-#include <stdint.h>
-
+#include <algorithm>
 #include <utility>
 
 #include "core/fxcrt/check_op.h"
-#include "core/fxcrt/notreached.h"
 #include "core/fxcrt/stl_util.h"
 #include "core/fxge/dib/cfx_dibitmap.h"
 
-CFX_AggClipRgn::CFX_AggClipRgn(int width, int height)
-    : box_(0, 0, width, height) {}
+namespace {
 
-CFX_AggClipRgn::CFX_AggClipRgn(const CFX_AggClipRgn& src) = default;
+// Returns the runs of `runs` within `box`, which must be inside the box of
+// `runs`.
+RetainPtr<const CFX_AggClipRgn::Runs> CropRuns(
+    const CFX_AggClipRgn::Runs& runs,
+    const FX_RECT& box) {
+  CFX_AggClipRgn::RunsBuilder builder(box);
+  for (int y = box.top; y < box.bottom; ++y) {
+    for (const CFX_AggClipRgn::Run& run : runs.GetRow(y)) {
+      builder.AddRun(y, run.left, run.right, run.coverage);
+    }
+  }
+  return builder.Build();
+}
 
-CFX_AggClipRgn::~CFX_AggClipRgn() = default;
+// Returns the product of the coverages of `runs1` and `runs2` within `box`,
+// which must be inside both of their boxes.
+RetainPtr<const CFX_AggClipRgn::Runs> MultiplyRuns(
+    const CFX_AggClipRgn::Runs& runs1,
+    const CFX_AggClipRgn::Runs& runs2,
+    const FX_RECT& box) {
+  CFX_AggClipRgn::RunsBuilder builder(box);
+  for (int y = box.top; y < box.bottom; ++y) {
+    pdfium::span<const CFX_AggClipRgn::Run> row1 = runs1.GetRow(y);
+    pdfium::span<const CFX_AggClipRgn::Run> row2 = runs2.GetRow(y);
+    size_t i1 = 0;
+    size_t i2 = 0;
+    while (i1 < row1.size() && i2 < row2.size()) {
+      const CFX_AggClipRgn::Run& run1 = row1[i1];
+      const CFX_AggClipRgn::Run& run2 = row2[i2];
+      const int left = std::max(run1.left, run2.left);
+      const int right = std::min(run1.right, run2.right);
+      if (left < right) {
+        builder.AddRun(y, left, right, run1.coverage * run2.coverage / 255);
+      }
+      if (run1.right <= run2.right) {
+        ++i1;
+      } else {
+        ++i2;
+      }
+    }
+  }
+  return builder.Build();
+}
 
-void CFX_AggClipRgn::IntersectRect(const FX_RECT& rect) {
-  if (type_ == kRectI) {
-    box_.Intersect(rect);
+}  // namespace
+
+CFX_AggClipRgn::Runs::Runs(const FX_RECT& box,
+                           std::vector<uint32_t> row_starts,
+                           std::vector<Run> runs)
+    : box_(box), row_starts_(std::move(row_starts)), runs_(std::move(runs)) {
+  CHECK_EQ(row_starts_.size(), static_cast<size_t>(box_.Height()) + 1);
+}
+
+CFX_AggClipRgn::Runs::~Runs() = default;
+
+pdfium::span<const CFX_AggClipRgn::Run> CFX_AggClipRgn::Runs::GetRow(
+    int y) const {
+  CHECK_GE(y, box_.top);
+  CHECK_LT(y, box_.bottom);
+  const size_t row = static_cast<size_t>(y - box_.top);
+  return pdfium::span(runs_).subspan(row_starts_[row],
+                                     row_starts_[row + 1] - row_starts_[row]);
+}
+
+CFX_AggClipRgn::RunsBuilder::RunsBuilder(const FX_RECT& box)
+    : box_(box), next_row_(box.top) {
+  row_starts_.reserve(static_cast<size_t>(box_.Height()) + 1);
+}
+
+CFX_AggClipRgn::RunsBuilder::~RunsBuilder() = default;
+
+void CFX_AggClipRgn::RunsBuilder::AddRun(int y,
+                                         int left,
+                                         int right,
+                                         uint8_t coverage) {
+  left = std::max(left, box_.left);
+  right = std::min(right, box_.right);
+  if (coverage == 0 || left >= right || y < box_.top || y >= box_.bottom) {
     return;
   }
-  IntersectMaskRect(rect, box_, mask_);
+
+  CHECK_GE(y, next_row_ - 1);
+  FinishRowsUpTo(y);
+  if (!runs_.empty() && row_starts_.back() < runs_.size()) {
+    Run& last = runs_.back();
+    CHECK_LE(last.right, left);
+    if (last.right == left && last.coverage == coverage) {
+      last.right = right;
+      return;
+    }
+  }
+  runs_.push_back({.left = left, .right = right, .coverage = coverage});
 }
 
-void CFX_AggClipRgn::IntersectMaskRect(FX_RECT rect,
-                                       FX_RECT mask_rect,
-                                       RetainPtr<CFX_DIBitmap> pOldMask) {
-  type_ = kMaskF;
-  box_ = rect;
-  box_.Intersect(mask_rect);
-  if (box_.IsEmpty()) {
-    type_ = kRectI;
-    return;
+RetainPtr<const CFX_AggClipRgn::Runs> CFX_AggClipRgn::RunsBuilder::Build() {
+  FinishRowsUpTo(box_.bottom);
+  row_starts_.push_back(fxcrt::CollectionSize<uint32_t>(runs_));
+  return pdfium::MakeRetain<Runs>(box_, std::move(row_starts_),
+                                  std::move(runs_));
+}
+
+void CFX_AggClipRgn::RunsBuilder::FinishRowsUpTo(int y) {
+  // Starts the rows up to and including `y`, if within the box. Rows without
+  // runs start and end at the current end of `runs_`.
+  const int last_row = std::min(y, box_.bottom - 1);
+  while (next_row_ <= last_row) {
+    row_starts_.push_back(fxcrt::CollectionSize<uint32_t>(runs_));
+    ++next_row_;
   }
-  if (box_ == mask_rect) {
-    mask_ = std::move(pOldMask);
-    return;
+}
+
+CFX_AggClipRgn::CFX_AggClipRgn(int width, int height)
+    : box_(0, 0, width, height) {}
+
+CFX_AggClipRgn::CFX_AggClipRgn(const CFX_AggClipRgn& src) = default;
+
+CFX_AggClipRgn::~CFX_AggClipRgn() = default;
+
+RetainPtr<CFX_DIBitmap> CFX_AggClipRgn::GetMask() const {
+  if (type_ != kMaskF) {
+    return nullptr;
   }
-  mask_ = pdfium::MakeRetain<CFX_DIBitmap>();
-  CHECK(mask_->Create(box_.Width(), box_.Height(), FXDIB_Format::k8bppMask));
-  const int offset = box_.left - mask_rect.left;
-  for (int row = box_.top; row < box_.bottom; row++) {
-    pdfium::span<uint8_t> dest_scan =
-        mask_->GetWritableScanline(row - box_.top);
-    pdfium::span<const uint8_t> src_scan =
-        pOldMask->GetScanline(row - mask_rect.top);
-    fxcrt::Copy(src_scan.subspan(static_cast<size_t>(offset),
-                                 static_cast<size_t>(box_.Width())),
-                dest_scan);
+  if (!runs_->mask_) {
+    auto mask = pdfium::MakeRetain<CFX_DIBitmap>();
+    CHECK(mask->Create(box_.Width(), box_.Height(), FXDIB_Format::k8bppMask));
+    for (int y = box_.top; y < box_.bottom; ++y) {
+      pdfium::span<uint8_t> scan = mask->GetWritableScanline(y - box_.top);
+      for (const Run& run : runs_->GetRow(y)) {
+        std::ranges::fill(
+            scan.subspan(static_cast<size_t>(run.left - box_.left),
+                         static_cast<size_t>(run.right - run.left)),
+            run.coverage);
+      }
+    }
+    runs_->mask_ = std::move(mask);
   }
+  return runs_->mask_;
 }
 
-void CFX_AggClipRgn::IntersectMaskF(int left,
-                                    int top,
-                                    RetainPtr<CFX_DIBitmap> pMask) {
-  FX_RECT mask_box(left, top, left + pMask->GetWidth(),
-                   top + pMask->GetHeight());
-  if (!mask_box.IsEmpty()) {
-    // Make sure non-empty masks have the right format. If the mask is empty,
-    // then the format does not matter as it will not get used.
-    CHECK_EQ(pMask->GetFormat(), FXDIB_Format::k8bppMask);
+void CFX_AggClipRgn::IntersectRect(const FX_RECT& rect) {
+  FX_RECT new_box = box_;
+  new_box.Intersect(rect);
+  if (type_ == kRectI || new_box == box_) {
+    box_ = new_box;
+    return;
   }
-  if (type_ == kRectI) {
-    IntersectMaskRect(box_, mask_box, std::move(pMask));
+  box_ = new_box;
+  if (box_.IsEmpty()) {
+    type_ = kRectI;
+    runs_.Reset();
     return;
   }
+  runs_ = CropRuns(*runs_, box_);
+}
 
+void CFX_AggClipRgn::IntersectMaskF(RetainPtr<const Runs> mask) {
   FX_RECT new_box = box_;
-  new_box.Intersect(mask_box);
+  new_box.Intersect(mask->GetBox());
   if (new_box.IsEmpty()) {
     type_ = kRectI;
-    mask_ = nullptr;
     box_ = new_box;
+    runs_.Reset();
     return;
   }
-  auto new_dib = pdfium::MakeRetain<CFX_DIBitmap>();
-  CHECK(new_dib->Create(new_box.Width(), new_box.Height(),
-                        FXDIB_Format::k8bppMask));
-  for (int row = new_box.top; row < new_box.bottom; row++) {
-    pdfium::span<const uint8_t> old_scan = mask_->GetScanline(row - box_.top);
-    pdfium::span<const uint8_t> mask_scan = pMask->GetScanline(row - top);
-    auto new_scan = new_dib->GetWritableScanline(row - new_box.top);
-    for (int col = new_box.left; col < new_box.right; col++) {
-      new_scan[col - new_box.left] =
-          old_scan[col - box_.left] * mask_scan[col - left] / 255;
-    }
+
+  if (type_ == kRectI) {
+    runs_ = new_box == mask->GetBox() ? std::move(mask)
+                                      : CropRuns(*mask, new_box);
+  } else {
+    runs_ = MultiplyRuns(*runs_, *mask, new_box);
   }
+  type_ = kMaskF;
   box_ = new_box;
-  mask_ = std::move(new_dib);
 }
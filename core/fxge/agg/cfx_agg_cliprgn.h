@@ -7,34 +7,102 @@
 #ifndef CORE_FXGE_AGG_CFX_AGG_CLIPRGN_H_
 #define CORE_FXGE_AGG_CFX_AGG_CLIPRGN_H_
 
+#include <stdint.h>
+
+#include <vector>
+
 #include "core/fxcrt/fx_coordinates.h"
 #include "core/fxcrt/retain_ptr.h"
+#include "core/fxcrt/span.h"
 
 class CFX_DIBitmap;
 
+// A clip region is either a rectangle, or a box with the coverage of each of
+// its pixels. The coverage gets stored as runs of pixels, which is much
+// smaller than a mask bitmap for typical clip paths. Copies share the runs,
+// which never change once built, so saving the clip state is cheap.
 class CFX_AggClipRgn {
  public:
   enum ClipType : bool { kRectI, kMaskF };
 
+  // Pixels in a row that have the same nonzero coverage.
+  struct Run {
+    bool operator==(const Run& that) const = default;
+
+    int left;
+    int right;  // Exclusive.
+    uint8_t coverage;
+  };
+
+  // The runs of each row of a box, sorted left to right.
+  class Runs final : public Retainable {
+   public:
+    CONSTRUCT_VIA_MAKE_RETAIN;
+
+    const FX_RECT& GetBox() const { return box_; }
+
+    // Returns the runs of row `y`, which must be within the box.
+    pdfium::span<const Run> GetRow(int y) const;
+
+   private:
+    friend class CFX_AggClipRgn;
+
+    Runs(const FX_RECT& box,
+         std::vector<uint32_t> row_starts,
+         std::vector<Run> runs);
+    ~Runs() override;
+
+    const FX_RECT box_;
+    // Index into `runs_` of the first run of each row, and the end of `runs_`.
+    const std::vector<uint32_t> row_starts_;
+    const std::vector<Run> runs_;
+    // Built on demand for code that needs the coverage as a bitmap.
+    mutable RetainPtr<CFX_DIBitmap> mask_;
+  };
+
+  // Builds `Runs` for a box, row by row.
+  class RunsBuilder {
+   public:
+    explicit RunsBuilder(const FX_RECT& box);
+    ~RunsBuilder();
+
+    // Adds pixels `left` to `right` of row `y` with `coverage`, clipped to the
+    // box. Rows must be added top to bottom, and runs within a row left to
+    // right, without overlap.
+    void AddRun(int y, int left, int right, uint8_t coverage);
+
+    RetainPtr<const Runs> Build();
+
+   private:
+    void FinishRowsUpTo(int y);
+
+    const FX_RECT box_;
+    int next_row_;
+    std::vector<uint32_t> row_starts_;
+    std::vector<Run> runs_;
+  };
+
   CFX_AggClipRgn(int device_width, int device_height);
   CFX_AggClipRgn(const CFX_AggClipRgn& src);
   ~CFX_AggClipRgn();
 
   ClipType GetType() const { return type_; }
   const FX_RECT& GetBox() const { return box_; }
-  RetainPtr<CFX_DIBitmap> GetMask() const { return mask_; }
+
+  // Only valid for kMaskF regions. The box of the runs is GetBox().
+  const Runs* GetRuns() const { return runs_.Get(); }
+
+  // Returns the coverage of GetBox() as a k8bppMask bitmap for kMaskF regions,
+  // or nullptr. Must not be modified.
+  RetainPtr<CFX_DIBitmap> GetMask() const;
 
   void IntersectRect(const FX_RECT& rect);
-  void IntersectMaskF(int left, int top, RetainPtr<CFX_DIBitmap> Mask);
+  void IntersectMaskF(RetainPtr<const Runs> mask);
 
  private:
-  void IntersectMaskRect(FX_RECT rect,
-                         FX_RECT mask_rect,
-                         RetainPtr<CFX_DIBitmap> pOldMask);
-
   ClipType type_ = kRectI;
   FX_RECT box_;
-  RetainPtr<CFX_DIBitmap> mask_;
+  RetainPtr<const Runs> runs_;
 };
 
 #endif  // CORE_FXGE_AGG_CFX_AGG_CLIPRGN_H_
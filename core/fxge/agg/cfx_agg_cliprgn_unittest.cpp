@@ -0,0 +1,107 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxge/agg/cfx_agg_cliprgn.h"
+
+#include <vector>
+
+#include "core/fxge/dib/cfx_dibitmap.h"
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+using ::testing::ElementsAre;
+using ClipRun = CFX_AggClipRgn::Run;
+
+std::vector<ClipRun> GetRow(const CFX_AggClipRgn::Runs& runs, int y) {
+  pdfium::span<const ClipRun> row = runs.GetRow(y);
+  return std::vector<ClipRun>(row.begin(), row.end());
+}
+
+// A 4x3 mask at (2, 1). Row 1 has a hole in the middle, row 2 is empty.
+RetainPtr<const CFX_AggClipRgn::Runs> CreateMask() {
+  CFX_AggClipRgn::RunsBuilder builder(FX_RECT(2, 1, 6, 4));
+  builder.AddRun(1, 0, 3, 100);
+  builder.AddRun(1, 3, 4, 100);
+  builder.AddRun(1, 5, 10, 255);
+  builder.AddRun(3, 2, 6, 255);
+  return builder.Build();
+}
+
+}  // namespace
+
+TEST(CFXAggClipRgnTest, RunsBuilder) {
+  RetainPtr<const CFX_AggClipRgn::Runs> runs = CreateMask();
+  EXPECT_EQ(FX_RECT(2, 1, 6, 4), runs->GetBox());
+
+  // Runs get clipped to the box, and adjacent runs with the same coverage get
+  // merged.
+  EXPECT_EQ((std::vector<ClipRun>{{2, 4, 100}, {5, 6, 255}}),
+            GetRow(*runs, 1));
+  EXPECT_TRUE(GetRow(*runs, 2).empty());
+  EXPECT_EQ((std::vector<ClipRun>{{2, 6, 255}}), GetRow(*runs, 3));
+}
+
+TEST(CFXAggClipRgnTest, IntersectMaskF) {
+  CFX_AggClipRgn clip_rgn(10, 10);
+  EXPECT_EQ(CFX_AggClipRgn::kRectI, clip_rgn.GetType());
+
+  clip_rgn.IntersectMaskF(CreateMask());
+  ASSERT_EQ(CFX_AggClipRgn::kMaskF, clip_rgn.GetType());
+  EXPECT_EQ(FX_RECT(2, 1, 6, 4), clip_rgn.GetBox());
+
+  // Copies share the runs until either one changes.
+  CFX_AggClipRgn saved(clip_rgn);
+  EXPECT_EQ(clip_rgn.GetRuns(), saved.GetRuns());
+
+  CFX_AggClipRgn::RunsBuilder builder(FX_RECT(0, 0, 4, 10));
+  for (int y = 0; y < 10; ++y) {
+    builder.AddRun(y, 0, 4, 51);
+  }
+  clip_rgn.IntersectMaskF(builder.Build());
+  ASSERT_EQ(CFX_AggClipRgn::kMaskF, clip_rgn.GetType());
+  EXPECT_EQ(FX_RECT(2, 1, 4, 4), clip_rgn.GetBox());
+  EXPECT_EQ((std::vector<ClipRun>{{2, 4, 20}}), GetRow(*clip_rgn.GetRuns(), 1));
+  EXPECT_TRUE(GetRow(*clip_rgn.GetRuns(), 2).empty());
+  EXPECT_EQ((std::vector<ClipRun>{{2, 4, 51}}), GetRow(*clip_rgn.GetRuns(), 3));
+
+  EXPECT_NE(clip_rgn.GetRuns(), saved.GetRuns());
+  EXPECT_EQ(FX_RECT(2, 1, 6, 4), saved.GetBox());
+}
+
+TEST(CFXAggClipRgnTest, IntersectRect) {
+  CFX_AggClipRgn clip_rgn(10, 10);
+  clip_rgn.IntersectRect(FX_RECT(1, 1, 20, 5));
+  EXPECT_EQ(CFX_AggClipRgn::kRectI, clip_rgn.GetType());
+  EXPECT_EQ(FX_RECT(1, 1, 10, 5), clip_rgn.GetBox());
+
+  clip_rgn.IntersectMaskF(CreateMask());
+  clip_rgn.IntersectRect(FX_RECT(3, 0, 10, 2));
+  ASSERT_EQ(CFX_AggClipRgn::kMaskF, clip_rgn.GetType());
+  EXPECT_EQ(FX_RECT(3, 1, 6, 2), clip_rgn.GetBox());
+  EXPECT_EQ((std::vector<ClipRun>{{3, 4, 100}, {5, 6, 255}}),
+            GetRow(*clip_rgn.GetRuns(), 1));
+
+  clip_rgn.IntersectRect(FX_RECT(0, 5, 10, 10));
+  EXPECT_EQ(CFX_AggClipRgn::kRectI, clip_rgn.GetType());
+  EXPECT_TRUE(clip_rgn.GetBox().IsEmpty());
+}
+
+TEST(CFXAggClipRgnTest, GetMask) {
+  CFX_AggClipRgn clip_rgn(10, 10);
+  EXPECT_FALSE(clip_rgn.GetMask());
+
+  clip_rgn.IntersectMaskF(CreateMask());
+  RetainPtr<CFX_DIBitmap> mask = clip_rgn.GetMask();
+  ASSERT_TRUE(mask);
+  EXPECT_EQ(FXDIB_Format::k8bppMask, mask->GetFormat());
+  EXPECT_EQ(4, mask->GetWidth());
+  EXPECT_EQ(3, mask->GetHeight());
+  EXPECT_EQ(mask, clip_rgn.GetMask());
+
+  EXPECT_THAT(mask->GetScanline(0), ElementsAre(100, 100, 0, 255));
+  EXPECT_THAT(mask->GetScanline(1), ElementsAre(0, 0, 0, 0));
+  EXPECT_THAT(mask->GetScanline(2), ElementsAre(255, 255, 255, 255));
+}
@@ -19,7 +19,7 @@
 #include "core/fxcrt/fx_safe_types.h"
 #include "core/fxcrt/notreached.h"
 #include "core/fxcrt/span.h"
-#include "core/fxcrt/unowned_ptr_exclusion.h"
+#include "core/fxcrt/unowned_ptr.h"
 #include "core/fxcrt/zip.h"
 #include "core/fxge/agg/cfx_agg_cliprgn.h"
 #include "core/fxge/agg/cfx_agg_imagerenderer.h"
@@ -39,7 +39,6 @@
 #include "third_party/agg23/agg_conv_stroke.h"
 #include "third_party/agg23/agg_curves.h"
 #include "third_party/agg23/agg_path_storage.h"
-#include "third_party/agg23/agg_pixfmt_gray.h"
 #include "third_party/agg23/agg_rasterizer_scanline_aa.h"
 #include "third_party/agg23/agg_renderer_scanline.h"
 #include "third_party/agg23/agg_scanline_u.h"
@@ -347,8 +346,8 @@ agg::filling_rule_e GetAlternateOrWindingFillType(
              : agg::fill_even_odd;
 }
 
-RetainPtr<CFX_DIBitmap> GetClipMaskFromRegion(const CFX_AggClipRgn* r) {
-  return (r && r->GetType() == CFX_AggClipRgn::kMaskF) ? r->GetMask() : nullptr;
+const CFX_AggClipRgn::Runs* GetClipRunsFromRegion(const CFX_AggClipRgn* r) {
+  return (r && r->GetType() == CFX_AggClipRgn::kMaskF) ? r->GetRuns() : nullptr;
 }
 
 FX_RECT GetClipBoxFromRegion(const RetainPtr<CFX_DIBitmap>& device,
@@ -380,7 +379,7 @@ class CFX_AggRenderer {
                                                       int,
                                                       int,
                                                       const uint8_t*,
-                                                      const uint8_t*);
+                                                      int);
 
   void CompositeSpan(uint8_t* dest_scan,
                      const uint8_t* backdrop_scan,
@@ -389,28 +388,28 @@ class CFX_AggRenderer {
                      int col_start,
                      int col_end,
                      const uint8_t* cover_scan,
-                     const uint8_t* clip_scan);
+                     int clip_alpha);
 
   void CompositeSpanGray(uint8_t* dest_scan,
                          int bytes_per_pixel,
                          int col_start,
                          int col_end,
                          const uint8_t* cover_scan,
-                         const uint8_t* clip_scan);
+                         int clip_alpha);
 
   void CompositeSpanARGB(uint8_t* dest_scan,
                          int bytes_per_pixel,
                          int col_start,
                          int col_end,
                          const uint8_t* cover_scan,
-                         const uint8_t* clip_scan);
+                         int clip_alpha);
 
   void CompositeSpanRGB(uint8_t* dest_scan,
                         int bytes_per_pixel,
                         int col_start,
                         int col_end,
                         const uint8_t* cover_scan,
-                        const uint8_t* clip_scan);
+                        int clip_alpha);
 
   static CompositeSpanFunc GetCompositeSpanFunc(
       const RetainPtr<CFX_DIBitmap>& device) {
@@ -426,18 +425,32 @@ class CFX_AggRenderer {
     return &CFX_AggRenderer::CompositeSpanRGB;
   }
 
-  inline int GetSrcAlpha(const uint8_t* clip_scan, int col) const {
-    return clip_scan ? alpha_ * UNSAFE_TODO(clip_scan[col]) / 255 : alpha_;
+  // `clip_alpha` is the clip coverage of the pixels being composited, which is
+  // 255 where there is no clip mask.
+  inline int GetSrcAlpha(int clip_alpha) const {
+    return clip_alpha == 255 ? alpha_ : alpha_ * clip_alpha / 255;
   }
 
   inline int GetSourceAlpha(const uint8_t* cover_scan,
-                            const uint8_t* clip_scan,
+                            int clip_alpha,
                             int col) const {
-    return UNSAFE_TODO(clip_scan ? alpha_ * cover_scan[col] * clip_scan[col] /
-                                       255 / 255
-                                 : alpha_ * cover_scan[col] / 255);
+    return UNSAFE_TODO(clip_alpha == 255
+                           ? alpha_ * cover_scan[col] / 255
+                           : alpha_ * cover_scan[col] * clip_alpha / 255 / 255);
   }
 
+  // Composites columns `col_start` to `col_end` of a span at `x` in row `y`,
+  // once per run of equal clip coverage.
+  void CompositeClippedSpan(uint8_t* dest_pos,
+                            const uint8_t* backdrop_pos,
+                            int bytes_per_pixel,
+                            bool bDestAlpha,
+                            int x,
+                            int y,
+                            int col_start,
+                            int col_end,
+                            const uint8_t* cover_scan);
+
   static int GetColStart(int span_left, int clip_left) {
     return span_left < clip_left ? clip_left - span_left : 0;
   }
@@ -459,9 +472,10 @@ class CFX_AggRenderer {
   const bool rgb_byte_order_;
   const FX_RECT clip_box_;
   RetainPtr<CFX_DIBitmap> const backdrop_device_;
-  RetainPtr<CFX_DIBitmap> const clip_mask_;
   RetainPtr<CFX_DIBitmap> const device_;
   UnownedPtr<const CFX_AggClipRgn> clip_rgn_;
+  // The clip coverage within `clip_box_`, or nullptr if there is no mask.
+  UnownedPtr<const CFX_AggClipRgn::Runs> const clip_runs_;
   const CompositeSpanFunc composite_span_func_;
 };
 
@@ -472,7 +486,7 @@ void CFX_AggRenderer::CompositeSpan(uint8_t* dest_scan,
                                     int col_start,
                                     int col_end,
                                     const uint8_t* cover_scan,
-                                    const uint8_t* clip_scan) {
+                                    int clip_alpha) {
   CHECK(bytes_per_pixel);
   UNSAFE_TODO({
     dest_scan += col_start * bytes_per_pixel;
@@ -481,7 +495,7 @@ void CFX_AggRenderer::CompositeSpan(uint8_t* dest_scan,
       if (bytes_per_pixel == 4 && bDestAlpha) {
         const auto& bgr = GetBGR();
         for (int col = col_start; col < col_end; col++) {
-          int src_alpha = GetSrcAlpha(clip_scan, col);
+          int src_alpha = GetSrcAlpha(clip_alpha);
           uint8_t dest_alpha =
               backdrop_scan[3] + src_alpha - backdrop_scan[3] * src_alpha / 255;
           dest_scan[3] = dest_alpha;
@@ -513,7 +527,7 @@ void CFX_AggRenderer::CompositeSpan(uint8_t* dest_scan,
       if (bytes_per_pixel == 3 || bytes_per_pixel == 4) {
         const auto& bgr = GetBGR();
         for (int col = col_start; col < col_end; col++) {
-          int src_alpha = GetSrcAlpha(clip_scan, col);
+          int src_alpha = GetSrcAlpha(clip_alpha);
           int r = FXDIB_ALPHA_MERGE(*backdrop_scan++, bgr.red, src_alpha);
           int g = FXDIB_ALPHA_MERGE(*backdrop_scan++, bgr.green, src_alpha);
           int b = FXDIB_ALPHA_MERGE(*backdrop_scan, bgr.blue, src_alpha);
@@ -531,7 +545,7 @@ void CFX_AggRenderer::CompositeSpan(uint8_t* dest_scan,
     if (bytes_per_pixel == 4 && bDestAlpha) {
       const auto& bgr = GetBGR();
       for (int col = col_start; col < col_end; col++) {
-        int src_alpha = GetSrcAlpha(clip_scan, col);
+        int src_alpha = GetSrcAlpha(clip_alpha);
         int src_alpha_covered = src_alpha * cover_scan[col] / 255;
         if (src_alpha_covered == 0) {
           dest_scan += 4;
@@ -567,7 +581,7 @@ void CFX_AggRenderer::CompositeSpan(uint8_t* dest_scan,
     if (bytes_per_pixel == 3 || bytes_per_pixel == 4) {
       const auto& bgr = GetBGR();
       for (int col = col_start; col < col_end; col++) {
-        int src_alpha = GetSrcAlpha(clip_scan, col);
+        int src_alpha = GetSrcAlpha(clip_alpha);
         if (full_cover_) {
           *dest_scan++ =
               FXDIB_ALPHA_MERGE(*backdrop_scan++, bgr.blue, src_alpha);
@@ -594,7 +608,7 @@ void CFX_AggRenderer::CompositeSpan(uint8_t* dest_scan,
     CHECK_EQ(bytes_per_pixel, 1);
     const int gray = GetGray();
     for (int col = col_start; col < col_end; col++) {
-      int src_alpha = GetSrcAlpha(clip_scan, col);
+      int src_alpha = GetSrcAlpha(clip_alpha);
       if (full_cover_) {
         *dest_scan = FXDIB_ALPHA_MERGE(*backdrop_scan++, gray, src_alpha);
         continue;
@@ -611,13 +625,13 @@ void CFX_AggRenderer::CompositeSpanGray(uint8_t* dest_scan,
                                         int col_start,
                                         int col_end,
                                         const uint8_t* cover_scan,
-                                        const uint8_t* clip_scan) {
+                                        int clip_alpha) {
   DCHECK(!rgb_byte_order_);
   const int gray = GetGray();
   UNSAFE_TODO({
     dest_scan += col_start;
     for (int col = col_start; col < col_end; col++) {
-      int src_alpha = GetSourceAlpha(cover_scan, clip_scan, col);
+      int src_alpha = GetSourceAlpha(cover_scan, clip_alpha, col);
       if (src_alpha) {
         if (src_alpha == 255) {
           *dest_scan = gray;
@@ -635,15 +649,15 @@ void CFX_AggRenderer::CompositeSpanARGB(uint8_t* dest_scan,
                                         int col_start,
                                         int col_end,
                                         const uint8_t* cover_scan,
-                                        const uint8_t* clip_scan) {
+                                        int clip_alpha) {
   const auto& bgr = GetBGR();
   UNSAFE_TODO({
     dest_scan += col_start * bytes_per_pixel;
     if (rgb_byte_order_) {
       for (int col = col_start; col < col_end; col++) {
         int src_alpha = full_cover_
-                            ? GetSrcAlpha(clip_scan, col)
-                            : GetSourceAlpha(cover_scan, clip_scan, col);
+                            ? GetSrcAlpha(clip_alpha)
+                            : GetSourceAlpha(cover_scan, clip_alpha, col);
         if (src_alpha) {
           if (src_alpha == 255) {
             *(reinterpret_cast<uint32_t*>(dest_scan)) = color_;
@@ -666,8 +680,8 @@ void CFX_AggRenderer::CompositeSpanARGB(uint8_t* dest_scan,
       return;
     }
     for (int col = col_start; col < col_end; col++) {
-      int src_alpha = full_cover_ ? GetSrcAlpha(clip_scan, col)
-                                  : GetSourceAlpha(cover_scan, clip_scan, col);
+      int src_alpha = full_cover_ ? GetSrcAlpha(clip_alpha)
+                                  : GetSourceAlpha(cover_scan, clip_alpha, col);
       if (src_alpha) {
         if (src_alpha == 255) {
           *(reinterpret_cast<uint32_t*>(dest_scan)) = color_;
@@ -703,13 +717,13 @@ void CFX_AggRenderer::CompositeSpanRGB(uint8_t* dest_scan,
                                        int col_start,
                                        int col_end,
                                        const uint8_t* cover_scan,
-                                       const uint8_t* clip_scan) {
+                                       int clip_alpha) {
   const auto& bgr = GetBGR();
   UNSAFE_TODO({
     dest_scan += col_start * bytes_per_pixel;
     if (rgb_byte_order_) {
       for (int col = col_start; col < col_end; col++) {
-        int src_alpha = GetSourceAlpha(cover_scan, clip_scan, col);
+        int src_alpha = GetSourceAlpha(cover_scan, clip_alpha, col);
         if (src_alpha) {
           if (src_alpha == 255) {
             if (bytes_per_pixel == 4) {
@@ -735,8 +749,8 @@ void CFX_AggRenderer::CompositeSpanRGB(uint8_t* dest_scan,
       return;
     }
     for (int col = col_start; col < col_end; col++) {
-      int src_alpha = full_cover_ ? GetSrcAlpha(clip_scan, col)
-                                  : GetSourceAlpha(cover_scan, clip_scan, col);
+      int src_alpha = full_cover_ ? GetSrcAlpha(clip_alpha)
+                                  : GetSourceAlpha(cover_scan, clip_alpha, col);
       if (src_alpha) {
         if (src_alpha == 255) {
           if (bytes_per_pixel == 4) {
@@ -774,9 +788,9 @@ CFX_AggRenderer::CFX_AggRenderer(const RetainPtr<CFX_DIBitmap>& pDevice,
       rgb_byte_order_(bRgbByteOrder),
       clip_box_(GetClipBoxFromRegion(pDevice, pClipRgn)),
       backdrop_device_(pBackdropDevice),
-      clip_mask_(GetClipMaskFromRegion(pClipRgn)),
       device_(pDevice),
       clip_rgn_(pClipRgn),
+      clip_runs_(GetClipRunsFromRegion(pClipRgn)),
       composite_span_func_(GetCompositeSpanFunc(device_)) {
   if (device_->GetBPP() == 8) {
     DCHECK(!rgb_byte_order_);
@@ -792,6 +806,46 @@ CFX_AggRenderer::CFX_AggRenderer(const RetainPtr<CFX_DIBitmap>& pDevice,
   color_data_ = ArgbToBGRStruct(color);
 }
 
+void CFX_AggRenderer::CompositeClippedSpan(uint8_t* dest_pos,
+                                           const uint8_t* backdrop_pos,
+                                           int bytes_per_pixel,
+                                           bool bDestAlpha,
+                                           int x,
+                                           int y,
+                                           int col_start,
+                                           int col_end,
+                                           const uint8_t* cover_scan) {
+  // Pixels between the runs have no clip coverage. Only compositing against a
+  // backdrop still writes to them.
+  int col = col_start;
+  for (const CFX_AggClipRgn::Run& run : clip_runs_->GetRow(y)) {
+    const int run_start = std::max(run.left - x, col_start);
+    const int run_end = std::min(run.right - x, col_end);
+    if (run_end <= col_start) {
+      continue;
+    }
+    if (run_start >= col_end) {
+      break;
+    }
+    if (backdrop_pos) {
+      if (col < run_start) {
+        CompositeSpan(dest_pos, backdrop_pos, bytes_per_pixel, bDestAlpha, col,
+                      run_start, cover_scan, /*clip_alpha=*/0);
+      }
+      CompositeSpan(dest_pos, backdrop_pos, bytes_per_pixel, bDestAlpha,
+                    run_start, run_end, cover_scan, run.coverage);
+    } else {
+      (this->*composite_span_func_)(dest_pos, bytes_per_pixel, run_start,
+                                    run_end, cover_scan, run.coverage);
+    }
+    col = run_end;
+  }
+  if (backdrop_pos && col < col_end) {
+    CompositeSpan(dest_pos, backdrop_pos, bytes_per_pixel, bDestAlpha, col,
+                  col_end, cover_scan, /*clip_alpha=*/0);
+  }
+}
+
 template <class Scanline>
 void CFX_AggRenderer::render(const Scanline& sl) {
   int y = sl.y();
@@ -822,21 +876,19 @@ void CFX_AggRenderer::render(const Scanline& sl) {
       uint8_t* dest_pos = dest_scan + x * bytes_per_pixel;
       const uint8_t* backdrop_pos =
           backdrop_scan ? backdrop_scan + x * bytes_per_pixel : nullptr;
-      const uint8_t* clip_pos = nullptr;
-      if (clip_mask_) {
-        // TODO(crbug.com/1382604): use subspan arithmetic.
-        clip_pos = clip_mask_->GetBuffer().data() +
-                   (y - clip_box_.top) * clip_mask_->GetPitch() + x -
-                   clip_box_.left;
-      }
       const int col_start = GetColStart(x, clip_box_.left);
       const int col_end = GetColEnd(x, span->len, clip_box_.right);
-      if (backdrop_pos) {
+      if (clip_runs_) {
+        CompositeClippedSpan(dest_pos, backdrop_pos, bytes_per_pixel,
+                             bDestAlpha, x, y, col_start, col_end,
+                             span->covers);
+      } else if (backdrop_pos) {
         CompositeSpan(dest_pos, backdrop_pos, bytes_per_pixel, bDestAlpha,
-                      col_start, col_end, span->covers, clip_pos);
+                      col_start, col_end, span->covers, /*clip_alpha=*/255);
       } else {
         (this->*composite_span_func_)(dest_pos, bytes_per_pixel, col_start,
-                                      col_end, span->covers, clip_pos);
+                                      col_end, span->covers,
+                                      /*clip_alpha=*/255);
       }
       if (--num_spans == 0) {
         break;
@@ -847,29 +899,38 @@ void CFX_AggRenderer::render(const Scanline& sl) {
   });
 }
 
-template <class BaseRenderer>
-class RendererScanLineAaOffset {
+// Collects the coverage of a clip path as runs, instead of rendering it into
+// a mask bitmap first.
+class ClipRunsRenderer {
  public:
-  typedef BaseRenderer base_ren_type;
-  typedef typename base_ren_type::color_type color_type;
-  RendererScanLineAaOffset(base_ren_type& ren, unsigned left, unsigned top)
-      : ren_(&ren), left_(left), top_(top) {}
-  void color(const color_type& c) { color_ = c; }
-  const color_type& color() const { return color_; }
+  explicit ClipRunsRenderer(CFX_AggClipRgn::RunsBuilder* builder)
+      : builder_(builder) {}
+
+  // Needed for agg caller
   void prepare(unsigned) {}
+
   template <class Scanline>
   void render(const Scanline& sl) {
-    int y = sl.y();
+    const int y = sl.y();
     unsigned num_spans = sl.num_spans();
     typename Scanline::const_iterator span = sl.begin();
     while (true) {
-      int x = span->x;
+      const int x = span->x;
       if (span->len > 0) {
-        ren_->blend_solid_hspan(x - left_, y - top_, (unsigned)span->len,
-                                color_, span->covers);
+        // Adds pixels with equal coverage as one run.
+        const uint8_t* covers = span->covers;
+        int run_start = 0;
+        for (int i = 1; i <= span->len; ++i) {
+          if (i < span->len && UNSAFE_TODO(covers[i] == covers[run_start])) {
+            continue;
+          }
+          const uint8_t cover = UNSAFE_TODO(covers[run_start]);
+          builder_->AddRun(y, x + run_start, x + i, CoverToClipAlpha(cover));
+          run_start = i;
+        }
       } else {
-        ren_->blend_hline(x - left_, y - top_, (unsigned)(x - span->len - 1),
-                          color_, *(span->covers));
+        builder_->AddRun(y, x, x - span->len,
+                         CoverToClipAlpha(*(span->covers)));
       }
       if (--num_spans == 0) {
         break;
@@ -880,10 +941,16 @@ class RendererScanLineAaOffset {
   }
 
  private:
-  UNOWNED_PTR_EXCLUSION base_ren_type* ren_;
-  color_type color_;
-  unsigned left_;
-  unsigned top_;
+  // Matches blending a `cover` of opaque white onto a black gray8 pixel, which
+  // is how clip masks used to get rendered.
+  static uint8_t CoverToClipAlpha(uint8_t cover) {
+    if (cover == 255) {
+      return 255;
+    }
+    return cover ? cover - 1 : 0;
+  }
+
+  UnownedPtr<CFX_AggClipRgn::RunsBuilder> const builder_;
 };
 
 agg::path_storage BuildAggPath(const CFX_Path& path,
@@ -1031,24 +1098,14 @@ void CFX_AggDeviceDriver::SetClipMask(agg::rasterizer_scanline_aa& rasterizer) {
   FX_RECT path_rect(rasterizer.min_x(), rasterizer.min_y(),
                     rasterizer.max_x() + 1, rasterizer.max_y() + 1);
   path_rect.Intersect(clip_rgn_->GetBox());
-  auto pThisLayer = pdfium::MakeRetain<CFX_DIBitmap>();
+  CFX_AggClipRgn::RunsBuilder builder(path_rect);
   if (!path_rect.IsEmpty()) {
-    CHECK(pThisLayer->Create(path_rect.Width(), path_rect.Height(),
-                             FXDIB_Format::k8bppMask));
-    agg::rendering_buffer raw_buf(
-        pThisLayer->GetWritableBuffer().data(), pThisLayer->GetWidth(),
-        pThisLayer->GetHeight(), pThisLayer->GetPitch());
-    agg::pixfmt_gray8 pixel_buf(raw_buf);
-    agg::renderer_base<agg::pixfmt_gray8> base_buf(pixel_buf);
-    RendererScanLineAaOffset<agg::renderer_base<agg::pixfmt_gray8>>
-        final_render(base_buf, path_rect.left, path_rect.top);
-    final_render.color(agg::gray8(255));
+    ClipRunsRenderer final_render(&builder);
     agg::scanline_u8 scanline;
     agg::render_scanlines(rasterizer, scanline, final_render,
                           fill_options_.aliased_path);
   }
-  clip_rgn_->IntersectMaskF(path_rect.left, path_rect.top,
-                            std::move(pThisLayer));
+  clip_rgn_->IntersectMaskF(builder.Build());
 }
 
 bool CFX_AggDeviceDriver::SetClip_PathFill(
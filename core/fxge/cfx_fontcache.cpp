@@ -6,11 +6,26 @@
 
 #include "core/fxge/cfx_fontcache.h"
 
+#include <utility>
+
 #include "core/fxge/cfx_font.h"
 #include "core/fxge/cfx_glyphcache.h"
 #include "core/fxge/fx_font.h"
 
-CFX_FontCache::CFX_FontCache() = default;
+namespace {
+
+constinit CacheBudget g_glyph_cache_budget(CacheBudget::kUnlimited);
+
+}  // namespace
+
+// static
+CacheBudget* CFX_FontCache::GetGlyphCacheBudget() {
+  return &g_glyph_cache_budget;
+}
+
+CFX_FontCache::CFX_FontCache() : CFX_FontCache(GetGlyphCacheBudget()) {}
+
+CFX_FontCache::CFX_FontCache(CacheBudget* budget) : budget_(budget) {}
 
 CFX_FontCache::~CFX_FontCache() = default;
 
@@ -23,11 +38,47 @@ RetainPtr<CFX_GlyphCache> CFX_FontCache::GetGlyphCache(const CFX_Font* font) {
     return pdfium::WrapRetain(it->second.Get());
   }
 
-  auto new_cache = pdfium::MakeRetain<CFX_GlyphCache>(face);
+  auto new_cache = pdfium::MakeRetain<CFX_GlyphCache>(face, this);
   map[face.Get()].Reset(new_cache.Get());
   return new_cache;
 }
 
+void CFX_FontCache::TrimGlyphCaches() {
+  if (!budget_->IsExceeded()) {
+    return;
+  }
+
+  while (budget_->IsExceeded() && !lru_.empty()) {
+    const CFX_GlyphCache::LruNode& node = lru_.front();
+    node.glyph_cache->EvictEntry(node.key);
+    lru_.pop_front();
+  }
+  RemoveDeadGlyphCaches();
+}
+
+CFX_GlyphCache::LruList::iterator CFX_FontCache::AddLruNode(
+    CFX_GlyphCache* glyph_cache,
+    CFX_GlyphCache::EntryKey key) {
+  CFX_GlyphCache::LruNode node = {UnownedPtr<CFX_GlyphCache>(glyph_cache),
+                                  std::move(key)};
+  return lru_.insert(lru_.end(), std::move(node));
+}
+
+void CFX_FontCache::TouchLruNode(CFX_GlyphCache::LruList::iterator it) {
+  lru_.splice(lru_.end(), lru_, it);
+}
+
+void CFX_FontCache::RemoveLruNode(CFX_GlyphCache::LruList::iterator it) {
+  lru_.erase(it);
+}
+
+void CFX_FontCache::RemoveDeadGlyphCaches() {
+  std::erase_if(glyph_cache_map_,
+                [](const auto& entry) { return !entry.second; });
+  std::erase_if(ext_glyph_cache_map_,
+                [](const auto& entry) { return !entry.second; });
+}
+
 #if defined(PDF_USE_SKIA)
 CFX_TypeFace* CFX_FontCache::GetDeviceCache(const CFX_Font* font) {
   return GetGlyphCache(font)->GetDeviceCache(font);
@@ -7,17 +7,32 @@
 #ifndef CORE_FXGE_CFX_FONTCACHE_H_
 #define CORE_FXGE_CFX_FONTCACHE_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <map>
 
+#include "core/fxcrt/cache_budget.h"
 #include "core/fxcrt/fx_system.h"
+#include "core/fxcrt/observed_ptr.h"
 #include "core/fxcrt/retain_ptr.h"
+#include "core/fxcrt/unowned_ptr.h"
 #include "core/fxge/cfx_glyphcache.h"
 
 class CFX_Font;
 
-class CFX_FontCache {
+// Caches glyphs for all the faces used on a thread. Glyph bitmaps, paths and
+// widths from all faces count against one budget, which the font caches of
+// all threads share. Bitmaps and widths are evicted least recently used
+// first. Paths are never evicted, see CFX_GlyphCache::Entry.
+class CFX_FontCache final : public Observable {
  public:
+  // The budget that font caches use by default. No limit by default.
+  static CacheBudget* GetGlyphCacheBudget();
+
   CFX_FontCache();
+  // `budget` must outlive this cache and its glyph caches.
+  explicit CFX_FontCache(CacheBudget* budget);
   ~CFX_FontCache();
 
   RetainPtr<CFX_GlyphCache> GetGlyphCache(const CFX_Font* font);
@@ -25,9 +40,32 @@ class CFX_FontCache {
   CFX_TypeFace* GetDeviceCache(const CFX_Font* font);
 #endif
 
+  CacheBudget* budget() const { return budget_; }
+
+  // Evicts the least recently used entries, across all faces, until the
+  // budget is no longer exceeded, or this cache has no evictable entries left. Entries
+  // cached by other threads are left alone. Invalidates pointers previously
+  // returned from CFX_GlyphCache::LoadGlyphBitmap(), so only call it when none
+  // are in use.
+  void TrimGlyphCaches();
+
  private:
+  friend class CFX_GlyphCache;
+
+  // Called by CFX_GlyphCache to order its entries across faces.
+  CFX_GlyphCache::LruList::iterator AddLruNode(
+      CFX_GlyphCache* glyph_cache,
+      CFX_GlyphCache::EntryKey key);
+  void TouchLruNode(CFX_GlyphCache::LruList::iterator it);
+  void RemoveLruNode(CFX_GlyphCache::LruList::iterator it);
+
+  void RemoveDeadGlyphCaches();
+
+  UnownedPtr<CacheBudget> const budget_;
   std::map<CFX_Face*, ObservedPtr<CFX_GlyphCache>> glyph_cache_map_;
   std::map<CFX_Face*, ObservedPtr<CFX_GlyphCache>> ext_glyph_cache_map_;
+  // Least recently used first.
+  CFX_GlyphCache::LruList lru_;
 };
 
 #endif  // CORE_FXGE_CFX_FONTCACHE_H_
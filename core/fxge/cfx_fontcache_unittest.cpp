@@ -0,0 +1,222 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxge/cfx_fontcache.h"
+
+#include <vector>
+
+#include "core/fxcrt/cache_budget.h"
+#include "core/fxcrt/fx_codepage.h"
+#include "core/fxge/cfx_font.h"
+#include "core/fxge/cfx_glyphbitmap.h"
+#include "core/fxge/cfx_glyphcache.h"
+#include "core/fxge/cfx_textrenderoptions.h"
+#include "core/fxge/freetype/fx_freetype.h"
+#include "core/fxge/fx_font.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+class FontCacheTest : public testing::Test {
+ public:
+  void SetUp() override {
+    font_.LoadSubst("Helvetica", /*bTrueType=*/true, /*flags=*/0,
+                    pdfium::kFontWeightNormal, /*italic_angle=*/0,
+                    FX_CodePage::kDefANSI, /*bVertical=*/false);
+    ASSERT_TRUE(font_.GetFace());
+    for (uint32_t ch = 'A'; ch <= 'Z'; ++ch) {
+      int glyph_index = font_.GetFace()->GetCharIndex(ch);
+      if (glyph_index > 0) {
+        glyph_indices_.push_back(glyph_index);
+      }
+    }
+    ASSERT_GE(glyph_indices_.size(), 4u);
+  }
+
+  const CFX_GlyphBitmap* LoadGlyphBitmap(CFX_GlyphCache* glyph_cache,
+                                         uint32_t glyph_index) {
+    CFX_TextRenderOptions options;
+    return glyph_cache->LoadGlyphBitmap(
+        &font_, glyph_index, /*bFontStyle=*/false,
+        CFX_Matrix(24, 0, 0, 24, 0, 0), /*dest_width=*/0,
+        FT_RENDER_MODE_NORMAL, &options);
+  }
+
+  CFX_Font font_;
+  std::vector<uint32_t> glyph_indices_;
+};
+
+}  // namespace
+
+TEST_F(FontCacheTest, GlyphBitmapStats) {
+  CacheBudget budget(CacheBudget::kUnlimited);
+  CFX_FontCache font_cache(&budget);
+  RetainPtr<CFX_GlyphCache> glyph_cache = font_cache.GetGlyphCache(&font_);
+  const CFX_GlyphBitmap* bitmap =
+      LoadGlyphBitmap(glyph_cache.Get(), glyph_indices_[0]);
+  ASSERT_TRUE(bitmap);
+  EXPECT_EQ(0u, budget.GetStats().hits);
+  EXPECT_EQ(1u, budget.GetStats().misses);
+  EXPECT_GT(budget.bytes(), 0u);
+
+  EXPECT_EQ(bitmap, LoadGlyphBitmap(glyph_cache.Get(), glyph_indices_[0]));
+  EXPECT_EQ(1u, budget.GetStats().hits);
+  EXPECT_EQ(1u, budget.GetStats().misses);
+
+  // Releasing the glyph cache releases its bitmaps.
+  glyph_cache.Reset();
+  EXPECT_EQ(0u, budget.bytes());
+  EXPECT_EQ(0u, budget.GetStats().evictions);
+}
+
+TEST_F(FontCacheTest, GlyphBitmapEviction) {
+  CacheBudget budget(CacheBudget::kUnlimited);
+  CFX_FontCache font_cache(&budget);
+  RetainPtr<CFX_GlyphCache> glyph_cache = font_cache.GetGlyphCache(&font_);
+  for (uint32_t glyph_index : glyph_indices_) {
+    LoadGlyphBitmap(glyph_cache.Get(), glyph_index);
+  }
+  const size_t total_bytes = budget.bytes();
+  ASSERT_GT(total_bytes, 0u);
+
+  // Trimming without a limit does nothing.
+  font_cache.TrimGlyphCaches();
+  EXPECT_EQ(total_bytes, budget.bytes());
+  EXPECT_EQ(0u, budget.GetStats().evictions);
+
+  // Use the first glyph again, so it is not the least recently used one.
+  LoadGlyphBitmap(glyph_cache.Get(), glyph_indices_[0]);
+  budget.SetMaxBytes(total_bytes / 2);
+  font_cache.TrimGlyphCaches();
+  EXPECT_LE(budget.bytes(), total_bytes / 2);
+  EXPECT_GT(budget.GetStats().evictions, 0u);
+
+  const uint64_t hits = budget.GetStats().hits;
+  const uint64_t misses = budget.GetStats().misses;
+  LoadGlyphBitmap(glyph_cache.Get(), glyph_indices_[0]);
+  EXPECT_EQ(hits + 1, budget.GetStats().hits);
+  LoadGlyphBitmap(glyph_cache.Get(), glyph_indices_[1]);
+  EXPECT_EQ(misses + 1, budget.GetStats().misses);
+
+  budget.SetMaxBytes(1);
+  font_cache.TrimGlyphCaches();
+  EXPECT_EQ(0u, budget.bytes());
+
+  budget.SetMaxBytes(CacheBudget::kUnlimited);
+  LoadGlyphBitmap(glyph_cache.Get(), glyph_indices_[0]);
+  EXPECT_GT(budget.bytes(), 0u);
+}
+
+// Font caches on different threads share the budget, but each one only
+// evicts its own glyph bitmaps.
+TEST_F(FontCacheTest, SharedBudget) {
+  CacheBudget budget(CacheBudget::kUnlimited);
+  CFX_FontCache font_cache1(&budget);
+  CFX_FontCache font_cache2(&budget);
+  RetainPtr<CFX_GlyphCache> glyph_cache1 = font_cache1.GetGlyphCache(&font_);
+  RetainPtr<CFX_GlyphCache> glyph_cache2 = font_cache2.GetGlyphCache(&font_);
+  LoadGlyphBitmap(glyph_cache1.Get(), glyph_indices_[0]);
+  const size_t bytes1 = budget.bytes();
+  LoadGlyphBitmap(glyph_cache2.Get(), glyph_indices_[0]);
+  EXPECT_EQ(2 * bytes1, budget.bytes());
+  EXPECT_EQ(2u, budget.GetStats().misses);
+
+  budget.SetMaxBytes(bytes1);
+  font_cache2.TrimGlyphCaches();
+  EXPECT_EQ(bytes1, budget.bytes());
+  EXPECT_EQ(1u, budget.GetStats().evictions);
+
+  // The first cache still has its bitmap.
+  LoadGlyphBitmap(glyph_cache1.Get(), glyph_indices_[0]);
+  EXPECT_EQ(1u, budget.GetStats().hits);
+
+  // Nothing is left to evict in the second cache.
+  budget.SetMaxBytes(0);
+  font_cache2.TrimGlyphCaches();
+  EXPECT_EQ(bytes1, budget.bytes());
+  font_cache1.TrimGlyphCaches();
+  EXPECT_EQ(0u, budget.bytes());
+}
+
+TEST_F(FontCacheTest, PathsAndWidths) {
+  CacheBudget budget(CacheBudget::kUnlimited);
+  CFX_FontCache font_cache(&budget);
+  RetainPtr<CFX_GlyphCache> glyph_cache = font_cache.GetGlyphCache(&font_);
+  const CFX_Path* path =
+      glyph_cache->LoadGlyphPath(&font_, glyph_indices_[0], /*dest_width=*/0);
+  ASSERT_TRUE(path);
+  const size_t path_bytes = budget.bytes();
+  EXPECT_GT(path_bytes, 0u);
+  EXPECT_EQ(path, glyph_cache->LoadGlyphPath(&font_, glyph_indices_[0],
+                                             /*dest_width=*/0));
+
+  const int width = glyph_cache->GetGlyphWidth(&font_, glyph_indices_[0],
+                                               /*dest_width=*/0, /*weight=*/0);
+  EXPECT_GT(budget.bytes(), path_bytes);
+  EXPECT_EQ(width, glyph_cache->GetGlyphWidth(&font_, glyph_indices_[0],
+                                              /*dest_width=*/0, /*weight=*/0));
+  EXPECT_EQ(2u, budget.GetStats().hits);
+  EXPECT_EQ(2u, budget.GetStats().misses);
+
+  // The path is the least recently used entry, but paths are never evicted.
+  budget.SetMaxBytes(1);
+  font_cache.TrimGlyphCaches();
+  EXPECT_EQ(1u, budget.GetStats().evictions);
+  EXPECT_EQ(path_bytes, budget.bytes());
+  EXPECT_EQ(path, glyph_cache->LoadGlyphPath(&font_, glyph_indices_[0],
+                                             /*dest_width=*/0));
+  EXPECT_EQ(3u, budget.GetStats().hits);
+  EXPECT_EQ(width, glyph_cache->GetGlyphWidth(&font_, glyph_indices_[0],
+                                              /*dest_width=*/0, /*weight=*/0));
+  EXPECT_EQ(3u, budget.GetStats().misses);
+
+  glyph_cache.Reset();
+  EXPECT_EQ(0u, budget.bytes());
+}
+
+// Eviction follows the order of use across faces.
+TEST_F(FontCacheTest, EvictionOrderAcrossFaces) {
+  CFX_Font other_font;
+  other_font.LoadSubst("Courier", /*bTrueType=*/true, /*flags=*/0,
+                       pdfium::kFontWeightNormal, /*italic_angle=*/0,
+                       FX_CodePage::kDefANSI, /*bVertical=*/false);
+  ASSERT_TRUE(other_font.GetFace());
+  ASSERT_NE(font_.GetFace(), other_font.GetFace());
+
+  CacheBudget budget(CacheBudget::kUnlimited);
+  CFX_FontCache font_cache(&budget);
+  RetainPtr<CFX_GlyphCache> glyph_cache1 = font_cache.GetGlyphCache(&font_);
+  RetainPtr<CFX_GlyphCache> glyph_cache2 =
+      font_cache.GetGlyphCache(&other_font);
+  ASSERT_NE(glyph_cache1, glyph_cache2);
+
+  CFX_TextRenderOptions options;
+  auto load_other = [&]() {
+    return glyph_cache2->LoadGlyphBitmap(
+        &other_font, glyph_indices_[0], /*bFontStyle=*/false,
+        CFX_Matrix(24, 0, 0, 24, 0, 0), /*dest_width=*/0,
+        FT_RENDER_MODE_NORMAL, &options);
+  };
+  ASSERT_TRUE(LoadGlyphBitmap(glyph_cache1.Get(), glyph_indices_[0]));
+  ASSERT_TRUE(load_other());
+  ASSERT_TRUE(LoadGlyphBitmap(glyph_cache1.Get(), glyph_indices_[1]));
+  // Use the first glyph again, so that the other face has the least recently
+  // used one.
+  ASSERT_TRUE(LoadGlyphBitmap(glyph_cache1.Get(), glyph_indices_[0]));
+  EXPECT_EQ(1u, budget.GetStats().hits);
+
+  budget.SetMaxBytes(budget.bytes() - 1);
+  font_cache.TrimGlyphCaches();
+  EXPECT_EQ(1u, budget.GetStats().evictions);
+
+  // Both glyphs of the first face are still cached.
+  LoadGlyphBitmap(glyph_cache1.Get(), glyph_indices_[0]);
+  LoadGlyphBitmap(glyph_cache1.Get(), glyph_indices_[1]);
+  EXPECT_EQ(3u, budget.GetStats().hits);
+
+  budget.SetMaxBytes(CacheBudget::kUnlimited);
+  load_other();
+  EXPECT_EQ(3u, budget.GetStats().hits);
+  EXPECT_EQ(4u, budget.GetStats().misses);
+}
@@ -13,7 +13,8 @@
 
 namespace {
 
-CFX_GEModule* g_pGEModule = nullptr;
+// Each thread that uses PDFium has its own instance.
+thread_local CFX_GEModule* g_pGEModule = nullptr;
 
 }  // namespace
 
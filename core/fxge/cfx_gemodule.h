@@ -37,6 +37,8 @@ class CFX_GEModule {
 #endif
   };
 
+  // Per-thread singleton which must be managed by callers. `pUserFontPaths`
+  // must outlive the instance.
   static void Create(const char** pUserFontPaths);
   static void Destroy();
   static CFX_GEModule* Get();
@@ -8,17 +8,24 @@
 
 #include <initializer_list>
 #include <memory>
+#include <type_traits>
 #include <utility>
+#include <variant>
 
 #include "build/build_config.h"
+#include "core/fxcrt/cache_budget.h"
+#include "core/fxcrt/check_op.h"
 #include "core/fxcrt/fx_codepage.h"
 #include "core/fxcrt/fx_memcpy_wrappers.h"
 #include "core/fxcrt/span.h"
+#include "core/fxcrt/stl_util.h"
 #include "core/fxge/cfx_defaultrenderdevice.h"
 #include "core/fxge/cfx_font.h"
+#include "core/fxge/cfx_fontcache.h"
 #include "core/fxge/cfx_glyphbitmap.h"
 #include "core/fxge/cfx_path.h"
 #include "core/fxge/cfx_substfont.h"
+#include "core/fxge/dib/cfx_dibitmap.h"
 
 #if defined(PDF_USE_SKIA)
 #include "third_party/skia/include/core/SkFontMgr.h"         // nogncheck
@@ -50,7 +57,7 @@ class UniqueKeyGen {
                int anti_alias,
                bool bNative);
 
-  pdfium::span<const uint8_t> span() const;
+  pdfium::span<const uint32_t> span() const;
 
  private:
   void Initialize(std::initializer_list<const int> args);
@@ -68,8 +75,8 @@ void UniqueKeyGen::Initialize(std::initializer_list<const int32_t> args) {
   key_len_ = args.size();
 }
 
-pdfium::span<const uint8_t> UniqueKeyGen::span() const {
-  return pdfium::as_bytes(pdfium::span(key_).first(key_len_));
+pdfium::span<const uint32_t> UniqueKeyGen::span() const {
+  return pdfium::span(key_).first(key_len_);
 }
 
 UniqueKeyGen::UniqueKeyGen(const CFX_Font* font,
@@ -107,12 +114,48 @@ UniqueKeyGen::UniqueKeyGen(const CFX_Font* font,
   }
 }
 
+size_t GetGlyphBitmapSize(const CFX_GlyphBitmap* bitmap) {
+  if (!bitmap) {
+    return 0;
+  }
+  return sizeof(CFX_GlyphBitmap) + bitmap->GetBitmap()->GetBuffer().size();
+}
+
+size_t GetPathSize(const CFX_Path* path) {
+  if (!path) {
+    return 0;
+  }
+  return sizeof(CFX_Path) +
+         path->GetPoints().capacity() * sizeof(CFX_Path::Point);
+}
+
 }  // namespace
 
-CFX_GlyphCache::CFX_GlyphCache(RetainPtr<CFX_Face> face)
-    : face_(std::move(face)) {}
+CFX_GlyphCache::GlyphBitmapKey::GlyphBitmapKey(
+    pdfium::span<const uint32_t> size_params,
+    uint32_t glyph_index)
+    : param_count(size_params.size()), glyph_index(glyph_index) {
+  CHECK_LE(size_params.size(), kMaxParams);
+  fxcrt::Copy(size_params, params);
+}
 
-CFX_GlyphCache::~CFX_GlyphCache() = default;
+CFX_GlyphCache::CFX_GlyphCache(RetainPtr<CFX_Face> face,
+                               CFX_FontCache* font_cache)
+    : face_(std::move(face)),
+      font_cache_(font_cache),
+      budget_(font_cache->budget()) {}
+
+CFX_GlyphCache::~CFX_GlyphCache() {
+  if (font_cache_) {
+    for (const auto& [key, entry] : bitmap_map_) {
+      font_cache_->RemoveLruNode(entry.lru_it);
+    }
+    for (const auto& [key, entry] : width_map_) {
+      font_cache_->RemoveLruNode(entry.lru_it);
+    }
+  }
+  budget_->Remove(bytes_);
+}
 
 std::unique_ptr<CFX_GlyphBitmap> CFX_GlyphCache::RenderGlyph(
     const CFX_Font* font,
@@ -142,13 +185,15 @@ const CFX_Path* CFX_GlyphCache::LoadGlyphPath(const CFX_Font* font,
   bool vertical = pSubstFont && font->IsVertical();
   const PathMapKey key =
       std::make_tuple(glyph_index, dest_width, weight, angle, vertical);
-  auto it = path_map_.find(key);
-  if (it != path_map_.end()) {
-    return it->second.get();
+  PathEntry* entry = FindEntry(path_map_, key);
+  if (entry) {
+    return entry->value.get();
   }
 
-  path_map_[key] = font->LoadGlyphPathImpl(glyph_index, dest_width);
-  return path_map_[key].get();
+  std::unique_ptr<CFX_Path> path =
+      font->LoadGlyphPathImpl(glyph_index, dest_width);
+  const size_t bytes = GetPathSize(path.get());
+  return AddEntry(path_map_, key, std::move(path), bytes)->value.get();
 }
 
 const CFX_GlyphBitmap* CFX_GlyphCache::LoadGlyphBitmap(
@@ -169,7 +214,6 @@ const CFX_GlyphBitmap* CFX_GlyphCache::LoadGlyphBitmap(
   const bool bNative = false;
 #endif
   UniqueKeyGen keygen(font, matrix, dest_width, anti_alias, bNative);
-  auto FaceGlyphsKey = ByteString(ByteStringView(keygen.span()));
 
 #if BUILDFLAG(IS_APPLE)
   const bool bDoLookUp =
@@ -178,47 +222,31 @@ const CFX_GlyphBitmap* CFX_GlyphCache::LoadGlyphBitmap(
   const bool bDoLookUp = true;
 #endif
   if (bDoLookUp) {
-    return LookUpGlyphBitmap(font, matrix, FaceGlyphsKey, glyph_index,
+    return LookUpGlyphBitmap(font, matrix, keygen.span(), glyph_index,
                              bFontStyle, dest_width, anti_alias);
   }
 
 #if BUILDFLAG(IS_APPLE)
   DCHECK(!CFX_DefaultRenderDevice::UseSkiaRenderer());
 
-  std::unique_ptr<CFX_GlyphBitmap> pGlyphBitmap;
-  auto it = size_map_.find(FaceGlyphsKey);
-  if (it != size_map_.end()) {
-    SizeGlyphCache* pSizeCache = &(it->second);
-    auto it2 = pSizeCache->find(glyph_index);
-    if (it2 != pSizeCache->end()) {
-      return it2->second.get();
-    }
-
-    pGlyphBitmap = RenderGlyph_Nativetext(font, glyph_index, matrix, dest_width,
-                                          anti_alias);
-    if (pGlyphBitmap) {
-      CFX_GlyphBitmap* pResult = pGlyphBitmap.get();
-      (*pSizeCache)[glyph_index] = std::move(pGlyphBitmap);
-      return pResult;
-    }
-  } else {
-    pGlyphBitmap = RenderGlyph_Nativetext(font, glyph_index, matrix, dest_width,
-                                          anti_alias);
-    if (pGlyphBitmap) {
-      CFX_GlyphBitmap* pResult = pGlyphBitmap.get();
-
-      SizeGlyphCache cache;
-      cache[glyph_index] = std::move(pGlyphBitmap);
+  const GlyphBitmapKey key(keygen.span(), glyph_index);
+  GlyphBitmapEntry* entry = FindEntry(bitmap_map_, key);
+  if (entry) {
+    return entry->value.get();
+  }
 
-      size_map_[FaceGlyphsKey] = std::move(cache);
-      return pResult;
-    }
+  std::unique_ptr<CFX_GlyphBitmap> pGlyphBitmap = RenderGlyph_Nativetext(
+      font, glyph_index, matrix, dest_width, anti_alias);
+  if (pGlyphBitmap) {
+    const size_t bytes = GetGlyphBitmapSize(pGlyphBitmap.get());
+    return AddEntry(bitmap_map_, key, std::move(pGlyphBitmap), bytes)
+        ->value.get();
   }
+
   UniqueKeyGen keygen2(font, matrix, dest_width, anti_alias,
                        /*bNative=*/false);
-  auto FaceGlyphsKey2 = ByteString(ByteStringView(keygen2.span()));
   text_options->native_text = false;
-  return LookUpGlyphBitmap(font, matrix, FaceGlyphsKey2, glyph_index,
+  return LookUpGlyphBitmap(font, matrix, keygen2.span(), glyph_index,
                            bFontStyle, dest_width, anti_alias);
 #endif  // BUILDFLAG(IS_APPLE)
 }
@@ -228,13 +256,15 @@ int CFX_GlyphCache::GetGlyphWidth(const CFX_Font* font,
                                   int dest_width,
                                   int weight) {
   const WidthMapKey key = std::make_tuple(glyph_index, dest_width, weight);
-  auto it = width_map_.find(key);
-  if (it != width_map_.end()) {
-    return it->second;
+  WidthEntry* entry = FindEntry(width_map_, key);
+  if (entry) {
+    return entry->value;
   }
 
-  width_map_[key] = font->GetGlyphWidthImpl(glyph_index, dest_width, weight);
-  return width_map_[key];
+  return AddEntry(width_map_, key,
+                  font->GetGlyphWidthImpl(glyph_index, dest_width, weight),
+                  /*bytes=*/0)
+      ->value;
 }
 
 #if defined(PDF_USE_SKIA)
@@ -302,28 +332,82 @@ CFX_TypeFace* CFX_GlyphCache::GetDeviceCache(const CFX_Font* font) {
 CFX_GlyphBitmap* CFX_GlyphCache::LookUpGlyphBitmap(
     const CFX_Font* font,
     const CFX_Matrix& matrix,
-    const ByteString& FaceGlyphsKey,
+    pdfium::span<const uint32_t> size_params,
     uint32_t glyph_index,
     bool bFontStyle,
     int dest_width,
     int anti_alias) {
-  SizeGlyphCache* pSizeCache;
-  auto it = size_map_.find(FaceGlyphsKey);
-  if (it == size_map_.end()) {
-    size_map_[FaceGlyphsKey] = SizeGlyphCache();
-    pSizeCache = &(size_map_[FaceGlyphsKey]);
-  } else {
-    pSizeCache = &(it->second);
+  const GlyphBitmapKey key(size_params, glyph_index);
+  GlyphBitmapEntry* entry = FindEntry(bitmap_map_, key);
+  if (entry) {
+    return entry->value.get();
   }
 
-  auto it2 = pSizeCache->find(glyph_index);
-  if (it2 != pSizeCache->end()) {
-    return it2->second.get();
+  std::unique_ptr<CFX_GlyphBitmap> bitmap = RenderGlyph(
+      font, glyph_index, bFontStyle, matrix, dest_width, anti_alias);
+  const size_t bytes = GetGlyphBitmapSize(bitmap.get());
+  return AddEntry(bitmap_map_, key, std::move(bitmap), bytes)->value.get();
+}
+
+template <typename Map>
+typename Map::mapped_type* CFX_GlyphCache::FindEntry(
+    Map& map,
+    const typename Map::key_type& key) {
+  auto it = map.find(key);
+  if (it == map.end()) {
+    return nullptr;
   }
 
-  std::unique_ptr<CFX_GlyphBitmap> pGlyphBitmap = RenderGlyph(
-      font, glyph_index, bFontStyle, matrix, dest_width, anti_alias);
-  CFX_GlyphBitmap* pResult = pGlyphBitmap.get();
-  (*pSizeCache)[glyph_index] = std::move(pGlyphBitmap);
-  return pResult;
+  budget_->RecordHit();
+  if constexpr (Map::mapped_type::kEvictable) {
+    if (font_cache_) {
+      font_cache_->TouchLruNode(it->second.lru_it);
+    }
+  }
+  return &it->second;
+}
+
+template <typename Map>
+typename Map::mapped_type* CFX_GlyphCache::AddEntry(
+    Map& map,
+    const typename Map::key_type& key,
+    typename Map::mapped_type::value_type value,
+    size_t bytes) {
+  // Count the bookkeeping too, so that entries without data are bounded.
+  bytes += sizeof(typename Map::value_type) + sizeof(LruNode);
+  budget_->RecordMiss();
+  budget_->Add(bytes);
+  bytes_ += bytes;
+  LruList::iterator lru_it;
+  if constexpr (Map::mapped_type::kEvictable) {
+    if (font_cache_) {
+      lru_it = font_cache_->AddLruNode(this, key);
+    }
+  }
+  auto [it, inserted] =
+      map.emplace(key, typename Map::mapped_type{std::move(value), bytes,
+                                                 lru_it});
+  CHECK(inserted);
+  return &it->second;
+}
+
+void CFX_GlyphCache::EvictEntry(const EntryKey& key) {
+  auto evict = [this](auto& map, const auto& map_key) {
+    auto it = map.find(map_key);
+    CHECK(it != map.end());
+    const size_t bytes = it->second.bytes;
+    map.erase(it);
+    bytes_ -= bytes;
+    budget_->Evict(bytes);
+  };
+  std::visit(
+      [this, &evict](const auto& map_key) {
+        using KeyType = std::decay_t<decltype(map_key)>;
+        if constexpr (std::is_same_v<KeyType, GlyphBitmapKey>) {
+          evict(bitmap_map_, map_key);
+        } else {
+          evict(width_map_, map_key);
+        }
+      },
+      key);
 }
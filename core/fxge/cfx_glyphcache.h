@@ -7,21 +7,36 @@
 #ifndef CORE_FXGE_CFX_GLYPHCACHE_H_
 #define CORE_FXGE_CFX_GLYPHCACHE_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <list>
 #include <map>
 #include <memory>
 #include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
 
-#include "core/fxcrt/bytestring.h"
 #include "core/fxcrt/observed_ptr.h"
 #include "core/fxcrt/retain_ptr.h"
+#include "core/fxcrt/span.h"
+#include "core/fxcrt/unowned_ptr.h"
 #include "core/fxge/cfx_face.h"
+#include "third_party/abseil-cpp/absl/container/flat_hash_map.h"
 
 #if defined(PDF_USE_SKIA)
 #include "core/fxge/fx_font.h"
 #include "third_party/skia/include/core/SkRefCnt.h"  // nogncheck
 #endif
 
+namespace fxcrt {
+class CacheBudget;
+}  // namespace fxcrt
+
 class CFX_Font;
+class CFX_FontCache;
 class CFX_GlyphBitmap;
 class CFX_Matrix;
 class CFX_Path;
@@ -55,15 +70,71 @@ class CFX_GlyphCache final : public Retainable, public Observable {
 #endif
 
  private:
-  explicit CFX_GlyphCache(RetainPtr<CFX_Face> face);
-  ~CFX_GlyphCache() override;
+  friend class CFX_FontCache;
+
+  // Identifies a glyph rendered with a given transform, size and style. It
+  // has a fixed size, so that lookups do not allocate.
+  struct GlyphBitmapKey {
+    static constexpr size_t kMaxParams = 10;
+
+    GlyphBitmapKey(pdfium::span<const uint32_t> size_params,
+                   uint32_t glyph_index);
+
+    bool operator==(const GlyphBitmapKey& that) const = default;
+
+    template <typename H>
+    friend H AbslHashValue(H h, const GlyphBitmapKey& key) {
+      return H::combine(std::move(h), key.params, key.param_count,
+                        key.glyph_index);
+    }
+
+    std::array<uint32_t, kMaxParams> params = {};
+    size_t param_count;
+    uint32_t glyph_index;
+  };
 
-  using SizeGlyphCache = std::map<uint32_t, std::unique_ptr<CFX_GlyphBitmap>>;
   // <glyph_index, width, weight, angle, vertical>
   using PathMapKey = std::tuple<uint32_t, int, int, int, bool>;
   // <glyph_index, dest_width, weight>
   using WidthMapKey = std::tuple<uint32_t, int, int>;
 
+  // Identifies an evictable cached glyph bitmap or width.
+  using EntryKey = std::variant<GlyphBitmapKey, WidthMapKey>;
+
+  // A node in CFX_FontCache's least recently used first list, which orders
+  // the evictable entries of all the glyph caches it created.
+  struct LruNode {
+    UnownedPtr<CFX_GlyphCache> glyph_cache;
+    EntryKey key;
+  };
+  using LruList = std::list<LruNode>;
+
+  template <typename T>
+  struct Entry {
+    using value_type = T;
+
+    // Glyph paths get handed out to embedders by FPDFFont_GetGlyphPath(),
+    // which cannot tell when they are done with them. So paths count against
+    // the budget, but stay out of the LRU list and live as long as their
+    // glyph cache.
+    static constexpr bool kEvictable =
+        !std::is_same_v<T, std::unique_ptr<CFX_Path>>;
+
+    // For glyph bitmaps and paths, may be null, to remember glyphs that
+    // failed to load.
+    T value;
+    size_t bytes;
+    // Only valid while `font_cache_` is, and only for evictable entries.
+    LruList::iterator lru_it;
+  };
+
+  using GlyphBitmapEntry = Entry<std::unique_ptr<CFX_GlyphBitmap>>;
+  using PathEntry = Entry<std::unique_ptr<CFX_Path>>;
+  using WidthEntry = Entry<int>;
+
+  CFX_GlyphCache(RetainPtr<CFX_Face> face, CFX_FontCache* font_cache);
+  ~CFX_GlyphCache() override;
+
   std::unique_ptr<CFX_GlyphBitmap> RenderGlyph(const CFX_Font* font,
                                                uint32_t glyph_index,
                                                bool bFontStyle,
@@ -78,15 +149,37 @@ class CFX_GlyphCache final : public Retainable, public Observable {
       int anti_alias);
   CFX_GlyphBitmap* LookUpGlyphBitmap(const CFX_Font* font,
                                      const CFX_Matrix& matrix,
-                                     const ByteString& FaceGlyphsKey,
+                                     pdfium::span<const uint32_t> size_params,
                                      uint32_t glyph_index,
                                      bool bFontStyle,
                                      int dest_width,
                                      int anti_alias);
+
+  // Returns the cached entry for `key` in `map` and marks it as most recently
+  // used, or returns nullptr if there is none.
+  template <typename Map>
+  typename Map::mapped_type* FindEntry(Map& map,
+                                       const typename Map::key_type& key);
+  template <typename Map>
+  typename Map::mapped_type* AddEntry(
+      Map& map,
+      const typename Map::key_type& key,
+      typename Map::mapped_type::value_type value,
+      size_t bytes);
+
+  // For CFX_FontCache to evict entries across faces. Leaves the LRU node
+  // for the caller to remove.
+  void EvictEntry(const EntryKey& key);
+
   RetainPtr<CFX_Face> const face_;
-  std::map<ByteString, SizeGlyphCache> size_map_;
-  std::map<PathMapKey, std::unique_ptr<CFX_Path>> path_map_;
-  std::map<WidthMapKey, int> width_map_;
+  ObservedPtr<CFX_FontCache> const font_cache_;
+  // Outlives `font_cache_`.
+  UnownedPtr<fxcrt::CacheBudget> const budget_;
+  absl::flat_hash_map<GlyphBitmapKey, GlyphBitmapEntry> bitmap_map_;
+  std::map<PathMapKey, PathEntry> path_map_;
+  std::map<WidthMapKey, WidthEntry> width_map_;
+  // Bytes used by all the entries above.
+  size_t bytes_ = 0;
 #if defined(PDF_USE_SKIA)
   sk_sp<SkTypeface> typeface_;
 #endif
@@ -0,0 +1,383 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxge/cfx_glyphrunblitter.h"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+#include "core/fxcrt/check.h"
+#include "core/fxcrt/check_op.h"
+#include "core/fxcrt/compiler_specific.h"
+#include "core/fxcrt/fx_safe_types.h"
+#include "core/fxcrt/notreached.h"
+#include "core/fxcrt/span.h"
+#include "core/fxge/dib/cfx_dibitmap.h"
+#include "core/fxge/dib/composite_simd.h"
+
+namespace {
+
+constexpr std::array<const uint8_t, 256> kTextGammaAdjust = {{
+    0,   2,   3,   4,   6,   7,   8,   10,  11,  12,  13,  15,  16,  17,  18,
+    19,  21,  22,  23,  24,  25,  26,  27,  29,  30,  31,  32,  33,  34,  35,
+    36,  38,  39,  40,  41,  42,  43,  44,  45,  46,  47,  48,  49,  51,  52,
+    53,  54,  55,  56,  57,  58,  59,  60,  61,  62,  63,  64,  65,  66,  67,
+    68,  69,  71,  72,  73,  74,  75,  76,  77,  78,  79,  80,  81,  82,  83,
+    84,  85,  86,  87,  88,  89,  90,  91,  92,  93,  94,  95,  96,  97,  98,
+    99,  100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110, 111, 112, 113,
+    114, 115, 116, 117, 118, 119, 120, 121, 122, 123, 124, 125, 126, 127, 128,
+    129, 129, 130, 131, 132, 133, 134, 135, 136, 137, 138, 139, 140, 141, 142,
+    143, 144, 145, 146, 147, 148, 149, 150, 151, 152, 153, 154, 155, 156, 156,
+    157, 158, 159, 160, 161, 162, 163, 164, 165, 166, 167, 168, 169, 170, 171,
+    172, 173, 174, 174, 175, 176, 177, 178, 179, 180, 181, 182, 183, 184, 185,
+    186, 187, 188, 189, 190, 190, 191, 192, 193, 194, 195, 196, 197, 198, 199,
+    200, 201, 202, 203, 204, 204, 205, 206, 207, 208, 209, 210, 211, 212, 213,
+    214, 215, 216, 217, 217, 218, 219, 220, 221, 222, 223, 224, 225, 226, 227,
+    228, 228, 229, 230, 231, 232, 233, 234, 235, 236, 237, 238, 239, 239, 240,
+    241, 242, 243, 244, 245, 246, 247, 248, 249, 250, 250, 251, 252, 253, 254,
+    255,
+}};
+
+int CalcAlpha(int src, int alpha) {
+  return src * alpha / 255;
+}
+
+// Blends `color` onto the color channels of `dest` with `alpha`.
+void ApplyAlpha(uint8_t* dest,
+                const FX_BGRA_STRUCT<uint8_t>& color,
+                int alpha) {
+  UNSAFE_TODO({
+    dest[0] = FXDIB_ALPHA_MERGE(dest[0], color.blue, alpha);
+    dest[1] = FXDIB_ALPHA_MERGE(dest[1], color.green, alpha);
+    dest[2] = FXDIB_ALPHA_MERGE(dest[2], color.red, alpha);
+  });
+}
+
+// Composites `color` with `src_alpha` onto a straight alpha pixel. A
+// transparent pixel takes the color as is, even when `src_alpha` is 0.
+void CompositeArgb(uint8_t* dest,
+                   const FX_BGRA_STRUCT<uint8_t>& color,
+                   int src_alpha) {
+  UNSAFE_TODO({
+    const uint8_t back_alpha = dest[3];
+    if (back_alpha == 0) {
+      dest[0] = color.blue;
+      dest[1] = color.green;
+      dest[2] = color.red;
+      dest[3] = static_cast<uint8_t>(src_alpha);
+      return;
+    }
+    if (src_alpha == 0) {
+      return;
+    }
+    const uint8_t dest_alpha =
+        back_alpha + src_alpha - back_alpha * src_alpha / 255;
+    ApplyAlpha(dest, color, src_alpha * 255 / dest_alpha);
+    dest[3] = dest_alpha;
+  });
+}
+
+// Composites one pixel with the gamma adjusted average `coverage` of its
+// channels.
+template <bool kHasAlpha>
+void CompositeNormalized(uint8_t* dest,
+                         const FX_BGRA_STRUCT<uint8_t>& color,
+                         int coverage) {
+  const int src_alpha = CalcAlpha(coverage, color.alpha);
+  if constexpr (kHasAlpha) {
+    CompositeArgb(dest, color, src_alpha);
+  } else if (src_alpha != 0) {
+    ApplyAlpha(dest, color, src_alpha);
+  }
+}
+
+}  // namespace
+
+CFX_GlyphRunBlitter::CFX_GlyphRunBlitter(RetainPtr<CFX_DIBitmap> bitmap,
+                                         Mode mode,
+                                         uint32_t color)
+    : bitmap_(std::move(bitmap)),
+      mode_(mode),
+      color_(color),
+      bgra_(ArgbToBGRAStruct(color)) {
+  // TODO(crbug.com/42271020): Add support for `FXDIB_Format::kBgraPremul`.
+  CHECK(!bitmap_->IsPremultiplied());
+  if (mode_ == Mode::kGray) {
+    CHECK(byte_mask_compositor_.Init(bitmap_->GetFormat(),
+                                     FXDIB_Format::k8bppMask, {}, color_,
+                                     BlendMode::kNormal, false));
+    CHECK(bit_mask_compositor_.Init(bitmap_->GetFormat(),
+                                    FXDIB_Format::k1bppMask, {}, color_,
+                                    BlendMode::kNormal, false));
+    return;
+  }
+  const FXDIB_Format format = bitmap_->GetFormat();
+  CHECK(format == FXDIB_Format::kBgr || format == FXDIB_Format::kBgrx ||
+        format == FXDIB_Format::kBgra);
+  if (mode_ == Mode::kLcdNormalized) {
+    coverage_.resize(bitmap_->GetWidth());
+  }
+}
+
+CFX_GlyphRunBlitter::~CFX_GlyphRunBlitter() = default;
+
+void CFX_GlyphRunBlitter::AddGlyph(RetainPtr<const CFX_DIBitmap> glyph,
+                                   const CFX_Point& origin,
+                                   int x_subpixel) {
+  if (mode_ == Mode::kGray) {
+    CHECK(glyph->IsMaskFormat());
+    if (FXARGB_A(color_) == 0) {
+      return;
+    }
+    int dest_left = origin.x;
+    int dest_top = origin.y;
+    int width = glyph->GetWidth();
+    int height = glyph->GetHeight();
+    int src_left = 0;
+    int src_top = 0;
+    if (!bitmap_->GetOverlapRect(dest_left, dest_top, width, height,
+                                 glyph->GetWidth(), glyph->GetHeight(),
+                                 src_left, src_top, nullptr)) {
+      return;
+    }
+    glyphs_.push_back({.bitmap = std::move(glyph),
+                       .left = dest_left - src_left,
+                       .top = dest_top - src_top,
+                       .dest_rect = FX_RECT(dest_left, dest_top,
+                                            dest_left + width,
+                                            dest_top + height),
+                       .x_subpixel = 0});
+    return;
+  }
+
+  if (x_subpixel != 0 && x_subpixel != 1) {
+    x_subpixel = 2;
+  }
+  FX_SAFE_INT32 safe_right = origin.x;
+  safe_right += glyph->GetWidth() / 3;
+  FX_SAFE_INT32 safe_bottom = origin.y;
+  safe_bottom += glyph->GetHeight();
+  if (!safe_right.IsValid()) {
+    return;
+  }
+  const int right = safe_right.ValueOrDie();
+  const int bottom = safe_bottom.ValueOrDefault(bitmap_->GetHeight());
+  FX_RECT dest_rect(std::max(origin.x, 0), std::max(origin.y, 0),
+                    std::min(right, bitmap_->GetWidth()),
+                    std::min(bottom, bitmap_->GetHeight()));
+  if (dest_rect.left >= dest_rect.right || dest_rect.top >= dest_rect.bottom) {
+    return;
+  }
+  glyphs_.push_back({.bitmap = std::move(glyph),
+                     .left = origin.x,
+                     .top = origin.y,
+                     .dest_rect = dest_rect,
+                     .x_subpixel = x_subpixel});
+}
+
+void CFX_GlyphRunBlitter::Blit() {
+  if (glyphs_.empty()) {
+    return;
+  }
+
+  // Sorts the glyphs into bands, keeping them in order within each band.
+  const int band_count =
+      (bitmap_->GetHeight() + kBandHeight - 1) / kBandHeight;
+  std::vector<std::vector<uint32_t>> bands(band_count);
+  for (size_t i = 0; i < glyphs_.size(); ++i) {
+    const FX_RECT& rect = glyphs_[i].dest_rect;
+    const int first_band = rect.top / kBandHeight;
+    const int last_band = (rect.bottom - 1) / kBandHeight;
+    for (int band = first_band; band <= last_band; ++band) {
+      bands[band].push_back(static_cast<uint32_t>(i));
+    }
+  }
+
+  for (int band = 0; band < band_count; ++band) {
+    const int band_top = band * kBandHeight;
+    const int band_bottom = band_top + kBandHeight;
+    for (uint32_t index : bands[band]) {
+      const Glyph& glyph = glyphs_[index];
+      BlitRows(glyph, std::max(glyph.dest_rect.top, band_top),
+               std::min(glyph.dest_rect.bottom, band_bottom));
+    }
+  }
+  glyphs_.clear();
+}
+
+void CFX_GlyphRunBlitter::BlitRows(const Glyph& glyph, int top, int bottom) {
+  const FXDIB_Format format = bitmap_->GetFormat();
+  switch (mode_) {
+    case Mode::kGray:
+      BlitGrayRows(glyph, top, bottom);
+      return;
+    case Mode::kLcd:
+      if (format == FXDIB_Format::kBgra) {
+        BlitLcdRows<4, true>(glyph, top, bottom);
+      } else if (format == FXDIB_Format::kBgrx) {
+        BlitLcdRows<4, false>(glyph, top, bottom);
+      } else {
+        BlitLcdRows<3, false>(glyph, top, bottom);
+      }
+      return;
+    case Mode::kLcdNormalized:
+      if (format == FXDIB_Format::kBgra) {
+        BlitLcdNormalizedRows<4, true>(glyph, top, bottom);
+      } else if (format == FXDIB_Format::kBgrx) {
+        BlitLcdNormalizedRows<4, false>(glyph, top, bottom);
+      } else {
+        BlitLcdNormalizedRows<3, false>(glyph, top, bottom);
+      }
+      return;
+  }
+  NOTREACHED();
+}
+
+void CFX_GlyphRunBlitter::BlitGrayRows(const Glyph& glyph,
+                                       int top,
+                                       int bottom) {
+  const int bytes_per_pixel = bitmap_->GetBPP() / 8;
+  const int width = glyph.dest_rect.Width();
+  const int src_left = glyph.dest_rect.left - glyph.left;
+  const bool is_bit_mask = glyph.bitmap->GetBPP() == 1;
+  for (int row = top; row < bottom; ++row) {
+    pdfium::span<uint8_t> dest_scan =
+        bitmap_->GetWritableScanline(row).subspan(
+            static_cast<size_t>(glyph.dest_rect.left * bytes_per_pixel));
+    pdfium::span<const uint8_t> src_scan =
+        glyph.bitmap->GetScanline(row - glyph.top);
+    if (is_bit_mask) {
+      bit_mask_compositor_.CompositeBitMaskLine(dest_scan, src_scan, src_left,
+                                                width, {});
+    } else {
+      byte_mask_compositor_.CompositeByteMaskLine(
+          dest_scan, src_scan.subspan(static_cast<size_t>(src_left)), width,
+          {});
+    }
+  }
+}
+
+template <int kBytesPerPixel, bool kHasAlpha>
+void CFX_GlyphRunBlitter::BlitLcdRows(const Glyph& glyph, int top, int bottom) {
+  // Column `col` takes the red, green and blue coverage from bytes `offset`
+  // to `offset + 2` of the glyph row, where `offset` is
+  // `(col - glyph.left) * 3 - glyph.x_subpixel`. The first column of the glyph
+  // may miss some of them.
+  const int start_col = glyph.dest_rect.left;
+  const int end_col = glyph.dest_rect.right;
+  for (int row = top; row < bottom; ++row) {
+    const uint8_t* src_scan =
+        glyph.bitmap->GetScanline(row - glyph.top)
+            .subspan(static_cast<size_t>((start_col - glyph.left) * 3))
+            .data();
+    uint8_t* dest_scan =
+        bitmap_->GetWritableScanline(row)
+            .subspan(static_cast<size_t>(start_col * kBytesPerPixel))
+            .data();
+    UNSAFE_TODO({
+      src_scan -= glyph.x_subpixel;
+      int col = start_col;
+      if (glyph.x_subpixel != 0 && start_col == glyph.left) {
+        if (glyph.x_subpixel == 1) {
+          dest_scan[1] = FXDIB_ALPHA_MERGE(
+              dest_scan[1], bgra_.green,
+              CalcAlpha(kTextGammaAdjust[src_scan[1]], bgra_.alpha));
+        }
+        dest_scan[0] = FXDIB_ALPHA_MERGE(
+            dest_scan[0], bgra_.blue,
+            CalcAlpha(kTextGammaAdjust[src_scan[2]], bgra_.alpha));
+        if constexpr (kHasAlpha) {
+          dest_scan[3] = 255;
+        }
+        src_scan += 3;
+        dest_scan += kBytesPerPixel;
+        ++col;
+      }
+      for (; col < end_col; ++col) {
+        dest_scan[0] = FXDIB_ALPHA_MERGE(
+            dest_scan[0], bgra_.blue,
+            CalcAlpha(kTextGammaAdjust[src_scan[2]], bgra_.alpha));
+        dest_scan[1] = FXDIB_ALPHA_MERGE(
+            dest_scan[1], bgra_.green,
+            CalcAlpha(kTextGammaAdjust[src_scan[1]], bgra_.alpha));
+        dest_scan[2] = FXDIB_ALPHA_MERGE(
+            dest_scan[2], bgra_.red,
+            CalcAlpha(kTextGammaAdjust[src_scan[0]], bgra_.alpha));
+        if constexpr (kHasAlpha) {
+          dest_scan[3] = 255;
+        }
+        src_scan += 3;
+        dest_scan += kBytesPerPixel;
+      }
+    });
+  }
+}
+
+template <int kBytesPerPixel, bool kHasAlpha>
+void CFX_GlyphRunBlitter::BlitLcdNormalizedRows(const Glyph& glyph,
+                                                int top,
+                                                int bottom) {
+  // Same as BlitLcdRows(), but with the average coverage of each column.
+  const int start_col = glyph.dest_rect.left;
+  const int end_col = glyph.dest_rect.right;
+  for (int row = top; row < bottom; ++row) {
+    const uint8_t* src_scan =
+        glyph.bitmap->GetScanline(row - glyph.top)
+            .subspan(static_cast<size_t>((start_col - glyph.left) * 3))
+            .data();
+    pdfium::span<uint8_t> dest_span = bitmap_->GetWritableScanline(row).subspan(
+        static_cast<size_t>(start_col * kBytesPerPixel));
+    int col = start_col;
+    UNSAFE_TODO({
+      src_scan -= glyph.x_subpixel;
+      if (glyph.x_subpixel != 0) {
+        // With a subpixel offset, the first column leaves transparent pixels
+        // alone where it has no coverage.
+        int src_value;
+        if (start_col > glyph.left) {
+          src_value = (src_scan[0] + src_scan[1] + src_scan[2]) / 3;
+        } else if (glyph.x_subpixel == 1) {
+          src_value = (src_scan[1] + src_scan[2]) / 3;
+        } else {
+          src_value = src_scan[2] / 3;
+        }
+        const int coverage = kTextGammaAdjust[src_value];
+        if (CalcAlpha(coverage, bgra_.alpha) != 0) {
+          CompositeNormalized<kHasAlpha>(dest_span.data(), bgra_, coverage);
+        }
+        src_scan += 3;
+        dest_span = dest_span.subspan(static_cast<size_t>(kBytesPerPixel));
+        ++col;
+      }
+    });
+
+    // Gathers the coverage of the rest of the row first, so it can get
+    // composited like a mask.
+    pdfium::span<uint8_t> coverage =
+        pdfium::span(coverage_).first(static_cast<size_t>(end_col - col));
+    for (uint8_t& value : coverage) {
+      value = UNSAFE_TODO(
+          kTextGammaAdjust[(src_scan[0] + src_scan[1] + src_scan[2]) / 3]);
+      UNSAFE_TODO(src_scan += 3);
+    }
+
+    size_t done = 0;
+    if constexpr (kBytesPerPixel == 4) {
+      // Leaves any remaining pixels to the scalar code below.
+      if constexpr (kHasAlpha) {
+        done = fxge::CompositeRowByteMask2BgraNormal(
+            coverage, bgra_, /*rgb_byte_order=*/false, {}, dest_span);
+      } else {
+        done = fxge::CompositeRowByteMask2BgrxNormal(
+            coverage, bgra_, /*rgb_byte_order=*/false, {}, dest_span);
+      }
+      dest_span = dest_span.subspan(done * kBytesPerPixel);
+    }
+    for (uint8_t value : coverage.subspan(done)) {
+      CompositeNormalized<kHasAlpha>(dest_span.data(), bgra_, value);
+      dest_span = dest_span.subspan(static_cast<size_t>(kBytesPerPixel));
+    }
+  }
+}
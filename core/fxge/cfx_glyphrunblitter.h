@@ -0,0 +1,87 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FXGE_CFX_GLYPHRUNBLITTER_H_
+#define CORE_FXGE_CFX_GLYPHRUNBLITTER_H_
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "core/fxcrt/fx_coordinates.h"
+#include "core/fxcrt/retain_ptr.h"
+#include "core/fxge/dib/cfx_scanlinecompositor.h"
+#include "core/fxge/dib/fx_dib.h"
+
+class CFX_DIBitmap;
+
+// Composites the glyph bitmaps of a run of text onto the bitmap that
+// CFX_RenderDevice::DrawNormalText() draws into. Glyphs get composited a band
+// of rows at a time, so the destination rows stay in cache while all of the
+// glyphs that touch them get drawn. The blend loops are specialized for each
+// destination format and anti-aliasing mode.
+//
+// The result is identical to compositing each glyph in turn, in the order they
+// got added.
+class CFX_GlyphRunBlitter {
+ public:
+  enum class Mode {
+    // 8-bit coverage glyphs, composited as masks.
+    kGray,
+    // LCD glyphs with 3 coverage values per pixel, composited per channel.
+    kLcd,
+    // LCD glyphs, composited with the average coverage of each pixel.
+    kLcdNormalized,
+  };
+
+  // Number of rows in a band.
+  static constexpr int kBandHeight = 16;
+
+  // For the LCD modes, `bitmap` must be kBgr, kBgrx or kBgra.
+  CFX_GlyphRunBlitter(RetainPtr<CFX_DIBitmap> bitmap,
+                      Mode mode,
+                      uint32_t color);
+  ~CFX_GlyphRunBlitter();
+
+  // Adds `glyph` with its top left pixel at `origin` in the bitmap.
+  // `x_subpixel` is the horizontal offset of LCD glyphs in thirds of a pixel,
+  // from 0 to 2. Other values count as 2.
+  void AddGlyph(RetainPtr<const CFX_DIBitmap> glyph,
+                const CFX_Point& origin,
+                int x_subpixel);
+
+  // Composites all glyphs added so far.
+  void Blit();
+
+ private:
+  // The part of a glyph that falls inside the bitmap.
+  struct Glyph {
+    RetainPtr<const CFX_DIBitmap> bitmap;
+    // Position of the glyph bitmap in the destination bitmap.
+    int left;
+    int top;
+    // Destination rows and columns to composite.
+    FX_RECT dest_rect;
+    int x_subpixel;
+  };
+
+  void BlitRows(const Glyph& glyph, int top, int bottom);
+  void BlitGrayRows(const Glyph& glyph, int top, int bottom);
+  template <int kBytesPerPixel, bool kHasAlpha>
+  void BlitLcdRows(const Glyph& glyph, int top, int bottom);
+  template <int kBytesPerPixel, bool kHasAlpha>
+  void BlitLcdNormalizedRows(const Glyph& glyph, int top, int bottom);
+
+  const RetainPtr<CFX_DIBitmap> bitmap_;
+  const Mode mode_;
+  const uint32_t color_;
+  const FX_BGRA_STRUCT<uint8_t> bgra_;
+  CFX_ScanlineCompositor byte_mask_compositor_;
+  CFX_ScanlineCompositor bit_mask_compositor_;
+  std::vector<Glyph> glyphs_;
+  // Gamma adjusted coverage of the pixels of one row, for kLcdNormalized.
+  std::vector<uint8_t> coverage_;
+};
+
+#endif  // CORE_FXGE_CFX_GLYPHRUNBLITTER_H_
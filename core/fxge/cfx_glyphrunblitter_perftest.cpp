@@ -0,0 +1,55 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "public/cpp/fpdf_scopers.h"
+#include "public/fpdfview.h"
+#include "testing/embedder_test.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf_timer.h"
+
+namespace {
+
+// Renders at twice the page size, so glyphs are about as large as on screen.
+constexpr int kScale = 2;
+
+struct RenderCase {
+  const char* label;
+  int format;
+  int flags;
+};
+
+constexpr RenderCase kRenderCases[] = {
+    {"bgra", FPDFBitmap_BGRA, 0},
+    {"bgrx", FPDFBitmap_BGRx, 0},
+    {"bgr", FPDFBitmap_BGR, 0},
+    {"gray", FPDFBitmap_Gray, 0},
+    {"bgrx_lcd", FPDFBitmap_BGRx, FPDF_LCD_TEXT},
+    {"bgrx_no_smooth", FPDFBitmap_BGRx, FPDF_RENDER_NO_SMOOTHTEXT},
+};
+
+}  // namespace
+
+class CFXGlyphRunBlitterPerfTest : public EmbedderTest {};
+
+TEST_F(CFXGlyphRunBlitterPerfTest, RenderTextDensePage) {
+  ASSERT_TRUE(OpenDocument("text_dense.pdf"));
+  ScopedPage page = LoadScopedPage(0);
+  ASSERT_TRUE(page);
+  const int width = static_cast<int>(FPDF_GetPageWidthF(page.get())) * kScale;
+  const int height =
+      static_cast<int>(FPDF_GetPageHeightF(page.get())) * kScale;
+
+  for (const RenderCase& render_case : kRenderCases) {
+    ScopedFPDFBitmap bitmap(FPDFBitmap_CreateEx(
+        width, height, render_case.format, /*first_scan=*/nullptr,
+        /*stride=*/0));
+    ASSERT_TRUE(bitmap);
+    pdfium::MeasureBestTimeMs(render_case.label, pdfium::kDefaultPerfRuns, [&] {
+      ASSERT_TRUE(FPDFBitmap_FillRect(bitmap.get(), 0, 0, width, height,
+                                      0xFFFFFFFF));
+      FPDF_RenderPageBitmap(bitmap.get(), page.get(), 0, 0, width, height,
+                            /*rotate=*/0, render_case.flags);
+    });
+  }
+}
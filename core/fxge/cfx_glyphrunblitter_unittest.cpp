@@ -0,0 +1,280 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxge/cfx_glyphrunblitter.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include "core/fxcrt/fx_coordinates.h"
+#include "core/fxcrt/span.h"
+#include "core/fxge/dib/cfx_dibitmap.h"
+#include "core/fxge/dib/fx_dib.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+constexpr int kWidth = 61;
+constexpr int kHeight = 45;
+
+struct TestGlyph {
+  RetainPtr<CFX_DIBitmap> bitmap;
+  CFX_Point origin;
+  int x_subpixel;
+};
+
+// Fills `bitmap` with arbitrary bytes, with some fully transparent pixels.
+void FillBitmap(const RetainPtr<CFX_DIBitmap>& bitmap, uint32_t seed) {
+  for (int row = 0; row < bitmap->GetHeight(); ++row) {
+    pdfium::span<uint8_t> scan = bitmap->GetWritableScanline(row);
+    for (size_t i = 0; i < scan.size(); ++i) {
+      seed = seed * 1103515245 + 12345;
+      scan[i] = static_cast<uint8_t>(seed >> 16);
+    }
+    if (bitmap->GetFormat() == FXDIB_Format::kBgra) {
+      for (size_t i = 3; i < scan.size(); i += 12) {
+        scan[i] = 0;
+      }
+    }
+  }
+}
+
+RetainPtr<CFX_DIBitmap> CreateBitmap(int width,
+                                     int height,
+                                     FXDIB_Format format,
+                                     uint32_t seed) {
+  auto bitmap = pdfium::MakeRetain<CFX_DIBitmap>();
+  CHECK(bitmap->Create(width, height, format));
+  FillBitmap(bitmap, seed);
+  return bitmap;
+}
+
+// Glyphs that overlap each other, cross band boundaries and stick out of the
+// bitmap on every side. LCD glyphs are 3 bytes per pixel wide.
+std::vector<TestGlyph> CreateGlyphs(bool lcd) {
+  static constexpr struct {
+    int left;
+    int top;
+    int width;
+    int height;
+  } kRects[] = {
+      {5, 3, 11, 14},   {9, 10, 20, 30},  {-4, -6, 12, 12}, {0, 20, 7, 9},
+      {50, 38, 15, 12}, {30, 15, 31, 17}, {59, 0, 4, 45},   {-3, 40, 8, 8},
+      {0, 0, 1, 1},     {12, 16, 9, 16},
+  };
+  std::vector<TestGlyph> glyphs;
+  uint32_t seed = 1;
+  for (const auto& rect : kRects) {
+    const int width = lcd ? rect.width * 3 : rect.width;
+    glyphs.push_back(
+        {.bitmap = CreateBitmap(width, rect.height, FXDIB_Format::k8bppMask,
+                                seed++),
+         .origin = {rect.left, rect.top},
+         .x_subpixel = static_cast<int>(seed % 3)});
+  }
+  return glyphs;
+}
+
+int CalcAlpha(int src, int alpha) {
+  return src * alpha / 255;
+}
+
+// Same as the table in the blitter.
+constexpr std::array<const uint8_t, 256> kTextGammaAdjust = {{
+    0,   2,   3,   4,   6,   7,   8,   10,  11,  12,  13,  15,  16,  17,  18,
+    19,  21,  22,  23,  24,  25,  26,  27,  29,  30,  31,  32,  33,  34,  35,
+    36,  38,  39,  40,  41,  42,  43,  44,  45,  46,  47,  48,  49,  51,  52,
+    53,  54,  55,  56,  57,  58,  59,  60,  61,  62,  63,  64,  65,  66,  67,
+    68,  69,  71,  72,  73,  74,  75,  76,  77,  78,  79,  80,  81,  82,  83,
+    84,  85,  86,  87,  88,  89,  90,  91,  92,  93,  94,  95,  96,  97,  98,
+    99,  100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110, 111, 112, 113,
+    114, 115, 116, 117, 118, 119, 120, 121, 122, 123, 124, 125, 126, 127, 128,
+    129, 129, 130, 131, 132, 133, 134, 135, 136, 137, 138, 139, 140, 141, 142,
+    143, 144, 145, 146, 147, 148, 149, 150, 151, 152, 153, 154, 155, 156, 156,
+    157, 158, 159, 160, 161, 162, 163, 164, 165, 166, 167, 168, 169, 170, 171,
+    172, 173, 174, 174, 175, 176, 177, 178, 179, 180, 181, 182, 183, 184, 185,
+    186, 187, 188, 189, 190, 190, 191, 192, 193, 194, 195, 196, 197, 198, 199,
+    200, 201, 202, 203, 204, 204, 205, 206, 207, 208, 209, 210, 211, 212, 213,
+    214, 215, 216, 217, 217, 218, 219, 220, 221, 222, 223, 224, 225, 226, 227,
+    228, 228, 229, 230, 231, 232, 233, 234, 235, 236, 237, 238, 239, 239, 240,
+    241, 242, 243, 244, 245, 246, 247, 248, 249, 250, 250, 251, 252, 253, 254,
+    255,
+}};
+
+int GammaAdjust(int value) {
+  return kTextGammaAdjust[value];
+}
+
+void MergeChannel(int src, int channel, int alpha, uint8_t& dest) {
+  dest = FXDIB_ALPHA_MERGE(dest, channel, CalcAlpha(GammaAdjust(src), alpha));
+}
+
+// Per-pixel reference for compositing one LCD glyph pixel, with the coverage
+// bytes that exist in `coverage`, in red, green, blue order.
+void CompositeLcdPixel(const int coverage[3],
+                       bool normalize,
+                       bool skip_transparent,
+                       bool has_alpha,
+                       const FX_BGRA_STRUCT<uint8_t>& bgra,
+                       pdfium::span<uint8_t> dest) {
+  if (!normalize) {
+    if (coverage[0] >= 0) {
+      MergeChannel(coverage[0], bgra.red, bgra.alpha, dest[2]);
+    }
+    if (coverage[1] >= 0) {
+      MergeChannel(coverage[1], bgra.green, bgra.alpha, dest[1]);
+    }
+    MergeChannel(coverage[2], bgra.blue, bgra.alpha, dest[0]);
+    if (has_alpha) {
+      dest[3] = 255;
+    }
+    return;
+  }
+
+  int sum = 0;
+  for (int i = 0; i < 3; ++i) {
+    sum += coverage[i] >= 0 ? coverage[i] : 0;
+  }
+  const int src_alpha = CalcAlpha(GammaAdjust(sum / 3), bgra.alpha);
+  if (!has_alpha) {
+    for (int i = 0; i < 3; ++i) {
+      const uint8_t channel = i == 0 ? bgra.blue : i == 1 ? bgra.green
+                                                          : bgra.red;
+      dest[i] = FXDIB_ALPHA_MERGE(dest[i], channel, src_alpha);
+    }
+    return;
+  }
+  if (skip_transparent && src_alpha == 0) {
+    return;
+  }
+  if (dest[3] == 0) {
+    dest[0] = bgra.blue;
+    dest[1] = bgra.green;
+    dest[2] = bgra.red;
+    dest[3] = static_cast<uint8_t>(src_alpha);
+    return;
+  }
+  if (src_alpha == 0) {
+    return;
+  }
+  const uint8_t dest_alpha = dest[3] + src_alpha - dest[3] * src_alpha / 255;
+  const int ratio = src_alpha * 255 / dest_alpha;
+  dest[0] = FXDIB_ALPHA_MERGE(dest[0], bgra.blue, ratio);
+  dest[1] = FXDIB_ALPHA_MERGE(dest[1], bgra.green, ratio);
+  dest[2] = FXDIB_ALPHA_MERGE(dest[2], bgra.red, ratio);
+  dest[3] = dest_alpha;
+}
+
+// Draws `glyphs` one by one, pixel by pixel.
+void DrawLcdGlyphs(const RetainPtr<CFX_DIBitmap>& bitmap,
+                   const std::vector<TestGlyph>& glyphs,
+                   bool normalize,
+                   uint32_t color) {
+  const FX_BGRA_STRUCT<uint8_t> bgra = ArgbToBGRAStruct(color);
+  const bool has_alpha = bitmap->IsAlphaFormat();
+  const int bytes_per_pixel = bitmap->GetBPP() / 8;
+  for (const TestGlyph& glyph : glyphs) {
+    const int left = glyph.origin.x;
+    const int top = glyph.origin.y;
+    for (int row = 0; row < glyph.bitmap->GetHeight(); ++row) {
+      const int dest_row = top + row;
+      if (dest_row < 0 || dest_row >= bitmap->GetHeight()) {
+        continue;
+      }
+      pdfium::span<const uint8_t> src = glyph.bitmap->GetScanline(row);
+      pdfium::span<uint8_t> dest = bitmap->GetWritableScanline(dest_row);
+      const int start_col = std::max(left, 0);
+      const int end_col =
+          std::min(left + glyph.bitmap->GetWidth() / 3, bitmap->GetWidth());
+      for (int col = start_col; col < end_col; ++col) {
+        const int offset = (col - left) * 3 - glyph.x_subpixel;
+        int coverage[3];
+        for (int i = 0; i < 3; ++i) {
+          coverage[i] =
+              offset + i >= 0 ? src[static_cast<size_t>(offset + i)] : -1;
+        }
+        const bool skip_transparent =
+            glyph.x_subpixel != 0 && col == start_col;
+        CompositeLcdPixel(
+            coverage, normalize, skip_transparent, has_alpha, bgra,
+            dest.subspan(static_cast<size_t>(col * bytes_per_pixel)));
+      }
+    }
+  }
+}
+
+void ExpectSameBitmaps(const RetainPtr<CFX_DIBitmap>& expected,
+                       const RetainPtr<CFX_DIBitmap>& actual) {
+  const size_t row_bytes =
+      static_cast<size_t>(expected->GetWidth() * expected->GetBPP() / 8);
+  for (int row = 0; row < expected->GetHeight(); ++row) {
+    EXPECT_EQ(expected->GetScanline(row).first(row_bytes),
+              actual->GetScanline(row).first(row_bytes))
+        << "row " << row;
+  }
+}
+
+}  // namespace
+
+TEST(CFXGlyphRunBlitterTest, Lcd) {
+  const std::vector<TestGlyph> glyphs = CreateGlyphs(/*lcd=*/true);
+  for (FXDIB_Format format :
+       {FXDIB_Format::kBgr, FXDIB_Format::kBgrx, FXDIB_Format::kBgra}) {
+    for (bool normalize : {false, true}) {
+      for (uint32_t color : {0xff204080u, 0x80c0a060u, 0x00ffffffu}) {
+        SCOPED_TRACE(testing::Message()
+                     << "format " << static_cast<int>(format) << " normalize "
+                     << normalize << " color " << color);
+        RetainPtr<CFX_DIBitmap> expected =
+            CreateBitmap(kWidth, kHeight, format, 42);
+        RetainPtr<CFX_DIBitmap> actual =
+            CreateBitmap(kWidth, kHeight, format, 42);
+        DrawLcdGlyphs(expected, glyphs, normalize, color);
+
+        CFX_GlyphRunBlitter blitter(
+            actual,
+            normalize ? CFX_GlyphRunBlitter::Mode::kLcdNormalized
+                      : CFX_GlyphRunBlitter::Mode::kLcd,
+            color);
+        for (const TestGlyph& glyph : glyphs) {
+          blitter.AddGlyph(glyph.bitmap, glyph.origin, glyph.x_subpixel);
+        }
+        blitter.Blit();
+        ExpectSameBitmaps(expected, actual);
+      }
+    }
+  }
+}
+
+TEST(CFXGlyphRunBlitterTest, Gray) {
+  const std::vector<TestGlyph> glyphs = CreateGlyphs(/*lcd=*/false);
+  for (FXDIB_Format format : {FXDIB_Format::k8bppMask, FXDIB_Format::kBgr,
+                              FXDIB_Format::kBgrx, FXDIB_Format::kBgra}) {
+    for (uint32_t color : {0xff204080u, 0x80c0a060u, 0x00ffffffu}) {
+      SCOPED_TRACE(testing::Message() << "format " << static_cast<int>(format)
+                                      << " color " << color);
+      RetainPtr<CFX_DIBitmap> expected =
+          CreateBitmap(kWidth, kHeight, format, 42);
+      RetainPtr<CFX_DIBitmap> actual =
+          CreateBitmap(kWidth, kHeight, format, 42);
+      for (const TestGlyph& glyph : glyphs) {
+        ASSERT_TRUE(expected->CompositeMask(
+            glyph.origin.x, glyph.origin.y, glyph.bitmap->GetWidth(),
+            glyph.bitmap->GetHeight(), glyph.bitmap, color, 0, 0,
+            BlendMode::kNormal, nullptr, false));
+      }
+
+      CFX_GlyphRunBlitter blitter(actual, CFX_GlyphRunBlitter::Mode::kGray,
+                                  color);
+      for (const TestGlyph& glyph : glyphs) {
+        blitter.AddGlyph(glyph.bitmap, glyph.origin, 0);
+      }
+      blitter.Blit();
+      ExpectSameBitmaps(expected, actual);
+    }
+  }
+}
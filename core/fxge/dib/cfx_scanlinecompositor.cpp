@@ -17,6 +17,7 @@
 #include "core/fxcrt/stl_util.h"
 #include "core/fxcrt/zip.h"
 #include "core/fxge/dib/blend.h"
+#include "core/fxge/dib/composite_simd.h"
 #include "core/fxge/dib/fx_dib.h"
 
 using fxge::Blend;
@@ -2313,6 +2314,16 @@ void CFX_ScanlineCompositor::CompositeRgbBitmapLineSrcBgra(
       return;
     }
     case FXDIB_Format::kBgra: {
+      if (blend_type_ == BlendMode::kNormal) {
+        // Leaves any remaining pixels to the scalar code below.
+        const size_t done = fxge::CompositeRowBgra2BgraNormal(
+            pdfium::as_bytes(src_span), clip_scan, rgb_byte_order_, dest_scan);
+        src_span = src_span.subspan(done);
+        dest_scan = dest_scan.subspan(done * 4);
+        if (!clip_scan.empty()) {
+          clip_scan = clip_scan.subspan(done);
+        }
+      }
       if (rgb_byte_order_) {
         auto dest_span =
             fxcrt::reinterpret_span<FX_RGBA_STRUCT<uint8_t>>(dest_scan);
@@ -2368,6 +2379,13 @@ void CFX_ScanlineCompositor::CompositeRgbBitmapLineSrcBgraPremul(
       NOTREACHED();
     }
     case FXDIB_Format::kBgraPremul: {
+      if (blend_type_ == BlendMode::kNormal) {
+        // Leaves any remaining pixels to the scalar code below.
+        const size_t done = fxge::CompositeRowBgraPremul2BgraPremulNormal(
+            pdfium::as_bytes(src_span), rgb_byte_order_, dest_scan);
+        src_span = src_span.subspan(done);
+        dest_scan = dest_scan.subspan(done * 4);
+      }
       if (rgb_byte_order_) {
         auto dest_span =
             fxcrt::reinterpret_span<FX_RGBA_STRUCT<uint8_t>>(dest_scan);
@@ -2549,6 +2567,18 @@ void CFX_ScanlineCompositor::CompositeByteMaskLine(
     }
     case FXDIB_Format::kBgr:
     case FXDIB_Format::kBgrx: {
+      if (dest_format_ == FXDIB_Format::kBgrx &&
+          blend_type_ == BlendMode::kNormal) {
+        // Leaves any remaining pixels to the scalar code below.
+        const size_t done = fxge::CompositeRowByteMask2BgrxNormal(
+            src_scan.first(static_cast<size_t>(width)),
+            std::get<FX_BGRA_STRUCT<uint8_t>>(mask_color_), rgb_byte_order_,
+            clip_scan, dest_scan);
+        dest_scan = dest_scan.subspan(done * 4);
+        src_scan = src_scan.subspan(done);
+        clip_scan = clip_scan.subspan(std::min(done, clip_scan.size()));
+        width -= static_cast<int>(done);
+      }
       if (rgb_byte_order_) {
         CompositeRow_ByteMask2Rgb_RgbByteOrder(
             dest_scan, src_scan, std::get<FX_BGRA_STRUCT<uint8_t>>(mask_color_),
@@ -2561,6 +2591,17 @@ void CFX_ScanlineCompositor::CompositeByteMaskLine(
       return;
     }
     case FXDIB_Format::kBgra: {
+      if (blend_type_ == BlendMode::kNormal) {
+        // Leaves any remaining pixels to the scalar code below.
+        const size_t done = fxge::CompositeRowByteMask2BgraNormal(
+            src_scan.first(static_cast<size_t>(width)),
+            std::get<FX_BGRA_STRUCT<uint8_t>>(mask_color_), rgb_byte_order_,
+            clip_scan, dest_scan);
+        dest_scan = dest_scan.subspan(done * 4);
+        src_scan = src_scan.subspan(done);
+        clip_scan = clip_scan.subspan(std::min(done, clip_scan.size()));
+        width -= static_cast<int>(done);
+      }
       if (rgb_byte_order_) {
         auto dest_span =
             fxcrt::reinterpret_span<FX_RGBA_STRUCT<uint8_t>>(dest_scan);
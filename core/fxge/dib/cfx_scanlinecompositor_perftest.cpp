@@ -0,0 +1,98 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxge/dib/cfx_scanlinecompositor.h"
+
+#include <stdint.h>
+
+#include <functional>
+#include <vector>
+
+#include "core/fxcrt/span.h"
+#include "core/fxge/dib/composite_simd.h"
+#include "core/fxge/dib/fx_dib.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf_timer.h"
+
+namespace {
+
+constexpr int kWidth = 2048;
+constexpr int kHeight = 512;
+constexpr size_t kRowSize = kWidth * 4;
+
+std::vector<uint8_t> MakeBytes(size_t size, uint32_t seed) {
+  std::vector<uint8_t> bytes(size);
+  for (uint8_t& byte : bytes) {
+    seed = seed * 1103515245 + 12345;
+    byte = static_cast<uint8_t>(seed >> 16);
+  }
+  return bytes;
+}
+
+// Composites every row of a `kWidth` x `kHeight` destination with
+// `composite_row`, with the scalar code only and then with the vectorized
+// code, and checks that both produce the same pixels.
+void MeasureScalarAndSimd(
+    const std::function<void(pdfium::span<uint8_t>)>& composite_row) {
+  const std::vector<uint8_t> original = MakeBytes(kRowSize * kHeight, 1);
+  std::vector<uint8_t> scalar_dest;
+  std::vector<uint8_t> simd_dest;
+  for (bool simd : {false, true}) {
+    fxge::SetCompositeSimdEnabledForTesting(simd);
+    std::vector<uint8_t>& dest = simd ? simd_dest : scalar_dest;
+    pdfium::MeasureBestTimeMs(
+        simd ? "simd" : "scalar", pdfium::kDefaultPerfRuns, [&] {
+          dest = original;
+          pdfium::span<uint8_t> rows(dest);
+          for (int row = 0; row < kHeight; ++row) {
+            composite_row(rows.subspan(row * kRowSize, kRowSize));
+          }
+        });
+  }
+  fxge::SetCompositeSimdEnabledForTesting(true);
+  EXPECT_EQ(scalar_dest, simd_dest);
+}
+
+void MeasureBgra2Bgra(bool clipped) {
+  const std::vector<uint8_t> src = MakeBytes(kRowSize, 2);
+  const std::vector<uint8_t> clip =
+      clipped ? MakeBytes(kWidth, 3) : std::vector<uint8_t>();
+  CFX_ScanlineCompositor compositor;
+  ASSERT_TRUE(compositor.Init(FXDIB_Format::kBgra, FXDIB_Format::kBgra,
+                              /*src_palette=*/{}, /*mask_color=*/0,
+                              BlendMode::kNormal, /*bRgbByteOrder=*/false));
+  MeasureScalarAndSimd([&](pdfium::span<uint8_t> dest) {
+    compositor.CompositeRgbBitmapLine(dest, src, kWidth, clip);
+  });
+}
+
+void MeasureByteMask(FXDIB_Format dest_format) {
+  const std::vector<uint8_t> mask = MakeBytes(kWidth, 4);
+  CFX_ScanlineCompositor compositor;
+  ASSERT_TRUE(compositor.Init(dest_format, FXDIB_Format::k8bppMask,
+                              /*src_palette=*/{},
+                              ArgbEncode(200, 250, 120, 10),
+                              BlendMode::kNormal, /*bRgbByteOrder=*/false));
+  MeasureScalarAndSimd([&](pdfium::span<uint8_t> dest) {
+    compositor.CompositeByteMaskLine(dest, mask, kWidth, /*clip_scan=*/{});
+  });
+}
+
+}  // namespace
+
+TEST(CFXScanlineCompositorPerfTest, Bgra2BgraNormal) {
+  MeasureBgra2Bgra(/*clipped=*/false);
+}
+
+TEST(CFXScanlineCompositorPerfTest, Bgra2BgraNormalClipped) {
+  MeasureBgra2Bgra(/*clipped=*/true);
+}
+
+TEST(CFXScanlineCompositorPerfTest, ByteMask2BgraNormal) {
+  MeasureByteMask(FXDIB_Format::kBgra);
+}
+
+TEST(CFXScanlineCompositorPerfTest, ByteMask2BgrxNormal) {
+  MeasureByteMask(FXDIB_Format::kBgrx);
+}
@@ -0,0 +1,372 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxge/dib/composite_simd.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+
+#include "core/fxcrt/check_op.h"
+#include "core/fxcrt/compiler_specific.h"
+
+// Compiles this file once per CPU target that Highway supports.
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "core/fxge/dib/composite_simd.cpp"
+#include "hwy/foreach_target.h"  // IWYU pragma: keep
+#include "hwy/highway.h"
+
+HWY_BEFORE_NAMESPACE();
+namespace fxge {
+namespace HWY_NAMESPACE {
+
+namespace hn = hwy::HWY_NAMESPACE;
+
+// Each 32-bit lane holds one pixel, or one component of one pixel.
+using DI = hn::ScalableTag<int32_t>;
+using VI = hn::Vec<DI>;
+
+// Bit offset of byte `kByte` of a pixel within its lane.
+template <int kByte>
+constexpr int kByteShift = HWY_IS_LITTLE_ENDIAN ? kByte * 8 : 24 - kByte * 8;
+
+HWY_INLINE VI LoadPixels(const uint8_t* pixels) {
+  const hn::Repartition<uint8_t, DI> d8;
+  return hn::BitCast(DI(), hn::LoadU(d8, pixels));
+}
+
+HWY_INLINE void StorePixels(VI pixels, uint8_t* dest) {
+  const hn::Repartition<uint8_t, DI> d8;
+  hn::StoreU(hn::BitCast(d8, pixels), d8, dest);
+}
+
+// Loads one byte per pixel.
+HWY_INLINE VI LoadBytes(const uint8_t* bytes) {
+  const hn::Rebind<uint8_t, DI> d8;
+  return hn::PromoteTo(DI(), hn::LoadU(d8, bytes));
+}
+
+template <int kByte>
+HWY_INLINE VI GetByte(VI pixels) {
+  return hn::And(hn::ShiftRight<kByteShift<kByte>>(pixels),
+                 hn::Set(DI(), 0xff));
+}
+
+// Packs the low bytes of the components, like storing them into uint8_t.
+HWY_INLINE VI PackBytes(VI c0, VI c1, VI c2, VI c3) {
+  const VI mask = hn::Set(DI(), 0xff);
+  return hn::Or(hn::Or(hn::ShiftLeft<kByteShift<0>>(hn::And(c0, mask)),
+                       hn::ShiftLeft<kByteShift<1>>(hn::And(c1, mask))),
+                hn::Or(hn::ShiftLeft<kByteShift<2>>(hn::And(c2, mask)),
+                       hn::ShiftLeft<kByteShift<3>>(hn::And(c3, mask))));
+}
+
+// Exchanges the first and third bytes of each pixel, which turns BGRA pixels
+// into RGBA pixels.
+HWY_INLINE VI SwapRedBlue(VI pixels) {
+  return PackBytes(GetByte<2>(pixels), GetByte<1>(pixels), GetByte<0>(pixels),
+                   GetByte<3>(pixels));
+}
+
+// Loads source pixels in the byte order of the destination.
+HWY_INLINE VI LoadSrcPixels(const uint8_t* pixels, bool rgb_byte_order) {
+  const VI loaded = LoadPixels(pixels);
+  return rgb_byte_order ? SwapRedBlue(loaded) : loaded;
+}
+
+// Returns `x / 255` for 0 <= x <= 255 * 255.
+HWY_INLINE VI Div255(VI x) {
+  return hn::ShiftRight<23>(hn::Mul(x, hn::Set(DI(), 0x8081)));
+}
+
+// Returns `n / d` for 0 <= n < 2^24 and 0 < d < 2^24. Float division is not
+// correctly rounded on every target, so the quotient gets fixed up afterwards.
+HWY_INLINE VI DivFloor(VI n, VI d) {
+  const DI di;
+  const hn::RebindToFloat<DI> df;
+  const VI one = hn::Set(di, 1);
+  VI q =
+      hn::ConvertTo(di, hn::Div(hn::ConvertTo(df, n), hn::ConvertTo(df, d)));
+  q = hn::IfThenElse(hn::Gt(hn::Mul(q, d), n), hn::Sub(q, one), q);
+  q = hn::IfThenElse(hn::Le(hn::Mul(hn::Add(q, one), d), n), hn::Add(q, one),
+                     q);
+  return q;
+}
+
+// Same as AlphaUnion() in cfx_scanlinecompositor.cpp.
+HWY_INLINE VI AlphaUnion(VI dest, VI src) {
+  return hn::Sub(hn::Add(dest, src), Div255(hn::Mul(dest, src)));
+}
+
+// Same as FXDIB_ALPHA_MERGE().
+HWY_INLINE VI AlphaMerge(VI back, VI src, VI alpha) {
+  const VI inverse = hn::Sub(hn::Set(DI(), 255), alpha);
+  return Div255(hn::Add(hn::Mul(back, inverse), hn::Mul(src, alpha)));
+}
+
+// Merges the color components of `src` into `back`. Leaves the alpha byte
+// zeroed.
+HWY_INLINE VI AlphaMergeColors(VI back, VI src, VI alpha) {
+  return PackBytes(AlphaMerge(GetByte<0>(back), GetByte<0>(src), alpha),
+                   AlphaMerge(GetByte<1>(back), GetByte<1>(src), alpha),
+                   AlphaMerge(GetByte<2>(back), GetByte<2>(src), alpha),
+                   hn::Zero(DI()));
+}
+
+// Composites straight alpha colors `src` with alpha `src_alpha` onto the
+// straight alpha pixels `dest`.
+HWY_INLINE VI CompositeStraightAlpha(VI src, VI src_alpha, VI dest) {
+  const DI di;
+  const VI back_alpha = GetByte<3>(dest);
+  const VI dest_alpha = AlphaUnion(back_alpha, src_alpha);
+  const VI alpha_ratio = DivFloor(hn::Mul(src_alpha, hn::Set(di, 255)),
+                                  hn::Max(dest_alpha, hn::Set(di, 1)));
+  const VI blended =
+      hn::Or(AlphaMergeColors(dest, src, alpha_ratio),
+             PackBytes(hn::Zero(di), hn::Zero(di), hn::Zero(di), dest_alpha));
+  // A transparent backdrop takes the source color as is, even where
+  // `src_alpha` is 0.
+  const VI copied = PackBytes(GetByte<0>(src), GetByte<1>(src),
+                              GetByte<2>(src), src_alpha);
+  return hn::IfThenElse(hn::Eq(back_alpha, hn::Zero(di)), copied, blended);
+}
+
+// Same as GetAlphaWithSrc() in cfx_scanlinecompositor.cpp.
+HWY_INLINE VI GetMaskAlpha(VI mask_alpha, const uint8_t* mask,
+                           const uint8_t* clip) {
+  const VI alpha = hn::Mul(mask_alpha, LoadBytes(mask));
+  if (!clip) {
+    return Div255(alpha);
+  }
+  return DivFloor(hn::Mul(alpha, LoadBytes(clip)), hn::Set(DI(), 255 * 255));
+}
+
+size_t CompositeRowBgra2BgraNormalImpl(const uint8_t* src,
+                                       const uint8_t* clip,
+                                       bool rgb_byte_order,
+                                       uint8_t* dest,
+                                       size_t pixel_count) {
+  const DI di;
+  const size_t lanes = hn::Lanes(di);
+  size_t col = 0;
+  // SAFETY: the caller guarantees `pixel_count` pixels in `src` and `dest`,
+  // and in `clip` when present.
+  UNSAFE_BUFFERS({
+    for (; col + lanes <= pixel_count; col += lanes) {
+      const VI src_pixels = LoadSrcPixels(src + col * 4, rgb_byte_order);
+      VI src_alpha = GetByte<3>(src_pixels);
+      if (clip) {
+        src_alpha = Div255(hn::Mul(src_alpha, LoadBytes(clip + col)));
+      }
+      StorePixels(CompositeStraightAlpha(src_pixels, src_alpha,
+                                         LoadPixels(dest + col * 4)),
+                  dest + col * 4);
+    }
+  });
+  return col;
+}
+
+size_t CompositeRowByteMask2BgraNormalImpl(const uint8_t* mask,
+                                           const uint8_t* mask_color,
+                                           const uint8_t* clip,
+                                           uint8_t* dest,
+                                           size_t pixel_count) {
+  const DI di;
+  const size_t lanes = hn::Lanes(di);
+  // SAFETY: `mask_color` is a 4-byte pixel.
+  const VI color = UNSAFE_BUFFERS(
+      PackBytes(hn::Set(di, mask_color[0]), hn::Set(di, mask_color[1]),
+                hn::Set(di, mask_color[2]), hn::Zero(di)));
+  const VI mask_alpha = hn::Set(di, UNSAFE_BUFFERS(mask_color[3]));
+  size_t col = 0;
+  // SAFETY: the caller guarantees `pixel_count` pixels in `mask` and `dest`,
+  // and in `clip` when present.
+  UNSAFE_BUFFERS({
+    for (; col + lanes <= pixel_count; col += lanes) {
+      const VI src_alpha =
+          GetMaskAlpha(mask_alpha, mask + col, clip ? clip + col : nullptr);
+      StorePixels(
+          CompositeStraightAlpha(color, src_alpha, LoadPixels(dest + col * 4)),
+          dest + col * 4);
+    }
+  });
+  return col;
+}
+
+size_t CompositeRowByteMask2BgrxNormalImpl(const uint8_t* mask,
+                                           const uint8_t* mask_color,
+                                           const uint8_t* clip,
+                                           uint8_t* dest,
+                                           size_t pixel_count) {
+  const DI di;
+  const size_t lanes = hn::Lanes(di);
+  // SAFETY: `mask_color` is a 4-byte pixel.
+  const VI color = UNSAFE_BUFFERS(
+      PackBytes(hn::Set(di, mask_color[0]), hn::Set(di, mask_color[1]),
+                hn::Set(di, mask_color[2]), hn::Zero(di)));
+  const VI mask_alpha = hn::Set(di, UNSAFE_BUFFERS(mask_color[3]));
+  size_t col = 0;
+  // SAFETY: the caller guarantees `pixel_count` pixels in `mask` and `dest`,
+  // and in `clip` when present.
+  UNSAFE_BUFFERS({
+    for (; col + lanes <= pixel_count; col += lanes) {
+      const VI src_alpha =
+          GetMaskAlpha(mask_alpha, mask + col, clip ? clip + col : nullptr);
+      const VI dest_pixels = LoadPixels(dest + col * 4);
+      const VI dest_alpha = PackBytes(hn::Zero(di), hn::Zero(di), hn::Zero(di),
+                                      GetByte<3>(dest_pixels));
+      StorePixels(
+          hn::Or(AlphaMergeColors(dest_pixels, color, src_alpha), dest_alpha),
+          dest + col * 4);
+    }
+  });
+  return col;
+}
+
+#if defined(PDF_USE_SKIA)
+size_t CompositeRowBgraPremul2BgraPremulNormalImpl(const uint8_t* src,
+                                                   bool rgb_byte_order,
+                                                   uint8_t* dest,
+                                                   size_t pixel_count) {
+  const DI di;
+  const size_t lanes = hn::Lanes(di);
+  size_t col = 0;
+  // SAFETY: the caller guarantees `pixel_count` pixels in `src` and `dest`.
+  UNSAFE_BUFFERS({
+    for (; col + lanes <= pixel_count; col += lanes) {
+      const VI src_pixels = LoadSrcPixels(src + col * 4, rgb_byte_order);
+      const VI dest_pixels = LoadPixels(dest + col * 4);
+      const VI src_alpha = GetByte<3>(src_pixels);
+      const VI back_alpha = GetByte<3>(dest_pixels);
+      const VI inverse = hn::Sub(hn::Set(di, 255), src_alpha);
+      const VI blended = PackBytes(
+          hn::Add(GetByte<0>(src_pixels),
+                  Div255(hn::Mul(GetByte<0>(dest_pixels), inverse))),
+          hn::Add(GetByte<1>(src_pixels),
+                  Div255(hn::Mul(GetByte<1>(dest_pixels), inverse))),
+          hn::Add(GetByte<2>(src_pixels),
+                  Div255(hn::Mul(GetByte<2>(dest_pixels), inverse))),
+          AlphaUnion(back_alpha, src_alpha));
+      StorePixels(hn::IfThenElse(hn::Eq(back_alpha, hn::Zero(di)), src_pixels,
+                                 blended),
+                  dest + col * 4);
+    }
+  });
+  return col;
+}
+#endif  // defined(PDF_USE_SKIA)
+
+}  // namespace HWY_NAMESPACE
+}  // namespace fxge
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace fxge {
+
+namespace {
+
+std::atomic<bool> g_simd_enabled = true;
+
+bool IsSimdEnabled() {
+  return g_simd_enabled.load(std::memory_order_relaxed);
+}
+
+// Returns `color` in the byte order of the destination.
+std::array<uint8_t, 4> GetMaskColorBytes(const FX_BGRA_STRUCT<uint8_t>& color,
+                                         bool rgb_byte_order) {
+  if (rgb_byte_order) {
+    return {color.red, color.green, color.blue, color.alpha};
+  }
+  return {color.blue, color.green, color.red, color.alpha};
+}
+
+// Returns how many pixels of a mask row the vectorized code may composite.
+size_t GetClippedPixelCount(pdfium::span<const uint8_t> clip,
+                            size_t pixel_count) {
+  if (clip.empty()) {
+    return pixel_count;
+  }
+  // Past the end of `clip`, the scalar code composites without a clip. Leave
+  // those pixels to it.
+  return std::min(pixel_count, clip.size());
+}
+
+}  // namespace
+
+HWY_EXPORT(CompositeRowBgra2BgraNormalImpl);
+HWY_EXPORT(CompositeRowByteMask2BgraNormalImpl);
+HWY_EXPORT(CompositeRowByteMask2BgrxNormalImpl);
+#if defined(PDF_USE_SKIA)
+HWY_EXPORT(CompositeRowBgraPremul2BgraPremulNormalImpl);
+#endif
+
+size_t CompositeRowBgra2BgraNormal(pdfium::span<const uint8_t> src,
+                                   pdfium::span<const uint8_t> clip,
+                                   bool rgb_byte_order,
+                                   pdfium::span<uint8_t> dest) {
+  if (!IsSimdEnabled()) {
+    return 0;
+  }
+  const size_t pixel_count = src.size() / 4;
+  CHECK_GE(dest.size(), pixel_count * 4);
+  if (!clip.empty()) {
+    CHECK_GE(clip.size(), pixel_count);
+  }
+  return HWY_DYNAMIC_DISPATCH(CompositeRowBgra2BgraNormalImpl)(
+      src.data(), clip.empty() ? nullptr : clip.data(), rgb_byte_order,
+      dest.data(), pixel_count);
+}
+
+size_t CompositeRowByteMask2BgraNormal(
+    pdfium::span<const uint8_t> mask,
+    const FX_BGRA_STRUCT<uint8_t>& mask_color,
+    bool rgb_byte_order,
+    pdfium::span<const uint8_t> clip,
+    pdfium::span<uint8_t> dest) {
+  if (!IsSimdEnabled()) {
+    return 0;
+  }
+  const size_t pixel_count = GetClippedPixelCount(clip, mask.size());
+  CHECK_GE(dest.size(), pixel_count * 4);
+  return HWY_DYNAMIC_DISPATCH(CompositeRowByteMask2BgraNormalImpl)(
+      mask.data(), GetMaskColorBytes(mask_color, rgb_byte_order).data(),
+      clip.empty() ? nullptr : clip.data(), dest.data(), pixel_count);
+}
+
+size_t CompositeRowByteMask2BgrxNormal(
+    pdfium::span<const uint8_t> mask,
+    const FX_BGRA_STRUCT<uint8_t>& mask_color,
+    bool rgb_byte_order,
+    pdfium::span<const uint8_t> clip,
+    pdfium::span<uint8_t> dest) {
+  if (!IsSimdEnabled()) {
+    return 0;
+  }
+  const size_t pixel_count = GetClippedPixelCount(clip, mask.size());
+  CHECK_GE(dest.size(), pixel_count * 4);
+  return HWY_DYNAMIC_DISPATCH(CompositeRowByteMask2BgrxNormalImpl)(
+      mask.data(), GetMaskColorBytes(mask_color, rgb_byte_order).data(),
+      clip.empty() ? nullptr : clip.data(), dest.data(), pixel_count);
+}
+
+#if defined(PDF_USE_SKIA)
+size_t CompositeRowBgraPremul2BgraPremulNormal(pdfium::span<const uint8_t> src,
+                                               bool rgb_byte_order,
+                                               pdfium::span<uint8_t> dest) {
+  if (!IsSimdEnabled()) {
+    return 0;
+  }
+  const size_t pixel_count = src.size() / 4;
+  CHECK_GE(dest.size(), pixel_count * 4);
+  return HWY_DYNAMIC_DISPATCH(CompositeRowBgraPremul2BgraPremulNormalImpl)(
+      src.data(), rgb_byte_order, dest.data(), pixel_count);
+}
+#endif  // defined(PDF_USE_SKIA)
+
+void SetCompositeSimdEnabledForTesting(bool enabled) {
+  g_simd_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+}  // namespace fxge
+#endif  // HWY_ONCE
@@ -0,0 +1,68 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FXGE_DIB_COMPOSITE_SIMD_H_
+#define CORE_FXGE_DIB_COMPOSITE_SIMD_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "core/fxcrt/span.h"
+#include "core/fxge/dib/fx_dib.h"
+
+// Vectorized versions of the BlendMode::kNormal row compositors used by
+// CFX_ScanlineCompositor, with runtime CPU dispatch. The results are identical
+// to the scalar code, pixel for pixel.
+//
+// Each function only handles as many whole vectors as fit into the row, and
+// returns the number of pixels it composited. The caller composites the
+// remaining pixels with the scalar code. Returns 0 where no vectorized code is
+// available.
+//
+// Sources are in BGRA byte order. `rgb_byte_order` tells whether the
+// destination is in RGBA order instead, as with FPDF_REVERSE_BYTE_ORDER. Alpha
+// is always the last byte.
+namespace fxge {
+
+// Straight alpha source onto straight alpha destination. `clip` is either
+// empty, or holds one coverage value per pixel.
+size_t CompositeRowBgra2BgraNormal(pdfium::span<const uint8_t> src,
+                                   pdfium::span<const uint8_t> clip,
+                                   bool rgb_byte_order,
+                                   pdfium::span<uint8_t> dest);
+
+// `mask` colored with `mask_color`, onto a straight alpha destination.
+// `clip` is either empty, or holds one coverage value per pixel for a leading
+// part of the row.
+size_t CompositeRowByteMask2BgraNormal(
+    pdfium::span<const uint8_t> mask,
+    const FX_BGRA_STRUCT<uint8_t>& mask_color,
+    bool rgb_byte_order,
+    pdfium::span<const uint8_t> clip,
+    pdfium::span<uint8_t> dest);
+
+// Same as CompositeRowByteMask2BgraNormal(), but onto a destination without
+// alpha. The last byte of each destination pixel is left untouched.
+size_t CompositeRowByteMask2BgrxNormal(
+    pdfium::span<const uint8_t> mask,
+    const FX_BGRA_STRUCT<uint8_t>& mask_color,
+    bool rgb_byte_order,
+    pdfium::span<const uint8_t> clip,
+    pdfium::span<uint8_t> dest);
+
+#if defined(PDF_USE_SKIA)
+// Premultiplied alpha source onto premultiplied alpha destination.
+size_t CompositeRowBgraPremul2BgraPremulNormal(pdfium::span<const uint8_t> src,
+                                               bool rgb_byte_order,
+                                               pdfium::span<uint8_t> dest);
+#endif  // defined(PDF_USE_SKIA)
+
+// While `enabled` is false, the functions above composite nothing and return
+// 0, so callers composite whole rows with their scalar code. Lets tests and
+// benchmarks compare both paths.
+void SetCompositeSimdEnabledForTesting(bool enabled);
+
+}  // namespace fxge
+
+#endif  // CORE_FXGE_DIB_COMPOSITE_SIMD_H_
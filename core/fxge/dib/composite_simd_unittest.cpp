@@ -0,0 +1,305 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxge/dib/composite_simd.h"
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "core/fxcrt/span.h"
+#include "core/fxge/dib/cfx_scanlinecompositor.h"
+#include "core/fxge/dib/fx_dib.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+// Covers every pair of source and backdrop alpha values, plus a few pixels
+// that do not fill a whole vector.
+constexpr size_t kWidth = 256 * 256 + 13;
+
+using Pixel = FX_BGRA_STRUCT<uint8_t>;
+
+uint8_t AlphaUnion(int dest, int src) {
+  return dest + src - dest * src / 255;
+}
+
+uint8_t AlphaMerge(int back, int src, int alpha) {
+  return FXDIB_ALPHA_MERGE(back, src, alpha);
+}
+
+// Per-pixel reference versions of the BlendMode::kNormal compositors in
+// cfx_scanlinecompositor.cpp.
+Pixel CompositeStraightAlpha(const Pixel& src, int src_alpha, Pixel dest) {
+  if (dest.alpha == 0) {
+    return {src.blue, src.green, src.red, static_cast<uint8_t>(src_alpha)};
+  }
+  if (src_alpha == 0) {
+    return dest;
+  }
+  const uint8_t dest_alpha = AlphaUnion(dest.alpha, src_alpha);
+  const int alpha_ratio = src_alpha * 255 / dest_alpha;
+  return {AlphaMerge(dest.blue, src.blue, alpha_ratio),
+          AlphaMerge(dest.green, src.green, alpha_ratio),
+          AlphaMerge(dest.red, src.red, alpha_ratio), dest_alpha};
+}
+
+// Returns `pixel` in the other byte order.
+Pixel SwapRedBlue(const Pixel& pixel) {
+  return {pixel.red, pixel.green, pixel.blue, pixel.alpha};
+}
+
+int GetMaskAlpha(int mask_alpha,
+                 pdfium::span<const uint8_t> mask,
+                 pdfium::span<const uint8_t> clip,
+                 size_t col) {
+  int result = mask_alpha * mask[col];
+  if (col < clip.size()) {
+    result *= clip[col];
+    result /= 255;
+  }
+  return result / 255;
+}
+
+std::vector<uint8_t> MakeMask() {
+  std::vector<uint8_t> mask(kWidth);
+  for (size_t i = 0; i < kWidth; ++i) {
+    mask[i] = static_cast<uint8_t>(i >> 8);
+  }
+  return mask;
+}
+
+std::vector<uint8_t> MakeClip(size_t size) {
+  std::vector<uint8_t> clip(size);
+  for (size_t i = 0; i < size; ++i) {
+    clip[i] = static_cast<uint8_t>(i * 7 + 255);
+  }
+  return clip;
+}
+
+std::vector<Pixel> MakeSrc() {
+  std::vector<Pixel> src(kWidth);
+  for (size_t i = 0; i < kWidth; ++i) {
+    src[i] = {static_cast<uint8_t>(i * 3), static_cast<uint8_t>(i * 5 + 1),
+              static_cast<uint8_t>(i * 11 + 2), static_cast<uint8_t>(i >> 8)};
+  }
+  return src;
+}
+
+std::vector<Pixel> MakeDest() {
+  std::vector<Pixel> dest(kWidth);
+  for (size_t i = 0; i < kWidth; ++i) {
+    dest[i] = {static_cast<uint8_t>(i * 13 + 3), static_cast<uint8_t>(i * 17),
+               static_cast<uint8_t>(i * 19 + 4), static_cast<uint8_t>(i)};
+  }
+  return dest;
+}
+
+void ExpectPixelsEq(pdfium::span<const Pixel> expected,
+                    pdfium::span<const Pixel> actual) {
+  ASSERT_EQ(expected.size(), actual.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    const Pixel& e = expected[i];
+    const Pixel& a = actual[i];
+    ASSERT_TRUE(e.blue == a.blue && e.green == a.green && e.red == a.red &&
+                e.alpha == a.alpha)
+        << "pixel " << i << ": expected " << int{e.blue} << "," << int{e.green}
+        << "," << int{e.red} << "," << int{e.alpha} << " got " << int{a.blue}
+        << "," << int{a.green} << "," << int{a.red} << "," << int{a.alpha};
+  }
+}
+
+// Checks that `actual` holds the `expected` pixels for the `done` pixels that
+// the vectorized code composited, and that it left the rest alone.
+void ExpectComposited(size_t done,
+                      pdfium::span<const Pixel> expected,
+                      pdfium::span<const Pixel> original,
+                      pdfium::span<const Pixel> actual) {
+  ASSERT_LE(done, actual.size());
+  ExpectPixelsEq(expected.first(done), actual.first(done));
+  ExpectPixelsEq(original.subspan(done), actual.subspan(done));
+}
+
+}  // namespace
+
+TEST(CompositeSimdTest, Bgra2BgraNormal) {
+  const std::vector<Pixel> src = MakeSrc();
+  const std::vector<Pixel> original = MakeDest();
+  for (size_t clip_size : {size_t{0}, kWidth}) {
+    SCOPED_TRACE(clip_size);
+    const std::vector<uint8_t> clip = MakeClip(clip_size);
+    for (bool rgb_byte_order : {false, true}) {
+      SCOPED_TRACE(rgb_byte_order);
+      // With `rgb_byte_order`, the destination bytes are in RGBA order.
+      std::vector<Pixel> expected = original;
+      for (size_t i = 0; i < kWidth; ++i) {
+        const int clip_value = clip.empty() ? 255 : clip[i];
+        expected[i] = CompositeStraightAlpha(
+            rgb_byte_order ? SwapRedBlue(src[i]) : src[i],
+            src[i].alpha * clip_value / 255, expected[i]);
+      }
+
+      std::vector<Pixel> dest = original;
+      const size_t done = fxge::CompositeRowBgra2BgraNormal(
+          pdfium::as_byte_span(src), clip, rgb_byte_order,
+          pdfium::as_writable_byte_span(dest));
+      ExpectComposited(done, expected, original, dest);
+
+      // The compositor composites the rest of the row with the scalar code.
+      CFX_ScanlineCompositor compositor;
+      ASSERT_TRUE(compositor.Init(FXDIB_Format::kBgra, FXDIB_Format::kBgra,
+                                  /*src_palette=*/{}, /*mask_color=*/0,
+                                  BlendMode::kNormal, rgb_byte_order));
+      dest = original;
+      compositor.CompositeRgbBitmapLine(pdfium::as_writable_byte_span(dest),
+                                        pdfium::as_byte_span(src), kWidth,
+                                        clip);
+      ExpectPixelsEq(expected, dest);
+    }
+  }
+}
+
+TEST(CompositeSimdTest, ByteMask2BgraNormal) {
+  const std::vector<uint8_t> mask = MakeMask();
+  const std::vector<Pixel> original = MakeDest();
+  const Pixel mask_color = {10, 120, 250, 200};
+  // Clips may be shorter than the row, in which case the rest of the row is
+  // not clipped.
+  for (size_t clip_size : {size_t{0}, kWidth, size_t{1000}}) {
+    SCOPED_TRACE(clip_size);
+    const std::vector<uint8_t> clip = MakeClip(clip_size);
+    for (bool rgb_byte_order : {false, true}) {
+      SCOPED_TRACE(rgb_byte_order);
+      const Pixel color =
+          rgb_byte_order ? Pixel{mask_color.red, mask_color.green,
+                                 mask_color.blue, mask_color.alpha}
+                         : mask_color;
+      std::vector<Pixel> expected = original;
+      for (size_t i = 0; i < kWidth; ++i) {
+        expected[i] = CompositeStraightAlpha(
+            color, GetMaskAlpha(mask_color.alpha, mask, clip, i), expected[i]);
+      }
+
+      std::vector<Pixel> dest = original;
+      const size_t done = fxge::CompositeRowByteMask2BgraNormal(
+          mask, mask_color, rgb_byte_order, clip,
+          pdfium::as_writable_byte_span(dest));
+      ExpectComposited(done, expected, original, dest);
+
+      CFX_ScanlineCompositor compositor;
+      ASSERT_TRUE(compositor.Init(FXDIB_Format::kBgra, FXDIB_Format::k8bppMask,
+                                  /*src_palette=*/{},
+                                  ArgbEncode(mask_color.alpha, mask_color.red,
+                                             mask_color.green, mask_color.blue),
+                                  BlendMode::kNormal, rgb_byte_order));
+      dest = original;
+      compositor.CompositeByteMaskLine(pdfium::as_writable_byte_span(dest),
+                                       mask, kWidth, clip);
+      ExpectPixelsEq(expected, dest);
+    }
+  }
+}
+
+TEST(CompositeSimdTest, ByteMask2BgrxNormal) {
+  const std::vector<uint8_t> mask = MakeMask();
+  const std::vector<Pixel> original = MakeDest();
+  const Pixel mask_color = {10, 120, 250, 200};
+  for (size_t clip_size : {size_t{0}, kWidth, size_t{1000}}) {
+    SCOPED_TRACE(clip_size);
+    const std::vector<uint8_t> clip = MakeClip(clip_size);
+    for (bool rgb_byte_order : {false, true}) {
+      SCOPED_TRACE(rgb_byte_order);
+      const Pixel color =
+          rgb_byte_order ? Pixel{mask_color.red, mask_color.green,
+                                 mask_color.blue, mask_color.alpha}
+                         : mask_color;
+      std::vector<Pixel> expected = original;
+      for (size_t i = 0; i < kWidth; ++i) {
+        const int src_alpha = GetMaskAlpha(mask_color.alpha, mask, clip, i);
+        Pixel& pixel = expected[i];
+        pixel.blue = AlphaMerge(pixel.blue, color.blue, src_alpha);
+        pixel.green = AlphaMerge(pixel.green, color.green, src_alpha);
+        pixel.red = AlphaMerge(pixel.red, color.red, src_alpha);
+      }
+
+      std::vector<Pixel> dest = original;
+      const size_t done = fxge::CompositeRowByteMask2BgrxNormal(
+          mask, mask_color, rgb_byte_order, clip,
+          pdfium::as_writable_byte_span(dest));
+      ExpectComposited(done, expected, original, dest);
+
+      CFX_ScanlineCompositor compositor;
+      ASSERT_TRUE(compositor.Init(FXDIB_Format::kBgrx, FXDIB_Format::k8bppMask,
+                                  /*src_palette=*/{},
+                                  ArgbEncode(mask_color.alpha, mask_color.red,
+                                             mask_color.green, mask_color.blue),
+                                  BlendMode::kNormal, rgb_byte_order));
+      dest = original;
+      compositor.CompositeByteMaskLine(pdfium::as_writable_byte_span(dest),
+                                       mask, kWidth, clip);
+      ExpectPixelsEq(expected, dest);
+    }
+  }
+}
+
+#if defined(PDF_USE_SKIA)
+TEST(CompositeSimdTest, BgraPremul2BgraPremulNormal) {
+  const std::vector<Pixel> src = MakeSrc();
+  const std::vector<Pixel> original = MakeDest();
+  for (bool rgb_byte_order : {false, true}) {
+    SCOPED_TRACE(rgb_byte_order);
+    std::vector<Pixel> expected = original;
+    for (size_t i = 0; i < kWidth; ++i) {
+      const Pixel src_pixel = rgb_byte_order ? SwapRedBlue(src[i]) : src[i];
+      Pixel& pixel = expected[i];
+      if (pixel.alpha == 0) {
+        pixel = src_pixel;
+        continue;
+      }
+      const int in_alpha = 255 - src_pixel.alpha;
+      pixel.blue = src_pixel.blue + pixel.blue * in_alpha / 255;
+      pixel.green = src_pixel.green + pixel.green * in_alpha / 255;
+      pixel.red = src_pixel.red + pixel.red * in_alpha / 255;
+      pixel.alpha = AlphaUnion(pixel.alpha, src_pixel.alpha);
+    }
+
+    std::vector<Pixel> dest = original;
+    const size_t done = fxge::CompositeRowBgraPremul2BgraPremulNormal(
+        pdfium::as_byte_span(src), rgb_byte_order,
+        pdfium::as_writable_byte_span(dest));
+    ExpectComposited(done, expected, original, dest);
+
+    CFX_ScanlineCompositor compositor;
+    ASSERT_TRUE(compositor.Init(FXDIB_Format::kBgraPremul,
+                                FXDIB_Format::kBgraPremul, /*src_palette=*/{},
+                                /*mask_color=*/0, BlendMode::kNormal,
+                                rgb_byte_order));
+    dest = original;
+    compositor.CompositeRgbBitmapLine(pdfium::as_writable_byte_span(dest),
+                                      pdfium::as_byte_span(src), kWidth, {});
+    ExpectPixelsEq(expected, dest);
+  }
+}
+#endif  // defined(PDF_USE_SKIA)
+
+TEST(CompositeSimdTest, DisabledForTesting) {
+  const std::vector<Pixel> src = MakeSrc();
+  const std::vector<uint8_t> mask = MakeMask();
+  const std::vector<Pixel> original = MakeDest();
+  std::vector<Pixel> dest = original;
+
+  fxge::SetCompositeSimdEnabledForTesting(false);
+  EXPECT_EQ(0u, fxge::CompositeRowBgra2BgraNormal(
+                    pdfium::as_byte_span(src), /*clip=*/{},
+                    /*rgb_byte_order=*/false,
+                    pdfium::as_writable_byte_span(dest)));
+  EXPECT_EQ(0u, fxge::CompositeRowByteMask2BgraNormal(
+                    mask, {10, 120, 250, 200}, /*rgb_byte_order=*/false,
+                    /*clip=*/{}, pdfium::as_writable_byte_span(dest)));
+  EXPECT_EQ(0u, fxge::CompositeRowByteMask2BgrxNormal(
+                    mask, {10, 120, 250, 200}, /*rgb_byte_order=*/false,
+                    /*clip=*/{}, pdfium::as_writable_byte_span(dest)));
+  fxge::SetCompositeSimdEnabledForTesting(true);
+  ExpectPixelsEq(original, dest);
+}
@@ -9,10 +9,11 @@
 #include <math.h>
 
 #include <algorithm>
-#include <type_traits>
+#include <bit>
 #include <utility>
 
 #include "core/fxcrt/check.h"
+#include "core/fxcrt/check_op.h"
 #include "core/fxcrt/fx_safe_types.h"
 #include "core/fxcrt/fx_system.h"
 #include "core/fxcrt/pauseindicator_iface.h"
@@ -21,24 +22,53 @@
 #include "core/fxge/dib/cfx_dibitmap.h"
 #include "core/fxge/dib/fx_dib.h"
 #include "core/fxge/dib/scanlinecomposer_iface.h"
-
-static_assert(
-    std::is_trivially_destructible<CStretchEngine::PixelWeight>::value,
-    "PixelWeight storage may be re-used without invoking its destructor");
+#include "core/fxge/dib/stretch_simd.h"
 
 namespace {
 
+// Integer downscales up to this factor may use the box filter.
+constexpr int kMaxBoxSize = 256;
+
 size_t TotalBytesForWeightCount(size_t weight_count) {
-  // Always room for one weight even for empty ranges due to declaration
-  // of weights_[1] in the header. Don't shrink below this since
-  // CalculateWeights() relies on this later.
-  const size_t extra_weights = weight_count > 0 ? weight_count - 1 : 0;
-  FX_SAFE_SIZE_T total_bytes = extra_weights;
-  total_bytes *= sizeof(CStretchEngine::PixelWeight::weights_[0]);
+  FX_SAFE_SIZE_T total_bytes = weight_count;
+  total_bytes *= sizeof(uint32_t);
   total_bytes += sizeof(CStretchEngine::PixelWeight);
   return total_bytes.ValueOrDie();
 }
 
+// Returns the weight of each source pixel in a box of `box_size` pixels. Exact,
+// since `box_size` is a power of two.
+uint32_t GetBoxWeight(int box_size) {
+  return CStretchEngine::kFixedPointOne / box_size;
+}
+
+// Box filter version of the horizontal pass, for formats without alpha. Only
+// writes the color components of each destination pixel.
+void StretchRowHorzBox(pdfium::span<const uint8_t> src,
+                       int bytes_per_pixel,
+                       int box_size,
+                       int dest_min,
+                       int dest_max,
+                       pdfium::span<uint8_t> dest) {
+  const uint32_t box_weight = GetBoxWeight(box_size);
+  const size_t bpp = static_cast<size_t>(bytes_per_pixel);
+  const size_t color_bytes = std::min<size_t>(bpp, 3);
+  const size_t box_bytes = static_cast<size_t>(box_size) * bpp;
+  size_t dest_index = 0;
+  for (int col = dest_min; col < dest_max; ++col) {
+    pdfium::span<const uint8_t> box =
+        src.subspan(static_cast<size_t>(col) * box_bytes, box_bytes);
+    for (size_t i = 0; i < color_bytes; ++i) {
+      uint32_t sum = 0;
+      for (size_t j = i; j < box_bytes; j += bpp) {
+        sum += box[j];
+      }
+      dest[dest_index + i] = CStretchEngine::PixelFromFixed(sum * box_weight);
+    }
+    dest_index += bpp;
+  }
+}
+
 }  // namespace
 
 // static
@@ -73,9 +103,10 @@ bool CStretchEngine::WeightTable::CalculateWeights(
   const bool bilinear = options.bInterpolateBilinear;
 
   dest_min_ = 0;
-  item_size_bytes_ = 0;
-  weight_tables_size_bytes_ = 0;
-  weight_tables_.clear();
+  box_size_ = 0;
+  weight_count_ = 0;
+  pixel_weights_.clear();
+  weights_.clear();
   if (dest_len == 0) {
     return true;
   }
@@ -89,102 +120,140 @@ bool CStretchEngine::WeightTable::CalculateWeights(
   const double scale = static_cast<double>(src_len) / dest_len;
   const double base = dest_len < 0 ? src_len : 0;
   const size_t weight_count = static_cast<size_t>(ceil(fabs(scale))) + 1;
-  item_size_bytes_ = TotalBytesForWeightCount(weight_count);
+  const size_t item_size_bytes = TotalBytesForWeightCount(weight_count);
 
   const size_t dest_range = static_cast<size_t>(dest_max - dest_min);
-  const size_t kMaxTableItemsAllowed = kMaxTableBytesAllowed / item_size_bytes_;
+  const size_t kMaxTableItemsAllowed = kMaxTableBytesAllowed / item_size_bytes;
   if (dest_range > kMaxTableItemsAllowed) {
     return false;
   }
 
-  weight_tables_size_bytes_ = dest_range * item_size_bytes_;
-  weight_tables_.resize(weight_tables_size_bytes_);
-  UNSAFE_TODO({
-    if (options.bNoSmoothing || fabs(scale) < 1.0f) {
-      for (int dest_pixel = dest_min; dest_pixel < dest_max; ++dest_pixel) {
-        PixelWeight& pixel_weights = *GetPixelWeight(dest_pixel);
-        double src_pos = dest_pixel * scale + scale / 2 + base;
-        if (bilinear) {
-          int src_start = static_cast<int>(floor(src_pos - 0.5));
-          int src_end = static_cast<int>(floor(src_pos + 0.5));
-          src_start = std::max(src_start, src_min);
-          src_end = std::min(src_end, src_max - 1);
-          pixel_weights.SetStartEnd(src_start, src_end, weight_count);
-          if (pixel_weights.src_start_ >= pixel_weights.src_end_) {
-            // Always room for one weight per size calculation.
-            pixel_weights.weights_[0] = kFixedPointOne;
-          } else {
-            pixel_weights.weights_[1] =
-                FixedFromDouble(src_pos - pixel_weights.src_start_ - 0.5f);
-            pixel_weights.weights_[0] =
-                kFixedPointOne - pixel_weights.weights_[1];
-          }
+  weight_count_ = weight_count;
+  pixel_weights_.resize(dest_range);
+  weights_.resize(dest_range * weight_count);
+  if (options.bNoSmoothing || fabs(scale) < 1.0f) {
+    for (int dest_pixel = dest_min; dest_pixel < dest_max; ++dest_pixel) {
+      PixelWeight& pixel_weight = pixel_weights_[dest_pixel - dest_min];
+      pdfium::span<uint32_t> weights = GetWritableWeights(dest_pixel);
+      double src_pos = dest_pixel * scale + scale / 2 + base;
+      if (bilinear) {
+        int src_start = static_cast<int>(floor(src_pos - 0.5));
+        int src_end = static_cast<int>(floor(src_pos + 0.5));
+        src_start = std::max(src_start, src_min);
+        src_end = std::min(src_end, src_max - 1);
+        SetStartEnd(pixel_weight, src_start, src_end);
+        if (pixel_weight.src_start_ >= pixel_weight.src_end_) {
+          // Always room for one weight per size calculation.
+          weights[0] = kFixedPointOne;
         } else {
-          int pixel_pos = static_cast<int>(floor(src_pos));
-          int src_start = std::max(pixel_pos, src_min);
-          int src_end = std::min(pixel_pos, src_max - 1);
-          pixel_weights.SetStartEnd(src_start, src_end, weight_count);
-          pixel_weights.weights_[0] = kFixedPointOne;
+          weights[1] =
+              FixedFromDouble(src_pos - pixel_weight.src_start_ - 0.5f);
+          weights[0] = kFixedPointOne - weights[1];
         }
+      } else {
+        int pixel_pos = static_cast<int>(floor(src_pos));
+        int src_start = std::max(pixel_pos, src_min);
+        int src_end = std::min(pixel_pos, src_max - 1);
+        SetStartEnd(pixel_weight, src_start, src_end);
+        weights[0] = kFixedPointOne;
       }
-      return true;
     }
+    return true;
+  }
 
-    for (int dest_pixel = dest_min; dest_pixel < dest_max; ++dest_pixel) {
-      PixelWeight& pixel_weights = *GetPixelWeight(dest_pixel);
-      double src_start = dest_pixel * scale + base;
-      double src_end = src_start + scale;
-      int start_i = floor(std::min(src_start, src_end));
-      int end_i = floor(std::max(src_start, src_end));
-      start_i = std::max(start_i, src_min);
-      end_i = std::min(end_i, src_max - 1);
-      if (start_i > end_i) {
-        start_i = std::min(start_i, src_max - 1);
-        pixel_weights.SetStartEnd(start_i, start_i, weight_count);
-        continue;
-      }
-      pixel_weights.SetStartEnd(start_i, end_i, weight_count);
-      uint32_t remaining = kFixedPointOne;
-      double rounding_error = 0.0;
-      for (int j = start_i; j < end_i; ++j) {
-        double dest_start = (j - base) / scale;
-        double dest_end = (j + 1 - base) / scale;
-        if (dest_start > dest_end) {
-          std::swap(dest_start, dest_end);
-        }
-        double area_start =
-            std::max(dest_start, static_cast<double>(dest_pixel));
-        double area_end =
-            std::min(dest_end, static_cast<double>(dest_pixel + 1));
-        double weight = std::max(0.0, area_end - area_start);
-        uint32_t fixed_weight = FixedFromDouble(weight + rounding_error);
-        pixel_weights.SetWeightForPosition(j, fixed_weight);
-        remaining -= fixed_weight;
-        rounding_error =
-            weight - static_cast<double>(fixed_weight) / kFixedPointOne;
-      }
-      // Note: underflow is defined behaviour for unsigned types and will
-      // result in an out-of-range value.
-      if (remaining && remaining <= kFixedPointOne) {
-        pixel_weights.SetWeightForPosition(end_i, remaining);
-      } else {
-        pixel_weights.RemoveLastWeightAndAdjust(remaining);
+  for (int dest_pixel = dest_min; dest_pixel < dest_max; ++dest_pixel) {
+    PixelWeight& pixel_weight = pixel_weights_[dest_pixel - dest_min];
+    pdfium::span<uint32_t> weights = GetWritableWeights(dest_pixel);
+    double src_start = dest_pixel * scale + base;
+    double src_end = src_start + scale;
+    int start_i = floor(std::min(src_start, src_end));
+    int end_i = floor(std::max(src_start, src_end));
+    start_i = std::max(start_i, src_min);
+    end_i = std::min(end_i, src_max - 1);
+    if (start_i > end_i) {
+      start_i = std::min(start_i, src_max - 1);
+      SetStartEnd(pixel_weight, start_i, start_i);
+      continue;
+    }
+    SetStartEnd(pixel_weight, start_i, end_i);
+    uint32_t remaining = kFixedPointOne;
+    double rounding_error = 0.0;
+    for (int j = start_i; j < end_i; ++j) {
+      double dest_start = (j - base) / scale;
+      double dest_end = (j + 1 - base) / scale;
+      if (dest_start > dest_end) {
+        std::swap(dest_start, dest_end);
       }
+      double area_start = std::max(dest_start, static_cast<double>(dest_pixel));
+      double area_end = std::min(dest_end, static_cast<double>(dest_pixel + 1));
+      double weight = std::max(0.0, area_end - area_start);
+      uint32_t fixed_weight = FixedFromDouble(weight + rounding_error);
+      weights[j - start_i] = fixed_weight;
+      remaining -= fixed_weight;
+      rounding_error =
+          weight - static_cast<double>(fixed_weight) / kFixedPointOne;
+    }
+    // Note: underflow is defined behaviour for unsigned types and will
+    // result in an out-of-range value.
+    if (remaining && remaining <= kFixedPointOne) {
+      weights[end_i - start_i] = remaining;
+    } else {
+      // Drops the last position, and adjusts the weight of the position
+      // before it. Relies on unsigned overflow to decrement it, as needed.
+      CHECK_GT(end_i, start_i);
+      --pixel_weight.src_end_;
+      weights[end_i - start_i - 1] += remaining;
+    }
+  }
+
+  // An integer downscale averages whole, non-overlapping boxes of source
+  // pixels, so the stretch passes can skip the per-pixel weights. Only power
+  // of two boxes get the same weight for every source pixel in the table
+  // above. Other sizes spread the rounding error over the box, and a single
+  // box weight would not give the same results.
+  if (dest_len > 0 && src_len % dest_len == 0) {
+    const int box_size = src_len / dest_len;
+    if (box_size >= 2 && box_size <= kMaxBoxSize &&
+        std::has_single_bit(static_cast<unsigned>(box_size)) &&
+        static_cast<int64_t>(dest_min) * box_size >= src_min &&
+        static_cast<int64_t>(dest_max) * box_size <= src_max) {
+      box_size_ = box_size;
     }
-  });
+  }
   return true;
 }
 
 const CStretchEngine::PixelWeight* CStretchEngine::WeightTable::GetPixelWeight(
     int pixel) const {
   DCHECK(pixel >= dest_min_);
-  return reinterpret_cast<const PixelWeight*>(
-      &weight_tables_[(pixel - dest_min_) * item_size_bytes_]);
+  return &pixel_weights_[pixel - dest_min_];
+}
+
+pdfium::span<const uint32_t> CStretchEngine::WeightTable::GetWeights(
+    int pixel) const {
+  const PixelWeight& pixel_weight = *GetPixelWeight(pixel);
+  const size_t count =
+      pixel_weight.src_end_ >= pixel_weight.src_start_
+          ? static_cast<size_t>(pixel_weight.src_end_ -
+                                pixel_weight.src_start_ + 1)
+          : 0;
+  return pdfium::span(weights_).subspan(
+      static_cast<size_t>(pixel - dest_min_) * weight_count_, count);
+}
+
+void CStretchEngine::WeightTable::SetStartEnd(PixelWeight& pixel_weight,
+                                              int src_start,
+                                              int src_end) {
+  CHECK_LT(src_end - src_start, static_cast<int>(weight_count_));
+  pixel_weight.src_start_ = src_start;
+  pixel_weight.src_end_ = src_end;
 }
 
-CStretchEngine::PixelWeight* CStretchEngine::WeightTable::GetPixelWeight(
+pdfium::span<uint32_t> CStretchEngine::WeightTable::GetWritableWeights(
     int pixel) {
-  return const_cast<PixelWeight*>(std::as_const(*this).GetPixelWeight(pixel));
+  DCHECK(pixel >= dest_min_);
+  return pdfium::span(weights_).subspan(
+      static_cast<size_t>(pixel - dest_min_) * weight_count_, weight_count_);
 }
 
 CStretchEngine::CStretchEngine(ScanlineComposerIface* pDestBitmap,
@@ -322,6 +391,7 @@ bool CStretchEngine::ContinueStretchHorz(PauseIndicatorIface* pPause) {
   }
 
   int Bpp = dest_bpp_ / 8;
+  const int box_size = weight_table_.box_size();
   static const int kStrechPauseRows = 10;
   int rows_to_go = kStrechPauseRows;
   for (; cur_row_ < src_clip_.bottom; ++cur_row_) {
@@ -333,112 +403,82 @@ bool CStretchEngine::ContinueStretchHorz(PauseIndicatorIface* pPause) {
       rows_to_go = kStrechPauseRows;
     }
 
-    const uint8_t* src_scan = source_->GetScanline(cur_row_).data();
+    pdfium::span<const uint8_t> src_scan = source_->GetScanline(cur_row_);
     pdfium::span<uint8_t> dest_span = inter_buf_.subspan(
         (cur_row_ - src_clip_.top) * inter_pitch_, inter_pitch_);
     size_t dest_span_index = 0;
-    // TODO(npm): reduce duplicated code here
-    UNSAFE_TODO({
-      switch (trans_method_) {
-        case TransformMethod::k1BppTo8Bpp:
-        case TransformMethod::k1BppToManyBpp: {
-          for (int col = dest_clip_.left; col < dest_clip_.right; ++col) {
-            PixelWeight* pWeights = weight_table_.GetPixelWeight(col);
-            uint32_t dest_a = 0;
-            for (int j = pWeights->src_start_; j <= pWeights->src_end_; ++j) {
-              uint32_t pixel_weight = pWeights->GetWeightForPosition(j);
-              if (src_scan[j / 8] & (1 << (7 - j % 8))) {
-                dest_a += pixel_weight * 255;
-              }
+    switch (trans_method_) {
+      case TransformMethod::k1BppTo8Bpp:
+      case TransformMethod::k1BppToManyBpp: {
+        for (int col = dest_clip_.left; col < dest_clip_.right; ++col) {
+          const PixelWeight* pWeights = weight_table_.GetPixelWeight(col);
+          pdfium::span<const uint32_t> weights = weight_table_.GetWeights(col);
+          uint32_t dest_a = 0;
+          for (int j = pWeights->src_start_; j <= pWeights->src_end_; ++j) {
+            uint32_t pixel_weight = weights[j - pWeights->src_start_];
+            if (src_scan[j / 8] & (1 << (7 - j % 8))) {
+              dest_a += pixel_weight * 255;
             }
-            dest_span[dest_span_index++] = PixelFromFixed(dest_a);
           }
-          break;
+          dest_span[dest_span_index++] = PixelFromFixed(dest_a);
         }
-        case TransformMethod::k8BppTo8Bpp: {
-          for (int col = dest_clip_.left; col < dest_clip_.right; ++col) {
-            PixelWeight* pWeights = weight_table_.GetPixelWeight(col);
-            uint32_t dest_a = 0;
-            for (int j = pWeights->src_start_; j <= pWeights->src_end_; ++j) {
-              uint32_t pixel_weight = pWeights->GetWeightForPosition(j);
-              dest_a += pixel_weight * src_scan[j];
-            }
-            dest_span[dest_span_index++] = PixelFromFixed(dest_a);
-          }
+        break;
+      }
+      case TransformMethod::k8BppTo8Bpp: {
+        if (box_size) {
+          StretchRowHorzBox(src_scan, 1, box_size, dest_clip_.left,
+                            dest_clip_.right, dest_span);
           break;
         }
-        case TransformMethod::k8BppToManyBpp: {
-          for (int col = dest_clip_.left; col < dest_clip_.right; ++col) {
-            PixelWeight* pWeights = weight_table_.GetPixelWeight(col);
-            uint32_t dest_r = 0;
-            uint32_t dest_g = 0;
-            uint32_t dest_b = 0;
-            for (int j = pWeights->src_start_; j <= pWeights->src_end_; ++j) {
-              uint32_t pixel_weight = pWeights->GetWeightForPosition(j);
-              FX_ARGB argb = src_palette_[src_scan[j]];
-              if (dest_format_ == FXDIB_Format::kBgr) {
-                dest_r += pixel_weight * static_cast<uint8_t>(argb >> 16);
-                dest_g += pixel_weight * static_cast<uint8_t>(argb >> 8);
-                dest_b += pixel_weight * static_cast<uint8_t>(argb);
-              } else {
-                dest_b += pixel_weight * static_cast<uint8_t>(argb >> 24);
-                dest_g += pixel_weight * static_cast<uint8_t>(argb >> 16);
-                dest_r += pixel_weight * static_cast<uint8_t>(argb >> 8);
-              }
+        fxge::StretchRowHorzGray(src_scan, weight_table_, dest_clip_.left,
+                                 dest_clip_.right, dest_span);
+        break;
+      }
+      case TransformMethod::k8BppToManyBpp: {
+        for (int col = dest_clip_.left; col < dest_clip_.right; ++col) {
+          const PixelWeight* pWeights = weight_table_.GetPixelWeight(col);
+          pdfium::span<const uint32_t> weights = weight_table_.GetWeights(col);
+          uint32_t dest_r = 0;
+          uint32_t dest_g = 0;
+          uint32_t dest_b = 0;
+          for (int j = pWeights->src_start_; j <= pWeights->src_end_; ++j) {
+            uint32_t pixel_weight = weights[j - pWeights->src_start_];
+            FX_ARGB argb = src_palette_[src_scan[j]];
+            if (dest_format_ == FXDIB_Format::kBgr) {
+              dest_r += pixel_weight * static_cast<uint8_t>(argb >> 16);
+              dest_g += pixel_weight * static_cast<uint8_t>(argb >> 8);
+              dest_b += pixel_weight * static_cast<uint8_t>(argb);
+            } else {
+              dest_b += pixel_weight * static_cast<uint8_t>(argb >> 24);
+              dest_g += pixel_weight * static_cast<uint8_t>(argb >> 16);
+              dest_r += pixel_weight * static_cast<uint8_t>(argb >> 8);
             }
-            dest_span[dest_span_index++] = PixelFromFixed(dest_b);
-            dest_span[dest_span_index++] = PixelFromFixed(dest_g);
-            dest_span[dest_span_index++] = PixelFromFixed(dest_r);
           }
-          break;
+          dest_span[dest_span_index++] = PixelFromFixed(dest_b);
+          dest_span[dest_span_index++] = PixelFromFixed(dest_g);
+          dest_span[dest_span_index++] = PixelFromFixed(dest_r);
         }
-        case TransformMethod::kManyBpptoManyBpp: {
-          for (int col = dest_clip_.left; col < dest_clip_.right; ++col) {
-            PixelWeight* pWeights = weight_table_.GetPixelWeight(col);
-            uint32_t dest_r = 0;
-            uint32_t dest_g = 0;
-            uint32_t dest_b = 0;
-            for (int j = pWeights->src_start_; j <= pWeights->src_end_; ++j) {
-              uint32_t pixel_weight = pWeights->GetWeightForPosition(j);
-              const uint8_t* src_pixel = src_scan + j * Bpp;
-              dest_b += pixel_weight * (*src_pixel++);
-              dest_g += pixel_weight * (*src_pixel++);
-              dest_r += pixel_weight * (*src_pixel);
-            }
-            dest_span[dest_span_index++] = PixelFromFixed(dest_b);
-            dest_span[dest_span_index++] = PixelFromFixed(dest_g);
-            dest_span[dest_span_index++] = PixelFromFixed(dest_r);
-            dest_span_index += Bpp - 3;
-          }
-          break;
-        }
-        case TransformMethod::kManyBpptoManyBppWithAlpha: {
-          DCHECK(has_alpha_);
-          for (int col = dest_clip_.left; col < dest_clip_.right; ++col) {
-            PixelWeight* pWeights = weight_table_.GetPixelWeight(col);
-            uint32_t dest_a = 0;
-            uint32_t dest_r = 0;
-            uint32_t dest_g = 0;
-            uint32_t dest_b = 0;
-            for (int j = pWeights->src_start_; j <= pWeights->src_end_; ++j) {
-              const uint8_t* src_pixel = src_scan + j * Bpp;
-              uint32_t pixel_weight =
-                  pWeights->GetWeightForPosition(j) * src_pixel[3] / 255;
-              dest_b += pixel_weight * (*src_pixel++);
-              dest_g += pixel_weight * (*src_pixel++);
-              dest_r += pixel_weight * (*src_pixel);
-              dest_a += pixel_weight;
-            }
-            dest_span[dest_span_index++] = PixelFromFixed(dest_b);
-            dest_span[dest_span_index++] = PixelFromFixed(dest_g);
-            dest_span[dest_span_index++] = PixelFromFixed(dest_r);
-            dest_span[dest_span_index] = PixelFromFixed(255 * dest_a);
-            dest_span_index += Bpp - 3;
-          }
+        break;
+      }
+      case TransformMethod::kManyBpptoManyBpp: {
+        if (box_size) {
+          StretchRowHorzBox(src_scan, Bpp, box_size, dest_clip_.left,
+                            dest_clip_.right, dest_span);
           break;
         }
+        fxge::StretchRowHorzRgb(src_scan, Bpp, /*has_alpha=*/false,
+                                weight_table_, dest_clip_.left,
+                                dest_clip_.right, dest_span);
+        break;
       }
-    });
+      case TransformMethod::kManyBpptoManyBppWithAlpha: {
+        DCHECK(has_alpha_);
+        fxge::StretchRowHorzRgb(src_scan, Bpp, /*has_alpha=*/true,
+                                weight_table_, dest_clip_.left,
+                                dest_clip_.right, dest_span);
+        break;
+      }
+    }
     rows_to_go--;
   }
   return false;
@@ -457,86 +497,80 @@ void CStretchEngine::StretchVert() {
   }
 
   const int DestBpp = dest_bpp_ / 8;
-  UNSAFE_TODO({
-    for (int row = dest_clip_.top; row < dest_clip_.bottom; ++row) {
-      unsigned char* dest_scan = dest_scanline_.data();
-      PixelWeight* pWeights = table.GetPixelWeight(row);
-      switch (trans_method_) {
-        case TransformMethod::k1BppTo8Bpp:
-        case TransformMethod::k1BppToManyBpp:
-        case TransformMethod::k8BppTo8Bpp: {
-          for (int col = dest_clip_.left; col < dest_clip_.right; ++col) {
-            pdfium::span<const uint8_t> src_span =
-                inter_buf_.subspan((col - dest_clip_.left) * DestBpp);
-            uint32_t dest_a = 0;
-            for (int j = pWeights->src_start_; j <= pWeights->src_end_; ++j) {
-              uint32_t pixel_weight = pWeights->GetWeightForPosition(j);
-              dest_a +=
-                  pixel_weight * src_span[(j - src_clip_.top) * inter_pitch_];
-            }
-            *dest_scan = PixelFromFixed(dest_a);
-            dest_scan += DestBpp;
-          }
-          break;
+  const size_t row_bytes = static_cast<size_t>(dest_clip_.Width()) * DestBpp;
+  const int box_size = table.box_size();
+  // Weighted sums of the intermediate rows for one destination row, one per
+  // byte.
+  DataVector<uint32_t> sums(row_bytes);
+  for (int row = dest_clip_.top; row < dest_clip_.bottom; ++row) {
+    std::fill(sums.begin(), sums.end(), 0);
+    if (box_size) {
+      const uint32_t box_weight = GetBoxWeight(box_size);
+      for (int j = row * box_size; j < (row + 1) * box_size; ++j) {
+        fxge::AccumulateWeightedRow(GetInterRow(j, row_bytes), box_weight,
+                                    sums);
+      }
+    } else {
+      const PixelWeight* pWeights = table.GetPixelWeight(row);
+      pdfium::span<const uint32_t> weights = table.GetWeights(row);
+      for (int j = pWeights->src_start_; j <= pWeights->src_end_; ++j) {
+        fxge::AccumulateWeightedRow(GetInterRow(j, row_bytes),
+                                    weights[j - pWeights->src_start_], sums);
+      }
+    }
+    pdfium::span<uint8_t> dest_scan(dest_scanline_);
+    switch (trans_method_) {
+      case TransformMethod::k1BppTo8Bpp:
+      case TransformMethod::k1BppToManyBpp:
+      case TransformMethod::k8BppTo8Bpp: {
+        for (int col = dest_clip_.left; col < dest_clip_.right; ++col) {
+          const size_t offset = (col - dest_clip_.left) * DestBpp;
+          dest_scan[offset] = PixelFromFixed(sums[offset]);
         }
-        case TransformMethod::k8BppToManyBpp:
-        case TransformMethod::kManyBpptoManyBpp: {
-          for (int col = dest_clip_.left; col < dest_clip_.right; ++col) {
-            pdfium::span<const uint8_t> src_span =
-                inter_buf_.subspan((col - dest_clip_.left) * DestBpp);
-            uint32_t dest_r = 0;
-            uint32_t dest_g = 0;
-            uint32_t dest_b = 0;
-            for (int j = pWeights->src_start_; j <= pWeights->src_end_; ++j) {
-              uint32_t pixel_weight = pWeights->GetWeightForPosition(j);
-              pdfium::span<const uint8_t> src_pixel = src_span.subspan(
-                  static_cast<size_t>((j - src_clip_.top) * inter_pitch_), 3u);
-              dest_b += pixel_weight * src_pixel[0];
-              dest_g += pixel_weight * src_pixel[1];
-              dest_r += pixel_weight * src_pixel[2];
-            }
-            dest_scan[0] = PixelFromFixed(dest_b);
-            dest_scan[1] = PixelFromFixed(dest_g);
-            dest_scan[2] = PixelFromFixed(dest_r);
-            dest_scan += DestBpp;
-          }
-          break;
+        break;
+      }
+      case TransformMethod::k8BppToManyBpp:
+      case TransformMethod::kManyBpptoManyBpp: {
+        for (int col = dest_clip_.left; col < dest_clip_.right; ++col) {
+          const size_t offset = (col - dest_clip_.left) * DestBpp;
+          pdfium::span<const uint32_t> pixel_sums =
+              pdfium::span(sums).subspan(offset, 3u);
+          pdfium::span<uint8_t> dest_pixel = dest_scan.subspan(offset, 3u);
+          dest_pixel[0] = PixelFromFixed(pixel_sums[0]);
+          dest_pixel[1] = PixelFromFixed(pixel_sums[1]);
+          dest_pixel[2] = PixelFromFixed(pixel_sums[2]);
         }
-        case TransformMethod::kManyBpptoManyBppWithAlpha: {
-          DCHECK(has_alpha_);
-          for (int col = dest_clip_.left; col < dest_clip_.right; ++col) {
-            pdfium::span<const uint8_t> src_span =
-                inter_buf_.subspan((col - dest_clip_.left) * DestBpp);
-            uint32_t dest_a = 0;
-            uint32_t dest_r = 0;
-            uint32_t dest_g = 0;
-            uint32_t dest_b = 0;
-            static constexpr size_t kPixelBytes = 4;
-            for (int j = pWeights->src_start_; j <= pWeights->src_end_; ++j) {
-              uint32_t pixel_weight = pWeights->GetWeightForPosition(j);
-              pdfium::span<const uint8_t> src_pixel = src_span.subspan(
-                  static_cast<size_t>((j - src_clip_.top) * inter_pitch_),
-                  kPixelBytes);
-              dest_b += pixel_weight * src_pixel[0];
-              dest_g += pixel_weight * src_pixel[1];
-              dest_r += pixel_weight * src_pixel[2];
-              dest_a += pixel_weight * src_pixel[3];
-            }
-            if (dest_a) {
-              int r = static_cast<uint32_t>(dest_r) * 255 / dest_a;
-              int g = static_cast<uint32_t>(dest_g) * 255 / dest_a;
-              int b = static_cast<uint32_t>(dest_b) * 255 / dest_a;
-              dest_scan[0] = std::clamp(b, 0, 255);
-              dest_scan[1] = std::clamp(g, 0, 255);
-              dest_scan[2] = std::clamp(r, 0, 255);
-            }
-            dest_scan[3] = PixelFromFixed(dest_a);
-            dest_scan += DestBpp;
+        break;
+      }
+      case TransformMethod::kManyBpptoManyBppWithAlpha: {
+        DCHECK(has_alpha_);
+        static constexpr size_t kPixelBytes = 4;
+        for (int col = dest_clip_.left; col < dest_clip_.right; ++col) {
+          const size_t offset = (col - dest_clip_.left) * DestBpp;
+          pdfium::span<const uint32_t> pixel_sums =
+              pdfium::span(sums).subspan(offset, kPixelBytes);
+          pdfium::span<uint8_t> dest_pixel =
+              dest_scan.subspan(offset, kPixelBytes);
+          const uint32_t dest_a = pixel_sums[3];
+          if (dest_a) {
+            int r = pixel_sums[2] * 255 / dest_a;
+            int g = pixel_sums[1] * 255 / dest_a;
+            int b = pixel_sums[0] * 255 / dest_a;
+            dest_pixel[0] = std::clamp(b, 0, 255);
+            dest_pixel[1] = std::clamp(g, 0, 255);
+            dest_pixel[2] = std::clamp(r, 0, 255);
           }
-          break;
+          dest_pixel[3] = PixelFromFixed(dest_a);
         }
+        break;
       }
-      dest_bitmap_->ComposeScanline(row - dest_clip_.top, dest_scanline_);
     }
-  });
+    dest_bitmap_->ComposeScanline(row - dest_clip_.top, dest_scanline_);
+  }
+}
+
+pdfium::span<const uint8_t> CStretchEngine::GetInterRow(int src_row,
+                                                        size_t size) const {
+  return inter_buf_.subspan(
+      static_cast<size_t>(src_row - src_clip_.top) * inter_pitch_, size);
 }
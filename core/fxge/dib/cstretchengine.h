@@ -9,13 +9,15 @@
 
 #include <stdint.h>
 
-#include "core/fxcrt/check_op.h"
+#include <vector>
+
 #include "core/fxcrt/data_vector.h"
 #include "core/fxcrt/fixed_size_data_vector.h"
 #include "core/fxcrt/fx_coordinates.h"
 #include "core/fxcrt/fx_system.h"
 #include "core/fxcrt/raw_span.h"
 #include "core/fxcrt/retain_ptr.h"
+#include "core/fxcrt/span.h"
 #include "core/fxcrt/unowned_ptr.h"
 #include "core/fxge/dib/fx_dib.h"
 
@@ -44,41 +46,15 @@ class CStretchEngine {
                                      int src_width,
                                      int src_height);
 
+  // Source range of one destination pixel. The weights for the range live in
+  // WeightTable.
   struct PixelWeight {
-    void SetStartEnd(int src_start, int src_end, size_t weight_count) {
-      CHECK_LT(src_end - src_start, static_cast<int>(weight_count));
-      src_start_ = src_start;
-      src_end_ = src_end;
-    }
-
-    uint32_t GetWeightForPosition(int position) const {
-      CHECK_GE(position, src_start_);
-      CHECK_LE(position, src_end_);
-      // SAFETY: enforced by checks above.
-      return UNSAFE_BUFFERS(weights_[position - src_start_]);
-    }
-
-    void SetWeightForPosition(int position, uint32_t weight) {
-      CHECK_GE(position, src_start_);
-      CHECK_LE(position, src_end_);
-      // SAFETY: enforced by checks above.
-      UNSAFE_BUFFERS(weights_[position - src_start_] = weight);
-    }
-
-    // NOTE: relies on defined behaviour for unsigned overflow to
-    // decrement the previous position, as needed.
-    void RemoveLastWeightAndAdjust(uint32_t weight_change) {
-      CHECK_GT(src_end_, src_start_);
-      --src_end_;
-      // SAFETY: enforced by checks above.
-      UNSAFE_BUFFERS(weights_[src_end_ - src_start_] += weight_change);
-    }
-
     int src_start_;
-    int src_end_;          // Note: inclusive, [0, -1] for empty range at 0.
-    uint32_t weights_[1];  // Not really 1, variable size.
+    int src_end_;  // Note: inclusive, [0, -1] for empty range at 0.
   };
 
+  // Stores the weights of all destination pixels in one array, a fixed number
+  // of slots per pixel, so the stretch passes can load them contiguously.
   class WeightTable {
    public:
     WeightTable();
@@ -95,13 +71,26 @@ class CStretchEngine {
                           const FXDIB_ResampleOptions& options);
 
     const PixelWeight* GetPixelWeight(int pixel) const;
-    PixelWeight* GetPixelWeight(int pixel);
+
+    // Returns the weights for positions `src_start_` through `src_end_` of
+    // `pixel`.
+    pdfium::span<const uint32_t> GetWeights(int pixel) const;
+
+    // Returns the number of source pixels that each destination pixel averages
+    // when the table is a plain box filter over a power of two downscale, or 0
+    // otherwise. In that case, destination pixel `i` covers source pixels
+    // `i * box size` up to, but not including, `(i + 1) * box size`.
+    int box_size() const { return box_size_; }
 
    private:
+    void SetStartEnd(PixelWeight& pixel_weight, int src_start, int src_end);
+    pdfium::span<uint32_t> GetWritableWeights(int pixel);
+
     int dest_min_ = 0;
-    size_t item_size_bytes_ = 0;
-    size_t weight_tables_size_bytes_ = 0;
-    DataVector<uint8_t> weight_tables_;
+    int box_size_ = 0;
+    size_t weight_count_ = 0;
+    std::vector<PixelWeight> pixel_weights_;
+    DataVector<uint32_t> weights_;
   };
 
   CStretchEngine(ScanlineComposerIface* pDestBitmap,
@@ -134,6 +123,9 @@ class CStretchEngine {
     kManyBpptoManyBppWithAlpha
   };
 
+  // Returns the first `size` bytes of the intermediate row for `src_row`.
+  pdfium::span<const uint8_t> GetInterRow(int src_row, size_t size) const;
+
   const FXDIB_Format dest_format_;
   const int dest_bpp_;
   const int src_bpp_;
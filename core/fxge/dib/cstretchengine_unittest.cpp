@@ -4,12 +4,19 @@
 
 #include "core/fxge/dib/cstretchengine.h"
 
+#include <stdlib.h>
+
+#include <algorithm>
 #include <utility>
+#include <vector>
 
 #include "core/fpdfapi/page/cpdf_dib.h"
 #include "core/fpdfapi/parser/cpdf_dictionary.h"
 #include "core/fpdfapi/parser/cpdf_number.h"
 #include "core/fpdfapi/parser/cpdf_stream.h"
+#include "core/fxcrt/retain_ptr.h"
+#include "core/fxcrt/span.h"
+#include "core/fxge/dib/cfx_dibitmap.h"
 #include "core/fxge/dib/fx_dib.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -19,10 +26,10 @@ namespace {
 constexpr uint32_t kTooBigSrcLen = 20;
 constexpr uint32_t kTooBigDestLen = 32 * 1024 * 1024 + 1;
 
-uint32_t PixelWeightSum(const CStretchEngine::PixelWeight* weights) {
+uint32_t PixelWeightSum(pdfium::span<const uint32_t> weights) {
   uint32_t sum = 0;
-  for (int i = weights->src_start_; i <= weights->src_end_; ++i) {
-    sum += weights->GetWeightForPosition(i);
+  for (uint32_t weight : weights) {
+    sum += weight;
   }
   return sum;
 }
@@ -35,7 +42,7 @@ void ExecuteOneStretchTest(int32_t dest_width,
   ASSERT_TRUE(table.CalculateWeights(dest_width, 0, dest_width, src_width, 0,
                                      src_width, options));
   for (int32_t i = 0; i < dest_width; ++i) {
-    EXPECT_EQ(kExpectedSum, PixelWeightSum(table.GetPixelWeight(i)))
+    EXPECT_EQ(kExpectedSum, PixelWeightSum(table.GetWeights(i)))
         << "for { " << src_width << ", " << dest_width << " } at " << i;
   }
 }
@@ -48,7 +55,7 @@ void ExecuteOneReversedStretchTest(int32_t dest_width,
   ASSERT_TRUE(table.CalculateWeights(-dest_width, 0, dest_width, src_width, 0,
                                      src_width, options));
   for (int32_t i = 0; i < dest_width; ++i) {
-    EXPECT_EQ(kExpectedSum, PixelWeightSum(table.GetPixelWeight(i)))
+    EXPECT_EQ(kExpectedSum, PixelWeightSum(table.GetWeights(i)))
         << "for { " << src_width << ", " << dest_width << " } at " << i
         << " (reversed)";
   }
@@ -66,6 +73,86 @@ void ExecuteStretchTests(const FXDIB_ResampleOptions& options) {
   }
 }
 
+// Stretches `src` using the per-pixel weights of CStretchEngine::WeightTable,
+// one byte at a time, for the color bytes of each pixel.
+std::vector<uint8_t> StretchReference(const CFX_DIBitmap& src,
+                                      int dest_width,
+                                      int dest_height) {
+  const int bpp = src.GetBPP() / 8;
+  const int color_bytes = std::min(bpp, 3);
+  FXDIB_ResampleOptions options;
+  CStretchEngine::WeightTable horz;
+  CStretchEngine::WeightTable vert;
+  EXPECT_TRUE(horz.CalculateWeights(dest_width, 0, dest_width, src.GetWidth(),
+                                    0, src.GetWidth(), options));
+  EXPECT_TRUE(vert.CalculateWeights(dest_height, 0, dest_height,
+                                    src.GetHeight(), 0, src.GetHeight(),
+                                    options));
+  const size_t inter_pitch = static_cast<size_t>(dest_width) * bpp;
+  std::vector<uint8_t> inter(inter_pitch * src.GetHeight());
+  for (int row = 0; row < src.GetHeight(); ++row) {
+    pdfium::span<const uint8_t> src_scan = src.GetScanline(row);
+    for (int col = 0; col < dest_width; ++col) {
+      const int src_start = horz.GetPixelWeight(col)->src_start_;
+      pdfium::span<const uint32_t> weights = horz.GetWeights(col);
+      for (int c = 0; c < color_bytes; ++c) {
+        uint32_t sum = 0;
+        for (size_t i = 0; i < weights.size(); ++i) {
+          sum += weights[i] * src_scan[(src_start + i) * bpp + c];
+        }
+        inter[row * inter_pitch + col * bpp + c] =
+            CStretchEngine::PixelFromFixed(sum);
+      }
+    }
+  }
+  std::vector<uint8_t> dest(inter_pitch * dest_height);
+  for (int row = 0; row < dest_height; ++row) {
+    const int src_start = vert.GetPixelWeight(row)->src_start_;
+    pdfium::span<const uint32_t> weights = vert.GetWeights(row);
+    for (size_t offset = 0; offset < inter_pitch; ++offset) {
+      uint32_t sum = 0;
+      for (size_t i = 0; i < weights.size(); ++i) {
+        sum += weights[i] * inter[(src_start + i) * inter_pitch + offset];
+      }
+      dest[row * inter_pitch + offset] = CStretchEngine::PixelFromFixed(sum);
+    }
+  }
+  return dest;
+}
+
+// Returns the largest difference between the color bytes of `expected` and
+// the pixels of `actual`.
+int MaxStretchError(pdfium::span<const uint8_t> expected,
+                    const CFX_DIBitmap& actual) {
+  const int bpp = actual.GetBPP() / 8;
+  const size_t pitch = static_cast<size_t>(actual.GetWidth()) * bpp;
+  int max_error = 0;
+  for (int row = 0; row < actual.GetHeight(); ++row) {
+    pdfium::span<const uint8_t> scan = actual.GetScanline(row);
+    for (size_t offset = 0; offset < pitch; ++offset) {
+      if (offset % bpp < 3) {
+        max_error = std::max(
+            max_error, abs(expected[row * pitch + offset] - scan[offset]));
+      }
+    }
+  }
+  return max_error;
+}
+
+RetainPtr<CFX_DIBitmap> MakeStretchSource(FXDIB_Format format) {
+  // Divisible by 3, 4, 5 and 8.
+  static constexpr int kSize = 120;
+  auto bitmap = pdfium::MakeRetain<CFX_DIBitmap>();
+  EXPECT_TRUE(bitmap->Create(kSize, kSize, format));
+  for (int row = 0; row < kSize; ++row) {
+    pdfium::span<uint8_t> scan = bitmap->GetWritableScanline(row);
+    for (size_t i = 0; i < scan.size(); ++i) {
+      scan[i] = static_cast<uint8_t>(row * 29 + i * 13 + (i * row >> 4));
+    }
+  }
+  return bitmap;
+}
+
 }  // namespace
 
 TEST(CStretchEngine, OverflowInCtor) {
@@ -150,3 +237,67 @@ TEST(CStretchEngine, TooManyWeights) {
                                       kTooBigSrcLen, 0, kTooBigSrcLen,
                                       options));
 }
+
+TEST(CStretchEngine, BoxSize) {
+  FXDIB_ResampleOptions options;
+  CStretchEngine::WeightTable table;
+  ASSERT_TRUE(table.CalculateWeights(100, 0, 100, 400, 0, 400, options));
+  EXPECT_EQ(4, table.box_size());
+  ASSERT_TRUE(table.CalculateWeights(100, 10, 20, 800, 80, 160, options));
+  EXPECT_EQ(8, table.box_size());
+
+  // Integer downscales by other factors.
+  ASSERT_TRUE(table.CalculateWeights(100, 0, 100, 300, 0, 300, options));
+  EXPECT_EQ(0, table.box_size());
+  ASSERT_TRUE(table.CalculateWeights(100, 0, 100, 500, 0, 500, options));
+  EXPECT_EQ(0, table.box_size());
+
+  // Not an integer downscale.
+  ASSERT_TRUE(table.CalculateWeights(100, 0, 100, 350, 0, 350, options));
+  EXPECT_EQ(0, table.box_size());
+  ASSERT_TRUE(table.CalculateWeights(100, 0, 100, 100, 0, 100, options));
+  EXPECT_EQ(0, table.box_size());
+  ASSERT_TRUE(table.CalculateWeights(400, 0, 400, 100, 0, 100, options));
+  EXPECT_EQ(0, table.box_size());
+
+  // Mirror images.
+  ASSERT_TRUE(table.CalculateWeights(-100, 0, 100, 400, 0, 400, options));
+  EXPECT_EQ(0, table.box_size());
+
+  // Boxes that get clipped by the source range.
+  ASSERT_TRUE(table.CalculateWeights(100, 0, 100, 400, 0, 399, options));
+  EXPECT_EQ(0, table.box_size());
+
+  options.bNoSmoothing = true;
+  ASSERT_TRUE(table.CalculateWeights(100, 0, 100, 400, 0, 400, options));
+  EXPECT_EQ(0, table.box_size());
+}
+
+TEST(CStretchEngine, BoxFilter) {
+  for (FXDIB_Format format : {FXDIB_Format::k8bppMask, FXDIB_Format::kBgr,
+                              FXDIB_Format::kBgrx}) {
+    SCOPED_TRACE(static_cast<int>(format));
+    RetainPtr<CFX_DIBitmap> src = MakeStretchSource(format);
+
+    // Power of two boxes use the box filter, other sizes do not. All of them
+    // give the exact same results as the weight table.
+    for (int size : {60, 30, 15, 40, 24}) {
+      SCOPED_TRACE(size);
+      RetainPtr<CFX_DIBitmap> dest =
+          src->StretchTo(size, size, FXDIB_ResampleOptions(), nullptr);
+      ASSERT_TRUE(dest);
+      EXPECT_EQ(0, MaxStretchError(StretchReference(*src, size, size), *dest));
+    }
+
+    // Different factors in each direction.
+    RetainPtr<CFX_DIBitmap> dest =
+        src->StretchTo(30, 40, FXDIB_ResampleOptions(), nullptr);
+    ASSERT_TRUE(dest);
+    EXPECT_EQ(0, MaxStretchError(StretchReference(*src, 30, 40), *dest));
+
+    // No integer downscale.
+    dest = src->StretchTo(37, 29, FXDIB_ResampleOptions(), nullptr);
+    ASSERT_TRUE(dest);
+    EXPECT_EQ(0, MaxStretchError(StretchReference(*src, 37, 29), *dest));
+  }
+}
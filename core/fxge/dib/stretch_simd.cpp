@@ -0,0 +1,193 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxge/dib/stretch_simd.h"
+
+#include <stddef.h>
+
+#include <array>
+
+#include "core/fxcrt/check_op.h"
+#include "core/fxcrt/compiler_specific.h"
+
+// Compiles this file once per CPU target that Highway supports.
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "core/fxge/dib/stretch_simd.cpp"
+#include "hwy/foreach_target.h"  // IWYU pragma: keep
+#include "hwy/highway.h"
+
+HWY_BEFORE_NAMESPACE();
+namespace fxge {
+namespace HWY_NAMESPACE {
+
+namespace hn = hwy::HWY_NAMESPACE;
+
+using DU = hn::ScalableTag<uint32_t>;
+using VU = hn::Vec<DU>;
+
+// One pixel of up to 4 components, one per lane.
+using DPixel = hn::FixedTag<uint32_t, 4>;
+using VPixel = hn::Vec<DPixel>;
+
+void AccumulateWeightedRowImpl(pdfium::span<const uint8_t> src,
+                               uint32_t weight,
+                               pdfium::span<uint32_t> sums) {
+  const DU du;
+  const hn::Rebind<uint8_t, DU> d8;
+  const size_t lanes = hn::Lanes(du);
+  const VU weights = hn::Set(du, weight);
+  size_t i = 0;
+  // SAFETY: `sums` is at least as long as `src`, as checked by the caller.
+  UNSAFE_BUFFERS({
+    for (; i + lanes <= src.size(); i += lanes) {
+      const VU pixels = hn::PromoteTo(du, hn::LoadU(d8, src.data() + i));
+      hn::StoreU(hn::Add(hn::LoadU(du, sums.data() + i),
+                         hn::Mul(weights, pixels)),
+                 du, sums.data() + i);
+    }
+  });
+  for (; i < src.size(); ++i) {
+    sums[i] += weight * src[i];
+  }
+}
+
+void StretchRowHorzGrayImpl(pdfium::span<const uint8_t> src,
+                            const CStretchEngine::WeightTable& table,
+                            int dest_min,
+                            int dest_max,
+                            pdfium::span<uint8_t> dest) {
+  const DU du;
+  const hn::Rebind<uint8_t, DU> d8;
+  const size_t lanes = hn::Lanes(du);
+  size_t dest_index = 0;
+  for (int col = dest_min; col < dest_max; ++col) {
+    pdfium::span<const uint32_t> weights = table.GetWeights(col);
+    pdfium::span<const uint8_t> pixels = src.subspan(
+        static_cast<size_t>(table.GetPixelWeight(col)->src_start_),
+        weights.size());
+    uint32_t sum = 0;
+    size_t i = 0;
+    if (weights.size() >= lanes) {
+      VU sums = hn::Zero(du);
+      // SAFETY: `pixels` and `weights` have the same size.
+      UNSAFE_BUFFERS({
+        for (; i + lanes <= weights.size(); i += lanes) {
+          sums = hn::Add(
+              sums,
+              hn::Mul(hn::LoadU(du, weights.data() + i),
+                      hn::PromoteTo(du, hn::LoadU(d8, pixels.data() + i))));
+        }
+      });
+      sum = hn::ReduceSum(du, sums);
+    }
+    for (; i < weights.size(); ++i) {
+      sum += weights[i] * pixels[i];
+    }
+    dest[dest_index++] = CStretchEngine::PixelFromFixed(sum);
+  }
+}
+
+void StretchRowHorzRgbImpl(pdfium::span<const uint8_t> src,
+                           int bytes_per_pixel,
+                           bool has_alpha,
+                           const CStretchEngine::WeightTable& table,
+                           int dest_min,
+                           int dest_max,
+                           pdfium::span<uint8_t> dest) {
+  const DPixel dp;
+  const hn::Rebind<uint8_t, DPixel> d8;
+  const VPixel one = hn::Set(dp, 1);
+  const auto alpha_lane = hn::Eq(hn::Iota(dp, 0), hn::Set(dp, 3));
+  const size_t bpp = static_cast<size_t>(bytes_per_pixel);
+  size_t dest_index = 0;
+  for (int col = dest_min; col < dest_max; ++col) {
+    pdfium::span<const uint32_t> weights = table.GetWeights(col);
+    pdfium::span<const uint8_t> pixels = src.subspan(
+        static_cast<size_t>(table.GetPixelWeight(col)->src_start_) * bpp);
+    CHECK_GE(pixels.size(), weights.size() * bpp);
+    std::array<uint32_t, 4> sums = {};
+    // Each vector load reads 4 bytes, which goes one byte past the last pixel
+    // when there are 3 bytes per pixel.
+    if (weights.empty() || pixels.size() >= weights.size() * bpp + 4 - bpp) {
+      VPixel pixel_sums = hn::Zero(dp);
+      // SAFETY: checked above.
+      UNSAFE_BUFFERS({
+        for (size_t i = 0; i < weights.size(); ++i) {
+          const uint8_t* src_pixel = pixels.data() + i * bpp;
+          VPixel pixel = hn::PromoteTo(dp, hn::LoadU(d8, src_pixel));
+          uint32_t pixel_weight = weights[i];
+          if (has_alpha) {
+            pixel_weight = pixel_weight * src_pixel[3] / 255;
+            pixel = hn::IfThenElse(alpha_lane, one, pixel);
+          }
+          pixel_sums =
+              hn::Add(pixel_sums, hn::Mul(hn::Set(dp, pixel_weight), pixel));
+        }
+      });
+      hn::StoreU(pixel_sums, dp, sums.data());
+    } else {
+      for (size_t i = 0; i < weights.size(); ++i) {
+        pdfium::span<const uint8_t> src_pixel = pixels.subspan(i * bpp, bpp);
+        uint32_t pixel_weight = weights[i];
+        if (has_alpha) {
+          pixel_weight = pixel_weight * src_pixel[3] / 255;
+          sums[3] += pixel_weight;
+        }
+        sums[0] += pixel_weight * src_pixel[0];
+        sums[1] += pixel_weight * src_pixel[1];
+        sums[2] += pixel_weight * src_pixel[2];
+      }
+    }
+    dest[dest_index] = CStretchEngine::PixelFromFixed(sums[0]);
+    dest[dest_index + 1] = CStretchEngine::PixelFromFixed(sums[1]);
+    dest[dest_index + 2] = CStretchEngine::PixelFromFixed(sums[2]);
+    if (has_alpha) {
+      dest[dest_index + 3] = CStretchEngine::PixelFromFixed(255 * sums[3]);
+    }
+    dest_index += bpp;
+  }
+}
+
+}  // namespace HWY_NAMESPACE
+}  // namespace fxge
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace fxge {
+
+HWY_EXPORT(AccumulateWeightedRowImpl);
+HWY_EXPORT(StretchRowHorzGrayImpl);
+HWY_EXPORT(StretchRowHorzRgbImpl);
+
+void AccumulateWeightedRow(pdfium::span<const uint8_t> src,
+                           uint32_t weight,
+                           pdfium::span<uint32_t> sums) {
+  CHECK_GE(sums.size(), src.size());
+  HWY_DYNAMIC_DISPATCH(AccumulateWeightedRowImpl)(src, weight, sums);
+}
+
+void StretchRowHorzGray(pdfium::span<const uint8_t> src,
+                        const CStretchEngine::WeightTable& table,
+                        int dest_min,
+                        int dest_max,
+                        pdfium::span<uint8_t> dest) {
+  HWY_DYNAMIC_DISPATCH(StretchRowHorzGrayImpl)(src, table, dest_min, dest_max,
+                                               dest);
+}
+
+void StretchRowHorzRgb(pdfium::span<const uint8_t> src,
+                       int bytes_per_pixel,
+                       bool has_alpha,
+                       const CStretchEngine::WeightTable& table,
+                       int dest_min,
+                       int dest_max,
+                       pdfium::span<uint8_t> dest) {
+  CHECK(bytes_per_pixel == 3 || bytes_per_pixel == 4);
+  CHECK(!has_alpha || bytes_per_pixel == 4);
+  HWY_DYNAMIC_DISPATCH(StretchRowHorzRgbImpl)(
+      src, bytes_per_pixel, has_alpha, table, dest_min, dest_max, dest);
+}
+
+}  // namespace fxge
+#endif  // HWY_ONCE
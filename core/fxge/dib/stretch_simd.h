@@ -0,0 +1,44 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FXGE_DIB_STRETCH_SIMD_H_
+#define CORE_FXGE_DIB_STRETCH_SIMD_H_
+
+#include <stdint.h>
+
+#include "core/fxcrt/span.h"
+#include "core/fxge/dib/cstretchengine.h"
+
+// Vectorized inner loops of CStretchEngine, with runtime CPU dispatch. The
+// results are identical to the scalar loops they replace.
+namespace fxge {
+
+// Adds `weight` times each byte of `src` to the matching entry of `sums`.
+void AccumulateWeightedRow(pdfium::span<const uint8_t> src,
+                           uint32_t weight,
+                           pdfium::span<uint32_t> sums);
+
+// Resamples the 1 byte per pixel row `src` into destination pixels
+// `dest_min` up to, but not including, `dest_max`, as weighted by `table`.
+void StretchRowHorzGray(pdfium::span<const uint8_t> src,
+                        const CStretchEngine::WeightTable& table,
+                        int dest_min,
+                        int dest_max,
+                        pdfium::span<uint8_t> dest);
+
+// Same as StretchRowHorzGray(), but for 3 or 4 bytes per pixel, in both `src`
+// and `dest`. Only writes the color components, unless `has_alpha` is set.
+// Then the source pixels also get weighted by their alpha, and the alpha sum
+// goes into the last byte.
+void StretchRowHorzRgb(pdfium::span<const uint8_t> src,
+                       int bytes_per_pixel,
+                       bool has_alpha,
+                       const CStretchEngine::WeightTable& table,
+                       int dest_min,
+                       int dest_max,
+                       pdfium::span<uint8_t> dest);
+
+}  // namespace fxge
+
+#endif  // CORE_FXGE_DIB_STRETCH_SIMD_H_
@@ -0,0 +1,173 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxge/dib/stretch_simd.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <vector>
+
+#include "core/fxcrt/span.h"
+#include "core/fxge/dib/cstretchengine.h"
+#include "core/fxge/dib/fx_dib.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+struct StretchCase {
+  int dest_len;
+  int src_len;
+  bool bilinear;
+};
+
+// Downscales, upscales and mirror images, with weight counts that do and do
+// not fill whole vectors.
+constexpr StretchCase kStretchCases[] = {
+    {100, 100, false}, {37, 100, false}, {100, 37, false},  {100, 37, true},
+    {-41, 100, false}, {-100, 41, true}, {3, 100, false},   {1, 100, false},
+    {25, 100, false},  {7, 1000, false}, {1000, 7, false},  {64, 2048, false},
+};
+
+std::vector<uint8_t> MakeRow(size_t size) {
+  std::vector<uint8_t> row(size);
+  for (size_t i = 0; i < size; ++i) {
+    row[i] = static_cast<uint8_t>(i * 37 + (i >> 3) * 101 + 5);
+  }
+  return row;
+}
+
+// Reference versions of the loops in CStretchEngine::ContinueStretchHorz().
+std::vector<uint8_t> StretchRowGray(pdfium::span<const uint8_t> src,
+                                    const CStretchEngine::WeightTable& table,
+                                    int dest_width) {
+  std::vector<uint8_t> dest(dest_width);
+  for (int col = 0; col < dest_width; ++col) {
+    const int src_start = table.GetPixelWeight(col)->src_start_;
+    pdfium::span<const uint32_t> weights = table.GetWeights(col);
+    uint32_t sum = 0;
+    for (size_t i = 0; i < weights.size(); ++i) {
+      sum += weights[i] * src[src_start + i];
+    }
+    dest[col] = CStretchEngine::PixelFromFixed(sum);
+  }
+  return dest;
+}
+
+std::vector<uint8_t> StretchRowRgb(pdfium::span<const uint8_t> src,
+                                   int bpp,
+                                   bool has_alpha,
+                                   const CStretchEngine::WeightTable& table,
+                                   int dest_width,
+                                   uint8_t fill) {
+  std::vector<uint8_t> dest(dest_width * bpp, fill);
+  for (int col = 0; col < dest_width; ++col) {
+    const int src_start = table.GetPixelWeight(col)->src_start_;
+    pdfium::span<const uint32_t> weights = table.GetWeights(col);
+    uint32_t sums[4] = {};
+    for (size_t i = 0; i < weights.size(); ++i) {
+      pdfium::span<const uint8_t> src_pixel =
+          src.subspan((src_start + i) * bpp, static_cast<size_t>(bpp));
+      uint32_t pixel_weight = weights[i];
+      if (has_alpha) {
+        pixel_weight = pixel_weight * src_pixel[3] / 255;
+        sums[3] += pixel_weight;
+      }
+      for (int c = 0; c < 3; ++c) {
+        sums[c] += pixel_weight * src_pixel[c];
+      }
+    }
+    for (int c = 0; c < 3; ++c) {
+      dest[col * bpp + c] = CStretchEngine::PixelFromFixed(sums[c]);
+    }
+    if (has_alpha) {
+      dest[col * bpp + 3] = CStretchEngine::PixelFromFixed(255 * sums[3]);
+    }
+  }
+  return dest;
+}
+
+}  // namespace
+
+TEST(StretchSimdTest, AccumulateWeightedRow) {
+  for (size_t size : {0u, 1u, 15u, 16u, 17u, 100u, 1023u}) {
+    SCOPED_TRACE(size);
+    const std::vector<uint8_t> src = MakeRow(size);
+    std::vector<uint32_t> expected(size + 1, 7);
+    std::vector<uint32_t> sums = expected;
+    for (uint32_t weight : {0u, 1u, 12345u, CStretchEngine::kFixedPointOne}) {
+      for (size_t i = 0; i < size; ++i) {
+        expected[i] += weight * src[i];
+      }
+      fxge::AccumulateWeightedRow(src, weight, sums);
+    }
+    EXPECT_EQ(expected, sums);
+  }
+}
+
+TEST(StretchSimdTest, StretchRowHorzGray) {
+  for (const StretchCase& test_case : kStretchCases) {
+    SCOPED_TRACE(testing::Message() << test_case.src_len << " to "
+                                    << test_case.dest_len);
+    const int dest_width = abs(test_case.dest_len);
+    FXDIB_ResampleOptions options;
+    options.bInterpolateBilinear = test_case.bilinear;
+    CStretchEngine::WeightTable table;
+    ASSERT_TRUE(table.CalculateWeights(test_case.dest_len, 0, dest_width,
+                                       test_case.src_len, 0, test_case.src_len,
+                                       options));
+    const std::vector<uint8_t> src = MakeRow(test_case.src_len);
+    std::vector<uint8_t> dest(dest_width);
+    fxge::StretchRowHorzGray(src, table, 0, dest_width, dest);
+    EXPECT_EQ(StretchRowGray(src, table, dest_width), dest);
+
+    // Only part of the row.
+    const int dest_min = dest_width / 3;
+    const int dest_max = dest_width - dest_width / 4;
+    CStretchEngine::WeightTable clipped_table;
+    ASSERT_TRUE(clipped_table.CalculateWeights(
+        test_case.dest_len, dest_min, dest_max, test_case.src_len, 0,
+        test_case.src_len, options));
+    std::vector<uint8_t> clipped_dest(dest_max - dest_min);
+    fxge::StretchRowHorzGray(src, clipped_table, dest_min, dest_max,
+                             clipped_dest);
+    EXPECT_EQ(std::vector<uint8_t>(dest.begin() + dest_min,
+                                   dest.begin() + dest_max),
+              clipped_dest);
+  }
+}
+
+TEST(StretchSimdTest, StretchRowHorzRgb) {
+  struct FormatCase {
+    int bpp;
+    bool has_alpha;
+  };
+  static constexpr FormatCase kFormatCases[] = {
+      {3, false}, {4, false}, {4, true}};
+  for (const FormatCase& format_case : kFormatCases) {
+    SCOPED_TRACE(testing::Message() << format_case.bpp << " bytes per pixel, "
+                                    << format_case.has_alpha);
+    for (const StretchCase& test_case : kStretchCases) {
+      SCOPED_TRACE(testing::Message() << test_case.src_len << " to "
+                                      << test_case.dest_len);
+      const int dest_width = abs(test_case.dest_len);
+      FXDIB_ResampleOptions options;
+      options.bInterpolateBilinear = test_case.bilinear;
+      CStretchEngine::WeightTable table;
+      ASSERT_TRUE(table.CalculateWeights(test_case.dest_len, 0, dest_width,
+                                         test_case.src_len, 0,
+                                         test_case.src_len, options));
+      // No padding after the last pixel, so 3 byte pixels at the end of the
+      // row cannot use 4 byte loads.
+      const std::vector<uint8_t> src =
+          MakeRow(test_case.src_len * format_case.bpp);
+      std::vector<uint8_t> dest(dest_width * format_case.bpp, 0xcd);
+      fxge::StretchRowHorzRgb(src, format_case.bpp, format_case.has_alpha,
+                              table, 0, dest_width, dest);
+      EXPECT_EQ(StretchRowRgb(src, format_case.bpp, format_case.has_alpha,
+                              table, dest_width, 0xcd),
+                dest);
+    }
+  }
+}
@@ -6,12 +6,21 @@
 
 #include "fpdfsdk/cpdfsdk_customaccess.h"
 
+#include "core/fxcrt/check_op.h"
 #include "core/fxcrt/fx_safe_types.h"
 #include "core/fxcrt/numerics/safe_conversions.h"
+#include "core/fxcrt/stl_util.h"
 
 CPDFSDK_CustomAccess::CPDFSDK_CustomAccess(FPDF_FILEACCESS* pFileAccess)
     : file_access_(*pFileAccess) {}
 
+CPDFSDK_CustomAccess::CPDFSDK_CustomAccess(
+    FPDF_FILEACCESS* pFileAccess,
+    pdfium::span<const uint8_t> file_data)
+    : file_access_(*pFileAccess), file_data_(file_data) {
+  CHECK_EQ(file_data_.size(), file_access_.m_FileLen);
+}
+
 CPDFSDK_CustomAccess::~CPDFSDK_CustomAccess() = default;
 
 FX_FILESIZE CPDFSDK_CustomAccess::GetSize() {
@@ -30,8 +39,22 @@ bool CPDFSDK_CustomAccess::ReadBlockAtOffset(pdfium::span<uint8_t> buffer,
 
   FX_SAFE_FILESIZE new_pos = buffer.size();
   new_pos += offset;
-  return new_pos.IsValid() && new_pos.ValueOrDie() <= GetSize() &&
-         file_access_.m_GetBlock(
-             file_access_.m_Param, pdfium::checked_cast<unsigned long>(offset),
-             buffer.data(), pdfium::checked_cast<unsigned long>(buffer.size()));
+  if (!new_pos.IsValid() || new_pos.ValueOrDie() > GetSize()) {
+    return false;
+  }
+
+  if (!file_data_.empty()) {
+    fxcrt::Copy(
+        file_data_.subspan(pdfium::checked_cast<size_t>(offset), buffer.size()),
+        buffer);
+    return true;
+  }
+
+  return !!file_access_.m_GetBlock(
+      file_access_.m_Param, pdfium::checked_cast<unsigned long>(offset),
+      buffer.data(), pdfium::checked_cast<unsigned long>(buffer.size()));
+}
+
+pdfium::span<const uint8_t> CPDFSDK_CustomAccess::GetInMemorySpan() {
+  return file_data_;
 }
@@ -8,7 +8,9 @@
 #define FPDFSDK_CPDFSDK_CUSTOMACCESS_H_
 
 #include "core/fxcrt/fx_stream.h"
+#include "core/fxcrt/raw_span.h"
 #include "core/fxcrt/retain_ptr.h"
+#include "core/fxcrt/span.h"
 #include "public/fpdfview.h"
 
 class CPDFSDK_CustomAccess final : public IFX_SeekableReadStream {
@@ -19,12 +21,19 @@ class CPDFSDK_CustomAccess final : public IFX_SeekableReadStream {
   FX_FILESIZE GetSize() override;
   bool ReadBlockAtOffset(pdfium::span<uint8_t> buffer,
                          FX_FILESIZE offset) override;
+  pdfium::span<const uint8_t> GetInMemorySpan() override;
 
  private:
   explicit CPDFSDK_CustomAccess(FPDF_FILEACCESS* pFileAccess);
+  // `file_data` holds all `pFileAccess->m_FileLen` bytes of the file, and
+  // must outlive this object. Blocks get read from it rather than through
+  // `pFileAccess->m_GetBlock`.
+  CPDFSDK_CustomAccess(FPDF_FILEACCESS* pFileAccess,
+                       pdfium::span<const uint8_t> file_data);
   ~CPDFSDK_CustomAccess() override;
 
   FPDF_FILEACCESS file_access_;
+  pdfium::raw_span<const uint8_t> file_data_;
 };
 
 #endif  // FPDFSDK_CPDFSDK_CUSTOMACCESS_H_
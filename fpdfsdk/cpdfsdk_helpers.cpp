@@ -6,6 +6,7 @@
 
 #include "fpdfsdk/cpdfsdk_helpers.h"
 
+#include <atomic>
 #include <utility>
 
 #include "build/build_config.h"
@@ -39,18 +40,23 @@ namespace {
 
 constexpr char kQuadPoints[] = "QuadPoints";
 
+// Atomic, since documents may be loaded on several threads. See
+// FPDF_InitThread().
 // 0 bit: FPDF_POLICY_MACHINETIME_ACCESS
-uint32_t g_sandbox_policy = 0xFFFFFFFF;
+std::atomic<uint32_t> g_sandbox_policy = 0xFFFFFFFF;
 
-UNSUPPORT_INFO* g_unsupport_info = nullptr;
+std::atomic<UNSUPPORT_INFO*> g_unsupport_info = nullptr;
+
+thread_local bool g_has_custom_system_font_info = false;
 
 bool RaiseUnsupportedError(int nError) {
-  if (!g_unsupport_info) {
+  UNSUPPORT_INFO* unsupport_info = g_unsupport_info.load();
+  if (!unsupport_info) {
     return false;
   }
 
-  if (g_unsupport_info->FSDK_UnSupport_Handler) {
-    g_unsupport_info->FSDK_UnSupport_Handler(g_unsupport_info, nError);
+  if (unsupport_info->FSDK_UnSupport_Handler) {
+    unsupport_info->FSDK_UnSupport_Handler(unsupport_info, nError);
   }
   return true;
 }
@@ -390,9 +396,9 @@ void SetPDFSandboxPolicy(FPDF_DWORD policy, FPDF_BOOL enable) {
     case FPDF_POLICY_MACHINETIME_ACCESS: {
       uint32_t mask = 1 << policy;
       if (enable) {
-        g_sandbox_policy |= mask;
+        g_sandbox_policy.fetch_or(mask);
       } else {
-        g_sandbox_policy &= ~mask;
+        g_sandbox_policy.fetch_and(~mask);
       }
     } break;
     default:
@@ -404,7 +410,7 @@ FPDF_BOOL IsPDFSandboxPolicyEnabled(FPDF_DWORD policy) {
   switch (policy) {
     case FPDF_POLICY_MACHINETIME_ACCESS: {
       uint32_t mask = 1 << policy;
-      return !!(g_sandbox_policy & mask);
+      return !!(g_sandbox_policy.load() & mask);
     }
     default:
       return false;
@@ -415,6 +421,14 @@ void SetPDFUnsupportInfo(UNSUPPORT_INFO* unsp_info) {
   g_unsupport_info = unsp_info;
 }
 
+void SetHasCustomSystemFontInfo(bool custom) {
+  g_has_custom_system_font_info = custom;
+}
+
+bool HasCustomSystemFontInfo() {
+  return g_has_custom_system_font_info;
+}
+
 void ReportUnsupportedFeatures(const CPDF_Document* doc) {
   const CPDF_Dictionary* pRootDict = doc->GetRoot();
   if (!pRootDict) {
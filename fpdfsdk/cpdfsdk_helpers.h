@@ -343,6 +343,10 @@ void SetPDFSandboxPolicy(FPDF_DWORD policy, FPDF_BOOL enable);
 FPDF_BOOL IsPDFSandboxPolicyEnabled(FPDF_DWORD policy);
 
 void SetPDFUnsupportInfo(UNSUPPORT_INFO* unsp_info);
+// Whether FPDF_SetSystemFontInfo() changed the system font info of the calling
+// thread since it called FPDF_InitLibraryWithConfig() or FPDF_InitThread().
+void SetHasCustomSystemFontInfo(bool custom);
+bool HasCustomSystemFontInfo();
 void ReportUnsupportedFeatures(const CPDF_Document* doc);
 void ReportUnsupportedXFA(const CPDF_Document* doc);
 void CheckForUnsupportedAnnot(const CPDF_Annot* pAnnot);
@@ -15,7 +15,14 @@
 static constexpr char kDateKey[] = "CreationDate";
 static constexpr char kChecksumKey[] = "CheckSum";
 
-class FPDFAttachmentEmbedderTest : public EmbedderTest {};
+class FPDFAttachmentEmbedderTest : public EmbedderTest {
+ protected:
+  void TearDown() override {
+    // Do not leak a limit set by a failed test into other tests.
+    FPDF_SetMaxFlateDecodeSize(0);
+    EmbedderTest::TearDown();
+  }
+};
 
 TEST_F(FPDFAttachmentEmbedderTest, ExtractAttachments) {
   // Open a file with two attachments.
@@ -96,6 +103,23 @@ TEST_F(FPDFAttachmentEmbedderTest, ExtractAttachments) {
   EXPECT_EQ(kCheckSumW, GetPlatformWString(buf.data()));
 }
 
+TEST_F(FPDFAttachmentEmbedderTest, ExtractAttachmentWithMaxFlateDecodeSize) {
+  ASSERT_TRUE(OpenDocument("embedded_attachments.pdf"));
+  FPDF_ATTACHMENT attachment = FPDFDoc_GetAttachment(document(), 1);
+  ASSERT_TRUE(attachment);
+
+  // The Flate compressed file gets cut off at the limit.
+  FPDF_SetMaxFlateDecodeSize(1000);
+  unsigned long length_bytes;
+  ASSERT_TRUE(FPDFAttachment_GetFile(attachment, nullptr, 0, &length_bytes));
+  EXPECT_EQ(1000u, length_bytes);
+
+  // Removing the limit restores the full file. TearDown() also does this.
+  FPDF_SetMaxFlateDecodeSize(0);
+  ASSERT_TRUE(FPDFAttachment_GetFile(attachment, nullptr, 0, &length_bytes));
+  EXPECT_EQ(5869u, length_bytes);
+}
+
 TEST_F(FPDFAttachmentEmbedderTest, NoAttachmentToExtract) {
   // Open a file with no attachments.
   ASSERT_TRUE(OpenDocument("hello_world.pdf"));
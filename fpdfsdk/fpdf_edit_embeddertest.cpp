@@ -3195,6 +3195,45 @@ TEST_F(FPDFEditEmbedderTest, GlyphPaths) {
   EXPECT_EQ(FPDF_SEGMENT_BEZIERTO, FPDFPathSegment_GetType(segment));
 }
 
+TEST_F(FPDFEditEmbedderTest, GlyphPathOutlivesGlyphCacheTrim) {
+  ASSERT_TRUE(OpenDocument("text_font.pdf"));
+  ScopedPage page = LoadScopedPage(0);
+  ASSERT_TRUE(page);
+  FPDF_PAGEOBJECT text = FPDFPage_GetObject(page.get(), 0);
+  ASSERT_TRUE(text);
+  FPDF_FONT font = FPDFTextObj_GetFont(text);
+  ASSERT_TRUE(font);
+
+  FPDF_GLYPHPATH gpath = FPDFFont_GetGlyphPath(font, 's', 12.0f);
+  ASSERT_TRUE(gpath);
+  auto get_points = [gpath] {
+    std::vector<std::pair<float, float>> points;
+    const int count = FPDFGlyphPath_CountGlyphSegments(gpath);
+    for (int i = 0; i < count; ++i) {
+      FPDF_PATHSEGMENT segment = FPDFGlyphPath_GetGlyphPathSegment(gpath, i);
+      float x;
+      float y;
+      EXPECT_TRUE(FPDFPathSegment_GetPoint(segment, &x, &y));
+      points.emplace_back(x, y);
+    }
+    return points;
+  };
+  const std::vector<std::pair<float, float>> points = get_points();
+  ASSERT_FALSE(points.empty());
+
+  // Rendering with a tiny glyph cache evicts glyphs, but not the path.
+  FPDF_CACHE_STATS stats;
+  ASSERT_TRUE(FPDF_GetCacheStats(FPDF_CACHE_GLYPHS, &stats));
+  ASSERT_TRUE(FPDF_SetCacheLimit(FPDF_CACHE_GLYPHS, 1));
+  ScopedFPDFBitmap bitmap = RenderLoadedPage(page.get());
+  ASSERT_TRUE(bitmap);
+  bitmap = RenderLoadedPage(page.get());
+  ASSERT_TRUE(bitmap);
+  EXPECT_EQ(points, get_points());
+  EXPECT_EQ(gpath, FPDFFont_GetGlyphPath(font, 's', 12.0f));
+  ASSERT_TRUE(FPDF_SetCacheLimit(FPDF_CACHE_GLYPHS, stats.max_bytes));
+}
+
 TEST_F(FPDFEditEmbedderTest, FormGetObjects) {
   ASSERT_TRUE(OpenDocument("form_object.pdf"));
   ScopedPage page = LoadScopedPage(0);
@@ -23,6 +23,7 @@
 #include "core/fxge/cfx_gemodule.h"
 #include "core/fxge/fx_font.h"
 #include "core/fxge/systemfontinfo_iface.h"
+#include "fpdfsdk/cpdfsdk_helpers.h"
 
 #ifdef PDF_ENABLE_XFA
 #include "xfa/fgas/font/cfgas_fontmgr.h"
@@ -156,6 +157,7 @@ FPDF_EXPORT void FPDF_CALLCONV
 FPDF_SetSystemFontInfo(FPDF_SYSFONTINFO* font_infoExt) {
   auto* mapper = CFX_GEModule::Get()->GetFontMgr()->GetBuiltinMapper();
   if (!font_infoExt) {
+    SetHasCustomSystemFontInfo(true);
     std::unique_ptr<SystemFontInfoIface> info = mapper->TakeSystemFontInfo();
     // Delete `info` when it goes out of scope here.
     return;
@@ -165,6 +167,7 @@ FPDF_SetSystemFontInfo(FPDF_SYSFONTINFO* font_infoExt) {
     return;
   }
 
+  SetHasCustomSystemFontInfo(true);
   mapper->SetSystemFontInfo(
       std::make_unique<CFX_ExternalFontInfo>(font_infoExt));
 
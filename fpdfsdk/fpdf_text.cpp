@@ -9,24 +9,30 @@
 #include <algorithm>
 #include <limits>
 #include <memory>
+#include <optional>
+#include <utility>
 #include <vector>
 
 #include "build/build_config.h"
 #include "core/fpdfapi/font/cpdf_font.h"
+#include "core/fpdfapi/parser/cpdf_document.h"
 #include "core/fpdfapi/page/cpdf_page.h"
 #include "core/fpdfapi/page/cpdf_textobject.h"
 #include "core/fpdfdoc/cpdf_viewerpreferences.h"
 #include "core/fpdftext/cpdf_linkextract.h"
+#include "core/fpdftext/cpdf_textindex.h"
 #include "core/fpdftext/cpdf_textpage.h"
 #include "core/fpdftext/cpdf_textpagefind.h"
 #include "core/fxcrt/check_op.h"
 #include "core/fxcrt/compiler_specific.h"
+#include "core/fxcrt/data_vector.h"
 #include "core/fxcrt/fx_memcpy_wrappers.h"
 #include "core/fxcrt/numerics/safe_conversions.h"
 #include "core/fxcrt/span.h"
 #include "core/fxcrt/span_util.h"
 #include "core/fxcrt/stl_util.h"
 #include "fpdfsdk/cpdfsdk_helpers.h"
+#include "public/cpp/fpdf_scopers.h"
 
 namespace {
 
@@ -39,6 +45,32 @@ CPDF_TextPage* GetTextPageForValidIndex(FPDF_TEXTPAGE text_page, int index) {
   return static_cast<size_t>(index) < textpage->size() ? textpage : nullptr;
 }
 
+CPDF_TextPageFind::Options FindOptionsFromFlags(unsigned long flags) {
+  CPDF_TextPageFind::Options options;
+  options.bMatchCase = !!(flags & FPDF_MATCHCASE);
+  options.bMatchWholeWord = !!(flags & FPDF_MATCHWHOLEWORD);
+  options.bConsecutive = !!(flags & FPDF_CONSECUTIVE);
+  return options;
+}
+
+FPDF_TEXTINDEX FPDFTextIndexFromCPDFTextIndex(CPDF_TextIndex* index) {
+  return reinterpret_cast<FPDF_TEXTINDEX>(index);
+}
+
+CPDF_TextIndex* CPDFTextIndexFromFPDFTextIndex(FPDF_TEXTINDEX index) {
+  return reinterpret_cast<CPDF_TextIndex*>(index);
+}
+
+FPDF_TEXTINDEX_SEARCH FPDFTextIndexSearchFromCPDFTextIndexSearch(
+    CPDF_TextIndex::Search* search) {
+  return reinterpret_cast<FPDF_TEXTINDEX_SEARCH>(search);
+}
+
+CPDF_TextIndex::Search* CPDFTextIndexSearchFromFPDFTextIndexSearch(
+    FPDF_TEXTINDEX_SEARCH search) {
+  return reinterpret_cast<CPDF_TextIndex::Search*>(search);
+}
+
 }  // namespace
 
 FPDF_EXPORT FPDF_TEXTPAGE FPDF_CALLCONV FPDFText_LoadPage(FPDF_PAGE page) {
@@ -443,14 +475,10 @@ FPDFText_FindStart(FPDF_TEXTPAGE text_page,
     return nullptr;
   }
 
-  CPDF_TextPageFind::Options options;
-  options.bMatchCase = !!(flags & FPDF_MATCHCASE);
-  options.bMatchWholeWord = !!(flags & FPDF_MATCHWHOLEWORD);
-  options.bConsecutive = !!(flags & FPDF_CONSECUTIVE);
-
   // SAFETY: required from caller.
   auto find = CPDF_TextPageFind::Create(
-      textpage, UNSAFE_BUFFERS(WideStringFromFPDFWideString(findwhat)), options,
+      textpage, UNSAFE_BUFFERS(WideStringFromFPDFWideString(findwhat)),
+      FindOptionsFromFlags(flags),
       start_index >= 0 ? std::optional<size_t>(start_index) : std::nullopt);
 
   // Caller takes ownership.
@@ -504,6 +532,129 @@ FPDF_EXPORT void FPDF_CALLCONV FPDFText_FindClose(FPDF_SCHHANDLE handle) {
       CPDFTextPageFindFromFPDFSchHandle(handle));
 }
 
+FPDF_EXPORT FPDF_TEXTINDEX FPDF_CALLCONV
+FPDFText_BuildIndex(FPDF_DOCUMENT document) {
+  CPDF_Document* doc = CPDFDocumentFromFPDFDocument(document);
+  if (!doc) {
+    return nullptr;
+  }
+
+  const bool rtl = CPDF_ViewerPreferences(doc).IsDirectionR2L();
+  const int page_count = FPDF_GetPageCount(document);
+  std::vector<CPDF_TextIndex::Page> pages(page_count);
+  for (int i = 0; i < page_count; ++i) {
+    ScopedFPDFPage page(FPDF_LoadPage(document, i));
+    CPDF_Page* pdf_page = CPDFPageFromFPDFPage(page.get());
+    if (pdf_page) {
+      CPDF_TextPage text_page(pdf_page, rtl);
+      pages[i] = CPDF_TextIndex::PageFromTextPage(text_page);
+    }
+  }
+
+  // Caller takes ownership.
+  return FPDFTextIndexFromCPDFTextIndex(
+      std::make_unique<CPDF_TextIndex>(CPDF_TextIndex::GetDocumentId(*doc),
+                                       std::move(pages))
+          .release());
+}
+
+FPDF_EXPORT unsigned long FPDF_CALLCONV
+FPDFText_SaveIndex(FPDF_TEXTINDEX index, void* buffer, unsigned long buflen) {
+  if (!index) {
+    return 0;
+  }
+
+  DataVector<uint8_t> data = CPDFTextIndexFromFPDFTextIndex(index)->Serialize();
+  // SAFETY: required from caller.
+  auto buffer_span = UNSAFE_BUFFERS(SpanFromFPDFApiArgs(buffer, buflen));
+  if (buffer_span.size() >= data.size()) {
+    fxcrt::Copy(data, buffer_span);
+  }
+  return pdfium::checked_cast<unsigned long>(data.size());
+}
+
+FPDF_EXPORT FPDF_TEXTINDEX FPDF_CALLCONV
+FPDFText_LoadIndex(FPDF_DOCUMENT document,
+                   const void* data,
+                   unsigned long size) {
+  CPDF_Document* doc = CPDFDocumentFromFPDFDocument(document);
+  if (!doc || !data) {
+    return nullptr;
+  }
+
+  // SAFETY: required from caller.
+  auto data_span = UNSAFE_BUFFERS(
+      pdfium::span(static_cast<const uint8_t*>(data), size_t{size}));
+  // Caller takes ownership.
+  return FPDFTextIndexFromCPDFTextIndex(
+      CPDF_TextIndex::Deserialize(data_span,
+                                  CPDF_TextIndex::GetDocumentId(*doc),
+                                  doc->GetPageCount())
+          .release());
+}
+
+FPDF_EXPORT void FPDF_CALLCONV FPDFText_CloseIndex(FPDF_TEXTINDEX index) {
+  // PDFium takes ownership.
+  std::unique_ptr<CPDF_TextIndex> index_deleter(
+      CPDFTextIndexFromFPDFTextIndex(index));
+}
+
+FPDF_EXPORT FPDF_TEXTINDEX_SEARCH FPDF_CALLCONV
+FPDFText_IndexFindStart(FPDF_TEXTINDEX index,
+                        FPDF_WIDESTRING findwhat,
+                        unsigned long flags,
+                        int start_page) {
+  if (!index || !findwhat) {
+    return nullptr;
+  }
+
+  // SAFETY: required from caller.
+  auto search = std::make_unique<CPDF_TextIndex::Search>(
+      CPDFTextIndexFromFPDFTextIndex(index),
+      UNSAFE_BUFFERS(WideStringFromFPDFWideString(findwhat)),
+      FindOptionsFromFlags(flags), start_page);
+
+  // Caller takes ownership.
+  return FPDFTextIndexSearchFromCPDFTextIndexSearch(search.release());
+}
+
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV
+FPDFText_IndexFindNext(FPDF_TEXTINDEX_SEARCH search) {
+  if (!search) {
+    return false;
+  }
+
+  return CPDFTextIndexSearchFromFPDFTextIndexSearch(search)->FindNext();
+}
+
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV
+FPDFText_IndexGetResult(FPDF_TEXTINDEX_SEARCH search,
+                        int* page_index,
+                        int* char_index,
+                        int* char_count) {
+  if (!search || !page_index || !char_index || !char_count) {
+    return false;
+  }
+
+  const std::optional<CPDF_TextIndex::Hit>& hit =
+      CPDFTextIndexSearchFromFPDFTextIndexSearch(search)->GetHit();
+  if (!hit.has_value()) {
+    return false;
+  }
+
+  *page_index = hit->page_index;
+  *char_index = hit->char_index;
+  *char_count = hit->char_count;
+  return true;
+}
+
+FPDF_EXPORT void FPDF_CALLCONV
+FPDFText_IndexFindClose(FPDF_TEXTINDEX_SEARCH search) {
+  // PDFium takes ownership.
+  std::unique_ptr<CPDF_TextIndex::Search> search_deleter(
+      CPDFTextIndexSearchFromFPDFTextIndexSearch(search));
+}
+
 // web link
 FPDF_EXPORT FPDF_PAGELINK FPDF_CALLCONV
 FPDFLink_LoadWebLinks(FPDF_TEXTPAGE text_page) {
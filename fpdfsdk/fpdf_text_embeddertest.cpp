@@ -13,6 +13,8 @@
 #include "core/fxge/fx_font.h"
 #include "public/cpp/fpdf_scopers.h"
 #include "public/fpdf_doc.h"
+#include "public/fpdf_edit.h"
+#include "public/fpdf_save.h"
 #include "public/fpdf_text.h"
 #include "public/fpdf_transformpage.h"
 #include "public/fpdfview.h"
@@ -22,6 +24,7 @@
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/utils/compare_coordinates.h"
 
+using ::testing::ElementsAre;
 using ::testing::ElementsAreArray;
 
 namespace {
@@ -73,6 +76,48 @@ int GetRotatedText90FirstCharIndexForQuadrant(int quadrant) {
   }
 }
 
+// The page index, char index and char count of a search match.
+using SearchHit = std::array<int, 3>;
+
+std::vector<SearchHit> FindWithIndex(FPDF_TEXTINDEX index,
+                                     FPDF_WIDESTRING findwhat,
+                                     unsigned long flags,
+                                     int start_page) {
+  ScopedFPDFTextIndexSearch search(
+      FPDFText_IndexFindStart(index, findwhat, flags, start_page));
+  EXPECT_TRUE(search);
+  std::vector<SearchHit> hits;
+  SearchHit hit;
+  while (FPDFText_IndexFindNext(search.get())) {
+    EXPECT_TRUE(
+        FPDFText_IndexGetResult(search.get(), &hit[0], &hit[1], &hit[2]));
+    hits.push_back(hit);
+  }
+  return hits;
+}
+
+// Same as FindWithIndex(), but loads and searches each page.
+std::vector<SearchHit> FindInPages(FPDF_DOCUMENT document,
+                                   FPDF_WIDESTRING findwhat,
+                                   unsigned long flags,
+                                   int start_page) {
+  std::vector<SearchHit> hits;
+  for (int i = start_page; i < FPDF_GetPageCount(document); ++i) {
+    ScopedFPDFPage page(FPDF_LoadPage(document, i));
+    EXPECT_TRUE(page);
+    ScopedFPDFTextPage textpage(FPDFText_LoadPage(page.get()));
+    EXPECT_TRUE(textpage);
+    ScopedFPDFTextFind search(
+        FPDFText_FindStart(textpage.get(), findwhat, flags, 0));
+    EXPECT_TRUE(search);
+    while (FPDFText_FindNext(search.get())) {
+      hits.push_back({i, FPDFText_GetSchResultIndex(search.get()),
+                      FPDFText_GetSchCount(search.get())});
+    }
+  }
+  return hits;
+}
+
 }  // namespace
 
 class FPDFTextEmbedderTest : public EmbedderTest {};
@@ -664,6 +709,194 @@ TEST_F(FPDFTextEmbedderTest, TextSearchSpaceInSearchTerm) {
   EXPECT_FALSE(FPDFText_FindNext(search.get()));
 }
 
+TEST_F(FPDFTextEmbedderTest, TextIndex) {
+  EXPECT_FALSE(FPDFText_BuildIndex(nullptr));
+  EXPECT_FALSE(FPDFText_LoadIndex(nullptr, nullptr, 0));
+  EXPECT_FALSE(FPDFText_IndexFindStart(nullptr, nullptr, 0, 0));
+  EXPECT_FALSE(FPDFText_IndexFindNext(nullptr));
+  int page_index = -1;
+  int char_index = -1;
+  int char_count = -1;
+  EXPECT_FALSE(FPDFText_IndexGetResult(nullptr, &page_index, &char_index,
+                                       &char_count));
+
+  ASSERT_TRUE(OpenDocument("hello_world.pdf"));
+  ScopedFPDFTextIndex index(FPDFText_BuildIndex(document()));
+  ASSERT_TRUE(index);
+
+  // Finds the same matches as FPDFText_FindNext() on the page.
+  ScopedFPDFWideString world = GetFPDFWideString(L"world");
+  {
+    ScopedFPDFTextIndexSearch search(
+        FPDFText_IndexFindStart(index.get(), world.get(), 0, 0));
+    ASSERT_TRUE(search);
+    EXPECT_FALSE(FPDFText_IndexGetResult(search.get(), &page_index,
+                                         &char_index, &char_count));
+
+    ASSERT_TRUE(FPDFText_IndexFindNext(search.get()));
+    ASSERT_TRUE(FPDFText_IndexGetResult(search.get(), &page_index,
+                                        &char_index, &char_count));
+    EXPECT_EQ(0, page_index);
+    EXPECT_EQ(7, char_index);
+    EXPECT_EQ(5, char_count);
+    EXPECT_FALSE(
+        FPDFText_IndexGetResult(search.get(), nullptr, nullptr, nullptr));
+
+    ASSERT_TRUE(FPDFText_IndexFindNext(search.get()));
+    ASSERT_TRUE(FPDFText_IndexGetResult(search.get(), &page_index,
+                                        &char_index, &char_count));
+    EXPECT_EQ(0, page_index);
+    EXPECT_EQ(24, char_index);
+    EXPECT_EQ(5, char_count);
+
+    EXPECT_FALSE(FPDFText_IndexFindNext(search.get()));
+    EXPECT_FALSE(FPDFText_IndexGetResult(search.get(), &page_index,
+                                         &char_index, &char_count));
+    EXPECT_EQ(24, char_index);
+  }
+  {
+    // No pages from `start_page` on.
+    ScopedFPDFTextIndexSearch search(
+        FPDFText_IndexFindStart(index.get(), world.get(), 0, 1));
+    ASSERT_TRUE(search);
+    EXPECT_FALSE(FPDFText_IndexFindNext(search.get()));
+  }
+
+  // Round trip through the saved data.
+  unsigned long size = FPDFText_SaveIndex(index.get(), nullptr, 0);
+  ASSERT_GT(size, 0u);
+  std::vector<uint8_t> data(size);
+  EXPECT_EQ(size, FPDFText_SaveIndex(index.get(), data.data(), size));
+  EXPECT_EQ(size, FPDFText_SaveIndex(index.get(), data.data(), size - 1));
+
+  EXPECT_FALSE(FPDFText_LoadIndex(nullptr, data.data(), size));
+  ScopedFPDFTextIndex loaded(
+      FPDFText_LoadIndex(document(), data.data(), size));
+  ASSERT_TRUE(loaded);
+  {
+    ScopedFPDFWideString goodbye = GetFPDFWideString(L"GOODBYE");
+    ScopedFPDFTextIndexSearch search(
+        FPDFText_IndexFindStart(loaded.get(), goodbye.get(), 0, 0));
+    ASSERT_TRUE(search);
+    ASSERT_TRUE(FPDFText_IndexFindNext(search.get()));
+    ASSERT_TRUE(FPDFText_IndexGetResult(search.get(), &page_index,
+                                        &char_index, &char_count));
+    EXPECT_EQ(0, page_index);
+    EXPECT_EQ(15, char_index);
+    EXPECT_EQ(7, char_count);
+    EXPECT_FALSE(FPDFText_IndexFindNext(search.get()));
+  }
+  {
+    ScopedFPDFWideString goodbye = GetFPDFWideString(L"GOODBYE");
+    ScopedFPDFTextIndexSearch search(FPDFText_IndexFindStart(
+        loaded.get(), goodbye.get(), FPDF_MATCHCASE, 0));
+    ASSERT_TRUE(search);
+    EXPECT_FALSE(FPDFText_IndexFindNext(search.get()));
+  }
+
+  EXPECT_FALSE(FPDFText_LoadIndex(document(), data.data(), size - 1));
+
+  // A saved copy of the document gets a file ID, so the index does not match
+  // it even though its text is the same.
+  ASSERT_TRUE(FPDF_SaveAsCopy(document(), this, 0));
+  FPDF_DOCUMENT saved_document = OpenSavedDocument();
+  ASSERT_TRUE(saved_document);
+  EXPECT_EQ(1, FPDF_GetPageCount(saved_document));
+  EXPECT_FALSE(FPDFText_LoadIndex(saved_document, data.data(), size));
+  CloseSavedDocument();
+
+  data[0] = 'X';
+  EXPECT_FALSE(FPDFText_LoadIndex(document(), data.data(), size));
+}
+
+TEST_F(FPDFTextEmbedderTest, TextIndexConsecutive) {
+  ASSERT_TRUE(OpenDocument("find_text_consecutive.pdf"));
+  ScopedFPDFTextIndex index(FPDFText_BuildIndex(document()));
+  ASSERT_TRUE(index);
+
+  ScopedFPDFWideString aaaa = GetFPDFWideString(L"aaaa");
+  {
+    ScopedFPDFTextIndexSearch search(
+        FPDFText_IndexFindStart(index.get(), aaaa.get(), 0, 0));
+    ASSERT_TRUE(search);
+    std::vector<int> char_indices;
+    int page_index;
+    int char_index;
+    int char_count;
+    while (FPDFText_IndexFindNext(search.get())) {
+      ASSERT_TRUE(FPDFText_IndexGetResult(search.get(), &page_index,
+                                          &char_index, &char_count));
+      EXPECT_EQ(0, page_index);
+      EXPECT_EQ(4, char_count);
+      char_indices.push_back(char_index);
+    }
+    EXPECT_THAT(char_indices, ElementsAre(0, 4));
+  }
+  {
+    ScopedFPDFTextIndexSearch search(
+        FPDFText_IndexFindStart(index.get(), aaaa.get(), FPDF_CONSECUTIVE, 0));
+    ASSERT_TRUE(search);
+    std::vector<int> char_indices;
+    int page_index;
+    int char_index;
+    int char_count;
+    while (FPDFText_IndexFindNext(search.get())) {
+      ASSERT_TRUE(FPDFText_IndexGetResult(search.get(), &page_index,
+                                          &char_index, &char_count));
+      EXPECT_EQ(0, page_index);
+      EXPECT_EQ(4, char_count);
+      char_indices.push_back(char_index);
+    }
+    EXPECT_THAT(char_indices, ElementsAre(0, 1, 2, 3, 4, 5, 6));
+  }
+}
+
+TEST_F(FPDFTextEmbedderTest, TextIndexMultiPage) {
+  ASSERT_TRUE(OpenDocument("annots.pdf"));
+  // Put a page without text between the two pages of the document.
+  ScopedFPDFPage blank_page(FPDFPage_New(document(), 1, 612, 792));
+  ASSERT_TRUE(blank_page);
+  ASSERT_EQ(3, FPDF_GetPageCount(document()));
+
+  ScopedFPDFTextIndex index(FPDFText_BuildIndex(document()));
+  ASSERT_TRUE(index);
+  unsigned long size = FPDFText_SaveIndex(index.get(), nullptr, 0);
+  std::vector<uint8_t> data(size);
+  ASSERT_EQ(size, FPDFText_SaveIndex(index.get(), data.data(), size));
+  ScopedFPDFTextIndex loaded(
+      FPDFText_LoadIndex(document(), data.data(), size));
+  ASSERT_TRUE(loaded);
+
+  static constexpr const wchar_t* kFindWhat[] = {
+      L"link", L"Page", L"destination to", L"page 2", L"annotations", L"e",
+      L"PDFium", L"missing"};
+  static constexpr unsigned long kFlags[] = {
+      0, FPDF_MATCHCASE, FPDF_MATCHWHOLEWORD, FPDF_CONSECUTIVE};
+  for (const wchar_t* findwhat : kFindWhat) {
+    ScopedFPDFWideString findwhat_string = GetFPDFWideString(findwhat);
+    for (unsigned long flags : kFlags) {
+      for (int start_page = 0; start_page < 4; ++start_page) {
+        SCOPED_TRACE(testing::Message() << findwhat << " " << flags << " "
+                                        << start_page);
+        const std::vector<SearchHit> expected = FindInPages(
+            document(), findwhat_string.get(), flags, start_page);
+        EXPECT_EQ(expected, FindWithIndex(index.get(), findwhat_string.get(),
+                                          flags, start_page));
+        EXPECT_EQ(expected, FindWithIndex(loaded.get(), findwhat_string.get(),
+                                          flags, start_page));
+      }
+    }
+  }
+
+  // The matches span both pages with text.
+  ScopedFPDFWideString link = GetFPDFWideString(L"link");
+  const std::vector<SearchHit> hits =
+      FindWithIndex(index.get(), link.get(), 0, 0);
+  ASSERT_FALSE(hits.empty());
+  EXPECT_EQ(0, hits.front()[0]);
+  EXPECT_EQ(2, hits.back()[0]);
+}
+
 // Fails on Windows. https://crbug.com/pdfium/1370
 #if BUILDFLAG(IS_WIN)
 #define MAYBE_TextSearchLatinExtended DISABLED_TextSearchLatinExtended
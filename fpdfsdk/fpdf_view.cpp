@@ -7,12 +7,30 @@
 #include "public/fpdfview.h"
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <limits>
 #include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <thread>
 #include <utility>
 #include <vector>
 
 #include "build/build_config.h"
+#include "constants/page_object.h"
+#include "core/fpdfapi/edit/cpdf_creator.h"
+#include "core/fpdfapi/edit/cpdf_pageexporter.h"
+#include "core/fpdfapi/page/cpdf_contentparser.h"
+#include "core/fpdfapi/page/cpdf_docimagecache.h"
 #include "core/fpdfapi/page/cpdf_docpagedata.h"
+#include "core/fpdfapi/page/cpdf_form.h"
+#include "core/fpdfapi/page/cpdf_formobject.h"
+#include "core/fpdfapi/page/cpdf_image.h"
+#include "core/fpdfapi/page/cpdf_imageobject.h"
 #include "core/fpdfapi/page/cpdf_occontext.h"
 #include "core/fpdfapi/page/cpdf_page.h"
 #include "core/fpdfapi/page/cpdf_pageimagecache.h"
@@ -22,7 +40,9 @@
 #include "core/fpdfapi/parser/cpdf_document.h"
 #include "core/fpdfapi/parser/cpdf_name.h"
 #include "core/fpdfapi/parser/cpdf_parser.h"
+#include "core/fpdfapi/parser/cpdf_reference.h"
 #include "core/fpdfapi/parser/cpdf_stream.h"
+#include "core/fpdfapi/parser/cpdf_stream_acc.h"
 #include "core/fpdfapi/parser/cpdf_string.h"
 #include "core/fpdfapi/parser/fpdf_parser_decode.h"
 #include "core/fpdfapi/render/cpdf_docrenderdata.h"
@@ -31,6 +51,9 @@
 #include "core/fpdfapi/render/cpdf_renderoptions.h"
 #include "core/fpdfdoc/cpdf_nametree.h"
 #include "core/fpdfdoc/cpdf_viewerpreferences.h"
+#include "core/fxcodec/jbig2/JBig2_SymbolDictCache.h"
+#include "core/fxcrt/cache_budget.h"
+#include "core/fxcrt/cfx_memorystream.h"
 #include "core/fxcrt/cfx_read_only_span_stream.h"
 #include "core/fxcrt/cfx_timer.h"
 #include "core/fxcrt/check_op.h"
@@ -40,13 +63,16 @@
 #include "core/fxcrt/fx_safe_types.h"
 #include "core/fxcrt/fx_stream.h"
 #include "core/fxcrt/fx_string.h"
+#include "core/fxcrt/fx_string_wrappers.h"
 #include "core/fxcrt/fx_system.h"
 #include "core/fxcrt/numerics/safe_conversions.h"
 #include "core/fxcrt/ptr_util.h"
+#include "core/fxcrt/raw_span.h"
 #include "core/fxcrt/span.h"
 #include "core/fxcrt/stl_util.h"
 #include "core/fxcrt/unowned_ptr.h"
 #include "core/fxge/cfx_defaultrenderdevice.h"
+#include "core/fxge/cfx_fontcache.h"
 #include "core/fxge/cfx_gemodule.h"
 #include "core/fxge/cfx_glyphcache.h"
 #include "core/fxge/cfx_renderdevice.h"
@@ -119,7 +145,98 @@ static_assert(static_cast<int>(CFX_DefaultRenderDevice::RendererType::kSkia) ==
 
 namespace {
 
+// Which per-thread engine state the calling thread has.
+enum class ThreadState {
+  kNone,
+  kLibrary,  // From FPDF_InitLibraryWithConfig().
+  kWorker,   // From FPDF_InitThread().
+};
+
 bool g_bLibraryInitialized = false;
+thread_local ThreadState g_thread_state = ThreadState::kNone;
+
+// From FPDF_LIBRARY_CONFIG, for threads that call FPDF_InitThread().
+const char** g_user_font_paths = nullptr;
+
+// Threads for FPDF_RenderPageBitmapInBands(). They start on first use, up to
+// one per processor, and each calls FPDF_InitThread() once. They stay around
+// until FPDF_DestroyLibrary() destroys the pool.
+class BandWorkerPool {
+ public:
+  BandWorkerPool() = default;
+  BandWorkerPool(const BandWorkerPool&) = delete;
+  BandWorkerPool& operator=(const BandWorkerPool&) = delete;
+  ~BandWorkerPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    task_ready_.notify_all();
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  // Runs `tasks` on the pool threads and `local_task` on the calling thread,
+  // and returns once all of them finished.
+  void Run(std::vector<std::function<void()>> tasks,
+           const std::function<void()>& local_task) {
+    size_t pending = tasks.size();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      const size_t max_threads =
+          std::max(std::thread::hardware_concurrency(), 1u);
+      while (threads_.size() < std::min(tasks.size(), max_threads)) {
+        threads_.emplace_back(&BandWorkerPool::WorkerMain, this);
+      }
+      for (auto& task : tasks) {
+        queue_.push_back({std::move(task), UnownedPtr<size_t>(&pending)});
+      }
+    }
+    task_ready_.notify_all();
+
+    local_task();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    task_done_.wait(lock, [&pending] { return pending == 0; });
+  }
+
+ private:
+  struct Task {
+    std::function<void()> run;
+    UnownedPtr<size_t> pending;
+  };
+
+  void WorkerMain() {
+    FPDF_InitThread();
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      task_ready_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        break;
+      }
+      Task task = std::move(queue_.front());
+      queue_.pop_front();
+      lock.unlock();
+      task.run();
+      lock.lock();
+      if (--*task.pending == 0) {
+        task_done_.notify_all();
+      }
+    }
+    lock.unlock();
+    FPDF_DestroyThread();
+  }
+
+  std::mutex mutex_;
+  std::condition_variable task_ready_;
+  std::condition_variable task_done_;
+  std::deque<Task> queue_;
+  std::vector<std::thread> threads_;
+  bool stopping_ = false;
+};
+
+BandWorkerPool* g_band_worker_pool = nullptr;
 
 void SetRendererType(FPDF_RENDERER_TYPE public_type) {
   // Internal definition of renderer types must stay updated with respect to
@@ -145,6 +262,21 @@ void SetRendererType(FPDF_RENDERER_TYPE public_type) {
 #endif
 }
 
+// Returns the budget shared by all caches of kind `cache`, one of the
+// FPDF_CACHE_* values, or nullptr.
+CacheBudget* GetCacheBudget(int cache) {
+  switch (cache) {
+    case FPDF_CACHE_GLYPHS:
+      return CFX_FontCache::GetGlyphCacheBudget();
+    case FPDF_CACHE_IMAGES:
+      return CPDF_DocImageCache::GetImageBudget();
+    case FPDF_CACHE_JBIG2_SYMBOL_DICTS:
+      return CJBig2_SymbolDictCache::GetSymbolDictBudget();
+    default:
+      return nullptr;
+  }
+}
+
 void ResetRendererType() {
 #if defined(PDF_USE_SKIA)
   CFX_DefaultRenderDevice::SetRendererType(
@@ -242,7 +374,8 @@ FPDF_InitLibraryWithConfig(const FPDF_LIBRARY_CONFIG* config) {
 
   FX_InitializeMemoryAllocators();
   CFX_Timer::InitializeGlobals();
-  CFX_GEModule::Create(config ? config->m_pUserFontPaths : nullptr);
+  g_user_font_paths = config ? config->m_pUserFontPaths : nullptr;
+  CFX_GEModule::Create(g_user_font_paths);
   pdfium::InitializePageModule();
 
 #if defined(PDF_USE_SKIA)
@@ -262,7 +395,10 @@ FPDF_InitLibraryWithConfig(const FPDF_LIBRARY_CONFIG* config) {
       SetRendererType(config->m_RendererType);
     }
   }
+  g_band_worker_pool = new BandWorkerPool();
   g_bLibraryInitialized = true;
+  g_thread_state = ThreadState::kLibrary;
+  SetHasCustomSystemFontInfo(false);
 }
 
 FPDF_EXPORT void FPDF_CALLCONV FPDF_DestroyLibrary() {
@@ -271,6 +407,9 @@ FPDF_EXPORT void FPDF_CALLCONV FPDF_DestroyLibrary() {
   }
 
   // Note: we teardown/destroy things in reverse order.
+  delete g_band_worker_pool;
+  g_band_worker_pool = nullptr;
+
   ResetRendererType();
 
   IJS_Runtime::Destroy();
@@ -288,7 +427,33 @@ FPDF_EXPORT void FPDF_CALLCONV FPDF_DestroyLibrary() {
   CFX_Timer::DestroyGlobals();
   FX_DestroyMemoryAllocators();
 
+  g_user_font_paths = nullptr;
+  CFX_FontCache::GetGlyphCacheBudget()->SetMaxBytes(CacheBudget::kUnlimited);
+  CPDF_DocImageCache::GetImageBudget()->SetMaxBytes(
+      CPDF_DocImageCache::kDefaultMaxBytes);
+  CJBig2_SymbolDictCache::GetSymbolDictBudget()->SetMaxBytes(
+      CJBig2_SymbolDictCache::kDefaultMaxBytes);
   g_bLibraryInitialized = false;
+  g_thread_state = ThreadState::kNone;
+}
+
+FPDF_EXPORT void FPDF_CALLCONV FPDF_InitThread() {
+  if (!g_bLibraryInitialized || g_thread_state != ThreadState::kNone) {
+    return;
+  }
+
+  CFX_GEModule::Create(g_user_font_paths);
+  g_thread_state = ThreadState::kWorker;
+  SetHasCustomSystemFontInfo(false);
+}
+
+FPDF_EXPORT void FPDF_CALLCONV FPDF_DestroyThread() {
+  if (g_thread_state != ThreadState::kWorker) {
+    return;
+  }
+
+  CFX_GEModule::Destroy();
+  g_thread_state = ThreadState::kNone;
 }
 
 FPDF_EXPORT void FPDF_CALLCONV FPDF_SetSandBoxPolicy(FPDF_DWORD policy,
@@ -296,6 +461,41 @@ FPDF_EXPORT void FPDF_CALLCONV FPDF_SetSandBoxPolicy(FPDF_DWORD policy,
   return SetPDFSandboxPolicy(policy, enable);
 }
 
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV FPDF_SetCacheLimit(int cache,
+                                                       size_t max_bytes) {
+  CacheBudget* budget = GetCacheBudget(cache);
+  if (!budget || !g_bLibraryInitialized) {
+    return false;
+  }
+
+  budget->SetMaxBytes(max_bytes);
+  // Other caches trim themselves the next time they get used.
+  if (cache == FPDF_CACHE_GLYPHS && g_thread_state != ThreadState::kNone) {
+    CFX_GEModule::Get()->GetFontCache()->TrimGlyphCaches();
+  }
+  return true;
+}
+
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV
+FPDF_GetCacheStats(int cache, FPDF_CACHE_STATS* stats) {
+  CacheBudget* budget = GetCacheBudget(cache);
+  if (!budget || !stats || !g_bLibraryInitialized) {
+    return false;
+  }
+
+  const CacheBudget::Stats cache_stats = budget->GetStats();
+  stats->hits = cache_stats.hits;
+  stats->misses = cache_stats.misses;
+  stats->evictions = cache_stats.evictions;
+  stats->bytes = cache_stats.bytes;
+  stats->max_bytes = cache_stats.max_bytes;
+  return true;
+}
+
+FPDF_EXPORT void FPDF_CALLCONV FPDF_SetMaxFlateDecodeSize(size_t max_size) {
+  SetMaxFlateDecodeSize(max_size);
+}
+
 #if BUILDFLAG(IS_WIN)
 FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV FPDF_SetPrintMode(int mode) {
   if (mode < FPDF_PRINTMODE_EMF ||
@@ -312,8 +512,8 @@ FPDF_EXPORT FPDF_DOCUMENT FPDF_CALLCONV
 FPDF_LoadDocument(FPDF_STRING file_path, FPDF_BYTESTRING password) {
   // NOTE: the creation of the file needs to be by the embedder on the
   // other side of this API.
-  return LoadDocumentImpl(IFX_SeekableReadStream::CreateFromFilename(file_path),
-                          password);
+  return LoadDocumentImpl(
+      IFX_SeekableReadStream::CreateMappedFromFilename(file_path), password);
 }
 
 FPDF_EXPORT int FPDF_CALLCONV FPDF_GetFormType(FPDF_DOCUMENT document) {
@@ -389,6 +589,28 @@ FPDF_LoadCustomDocument(FPDF_FILEACCESS* pFileAccess,
                           password);
 }
 
+FPDF_EXPORT FPDF_DOCUMENT FPDF_CALLCONV FPDF_LoadCustomDocumentWithFileData(
+    FPDF_FILEACCESS* pFileAccess,
+    const unsigned char* (*get_file_data)(void* param),
+    FPDF_BYTESTRING password) {
+  if (!pFileAccess) {
+    return nullptr;
+  }
+
+  const unsigned char* data =
+      get_file_data ? get_file_data(pFileAccess->m_Param) : nullptr;
+  if (!data || !pFileAccess->m_FileLen) {
+    return FPDF_LoadCustomDocument(pFileAccess, password);
+  }
+
+  // SAFETY: required from caller.
+  auto file_data = UNSAFE_BUFFERS(pdfium::span(
+      data, static_cast<size_t>(pFileAccess->m_FileLen)));
+  return LoadDocumentImpl(
+      pdfium::MakeRetain<CPDFSDK_CustomAccess>(pFileAccess, file_data),
+      password);
+}
+
 FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV FPDF_GetFileVersion(FPDF_DOCUMENT doc,
                                                         int* fileVersion) {
   if (!fileVersion) {
@@ -498,6 +720,108 @@ FPDF_EXPORT FPDF_PAGE FPDF_CALLCONV FPDF_LoadPage(FPDF_DOCUMENT document,
   return FPDFPageFromIPDFPage(pPage.Leak());
 }
 
+namespace {
+
+// Runs the filters of `streams`, after CPDF_StreamAcc::PrepareFilteredDecode(),
+// on up to `thread_count` threads, including the calling thread.
+void DecodeStreamsInParallel(
+    pdfium::span<const RetainPtr<CPDF_StreamAcc>> streams,
+    int thread_count) {
+  std::atomic<size_t> next_stream = 0;
+  auto decode_streams = [streams, &next_stream] {
+    for (size_t i = next_stream++; i < streams.size(); i = next_stream++) {
+      streams[i]->DecodePrepared();
+    }
+  };
+
+  const size_t worker_count =
+      std::min(static_cast<size_t>(std::max(thread_count, 1)), streams.size());
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < worker_count; ++i) {
+    threads.emplace_back(decode_streams);
+  }
+  decode_streams();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+}  // namespace
+
+FPDF_EXPORT int FPDF_CALLCONV
+FPDF_LoadPageRangeWithDecodeThreads(FPDF_DOCUMENT document,
+                                    int start_index,
+                                    int page_count,
+                                    FPDF_PAGE* pages,
+                                    int decode_thread_count) {
+  auto* doc = CPDFDocumentFromFPDFDocument(document);
+  if (!doc || !pages || start_index < 0 || page_count < 0) {
+    return -1;
+  }
+
+  FX_SAFE_INT32 end_index = start_index;
+  end_index += page_count;
+  if (!end_index.IsValid() ||
+      end_index.ValueOrDie() > FPDF_GetPageCount(document)) {
+    return -1;
+  }
+
+  // SAFETY: required from caller.
+  auto page_span = UNSAFE_BUFFERS(
+      pdfium::span(pages, static_cast<size_t>(page_count)));
+  int loaded_count = 0;
+#ifdef PDF_ENABLE_XFA
+  if (doc->GetExtension()) {
+    for (int i = 0; i < page_count; ++i) {
+      page_span[i] = FPDF_LoadPage(document, start_index + i);
+      if (page_span[i]) {
+        ++loaded_count;
+      }
+    }
+    return loaded_count;
+  }
+#endif  // PDF_ENABLE_XFA
+
+  // Everything that touches the document happens on this thread. The other
+  // threads only run the filters of the content streams.
+  std::vector<RetainPtr<CPDF_Page>> loaded_pages(page_count);
+  std::vector<std::vector<RetainPtr<CPDF_StreamAcc>>> page_streams(
+      page_count);
+  std::vector<RetainPtr<CPDF_StreamAcc>> all_streams;
+  for (int i = 0; i < page_count; ++i) {
+    RetainPtr<CPDF_Dictionary> dict =
+        doc->GetMutablePageDictionary(start_index + i);
+    if (!dict) {
+      continue;
+    }
+
+    auto page = pdfium::MakeRetain<CPDF_Page>(doc, std::move(dict));
+    page->AddPageImageCache();
+    page_streams[i] = CPDF_ContentParser::GetPageContentStreams(page.Get());
+    for (const auto& stream : page_streams[i]) {
+      stream->PrepareFilteredDecode();
+      all_streams.push_back(stream);
+    }
+    loaded_pages[i] = std::move(page);
+  }
+
+  DecodeStreamsInParallel(all_streams, decode_thread_count);
+  all_streams.clear();
+
+  for (int i = 0; i < page_count; ++i) {
+    RetainPtr<CPDF_Page>& page = loaded_pages[i];
+    if (!page) {
+      page_span[i] = nullptr;
+      continue;
+    }
+
+    page->ParseContentWithLoadedStreams(std::move(page_streams[i]));
+    page_span[i] = FPDFPageFromIPDFPage(page.Leak());
+    ++loaded_count;
+  }
+  return loaded_count;
+}
+
 FPDF_EXPORT float FPDF_CALLCONV FPDF_GetPageWidthF(FPDF_PAGE page) {
   IPDF_Page* pPage = IPDFPageFromFPDFPage(page);
   return pPage ? pPage->GetPageWidth() : 0.0f;
@@ -746,6 +1070,369 @@ FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV FPDF_RenderPage(HDC dc,
 }
 #endif  // BUILDFLAG(IS_WIN)
 
+namespace {
+
+// What a worker thread needs to render one band of a page for
+// FPDF_RenderPageBitmapInBands(). Reference counts are not atomic, so workers
+// never touch the calling thread's objects. They get plain data instead, and
+// load their own copy of the page from `snapshot`.
+struct BandRenderParams {
+  pdfium::raw_span<const uint8_t> snapshot;
+  int bitmap_width;
+  int bitmap_height;
+  FXDIB_Format bitmap_format;
+  uint32_t bitmap_pitch;
+  UnownedPtr<uint8_t> bitmap_buffer;
+  CFX_Matrix matrix;
+  int flags;
+};
+
+struct RenderBand {
+  FX_RECT rect;
+  bool rendered = false;
+};
+
+// An image that the page draws within `rect`, in page space. Every band that
+// draws part of it decodes all of its `pixels`.
+struct BandImage {
+  CFX_FloatRect rect;
+  size_t pixels;
+};
+
+// What FPDF_RenderPageBitmapInBands() keeps with a page between calls.
+class BandSnapshot final : public CPDF_Page::SnapshotIface {
+ public:
+  BandSnapshot(ByteString source,
+               RetainPtr<CFX_MemoryStream> stream,
+               std::vector<BandImage> images)
+      : source_(std::move(source)),
+        stream_(std::move(stream)),
+        images_(std::move(images)) {}
+  ~BandSnapshot() override = default;
+
+  // From SnapshotSourceDescriber, when `stream_` was written.
+  const ByteString& source() const { return source_; }
+  pdfium::span<const uint8_t> data() const { return stream_->GetSpan(); }
+  pdfium::span<const BandImage> images() const { return images_; }
+
+ private:
+  const ByteString source_;
+  const RetainPtr<CFX_MemoryStream> stream_;
+  const std::vector<BandImage> images_;
+};
+
+// Splits the rows of `rect` evenly, with the remainder going to the first
+// bands.
+std::vector<RenderBand> SplitIntoBands(const FX_RECT& rect, int band_count) {
+  const int rows = rect.Height();
+  std::vector<RenderBand> bands(band_count);
+  int band_top = rect.top;
+  for (int i = 0; i < band_count; ++i) {
+    const int band_rows = rows / band_count + (i < rows % band_count ? 1 : 0);
+    bands[i].rect =
+        FX_RECT(rect.left, band_top, rect.right, band_top + band_rows);
+    band_top += band_rows;
+  }
+  return bands;
+}
+
+// Renders the part of `page` inside `band_rect`. The device clip culls the
+// page objects outside of the band.
+void RenderPageBand(CPDF_Page* page,
+                    RetainPtr<CFX_DIBitmap> bitmap,
+                    const CFX_Matrix& matrix,
+                    const FX_RECT& band_rect,
+                    int flags) {
+  auto owned_context = std::make_unique<CPDF_PageRenderContext>();
+  CPDF_PageRenderContext* context = owned_context.get();
+  CPDF_Page::RenderContextClearer clearer(page);
+  page->SetRenderContext(std::move(owned_context));
+
+  auto device = std::make_unique<CFX_DefaultRenderDevice>();
+  device->AttachWithRgbByteOrder(std::move(bitmap),
+                                 !!(flags & FPDF_REVERSE_BYTE_ORDER));
+  context->device_ = std::move(device);
+  CPDFSDK_RenderPage(context, page, matrix, band_rect, flags,
+                     /*color_scheme=*/nullptr);
+}
+
+// Whether `page` has page object changes that FPDFPage_GenerateContent() did
+// not write to the document yet.
+bool HasUngeneratedChanges(const CPDF_Page* page) {
+  return page->HasDirtyStreams() ||
+         std::ranges::any_of(*page, [](const auto& page_object) {
+           return page_object->IsDirty();
+         });
+}
+
+// Whether rendering annotations regenerates widget appearances, which changes
+// the document.
+bool NeedsWidgetAppearances(const CPDF_Document* doc) {
+  const CPDF_Dictionary* root = doc->GetRoot();
+  RetainPtr<const CPDF_Dictionary> acro_form =
+      root ? root->GetDictFor("AcroForm") : nullptr;
+  return acro_form && acro_form->GetBooleanFor("NeedAppearances", false);
+}
+
+// Describes what SnapshotPage() copies for a page, with the data of streams
+// stood in for by CPDF_Stream::GetDataId(). A snapshot stays current for as
+// long as the description of its page stays the same.
+class SnapshotSourceDescriber {
+ public:
+  SnapshotSourceDescriber() = default;
+  ~SnapshotSourceDescriber() = default;
+
+  ByteString Describe(const CPDF_Page* page) {
+    const CPDF_Dictionary* page_dict = page->GetDict();
+    visited_.insert(page_dict->GetObjNum());
+    DescribeObject(page_dict, /*follow_references=*/true);
+
+    // Inheritable attributes, as far up the page tree as they may come from.
+    std::set<const CPDF_Dictionary*> ancestors;
+    RetainPtr<const CPDF_Dictionary> ancestor =
+        page_dict->GetDictFor(pdfium::page_object::kParent);
+    while (ancestor && ancestors.insert(ancestor.Get()).second) {
+      for (ByteStringView key :
+           {pdfium::page_object::kMediaBox, pdfium::page_object::kCropBox,
+            pdfium::page_object::kResources, pdfium::page_object::kRotate}) {
+        out_ << 'i' << key;
+        RetainPtr<const CPDF_Object> value = ancestor->GetObjectFor(key);
+        if (value) {
+          DescribeObject(value.Get(), /*follow_references=*/true);
+        }
+      }
+      ancestor = ancestor->GetDictFor(pdfium::page_object::kParent);
+    }
+
+    const CPDF_Dictionary* root = page->GetDocument()->GetRoot();
+    RetainPtr<const CPDF_Object> oc_properties =
+        root ? root->GetObjectFor("OCProperties") : nullptr;
+    if (oc_properties) {
+      out_ << 'o';
+      DescribeObject(oc_properties.Get(), /*follow_references=*/true);
+    }
+    return ByteString(out_);
+  }
+
+ private:
+  // Strings are prefixed with their length, so that descriptions of different
+  // objects never run together into the same text.
+  void DescribeString(ByteStringView str) {
+    out_ << str.GetLength() << ':' << str;
+  }
+
+  void DescribeObject(const CPDF_Object* object, bool follow_references) {
+    switch (object->GetType()) {
+      case CPDF_Object::kBoolean:
+      case CPDF_Object::kNumber:
+      case CPDF_Object::kString:
+      case CPDF_Object::kName:
+        out_ << static_cast<int>(object->GetType());
+        DescribeString(object->GetString().AsStringView());
+        return;
+      case CPDF_Object::kNullobj:
+        out_ << 'n';
+        return;
+      case CPDF_Object::kArray: {
+        out_ << '[';
+        CPDF_ArrayLocker locker(object->AsArray());
+        for (const auto& item : locker) {
+          DescribeObject(item.Get(), follow_references);
+        }
+        out_ << ']';
+        return;
+      }
+      case CPDF_Object::kDictionary: {
+        out_ << '<';
+        CPDF_DictionaryLocker locker(object->AsDictionary());
+        for (const auto& it : locker) {
+          DescribeString(it.first.AsStringView());
+          // Like CPDF_PageOrganizer::UpdateReference(), which leaves these
+          // alone.
+          const bool follow = follow_references && it.first != "Parent" &&
+                              it.first != "Prev" && it.first != "First";
+          DescribeObject(it.second.Get(), follow);
+        }
+        out_ << '>';
+        return;
+      }
+      case CPDF_Object::kStream: {
+        const CPDF_Stream* stream = object->AsStream();
+        DescribeObject(stream->GetDict().Get(), follow_references);
+        out_ << 's' << stream->GetDataId();
+        return;
+      }
+      case CPDF_Object::kReference: {
+        const uint32_t obj_num = object->AsReference()->GetRefObjNum();
+        out_ << 'r' << obj_num;
+        if (!follow_references || !visited_.insert(obj_num).second) {
+          return;
+        }
+        RetainPtr<const CPDF_Object> direct = object->GetDirect();
+        if (!direct) {
+          out_ << 'n';
+          return;
+        }
+        // Like CPDF_PageOrganizer::GetNewObjId(), which does not copy pages.
+        const CPDF_Dictionary* dict = direct->AsDictionary();
+        if (dict) {
+          const ByteString type = dict->GetByteStringFor("Type");
+          if (type.EqualNoCase("Page") || type.EqualNoCase("Pages")) {
+            out_ << 'p';
+            return;
+          }
+        }
+        DescribeObject(direct.Get(), /*follow_references=*/true);
+        return;
+      }
+    }
+  }
+
+  fxcrt::ostringstream out_;
+  std::set<uint32_t> visited_;
+};
+
+// Adds the images that `holder` draws, with `matrix` from the space of
+// `holder` to page space.
+void CollectBandImages(const CPDF_PageObjectHolder* holder,
+                       const CFX_Matrix& matrix,
+                       std::vector<BandImage>& images) {
+  for (const auto& object : *holder) {
+    if (const CPDF_ImageObject* image_object = object->AsImage()) {
+      RetainPtr<const CPDF_Image> image = image_object->GetImage();
+      FX_SAFE_SIZE_T pixels = image->GetPixelWidth();
+      pixels *= image->GetPixelHeight();
+      images.push_back({
+          .rect = matrix.TransformRect(image_object->GetRect()),
+          .pixels = pixels.ValueOrDefault(std::numeric_limits<size_t>::max()),
+      });
+    } else if (const CPDF_FormObject* form_object = object->AsForm()) {
+      CollectBandImages(form_object->form(),
+                        form_object->form_matrix() * matrix, images);
+    }
+  }
+}
+
+// Returns how many of up to `band_count` bands to render `images` in, such
+// that decoding images in more than one band costs fewer pixels than the
+// other threads render. Returns 1 if no band count does.
+int LimitBandCountForImages(pdfium::span<const BandImage> images,
+                            const CFX_Matrix& matrix,
+                            const FX_RECT& clip_rect,
+                            int band_count) {
+  FX_SAFE_SIZE_T safe_area = clip_rect.Width();
+  safe_area *= clip_rect.Height();
+  const size_t area = safe_area.ValueOrDie();
+  for (; band_count > 1; --band_count) {
+    const std::vector<RenderBand> bands = SplitIntoBands(clip_rect, band_count);
+    FX_SAFE_SIZE_T extra_pixels = 0;
+    for (const BandImage& image : images) {
+      const FX_RECT image_rect =
+          matrix.TransformRect(image.rect).GetOuterRect();
+      const auto decodes =
+          std::ranges::count_if(bands, [&image_rect](const RenderBand& band) {
+            FX_RECT rect = band.rect;
+            rect.Intersect(image_rect);
+            return !rect.IsEmpty();
+          });
+      if (decodes > 1) {
+        extra_pixels += FX_SAFE_SIZE_T(image.pixels) * (decodes - 1);
+      }
+    }
+    const size_t other_bands_area = area - area / band_count;
+    if (extra_pixels.IsValid() &&
+        extra_pixels.ValueOrDie() <= other_bands_area) {
+      return band_count;
+    }
+  }
+  return 1;
+}
+
+// Writes a single page document with the page at `page_index` of `doc` as it
+// is in memory, along with the optional content configuration.
+RetainPtr<CFX_MemoryStream> SnapshotPage(CPDF_Document* doc, int page_index) {
+  CPDF_Document snapshot(std::make_unique<CPDF_DocRenderData>(),
+                         std::make_unique<CPDF_DocPageData>());
+  snapshot.CreateNewDoc();
+
+  CPDF_PageExporter exporter(&snapshot, doc);
+  const uint32_t page_indices[] = {static_cast<uint32_t>(page_index)};
+  if (!exporter.ExportPages(page_indices, 0) ||
+      !exporter.ExportCatalogEntry("OCProperties")) {
+    return nullptr;
+  }
+
+  auto stream = pdfium::MakeRetain<CFX_MemoryStream>();
+  CPDF_Creator creator(&snapshot, stream);
+  if (!creator.Create(0)) {
+    return nullptr;
+  }
+  return stream;
+}
+
+// Returns the snapshot of `page` from an earlier call if the page has not
+// changed since, or else a new one.
+BandSnapshot* GetBandSnapshot(CPDF_Page* page) {
+  ByteString source = SnapshotSourceDescriber().Describe(page);
+  auto* snapshot = static_cast<BandSnapshot*>(page->GetSnapshot());
+  if (snapshot && snapshot->source() == source) {
+    return snapshot;
+  }
+  page->SetSnapshot(nullptr);
+
+  CPDF_Document* doc = page->GetDocument();
+  const int page_index = doc->GetPageIndex(page->GetDict()->GetObjNum());
+  if (page_index < 0) {
+    return nullptr;
+  }
+  RetainPtr<CFX_MemoryStream> stream = SnapshotPage(doc, page_index);
+  if (!stream) {
+    return nullptr;
+  }
+  std::vector<BandImage> images;
+  CollectBandImages(page, CFX_Matrix(), images);
+  auto new_snapshot = std::make_unique<BandSnapshot>(
+      std::move(source), std::move(stream), std::move(images));
+  snapshot = new_snapshot.get();
+  page->SetSnapshot(std::move(new_snapshot));
+  return snapshot;
+}
+
+// Runs on a worker thread with its own engine state.
+bool RenderPageBandFromSnapshot(const BandRenderParams& params,
+                                const FX_RECT& band_rect) {
+  auto document =
+      std::make_unique<CPDF_Document>(std::make_unique<CPDF_DocRenderData>(),
+                                      std::make_unique<CPDF_DocPageData>());
+  if (document->LoadDoc(
+          pdfium::MakeRetain<CFX_ReadOnlySpanStream>(params.snapshot),
+          nullptr) != CPDF_Parser::SUCCESS) {
+    return false;
+  }
+
+  RetainPtr<CPDF_Dictionary> dict = document->GetMutablePageDictionary(0);
+  if (!dict) {
+    return false;
+  }
+
+  auto page = pdfium::MakeRetain<CPDF_Page>(document.get(), std::move(dict));
+  page->AddPageImageCache();
+  page->ParseContent();
+
+  // Shares the destination bitmap's pixels, so the band lands in place.
+  auto bitmap = pdfium::MakeRetain<CFX_DIBitmap>();
+  if (!bitmap->Create(params.bitmap_width, params.bitmap_height,
+                      params.bitmap_format, params.bitmap_buffer.get(),
+                      params.bitmap_pitch)) {
+    return false;
+  }
+  RenderPageBand(page.Get(), std::move(bitmap), params.matrix, band_rect,
+                 params.flags);
+  return true;
+}
+
+}  // namespace
+
 FPDF_EXPORT void FPDF_CALLCONV FPDF_RenderPageBitmap(FPDF_BITMAP bitmap,
                                                      FPDF_PAGE page,
                                                      int start_x,
@@ -784,6 +1471,125 @@ FPDF_EXPORT void FPDF_CALLCONV FPDF_RenderPageBitmap(FPDF_BITMAP bitmap,
                                 /*pause=*/nullptr);
 }
 
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV
+FPDF_RenderPageBitmapInBands(FPDF_BITMAP bitmap,
+                             FPDF_PAGE page,
+                             int start_x,
+                             int start_y,
+                             int size_x,
+                             int size_y,
+                             int rotate,
+                             int flags,
+                             int band_count) {
+  CPDF_Page* pPage = CPDFPageFromFPDFPage(page);
+  if (!pPage) {
+    return false;
+  }
+
+  RetainPtr<CFX_DIBitmap> pBitmap(CFXDIBitmapFromFPDFBitmap(bitmap));
+  if (!pBitmap) {
+    return false;
+  }
+  ValidateBitmapPremultiplyState(pBitmap);
+
+  const FX_RECT rect(start_x, start_y, start_x + size_x, start_y + size_y);
+  FX_RECT clip_rect = rect;
+  clip_rect.Intersect(FX_RECT(0, 0, pBitmap->GetWidth(), pBitmap->GetHeight()));
+  const int rows = clip_rect.IsEmpty() ? 0 : clip_rect.Height();
+  band_count = std::min(band_count, rows);
+
+  CPDF_Document* doc = pPage->GetDocument();
+  const CFX_Matrix matrix = pPage->GetDisplayMatrixForRect(rect, rotate);
+  BandSnapshot* snapshot = nullptr;
+  if (band_count > 1 && !doc->GetExtension() &&
+      pPage->GetDict()->GetObjNum() &&
+      !CFX_DefaultRenderDevice::UseSkiaRenderer() &&
+      !HasCustomSystemFontInfo() && !HasUngeneratedChanges(pPage) &&
+      !((flags & FPDF_ANNOT) && NeedsWidgetAppearances(doc))) {
+    snapshot = GetBandSnapshot(pPage);
+  }
+  if (snapshot) {
+    band_count = LimitBandCountForImages(snapshot->images(), matrix, clip_rect,
+                                         band_count);
+  }
+  if (!snapshot || band_count < 2) {
+    FPDF_RenderPageBitmap(bitmap, page, start_x, start_y, size_x, size_y,
+                          rotate, flags);
+    return false;
+  }
+
+  const BandRenderParams params = {
+      .snapshot = snapshot->data(),
+      .bitmap_width = pBitmap->GetWidth(),
+      .bitmap_height = pBitmap->GetHeight(),
+      .bitmap_format = pBitmap->GetFormat(),
+      .bitmap_pitch = pBitmap->GetPitch(),
+      .bitmap_buffer =
+          UnownedPtr<uint8_t>(pBitmap->GetWritableBuffer().data()),
+      .matrix = matrix,
+      .flags = flags,
+  };
+
+  std::vector<RenderBand> bands = SplitIntoBands(clip_rect, band_count);
+  std::vector<std::function<void()>> tasks;
+  tasks.reserve(bands.size() - 1);
+  for (size_t i = 1; i < bands.size(); ++i) {
+    tasks.push_back([&params, &band = bands[i]] {
+      band.rendered = RenderPageBandFromSnapshot(params, band.rect);
+    });
+  }
+  g_band_worker_pool->Run(std::move(tasks), [&] {
+    RenderPageBand(pPage, pBitmap, params.matrix, bands[0].rect, flags);
+    bands[0].rendered = true;
+  });
+
+  // Fall back to the calling thread for bands that failed on a worker.
+  for (const RenderBand& band : bands) {
+    if (!band.rendered) {
+      RenderPageBand(pPage, pBitmap, params.matrix, band.rect, flags);
+    }
+  }
+  return true;
+}
+
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV FPDF_RenderPageTile(FPDF_BITMAP bitmap,
+                                                        FPDF_PAGE page,
+                                                        float scale,
+                                                        int tile_x,
+                                                        int tile_y,
+                                                        int rotate,
+                                                        int flags) {
+  CPDF_Page* pPage = CPDFPageFromFPDFPage(page);
+  CFX_DIBitmap* pBitmap = CFXDIBitmapFromFPDFBitmap(bitmap);
+  if (!pPage || !pBitmap || !(scale > 0) || tile_x < 0 || tile_y < 0) {
+    return false;
+  }
+
+  CFX_SizeF page_size = pPage->GetPageSize();
+  if (rotate % 2) {
+    std::swap(page_size.width, page_size.height);
+  }
+  const float page_width = page_size.width * scale;
+  const float page_height = page_size.height * scale;
+  if (!pdfium::IsValueInRangeForNumericType<int>(page_width) ||
+      !pdfium::IsValueInRangeForNumericType<int>(page_height)) {
+    return false;
+  }
+
+  FX_SAFE_INT32 start_x = tile_x;
+  start_x *= -pBitmap->GetWidth();
+  FX_SAFE_INT32 start_y = tile_y;
+  start_y *= -pBitmap->GetHeight();
+  if (!start_x.IsValid() || !start_y.IsValid()) {
+    return false;
+  }
+
+  FPDF_RenderPageBitmap(bitmap, page, start_x.ValueOrDie(),
+                        start_y.ValueOrDie(), static_cast<int>(page_width),
+                        static_cast<int>(page_height), rotate, flags);
+  return true;
+}
+
 FPDF_EXPORT void FPDF_CALLCONV
 FPDF_RenderPageBitmapWithMatrix(FPDF_BITMAP bitmap,
                                 FPDF_PAGE page,
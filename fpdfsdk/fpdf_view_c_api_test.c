@@ -429,6 +429,8 @@ int CheckPDFiumCApi() {
     CHK(FPDFLink_GetTextRange);
     CHK(FPDFLink_GetURL);
     CHK(FPDFLink_LoadWebLinks);
+    CHK(FPDFText_BuildIndex);
+    CHK(FPDFText_CloseIndex);
     CHK(FPDFText_ClosePage);
     CHK(FPDFText_CountChars);
     CHK(FPDFText_CountRects);
@@ -455,8 +457,13 @@ int CheckPDFiumCApi() {
     CHK(FPDFText_GetTextObject);
     CHK(FPDFText_GetUnicode);
     CHK(FPDFText_HasUnicodeMapError);
+    CHK(FPDFText_IndexFindClose);
+    CHK(FPDFText_IndexFindNext);
+    CHK(FPDFText_IndexFindStart);
+    CHK(FPDFText_IndexGetResult);
     CHK(FPDFText_IsGenerated);
     CHK(FPDFText_IsHyphen);
+    CHK(FPDFText_LoadIndex);
     CHK(FPDFText_LoadPage);
 
     // fpdf_thumbnail.h
@@ -504,11 +511,13 @@ int CheckPDFiumCApi() {
     CHK(FPDF_ClosePage);
     CHK(FPDF_CountNamedDests);
     CHK(FPDF_DestroyLibrary);
+    CHK(FPDF_DestroyThread);
     CHK(FPDF_DeviceToPage);
     CHK(FPDF_DocumentHasValidCrossReferenceTable);
 #ifdef PDF_ENABLE_V8
     CHK(FPDF_GetArrayBufferAllocatorSharedInstance);
 #endif
+    CHK(FPDF_GetCacheStats);
     CHK(FPDF_GetDocPermissions);
     CHK(FPDF_GetDocUserPermissions);
     CHK(FPDF_GetFileVersion);
@@ -533,23 +542,30 @@ int CheckPDFiumCApi() {
     CHK(FPDF_GetXFAPacketName);
     CHK(FPDF_InitLibrary);
     CHK(FPDF_InitLibraryWithConfig);
+    CHK(FPDF_InitThread);
     CHK(FPDF_LoadCustomDocument);
+    CHK(FPDF_LoadCustomDocumentWithFileData);
     CHK(FPDF_LoadDocument);
     CHK(FPDF_LoadMemDocument);
     CHK(FPDF_LoadMemDocument64);
     CHK(FPDF_LoadPage);
+    CHK(FPDF_LoadPageRangeWithDecodeThreads);
     CHK(FPDF_PageToDevice);
 #ifdef _WIN32
     CHK(FPDF_RenderPage);
 #endif
     CHK(FPDF_RenderPageBitmap);
+    CHK(FPDF_RenderPageBitmapInBands);
     CHK(FPDF_RenderPageBitmapWithMatrix);
 #if defined(PDF_USE_SKIA)
     CHK(FPDF_RenderPageSkia);
 #endif
+    CHK(FPDF_RenderPageTile);
 #if defined(_WIN32)
     CHK(FPDF_SetPrintMode);
 #endif
+    CHK(FPDF_SetCacheLimit);
+    CHK(FPDF_SetMaxFlateDecodeSize);
     CHK(FPDF_SetSandBoxPolicy);
     CHK(FPDF_VIEWERREF_GetDuplex);
     CHK(FPDF_VIEWERREF_GetName);
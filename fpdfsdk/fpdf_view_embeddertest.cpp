@@ -8,15 +8,22 @@
 #include <limits>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
 #include "build/build_config.h"
 #include "core/fpdfapi/parser/cpdf_document.h"
+#include "core/fxcrt/compiler_specific.h"
+#include "core/fxcrt/span.h"
+#include "core/fxcrt/stl_util.h"
 #include "core/fxge/cfx_defaultrenderdevice.h"
 #include "fpdfsdk/cpdfsdk_helpers.h"
 #include "fpdfsdk/fpdf_view_c_api_test.h"
 #include "public/cpp/fpdf_scopers.h"
+#include "public/fpdf_annot.h"
+#include "public/fpdf_edit.h"
+#include "public/fpdf_save.h"
 #include "public/fpdfview.h"
 #include "testing/embedder_test.h"
 #include "testing/embedder_test_constants.h"
@@ -151,6 +158,47 @@ ScopedFPDFBitmap SkPictureToPdfiumBitmap(sk_sp<SkPicture> picture,
 }
 #endif  // defined(PDF_USE_SKIA)
 
+// Returns all the rows of `bitmap`.
+pdfium::span<const uint8_t> GetBitmapBuffer(FPDF_BITMAP bitmap) {
+  // SAFETY: FPDF_BITMAP buffers hold `stride` bytes for each row.
+  return UNSAFE_BUFFERS(pdfium::span(
+      static_cast<const uint8_t*>(FPDFBitmap_GetBuffer(bitmap)),
+      static_cast<size_t>(FPDFBitmap_GetStride(bitmap)) *
+          FPDFBitmap_GetHeight(bitmap)));
+}
+
+// Checks that `tile` matches the same area of `page_bitmap`, for a tile of the
+// page rendered by FPDF_RenderPageTile().
+void CompareTile(FPDF_BITMAP page_bitmap,
+                 FPDF_BITMAP tile,
+                 int tile_x,
+                 int tile_y) {
+  const int tile_width = FPDFBitmap_GetWidth(tile);
+  const int tile_height = FPDFBitmap_GetHeight(tile);
+  const int left = tile_x * tile_width;
+  const int top = tile_y * tile_height;
+  const int width =
+      std::min(tile_width, FPDFBitmap_GetWidth(page_bitmap) - left);
+  const int height =
+      std::min(tile_height, FPDFBitmap_GetHeight(page_bitmap) - top);
+  ASSERT_GT(width, 0);
+  ASSERT_GT(height, 0);
+
+  pdfium::span<const uint8_t> page_buffer = GetBitmapBuffer(page_bitmap);
+  pdfium::span<const uint8_t> tile_buffer = GetBitmapBuffer(tile);
+  const size_t page_stride = FPDFBitmap_GetStride(page_bitmap);
+  const size_t tile_stride = FPDFBitmap_GetStride(tile);
+  const size_t row_bytes = width * 4;
+  for (int row = 0; row < height; ++row) {
+    pdfium::span<const uint8_t> expected = page_buffer.subspan(
+        (top + row) * page_stride + left * 4, row_bytes);
+    pdfium::span<const uint8_t> actual =
+        tile_buffer.subspan(row * tile_stride, row_bytes);
+    ASSERT_TRUE(std::ranges::equal(expected, actual))
+        << "tile " << tile_x << "," << tile_y << " row " << row;
+  }
+}
+
 }  // namespace
 
 TEST(fpdf, CApiTest) {
@@ -630,6 +678,53 @@ TEST_F(FPDFViewEmbedderTest, LoadCustomDocumentWithShortLivedFileAccess) {
   EXPECT_FLOAT_EQ(300.0f, FPDF_GetPageHeightF(page.get()));
 }
 
+TEST_F(FPDFViewEmbedderTest, LoadCustomDocumentWithFileData) {
+  struct File {
+    std::vector<uint8_t> contents;
+    bool in_memory = false;
+    int get_block_count = 0;
+  };
+  File file;
+  std::string pdf_path = PathService::GetTestFilePath("rectangles.pdf");
+  ASSERT_FALSE(pdf_path.empty());
+  file.contents = GetFileContents(pdf_path.c_str());
+  ASSERT_FALSE(file.contents.empty());
+
+  FPDF_FILEACCESS file_access = {};
+  file_access.m_FileLen = file.contents.size();
+  file_access.m_GetBlock = [](void* param, unsigned long pos,
+                              unsigned char* buf, unsigned long size) {
+    auto* file = static_cast<File*>(param);
+    ++file->get_block_count;
+    // SAFETY: required from caller.
+    auto dest = UNSAFE_BUFFERS(pdfium::span(buf, size));
+    fxcrt::Copy(pdfium::span(file->contents).subspan(pos, size), dest);
+    return 1;
+  };
+  file_access.m_Param = &file;
+  auto get_file_data = [](void* param) -> const unsigned char* {
+    auto* file = static_cast<File*>(param);
+    return file->in_memory ? file->contents.data() : nullptr;
+  };
+
+  EXPECT_FALSE(
+      FPDF_LoadCustomDocumentWithFileData(nullptr, get_file_data, nullptr));
+
+  // Without the file data, blocks get read through `file_access`.
+  for (bool in_memory : {true, false}) {
+    file.in_memory = in_memory;
+    file.get_block_count = 0;
+    ScopedFPDFDocument doc(FPDF_LoadCustomDocumentWithFileData(
+        &file_access, get_file_data, nullptr));
+    ASSERT_TRUE(doc);
+    ScopedFPDFPage page(FPDF_LoadPage(doc.get(), 0));
+    ASSERT_TRUE(page);
+    ScopedFPDFBitmap bitmap = RenderPage(page.get());
+    CompareBitmap(bitmap.get(), 200, 300, pdfium::RectanglesChecksum());
+    EXPECT_EQ(in_memory, file.get_block_count == 0);
+  }
+}
+
 TEST_F(FPDFViewEmbedderTest, Page) {
   ASSERT_TRUE(OpenDocument("about_blank.pdf"));
   ScopedPage page = LoadScopedPage(0);
@@ -2271,3 +2366,632 @@ TEST_F(FPDFViewEmbedderTest, DocumentVersionInCatalog) {
   EXPECT_TRUE(FPDF_GetFileVersion(document(), &version));
   EXPECT_EQ(16, version);
 }
+
+TEST_F(FPDFViewEmbedderTest, CacheLimits) {
+  FPDF_CACHE_STATS stats;
+  EXPECT_FALSE(FPDF_GetCacheStats(-1, &stats));
+  EXPECT_FALSE(FPDF_GetCacheStats(3, &stats));
+  EXPECT_FALSE(FPDF_GetCacheStats(FPDF_CACHE_GLYPHS, nullptr));
+  EXPECT_FALSE(FPDF_SetCacheLimit(-1, 0));
+  EXPECT_FALSE(FPDF_SetCacheLimit(3, 0));
+
+  ASSERT_TRUE(FPDF_GetCacheStats(FPDF_CACHE_GLYPHS, &stats));
+  EXPECT_EQ(std::numeric_limits<size_t>::max(), stats.max_bytes);
+  ASSERT_TRUE(FPDF_GetCacheStats(FPDF_CACHE_IMAGES, &stats));
+  EXPECT_EQ(128u * 1024 * 1024, stats.max_bytes);
+  ASSERT_TRUE(FPDF_GetCacheStats(FPDF_CACHE_JBIG2_SYMBOL_DICTS, &stats));
+  EXPECT_EQ(32u * 1024 * 1024, stats.max_bytes);
+
+  ASSERT_TRUE(FPDF_SetCacheLimit(FPDF_CACHE_IMAGES, 1024));
+  ASSERT_TRUE(FPDF_GetCacheStats(FPDF_CACHE_IMAGES, &stats));
+  EXPECT_EQ(1024u, stats.max_bytes);
+  ASSERT_TRUE(FPDF_SetCacheLimit(FPDF_CACHE_IMAGES, 128 * 1024 * 1024));
+}
+
+TEST_F(FPDFViewEmbedderTest, GlyphCacheLimit) {
+  ASSERT_TRUE(OpenDocument("hello_world.pdf"));
+  ScopedPage page = LoadScopedPage(0);
+  ASSERT_TRUE(page);
+
+  FPDF_CACHE_STATS before;
+  ASSERT_TRUE(FPDF_GetCacheStats(FPDF_CACHE_GLYPHS, &before));
+  TestRenderPageBitmapWithFlags(page.get(), 0, pdfium::HelloWorldChecksum());
+  FPDF_CACHE_STATS after;
+  ASSERT_TRUE(FPDF_GetCacheStats(FPDF_CACHE_GLYPHS, &after));
+  if (!CFX_DefaultRenderDevice::UseSkiaRenderer()) {
+    EXPECT_GT(after.hits + after.misses, before.hits + before.misses);
+    EXPECT_GT(after.bytes, 0u);
+  }
+
+  // Evicting glyphs does not change the rendering.
+  ASSERT_TRUE(FPDF_SetCacheLimit(FPDF_CACHE_GLYPHS, 1));
+  ASSERT_TRUE(FPDF_GetCacheStats(FPDF_CACHE_GLYPHS, &after));
+  EXPECT_EQ(0u, after.bytes);
+  TestRenderPageBitmapWithFlags(page.get(), 0, pdfium::HelloWorldChecksum());
+  TestRenderPageBitmapWithFlags(page.get(), 0, pdfium::HelloWorldChecksum());
+  if (!CFX_DefaultRenderDevice::UseSkiaRenderer()) {
+    ASSERT_TRUE(FPDF_GetCacheStats(FPDF_CACHE_GLYPHS, &after));
+    EXPECT_GT(after.evictions, before.evictions);
+  }
+
+  ASSERT_TRUE(FPDF_SetCacheLimit(FPDF_CACHE_GLYPHS,
+                                 std::numeric_limits<size_t>::max()));
+}
+
+TEST_F(FPDFViewEmbedderTest, JBig2SymbolDictCache) {
+  // The image uses a symbol dictionary from its JBIG2Globals stream.
+  ASSERT_TRUE(OpenDocument("bug_631912.pdf"));
+  ScopedPage page = LoadScopedPage(0);
+  ASSERT_TRUE(page);
+  FPDF_PAGEOBJECT obj = FPDFPage_GetObject(page.get(), 0);
+  ASSERT_TRUE(obj);
+
+  // The counters cover all documents, so only look at how they change.
+  FPDF_CACHE_STATS before;
+  ASSERT_TRUE(FPDF_GetCacheStats(FPDF_CACHE_JBIG2_SYMBOL_DICTS, &before));
+  static constexpr char kChecksum[] = "3f6a48e2b3e91b799bf34567f55cb4de";
+  {
+    ScopedFPDFBitmap bitmap(FPDFImageObj_GetBitmap(obj));
+    CompareBitmap(bitmap.get(), 1152, 720, kChecksum);
+  }
+  FPDF_CACHE_STATS stats;
+  ASSERT_TRUE(FPDF_GetCacheStats(FPDF_CACHE_JBIG2_SYMBOL_DICTS, &stats));
+  EXPECT_EQ(before.hits, stats.hits);
+  EXPECT_EQ(before.misses + 1, stats.misses);
+  EXPECT_EQ(before.evictions, stats.evictions);
+  EXPECT_GT(stats.bytes, before.bytes);
+
+  // Decoding the image again uses the cached dictionary.
+  {
+    ScopedFPDFBitmap bitmap(FPDFImageObj_GetBitmap(obj));
+    CompareBitmap(bitmap.get(), 1152, 720, kChecksum);
+  }
+  ASSERT_TRUE(FPDF_GetCacheStats(FPDF_CACHE_JBIG2_SYMBOL_DICTS, &stats));
+  EXPECT_EQ(before.hits + 1, stats.hits);
+  EXPECT_EQ(before.misses + 1, stats.misses);
+
+  // Without the cache, the dictionary gets evicted on the next lookup, and
+  // decoded every time.
+  ASSERT_TRUE(FPDF_SetCacheLimit(FPDF_CACHE_JBIG2_SYMBOL_DICTS, 0));
+  {
+    ScopedFPDFBitmap bitmap(FPDFImageObj_GetBitmap(obj));
+    CompareBitmap(bitmap.get(), 1152, 720, kChecksum);
+  }
+  ASSERT_TRUE(FPDF_GetCacheStats(FPDF_CACHE_JBIG2_SYMBOL_DICTS, &stats));
+  EXPECT_EQ(before.hits + 1, stats.hits);
+  EXPECT_EQ(before.misses + 2, stats.misses);
+  EXPECT_EQ(before.evictions + 1, stats.evictions);
+  EXPECT_EQ(before.bytes, stats.bytes);
+
+  ASSERT_TRUE(
+      FPDF_SetCacheLimit(FPDF_CACHE_JBIG2_SYMBOL_DICTS, 32 * 1024 * 1024));
+}
+
+TEST_F(FPDFViewEmbedderTest, ImageCache) {
+  ASSERT_TRUE(OpenDocument("embedded_images.pdf"));
+
+  // The counters cover all documents, so only look at how they change.
+  FPDF_CACHE_STATS before;
+  ASSERT_TRUE(FPDF_GetCacheStats(FPDF_CACHE_IMAGES, &before));
+  std::string checksum;
+  {
+    ScopedPage page = LoadScopedPage(0);
+    ASSERT_TRUE(page);
+    ScopedFPDFBitmap bitmap = RenderLoadedPage(page.get());
+    checksum = HashBitmap(bitmap.get());
+  }
+  FPDF_CACHE_STATS stats;
+  ASSERT_TRUE(FPDF_GetCacheStats(FPDF_CACHE_IMAGES, &stats));
+  const unsigned long long misses = stats.misses - before.misses;
+  EXPECT_GT(misses, 0u);
+  EXPECT_EQ(before.hits, stats.hits);
+  EXPECT_EQ(before.evictions, stats.evictions);
+  EXPECT_GT(stats.bytes, before.bytes);
+
+  // The decoded images outlive the page, so loading it again does not decode
+  // them again.
+  {
+    ScopedPage page = LoadScopedPage(0);
+    ASSERT_TRUE(page);
+    ScopedFPDFBitmap bitmap = RenderLoadedPage(page.get());
+    EXPECT_EQ(checksum, HashBitmap(bitmap.get()));
+  }
+  ASSERT_TRUE(FPDF_GetCacheStats(FPDF_CACHE_IMAGES, &stats));
+  EXPECT_EQ(before.hits + misses, stats.hits);
+  EXPECT_EQ(before.misses + misses, stats.misses);
+
+  // Without the cache, the images get evicted once the page renders, and
+  // decoded every time.
+  ASSERT_TRUE(FPDF_SetCacheLimit(FPDF_CACHE_IMAGES, 0));
+  {
+    ScopedPage page = LoadScopedPage(0);
+    ASSERT_TRUE(page);
+    ScopedFPDFBitmap bitmap = RenderLoadedPage(page.get());
+    EXPECT_EQ(checksum, HashBitmap(bitmap.get()));
+  }
+  ASSERT_TRUE(FPDF_GetCacheStats(FPDF_CACHE_IMAGES, &stats));
+  EXPECT_GT(stats.evictions, before.evictions);
+  EXPECT_EQ(before.hits + misses, stats.hits);
+  EXPECT_EQ(before.misses + 2 * misses, stats.misses);
+  EXPECT_EQ(before.bytes, stats.bytes);
+
+  ASSERT_TRUE(FPDF_SetCacheLimit(FPDF_CACHE_IMAGES, 128 * 1024 * 1024));
+}
+
+TEST_F(FPDFViewEmbedderTest, ImageCacheSharedByPages) {
+  // Pages 0 and 1 draw the same image.
+  ASSERT_TRUE(OpenDocument("shared_images.pdf"));
+
+  FPDF_CACHE_STATS before;
+  ASSERT_TRUE(FPDF_GetCacheStats(FPDF_CACHE_IMAGES, &before));
+  std::string checksum;
+  {
+    ScopedPage page = LoadScopedPage(0);
+    ASSERT_TRUE(page);
+    ScopedFPDFBitmap bitmap = RenderLoadedPage(page.get());
+    checksum = HashBitmap(bitmap.get());
+  }
+  FPDF_CACHE_STATS stats;
+  ASSERT_TRUE(FPDF_GetCacheStats(FPDF_CACHE_IMAGES, &stats));
+  EXPECT_EQ(before.hits, stats.hits);
+  EXPECT_EQ(before.misses + 1, stats.misses);
+  const size_t image_bytes = stats.bytes - before.bytes;
+  EXPECT_GT(image_bytes, 0u);
+
+  // The other page reuses the decoded image.
+  {
+    ScopedPage page = LoadScopedPage(1);
+    ASSERT_TRUE(page);
+    ScopedFPDFBitmap bitmap = RenderLoadedPage(page.get());
+    EXPECT_EQ(checksum, HashBitmap(bitmap.get()));
+  }
+  ASSERT_TRUE(FPDF_GetCacheStats(FPDF_CACHE_IMAGES, &stats));
+  EXPECT_EQ(before.hits + 1, stats.hits);
+  EXPECT_EQ(before.misses + 1, stats.misses);
+  EXPECT_EQ(before.bytes + image_bytes, stats.bytes);
+
+  // Another image on another page gets decoded.
+  {
+    ScopedPage page = LoadScopedPage(2);
+    ASSERT_TRUE(page);
+    ScopedFPDFBitmap bitmap = RenderLoadedPage(page.get());
+    EXPECT_NE(checksum, HashBitmap(bitmap.get()));
+  }
+  ASSERT_TRUE(FPDF_GetCacheStats(FPDF_CACHE_IMAGES, &stats));
+  EXPECT_EQ(before.hits + 1, stats.hits);
+  EXPECT_EQ(before.misses + 2, stats.misses);
+  EXPECT_EQ(before.bytes + 2 * image_bytes, stats.bytes);
+}
+
+TEST_F(FPDFViewEmbedderTest, ImageCacheEvictionOrder) {
+  // Pages 0 and 1 draw image A, page 2 image B and page 3 image C. The images
+  // all have the same size.
+  ASSERT_TRUE(OpenDocument("shared_images.pdf"));
+
+  auto render_page = [this](int page_index) {
+    ScopedPage page = LoadScopedPage(page_index);
+    ASSERT_TRUE(page);
+    RenderLoadedPage(page.get());
+  };
+
+  FPDF_CACHE_STATS before;
+  ASSERT_TRUE(FPDF_GetCacheStats(FPDF_CACHE_IMAGES, &before));
+  render_page(0);
+  FPDF_CACHE_STATS stats;
+  ASSERT_TRUE(FPDF_GetCacheStats(FPDF_CACHE_IMAGES, &stats));
+  const size_t image_bytes = stats.bytes - before.bytes;
+  ASSERT_GT(image_bytes, 0u);
+
+  // Leave room for two of the images.
+  ASSERT_TRUE(
+      FPDF_SetCacheLimit(FPDF_CACHE_IMAGES, before.bytes + 2 * image_bytes));
+  render_page(2);
+  // Using A makes B the least recently used image, so caching C evicts B.
+  render_page(1);
+  render_page(3);
+  ASSERT_TRUE(FPDF_GetCacheStats(FPDF_CACHE_IMAGES, &stats));
+  EXPECT_EQ(before.evictions + 1, stats.evictions);
+  EXPECT_EQ(before.misses + 3, stats.misses);
+  EXPECT_EQ(before.bytes + 2 * image_bytes, stats.bytes);
+
+  render_page(0);
+  ASSERT_TRUE(FPDF_GetCacheStats(FPDF_CACHE_IMAGES, &stats));
+  EXPECT_EQ(before.misses + 3, stats.misses);
+  render_page(2);
+  ASSERT_TRUE(FPDF_GetCacheStats(FPDF_CACHE_IMAGES, &stats));
+  EXPECT_EQ(before.misses + 4, stats.misses);
+
+  ASSERT_TRUE(FPDF_SetCacheLimit(FPDF_CACHE_IMAGES, 128 * 1024 * 1024));
+}
+
+TEST_F(FPDFViewEmbedderTest, ImageCacheLimitSurvivesRender) {
+  ASSERT_TRUE(OpenDocument("shared_images.pdf"));
+
+  FPDF_CACHE_STATS before;
+  ASSERT_TRUE(FPDF_GetCacheStats(FPDF_CACHE_IMAGES, &before));
+  const size_t limit = before.bytes + 1;
+  ASSERT_TRUE(FPDF_SetCacheLimit(FPDF_CACHE_IMAGES, limit));
+  for (int i = 0; i < 4; ++i) {
+    ScopedPage page = LoadScopedPage(i);
+    ASSERT_TRUE(page);
+    ScopedFPDFBitmap bitmap = RenderLoadedPage(page.get());
+    FPDF_CACHE_STATS stats;
+    ASSERT_TRUE(FPDF_GetCacheStats(FPDF_CACHE_IMAGES, &stats));
+    EXPECT_EQ(limit, stats.max_bytes);
+    EXPECT_LE(stats.bytes, limit);
+  }
+
+  // The images are too large for the limit, so none got cached.
+  FPDF_CACHE_STATS stats;
+  ASSERT_TRUE(FPDF_GetCacheStats(FPDF_CACHE_IMAGES, &stats));
+  EXPECT_EQ(before.hits, stats.hits);
+  EXPECT_EQ(before.misses + 4, stats.misses);
+  EXPECT_EQ(before.bytes, stats.bytes);
+
+  ASSERT_TRUE(FPDF_SetCacheLimit(FPDF_CACHE_IMAGES, 128 * 1024 * 1024));
+}
+
+// Best run with TSan (`is_tsan = true`) to detect data races.
+TEST_F(FPDFViewEmbedderTest, RenderDocumentsOnThreads) {
+  static constexpr const char* kFiles[] = {
+      "hello_world.pdf",
+      "rectangles.pdf",
+      "text_color.pdf",
+      "bug_1302355.pdf",
+      // Has an image with a soft mask, a shading, a soft masked form and an
+      // annotation.
+      "render_in_bands.pdf",
+  };
+  static constexpr size_t kThreadCount = 4;
+  static constexpr int kIterations = 2;
+
+  auto render_files = []() {
+    std::vector<std::string> hashes;
+    FPDF_InitThread();
+    for (const char* file : kFiles) {
+      std::string file_path = PathService::GetTestFilePath(file);
+      ScopedFPDFDocument doc(FPDF_LoadDocument(file_path.c_str(), nullptr));
+      EXPECT_TRUE(doc) << file;
+      if (!doc) {
+        continue;
+      }
+      for (int i = 0; i < FPDF_GetPageCount(doc.get()); ++i) {
+        ScopedFPDFPage page(FPDF_LoadPage(doc.get(), i));
+        EXPECT_TRUE(page) << file << " page " << i;
+        if (!page) {
+          continue;
+        }
+        const int width = static_cast<int>(FPDF_GetPageWidthF(page.get()));
+        const int height = static_cast<int>(FPDF_GetPageHeightF(page.get()));
+        ScopedFPDFBitmap bitmap(FPDFBitmap_Create(width, height, 0));
+        FPDFBitmap_FillRect(bitmap.get(), 0, 0, width, height, 0xFFFFFFFF);
+        FPDF_RenderPageBitmap(bitmap.get(), page.get(), 0, 0, width, height, 0,
+                              0);
+        hashes.push_back(HashBitmap(bitmap.get()));
+      }
+    }
+    FPDF_DestroyThread();
+    return hashes;
+  };
+
+  FPDF_CACHE_STATS before;
+  ASSERT_TRUE(FPDF_GetCacheStats(FPDF_CACHE_GLYPHS, &before));
+  std::vector<std::string> expected;
+  std::thread([&expected, &render_files] {
+    expected = render_files();
+  }).join();
+  ASSERT_FALSE(expected.empty());
+
+  // Glyph cache counters cover all threads. The thread's glyph cache is gone
+  // along with its bitmaps.
+  FPDF_CACHE_STATS after;
+  ASSERT_TRUE(FPDF_GetCacheStats(FPDF_CACHE_GLYPHS, &after));
+  if (!CFX_DefaultRenderDevice::UseSkiaRenderer()) {
+    EXPECT_GT(after.misses, before.misses);
+  }
+  EXPECT_EQ(before.bytes, after.bytes);
+
+  std::vector<std::vector<std::string>> results(kThreadCount);
+  std::vector<std::thread> threads;
+  for (auto& result : results) {
+    threads.emplace_back([&result, &render_files] {
+      for (int i = 0; i < kIterations; ++i) {
+        result = render_files();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (const auto& result : results) {
+    EXPECT_EQ(expected, result);
+  }
+}
+
+TEST_F(FPDFViewEmbedderTest, LoadPageRangeWithDecodeThreads) {
+  static constexpr const char* kFiles[] = {
+      // Compressed content streams.
+      "linearized.pdf",
+      // Arrays of content streams.
+      "hello_world_2_pages_split_streams.pdf",
+  };
+  for (const char* file : kFiles) {
+    std::string file_path = PathService::GetTestFilePath(file);
+    ScopedFPDFDocument doc(FPDF_LoadDocument(file_path.c_str(), nullptr));
+    ASSERT_TRUE(doc) << file;
+    const int page_count = FPDF_GetPageCount(doc.get());
+    ASSERT_GT(page_count, 1) << file;
+
+    for (int thread_count : {1, 4}) {
+      std::vector<FPDF_PAGE> pages(page_count);
+      ASSERT_EQ(page_count, FPDF_LoadPageRangeWithDecodeThreads(
+                                doc.get(), 0, page_count, pages.data(),
+                                thread_count))
+          << file;
+      for (int i = 0; i < page_count; ++i) {
+        ScopedFPDFPage range_page(pages[i]);
+        ASSERT_TRUE(range_page) << file;
+        ScopedFPDFPage page(FPDF_LoadPage(doc.get(), i));
+        ASSERT_TRUE(page) << file;
+        EXPECT_EQ(FPDFPage_CountObjects(page.get()),
+                  FPDFPage_CountObjects(range_page.get()))
+            << file << " page " << i;
+        ScopedFPDFBitmap expected = RenderPage(page.get());
+        ScopedFPDFBitmap bitmap = RenderPage(range_page.get());
+        EXPECT_EQ(HashBitmap(expected.get()), HashBitmap(bitmap.get()))
+            << file << " page " << i << " with " << thread_count
+            << " threads";
+      }
+    }
+
+    // Part of the document.
+    FPDF_PAGE last_page = nullptr;
+    ASSERT_EQ(1, FPDF_LoadPageRangeWithDecodeThreads(doc.get(), page_count - 1,
+                                                     1, &last_page, 4));
+    ScopedFPDFPage scoped_last_page(last_page);
+    EXPECT_TRUE(scoped_last_page);
+    EXPECT_EQ(0, FPDF_LoadPageRangeWithDecodeThreads(doc.get(), page_count, 0,
+                                                     &last_page, 4));
+
+    // Out of range.
+    EXPECT_EQ(-1, FPDF_LoadPageRangeWithDecodeThreads(doc.get(), page_count, 1,
+                                                      &last_page, 4));
+    EXPECT_EQ(-1, FPDF_LoadPageRangeWithDecodeThreads(doc.get(), -1, 1,
+                                                      &last_page, 4));
+    EXPECT_EQ(-1, FPDF_LoadPageRangeWithDecodeThreads(doc.get(), 0, -1,
+                                                      &last_page, 4));
+    EXPECT_EQ(-1,
+              FPDF_LoadPageRangeWithDecodeThreads(doc.get(), 0, 1, nullptr, 4));
+  }
+  EXPECT_EQ(-1,
+            FPDF_LoadPageRangeWithDecodeThreads(nullptr, 0, 0, nullptr, 4));
+}
+
+TEST_F(FPDFViewEmbedderTest, RenderPageBitmapInBands) {
+  static constexpr const char* kFiles[] = {
+      "hello_world.pdf",
+      "rectangles.pdf",
+      "text_color.pdf",
+      "bug_1302355.pdf",
+  };
+  for (const char* file : kFiles) {
+    std::string file_path = PathService::GetTestFilePath(file);
+    ScopedFPDFDocument doc(FPDF_LoadDocument(file_path.c_str(), nullptr));
+    ASSERT_TRUE(doc) << file;
+    ScopedFPDFPage page(FPDF_LoadPage(doc.get(), 0));
+    ASSERT_TRUE(page) << file;
+
+    const int width = static_cast<int>(FPDF_GetPageWidthF(page.get())) * 2;
+    const int height = static_cast<int>(FPDF_GetPageHeightF(page.get())) * 2;
+    ScopedFPDFBitmap expected(FPDFBitmap_Create(width, height, 0));
+    FPDFBitmap_FillRect(expected.get(), 0, 0, width, height, 0xFFFFFFFF);
+    FPDF_RenderPageBitmap(expected.get(), page.get(), 0, 0, width, height, 0,
+                          FPDF_ANNOT);
+
+    for (int band_count : {1, 3, 8}) {
+      ScopedFPDFBitmap bitmap(FPDFBitmap_Create(width, height, 0));
+      FPDFBitmap_FillRect(bitmap.get(), 0, 0, width, height, 0xFFFFFFFF);
+      EXPECT_EQ(band_count > 1,
+                !!FPDF_RenderPageBitmapInBands(bitmap.get(), page.get(), 0, 0,
+                                               width, height, 0, FPDF_ANNOT,
+                                               band_count))
+          << file;
+      EXPECT_EQ(HashBitmap(expected.get()), HashBitmap(bitmap.get()))
+          << file << " with " << band_count << " bands";
+    }
+  }
+}
+
+TEST_F(FPDFViewEmbedderTest, RenderPageBitmapInBandsCustomLoader) {
+  // Documents loaded through FPDF_FILEACCESS are not in memory as a whole,
+  // which does not matter to the bands.
+  ASSERT_TRUE(OpenDocument("rectangles.pdf"));
+  ScopedPage page = LoadScopedPage(0);
+  ASSERT_TRUE(page);
+
+  ScopedFPDFBitmap expected(FPDFBitmap_Create(200, 300, 0));
+  FPDFBitmap_FillRect(expected.get(), 0, 0, 200, 300, 0xFFFFFFFF);
+  FPDF_RenderPageBitmap(expected.get(), page.get(), 0, 0, 200, 300, 0, 0);
+
+  ScopedFPDFBitmap bitmap(FPDFBitmap_Create(200, 300, 0));
+  FPDFBitmap_FillRect(bitmap.get(), 0, 0, 200, 300, 0xFFFFFFFF);
+  EXPECT_TRUE(FPDF_RenderPageBitmapInBands(bitmap.get(), page.get(), 0, 0,
+                                           200, 300, 0, 0, 4));
+  EXPECT_EQ(HashBitmap(expected.get()), HashBitmap(bitmap.get()));
+}
+
+TEST_F(FPDFViewEmbedderTest, RenderPageBitmapInBandsModifiedPage) {
+  ASSERT_TRUE(OpenDocument("rectangles.pdf"));
+  ScopedPage page = LoadScopedPage(0);
+  ASSERT_TRUE(page);
+
+  auto render = [&page] {
+    ScopedFPDFBitmap bitmap(FPDFBitmap_Create(200, 300, 0));
+    FPDFBitmap_FillRect(bitmap.get(), 0, 0, 200, 300, 0xFFFFFFFF);
+    FPDF_RenderPageBitmap(bitmap.get(), page.get(), 0, 0, 200, 300, 0, 0);
+    return HashBitmap(bitmap.get());
+  };
+  const std::string original = render();
+
+  // Keeps a copy of the page, which must not outlive the changes below.
+  ScopedFPDFBitmap bitmap(FPDFBitmap_Create(200, 300, 0));
+  FPDFBitmap_FillRect(bitmap.get(), 0, 0, 200, 300, 0xFFFFFFFF);
+  EXPECT_TRUE(FPDF_RenderPageBitmapInBands(bitmap.get(), page.get(), 0, 0,
+                                           200, 300, 0, 0, 4));
+  EXPECT_EQ(original, HashBitmap(bitmap.get()));
+
+  // A rectangle across all bands.
+  FPDF_PAGEOBJECT rect = FPDFPageObj_CreateNewRect(20, 20, 30, 260);
+  ASSERT_TRUE(FPDFPageObj_SetFillColor(rect, 255, 0, 0, 255));
+  ASSERT_TRUE(FPDFPath_SetDrawMode(rect, FPDF_FILLMODE_ALTERNATE, 0));
+  FPDFPage_InsertObject(page.get(), rect);
+  const std::string modified = render();
+  EXPECT_NE(original, modified);
+
+  // Until the content is generated, the page renders on the calling thread.
+  FPDFBitmap_FillRect(bitmap.get(), 0, 0, 200, 300, 0xFFFFFFFF);
+  EXPECT_FALSE(FPDF_RenderPageBitmapInBands(bitmap.get(), page.get(), 0, 0,
+                                            200, 300, 0, 0, 4));
+  EXPECT_EQ(modified, HashBitmap(bitmap.get()));
+
+  // Afterwards, the other bands render the modified page too.
+  ASSERT_TRUE(FPDFPage_GenerateContent(page.get()));
+  FPDFBitmap_FillRect(bitmap.get(), 0, 0, 200, 300, 0xFFFFFFFF);
+  EXPECT_TRUE(FPDF_RenderPageBitmapInBands(bitmap.get(), page.get(), 0, 0,
+                                           200, 300, 0, 0, 4));
+  EXPECT_EQ(modified, HashBitmap(bitmap.get()));
+}
+
+TEST_F(FPDFViewEmbedderTest, RenderPageBitmapInBandsModifiedAnnotations) {
+  ASSERT_TRUE(OpenDocument("render_in_bands.pdf"));
+  ScopedPage page = LoadScopedPage(0);
+  ASSERT_TRUE(page);
+
+  auto render = [&page] {
+    ScopedFPDFBitmap bitmap(FPDFBitmap_Create(200, 300, 0));
+    FPDFBitmap_FillRect(bitmap.get(), 0, 0, 200, 300, 0xFFFFFFFF);
+    FPDF_RenderPageBitmap(bitmap.get(), page.get(), 0, 0, 200, 300, 0,
+                          FPDF_ANNOT);
+    return HashBitmap(bitmap.get());
+  };
+  auto render_in_bands = [&page] {
+    ScopedFPDFBitmap bitmap(FPDFBitmap_Create(200, 300, 0));
+    FPDFBitmap_FillRect(bitmap.get(), 0, 0, 200, 300, 0xFFFFFFFF);
+    EXPECT_TRUE(FPDF_RenderPageBitmapInBands(bitmap.get(), page.get(), 0, 0,
+                                             200, 300, 0, FPDF_ANNOT, 4));
+    return HashBitmap(bitmap.get());
+  };
+  const std::string original = render();
+  EXPECT_EQ(original, render_in_bands());
+  EXPECT_EQ(original, render_in_bands());
+
+  // Changes to the page dictionary do not need FPDFPage_GenerateContent(), and
+  // still reach the other bands.
+  ASSERT_TRUE(FPDFPage_RemoveAnnot(page.get(), 0));
+  const std::string without_annotation = render();
+  EXPECT_NE(original, without_annotation);
+  EXPECT_EQ(without_annotation, render_in_bands());
+
+  FPDFPage_SetRotation(page.get(), 2);
+  const std::string rotated = render();
+  EXPECT_NE(without_annotation, rotated);
+  EXPECT_EQ(rotated, render_in_bands());
+}
+
+TEST_F(FPDFViewEmbedderTest, RenderPageBitmapInBandsLargeImage) {
+  // Saves a page with an image that has 100 times as many pixels as the page
+  // gets rendered with, drawn with `matrix`.
+  auto save_document = [this](const FS_MATRIX& matrix) {
+    ScopedFPDFDocument doc(FPDF_CreateNewDocument());
+    ScopedFPDFPage page(FPDFPage_New(doc.get(), 0, 200, 300));
+    ScopedFPDFBitmap image_bitmap(FPDFBitmap_Create(2000, 3000, 0));
+    FPDFBitmap_FillRect(image_bitmap.get(), 0, 0, 2000, 1500, 0xFF0000FF);
+    FPDFBitmap_FillRect(image_bitmap.get(), 0, 1500, 2000, 1500, 0xFFFF0000);
+    FPDF_PAGEOBJECT image = FPDFPageObj_NewImageObj(doc.get());
+    FPDF_PAGE pages[] = {page.get()};
+    EXPECT_TRUE(FPDFImageObj_SetBitmap(pages, 1, image, image_bitmap.get()));
+    EXPECT_TRUE(FPDFPageObj_SetMatrix(image, &matrix));
+    FPDFPage_InsertObject(page.get(), image);
+    EXPECT_TRUE(FPDFPage_GenerateContent(page.get()));
+    ClearString();
+    EXPECT_TRUE(FPDF_SaveAsCopy(doc.get(), this, 0));
+    return GetString();
+  };
+  auto render_and_compare = [](const std::string& pdf, bool expect_bands) {
+    ScopedFPDFDocument doc(
+        FPDF_LoadMemDocument64(pdf.data(), pdf.size(), nullptr));
+    ASSERT_TRUE(doc);
+    ScopedFPDFPage page(FPDF_LoadPage(doc.get(), 0));
+    ASSERT_TRUE(page);
+
+    ScopedFPDFBitmap expected(FPDFBitmap_Create(200, 300, 0));
+    FPDFBitmap_FillRect(expected.get(), 0, 0, 200, 300, 0xFFFFFFFF);
+    FPDF_RenderPageBitmap(expected.get(), page.get(), 0, 0, 200, 300, 0, 0);
+
+    ScopedFPDFBitmap bitmap(FPDFBitmap_Create(200, 300, 0));
+    FPDFBitmap_FillRect(bitmap.get(), 0, 0, 200, 300, 0xFFFFFFFF);
+    EXPECT_EQ(expect_bands,
+              !!FPDF_RenderPageBitmapInBands(bitmap.get(), page.get(), 0, 0,
+                                             200, 300, 0, 0, 4));
+    EXPECT_EQ(HashBitmap(expected.get()), HashBitmap(bitmap.get()));
+  };
+
+  // Across the whole page, every band would decode the image.
+  render_and_compare(save_document({200, 0, 0, 300, 0, 0}),
+                     /*expect_bands=*/false);
+
+  // Within the top band, only that band decodes it.
+  render_and_compare(save_document({40, 0, 0, 60, 80, 230}),
+                     /*expect_bands=*/true);
+}
+
+TEST_F(FPDFViewEmbedderTest, RenderPageTile) {
+  // Has enough page objects to use a spatial index.
+  ASSERT_TRUE(OpenDocument("many_rectangles.pdf"));
+  ScopedPage page = LoadScopedPage(0);
+  ASSERT_TRUE(page);
+
+  static constexpr float kScale = 2.0f;
+  static constexpr int kTileSize = 128;
+  const int page_width =
+      static_cast<int>(FPDF_GetPageWidthF(page.get()) * kScale);
+  const int page_height =
+      static_cast<int>(FPDF_GetPageHeightF(page.get()) * kScale);
+  auto render_page = [&]() {
+    ScopedFPDFBitmap bitmap(FPDFBitmap_Create(page_width, page_height, 0));
+    FPDFBitmap_FillRect(bitmap.get(), 0, 0, page_width, page_height,
+                        0xFFFFFFFF);
+    FPDF_RenderPageBitmap(bitmap.get(), page.get(), 0, 0, page_width,
+                          page_height, 0, 0);
+    return bitmap;
+  };
+  auto compare_tiles = [&](FPDF_BITMAP page_bitmap) {
+    ScopedFPDFBitmap tile(FPDFBitmap_Create(kTileSize, kTileSize, 0));
+    for (int y = 0; y * kTileSize < page_height; ++y) {
+      for (int x = 0; x * kTileSize < page_width; ++x) {
+        FPDFBitmap_FillRect(tile.get(), 0, 0, kTileSize, kTileSize,
+                            0xFFFFFFFF);
+        ASSERT_TRUE(FPDF_RenderPageTile(tile.get(), page.get(), kScale, x, y,
+                                        0, 0));
+        CompareTile(page_bitmap, tile.get(), x, y);
+      }
+    }
+  };
+
+  ScopedFPDFBitmap page_bitmap = render_page();
+  compare_tiles(page_bitmap.get());
+
+  // Moving an object must be reflected in the tiles.
+  FPDF_PAGEOBJECT obj = FPDFPage_GetObject(page.get(), 0);
+  ASSERT_TRUE(obj);
+  FPDFPageObj_Transform(obj, 1, 0, 0, 1, 100, 150);
+  page_bitmap = render_page();
+  compare_tiles(page_bitmap.get());
+
+  ScopedFPDFBitmap tile(FPDFBitmap_Create(kTileSize, kTileSize, 0));
+  EXPECT_FALSE(FPDF_RenderPageTile(nullptr, page.get(), kScale, 0, 0, 0, 0));
+  EXPECT_FALSE(FPDF_RenderPageTile(tile.get(), nullptr, kScale, 0, 0, 0, 0));
+  EXPECT_FALSE(FPDF_RenderPageTile(tile.get(), page.get(), 0, 0, 0, 0, 0));
+  EXPECT_FALSE(
+      FPDF_RenderPageTile(tile.get(), page.get(), kScale, -1, 0, 0, 0));
+}
@@ -79,6 +79,16 @@ struct FPDFTextFindDeleter {
   inline void operator()(FPDF_SCHHANDLE handle) { FPDFText_FindClose(handle); }
 };
 
+struct FPDFTextIndexDeleter {
+  inline void operator()(FPDF_TEXTINDEX index) { FPDFText_CloseIndex(index); }
+};
+
+struct FPDFTextIndexSearchDeleter {
+  inline void operator()(FPDF_TEXTINDEX_SEARCH search) {
+    FPDFText_IndexFindClose(search);
+  }
+};
+
 struct FPDFTextPageDeleter {
   inline void operator()(FPDF_TEXTPAGE text) { FPDFText_ClosePage(text); }
 };
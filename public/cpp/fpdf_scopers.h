@@ -60,6 +60,14 @@ using ScopedFPDFTextFind =
     std::unique_ptr<std::remove_pointer<FPDF_SCHHANDLE>::type,
                     FPDFTextFindDeleter>;
 
+using ScopedFPDFTextIndex =
+    std::unique_ptr<std::remove_pointer<FPDF_TEXTINDEX>::type,
+                    FPDFTextIndexDeleter>;
+
+using ScopedFPDFTextIndexSearch =
+    std::unique_ptr<std::remove_pointer<FPDF_TEXTINDEX_SEARCH>::type,
+                    FPDFTextIndexSearchDeleter>;
+
 using ScopedFPDFTextPage =
     std::unique_ptr<std::remove_pointer<FPDF_TEXTPAGE>::type,
                     FPDFTextPageDeleter>;
@@ -554,6 +554,139 @@ FPDF_EXPORT int FPDF_CALLCONV FPDFText_GetSchCount(FPDF_SCHHANDLE handle);
 //
 FPDF_EXPORT void FPDF_CALLCONV FPDFText_FindClose(FPDF_SCHHANDLE handle);
 
+// Experimental API.
+// Function: FPDFText_BuildIndex
+//          Build a search index of the text of all pages of a document.
+// Parameters:
+//          document    -   Handle to a document.
+// Return Value:
+//          A handle to the index, or NULL if |document| is NULL.
+//          FPDFText_CloseIndex must be called to release this handle.
+// Comments:
+//          Loads every page once to extract its text. Searches of the index
+//          then find the same matches as FPDFText_FindStart and
+//          FPDFText_FindNext on each page, without loading any page. Pages
+//          that fail to load are indexed as having no text.
+//
+FPDF_EXPORT FPDF_TEXTINDEX FPDF_CALLCONV
+FPDFText_BuildIndex(FPDF_DOCUMENT document);
+
+// Experimental API.
+// Function: FPDFText_SaveIndex
+//          Write an index to a buffer, for FPDFText_LoadIndex to read back.
+// Parameters:
+//          index       -   Handle to an index.
+//          buffer      -   A buffer for the index data. May be NULL.
+//          buflen      -   The length of |buffer| in bytes.
+// Return Value:
+//          The size of the index data in bytes, or 0 if |index| is NULL. If
+//          |buflen| is smaller than that, |buffer| is left unchanged.
+// Comments:
+//          The data holds the text of the document, so it should be kept with
+//          the same care as the document. It may be stored next to the
+//          document to answer later searches without loading any page.
+//
+FPDF_EXPORT unsigned long FPDF_CALLCONV
+FPDFText_SaveIndex(FPDF_TEXTINDEX index, void* buffer, unsigned long buflen);
+
+// Experimental API.
+// Function: FPDFText_LoadIndex
+//          Read an index written by FPDFText_SaveIndex.
+// Parameters:
+//          document    -   Handle to the document the index was built for.
+//          data        -   The index data.
+//          size        -   The size of |data| in bytes.
+// Return Value:
+//          A handle to the index, or NULL if |document| or |data| is NULL, if
+//          |data| is not valid index data, or if it was built for another
+//          document. FPDFText_CloseIndex must be called to release this
+//          handle.
+// Comments:
+//          The index data records the file identifier (the trailer /ID), file
+//          size and page count of the document it was built for. A document
+//          that was saved again, or a different document, does not match.
+//          Changes made to |document| since it was loaded are not detected.
+//
+FPDF_EXPORT FPDF_TEXTINDEX FPDF_CALLCONV
+FPDFText_LoadIndex(FPDF_DOCUMENT document,
+                   const void* data,
+                   unsigned long size);
+
+// Experimental API.
+// Function: FPDFText_CloseIndex
+//          Release an index.
+// Parameters:
+//          index       -   Handle to an index. Searches of it must be closed
+//                          first.
+// Return Value:
+//          None.
+//
+FPDF_EXPORT void FPDF_CALLCONV FPDFText_CloseIndex(FPDF_TEXTINDEX index);
+
+// Experimental API.
+// Function: FPDFText_IndexFindStart
+//          Start a search of all pages of an index.
+// Parameters:
+//          index       -   Handle to an index.
+//          findwhat    -   A unicode match pattern.
+//          flags       -   Option flags, as for FPDFText_FindStart.
+//          start_page  -   Index of the first page to search.
+// Return Value:
+//          A handle for the search, or NULL if |index| or |findwhat| is NULL.
+//          FPDFText_IndexFindClose must be called to release this handle.
+//
+FPDF_EXPORT FPDF_TEXTINDEX_SEARCH FPDF_CALLCONV
+FPDFText_IndexFindStart(FPDF_TEXTINDEX index,
+                        FPDF_WIDESTRING findwhat,
+                        unsigned long flags,
+                        int start_page);
+
+// Experimental API.
+// Function: FPDFText_IndexFindNext
+//          Move on to the next match, going through the pages in order.
+// Parameters:
+//          search      -   A search handle returned by
+//                          FPDFText_IndexFindStart.
+// Return Value:
+//          Whether a match is found.
+//
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV
+FPDFText_IndexFindNext(FPDF_TEXTINDEX_SEARCH search);
+
+// Experimental API.
+// Function: FPDFText_IndexGetResult
+//          Get the current match of a search.
+// Parameters:
+//          search      -   A search handle returned by
+//                          FPDFText_IndexFindStart.
+//          page_index  -   Receives the index of the page of the match.
+//          char_index  -   Receives the index of the first matched
+//                          character, as FPDFText_GetSchResultIndex returns.
+//          char_count  -   Receives the number of matched characters, as
+//                          FPDFText_GetSchCount returns.
+// Return Value:
+//          True on success. False if any parameter is NULL, or if the last
+//          call to FPDFText_IndexFindNext did not find a match, in which case
+//          the out parameters remain unmodified.
+//
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV
+FPDFText_IndexGetResult(FPDF_TEXTINDEX_SEARCH search,
+                        int* page_index,
+                        int* char_index,
+                        int* char_count);
+
+// Experimental API.
+// Function: FPDFText_IndexFindClose
+//          Release a search.
+// Parameters:
+//          search      -   A search handle returned by
+//                          FPDFText_IndexFindStart.
+// Return Value:
+//          None.
+//
+FPDF_EXPORT void FPDF_CALLCONV
+FPDFText_IndexFindClose(FPDF_TEXTINDEX_SEARCH search);
+
 // Function: FPDFLink_LoadWebLinks
 //          Prepare information about weblinks in a page.
 // Parameters:
@@ -87,6 +87,8 @@ typedef const struct fpdf_structelement_attr_t__* FPDF_STRUCTELEMENT_ATTR;
 typedef const struct fpdf_structelement_attr_value_t__*
 FPDF_STRUCTELEMENT_ATTR_VALUE;
 typedef struct fpdf_structtree_t__* FPDF_STRUCTTREE;
+typedef struct fpdf_textindex_t__* FPDF_TEXTINDEX;
+typedef struct fpdf_textindex_search_t__* FPDF_TEXTINDEX_SEARCH;
 typedef struct fpdf_textpage_t__* FPDF_TEXTPAGE;
 typedef struct fpdf_widget_t__* FPDF_WIDGET;
 typedef struct fpdf_xobject_t__* FPDF_XOBJECT;
@@ -321,8 +323,48 @@ FPDF_EXPORT void FPDF_CALLCONV FPDF_InitLibrary();
 //          Calling this function does not automatically close other
 //          objects. It is recommended to close other objects before
 //          closing the library with this function.
+//
+//          All threads that called FPDF_InitThread() must have called
+//          FPDF_DestroyThread() first.
 FPDF_EXPORT void FPDF_CALLCONV FPDF_DestroyLibrary();
 
+// Experimental API.
+// Function: FPDF_InitThread
+//          Set up the calling thread to load and render documents
+//          concurrently with other threads.
+// Parameters:
+//          None.
+// Return value:
+//          None.
+// Comments:
+//          FPDF_InitLibrary() or FPDF_InitLibraryWithConfig() must have been
+//          called, and must have returned, on another thread first. Does
+//          nothing on the thread that initialized the library.
+//
+//          The font manager and glyph cache are kept per thread. Immutable
+//          engine state such as stock fonts, predefined cmaps and stock color
+//          spaces is shared by all threads. Documents, pages and all other
+//          handles must only be used on the thread that created them.
+//          Independent documents can then be rendered concurrently on
+//          different threads.
+//
+//          FPDF_SetSystemFontInfo() only affects the calling thread. Threads
+//          set up with this function use the default system font info.
+//          Forms, XFA and JavaScript are not supported on these threads.
+FPDF_EXPORT void FPDF_CALLCONV FPDF_InitThread();
+
+// Experimental API.
+// Function: FPDF_DestroyThread
+//          Release the per-thread resources allocated by FPDF_InitThread().
+// Parameters:
+//          None.
+// Return value:
+//          None.
+// Comments:
+//          Must be called on the same thread as FPDF_InitThread(), after
+//          closing all objects created on that thread.
+FPDF_EXPORT void FPDF_CALLCONV FPDF_DestroyThread();
+
 // Policy for accessing the local machine time.
 #define FPDF_POLICY_MACHINETIME_ACCESS 0
 
@@ -366,6 +408,91 @@ FPDF_EXPORT void FPDF_CALLCONV FPDF_SetSandBoxPolicy(FPDF_DWORD policy,
 FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV FPDF_SetPrintMode(int mode);
 #endif  // defined(_WIN32)
 
+// Experimental API.
+// Caches for FPDF_SetCacheLimit() and FPDF_GetCacheStats().
+//
+// Glyph bitmaps, paths and widths, for all fonts. Each thread set up with
+// FPDF_InitThread() has its own glyph cache. Glyph paths count against the
+// limit, but are never evicted, so that handles from FPDFFont_GetGlyphPath()
+// stay valid. No limit by default.
+#define FPDF_CACHE_GLYPHS 0
+// Decoded images. Each document has its own image cache, shared by all of its
+// pages, so images repeated on many pages only get decoded once. An image
+// drawn small may be decoded and cached at a reduced resolution. Inline images
+// are not cached. 128 MiB by default.
+#define FPDF_CACHE_IMAGES 1
+// Symbol dictionaries from JBIG2Globals streams, which are often shared by
+// many pages. Each document has its own symbol dictionary cache. 32 MiB by
+// default.
+#define FPDF_CACHE_JBIG2_SYMBOL_DICTS 2
+
+// Experimental API.
+// Counters for one kind of cache, covering the caches of all threads and
+// documents. See FPDF_GetCacheStats().
+typedef struct FPDF_CACHE_STATS_ {
+  // Number of lookups that found a cached entry.
+  unsigned long long hits;
+  // Number of lookups that had to load or decode the entry.
+  unsigned long long misses;
+  // Number of entries evicted to stay within the limit.
+  unsigned long long evictions;
+  // Bytes currently used by cached entries.
+  size_t bytes;
+  // The limit set with FPDF_SetCacheLimit(), or the default.
+  size_t max_bytes;
+} FPDF_CACHE_STATS;
+
+// Experimental API.
+// Function: FPDF_SetCacheLimit
+//          Set the maximum amount of memory that one kind of cache may use.
+// Parameters:
+//          cache     - One of the FPDF_CACHE_* values.
+//          max_bytes - The limit, in bytes, for the caches of all threads and
+//                      documents together. SIZE_MAX means no limit. 0 evicts
+//                      everything and disables caching.
+// Return value:
+//          True on success, false if |cache| is not valid or the library is
+//          not initialized.
+// Comments:
+//          Must not be called while a page is being rendered. Once the limit
+//          is exceeded, least recently used entries get evicted. The glyph
+//          cache of the calling thread evicts its own entries right away. The
+//          image and JBIG2 symbol dictionary caches evict the least recently
+//          used entries across all the documents last used on the same thread,
+//          the next time one of them gets used, e.g. when a page gets
+//          rendered. Entries that do not fit within the limit on their own are
+//          not cached. FPDF_DestroyLibrary() restores the default limits.
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV FPDF_SetCacheLimit(int cache,
+                                                       size_t max_bytes);
+
+// Experimental API.
+// Function: FPDF_GetCacheStats
+//          Get the counters for one kind of cache.
+// Parameters:
+//          cache - One of the FPDF_CACHE_* values.
+//          stats - Receives the counters. Must not be NULL.
+// Return value:
+//          True on success, false if |cache| is not valid, |stats| is NULL or
+//          the library is not initialized.
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV FPDF_GetCacheStats(int cache,
+                                                       FPDF_CACHE_STATS* stats);
+
+// Experimental API.
+// Function: FPDF_SetMaxFlateDecodeSize
+//          Set the maximum number of bytes that a FlateDecode filter may
+//          decode a stream to.
+// Parameters:
+//          max_size - The limit, in bytes. 0 means no limit, the default.
+// Return value:
+//          None.
+// Comments:
+//          Decoding stops at the limit, as if the stream ended there. This
+//          bounds the memory used by small streams that decompress to huge
+//          sizes. The limit applies to all documents, and to each filter of a
+//          stream separately. Regardless of the limit, decoded streams are
+//          never larger than 1 GiB.
+FPDF_EXPORT void FPDF_CALLCONV FPDF_SetMaxFlateDecodeSize(size_t max_size);
+
 // Function: FPDF_LoadDocument
 //          Open and load a PDF document.
 // Parameters:
@@ -387,6 +514,10 @@ FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV FPDF_SetPrintMode(int mode);
 //          the other encoding. If |password|'s encoding and the PDF's expected
 //          encoding do not match, FPDF_LoadDocument() will automatically
 //          convert |password| to the other encoding.
+//
+//          Where supported, the file is memory-mapped for reading, and it
+//          must not be truncated until the document is closed. If the file
+//          cannot be mapped, it is read through regular file I/O instead.
 FPDF_EXPORT FPDF_DOCUMENT FPDF_CALLCONV
 FPDF_LoadDocument(FPDF_STRING file_path, FPDF_BYTESTRING password);
 
@@ -566,6 +697,34 @@ typedef struct FPDF_FILEHANDLER_ {
 FPDF_EXPORT FPDF_DOCUMENT FPDF_CALLCONV
 FPDF_LoadCustomDocument(FPDF_FILEACCESS* pFileAccess, FPDF_BYTESTRING password);
 
+// Experimental API.
+// Function: FPDF_LoadCustomDocumentWithFileData
+//          Load PDF document from a custom access descriptor, like
+//          FPDF_LoadCustomDocument(), reading the file in place when the
+//          application has all of it in memory.
+// Parameters:
+//          pFileAccess   -   A structure for accessing the file.
+//          get_file_data -   Optional callback, called once with
+//                            |pFileAccess->m_Param| while loading. Returns
+//                            the address of all |pFileAccess->m_FileLen|
+//                            bytes of the file, e.g. of a memory-mapped file,
+//                            or NULL if they are not in memory.
+//          password      -   Optional password for decrypting the PDF file.
+// Return value:
+//          A handle to the loaded document, or NULL on failure.
+// Comments:
+//          When |get_file_data| returns the file's address, PDFium reads the
+//          file from there instead of copying blocks of it with
+//          |pFileAccess->m_GetBlock|. The bytes must stay valid and unchanged
+//          until the returned FPDF_DOCUMENT is closed.
+//
+//          Otherwise, this is the same as FPDF_LoadCustomDocument().
+FPDF_EXPORT FPDF_DOCUMENT FPDF_CALLCONV
+FPDF_LoadCustomDocumentWithFileData(
+    FPDF_FILEACCESS* pFileAccess,
+    const unsigned char* (*get_file_data)(void* param),
+    FPDF_BYTESTRING password);
+
 // Function: FPDF_GetFileVersion
 //          Get the file version of the given PDF document.
 // Parameters:
@@ -693,6 +852,39 @@ FPDF_EXPORT int FPDF_CALLCONV FPDF_GetPageCount(FPDF_DOCUMENT document);
 FPDF_EXPORT FPDF_PAGE FPDF_CALLCONV FPDF_LoadPage(FPDF_DOCUMENT document,
                                                   int page_index);
 
+// Experimental API.
+// Function: FPDF_LoadPageRangeWithDecodeThreads
+//          Load a range of pages inside the document, like calling
+//          FPDF_LoadPage() for each of them, while decoding their content
+//          streams on multiple threads.
+// Parameters:
+//          document     -   Handle to document. Returned by FPDF_LoadDocument
+//          start_index  -   Index number of the first page to load.
+//          page_count   -   Number of pages to load.
+//          pages        -   Array of |page_count| page handles, which receives
+//                           the loaded pages, or NULL for pages that fail to
+//                           load.
+//          decode_thread_count - Maximum number of threads that decode
+//                           content streams, including the calling thread.
+// Return value:
+//          The number of pages loaded, or -1 if the range is not in the
+//          document.
+// Comments:
+//          This is not a parallel page parser. Only the filters of the pages'
+//          content streams, e.g. FlateDecode, run on other threads. Parsing
+//          the content streams and loading the fonts, color spaces and images
+//          they use all happen on the calling thread, just like with
+//          FPDF_LoadPage(), so this only saves time for pages whose content
+//          streams are slow to decompress. Each loaded page must be closed
+//          with FPDF_ClosePage. XFA documents load their pages one by one with
+//          FPDF_LoadPage().
+FPDF_EXPORT int FPDF_CALLCONV
+FPDF_LoadPageRangeWithDecodeThreads(FPDF_DOCUMENT document,
+                                    int start_index,
+                                    int page_count,
+                                    FPDF_PAGE* pages,
+                                    int decode_thread_count);
+
 // Experimental API
 // Function: FPDF_GetPageWidthF
 //          Get page width.
@@ -905,6 +1097,97 @@ FPDF_EXPORT void FPDF_CALLCONV FPDF_RenderPageBitmap(FPDF_BITMAP bitmap,
                                                      int rotate,
                                                      int flags);
 
+// Experimental API.
+// Function: FPDF_RenderPageBitmapInBands
+//          Render contents of a page to a device independent bitmap, like
+//          FPDF_RenderPageBitmap(), using multiple threads.
+// Parameters:
+//          bitmap      -   Handle to the device independent bitmap (as the
+//                          output buffer).
+//          page        -   Handle to the page. Returned by FPDF_LoadPage.
+//          start_x     -   Left pixel position of the display area in
+//                          bitmap coordinates.
+//          start_y     -   Top pixel position of the display area in bitmap
+//                          coordinates.
+//          size_x      -   Horizontal size (in pixels) for displaying the page.
+//          size_y      -   Vertical size (in pixels) for displaying the page.
+//          rotate      -   Page orientation, as in FPDF_RenderPageBitmap().
+//          flags       -   0 for normal display, or combination of the Page
+//                          Rendering flags defined above.
+//          band_count  -   Maximum number of horizontal bands to split the
+//                          display area into. The calling thread renders one
+//                          band, and a pool of up to one thread per processor
+//                          renders the others.
+// Return value:
+//          True if the page was rendered in more than one band, false if it
+//          was rendered like FPDF_RenderPageBitmap(), or not at all.
+// Comments:
+//          Only the calling thread renders |page| itself. The other bands are
+//          rendered from a private copy of the page, as it is in memory when
+//          this function is called. The copy is kept with |page| and reused by
+//          later calls, until the page or the objects it uses change, or the
+//          page is closed. The result is the same as rendering with
+//          FPDF_RenderPageBitmap(). Every band decodes the images it draws
+//          part of, so fewer bands are used when decoding images more than
+//          once would cost more than rendering in parallel saves. The page is
+//          rendered like FPDF_RenderPageBitmap() instead when that leaves a
+//          single band, or when:
+//            - Page objects have changed since the last call to
+//              FPDFPage_GenerateContent().
+//            - The calling thread changed the system font info with
+//              FPDF_SetSystemFontInfo(), which the pool threads do not share.
+//            - |flags| has FPDF_ANNOT and the document's interactive form
+//              needs appearances generated.
+//            - The document uses XFA, or the renderer is not AGG.
+//          The pool threads start on first use and exit in
+//          FPDF_DestroyLibrary().
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV
+FPDF_RenderPageBitmapInBands(FPDF_BITMAP bitmap,
+                             FPDF_PAGE page,
+                             int start_x,
+                             int start_y,
+                             int size_x,
+                             int size_y,
+                             int rotate,
+                             int flags,
+                             int band_count);
+
+// Experimental API.
+// Function: FPDF_RenderPageTile
+//          Render one tile of a page that is split into tiles the size of
+//          |bitmap|, as requested by tiled viewers.
+// Parameters:
+//          bitmap      -   Handle to the device independent bitmap for the
+//                          tile. Its size is the tile size.
+//          page        -   Handle to the page. Returned by FPDF_LoadPage.
+//          scale       -   Device pixels per PDF unit (1/72 inch). Must be
+//                          positive.
+//          tile_x      -   Column of the tile, counting from the left, from 0.
+//          tile_y      -   Row of the tile, counting from the top, from 0.
+//          rotate      -   Page orientation, as in FPDF_RenderPageBitmap().
+//          flags       -   0 for normal display, or combination of the Page
+//                          Rendering flags defined above.
+// Return value:
+//          True if the tile was rendered, false on invalid arguments.
+// Comments:
+//          At |scale|, the page is FPDF_GetPageWidthF() * |scale| by
+//          FPDF_GetPageHeightF() * |scale| pixels, rounded down, with the
+//          dimensions swapped for 90 degree rotations. Each tile renders like
+//          the matching part of FPDF_RenderPageBitmap() at that size.
+//
+//          Pages with many objects are culled with a spatial index that is
+//          built once per FPDF_PAGE, so rendering a small tile only touches
+//          the objects that intersect it. The page also keeps its decoded
+//          images between calls, so render all the tiles of a page from the
+//          same FPDF_PAGE.
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV FPDF_RenderPageTile(FPDF_BITMAP bitmap,
+                                                        FPDF_PAGE page,
+                                                        float scale,
+                                                        int tile_x,
+                                                        int tile_y,
+                                                        int rotate,
+                                                        int flags);
+
 // Function: FPDF_RenderPageBitmapWithMatrix
 //          Render contents of a page to a device independent bitmap.
 // Parameters:
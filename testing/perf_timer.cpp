@@ -0,0 +1,41 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "testing/perf_timer.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+#include "core/fxcrt/bytestring.h"
+#include "core/fxcrt/check_op.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace pdfium {
+
+double MeasureBestTimeMs(const std::string& label,
+                         int runs,
+                         const std::function<void()>& fn) {
+  CHECK_GT(runs, 0);
+  double best_ms = std::numeric_limits<double>::max();
+  for (int i = 0; i < runs; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    best_ms = std::min(best_ms, elapsed.count());
+  }
+
+  const testing::TestInfo* info =
+      testing::UnitTest::GetInstance()->current_test_info();
+  printf("[ PERF     ] %s.%s %s: %.3f ms (best of %d)\n",
+         info->test_suite_name(), info->name(), label.c_str(), best_ms, runs);
+  testing::Test::RecordProperty(
+      label, ByteString::Format("%.3f", best_ms).c_str());
+  return best_ms;
+}
+
+}  // namespace pdfium
@@ -0,0 +1,25 @@
+// Copyright 2025 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TESTING_PERF_TIMER_H_
+#define TESTING_PERF_TIMER_H_
+
+#include <functional>
+#include <string>
+
+namespace pdfium {
+
+// Number of times perftests run each measured operation by default.
+inline constexpr int kDefaultPerfRuns = 5;
+
+// Calls `fn` `runs` times and returns the fastest run, in milliseconds. Prints
+// the result along with the current test's name and `label`, and records it as
+// a property of the current test, so that it shows up in --gtest_output files.
+double MeasureBestTimeMs(const std::string& label,
+                         int runs,
+                         const std::function<void()>& fn);
+
+}  // namespace pdfium
+
+#endif  // TESTING_PERF_TIMER_H_
@@ -1071,7 +1071,7 @@ CXFA_XMLLocale* GetLocaleFromBuffer(cppgc::Heap* heap,
   }
 
   DataAndBytesConsumed result =
-      FlateModule::FlateOrLZWDecode(false, src_span, true, 0, 0, 0, 0, 0);
+      FlateModule::FlateOrLZWDecode(false, src_span, true, 0, 0, 0, 0, 0, 0);
   if (result.data.empty()) {
     return nullptr;
   }